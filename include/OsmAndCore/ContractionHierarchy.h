@@ -0,0 +1,117 @@
+#ifndef _OSMAND_CORE_CONTRACTION_HIERARCHY_H_
+#define _OSMAND_CORE_CONTRACTION_HIERARCHY_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    class IObfsCollection;
+    class IRoadCostModel;
+    class IQueryController;
+
+    // Contraction hierarchy is a road graph preprocessed for a single cost model: nodes are ordered by
+    // importance and shortcut edges are added so that any fastest path can be found by searching only
+    // upwards from both ends. File contains:
+    //  - header with signatures of source OBFs and of cost model it was built for;
+    //  - node positions, sorted so that node is found by binary search (junction with turn restrictions
+    //    is followed by its copies, one per restricted incoming road, that keep only allowed turns);
+    //  - edges (original and shortcuts), where shortcut references two edges it replaces;
+    //  - upward outgoing and upward incoming edges of each node, in compressed adjacency form.
+    class ContractionHierarchy_P;
+    class OSMAND_CORE_API ContractionHierarchy
+    {
+        Q_DISABLE_COPY_AND_MOVE(ContractionHierarchy);
+    public:
+        // Position where path may start (or end) and time needed to get from there to actual start (or finish)
+        struct OSMAND_CORE_API Endpoint
+        {
+            Endpoint();
+            Endpoint(const PointI position31, const float time);
+            ~Endpoint();
+
+            PointI position31;
+            float time;
+        };
+
+        struct OSMAND_CORE_API Path
+        {
+            Path();
+            ~Path();
+
+            // Positions of road points the path passes, from source endpoint to target endpoint
+            QVector<PointI> points31;
+            // In seconds, including times of endpoints
+            float time;
+            // In meters, excluding endpoints
+            double distance;
+            unsigned int settledNodesCount;
+        };
+
+        struct OSMAND_CORE_API BuildStatistics
+        {
+            BuildStatistics();
+            ~BuildStatistics();
+
+            unsigned int nodesCount;
+            unsigned int edgesCount;
+            unsigned int shortcutsCount;
+        };
+
+    private:
+        PrivateImplementation<ContractionHierarchy_P> _p;
+    protected:
+    public:
+        ContractionHierarchy(const QString& filename);
+        virtual ~ContractionHierarchy();
+
+        const QString filename;
+
+        bool isValid() const;
+        int getNodesCount() const;
+        int getEdgesCount() const;
+
+        // Checks that hierarchy was built from exactly these OBF files and for the same cost model.
+        // Stale hierarchy gives wrong routes, so it must not be used
+        bool isUpToDate(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel) const;
+        bool containsNode(const PointI& position31) const;
+
+        // Finds fastest path from any of sources to any of targets. Returns false if there's no path
+        // or none of endpoints is a node of hierarchy
+        bool findPath(
+            const QList<Endpoint>& sources,
+            const QList<Endpoint>& targets,
+            Path& outPath,
+            const IQueryController* const controller = nullptr) const;
+
+        // Finds fastest travel times from every source to every target, each given by its endpoints, using
+        // bucket-based many-to-many search. Times are stored row by row, infinity means there's no path
+        bool findTravelTimes(
+            const QVector< QList<Endpoint> >& sources,
+            const QVector< QList<Endpoint> >& targets,
+            QVector<float>& outTimes,
+            const unsigned int threadsCount = 0,
+            const IQueryController* const controller = nullptr) const;
+
+        // Loads all roads of routing sections in collection, contracts them and writes hierarchy to file
+        static bool build(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel,
+            const QString& outputFilename,
+            BuildStatistics* const outStatistics = nullptr,
+            const IQueryController* const controller = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_CONTRACTION_HIERARCHY_H_)
@@ -0,0 +1,59 @@
+#ifndef _OSMAND_CORE_BUDGETED_ROUTING_DATA_BLOCKS_CACHE_H_
+#define _OSMAND_CORE_BUDGETED_ROUTING_DATA_BLOCKS_CACHE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Data/ObfRoutingSectionReader.h>
+
+namespace OsmAnd
+{
+    namespace ObfRoutingSectionReader_Metrics
+    {
+        struct Metric_dataBlocksCache;
+    }
+
+    // Routing data blocks cache that keeps blocks after queries release them, as long as approximate memory
+    // occupied by their roads fits the budget. Once budget is exceeded, blocks that are neither referenced by
+    // any query nor pinned are evicted in CLOCK order, that approximates least-recently-used order.
+    class BudgetedRoutingDataBlocksCache_P;
+    class OSMAND_CORE_API BudgetedRoutingDataBlocksCache : public ObfRoutingSectionReader::DataBlocksCache
+    {
+        Q_DISABLE_COPY_AND_MOVE(BudgetedRoutingDataBlocksCache);
+
+    public:
+        static const size_t DefaultMemoryBudget;
+        static const double DefaultRouteCorridorInMeters;
+
+    private:
+        PrivateImplementation<BudgetedRoutingDataBlocksCache_P> _p;
+    protected:
+    public:
+        BudgetedRoutingDataBlocksCache(const size_t memoryBudget = DefaultMemoryBudget);
+        virtual ~BudgetedRoutingDataBlocksCache();
+
+        // In bytes
+        const size_t memoryBudget;
+
+        virtual void onBlockObtained(const std::shared_ptr<const DataBlock>& dataBlock, const bool wasRead);
+
+        // Pinned blocks are never evicted, even if budget is exceeded. Pinning applies both to blocks that
+        // are already kept and to blocks obtained later
+        void pinArea(const AreaI& area31);
+        // Pins blocks within given distance of route, e.g. of the route currently being followed
+        void pinRoute(const QVector<PointI>& points31, const double corridorInMeters = DefaultRouteCorridorInMeters);
+        void unpinAll();
+
+        // Drops all kept blocks that are not pinned, regardless of budget
+        void evictUnpinned();
+
+        void obtainMetric(ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache& outMetric) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_BUDGETED_ROUTING_DATA_BLOCKS_CACHE_H_)
@@ -29,23 +29,23 @@ namespace OsmAnd
         ~ObfAddressSectionReader();
     protected:
     public:
-        static void loadStreetGroups(const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const ObfAddressSectionInfo>& section,
+        static void loadStreetGroups(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const ObfAddressSectionInfo>& section,
             QList< std::shared_ptr<const StreetGroup> >* resultOut = nullptr,
             std::function<bool (const std::shared_ptr<const OsmAnd::StreetGroup>&)> visitor = nullptr,
             const IQueryController* const controller = nullptr,
             QSet<ObfAddressBlockType>* blockTypeFilter = nullptr);
 
-        static void loadStreetsFromGroup(const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const StreetGroup>& group,
+        static void loadStreetsFromGroup(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const StreetGroup>& group,
             QList< std::shared_ptr<const Street> >* resultOut = nullptr,
             std::function<bool (const std::shared_ptr<const OsmAnd::Street>&)> visitor = nullptr,
             const IQueryController* const controller = nullptr);
 
-        static void loadBuildingsFromStreet(const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const Street>& street,
+        static void loadBuildingsFromStreet(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const Street>& street,
             QList< std::shared_ptr<const Building> >* resultOut = nullptr,
             std::function<bool (const std::shared_ptr<const OsmAnd::Building>&)> visitor = nullptr,
             const IQueryController* const controller = nullptr);
 
-        static void loadIntersectionsFromStreet(const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const Street>& street,
+        static void loadIntersectionsFromStreet(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const Street>& street,
             QList< std::shared_ptr<const StreetIntersection> >* resultOut = nullptr,
             std::function<bool (const std::shared_ptr<const OsmAnd::StreetIntersection>&)> visitor = nullptr,
             const IQueryController* const controller = nullptr);
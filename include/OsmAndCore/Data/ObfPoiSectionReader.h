@@ -5,6 +5,10 @@
 #include <functional>
 
 #include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QList>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -24,15 +28,43 @@ namespace OsmAnd
         ~ObfPoiSectionReader();
     protected:
     public:
-        static void loadCategories(const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+        static void loadCategories(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
             QList< std::shared_ptr<const AmenityCategory> >& categories);
 
-        static void loadAmenities(const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+        static void loadAmenities(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
             const ZoomLevel zoom, uint32_t zoomDepth = 3, const AreaI* bbox31 = nullptr,
             QSet<uint32_t>* desiredCategories = nullptr,
             QList< std::shared_ptr<const Amenity> >* amenitiesOut = nullptr,
             std::function<bool(std::shared_ptr<const Amenity>)> visitor = nullptr,
             const IQueryController* const controller = nullptr);
+
+        // Uses name index of the section to reach only amenities which name (or latin name) has a word
+        // starting with given prefix. Comparison ignores case and diacritics.
+        static void searchAmenitiesByName(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+            const QString& namePrefix,
+            const AreaI* bbox31 = nullptr,
+            QSet<uint32_t>* desiredCategories = nullptr,
+            QList< std::shared_ptr<const Amenity> >* amenitiesOut = nullptr,
+            std::function<bool(std::shared_ptr<const Amenity>)> visitor = nullptr,
+            const IQueryController* const controller = nullptr);
+
+        // Walks tiles hierarchy of the section best-first by distance, so that only tiles that may contain
+        // one of 'count' nearest amenities of desired categories get decoded. Amenities are ordered from
+        // nearest to farthest. Category identifiers are specific to the section.
+        static void findNearestAmenities(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+            const PointI& position31,
+            const unsigned int count,
+            QSet<uint32_t>* desiredCategories,
+            QList< std::shared_ptr<const Amenity> >& outAmenities,
+            const IQueryController* const controller = nullptr);
+
+        // Same as above for many positions at once: tiles decoded for one position are reused by others
+        static void findNearestAmenities(const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+            const QVector<PointI>& positions31,
+            const unsigned int count,
+            QSet<uint32_t>* desiredCategories,
+            QVector< QList< std::shared_ptr<const Amenity> > >& outAmenities,
+            const IQueryController* const controller = nullptr);
     };
 }
 
@@ -69,6 +69,10 @@ namespace OsmAnd
                 const RoutingDataLevel dataLevel,
                 const AreaI blockBBox31,
                 const AreaI* const queryArea31 = nullptr) const;
+
+            // Called each time query obtains block that should be cached, after block was either read
+            // (wasRead is true) or referenced from cache. Query holds a reference to block during the call
+            virtual void onBlockObtained(const std::shared_ptr<const DataBlock>& dataBlock, const bool wasRead);
         };
 
     private:
@@ -68,6 +68,36 @@ namespace OsmAnd
 
             OsmAnd__ObfRoutingSectionReader_Metrics__Metric_loadRoads__FIELDS(EMIT_METRIC_FIELD);
 
+            virtual QString toString(const bool shortFormat = false, const QString& prefix = QString::null) const;
+        };
+
+#define OsmAnd__ObfRoutingSectionReader_Metrics__Metric_dataBlocksCache__FIELDS(FIELD_ACTION)       \
+        /* Number of blocks obtained from cache */                                                  \
+        FIELD_ACTION(unsigned int, hits, "");                                                       \
+                                                                                                    \
+        /* Number of blocks that had to be read */                                                  \
+        FIELD_ACTION(unsigned int, misses, "");                                                     \
+                                                                                                    \
+        /* Number of blocks evicted to fit memory budget */                                         \
+        FIELD_ACTION(unsigned int, evictions, "");                                                  \
+                                                                                                    \
+        /* Number of blocks kept in cache */                                                        \
+        FIELD_ACTION(unsigned int, residentBlocks, "");                                             \
+                                                                                                    \
+        /* Number of kept blocks that are pinned */                                                 \
+        FIELD_ACTION(unsigned int, pinnedBlocks, "");                                               \
+                                                                                                    \
+        /* Approximate memory occupied by roads of kept blocks (in kilobytes) */                    \
+        FIELD_ACTION(unsigned int, residentMemoryUsage, "KB");
+
+        struct OSMAND_CORE_API Metric_dataBlocksCache : public Metric
+        {
+            Metric_dataBlocksCache();
+            virtual ~Metric_dataBlocksCache();
+            virtual void reset();
+
+            OsmAnd__ObfRoutingSectionReader_Metrics__Metric_dataBlocksCache__FIELDS(EMIT_METRIC_FIELD);
+
             virtual QString toString(const bool shortFormat = false, const QString& prefix = QString::null) const;
         };
     }
@@ -25,6 +25,9 @@ namespace OsmAnd {
 
         uint32_t _stopsOffset;
         uint32_t _stopsLength;
+
+        uint32_t _stringTableOffset;
+        uint32_t _stringTableLength;
     public:
         virtual ~ObfTransportSectionInfo();
 
@@ -5,6 +5,7 @@
 #include <functional>
 
 #include <OsmAndCore/QtExtensions.h>
+#include <QList>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -13,15 +14,35 @@ namespace OsmAnd {
 
     class ObfReader;
     class ObfTransportSectionInfo;
+    class TransportStop;
+    class TransportRoute;
     class IQueryController;
 
     class OSMAND_CORE_API ObfTransportSectionReader
     {
+    public:
+        typedef std::function<bool (const std::shared_ptr<const OsmAnd::TransportStop>&)> VisitorFunction;
+
     private:
         ObfTransportSectionReader();
         ~ObfTransportSectionReader();
     protected:
     public:
+        static void loadStops(
+            const std::shared_ptr<const ObfReader>& reader,
+            const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const AreaI* const bbox31 = nullptr,
+            QList< std::shared_ptr<const OsmAnd::TransportStop> >* resultOut = nullptr,
+            const VisitorFunction visitor = nullptr,
+            const IQueryController* const controller = nullptr);
+
+        // Loads routes at given offsets, as referenced by stops of the same section
+        static void loadRoutes(
+            const std::shared_ptr<const ObfReader>& reader,
+            const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const QList<uint32_t>& routesOffsets,
+            QList< std::shared_ptr<const OsmAnd::TransportRoute> >* resultOut = nullptr,
+            const IQueryController* const controller = nullptr);
     };
 
 } // namespace OsmAnd
@@ -56,6 +56,9 @@ namespace OsmAnd
         QHash< uint32_t, QVector<uint32_t> > pointsTypes;
         QHash< ObfObjectId, RoadRestriction > restrictions;
 
+        // Approximate amount of memory occupied by road object and its data, in bytes
+        size_t getMemoryUsage() const;
+
     friend class OsmAnd::ObfRoutingSectionReader_P;
     };
 }
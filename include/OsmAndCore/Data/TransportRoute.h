@@ -0,0 +1,62 @@
+#ifndef _OSMAND_CORE_TRANSPORT_ROUTE_H_
+#define _OSMAND_CORE_TRANSPORT_ROUTE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QList>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+
+namespace OsmAnd
+{
+    class ObfTransportSectionReader_P;
+    class ObfTransportSectionInfo;
+
+    class OSMAND_CORE_API TransportRoute Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(TransportRoute);
+
+    public:
+        // Stop as it's stored in route, that has the same id as stop stored in stops tree
+        struct OSMAND_CORE_API Stop
+        {
+            Stop();
+            ~Stop();
+
+            int64_t id;
+            PointI position31;
+            QString name;
+            QString latinName;
+        };
+
+    private:
+    protected:
+        TransportRoute(const std::shared_ptr<const ObfTransportSectionInfo>& section);
+    public:
+        ~TransportRoute();
+
+        const std::shared_ptr<const ObfTransportSectionInfo> section;
+
+        // Offset of route within OBF file, as referenced by stops
+        uint32_t offset;
+        uint64_t id;
+        // E.g. "bus", "tram" or "subway"
+        QString type;
+        QString operatorName;
+        QString ref;
+        QString name;
+        QString latinName;
+        // In meters
+        uint32_t distance;
+
+        QList<Stop> forwardStops;
+        QList<Stop> reverseStops;
+
+    friend class OsmAnd::ObfTransportSectionReader_P;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TRANSPORT_ROUTE_H_)
@@ -0,0 +1,41 @@
+#ifndef _OSMAND_CORE_TRANSPORT_STOP_H_
+#define _OSMAND_CORE_TRANSPORT_STOP_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+
+namespace OsmAnd
+{
+    class ObfTransportSectionReader_P;
+    class ObfTransportSectionInfo;
+
+    class OSMAND_CORE_API TransportStop Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(TransportStop);
+    private:
+    protected:
+        TransportStop(const std::shared_ptr<const ObfTransportSectionInfo>& section);
+    public:
+        ~TransportStop();
+
+        const std::shared_ptr<const ObfTransportSectionInfo> section;
+
+        int64_t id;
+        PointI position31;
+        QString name;
+        QString latinName;
+
+        // Offsets of routes that serve this stop, within OBF file
+        QVector<uint32_t> routesOffsets;
+
+    friend class OsmAnd::ObfTransportSectionReader_P;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TRANSPORT_STOP_H_)
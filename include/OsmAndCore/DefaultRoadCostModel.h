@@ -0,0 +1,54 @@
+#ifndef _OSMAND_CORE_DEFAULT_ROAD_COST_MODEL_H_
+#define _OSMAND_CORE_DEFAULT_ROAD_COST_MODEL_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QHash>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/IRoadCostModel.h>
+
+namespace OsmAnd
+{
+    // Cost model based on 'highway' type of the road, 'maxspeed', 'oneway' and point tags
+    class OSMAND_CORE_API DefaultRoadCostModel : public IRoadCostModel
+    {
+        Q_DISABLE_COPY_AND_MOVE(DefaultRoadCostModel);
+
+    public:
+        enum class Profile
+        {
+            Car,
+            Bicycle,
+            Pedestrian,
+        };
+
+    private:
+        bool obtainHighwayType(const std::shared_ptr<const Road>& road, QString& outHighwayType, float* const outMaxSpeed) const;
+    protected:
+        // Speeds in kilometers per hour
+        QHash<QString, float> _speedsByHighwayType;
+        float _maxSpeed;
+        bool _oneWayAware;
+        bool _restrictionsAware;
+        float _trafficSignalsPenalty;
+    public:
+        DefaultRoadCostModel(const Profile profile = Profile::Car);
+        virtual ~DefaultRoadCostModel();
+
+        const Profile profile;
+
+        virtual QString getSignature() const;
+        virtual bool acceptsRoad(const std::shared_ptr<const Road>& road) const;
+        virtual RoadDirection getDirection(const std::shared_ptr<const Road>& road) const;
+        virtual float getSpeed(const std::shared_ptr<const Road>& road) const;
+        virtual float getMaxSpeed() const;
+        virtual float getPointPenalty(const std::shared_ptr<const Road>& road, const int pointIndex) const;
+        virtual bool isRestrictionsAware() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_DEFAULT_ROAD_COST_MODEL_H_)
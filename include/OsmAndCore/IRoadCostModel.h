@@ -0,0 +1,44 @@
+#ifndef _OSMAND_CORE_I_ROAD_COST_MODEL_H_
+#define _OSMAND_CORE_I_ROAD_COST_MODEL_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/Data/Road.h>
+
+namespace OsmAnd
+{
+    // Cost model is queried once per road when road is added to routing graph, never per edge relaxation
+    class OSMAND_CORE_API IRoadCostModel
+    {
+        Q_DISABLE_COPY_AND_MOVE(IRoadCostModel);
+    private:
+    protected:
+        IRoadCostModel();
+    public:
+        virtual ~IRoadCostModel();
+
+        // Identifies model together with its settings: data precomputed with one model is not valid for another
+        virtual QString getSignature() const = 0;
+
+        virtual bool acceptsRoad(const std::shared_ptr<const Road>& road) const = 0;
+        virtual RoadDirection getDirection(const std::shared_ptr<const Road>& road) const = 0;
+
+        // Speeds are in meters per second. Maximal speed has to be not less than any speed returned for a road,
+        // since it's used to estimate remaining time
+        virtual float getSpeed(const std::shared_ptr<const Road>& road) const = 0;
+        virtual float getMaxSpeed() const = 0;
+
+        // Extra time in seconds for passing given point of the road (traffic signals, barriers, etc.)
+        virtual float getPointPenalty(const std::shared_ptr<const Road>& road, const int pointIndex) const = 0;
+
+        // Whether turn restrictions of roads (no left turn, only straight on, etc.) have to be obeyed
+        virtual bool isRestrictionsAware() const = 0;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_I_ROAD_COST_MODEL_H_)
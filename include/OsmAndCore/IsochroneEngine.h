@@ -0,0 +1,123 @@
+#ifndef _OSMAND_CORE_ISOCHRONE_ENGINE_H_
+#define _OSMAND_CORE_ISOCHRONE_ENGINE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QList>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Data/MapObject.h>
+#include <OsmAndCore/Data/ObfRoutingSectionReader.h>
+
+namespace OsmAnd
+{
+    class IObfsCollection;
+    class IRoadCostModel;
+    class IQueryController;
+    class IMapObjectsProvider;
+
+    // Computes areas reachable from a position within given travel times. Single time-bounded Dijkstra
+    // search runs over road data loaded on demand, travel times of reached roads are rasterized into
+    // a grid, and outlines of grid cells reachable within each time band are traced into polygons.
+    class IsochroneEngine_P;
+    class OSMAND_CORE_API IsochroneEngine
+    {
+        Q_DISABLE_COPY_AND_MOVE(IsochroneEngine);
+
+    public:
+        struct OSMAND_CORE_API Polygon
+        {
+            Polygon();
+            ~Polygon();
+
+            // Rings are closed: last point is equal to the first one
+            QVector<PointI> outerRing31;
+            QList< QVector<PointI> > innerRings31;
+        };
+
+        struct OSMAND_CORE_API Isochrone
+        {
+            Isochrone();
+            ~Isochrone();
+
+            // In seconds
+            float time;
+            QList<Polygon> polygons;
+        };
+
+        class OSMAND_CORE_API MapObject : public OsmAnd::MapObject
+        {
+            Q_DISABLE_COPY_AND_MOVE(MapObject);
+
+        public:
+            enum {
+                MaxBandsCount = 8,
+            };
+
+            class OSMAND_CORE_API EncodingDecodingRules : public OsmAnd::MapObject::EncodingDecodingRules
+            {
+                Q_DISABLE_COPY_AND_MOVE(EncodingDecodingRules);
+
+            private:
+            protected:
+                virtual void createRequiredRules(uint32_t& lastUsedRuleId);
+            public:
+                EncodingDecodingRules();
+                virtual ~EncodingDecodingRules();
+
+                // Quick-access rules
+                uint32_t isochrone_encodingRuleId;
+                // Band index, starting from the fastest one
+                uint32_t isochroneBand_encodingRuleIds[MaxBandsCount];
+
+                virtual uint32_t addRule(const uint32_t ruleId, const QString& ruleTag, const QString& ruleValue);
+            };
+
+        private:
+        protected:
+        public:
+            MapObject(const Polygon& polygon, const float time, const int bandIndex);
+            virtual ~MapObject();
+
+            const float time;
+            const int bandIndex;
+
+            // Default encoding-decoding rules
+            static std::shared_ptr<const EncodingDecodingRules> defaultEncodingDecodingRules;
+        };
+
+    private:
+        PrivateImplementation<IsochroneEngine_P> _p;
+    protected:
+    public:
+        IsochroneEngine(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel,
+            const std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache>& cache = nullptr);
+        virtual ~IsochroneEngine();
+
+        const std::shared_ptr<const IObfsCollection> obfsCollection;
+        const std::shared_ptr<const IRoadCostModel> costModel;
+        const std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache> cache;
+
+        // Computes isochrone for each of times (in seconds, at most MapObject::MaxBandsCount of them) in one pass.
+        // Cell size defines precision of polygons; it's increased if area is too large for the grid
+        bool compute(
+            const PointI origin31,
+            const QList<float>& times,
+            QList<Isochrone>& outIsochrones,
+            const double cellSizeInMeters = 100.0,
+            const IQueryController* const controller = nullptr) const;
+
+        // Provider of polygons of isochrones, tagged 'osmand=isochrone' and 'isochrone_band=<index>'
+        static std::shared_ptr<IMapObjectsProvider> createMapObjectsProvider(const QList<Isochrone>& isochrones);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ISOCHRONE_ENGINE_H_)
@@ -26,6 +26,7 @@ namespace OsmAnd
         /* Time elapsed for symbols stage */                                                                    \
         FIELD_ACTION(float, elapsedTimeForSymbolsStage, "s");                                                   \
         FIELD_ACTION(float, elapsedTimeForPreparingSymbols, "s");                                               \
+        FIELD_ACTION(bool, preparingSymbolsSkipped, "");                                                        \
         FIELD_ACTION(float, elapsedTimeForPublishingPreparedSymbols, "s");                                      \
         FIELD_ACTION(float, elapsedTimeForObtainingRenderableSymbols, "s");                                     \
         FIELD_ACTION(float, elapsedTimeForObtainingRenderableSymbolsWithLock, "s");                             \
@@ -62,6 +63,9 @@ namespace OsmAnd
         FIELD_ACTION(unsigned int, onPathSymbolsRendered, "");                                                  \
         FIELD_ACTION(float, elapsedTimeForOnSurfaceSymbolsRendering, "s");                                      \
         FIELD_ACTION(unsigned int, onSurfaceSymbolsRendered, "");                                               \
+        FIELD_ACTION(unsigned int, symbolsDrawCalls, "");                                                       \
+        FIELD_ACTION(unsigned int, symbolsBatchedDrawCalls, "");                                                \
+        FIELD_ACTION(unsigned int, symbolsBatchedQuads, "");                                                    \
                                                                                                                 \
         /* Time elapsed for debug stage */                                                                      \
         FIELD_ACTION(float, elapsedTimeForDebugStage, "s");                                                     \
@@ -0,0 +1,68 @@
+#ifndef _OSMAND_CORE_ELEVATION_PYRAMID_TILE_PROVIDER_H_
+#define _OSMAND_CORE_ELEVATION_PYRAMID_TILE_PROVIDER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Map/IMapElevationDataProvider.h>
+
+namespace OsmAnd
+{
+    // Elevation pyramid is a single pre-tiled file that is memory-mapped as a whole:
+    //  - header with tile size, samples encoding and table of levels (one per zoom);
+    //  - per level, sorted index of tile identifiers;
+    //  - per level, fixed-size tiles addressed directly by position in the index.
+    // Tiles encoded as Float32 are returned without any copy as slices of mapped memory,
+    // tiles encoded as QuantizedInt16 take half of the space and are expanded on request.
+    class ElevationPyramidTileProvider_P;
+    class OSMAND_CORE_API ElevationPyramidTileProvider : public IMapElevationDataProvider
+    {
+        Q_DISABLE_COPY_AND_MOVE(ElevationPyramidTileProvider);
+    public:
+        enum class Encoding : uint32_t
+        {
+            Float32 = 0,
+            QuantizedInt16 = 1,
+        };
+
+    private:
+        PrivateImplementation<ElevationPyramidTileProvider_P> _p;
+    protected:
+    public:
+        ElevationPyramidTileProvider(const QString& filename);
+        virtual ~ElevationPyramidTileProvider();
+
+        const QString filename;
+
+        bool isValid() const;
+        Encoding getEncoding() const;
+
+        virtual ZoomLevel getMinZoom() const;
+        virtual ZoomLevel getMaxZoom() const;
+        virtual uint32_t getTileSize() const;
+        virtual bool obtainData(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            std::shared_ptr<IMapTiledDataProvider::Data>& outTiledData,
+            std::shared_ptr<Metric>* pOutMetric = nullptr,
+            const IQueryController* const queryController = nullptr);
+
+        // Converts tiles stored in TileDB (as used by HeightmapTileProvider) into elevation pyramid.
+        // Levels below the lowest zoom present in TileDB are generated down to minZoom by downsampling.
+        static bool convertFromTileDB(
+            const QString& tileDbDataPath,
+            const QString& tileDbIndexFilename,
+            const QString& outputFilename,
+            const Encoding encoding = Encoding::Float32,
+            const ZoomLevel minZoom = MinZoomLevel);
+
+        static const uint32_t defaultTileSize;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ELEVATION_PYRAMID_TILE_PROVIDER_H_)
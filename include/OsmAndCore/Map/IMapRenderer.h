@@ -74,6 +74,10 @@ namespace OsmAnd
         virtual void forcedFrameInvalidate() = 0;
         virtual void forcedGpuProcessingCycle() = 0;
 
+        virtual bool isLastFrameSkipped() const = 0;
+        virtual FramesStatistics getFramesStatistics() const = 0;
+        virtual void resetFramesStatistics() = 0;
+
         virtual unsigned int getSymbolsCount() const = 0;
         virtual QList< std::shared_ptr<const MapSymbol> > getSymbolsAt(const PointI& screenPoint) const = 0;
         virtual bool isSymbolsUpdateSuspended(int* const pOutSuspendsCounter = nullptr) const = 0;
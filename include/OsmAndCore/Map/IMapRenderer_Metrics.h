@@ -22,7 +22,32 @@ namespace OsmAnd
         FIELD_ACTION(float, elapsedTimeForUpdatesProcessing, "s");                      \
                                                                                         \
         /* Time elapsed to process all scheduled calls in render thread */              \
-        FIELD_ACTION(float, elapsedTimeForRenderThreadDispatcher, "s");
+        FIELD_ACTION(float, elapsedTimeForRenderThreadDispatcher, "s");                 \
+                                                                                        \
+        /* Time elapsed to compact atlas textures */                                    \
+        FIELD_ACTION(float, elapsedTimeForAtlasTexturesCompaction, "s");                \
+                                                                                        \
+        /* Number of symbols moved between atlas textures */                            \
+        FIELD_ACTION(unsigned int, symbolsAtlasAreasMigrated, "");                      \
+                                                                                        \
+        /* Number of symbols atlas textures */                                          \
+        FIELD_ACTION(unsigned int, symbolsAtlasTexturesCount, "");                      \
+                                                                                        \
+        /* Part of texels of symbols atlas textures occupied by symbols */              \
+        FIELD_ACTION(float, symbolsAtlasTexturesOccupancy, "");                         \
+                                                                                        \
+        /* Part of free texels of symbols atlas textures left between symbols */        \
+        FIELD_ACTION(float, symbolsAtlasTexturesFragmentation, "");                     \
+                                                                                        \
+        /* Number of zoom gestures that ended since previous update with metric */      \
+        FIELD_ACTION(unsigned int, zoomGesturesFinished, "");                           \
+                                                                                        \
+        /* Number of tiled resources requested during these zoom gestures */            \
+        FIELD_ACTION(unsigned int, tiledResourcesRequested, "");                        \
+                                                                                        \
+        /* Number of map layer tiles not requested during these zoom gestures while */  \
+        /* zoom was not settled and other zooms were shown instead, each tile once */   \
+        FIELD_ACTION(unsigned int, tiledResourcesRequestsPostponed, "");
         struct OSMAND_CORE_API Metric_update : public Metric
         {
             Metric_update();
@@ -50,7 +75,10 @@ namespace OsmAnd
 
 #define OsmAnd__IMapRenderer_Metrics__Metric_renderFrame__FIELDS(FIELD_ACTION)          \
         /* Total elapsed time */                                                        \
-        FIELD_ACTION(float, elapsedTime, "s");
+        FIELD_ACTION(float, elapsedTime, "s");                                          \
+                                                                                        \
+        /* Frame was not rendered, since nothing was changed */                         \
+        FIELD_ACTION(bool, frameSkipped, "");
         struct OSMAND_CORE_API Metric_renderFrame : public Metric
         {
             Metric_renderFrame();
@@ -0,0 +1,62 @@
+#ifndef _OSMAND_CORE_I_VECTOR_MAP_LAYER_PROVIDER_H_
+#define _OSMAND_CORE_I_VECTOR_MAP_LAYER_PROVIDER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QtGlobal>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/Color.h>
+#include <OsmAndCore/Map/MapCommonTypes.h>
+#include <OsmAndCore/Map/IMapLayerProvider.h>
+
+namespace OsmAnd
+{
+    class OSMAND_CORE_API IVectorMapLayerProvider : public IMapLayerProvider
+    {
+        Q_DISABLE_COPY_AND_MOVE(IVectorMapLayerProvider);
+    public:
+#pragma pack(push, 1)
+        struct Vertex
+        {
+            // XY coordinates inside tile, normalized to [0.0 .. 1.0]: Y down, X right.
+            // Vertices may lie outside of that range, such geometry is clipped by renderer
+            float positionXY[2];
+
+            // Straight (not premultiplied) color
+            ColorARGB color;
+        };
+#pragma pack(pop)
+
+        class OSMAND_CORE_API Data : public IMapLayerProvider::Data
+        {
+            Q_DISABLE_COPY_AND_MOVE(Data);
+        private:
+        protected:
+        public:
+            Data(
+                const TileId tileId,
+                const ZoomLevel zoom,
+                const QVector<Vertex>& vertices,
+                const RetainableCacheMetadata* const pRetainableCacheMetadata = nullptr);
+            virtual ~Data();
+
+            // Triangles list, drawn in order
+            QVector<Vertex> vertices;
+        };
+
+    private:
+    protected:
+        IVectorMapLayerProvider();
+    public:
+        virtual ~IVectorMapLayerProvider();
+
+        virtual uint32_t getTileSize() const = 0;
+        virtual float getTileDensityFactor() const = 0;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_I_VECTOR_MAP_LAYER_PROVIDER_H_)
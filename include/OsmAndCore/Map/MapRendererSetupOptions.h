@@ -31,6 +31,28 @@ namespace OsmAnd
 
         // Limit maximal number of raster map layers drawn in batch. 0 means "maximal as limited by platform"
         unsigned int maxNumberOfRasterMapLayersInBatch;
+
+        // Budget of resources uploading done by render thread (when GPU worker is not enabled) per frame:
+        // time in seconds and size of uploaded data in bytes. Resources visible on screen are uploaded
+        // first, then ones of closest zoom levels. At least one resource is uploaded per frame.
+        // 0 means "not limited"
+        float resourcesUploadTimeBudgetPerFrame;
+        unsigned int resourcesUploadBytesBudgetPerFrame;
+
+        // Maximal number of symbols moved per frame out of sparse atlas textures, so that these textures
+        // may be released. Atlases are compacted by render thread only when GPU worker is not enabled.
+        // 0 means "don't compact"
+        unsigned int atlasTexturesCompactionAreasPerFrame;
+
+        // Time in seconds after last change of zoom, during which tiles of new zoom are not requested if
+        // tiles of neighbour zoom levels can be shown instead. This way tiles of zoom levels that are just
+        // passed by zoom gesture are not requested at all. 0 means "request immediately"
+        float tilesRequestsDelayAfterZoomChange;
+
+        // Don't render frames that would be identical to previously rendered one, and re-prepare symbols
+        // only when anything they depend on was changed. Host has to preserve contents of previous frame,
+        // e.g. by not swapping buffers when IMapRenderer::isLastFrameSkipped() reports so
+        bool skipUnchangedFrames;
     };
 }
 
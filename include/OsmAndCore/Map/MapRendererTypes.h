@@ -174,6 +174,25 @@ namespace OsmAnd
                 color != r.color;
         }
     };
+
+    struct FramesStatistics Q_DECL_FINAL
+    {
+        FramesStatistics()
+            : renderedFramesCount(0)
+            , skippedFramesCount(0)
+            , activeTime(0.0f)
+            , idleTime(0.0f)
+        {
+        }
+
+        // Frames rendered and frames skipped since nothing was changed
+        unsigned int renderedFramesCount;
+        unsigned int skippedFramesCount;
+
+        // Time in seconds spent rendering frames and time spent outside of rendering
+        float activeTime;
+        float idleTime;
+    };
 }
 
 #endif // !defined(_OSMAND_CORE_MAP_RENDERER_TYPES_H_)
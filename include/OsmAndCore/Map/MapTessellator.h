@@ -0,0 +1,52 @@
+#ifndef _OSMAND_CORE_MAP_TESSELLATOR_H_
+#define _OSMAND_CORE_MAP_TESSELLATOR_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <functional>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Map/MapCommonTypes.h>
+#include <OsmAndCore/Map/MapPrimitiviser.h>
+#include <OsmAndCore/Map/IVectorMapLayerProvider.h>
+#include <OsmAndCore/Map/MapTessellator_Metrics.h>
+
+namespace OsmAnd
+{
+    class MapPresentationEnvironment;
+
+    // Converts primitivised polygons and polylines of a tile into triangles that are drawn by GPU
+    // without any intermediate bitmap. Style is evaluated the same way MapRasterizer does, but
+    // path effects, shaders, shadows and path icons are not supported.
+    class MapTessellator_P;
+    class OSMAND_CORE_API MapTessellator
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapTessellator);
+    public:
+        typedef IVectorMapLayerProvider::Vertex Vertex;
+
+    private:
+        PrivateImplementation<MapTessellator_P> _p;
+    protected:
+    public:
+        MapTessellator(const std::shared_ptr<const MapPresentationEnvironment>& mapPresentationEnvironment);
+        virtual ~MapTessellator();
+
+        const std::shared_ptr<const MapPresentationEnvironment> mapPresentationEnvironment;
+
+        // Appends triangles to outVertices, positions are normalized to area31
+        void tessellate(
+            const AreaI area31,
+            const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
+            QVector<Vertex>& outVertices,
+            const bool fillBackground = true,
+            MapTessellator_Metrics::Metric_tessellate* const metric = nullptr,
+            const IQueryController* const controller = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_TESSELLATOR_H_)
@@ -0,0 +1,44 @@
+#ifndef _OSMAND_CORE_MAP_TESSELLATOR_METRICS_H_
+#define _OSMAND_CORE_MAP_TESSELLATOR_METRICS_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <functional>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Metrics.h>
+
+namespace OsmAnd
+{
+    namespace MapTessellator_Metrics
+    {
+#define OsmAnd__MapTessellator_Metrics__Metric_tessellate__FIELDS(FIELD_ACTION)     \
+        /* Total elapsed time */                                                    \
+        FIELD_ACTION(float, elapsedTime, "s");                                      \
+                                                                                    \
+        /* Polygons */                                                              \
+        FIELD_ACTION(unsigned int, polygonsTriangulated, "");                       \
+        FIELD_ACTION(float, elapsedTimeForPolygons, "s");                           \
+                                                                                    \
+        /* Polylines */                                                             \
+        FIELD_ACTION(unsigned int, polylinesExtruded, "");                          \
+        FIELD_ACTION(float, elapsedTimeForPolylines, "s");                          \
+                                                                                    \
+        /* Output */                                                                \
+        FIELD_ACTION(unsigned int, trianglesCount, "");
+        struct OSMAND_CORE_API Metric_tessellate : public Metric
+        {
+            Metric_tessellate();
+            virtual ~Metric_tessellate();
+            virtual void reset();
+
+            OsmAnd__MapTessellator_Metrics__Metric_tessellate__FIELDS(EMIT_METRIC_FIELD);
+
+            virtual QString toString(const bool shortFormat = false, const QString& prefix = QString::null) const;
+        };
+    }
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_TESSELLATOR_METRICS_H_)
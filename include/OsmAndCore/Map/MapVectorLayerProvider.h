@@ -0,0 +1,76 @@
+#ifndef _OSMAND_CORE_MAP_VECTOR_LAYER_PROVIDER_H_
+#define _OSMAND_CORE_MAP_VECTOR_LAYER_PROVIDER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Map/IVectorMapLayerProvider.h>
+#include <OsmAndCore/Map/MapTessellator_Metrics.h>
+#include <OsmAndCore/Map/MapPrimitivesProvider.h>
+
+namespace OsmAnd
+{
+    // Map layer that is drawn by GPU from triangles of primitivised map objects, instead of
+    // being rasterized by Skia into bitmaps
+    class MapVectorLayerProvider_P;
+    class OSMAND_CORE_API MapVectorLayerProvider : public IVectorMapLayerProvider
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapVectorLayerProvider);
+    public:
+        class OSMAND_CORE_API Data : public IVectorMapLayerProvider::Data
+        {
+            Q_DISABLE_COPY_AND_MOVE(Data);
+        private:
+        protected:
+        public:
+            Data(
+                const TileId tileId,
+                const ZoomLevel zoom,
+                const QVector<Vertex>& vertices,
+                const std::shared_ptr<const MapPrimitivesProvider::Data>& binaryMapData,
+                const RetainableCacheMetadata* const pRetainableCacheMetadata = nullptr);
+            virtual ~Data();
+
+            std::shared_ptr<const MapPrimitivesProvider::Data> binaryMapData;
+        };
+
+    private:
+        PrivateImplementation<MapVectorLayerProvider_P> _p;
+    protected:
+    public:
+        MapVectorLayerProvider(
+            const std::shared_ptr<MapPrimitivesProvider>& primitivesProvider,
+            const bool fillBackground = true);
+        virtual ~MapVectorLayerProvider();
+
+        const std::shared_ptr<MapPrimitivesProvider> primitivesProvider;
+        const bool fillBackground;
+
+        virtual float getTileDensityFactor() const;
+        virtual uint32_t getTileSize() const;
+
+        virtual bool obtainData(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            std::shared_ptr<IMapTiledDataProvider::Data>& outTiledData,
+            std::shared_ptr<Metric>* pOutMetric = nullptr,
+            const IQueryController* const queryController = nullptr);
+
+        bool obtainData(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            std::shared_ptr<Data>& outTiledData,
+            MapTessellator_Metrics::Metric_tessellate* const metric,
+            const IQueryController* const queryController);
+
+        virtual ZoomLevel getMinZoom() const;
+        virtual ZoomLevel getMaxZoom() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_VECTOR_LAYER_PROVIDER_H_)
@@ -0,0 +1,81 @@
+#ifndef _OSMAND_CORE_MAP_VIEWS_BATCH_RENDERER_H_
+#define _OSMAND_CORE_MAP_VIEWS_BATCH_RENDERER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <functional>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QList>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/Callable.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+class SkBitmap;
+
+namespace OsmAnd
+{
+    class IMapRenderer;
+
+    // Renders many views with the same map renderer one after another, e.g. to produce images offscreen.
+    // Views are reordered so that consecutive ones share as many tiles as possible, so resources of previous
+    // views that are still in GPU and caches of providers are reused. Renderer has to be set up and have
+    // rendering initialized in OpenGL context that is current on calling thread.
+    class MapViewsBatchRenderer_P;
+    class OSMAND_CORE_API MapViewsBatchRenderer
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapViewsBatchRenderer);
+    public:
+        struct OSMAND_CORE_API View Q_DECL_FINAL
+        {
+            View();
+            ~View();
+
+            // Anything that identifies view for caller, e.g. filename of image
+            QString name;
+            PointI target31;
+            float zoom;
+            float azimuth;
+            float elevationAngle;
+        };
+
+        struct OSMAND_CORE_API ViewStatistics Q_DECL_FINAL
+        {
+            ViewStatistics();
+            ~ViewStatistics();
+
+            // In seconds, sorted ascending
+            QVector<float> framesTimes;
+            float elapsedTime;
+        };
+
+        // Image is null if view failed to be rendered, and error tells why
+        OSMAND_CALLABLE(ViewRenderedCallback,
+            void,
+            const View& view,
+            const std::shared_ptr<const SkBitmap>& image,
+            const ViewStatistics& statistics,
+            const QString& error);
+
+    private:
+        PrivateImplementation<MapViewsBatchRenderer_P> _p;
+    protected:
+    public:
+        MapViewsBatchRenderer(const std::shared_ptr<IMapRenderer>& renderer);
+        virtual ~MapViewsBatchRenderer();
+
+        const std::shared_ptr<IMapRenderer> renderer;
+
+        // Reports each view as soon as it's rendered. View that failed or took longer than viewTimeout seconds
+        // is reported with error and doesn't stop the following ones. Returns number of views rendered
+        unsigned int render(
+            const QList<View>& views,
+            const ViewRenderedCallback callback,
+            const float viewTimeout = 10.0f * 60.0f) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_VIEWS_BATCH_RENDERER_H_)
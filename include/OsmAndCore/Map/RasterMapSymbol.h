@@ -10,6 +10,7 @@
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
 #include <OsmAndCore/Callable.h>
+#include <OsmAndCore/SdfGlyphAtlas.h>
 #include <OsmAndCore/Map/MapSymbol.h>
 
 namespace OsmAnd
@@ -26,6 +27,9 @@ namespace OsmAnd
         virtual ~RasterMapSymbol();
 
         std::shared_ptr<const SkBitmap> bitmap;
+        // Text drawn from glyphs of SDF atlas has no bitmap. Glyph run is kept after upload to GPU,
+        // since quads are placed every frame
+        std::shared_ptr<const SdfGlyphAtlas::GlyphRun> sdfGlyphRun;
         PointI size;
         QString content;
         LanguageId languageId;
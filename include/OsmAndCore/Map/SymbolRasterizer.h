@@ -12,8 +12,10 @@
 #include <OsmAndCore/PrivateImplementation.h>
 #include <OsmAndCore/Callable.h>
 #include <OsmAndCore/TextRasterizer.h>
+#include <OsmAndCore/SdfGlyphAtlas.h>
 #include <OsmAndCore/Map/MapCommonTypes.h>
 #include <OsmAndCore/Map/MapPrimitiviser.h>
+#include <OsmAndCore/Map/SymbolRasterizer_Metrics.h>
 
 class SkCanvas;
 class SkBitmap;
@@ -65,6 +67,8 @@ namespace OsmAnd
             const std::shared_ptr<const MapPrimitiviser::Symbol> primitiveSymbol;
 
             std::shared_ptr<const SkBitmap> bitmap;
+            // Set instead of bitmap for text drawn from glyphs of SDF atlas
+            std::shared_ptr<const SdfGlyphAtlas::GlyphRun> sdfGlyphRun;
             int order;
             ContentType contentType;
             QString content;
@@ -111,22 +115,42 @@ namespace OsmAnd
             bool,
             const std::shared_ptr<const MapObject>& mapObject);*/
 
+        // Size of rasterized text labels kept for reuse by all tiles, in bytes
+        static const size_t DefaultTextCacheSizeLimit;
+
+        enum class TextMode
+        {
+            // Every label is rasterized into its own bitmap
+            Bitmap,
+            // Labels without shields are laid out as glyph quads over shared SDF glyph atlas
+            SdfGlyphs,
+        };
+
     private:
         PrivateImplementation<SymbolRasterizer_P> _p;
     protected:
     public:
         SymbolRasterizer(
-            const std::shared_ptr<const TextRasterizer>& textRasterizer = TextRasterizer::getDefault());
+            const std::shared_ptr<const TextRasterizer>& textRasterizer = TextRasterizer::getDefault(),
+            const size_t textCacheSizeLimit = DefaultTextCacheSizeLimit,
+            const TextMode textMode = TextMode::Bitmap);
         virtual ~SymbolRasterizer();
 
         const std::shared_ptr<const TextRasterizer> textRasterizer;
+        const size_t textCacheSizeLimit;
+        const TextMode textMode;
+        // Atlas of glyphs of fonts of text rasterizer, only present in SdfGlyphs mode
+        const std::shared_ptr<const SdfGlyphAtlas> sdfGlyphAtlas;
 
         virtual void rasterize(
             const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
             QList< std::shared_ptr<const RasterizedSymbolsGroup> >& outSymbolsGroups,
             const float scaleFactor = 1.0f,
             const FilterByMapObject filter = nullptr,
-            const IQueryController* const controller = nullptr) const;
+            const IQueryController* const controller = nullptr,
+            SymbolRasterizer_Metrics::Metric_rasterize* const metric = nullptr) const;
+
+        void clearTextCache() const;
     };
 }
 
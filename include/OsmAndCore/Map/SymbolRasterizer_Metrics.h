@@ -0,0 +1,44 @@
+#ifndef _OSMAND_CORE_SYMBOL_RASTERIZER_METRICS_H_
+#define _OSMAND_CORE_SYMBOL_RASTERIZER_METRICS_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <functional>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Metrics.h>
+
+namespace OsmAnd
+{
+    namespace SymbolRasterizer_Metrics
+    {
+#define OsmAnd__SymbolRasterizer_Metrics__Metric_rasterize__FIELDS(FIELD_ACTION)    \
+        /* Total elapsed time */                                                    \
+        FIELD_ACTION(float, elapsedTime, "s");                                      \
+                                                                                    \
+        /* Text symbols */                                                          \
+        FIELD_ACTION(float, elapsedTimeForTextSymbols, "s");                        \
+        FIELD_ACTION(unsigned int, textSymbols, "");                                \
+        FIELD_ACTION(unsigned int, textCacheHits, "");                              \
+        FIELD_ACTION(unsigned int, textCacheJoins, "");                             \
+        FIELD_ACTION(unsigned int, textCacheMisses, "");                            \
+                                                                                    \
+        /* Icon symbols */                                                          \
+        FIELD_ACTION(float, elapsedTimeForIconSymbols, "s");                        \
+        FIELD_ACTION(unsigned int, iconSymbols, "");
+        struct OSMAND_CORE_API Metric_rasterize : public Metric
+        {
+            Metric_rasterize();
+            virtual ~Metric_rasterize();
+            virtual void reset();
+
+            OsmAnd__SymbolRasterizer_Metrics__Metric_rasterize__FIELDS(EMIT_METRIC_FIELD);
+
+            virtual QString toString(const bool shortFormat = false, const QString& prefix = QString::null) const;
+        };
+    }
+}
+
+#endif // !defined(_OSMAND_CORE_SYMBOL_RASTERIZER_METRICS_H_)
@@ -0,0 +1,50 @@
+#ifndef _OSMAND_CORE_PROFILE_ROAD_COST_MODEL_H_
+#define _OSMAND_CORE_PROFILE_ROAD_COST_MODEL_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QHash>
+#include <QMutex>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/IRoadCostModel.h>
+#include <OsmAndCore/Routing/RoutingProfile.h>
+
+namespace OsmAnd
+{
+    class RoutingProfileContext;
+
+    // Cost model that evaluates rulesets of a routing profile loaded from routing configuration (routing.xml).
+    // Profile is evaluated through its compiled per-section tables, so each distinct combination of road
+    // types is evaluated only once
+    class OSMAND_CORE_API ProfileRoadCostModel : public IRoadCostModel
+    {
+        Q_DISABLE_COPY_AND_MOVE(ProfileRoadCostModel);
+    private:
+        // Compiled tables are filled lazily, while graphs may be built from several threads
+        mutable QMutex _contextMutex;
+        std::shared_ptr<RoutingProfileContext> _context;
+    protected:
+    public:
+        ProfileRoadCostModel(
+            const std::shared_ptr<RoutingProfile>& profile,
+            const QHash<QString, QString>& parameters = QHash<QString, QString>());
+        virtual ~ProfileRoadCostModel();
+
+        const std::shared_ptr<RoutingProfile> profile;
+        const QHash<QString, QString> parameters;
+
+        virtual QString getSignature() const;
+        virtual bool acceptsRoad(const std::shared_ptr<const Road>& road) const;
+        virtual RoadDirection getDirection(const std::shared_ptr<const Road>& road) const;
+        virtual float getSpeed(const std::shared_ptr<const Road>& road) const;
+        virtual float getMaxSpeed() const;
+        virtual float getPointPenalty(const std::shared_ptr<const Road>& road, const int pointIndex) const;
+        virtual bool isRestrictionsAware() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_PROFILE_ROAD_COST_MODEL_H_)
@@ -0,0 +1,89 @@
+#ifndef _OSMAND_CORE_REVERSE_GEOCODER_H_
+#define _OSMAND_CORE_REVERSE_GEOCODER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    class IObfsCollection;
+    class IQueryController;
+
+    // Finds addresses nearest to positions. Address sections have no spatial access path, so all their
+    // buildings, interpolation lines and street points are collected once into a grid index of flat arrays.
+    // Index is built lazily on first query and, if filename is given, persisted there and loaded next time
+    // as long as OBF files did not change. File contains:
+    //  - header with signature of source OBFs;
+    //  - strings pool (UTF-8) with offsets of strings;
+    //  - settlements and streets, referencing names in strings pool;
+    //  - entries (points or interpolation segments) sorted by grid cell, and ranges of entries per cell.
+    class ReverseGeocoder_P;
+    class OSMAND_CORE_API ReverseGeocoder
+    {
+        Q_DISABLE_COPY_AND_MOVE(ReverseGeocoder);
+
+    public:
+        struct OSMAND_CORE_API Address
+        {
+            Address();
+            ~Address();
+
+            // Empty if nearest address is a street itself
+            QString houseNumber;
+            QString postcode;
+            QString streetName;
+            QString streetLatinName;
+            QString settlementName;
+            QString settlementLatinName;
+            // Position of address nearest to query, on interpolation line if address is interpolated
+            PointI position31;
+            // In meters
+            double distance;
+        };
+
+        static const double DefaultMaxDistance;
+
+    private:
+        PrivateImplementation<ReverseGeocoder_P> _p;
+    protected:
+    public:
+        ReverseGeocoder(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const QString& indexFilename = QString());
+        virtual ~ReverseGeocoder();
+
+        const std::shared_ptr<const IObfsCollection> obfsCollection;
+        const QString indexFilename;
+
+        // Loads or builds index, if that was not done yet. Queries do this implicitly
+        bool prepareIndex(const IQueryController* const controller = nullptr) const;
+        bool isIndexPrepared() const;
+        int getEntriesCount() const;
+
+        // Returns false if there's no address within given distance
+        bool findNearestAddress(
+            const PointI position31,
+            Address& outAddress,
+            const double maxDistance = DefaultMaxDistance,
+            const IQueryController* const controller = nullptr) const;
+
+        // Address of position N is stored at N, positions with nothing nearby get address with negative distance.
+        // Returns count of positions that got addresses
+        unsigned int findNearestAddresses(
+            const QVector<PointI>& positions31,
+            QVector<Address>& outAddresses,
+            const double maxDistance = DefaultMaxDistance,
+            const IQueryController* const controller = nullptr) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_REVERSE_GEOCODER_H_)
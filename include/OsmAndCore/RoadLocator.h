@@ -5,6 +5,7 @@
 
 #include <OsmAndCore/QtExtensions.h>
 #include <QList>
+#include <QVector>
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/CommonTypes.h>
@@ -16,11 +17,37 @@ namespace OsmAnd
 {
     class IObfsCollection;
     class Road;
+    class IQueryController;
 
     class RoadLocator_P;
     class OSMAND_CORE_API RoadLocator : public IRoadLocator
     {
         Q_DISABLE_COPY_AND_MOVE(RoadLocator);
+    public:
+        enum class MatchingMode
+        {
+            // Each point is snapped to the nearest road segment independently
+            Nearest,
+
+            // Hidden Markov model solved with Viterbi algorithm: candidates are scored by distance to point
+            // and by consistency of travelled distance between consecutive points
+            Continuous,
+        };
+
+        struct OSMAND_CORE_API MatchedPoint
+        {
+            MatchedPoint();
+            ~MatchedPoint();
+
+            // Null if there was no road within radius
+            std::shared_ptr<const Road> road;
+            // Index of the end point of matched road segment, same as in findNearestRoad()
+            int roadPointIndex;
+            // Projection of original point onto matched road segment
+            PointI position31;
+            double distance;
+        };
+
     private:
         PrivateImplementation<RoadLocator_P> _p;
     protected:
@@ -57,6 +84,15 @@ namespace OsmAnd
             const RoutingDataLevel dataLevel,
             QList< std::shared_ptr<const ObfRoutingSectionReader::DataBlock> >* const outReferencedCacheEntries = nullptr) const;
 
+        // Matches whole trace at once: roads are loaded and indexed once per area covered by trace
+        bool matchPoints(
+            const QVector<PointI>& points31,
+            const double radiusInMeters,
+            const RoutingDataLevel dataLevel,
+            QVector<MatchedPoint>& outMatchedPoints,
+            const MatchingMode mode = MatchingMode::Nearest,
+            const IQueryController* const controller = nullptr) const;
+
         static std::shared_ptr<const Road> findNearestRoad(
             const QList< std::shared_ptr<const Road> >& collection,
             const PointI position31,
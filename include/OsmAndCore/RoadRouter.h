@@ -0,0 +1,116 @@
+#ifndef _OSMAND_CORE_ROAD_ROUTER_H_
+#define _OSMAND_CORE_ROAD_ROUTER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QList>
+#include <QVector>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/Data/ObfRoutingSectionReader.h>
+
+namespace OsmAnd
+{
+    class IObfsCollection;
+    class IRoadCostModel;
+    class IQueryController;
+    class Road;
+    class ContractionHierarchy;
+
+    class RoadRouter_P;
+    class OSMAND_CORE_API RoadRouter
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadRouter);
+
+    public:
+        struct OSMAND_CORE_API RouteSegment
+        {
+            RouteSegment();
+            ~RouteSegment();
+
+            std::shared_ptr<const Road> road;
+            // Route goes from start point towards end point, which may be less than start point index
+            int startPointIndex;
+            int endPointIndex;
+        };
+
+        struct OSMAND_CORE_API Route
+        {
+            Route();
+            ~Route();
+
+            // Not filled for routes found using contraction hierarchy
+            QList<RouteSegment> segments;
+            QVector<PointI> points31;
+            // In seconds
+            float time;
+            // In meters
+            double distance;
+        };
+
+        struct OSMAND_CORE_API Statistics
+        {
+            Statistics();
+            ~Statistics();
+
+            // Nodes settled by contraction hierarchy search, or edges settled by plain graph search, which
+            // enters a junction once per incoming edge to obey turn restrictions
+            unsigned int settledNodesCount;
+            unsigned int graphNodesCount;
+            unsigned int graphEdgesCount;
+            unsigned int loadedTilesCount;
+            unsigned int loadedRoadsCount;
+            // Peak amount of memory used by graph and search state, in bytes
+            size_t peakMemoryUsage;
+            // Approximate amount of memory occupied by loaded roads, and by flat block graphs that graph was
+            // built from (only if blocks cache is used), in bytes
+            size_t roadsMemoryUsage;
+            size_t blockGraphsMemoryUsage;
+        };
+
+    private:
+        PrivateImplementation<RoadRouter_P> _p;
+    protected:
+    public:
+        RoadRouter(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel,
+            const std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache>& cache = nullptr,
+            const std::shared_ptr<const ContractionHierarchy>& contractionHierarchy = nullptr);
+        virtual ~RoadRouter();
+
+        const std::shared_ptr<const IObfsCollection> obfsCollection;
+        const std::shared_ptr<const IRoadCostModel> costModel;
+        const std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache> cache;
+        const std::shared_ptr<const ContractionHierarchy> contractionHierarchy;
+
+        // True if contraction hierarchy was given, and it was built from the same OBFs and for the same cost model
+        bool isUsingContractionHierarchy() const;
+
+        // Finds fastest route between two points. If contraction hierarchy is used, only its upward graph
+        // is searched. Otherwise, or if start or finish is not covered by hierarchy, bidirectional A* search
+        // runs over road data that is loaded on demand as search proceeds
+        bool findRoute(
+            const PointI start31,
+            const PointI finish31,
+            Route& outRoute,
+            Statistics* const outStatistics = nullptr,
+            const IQueryController* const controller = nullptr) const;
+
+        // Finds fastest travel times (in seconds) from every source to every target, stored row by row.
+        // Infinity means there's no route. Work is spread over threadsCount threads (or as many as there
+        // are cores, if zero), that share the same blocks cache. Without contraction hierarchy, routes much
+        // longer than straight distance to the farthest target are not searched and count as missing
+        bool computeTravelTimes(
+            const QVector<PointI>& sources31,
+            const QVector<PointI>& targets31,
+            QVector<float>& outTimes,
+            const unsigned int threadsCount = 0,
+            const IQueryController* const controller = nullptr) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_ROUTER_H_)
@@ -42,7 +42,7 @@ namespace OsmAnd {
         static bool parseTypedValue(const QString& value, const QString& type, float& parsedValue);
 
         static bool parseConfiguration(QIODevice* data, OsmAnd::RoutingConfiguration& outConfig);
-        static void loadDefault(OsmAnd::RoutingConfiguration& outConfig);
+        static bool loadDefault(OsmAnd::RoutingConfiguration& outConfig);
     };
 
 } // namespace OsmAnd
@@ -10,10 +10,11 @@
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/Routing/RoutingRuleset.h>
-#include <OsmAndCore/Data/Model/Road.h>
 
 namespace OsmAnd {
 
+    class RoutingProfileContext;
+
     class OSMAND_CORE_API RoutingProfile
     {
     public:
@@ -101,8 +102,9 @@ namespace OsmAnd {
     friend class OsmAnd::RoutingConfiguration;
     friend class OsmAnd::RoutingRuleExpression;
     friend class OsmAnd::RoutingRulesetContext;
+    friend class OsmAnd::RoutingProfileContext;
     };
 
 } // namespace OsmAnd
 
-#endif // !defined(_OSMAND_CORE_ROUTING_PROFILE_H_)
\ No newline at end of file
+#endif // !defined(_OSMAND_CORE_ROUTING_PROFILE_H_)
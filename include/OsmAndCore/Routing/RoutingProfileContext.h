@@ -6,24 +6,56 @@
 #include <OsmAndCore/QtExtensions.h>
 #include <QString>
 #include <QHash>
+#include <QVector>
 
 #include <OsmAndCore.h>
+#include <OsmAndCore/Data/Road.h>
 #include <OsmAndCore/Routing/RoutingProfile.h>
 #include <OsmAndCore/Routing/RoutingRulesetContext.h>
-#include <OsmAndCore/Data/Model/Road.h>
 
 namespace OsmAnd {
 
-    class ObfRoutingSectionInfo;
-    class ObfRoutingBorderLinePoint;
-
     class OSMAND_CORE_API RoutingProfileContext
     {
+    public:
+        // Results of rulesets that depend only on types of the road
+        struct CompiledRoadTypes
+        {
+            bool accepted;
+            RoadDirection direction;
+            float speed;
+            float speedPriority;
+        };
     private:
+        // Profile compiled for encoding rules of a single routing section. Rules are mapped to profile
+        // attributes through a dense table, and each distinct combination of types is evaluated only once,
+        // so that evaluation of a road is reduced to a lookup
+        struct CompiledSection
+        {
+            // Attribute id for each encoding rule id, or -1 if not yet resolved
+            QVector<int32_t> attributeIds;
+
+            QHash< QVector<uint32_t>, CompiledRoadTypes > roadTypes;
+
+            QHash< QVector<uint32_t>, float > obstaclesExtraTimes;
+            QHash< QVector<uint32_t>, float > routingObstaclesExtraTimes;
+        };
+        // Rules are held by the key, so a compiled section can't be confused with one of rules allocated later
+        QHash< std::shared_ptr<const MapObject::EncodingDecodingRules>, std::shared_ptr<CompiledSection> > _compiledSections;
+        std::shared_ptr<const MapObject::EncodingDecodingRules> _lastCompiledSectionKey;
+        CompiledSection* _lastCompiledSection;
+
+        CompiledSection& getCompiledSection(const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules);
+        uint32_t getAttributeId(
+            CompiledSection& compiledSection,
+            const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+            const uint32_t type);
+        float getCompiledObstaclesExtraTime(
+            const RoutingRuleset::Type rulesetType,
+            const std::shared_ptr<const Road>& road,
+            const uint32_t pointIndex);
     protected:
         std::shared_ptr<RoutingRulesetContext> _rulesetContexts[RoutingRuleset::TypesCount];
-
-        QHash< std::shared_ptr<const ObfRoutingSectionInfo>, QMap<uint32_t, uint32_t> > _tagValueAttribIdCache;
     public:
         RoutingProfileContext(const std::shared_ptr<RoutingProfile>& profile, QHash<QString, QString>* contextValues = nullptr);
         virtual ~RoutingProfileContext();
@@ -31,14 +63,14 @@ namespace OsmAnd {
         const std::shared_ptr<RoutingProfile> profile;
 
         std::shared_ptr<RoutingRulesetContext> getRulesetContext(RoutingRuleset::Type type);
+        CompiledRoadTypes getCompiledRoadTypes(const std::shared_ptr<const Road>& road);
 
-        Model::RoadDirection getDirection(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        bool acceptsRoad(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        bool acceptsBorderLinePoint(const std::shared_ptr<const ObfRoutingSectionInfo>& section, const std::shared_ptr<const ObfRoutingBorderLinePoint>& point);
-        float getSpeedPriority(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        float getSpeed(const std::shared_ptr<const OsmAnd::Model::Road>& road);
-        float getObstaclesExtraTime(const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex);
-        float getRoutingObstaclesExtraTime(const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex);
+        RoadDirection getDirection(const std::shared_ptr<const Road>& road);
+        bool acceptsRoad(const std::shared_ptr<const Road>& road);
+        float getSpeedPriority(const std::shared_ptr<const Road>& road);
+        float getSpeed(const std::shared_ptr<const Road>& road);
+        float getObstaclesExtraTime(const std::shared_ptr<const Road>& road, uint32_t pointIndex);
+        float getRoutingObstaclesExtraTime(const std::shared_ptr<const Road>& road, uint32_t pointIndex);
 
         friend class OsmAnd::RoutingRulesetContext;
     };
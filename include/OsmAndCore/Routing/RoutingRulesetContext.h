@@ -9,15 +9,12 @@
 #include <QBitArray>
 
 #include <OsmAndCore.h>
+#include <OsmAndCore/Data/Road.h>
 #include <OsmAndCore/Routing/RoutingRuleset.h>
 
 namespace OsmAnd {
 
     class RoutingProfileContext;
-    class ObfRoutingSectionInfo;
-    namespace Model {
-        class Road;
-    } // namespace Model
 
     class OSMAND_CORE_API RoutingRulesetContext
     {
@@ -25,9 +22,9 @@ namespace OsmAnd {
         QHash<QString, QString> _contextValues;
         std::shared_ptr<RoutingRuleset> _ruleset;
     protected:
-        bool evaluate(const std::shared_ptr<const Model::Road>& road, const RoutingRuleExpression::ResultType type, void* const result);
+        bool evaluate(const std::shared_ptr<const Road>& road, const RoutingRuleExpression::ResultType type, void* const result);
         bool evaluate(const QBitArray& types, const RoutingRuleExpression::ResultType type, void* const result);
-        QBitArray encode(const std::shared_ptr<const ObfRoutingSectionInfo>& section, const QVector<uint32_t>& roadTypes);
+        QBitArray encode(const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules, const QVector<uint32_t>& roadTypes);
     public:
         RoutingRulesetContext(RoutingProfileContext* owner, const std::shared_ptr<RoutingRuleset>& ruleset, QHash<QString, QString>* const contextValues);
         virtual ~RoutingRulesetContext();
@@ -36,11 +33,19 @@ namespace OsmAnd {
         const std::shared_ptr<RoutingRuleset> ruleset;
         const QHash<QString, QString>& contextValues;
 
-        int evaluateAsInteger(const std::shared_ptr<const Model::Road>& road, const int defaultValue);
-        float evaluateAsFloat(const std::shared_ptr<const Model::Road>& road, const float defaultValue);
+        int evaluateAsInteger(const std::shared_ptr<const Road>& road, const int defaultValue);
+        float evaluateAsFloat(const std::shared_ptr<const Road>& road, const float defaultValue);
 
-        int evaluateAsInteger(const std::shared_ptr<const ObfRoutingSectionInfo>& section, const QVector<uint32_t>& roadTypes, const int defaultValue);
-        float evaluateAsFloat(const std::shared_ptr<const ObfRoutingSectionInfo>& section, const QVector<uint32_t>& roadTypes, const float defaultValue);
+        int evaluateAsInteger(
+            const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+            const QVector<uint32_t>& roadTypes,
+            const int defaultValue);
+        float evaluateAsFloat(
+            const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+            const QVector<uint32_t>& roadTypes,
+            const float defaultValue);
+
+        friend class OsmAnd::RoutingProfileContext;
     };
 
 } // namespace OsmAnd
@@ -0,0 +1,117 @@
+#ifndef _OSMAND_CORE_SDF_GLYPH_ATLAS_H_
+#define _OSMAND_CORE_SDF_GLYPH_ATLAS_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QString>
+#include <QVector>
+#include <QReadWriteLock>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/IFontsCollection.h>
+#include <OsmAndCore/TextRasterizer.h>
+
+class SkBitmap;
+
+namespace OsmAnd
+{
+    // Keeps signed distance fields of glyphs, packed into pages shared by all labels of the same font.
+    // Glyph is rendered once at GlyphSize and may be drawn at any size, with or without halo, by
+    // thresholding distance in shader. Labels are laid out into runs of glyph quads instead of bitmaps.
+    // Number of pages is bounded: once it's reached, pages of least recently used fonts are dropped, while
+    // runs laid out before keep pages they reference.
+    class SdfGlyphAtlas_P;
+    class OSMAND_CORE_API SdfGlyphAtlas
+    {
+        Q_DISABLE_COPY_AND_MOVE(SdfGlyphAtlas);
+    public:
+        // Size of text glyphs are rendered at
+        static const float GlyphSize;
+        // Distance in texels covered by the field on each side of glyph outline
+        static const int Spread;
+        // Width and height of page, in texels
+        static const int PageSize;
+        static const int DefaultMaxPagesCount;
+
+        class OSMAND_CORE_API Page Q_DECL_FINAL
+        {
+            Q_DISABLE_COPY_AND_MOVE(Page);
+        private:
+        protected:
+        public:
+            Page(const QString& fontKey);
+            ~Page();
+
+            const QString fontKey;
+
+            // Glyphs are only added to page, never moved or removed. Distances are stored as A8, edge of
+            // glyph being at 0.5. Pixels and version are changed by atlas under write lock
+            mutable QReadWriteLock lock;
+            const std::shared_ptr<SkBitmap> bitmap;
+            unsigned int version;
+        };
+
+        struct GlyphQuad
+        {
+            // Index of page in run
+            int pageIndex;
+            // Index of glyph in text, matches glyph widths
+            int glyphIndex;
+            // Area covered by quad within label, in pixels from top-left corner
+            AreaF area;
+            // Area of glyph field on page, in texels
+            AreaI texels;
+        };
+
+        class OSMAND_CORE_API GlyphRun Q_DECL_FINAL
+        {
+            Q_DISABLE_COPY_AND_MOVE(GlyphRun);
+        private:
+        protected:
+        public:
+            GlyphRun();
+            ~GlyphRun();
+
+            QVector< std::shared_ptr<const Page> > pages;
+            QVector<GlyphQuad> quads;
+            PointI size;
+            // Label pixels per texel of field
+            float scale;
+            ColorARGB color;
+            ColorARGB haloColor;
+            unsigned int haloRadius;
+        };
+
+    private:
+        PrivateImplementation<SdfGlyphAtlas_P> _p;
+    protected:
+    public:
+        SdfGlyphAtlas(
+            const std::shared_ptr<const IFontsCollection>& fontsCollection,
+            const int maxPagesCount = DefaultMaxPagesCount);
+        virtual ~SdfGlyphAtlas();
+
+        const std::shared_ptr<const IFontsCollection> fontsCollection;
+        const int maxPagesCount;
+
+        // Lays text out the same way TextRasterizer does, adding missing glyphs to atlas. Background
+        // bitmap of style is not supported, nor halo wider than field spread at size of text: null is
+        // returned and such labels have to be rasterized
+        std::shared_ptr<const GlyphRun> layoutText(
+            const QString& text,
+            const TextRasterizer::Style& style = TextRasterizer::Style(),
+            QVector<SkScalar>* const outGlyphWidths = nullptr,
+            float* const outExtraTopSpace = nullptr,
+            float* const outExtraBottomSpace = nullptr,
+            float* const outLineSpacing = nullptr) const;
+
+        int getGlyphsCount() const;
+        int getPagesCount() const;
+        size_t getTextureMemoryUsage() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_SDF_GLYPH_ATLAS_H_)
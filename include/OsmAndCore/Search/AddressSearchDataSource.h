@@ -0,0 +1,67 @@
+#ifndef _OSMAND_CORE_ADDRESS_SEARCH_DATA_SOURCE_H_
+#define _OSMAND_CORE_ADDRESS_SEARCH_DATA_SOURCE_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/IObfsCollection.h>
+#include <OsmAndCore/Search/ISearchEngine.h>
+#include <OsmAndCore/Search/BaseSearchEngine.h>
+
+namespace OsmAnd
+{
+    class StreetGroup;
+    class Street;
+
+    class AddressSearchDataSource_P;
+    class OSMAND_CORE_API AddressSearchDataSource Q_DECL_FINAL : public ISearchEngine::IDataSource
+    {
+        Q_DISABLE_COPY_AND_MOVE(AddressSearchDataSource);
+
+    public:
+        class OSMAND_CORE_API ResultEntry Q_DECL_FINAL : public BaseSearchEngine::BaseSearchResult
+        {
+            Q_DISABLE_COPY_AND_MOVE(ResultEntry);
+
+        private:
+        protected:
+        public:
+            ResultEntry(
+                const std::shared_ptr<const StreetGroup>& streetGroup,
+                const std::shared_ptr<const Street>& street,
+                const QString& matchString,
+                const float matchFactor,
+                const QList< std::pair<int, int> >& matchedRanges);
+            virtual ~ResultEntry();
+
+            const std::shared_ptr<const StreetGroup> streetGroup;
+            // Null if result is a street group itself
+            const std::shared_ptr<const Street> street;
+        };
+
+    private:
+        PrivateImplementation<AddressSearchDataSource_P> _p;
+    protected:
+    public:
+        AddressSearchDataSource(const std::shared_ptr<const IObfsCollection>& obfsCollection);
+        virtual ~AddressSearchDataSource();
+
+        const std::shared_ptr<const IObfsCollection> obfsCollection;
+
+        virtual bool obtainResults(
+            const QString& query,
+            const AreaI* const bbox31,
+            const NewResultCallback newResultCallback,
+            const IQueryController* const controller = nullptr) const;
+        virtual std::shared_ptr<const ISearchEngine::ISearchResult> refineResult(
+            const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+            const QString& query) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ADDRESS_SEARCH_DATA_SOURCE_H_)
@@ -6,6 +6,8 @@
 #include <OsmAndCore/QtExtensions.h>
 #include <OsmAndCore/ignore_warnings_on_external_includes.h>
 #include <QList>
+#include <QLinkedList>
+#include <QString>
 #include <OsmAndCore/restore_internal_warnings.h>
 
 #include <OsmAndCore.h>
@@ -20,19 +22,27 @@ namespace OsmAnd
         Q_DISABLE_COPY_AND_MOVE(BaseSearchEngine);
 
     public:
-        /*class OSMAND_CORE_API ISearchResult
+        class OSMAND_CORE_API BaseSearchResult : public ISearchResult
         {
-            Q_DISABLE_COPY_AND_MOVE(ISearchResult);
+            Q_DISABLE_COPY_AND_MOVE(BaseSearchResult);
 
         private:
         protected:
-            ISearchResult();
+            BaseSearchResult(
+                const QString& matchString,
+                const float matchFactor,
+                const QList< std::pair<int, int> >& matchedRanges);
         public:
-            virtual ~ISearchResult();
+            virtual ~BaseSearchResult();
 
-            virtual float getMatchFactor() const = 0;
-            virtual QString getMatchString() const = 0;
-            virtual QList<QStringRef> getMatchedSubstrings() const = 0;
+            const QString matchString;
+            const float matchFactor;
+            // Pairs of (position, length) inside matchString
+            const QList< std::pair<int, int> > matchedRanges;
+
+            virtual float getMatchFactor() const;
+            virtual QString getMatchString() const;
+            virtual QList<QStringRef> getMatchedSubstrings() const;
         };
 
         class OSMAND_CORE_API BaseSearchResults : public ISearchResults
@@ -41,12 +51,31 @@ namespace OsmAnd
 
         private:
         protected:
-            BaseSearchResults();
         public:
+            BaseSearchResults(
+                const QString& query,
+                const QLinkedList< std::shared_ptr<const ISearchResult> >& results,
+                const bool complete);
             virtual ~BaseSearchResults();
 
+            const QString query;
+            const QLinkedList< std::shared_ptr<const ISearchResult> > results;
+            const bool complete;
+
+            virtual QString getQuery() const;
             virtual QLinkedList< std::shared_ptr<const ISearchResult> > getResults() const;
-        };*/
+            virtual bool isComplete() const;
+        };
+
+        // Every whitespace-separated token of query has to be a case- and diacritics-insensitive prefix of some word
+        // of name. Thus any result of "query + suffix" is always a result of "query", what allows
+        // sessions to refine previous results instead of searching from scratch.
+        static bool match(
+            const QString& query,
+            const QString& name,
+            float* const outMatchFactor = nullptr,
+            QList< std::pair<int, int> >* const outMatchedRanges = nullptr);
+
     private:
     protected:
         PrivateImplementation<BaseSearchEngine_P> _p;
@@ -0,0 +1,85 @@
+#ifndef _OSMAND_CORE_FORWARD_GEOCODER_H_
+#define _OSMAND_CORE_FORWARD_GEOCODER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QList>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+#include <OsmAndCore/IObfsCollection.h>
+
+namespace OsmAnd
+{
+    class IQueryController;
+
+    // Matches free-form queries like "city, street, house number" against names of settlements, streets
+    // and buildings. Instead of scanning address sections, each OBF file gets a trie of normalized words
+    // of those names, built on first query and, if requested, persisted next to the OBF file. Every word
+    // of query has to be a prefix of some word of result, of its street or of its settlement, with a few
+    // typos allowed in longer words. Words of one or two letters have to match a whole word.
+    class ForwardGeocoder_P;
+    class OSMAND_CORE_API ForwardGeocoder
+    {
+        Q_DISABLE_COPY_AND_MOVE(ForwardGeocoder);
+
+    public:
+        enum class ResultType
+        {
+            Settlement,
+            Street,
+            Building
+        };
+
+        struct OSMAND_CORE_API Result
+        {
+            Result();
+            ~Result();
+
+            ResultType type;
+            QString name;
+            // Empty for settlements, and for streets respectively
+            QString streetName;
+            QString settlementName;
+            PointI position31;
+            // Lower is better: sum of costs of query words, where each typo costs 2 and matching only
+            // beginning of word costs 1
+            unsigned int cost;
+        };
+
+        static const unsigned int DefaultMaxResultsCount;
+        // Suffix of files that keep persisted indices, next to OBF files
+        static const QString IndexFileSuffix;
+
+    private:
+        PrivateImplementation<ForwardGeocoder_P> _p;
+    protected:
+    public:
+        ForwardGeocoder(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const bool persistIndices = false);
+        virtual ~ForwardGeocoder();
+
+        const std::shared_ptr<const IObfsCollection> obfsCollection;
+        const bool persistIndices;
+
+        // Loads or builds indices of all OBF files with address sections. Queries do this implicitly
+        bool prepareIndices(const IQueryController* const controller = nullptr) const;
+        int getIndexedNamesCount() const;
+        size_t getMemoryUsage() const;
+
+        // Results are ordered from best to worst. Returns false if nothing matched
+        bool geocode(
+            const QString& query,
+            QList<Result>& outResults,
+            const unsigned int maxResultsCount = DefaultMaxResultsCount,
+            const IQueryController* const controller = nullptr) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_FORWARD_GEOCODER_H_)
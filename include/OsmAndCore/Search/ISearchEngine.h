@@ -12,25 +12,49 @@
 
 #include <OsmAndCore.h>
 #include <OsmAndCore/Callable.h>
+#include <OsmAndCore/PointsAndAreas.h>
 
 namespace OsmAnd
 {
     class ISearchSession;
+    class IQueryController;
 
     class OSMAND_CORE_API ISearchEngine
     {
         Q_DISABLE_COPY_AND_MOVE(ISearchEngine);
 
     public:
+        class ISearchResult;
+
         class OSMAND_CORE_API IDataSource
         {
             Q_DISABLE_COPY_AND_MOVE(IDataSource);
 
+        public:
+            OSMAND_CALLABLE(NewResultCallback,
+                void,
+                const IDataSource* const dataSource,
+                const std::shared_ptr<const ISearchResult>& result);
+
         private:
         protected:
             IDataSource();
         public:
             virtual ~IDataSource();
+
+            // Reports every entry that matches query (and lies inside bbox31, if specified) via callback,
+            // as soon as it's found. Returns false if search was aborted by controller.
+            virtual bool obtainResults(
+                const QString& query,
+                const AreaI* const bbox31,
+                const NewResultCallback newResultCallback,
+                const IQueryController* const controller = nullptr) const = 0;
+
+            // Re-evaluates result previously obtained from this data source against a query that
+            // is a continuation of the original one. Returns nullptr if result no longer matches.
+            virtual std::shared_ptr<const ISearchResult> refineResult(
+                const std::shared_ptr<const ISearchResult>& result,
+                const QString& query) const = 0;
         };
 
         class OSMAND_CORE_API ISearchResult
@@ -60,6 +84,7 @@ namespace OsmAnd
 
             virtual QString getQuery() const = 0;
             virtual QLinkedList< std::shared_ptr<const ISearchResult> > getResults() const = 0;
+            virtual bool isComplete() const = 0;
         };
 
     private:
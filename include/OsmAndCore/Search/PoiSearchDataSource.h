@@ -11,14 +11,35 @@
 #include <OsmAndCore/PrivateImplementation.h>
 #include <OsmAndCore/IObfsCollection.h>
 #include <OsmAndCore/Search/ISearchEngine.h>
+#include <OsmAndCore/Search/BaseSearchEngine.h>
 
 namespace OsmAnd
 {
+    class Amenity;
+
     class PoiSearchDataSource_P;
     class OSMAND_CORE_API PoiSearchDataSource Q_DECL_FINAL : public ISearchEngine::IDataSource
     {
         Q_DISABLE_COPY_AND_MOVE(PoiSearchDataSource);
 
+    public:
+        class OSMAND_CORE_API ResultEntry Q_DECL_FINAL : public BaseSearchEngine::BaseSearchResult
+        {
+            Q_DISABLE_COPY_AND_MOVE(ResultEntry);
+
+        private:
+        protected:
+        public:
+            ResultEntry(
+                const std::shared_ptr<const Amenity>& amenity,
+                const QString& matchString,
+                const float matchFactor,
+                const QList< std::pair<int, int> >& matchedRanges);
+            virtual ~ResultEntry();
+
+            const std::shared_ptr<const Amenity> amenity;
+        };
+
     private:
         PrivateImplementation<PoiSearchDataSource_P> _p;
     protected:
@@ -27,6 +48,15 @@ namespace OsmAnd
         virtual ~PoiSearchDataSource();
 
         const std::shared_ptr<const IObfsCollection> obfsCollection;
+
+        virtual bool obtainResults(
+            const QString& query,
+            const AreaI* const bbox31,
+            const NewResultCallback newResultCallback,
+            const IQueryController* const controller = nullptr) const;
+        virtual std::shared_ptr<const ISearchEngine::ISearchResult> refineResult(
+            const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+            const QString& query) const;
     };
 }
 
@@ -9,6 +9,7 @@
 #include <QFile>
 #include <QString>
 #include <QMutex>
+#include <QList>
 #include <QSqlDatabase>
 
 #include <OsmAndCore.h>
@@ -35,6 +36,7 @@ namespace OsmAnd {
 
         bool rebuildIndex();
         bool obtainTileData(const TileId tileId, const ZoomLevel zoom, QByteArray& data);
+        bool obtainTilesList(QList< std::pair<TileId, ZoomLevel> >& outTiles);
     };
 
 }
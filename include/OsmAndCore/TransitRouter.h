@@ -0,0 +1,113 @@
+#ifndef _OSMAND_CORE_TRANSIT_ROUTER_H_
+#define _OSMAND_CORE_TRANSIT_ROUTER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <QList>
+#include <QHash>
+#include <QString>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/PrivateImplementation.h>
+
+namespace OsmAnd
+{
+    class IObfsCollection;
+    class IQueryController;
+    class TransportRoute;
+
+    class TransitRouter_P;
+    class OSMAND_CORE_API TransitRouter
+    {
+        Q_DISABLE_COPY_AND_MOVE(TransitRouter);
+
+    public:
+        // Transport sections carry no schedules, so every route direction is assumed to run at fixed headway
+        // during service hours, with running times derived from distances between stops and speed of route type.
+        // All times are in seconds, times of day are counted from midnight
+        struct OSMAND_CORE_API Settings
+        {
+            Settings();
+            ~Settings();
+
+            unsigned int serviceStartTime;
+            unsigned int serviceEndTime;
+            unsigned int headway;
+            unsigned int dwellTime;
+            // Speeds are in meters per second, route types without speed use default one
+            float defaultSpeed;
+            QHash<QString, float> speedsByType;
+            float walkingSpeed;
+            // Distances are in meters
+            double maxTransferDistance;
+            double maxAccessDistance;
+            unsigned int maxTransfersCount;
+        };
+
+        enum class LegType
+        {
+            Walk,
+            Ride
+        };
+
+        struct OSMAND_CORE_API Leg
+        {
+            Leg();
+            ~Leg();
+
+            LegType type;
+            // Set only for rides
+            std::shared_ptr<const TransportRoute> route;
+            // Ids of stops, or -1 for start and finish of journey
+            int64_t startStopId;
+            int64_t endStopId;
+            PointI start31;
+            PointI end31;
+            unsigned int departureTime;
+            unsigned int arrivalTime;
+        };
+
+        struct OSMAND_CORE_API Journey
+        {
+            Journey();
+            ~Journey();
+
+            QList<Leg> legs;
+            unsigned int departureTime;
+            unsigned int arrivalTime;
+            unsigned int ridesCount;
+        };
+
+    private:
+        PrivateImplementation<TransitRouter_P> _p;
+    protected:
+    public:
+        // Decodes routes of all transport sections and builds timetable from them
+        TransitRouter(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const Settings& settings = Settings());
+        virtual ~TransitRouter();
+
+        const std::shared_ptr<const IObfsCollection> obfsCollection;
+        const Settings settings;
+
+        int getStopsCount() const;
+        // Each direction of route is counted separately
+        int getRoutesCount() const;
+        int getTripsCount() const;
+
+        // Finds journeys that leave start not earlier than departure time, using round-based search (RAPTOR).
+        // Journeys are Pareto-optimal: each next one has more rides, but arrives earlier. Returns false if
+        // finish can't be reached
+        bool findJourneys(
+            const PointI start31,
+            const PointI finish31,
+            const unsigned int departureTime,
+            QList<Journey>& outJourneys,
+            const IQueryController* const controller = nullptr) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TRANSIT_ROUTER_H_)
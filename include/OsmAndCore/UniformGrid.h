@@ -0,0 +1,433 @@
+#ifndef _OSMAND_CORE_UNIFORM_GRID_H_
+#define _OSMAND_CORE_UNIFORM_GRID_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QList>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/CommonTypes.h>
+#include <OsmAndCore/QuadTree.h>
+
+namespace OsmAnd
+{
+    // Flat grid of equal cells over fixed area, each entry is linked into every cell its AABB covers.
+    // Unlike QuadTree, inserting and removing entry costs only the cells it covers and never allocates
+    // once pools of entries and links have grown: freed slots are reused, and clear() keeps them all.
+    // Bounding boxes and acceptors are the ones of QuadTree, so both can be used interchangeably.
+    // Queries that visit several cells (test() and query()) mark visited entries, so they may not run
+    // concurrently on the same grid; select() may.
+    template<typename ELEMENT_TYPE, typename COORD_TYPE>
+    class UniformGrid
+    {
+    public:
+        typedef UniformGrid<ELEMENT_TYPE, COORD_TYPE> UniformGridT;
+        typedef QuadTree<ELEMENT_TYPE, COORD_TYPE> QuadTreeT;
+        typedef typename QuadTreeT::AreaT AreaT;
+        typedef typename QuadTreeT::OOBBT OOBBT;
+        typedef typename QuadTreeT::PointT PointT;
+        typedef typename QuadTreeT::BBoxType BBoxType;
+        typedef typename QuadTreeT::BBox BBox;
+        typedef typename QuadTreeT::Acceptor Acceptor;
+
+    private:
+    protected:
+        struct CellsRange
+        {
+            int firstColumn;
+            int lastColumn;
+            int firstRow;
+            int lastRow;
+        };
+
+        struct Entry
+        {
+            inline Entry()
+                : visitStamp(0)
+                , nextFree(-1)
+            {
+            }
+
+            BBox bbox;
+            ELEMENT_TYPE element;
+            CellsRange cells;
+            mutable unsigned int visitStamp;
+            int nextFree;
+        };
+
+        // Cell holds singly-linked list of links to entries, free links are chained the same way
+        struct Link
+        {
+            int entryIndex;
+            int next;
+        };
+
+        AreaT _area;
+        COORD_TYPE _cellSize;
+        int _columns;
+        int _rows;
+        QVector<int> _cells;
+        QVector<Entry> _entries;
+        int _firstFreeEntry;
+        QVector<Link> _links;
+        int _firstFreeLink;
+        int _entriesCount;
+        mutable unsigned int _visitStamp;
+
+        inline static const AreaT& getAABB(const BBox& bbox)
+        {
+            if (bbox.type == BBoxType::AABB)
+                return bbox.asAABB;
+            else /* if (bbox.type == BBoxType::OOBB) */
+                return bbox.asOOBB.aabb();
+        }
+
+        inline int getColumn(const COORD_TYPE x) const
+        {
+            if (x <= _area.left())
+                return 0;
+            return std::min(static_cast<int>((x - _area.left()) / _cellSize), _columns - 1);
+        }
+
+        inline int getRow(const COORD_TYPE y) const
+        {
+            if (y <= _area.top())
+                return 0;
+            return std::min(static_cast<int>((y - _area.top()) / _cellSize), _rows - 1);
+        }
+
+        inline CellsRange getCellsRange(const AreaT& aabb) const
+        {
+            CellsRange cells;
+            cells.firstColumn = getColumn(aabb.left());
+            cells.lastColumn = getColumn(aabb.right());
+            cells.firstRow = getRow(aabb.top());
+            cells.lastRow = getRow(aabb.bottom());
+            return cells;
+        }
+
+        int allocateEntry()
+        {
+            if (_firstFreeEntry < 0)
+            {
+                _entries.push_back(Entry());
+                return _entries.size() - 1;
+            }
+
+            const auto entryIndex = _firstFreeEntry;
+            _firstFreeEntry = _entries[entryIndex].nextFree;
+            return entryIndex;
+        }
+
+        void linkEntry(const int entryIndex, const int cellIndex)
+        {
+            int linkIndex = _firstFreeLink;
+            if (linkIndex < 0)
+            {
+                _links.push_back(Link());
+                linkIndex = _links.size() - 1;
+            }
+            else
+                _firstFreeLink = _links[linkIndex].next;
+
+            auto& link = _links[linkIndex];
+            link.entryIndex = entryIndex;
+            link.next = _cells[cellIndex];
+            _cells[cellIndex] = linkIndex;
+        }
+
+        void unlinkEntry(const int entryIndex, const int cellIndex)
+        {
+            auto pLinkIndex = &_cells[cellIndex];
+            while (*pLinkIndex >= 0)
+            {
+                auto& link = _links[*pLinkIndex];
+                if (link.entryIndex != entryIndex)
+                {
+                    pLinkIndex = &link.next;
+                    continue;
+                }
+
+                const auto linkIndex = *pLinkIndex;
+                *pLinkIndex = link.next;
+                link.next = _firstFreeLink;
+                _firstFreeLink = linkIndex;
+                return;
+            }
+        }
+
+        void removeEntry(const int entryIndex)
+        {
+            auto& entry = _entries[entryIndex];
+            for (auto row = entry.cells.firstRow; row <= entry.cells.lastRow; row++)
+            {
+                for (auto column = entry.cells.firstColumn; column <= entry.cells.lastColumn; column++)
+                    unlinkEntry(entryIndex, row * _columns + column);
+            }
+
+            entry.element = ELEMENT_TYPE();
+            entry.nextFree = _firstFreeEntry;
+            _firstFreeEntry = entryIndex;
+            _entriesCount--;
+        }
+
+        inline unsigned int obtainVisitStamp() const
+        {
+            if (Q_UNLIKELY(++_visitStamp == 0))
+            {
+                for (const auto& entry : constOf(_entries))
+                    entry.visitStamp = 0;
+                _visitStamp = 1;
+            }
+            return _visitStamp;
+        }
+
+        template<typename BBOX_TYPE>
+        static bool contains(const BBOX_TYPE& which, const BBox& what)
+        {
+            if (what.type == BBoxType::AABB)
+                return which.contains(what.asAABB);
+            else /* if (what.type == BBoxType::OOBB) */
+                return which.contains(what.asOOBB);
+        }
+
+        static bool contains(const BBox& which, const PointT& what)
+        {
+            if (which.type == BBoxType::AABB)
+                return which.asAABB.contains(what);
+            else /* if (which.type == BBoxType::OOBB) */
+                return which.asOOBB.contains(what);
+        }
+
+        template<typename BBOX_TYPE>
+        static bool intersects(const BBOX_TYPE& which, const BBox& what)
+        {
+            if (what.type == BBoxType::AABB)
+                return which.intersects(what.asAABB);
+            else /* if (what.type == BBoxType::OOBB) */
+                return which.intersects(what.asOOBB);
+        }
+
+        // Calls visitor for each entry in cells covered by bbox that passes same checks as in QuadTree,
+        // until visitor returns true
+        template<typename BBOX_TYPE, typename VISITOR>
+        bool visit(const BBOX_TYPE& bbox, const AreaT& aabb, const bool strict, const VISITOR visitor) const
+        {
+            if (!_area.intersects(aabb))
+                return false;
+
+            const auto visitStamp = obtainVisitStamp();
+            const auto cells = getCellsRange(aabb);
+            for (auto row = cells.firstRow; row <= cells.lastRow; row++)
+            {
+                for (auto column = cells.firstColumn; column <= cells.lastColumn; column++)
+                {
+                    for (auto linkIndex = _cells[row * _columns + column]; linkIndex >= 0; linkIndex = _links[linkIndex].next)
+                    {
+                        const auto& entry = _entries[_links[linkIndex].entryIndex];
+                        if (entry.visitStamp == visitStamp)
+                            continue;
+                        entry.visitStamp = visitStamp;
+
+                        if (!contains(bbox, entry.bbox) && (strict || !intersects(bbox, entry.bbox)))
+                            continue;
+
+                        if (visitor(entry))
+                            return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+    public:
+        inline UniformGrid(const AreaT& area = AreaT(), const COORD_TYPE cellSize = 64)
+            : _firstFreeEntry(-1)
+            , _firstFreeLink(-1)
+            , _entriesCount(0)
+            , _visitStamp(0)
+        {
+            reset(area, cellSize);
+        }
+
+        virtual ~UniformGrid()
+        {
+        }
+
+        // Changes area and cells of grid. All entries are removed, but pools are kept
+        void reset(const AreaT& area, const COORD_TYPE cellSize)
+        {
+            _area = area;
+            _cellSize = std::max(cellSize, static_cast<COORD_TYPE>(1));
+            _columns = std::max(static_cast<int>((area.width() + _cellSize - 1) / _cellSize), 1);
+            _rows = std::max(static_cast<int>((area.height() + _cellSize - 1) / _cellSize), 1);
+            clear();
+        }
+
+        void clear()
+        {
+            _cells.fill(-1, _columns * _rows);
+
+            // Lowest slots are chained first, so they're reused first
+            _firstFreeEntry = -1;
+            for (auto entryIndex = _entries.size() - 1; entryIndex >= 0; entryIndex--)
+            {
+                auto& entry = _entries[entryIndex];
+                entry.element = ELEMENT_TYPE();
+                entry.nextFree = _firstFreeEntry;
+                _firstFreeEntry = entryIndex;
+            }
+            _firstFreeLink = -1;
+            for (auto linkIndex = _links.size() - 1; linkIndex >= 0; linkIndex--)
+            {
+                _links[linkIndex].next = _firstFreeLink;
+                _firstFreeLink = linkIndex;
+            }
+            _entriesCount = 0;
+        }
+
+        void swap(UniformGridT& that)
+        {
+            std::swap(_area, that._area);
+            std::swap(_cellSize, that._cellSize);
+            std::swap(_columns, that._columns);
+            std::swap(_rows, that._rows);
+            _cells.swap(that._cells);
+            _entries.swap(that._entries);
+            std::swap(_firstFreeEntry, that._firstFreeEntry);
+            _links.swap(that._links);
+            std::swap(_firstFreeLink, that._firstFreeLink);
+            std::swap(_entriesCount, that._entriesCount);
+            std::swap(_visitStamp, that._visitStamp);
+        }
+
+        inline const AreaT& rootArea() const
+        {
+            return _area;
+        }
+
+        inline COORD_TYPE getCellSize() const
+        {
+            return _cellSize;
+        }
+
+        inline int getEntriesCount() const
+        {
+            return _entriesCount;
+        }
+
+        // Entries that only intersect area are clamped to border cells, as long as insert is not strict
+        bool insert(const ELEMENT_TYPE& element, const BBox& bbox, const bool strict = false)
+        {
+            const auto& aabb = getAABB(bbox);
+            if (!_area.contains(aabb))
+            {
+                if (strict)
+                    return false;
+                if (!_area.intersects(aabb))
+                    return false;
+            }
+
+            const auto entryIndex = allocateEntry();
+            auto& entry = _entries[entryIndex];
+            entry.bbox = bbox;
+            entry.element = element;
+            entry.cells = getCellsRange(aabb);
+            entry.nextFree = -1;
+            for (auto row = entry.cells.firstRow; row <= entry.cells.lastRow; row++)
+            {
+                for (auto column = entry.cells.firstColumn; column <= entry.cells.lastColumn; column++)
+                    linkEntry(entryIndex, row * _columns + column);
+            }
+            _entriesCount++;
+
+            return true;
+        }
+
+        bool removeOne(const ELEMENT_TYPE& element, const BBox& bbox)
+        {
+            const auto& aabb = getAABB(bbox);
+            if (!_area.intersects(aabb))
+                return false;
+
+            const auto cells = getCellsRange(aabb);
+            for (auto row = cells.firstRow; row <= cells.lastRow; row++)
+            {
+                for (auto column = cells.firstColumn; column <= cells.lastColumn; column++)
+                {
+                    for (auto linkIndex = _cells[row * _columns + column]; linkIndex >= 0; linkIndex = _links[linkIndex].next)
+                    {
+                        const auto entryIndex = _links[linkIndex].entryIndex;
+                        if (_entries[entryIndex].element != element)
+                            continue;
+
+                        removeEntry(entryIndex);
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        bool test(const BBox& bbox, const bool strict = false, const Acceptor acceptor = nullptr) const
+        {
+            const auto visitor =
+                [acceptor]
+                (const Entry& entry) -> bool
+                {
+                    return !acceptor || acceptor(entry.element, entry.bbox);
+                };
+
+            if (bbox.type == BBoxType::AABB)
+                return visit(bbox.asAABB, bbox.asAABB, strict, visitor);
+            else /* if (bbox.type == BBoxType::OOBB) */
+                return visit(bbox.asOOBB, bbox.asOOBB.aabb(), strict, visitor);
+        }
+
+        void query(const BBox& bbox, QList<ELEMENT_TYPE>& outResults, const bool strict = false, const Acceptor acceptor = nullptr) const
+        {
+            const auto visitor =
+                [acceptor, &outResults]
+                (const Entry& entry) -> bool
+                {
+                    if (!acceptor || acceptor(entry.element, entry.bbox))
+                        outResults.push_back(entry.element);
+                    return false;
+                };
+
+            if (bbox.type == BBoxType::AABB)
+                visit(bbox.asAABB, bbox.asAABB, strict, visitor);
+            else /* if (bbox.type == BBoxType::OOBB) */
+                visit(bbox.asOOBB, bbox.asOOBB.aabb(), strict, visitor);
+        }
+
+        void select(const PointT& point, QList<ELEMENT_TYPE>& outResults, const Acceptor acceptor = nullptr) const
+        {
+            if (!_area.contains(point))
+                return;
+
+            const auto cellIndex = getRow(point.y) * _columns + getColumn(point.x);
+            for (auto linkIndex = _cells[cellIndex]; linkIndex >= 0; linkIndex = _links[linkIndex].next)
+            {
+                const auto& entry = _entries[_links[linkIndex].entryIndex];
+                if (!contains(entry.bbox, point))
+                    continue;
+
+                if (!acceptor || acceptor(entry.element, entry.bbox))
+                    outResults.push_back(entry.element);
+            }
+        }
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_UNIFORM_GRID_H_)
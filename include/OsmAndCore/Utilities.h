@@ -28,6 +28,8 @@
 
 namespace OsmAnd
 {
+    class ObfFile;
+
     struct OSMAND_CORE_API Utilities Q_DECL_FINAL
     {
         inline static double toRadians(const double angle)
@@ -572,6 +574,37 @@ namespace OsmAnd
             return shiftedTileId;
         }
 
+        inline static QVector<TileId> getTileIdsUnderscaledByZoomShift(
+            const TileId tileId,
+            const int zoomShift,
+            QVector<PointF>* outNOffsetsInTile = nullptr,
+            PointF* outNSizeInTile = nullptr)
+        {
+            assert(zoomShift > 0);
+
+            const auto tilesPerSide = 1 << zoomShift;
+            const auto nSizeInTile = 1.0f / tilesPerSide;
+            QVector<TileId> underscaledTileIds;
+            underscaledTileIds.reserve(tilesPerSide * tilesPerSide);
+            if (outNOffsetsInTile)
+            {
+                outNOffsetsInTile->clear();
+                outNOffsetsInTile->reserve(tilesPerSide * tilesPerSide);
+            }
+            for (auto y = 0; y < tilesPerSide; y++)
+            {
+                for (auto x = 0; x < tilesPerSide; x++)
+                {
+                    underscaledTileIds.push_back(TileId::fromXY((tileId.x << zoomShift) + x, (tileId.y << zoomShift) + y));
+                    if (outNOffsetsInTile)
+                        outNOffsetsInTile->push_back(PointF(x * nSizeInTile, y * nSizeInTile));
+                }
+            }
+            if (outNSizeInTile)
+                *outNSizeInTile = PointF(nSizeInTile, nSizeInTile);
+            return underscaledTileIds;
+        }
+
         inline static AreaI areaRightShift(const AreaI& input, const uint32_t shift)
         {
             AreaI output;
@@ -771,6 +804,10 @@ namespace OsmAnd
         static float parseArbitraryFloat(const QString& value, const float defValue, bool* wasParsed = nullptr);
         static bool parseArbitraryBool(const QString& value, const bool defValue, bool* wasParsed = nullptr);
 
+        // Identifies set of OBF files that data precomputed from them was built from: any replaced, added or
+        // removed file changes signature, order of files doesn't
+        static QByteArray computeObfFilesSignature(const QList< std::shared_ptr<const ObfFile> >& obfFiles);
+
         static int javaDoubleCompare(const double l, const double r);
         static void findFiles(const QDir& origin, const QStringList& masks, QFileInfoList& files, const bool recursively = true);
         static void findDirectories(const QDir& origin, const QStringList& masks, QFileInfoList& directories, const bool recursively = true);
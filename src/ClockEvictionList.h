@@ -0,0 +1,104 @@
+#ifndef _OSMAND_CORE_CLOCK_EVICTION_LIST_H_
+#define _OSMAND_CORE_CLOCK_EVICTION_LIST_H_
+
+#include "stdlib_common.h"
+#include <functional>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+
+namespace OsmAnd
+{
+    // Keys of cached entries in CLOCK order, hand points to next eviction candidate. Reference bits are kept
+    // by cache in its entries, since cache decides on each candidate whether it's evicted. Not thread-safe.
+    template<typename KEY>
+    class ClockEvictionList Q_DECL_FINAL
+    {
+    public:
+        typedef KEY Key;
+
+        enum class Candidate
+        {
+            // Entry can't be evicted now, e.g. it's pinned or referenced from outside
+            Keep,
+            // Entry was used since hand passed it last time, cache has to clear its reference bit
+            SecondChance,
+            // Entry is evicted, cache has to release it
+            Evict,
+        };
+
+        typedef std::function<bool()> ConditionFunction;
+        typedef std::function<Candidate(const Key& key)> VisitFunction;
+        typedef std::function<bool(const Key& key)> PredicateFunction;
+
+    private:
+        QList<Key> _keys;
+        int _hand;
+    public:
+        ClockEvictionList()
+            : _hand(0)
+        {
+        }
+
+        ~ClockEvictionList()
+        {
+        }
+
+        // New key is placed right behind the hand, so it's checked last
+        void insert(const Key& key)
+        {
+            if (_hand > _keys.size())
+                _hand = 0;
+            _keys.insert(_hand, key);
+            _hand++;
+        }
+
+        // Moves hand while 'needsEviction' holds. Every entry loses its reference bit during the first
+        // turn of the hand, so two turns are enough to find every entry that may be evicted
+        void evictWhile(const ConditionFunction needsEviction, const VisitFunction visit)
+        {
+            auto stepsLeft = 2 * _keys.size();
+            while (!_keys.isEmpty() && stepsLeft-- > 0 && needsEviction())
+            {
+                if (_hand >= _keys.size())
+                    _hand = 0;
+
+                if (visit(_keys[_hand]) == Candidate::Evict)
+                    _keys.removeAt(_hand);
+                else
+                    _hand++;
+            }
+        }
+
+        // Evicts every entry 'shouldEvict' accepts regardless of reference bits, cache has to release them
+        void evictIf(const PredicateFunction shouldEvict)
+        {
+            for (auto position = _keys.size() - 1; position >= 0; position--)
+            {
+                if (!shouldEvict(_keys[position]))
+                    continue;
+
+                _keys.removeAt(position);
+                if (position < _hand)
+                    _hand--;
+            }
+        }
+
+        int size() const
+        {
+            return _keys.size();
+        }
+
+        void clear()
+        {
+            _keys.clear();
+            _hand = 0;
+        }
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_CLOCK_EVICTION_LIST_H_)
@@ -0,0 +1,106 @@
+#include "ContractionHierarchy.h"
+#include "ContractionHierarchy_P.h"
+
+OsmAnd::ContractionHierarchy::ContractionHierarchy(const QString& filename_)
+    : _p(new ContractionHierarchy_P(this))
+    , filename(filename_)
+{
+    _p->open();
+}
+
+OsmAnd::ContractionHierarchy::~ContractionHierarchy()
+{
+}
+
+bool OsmAnd::ContractionHierarchy::isValid() const
+{
+    return _p->isValid();
+}
+
+int OsmAnd::ContractionHierarchy::getNodesCount() const
+{
+    return _p->getNodesCount();
+}
+
+int OsmAnd::ContractionHierarchy::getEdgesCount() const
+{
+    return _p->getEdgesCount();
+}
+
+bool OsmAnd::ContractionHierarchy::isUpToDate(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection,
+    const std::shared_ptr<const IRoadCostModel>& costModel) const
+{
+    return _p->isUpToDate(obfsCollection, costModel);
+}
+
+bool OsmAnd::ContractionHierarchy::containsNode(const PointI& position31) const
+{
+    return _p->findNode(position31) >= 0;
+}
+
+bool OsmAnd::ContractionHierarchy::findPath(
+    const QList<Endpoint>& sources,
+    const QList<Endpoint>& targets,
+    Path& outPath,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->findPath(sources, targets, outPath, controller);
+}
+
+bool OsmAnd::ContractionHierarchy::findTravelTimes(
+    const QVector< QList<Endpoint> >& sources,
+    const QVector< QList<Endpoint> >& targets,
+    QVector<float>& outTimes,
+    const unsigned int threadsCount /*= 0*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->findTravelTimes(sources, targets, outTimes, threadsCount, controller);
+}
+
+bool OsmAnd::ContractionHierarchy::build(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection,
+    const std::shared_ptr<const IRoadCostModel>& costModel,
+    const QString& outputFilename,
+    BuildStatistics* const outStatistics /*= nullptr*/,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    return ContractionHierarchy_P::build(obfsCollection, costModel, outputFilename, outStatistics, controller);
+}
+
+OsmAnd::ContractionHierarchy::Endpoint::Endpoint()
+    : time(0.0f)
+{
+}
+
+OsmAnd::ContractionHierarchy::Endpoint::Endpoint(const PointI position31_, const float time_)
+    : position31(position31_)
+    , time(time_)
+{
+}
+
+OsmAnd::ContractionHierarchy::Endpoint::~Endpoint()
+{
+}
+
+OsmAnd::ContractionHierarchy::Path::Path()
+    : time(0.0f)
+    , distance(0.0)
+    , settledNodesCount(0)
+{
+}
+
+OsmAnd::ContractionHierarchy::Path::~Path()
+{
+}
+
+OsmAnd::ContractionHierarchy::BuildStatistics::BuildStatistics()
+    : nodesCount(0)
+    , edgesCount(0)
+    , shortcutsCount(0)
+{
+}
+
+OsmAnd::ContractionHierarchy::BuildStatistics::~BuildStatistics()
+{
+}
@@ -0,0 +1,982 @@
+#include "ContractionHierarchy_P.h"
+#include "ContractionHierarchy.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QPair>
+#include <QFile>
+#include <QCryptographicHash>
+#include <QThreadPool>
+#include <QThread>
+#include <QAtomicInt>
+#include "restore_internal_warnings.h"
+
+#include "IObfsCollection.h"
+#include "ObfFile.h"
+#include "IRoadCostModel.h"
+#include "IQueryController.h"
+#include "RoadGraph.h"
+#include "Concurrent.h"
+#include "FlatArraysIO.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+// 'OACH' in native (little-endian) byte order
+const uint32_t OsmAnd::ContractionHierarchy_P::Signature = 0x4843414F;
+const uint32_t OsmAnd::ContractionHierarchy_P::Version = 2;
+const int OsmAnd::ContractionHierarchy_P::MaxWitnessSettledNodes = 500;
+
+OsmAnd::ContractionHierarchy_P::ContractionHierarchy_P(ContractionHierarchy* const owner_)
+    : _isValid(false)
+    , owner(owner_)
+{
+}
+
+OsmAnd::ContractionHierarchy_P::~ContractionHierarchy_P()
+{
+}
+
+bool OsmAnd::ContractionHierarchy_P::heapEntryComparator(const HeapEntry& l, const HeapEntry& r)
+{
+    // Makes std::*_heap() functions maintain min-heap
+    return l.key > r.key;
+}
+
+uint64_t OsmAnd::ContractionHierarchy_P::makePositionKey(const PointI& position31)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(position31.x)) << 32) | static_cast<uint32_t>(position31.y);
+}
+
+QByteArray OsmAnd::ContractionHierarchy_P::computeCostModelSignature(const std::shared_ptr<const IRoadCostModel>& costModel)
+{
+    return QCryptographicHash::hash(costModel->getSignature().toUtf8(), QCryptographicHash::Md5);
+}
+
+bool OsmAnd::ContractionHierarchy_P::open()
+{
+    QFile file(owner->filename);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open contraction hierarchy '%s': %s", qPrintable(owner->filename), qPrintable(file.errorString()));
+        return false;
+    }
+
+    FileHeader header;
+    if (!FlatArraysIO::read(file, header))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Contraction hierarchy '%s' is truncated", qPrintable(owner->filename));
+        return false;
+    }
+    if (header.signature != Signature || header.version != Version)
+    {
+        LogPrintf(LogSeverityLevel::Error, "'%s' is not a contraction hierarchy of version %d", qPrintable(owner->filename), Version);
+        return false;
+    }
+
+    const auto expectedSize =
+        sizeof(FileHeader) +
+        static_cast<uint64_t>(header.nodesCount) * (sizeof(PointI) + 2 * sizeof(uint32_t)) +
+        2 * sizeof(uint32_t) +
+        static_cast<uint64_t>(header.edgesCount) * sizeof(Edge) +
+        (static_cast<uint64_t>(header.upwardOutgoingEdgesCount) + header.upwardIncomingEdgesCount) * sizeof(uint32_t);
+    if (static_cast<uint64_t>(file.size()) != expectedSize)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Contraction hierarchy '%s' is corrupted", qPrintable(owner->filename));
+        return false;
+    }
+
+    QVector<PointI> nodePositions(header.nodesCount);
+    QVector<Edge> edges(header.edgesCount);
+    QVector<uint32_t> upwardOutgoingOffsets(header.nodesCount + 1);
+    QVector<uint32_t> upwardOutgoingEdges(header.upwardOutgoingEdgesCount);
+    QVector<uint32_t> upwardIncomingOffsets(header.nodesCount + 1);
+    QVector<uint32_t> upwardIncomingEdges(header.upwardIncomingEdgesCount);
+    auto ok = FlatArraysIO::readArray(file, nodePositions);
+    ok = ok && FlatArraysIO::readArray(file, edges);
+    ok = ok && FlatArraysIO::readArray(file, upwardOutgoingOffsets);
+    ok = ok && FlatArraysIO::readArray(file, upwardOutgoingEdges);
+    ok = ok && FlatArraysIO::readArray(file, upwardIncomingOffsets);
+    ok = ok && FlatArraysIO::readArray(file, upwardIncomingEdges);
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to read contraction hierarchy '%s'", qPrintable(owner->filename));
+        return false;
+    }
+
+    for (const auto& edge : constOf(edges))
+    {
+        if (edge.source >= header.nodesCount || edge.target >= header.nodesCount ||
+            edge.firstChild >= static_cast<int32_t>(header.edgesCount) ||
+            edge.secondChild >= static_cast<int32_t>(header.edgesCount))
+        {
+            LogPrintf(LogSeverityLevel::Error, "Contraction hierarchy '%s' is corrupted", qPrintable(owner->filename));
+            return false;
+        }
+    }
+    const auto offsetsValid =
+        []
+        (const QVector<uint32_t>& offsets, const QVector<uint32_t>& list, const uint32_t edgesCount) -> bool
+        {
+            for (auto idx = 1; idx < offsets.size(); idx++)
+            {
+                if (offsets[idx] < offsets[idx - 1])
+                    return false;
+            }
+            if (offsets.first() != 0 || offsets.last() != static_cast<uint32_t>(list.size()))
+                return false;
+            for (const auto edge : constOf(list))
+            {
+                if (edge >= edgesCount)
+                    return false;
+            }
+            return true;
+        };
+    if (!offsetsValid(upwardOutgoingOffsets, upwardOutgoingEdges, header.edgesCount) ||
+        !offsetsValid(upwardIncomingOffsets, upwardIncomingEdges, header.edgesCount))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Contraction hierarchy '%s' is corrupted", qPrintable(owner->filename));
+        return false;
+    }
+
+    _sourceSignature = QByteArray(reinterpret_cast<const char*>(header.sourceSignature), sizeof(header.sourceSignature));
+    _costModelSignature = QByteArray(reinterpret_cast<const char*>(header.costModelSignature), sizeof(header.costModelSignature));
+    _nodePositions = qMove(nodePositions);
+    _edges = qMove(edges);
+    _upwardOutgoingOffsets = qMove(upwardOutgoingOffsets);
+    _upwardOutgoingEdges = qMove(upwardOutgoingEdges);
+    _upwardIncomingOffsets = qMove(upwardIncomingOffsets);
+    _upwardIncomingEdges = qMove(upwardIncomingEdges);
+    _isValid = true;
+
+    return true;
+}
+
+bool OsmAnd::ContractionHierarchy_P::isValid() const
+{
+    return _isValid;
+}
+
+int OsmAnd::ContractionHierarchy_P::getNodesCount() const
+{
+    return _nodePositions.size();
+}
+
+int OsmAnd::ContractionHierarchy_P::getEdgesCount() const
+{
+    return _edges.size();
+}
+
+bool OsmAnd::ContractionHierarchy_P::isUpToDate(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection,
+    const std::shared_ptr<const IRoadCostModel>& costModel) const
+{
+    if (!_isValid)
+        return false;
+
+    return
+        _costModelSignature == computeCostModelSignature(costModel) &&
+        _sourceSignature == Utilities::computeObfFilesSignature(obfsCollection->getObfFiles());
+}
+
+int OsmAnd::ContractionHierarchy_P::findNode(const PointI& position31) const
+{
+    const auto key = makePositionKey(position31);
+    const auto itNode = std::lower_bound(_nodePositions.cbegin(), _nodePositions.cend(), key,
+        []
+        (const PointI& nodePosition31, const uint64_t key) -> bool
+        {
+            return makePositionKey(nodePosition31) < key;
+        });
+    if (itNode == _nodePositions.cend() || *itNode != position31)
+        return -1;
+
+    return static_cast<int>(itNode - _nodePositions.cbegin());
+}
+
+void OsmAnd::ContractionHierarchy_P::QueryState::reset()
+{
+    for (const auto node : constOf(touchedNodes))
+    {
+        times[0][node] = times[1][node] = std::numeric_limits<float>::infinity();
+        parentEdges[0][node] = parentEdges[1][node] = -1;
+    }
+    touchedNodes.clear();
+    heaps[0].clear();
+    heaps[1].clear();
+}
+
+std::shared_ptr<OsmAnd::ContractionHierarchy_P::QueryState> OsmAnd::ContractionHierarchy_P::acquireQueryState() const
+{
+    {
+        QMutexLocker scopedLocker(&_idleQueryStatesMutex);
+
+        if (!_idleQueryStates.isEmpty())
+            return _idleQueryStates.takeLast();
+    }
+
+    const std::shared_ptr<QueryState> queryState(new QueryState());
+    for (auto direction = 0; direction < 2; direction++)
+    {
+        queryState->times[direction].resize(_nodePositions.size());
+        std::fill(queryState->times[direction].begin(), queryState->times[direction].end(), std::numeric_limits<float>::infinity());
+        queryState->parentEdges[direction].resize(_nodePositions.size());
+        std::fill(queryState->parentEdges[direction].begin(), queryState->parentEdges[direction].end(), -1);
+    }
+    return queryState;
+}
+
+void OsmAnd::ContractionHierarchy_P::releaseQueryState(const std::shared_ptr<QueryState>& queryState) const
+{
+    queryState->reset();
+
+    QMutexLocker scopedLocker(&_idleQueryStatesMutex);
+    _idleQueryStates.push_back(queryState);
+}
+
+bool OsmAnd::ContractionHierarchy_P::findPath(
+    const QList<Endpoint>& sources,
+    const QList<Endpoint>& targets,
+    Path& outPath,
+    const IQueryController* const controller) const
+{
+    if (!_isValid)
+        return false;
+
+    const auto queryState = acquireQueryState();
+    auto& times = queryState->times;
+    auto& parentEdges = queryState->parentEdges;
+    auto& heaps = queryState->heaps;
+
+    auto bestTime = std::numeric_limits<float>::infinity();
+    auto meetingNode = -1;
+    const auto push =
+        [&queryState, &times, &parentEdges, &heaps, &bestTime, &meetingNode]
+        (const int direction, const int node, const float time, const int parentEdge)
+        {
+            if (times[0][node] == std::numeric_limits<float>::infinity() &&
+                times[1][node] == std::numeric_limits<float>::infinity())
+            {
+                queryState->touchedNodes.push_back(node);
+            }
+            times[direction][node] = time;
+            parentEdges[direction][node] = parentEdge;
+
+            HeapEntry entry;
+            entry.key = time;
+            entry.node = node;
+            heaps[direction].push_back(entry);
+            std::push_heap(heaps[direction].begin(), heaps[direction].end(), heapEntryComparator);
+
+            const auto meetingTime = times[0][node] + times[1][node];
+            if (meetingTime < bestTime)
+            {
+                bestTime = meetingTime;
+                meetingNode = node;
+            }
+        };
+
+    // Junction copies made for turn restrictions follow the junction itself, and path may end at any of them
+    for (auto direction = 0; direction < 2; direction++)
+    {
+        for (const auto& endpoint : constOf(direction == 0 ? sources : targets))
+        {
+            for (auto node = findNode(endpoint.position31);
+                node >= 0 && node < _nodePositions.size() && _nodePositions[node] == endpoint.position31;
+                node++)
+            {
+                if (endpoint.time < times[direction][node])
+                    push(direction, node, endpoint.time, -1);
+            }
+        }
+    }
+
+    // Both searches go only upwards. Each of them stops when its smallest time reaches the best
+    // meeting time, since any other meeting node can't give faster path
+    unsigned int settledNodesCount = 0;
+    while (true)
+    {
+        if (controller && controller->isAborted())
+        {
+            releaseQueryState(queryState);
+            return false;
+        }
+
+        for (auto direction = 0; direction < 2; direction++)
+        {
+            if (!heaps[direction].isEmpty() && heaps[direction].first().key >= bestTime)
+                heaps[direction].clear();
+        }
+        if (heaps[0].isEmpty() && heaps[1].isEmpty())
+            break;
+        const auto direction = heaps[1].isEmpty() || (!heaps[0].isEmpty() && heaps[0].first().key <= heaps[1].first().key)
+            ? 0
+            : 1;
+        auto& heap = heaps[direction];
+
+        const auto entry = heap.first();
+        std::pop_heap(heap.begin(), heap.end(), heapEntryComparator);
+        heap.removeLast();
+        if (entry.key > times[direction][entry.node])
+            continue;
+        const auto node = entry.node;
+        const auto time = entry.key;
+        settledNodesCount++;
+
+        if (isStalled(*queryState, direction, node, time))
+            continue;
+
+        const auto& offsets = (direction == 0) ? _upwardOutgoingOffsets : _upwardIncomingOffsets;
+        const auto& edges = (direction == 0) ? _upwardOutgoingEdges : _upwardIncomingEdges;
+        for (auto idx = offsets[node], endIdx = offsets[node + 1]; idx < endIdx; idx++)
+        {
+            const auto edgeIdx = static_cast<int>(edges[idx]);
+            const auto& edge = _edges[edgeIdx];
+            const auto nextNode = static_cast<int>((direction == 0) ? edge.target : edge.source);
+            const auto newTime = time + edge.time;
+            if (newTime < times[direction][nextNode])
+                push(direction, nextNode, newTime, edgeIdx);
+        }
+    }
+
+    if (meetingNode < 0)
+    {
+        releaseQueryState(queryState);
+        return false;
+    }
+
+    // Chain of edges from source to meeting node is collected backwards
+    QVector<int> pathEdges;
+    auto firstNode = meetingNode;
+    for (auto edgeIdx = parentEdges[0][meetingNode]; edgeIdx >= 0; edgeIdx = parentEdges[0][firstNode])
+    {
+        pathEdges.push_back(edgeIdx);
+        firstNode = _edges[edgeIdx].source;
+    }
+    std::reverse(pathEdges.begin(), pathEdges.end());
+    auto lastNode = meetingNode;
+    for (auto edgeIdx = parentEdges[1][meetingNode]; edgeIdx >= 0; edgeIdx = parentEdges[1][lastNode])
+    {
+        pathEdges.push_back(edgeIdx);
+        lastNode = _edges[edgeIdx].target;
+    }
+    releaseQueryState(queryState);
+
+    outPath = Path();
+    outPath.time = bestTime;
+    outPath.settledNodesCount = settledNodesCount;
+    outPath.points31.push_back(_nodePositions[firstNode]);
+    for (const auto edgeIdx : constOf(pathEdges))
+        unpackEdge(edgeIdx, outPath.points31, outPath.distance);
+
+    return true;
+}
+
+bool OsmAnd::ContractionHierarchy_P::isStalled(
+    const QueryState& queryState,
+    const int direction,
+    const int node,
+    const float time) const
+{
+    // Stall-on-demand: if node can be reached faster through a higher node that is already reached,
+    // search doesn't continue from it
+    const auto& offsets = (direction == 0) ? _upwardIncomingOffsets : _upwardOutgoingOffsets;
+    const auto& edges = (direction == 0) ? _upwardIncomingEdges : _upwardOutgoingEdges;
+    for (auto idx = offsets[node], endIdx = offsets[node + 1]; idx < endIdx; idx++)
+    {
+        const auto& edge = _edges[edges[idx]];
+        const auto higherNode = (direction == 0) ? edge.source : edge.target;
+        if (queryState.times[direction][higherNode] + edge.time < time)
+            return true;
+    }
+
+    return false;
+}
+
+void OsmAnd::ContractionHierarchy_P::searchUpwards(
+    QueryState& queryState,
+    const int direction,
+    const QList<Endpoint>& endpoints,
+    const std::function<void (const int node, const float time)> visitor) const
+{
+    auto& times = queryState.times[direction];
+    auto& heap = queryState.heaps[direction];
+    const auto push =
+        [&queryState, &times, &heap]
+        (const int node, const float time)
+        {
+            if (queryState.times[0][node] == std::numeric_limits<float>::infinity() &&
+                queryState.times[1][node] == std::numeric_limits<float>::infinity())
+            {
+                queryState.touchedNodes.push_back(node);
+            }
+            times[node] = time;
+
+            HeapEntry entry;
+            entry.key = time;
+            entry.node = node;
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), heapEntryComparator);
+        };
+
+    for (const auto& endpoint : constOf(endpoints))
+    {
+        for (auto node = findNode(endpoint.position31);
+            node >= 0 && node < _nodePositions.size() && _nodePositions[node] == endpoint.position31;
+            node++)
+        {
+            if (endpoint.time < times[node])
+                push(node, endpoint.time);
+        }
+    }
+
+    // Whole upward search space is visited: it's small, and unlike point-to-point query
+    // there's no single meeting node to stop at
+    while (!heap.isEmpty())
+    {
+        const auto entry = heap.first();
+        std::pop_heap(heap.begin(), heap.end(), heapEntryComparator);
+        heap.removeLast();
+        if (entry.key > times[entry.node])
+            continue;
+        if (isStalled(queryState, direction, entry.node, entry.key))
+            continue;
+
+        visitor(entry.node, entry.key);
+
+        const auto& offsets = (direction == 0) ? _upwardOutgoingOffsets : _upwardIncomingOffsets;
+        const auto& edges = (direction == 0) ? _upwardOutgoingEdges : _upwardIncomingEdges;
+        for (auto idx = offsets[entry.node], endIdx = offsets[entry.node + 1]; idx < endIdx; idx++)
+        {
+            const auto& edge = _edges[edges[idx]];
+            const auto nextNode = static_cast<int>((direction == 0) ? edge.target : edge.source);
+            const auto newTime = entry.key + edge.time;
+            if (newTime < times[nextNode])
+                push(nextNode, newTime);
+        }
+    }
+}
+
+bool OsmAnd::ContractionHierarchy_P::findTravelTimes(
+    const QVector< QList<Endpoint> >& sources,
+    const QVector< QList<Endpoint> >& targets,
+    QVector<float>& outTimes,
+    const unsigned int threadsCount,
+    const IQueryController* const controller) const
+{
+    if (!_isValid)
+        return false;
+
+    const auto sourcesCount = sources.size();
+    const auto targetsCount = targets.size();
+    outTimes.resize(sourcesCount * targetsCount);
+    std::fill(outTimes.begin(), outTimes.end(), std::numeric_limits<float>::infinity());
+    if (sourcesCount == 0 || targetsCount == 0)
+        return true;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadsCount > 0 ? threadsCount : QThread::idealThreadCount());
+    const auto runInParallel =
+        [this, &threadPool, controller]
+        (const int count, const std::function<void (const int index, QueryState& queryState)> method)
+        {
+            QAtomicInt nextIndex(0);
+            for (auto workerIdx = 0, workersCount = threadPool.maxThreadCount(); workerIdx < workersCount; workerIdx++)
+            {
+                threadPool.start(new Concurrent::Task(
+                    [this, count, method, controller, &nextIndex]
+                    (Concurrent::Task* const task)
+                    {
+                        Q_UNUSED(task);
+
+                        const auto queryState = acquireQueryState();
+                        for (auto index = nextIndex.fetchAndAddOrdered(1); index < count; index = nextIndex.fetchAndAddOrdered(1))
+                        {
+                            if (controller && controller->isAborted())
+                                break;
+
+                            method(index, *queryState);
+                            queryState->reset();
+                        }
+                        releaseQueryState(queryState);
+                    }));
+            }
+            threadPool.waitForDone();
+        };
+
+    // Backward upward search from each target leaves (target, time) in bucket of every node it reaches
+    struct BucketEntry
+    {
+        int node;
+        int target;
+        float time;
+    };
+    QVector< QVector<BucketEntry> > bucketEntriesByTarget(targetsCount);
+    const auto pBucketEntriesByTarget = bucketEntriesByTarget.data();
+    runInParallel(targetsCount,
+        [this, &targets, pBucketEntriesByTarget]
+        (const int target, QueryState& queryState)
+        {
+            auto& bucketEntries = pBucketEntriesByTarget[target];
+            searchUpwards(queryState, 1, targets[target],
+                [&bucketEntries, target]
+                (const int node, const float time)
+                {
+                    BucketEntry bucketEntry;
+                    bucketEntry.node = node;
+                    bucketEntry.target = target;
+                    bucketEntry.time = time;
+                    bucketEntries.push_back(bucketEntry);
+                });
+        });
+    if (controller && controller->isAborted())
+        return false;
+
+    QVector<BucketEntry> bucketEntries;
+    for (const auto& targetBucketEntries : constOf(bucketEntriesByTarget))
+        bucketEntries += targetBucketEntries;
+    bucketEntriesByTarget.clear();
+    std::sort(bucketEntries.begin(), bucketEntries.end(),
+        []
+        (const BucketEntry& l, const BucketEntry& r) -> bool
+        {
+            return l.node < r.node;
+        });
+
+    // Forward upward search from each source scans buckets of nodes it reaches. Each source fills
+    // its own row, so rows are written without any locking
+    const auto pTimes = outTimes.data();
+    runInParallel(sourcesCount,
+        [this, &sources, &bucketEntries, pTimes, targetsCount]
+        (const int source, QueryState& queryState)
+        {
+            const auto pRow = pTimes + source * targetsCount;
+            searchUpwards(queryState, 0, sources[source],
+                [&bucketEntries, pRow]
+                (const int node, const float time)
+                {
+                    auto itBucketEntry = std::lower_bound(bucketEntries.cbegin(), bucketEntries.cend(), node,
+                        []
+                        (const BucketEntry& bucketEntry, const int node) -> bool
+                        {
+                            return bucketEntry.node < node;
+                        });
+                    for (; itBucketEntry != bucketEntries.cend() && itBucketEntry->node == node; ++itBucketEntry)
+                    {
+                        const auto totalTime = time + itBucketEntry->time;
+                        if (totalTime < pRow[itBucketEntry->target])
+                            pRow[itBucketEntry->target] = totalTime;
+                    }
+                });
+        });
+
+    return !(controller && controller->isAborted());
+}
+
+void OsmAnd::ContractionHierarchy_P::unpackEdge(const int edge, QVector<PointI>& outPoints31, double& outDistance) const
+{
+    // Shortcuts can be nested deeply, so explicit stack is used instead of recursion
+    QVector<int> edgesStack;
+    edgesStack.push_back(edge);
+    while (!edgesStack.isEmpty())
+    {
+        const auto& currentEdge = _edges[edgesStack.last()];
+        edgesStack.removeLast();
+
+        if (currentEdge.firstChild < 0)
+        {
+            outPoints31.push_back(_nodePositions[currentEdge.target]);
+            outDistance += currentEdge.length;
+            continue;
+        }
+
+        edgesStack.push_back(currentEdge.secondChild);
+        edgesStack.push_back(currentEdge.firstChild);
+    }
+}
+
+bool OsmAnd::ContractionHierarchy_P::build(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection,
+    const std::shared_ptr<const IRoadCostModel>& costModel,
+    const QString& outputFilename,
+    BuildStatistics* const outStatistics,
+    const IQueryController* const controller)
+{
+    RoadGraph graph(obfsCollection, costModel, nullptr);
+    if (!graph.loadAll(controller))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to load roads for contraction hierarchy '%s'", qPrintable(outputFilename));
+        return false;
+    }
+    const auto graphNodesCount = graph.getNodesCount();
+    const auto graphEdgesCount = graph.getEdgesCount();
+
+    // Hierarchy is node-based, so turn restrictions are expanded into extra nodes: edges of a road that has
+    // restricted turns at a junction arrive at own copy of that junction, which keeps only allowed outgoing edges
+    QHash< QPair<int, int>, int > turnStatesByJunctionRoad;
+    QVector<int> turnStateJunctions;
+    QVector<int> turnStateIncomingEdges;
+    QVector<int> edgesTurnStates(graphEdgesCount);
+    std::fill(edgesTurnStates.begin(), edgesTurnStates.end(), -1);
+    for (auto edgeIdx = 0; edgeIdx < graphEdgesCount; edgeIdx++)
+    {
+        const auto& edge = graph.getEdge(edgeIdx);
+        auto restricted = false;
+        for (auto nextEdgeIdx = graph.getFirstOutgoingEdge(edge.target); nextEdgeIdx >= 0 && !restricted; nextEdgeIdx = graph.getEdge(nextEdgeIdx).nextOutgoing)
+            restricted = !graph.isTurnAllowed(edgeIdx, nextEdgeIdx);
+        if (!restricted)
+            continue;
+
+        // Allowed turns depend only on the road and the junction
+        const auto junctionRoad = qMakePair(edge.target, edge.road);
+        auto itTurnState = turnStatesByJunctionRoad.find(junctionRoad);
+        if (itTurnState == turnStatesByJunctionRoad.end())
+        {
+            itTurnState = turnStatesByJunctionRoad.insert(junctionRoad, graphNodesCount + turnStateJunctions.size());
+            turnStateJunctions.push_back(edge.target);
+            turnStateIncomingEdges.push_back(edgeIdx);
+        }
+        edgesTurnStates[edgeIdx] = *itTurnState;
+    }
+    const auto nodesCount = graphNodesCount + turnStateJunctions.size();
+    const auto getJunction =
+        [graphNodesCount, &turnStateJunctions]
+        (const int graphNode) -> int
+        {
+            return graphNode < graphNodesCount ? graphNode : turnStateJunctions[graphNode - graphNodesCount];
+        };
+
+    // Nodes are numbered in order of their positions, so that they can be found by binary search.
+    // Junction copies go right after the junction they share position with
+    QVector<int> graphNodes(nodesCount);
+    for (auto node = 0; node < nodesCount; node++)
+        graphNodes[node] = node;
+    std::sort(graphNodes.begin(), graphNodes.end(),
+        [&graph, &getJunction]
+        (const int l, const int r) -> bool
+        {
+            const auto lKey = makePositionKey(graph.getNodePosition(getJunction(l)));
+            const auto rKey = makePositionKey(graph.getNodePosition(getJunction(r)));
+            return lKey < rKey || (lKey == rKey && l < r);
+        });
+    QVector<int> nodesByGraphNode(nodesCount);
+    QVector<PointI> nodePositions(nodesCount);
+    for (auto node = 0; node < nodesCount; node++)
+    {
+        nodesByGraphNode[graphNodes[node]] = node;
+        nodePositions[node] = graph.getNodePosition(getJunction(graphNodes[node]));
+    }
+
+    QVector<Edge> edges;
+    edges.reserve(graphEdgesCount * 2);
+    QVector< QVector<int> > outgoingEdges(nodesCount);
+    QVector< QVector<int> > incomingEdges(nodesCount);
+    const auto addEdge =
+        [&edges, &outgoingEdges, &incomingEdges]
+        (const int source, const int target, const float time, const float length, const int firstChild, const int secondChild)
+        {
+            Edge edge;
+            edge.source = source;
+            edge.target = target;
+            edge.time = time;
+            edge.length = length;
+            edge.firstChild = firstChild;
+            edge.secondChild = secondChild;
+
+            outgoingEdges[source].push_back(edges.size());
+            incomingEdges[target].push_back(edges.size());
+            edges.push_back(edge);
+        };
+    const auto getEdgeTarget =
+        [&graph, &edgesTurnStates, &nodesByGraphNode]
+        (const int edgeIdx) -> int
+        {
+            const auto turnState = edgesTurnStates[edgeIdx];
+            return nodesByGraphNode[turnState >= 0 ? turnState : graph.getEdge(edgeIdx).target];
+        };
+    for (auto edgeIdx = 0; edgeIdx < graphEdgesCount; edgeIdx++)
+    {
+        const auto& edge = graph.getEdge(edgeIdx);
+        addEdge(nodesByGraphNode[edge.source], getEdgeTarget(edgeIdx), edge.time, edge.length, -1, -1);
+    }
+    for (auto turnStateIdx = 0; turnStateIdx < turnStateJunctions.size(); turnStateIdx++)
+    {
+        const auto incomingEdgeIdx = turnStateIncomingEdges[turnStateIdx];
+        const auto junction = turnStateJunctions[turnStateIdx];
+        for (auto edgeIdx = graph.getFirstOutgoingEdge(junction); edgeIdx >= 0; edgeIdx = graph.getEdge(edgeIdx).nextOutgoing)
+        {
+            if (!graph.isTurnAllowed(incomingEdgeIdx, edgeIdx))
+                continue;
+
+            const auto& edge = graph.getEdge(edgeIdx);
+            addEdge(nodesByGraphNode[graphNodesCount + turnStateIdx], getEdgeTarget(edgeIdx), edge.time, edge.length, -1, -1);
+        }
+    }
+    const auto originalEdgesCount = edges.size();
+
+    QVector<int> ranks(nodesCount);
+    std::fill(ranks.begin(), ranks.end(), -1);
+    QVector<int> contractedNeighboursCounts(nodesCount);
+    std::fill(contractedNeighboursCounts.begin(), contractedNeighboursCounts.end(), 0);
+
+    // Witness search: limited Dijkstra over not yet contracted nodes, that avoids node being contracted
+    QVector<float> witnessTimes(nodesCount);
+    std::fill(witnessTimes.begin(), witnessTimes.end(), std::numeric_limits<float>::infinity());
+    QVector<int> witnessTouchedNodes;
+    QVector<HeapEntry> witnessHeap;
+    const auto witnessSearch =
+        [&edges, &outgoingEdges, &ranks, &witnessTimes, &witnessTouchedNodes, &witnessHeap]
+        (const int source, const int excludedNode, const float maxTime)
+        {
+            for (const auto node : constOf(witnessTouchedNodes))
+                witnessTimes[node] = std::numeric_limits<float>::infinity();
+            witnessTouchedNodes.clear();
+            witnessHeap.clear();
+
+            HeapEntry entry;
+            entry.key = 0.0f;
+            entry.node = source;
+            witnessTimes[source] = 0.0f;
+            witnessTouchedNodes.push_back(source);
+            witnessHeap.push_back(entry);
+
+            auto settledNodesCount = 0;
+            while (!witnessHeap.isEmpty() && settledNodesCount < MaxWitnessSettledNodes)
+            {
+                const auto top = witnessHeap.first();
+                std::pop_heap(witnessHeap.begin(), witnessHeap.end(), heapEntryComparator);
+                witnessHeap.removeLast();
+                if (top.key > witnessTimes[top.node])
+                    continue;
+                if (top.key > maxTime)
+                    break;
+                settledNodesCount++;
+
+                for (const auto edgeIdx : constOf(outgoingEdges[top.node]))
+                {
+                    const auto& edge = edges[edgeIdx];
+                    const auto target = static_cast<int>(edge.target);
+                    if (target == excludedNode || ranks[target] >= 0)
+                        continue;
+
+                    const auto newTime = top.key + edge.time;
+                    if (newTime >= witnessTimes[target])
+                        continue;
+                    if (witnessTimes[target] == std::numeric_limits<float>::infinity())
+                        witnessTouchedNodes.push_back(target);
+                    witnessTimes[target] = newTime;
+
+                    HeapEntry nextEntry;
+                    nextEntry.key = newTime;
+                    nextEntry.node = target;
+                    witnessHeap.push_back(nextEntry);
+                    std::push_heap(witnessHeap.begin(), witnessHeap.end(), heapEntryComparator);
+                }
+            }
+        };
+
+    // Of parallel edges to (or from) the same neighbour only the fastest one matters
+    const auto collectFastestEdges =
+        [&edges, &ranks]
+        (const QVector<int>& nodeEdges, const int node, const bool outgoing, QVector<int>& outFastestEdges)
+        {
+            outFastestEdges.clear();
+            for (const auto edgeIdx : constOf(nodeEdges))
+            {
+                const auto& edge = edges[edgeIdx];
+                const auto neighbour = static_cast<int>(outgoing ? edge.target : edge.source);
+                if (neighbour == node || ranks[neighbour] >= 0)
+                    continue;
+
+                auto duplicate = false;
+                for (auto& fastestEdgeIdx : outFastestEdges)
+                {
+                    const auto& fastestEdge = edges[fastestEdgeIdx];
+                    if (static_cast<int>(outgoing ? fastestEdge.target : fastestEdge.source) != neighbour)
+                        continue;
+
+                    duplicate = true;
+                    if (edge.time < fastestEdge.time)
+                        fastestEdgeIdx = edgeIdx;
+                    break;
+                }
+                if (!duplicate)
+                    outFastestEdges.push_back(edgeIdx);
+            }
+        };
+
+    // Contraction of a node replaces every path u->node->w, for which there's no witness path of
+    // the same time or faster, with a shortcut. When only simulated, shortcuts are just counted
+    QVector<int> nodeIncomingEdges;
+    QVector<int> nodeOutgoingEdges;
+    const auto contract =
+        [&edges, &outgoingEdges, &incomingEdges, &witnessTimes, &nodeIncomingEdges, &nodeOutgoingEdges,
+            &witnessSearch, &collectFastestEdges, &addEdge]
+        (const int node, const bool simulate) -> int
+        {
+            collectFastestEdges(incomingEdges[node], node, false, nodeIncomingEdges);
+            collectFastestEdges(outgoingEdges[node], node, true, nodeOutgoingEdges);
+
+            auto shortcutsCount = 0;
+            for (const auto incomingEdgeIdx : constOf(nodeIncomingEdges))
+            {
+                const auto incomingEdge = edges[incomingEdgeIdx];
+                const auto source = static_cast<int>(incomingEdge.source);
+
+                auto maxTime = -1.0f;
+                for (const auto outgoingEdgeIdx : constOf(nodeOutgoingEdges))
+                {
+                    const auto& outgoingEdge = edges[outgoingEdgeIdx];
+                    if (static_cast<int>(outgoingEdge.target) != source)
+                        maxTime = qMax(maxTime, incomingEdge.time + outgoingEdge.time);
+                }
+                if (maxTime < 0.0f)
+                    continue;
+
+                witnessSearch(source, node, maxTime);
+                for (const auto outgoingEdgeIdx : constOf(nodeOutgoingEdges))
+                {
+                    const auto outgoingEdge = edges[outgoingEdgeIdx];
+                    const auto target = static_cast<int>(outgoingEdge.target);
+                    const auto time = incomingEdge.time + outgoingEdge.time;
+                    if (target == source || witnessTimes[target] <= time)
+                        continue;
+
+                    shortcutsCount++;
+                    if (!simulate)
+                    {
+                        addEdge(source, target, time, incomingEdge.length + outgoingEdge.length,
+                            incomingEdgeIdx, outgoingEdgeIdx);
+                    }
+                }
+            }
+
+            return shortcutsCount;
+        };
+
+    // Priority is edge difference plus number of contracted neighbours, which spreads contraction
+    // evenly. Priorities of other nodes change as contraction proceeds, so they are updated lazily
+    const auto computePriority =
+        [&nodeIncomingEdges, &nodeOutgoingEdges, &contractedNeighboursCounts, &contract]
+        (const int node) -> int
+        {
+            const auto shortcutsCount = contract(node, true);
+            return shortcutsCount - nodeIncomingEdges.size() - nodeOutgoingEdges.size() + contractedNeighboursCounts[node];
+        };
+    typedef std::pair<int, int> PriorityEntry;
+    std::priority_queue< PriorityEntry, std::vector<PriorityEntry>, std::greater<PriorityEntry> > priorityQueue;
+    for (auto node = 0; node < nodesCount; node++)
+    {
+        if (node % 1000 == 0 && controller && controller->isAborted())
+            return false;
+
+        priorityQueue.push(PriorityEntry(computePriority(node), node));
+    }
+
+    auto nextRank = 0;
+    while (!priorityQueue.empty())
+    {
+        if (nextRank % 1000 == 0 && controller && controller->isAborted())
+            return false;
+
+        const auto node = priorityQueue.top().second;
+        priorityQueue.pop();
+
+        const auto priority = computePriority(node);
+        if (!priorityQueue.empty() && priority > priorityQueue.top().first)
+        {
+            priorityQueue.push(PriorityEntry(priority, node));
+            continue;
+        }
+
+        contract(node, false);
+        ranks[node] = nextRank++;
+        for (const auto edgeIdx : constOf(nodeIncomingEdges))
+            contractedNeighboursCounts[edges[edgeIdx].source]++;
+        for (const auto edgeIdx : constOf(nodeOutgoingEdges))
+            contractedNeighboursCounts[edges[edgeIdx].target]++;
+    }
+
+    // Edge from lower to higher node is upward outgoing edge of its source, otherwise it's
+    // upward incoming edge of its target
+    QVector<uint32_t> upwardOutgoingOffsets(nodesCount + 1);
+    QVector<uint32_t> upwardIncomingOffsets(nodesCount + 1);
+    std::fill(upwardOutgoingOffsets.begin(), upwardOutgoingOffsets.end(), 0);
+    std::fill(upwardIncomingOffsets.begin(), upwardIncomingOffsets.end(), 0);
+    for (const auto& edge : constOf(edges))
+    {
+        if (ranks[edge.target] > ranks[edge.source])
+            upwardOutgoingOffsets[edge.source + 1]++;
+        else
+            upwardIncomingOffsets[edge.target + 1]++;
+    }
+    for (auto node = 0; node < nodesCount; node++)
+    {
+        upwardOutgoingOffsets[node + 1] += upwardOutgoingOffsets[node];
+        upwardIncomingOffsets[node + 1] += upwardIncomingOffsets[node];
+    }
+    QVector<uint32_t> upwardOutgoingEdges(upwardOutgoingOffsets.last());
+    QVector<uint32_t> upwardIncomingEdges(upwardIncomingOffsets.last());
+    {
+        auto upwardOutgoingPositions = upwardOutgoingOffsets;
+        auto upwardIncomingPositions = upwardIncomingOffsets;
+        for (auto edgeIdx = 0, edgesCount = edges.size(); edgeIdx < edgesCount; edgeIdx++)
+        {
+            const auto& edge = edges[edgeIdx];
+            if (ranks[edge.target] > ranks[edge.source])
+                upwardOutgoingEdges[upwardOutgoingPositions[edge.source]++] = edgeIdx;
+            else
+                upwardIncomingEdges[upwardIncomingPositions[edge.target]++] = edgeIdx;
+        }
+    }
+
+    QFile output(outputFilename);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open '%s' for writing: %s", qPrintable(outputFilename), qPrintable(output.errorString()));
+        return false;
+    }
+
+    FileHeader header;
+    header.signature = Signature;
+    header.version = Version;
+    header.nodesCount = nodesCount;
+    header.edgesCount = edges.size();
+    header.upwardOutgoingEdgesCount = upwardOutgoingEdges.size();
+    header.upwardIncomingEdgesCount = upwardIncomingEdges.size();
+    const auto sourceSignature = Utilities::computeObfFilesSignature(obfsCollection->getObfFiles());
+    const auto costModelSignature = computeCostModelSignature(costModel);
+    memcpy(header.sourceSignature, sourceSignature.constData(), sizeof(header.sourceSignature));
+    memcpy(header.costModelSignature, costModelSignature.constData(), sizeof(header.costModelSignature));
+
+    auto ok = FlatArraysIO::write(output, header);
+    ok = ok && FlatArraysIO::writeArray(output, nodePositions);
+    ok = ok && FlatArraysIO::writeArray(output, edges);
+    ok = ok && FlatArraysIO::writeArray(output, upwardOutgoingOffsets);
+    ok = ok && FlatArraysIO::writeArray(output, upwardOutgoingEdges);
+    ok = ok && FlatArraysIO::writeArray(output, upwardIncomingOffsets);
+    ok = ok && FlatArraysIO::writeArray(output, upwardIncomingEdges);
+    output.close();
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to write contraction hierarchy '%s'", qPrintable(outputFilename));
+        QFile::remove(outputFilename);
+        return false;
+    }
+
+    if (outStatistics)
+    {
+        outStatistics->nodesCount = nodesCount;
+        outStatistics->edgesCount = originalEdgesCount;
+        outStatistics->shortcutsCount = edges.size() - originalEdgesCount;
+    }
+
+    return true;
+}
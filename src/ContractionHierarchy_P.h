@@ -0,0 +1,148 @@
+#ifndef _OSMAND_CORE_CONTRACTION_HIERARCHY_P_H_
+#define _OSMAND_CORE_CONTRACTION_HIERARCHY_P_H_
+
+#include "stdlib_common.h"
+#include <functional>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "ContractionHierarchy.h"
+
+namespace OsmAnd
+{
+    class ContractionHierarchy;
+    class ContractionHierarchy_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(ContractionHierarchy_P);
+
+    public:
+        typedef ContractionHierarchy::Endpoint Endpoint;
+        typedef ContractionHierarchy::Path Path;
+        typedef ContractionHierarchy::BuildStatistics BuildStatistics;
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t signature;
+            uint32_t version;
+            uint32_t nodesCount;
+            uint32_t edgesCount;
+            uint32_t upwardOutgoingEdgesCount;
+            uint32_t upwardIncomingEdgesCount;
+            uint8_t sourceSignature[16];
+            uint8_t costModelSignature[16];
+        };
+
+        // Shortcut replaces path of two edges, original edge has no children
+        struct Edge
+        {
+            uint32_t source;
+            uint32_t target;
+            float time;
+            float length;
+            int32_t firstChild;
+            int32_t secondChild;
+        };
+#pragma pack(pop)
+
+        static const uint32_t Signature;
+        static const uint32_t Version;
+        // Witness search gives up after settling this many nodes. Witness that was not found only
+        // causes a redundant shortcut, never a wrong route
+        static const int MaxWitnessSettledNodes;
+
+    private:
+        struct HeapEntry
+        {
+            float key;
+            int node;
+        };
+
+        // Buffers of a single query, sized by nodes count once and then reused by next queries.
+        // Only nodes touched by query are reset afterwards
+        struct QueryState
+        {
+            QVector<float> times[2];
+            QVector<int> parentEdges[2];
+            QVector<HeapEntry> heaps[2];
+            QVector<int> touchedNodes;
+
+            void reset();
+        };
+
+        bool _isValid;
+        QByteArray _sourceSignature;
+        QByteArray _costModelSignature;
+        QVector<PointI> _nodePositions;
+        QVector<Edge> _edges;
+        QVector<uint32_t> _upwardOutgoingOffsets;
+        QVector<uint32_t> _upwardOutgoingEdges;
+        QVector<uint32_t> _upwardIncomingOffsets;
+        QVector<uint32_t> _upwardIncomingEdges;
+
+        mutable QMutex _idleQueryStatesMutex;
+        mutable QList< std::shared_ptr<QueryState> > _idleQueryStates;
+
+        std::shared_ptr<QueryState> acquireQueryState() const;
+        void releaseQueryState(const std::shared_ptr<QueryState>& queryState) const;
+        void unpackEdge(const int edge, QVector<PointI>& outPoints31, double& outDistance) const;
+        bool isStalled(const QueryState& queryState, const int direction, const int node, const float time) const;
+        // Visits every node of upward search space of endpoints in given direction (0 - forward, 1 - backward)
+        void searchUpwards(
+            QueryState& queryState,
+            const int direction,
+            const QList<Endpoint>& endpoints,
+            const std::function<void (const int node, const float time)> visitor) const;
+
+        static bool heapEntryComparator(const HeapEntry& l, const HeapEntry& r);
+        static uint64_t makePositionKey(const PointI& position31);
+        static QByteArray computeCostModelSignature(const std::shared_ptr<const IRoadCostModel>& costModel);
+    protected:
+        ContractionHierarchy_P(ContractionHierarchy* const owner);
+
+        bool open();
+    public:
+        ~ContractionHierarchy_P();
+
+        ImplementationInterface<ContractionHierarchy> owner;
+
+        bool isValid() const;
+        int getNodesCount() const;
+        int getEdgesCount() const;
+        bool isUpToDate(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel) const;
+        int findNode(const PointI& position31) const;
+        bool findPath(
+            const QList<Endpoint>& sources,
+            const QList<Endpoint>& targets,
+            Path& outPath,
+            const IQueryController* const controller) const;
+        bool findTravelTimes(
+            const QVector< QList<Endpoint> >& sources,
+            const QVector< QList<Endpoint> >& targets,
+            QVector<float>& outTimes,
+            const unsigned int threadsCount,
+            const IQueryController* const controller) const;
+
+        static bool build(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel,
+            const QString& outputFilename,
+            BuildStatistics* const outStatistics,
+            const IQueryController* const controller);
+
+    friend class OsmAnd::ContractionHierarchy;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_CONTRACTION_HIERARCHY_P_H_)
@@ -0,0 +1,50 @@
+#include "BudgetedRoutingDataBlocksCache.h"
+#include "BudgetedRoutingDataBlocksCache_P.h"
+
+const size_t OsmAnd::BudgetedRoutingDataBlocksCache::DefaultMemoryBudget = 128 * 1024 * 1024;
+const double OsmAnd::BudgetedRoutingDataBlocksCache::DefaultRouteCorridorInMeters = 1000.0;
+
+OsmAnd::BudgetedRoutingDataBlocksCache::BudgetedRoutingDataBlocksCache(const size_t memoryBudget_ /*= DefaultMemoryBudget*/)
+    : _p(new BudgetedRoutingDataBlocksCache_P(this))
+    , memoryBudget(memoryBudget_)
+{
+}
+
+OsmAnd::BudgetedRoutingDataBlocksCache::~BudgetedRoutingDataBlocksCache()
+{
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache::onBlockObtained(
+    const std::shared_ptr<const DataBlock>& dataBlock,
+    const bool wasRead)
+{
+    _p->onBlockObtained(dataBlock, wasRead);
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache::pinArea(const AreaI& area31)
+{
+    _p->pinAreas(QList<AreaI>() << area31);
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache::pinRoute(
+    const QVector<PointI>& points31,
+    const double corridorInMeters /*= DefaultRouteCorridorInMeters*/)
+{
+    _p->pinRoute(points31, corridorInMeters);
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache::unpinAll()
+{
+    _p->unpinAll();
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache::evictUnpinned()
+{
+    _p->evictUnpinned();
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache::obtainMetric(
+    ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache& outMetric) const
+{
+    _p->obtainMetric(outMetric);
+}
@@ -0,0 +1,183 @@
+#include "BudgetedRoutingDataBlocksCache_P.h"
+#include "BudgetedRoutingDataBlocksCache.h"
+
+#include "Road.h"
+#include "Utilities.h"
+
+const int OsmAnd::BudgetedRoutingDataBlocksCache_P::RoutePointsPerPinnedArea = 16;
+
+OsmAnd::BudgetedRoutingDataBlocksCache_P::BudgetedRoutingDataBlocksCache_P(BudgetedRoutingDataBlocksCache* const owner_)
+    : _residentMemoryUsage(0)
+    , _hits(0)
+    , _misses(0)
+    , _evictions(0)
+    , owner(owner_)
+{
+}
+
+OsmAnd::BudgetedRoutingDataBlocksCache_P::~BudgetedRoutingDataBlocksCache_P()
+{
+}
+
+bool OsmAnd::BudgetedRoutingDataBlocksCache_P::isPinned(const AreaI& area31) const
+{
+    for (const auto& pinnedArea31 : constOf(_pinnedAreas))
+    {
+        if (pinnedArea31.intersects(area31))
+            return true;
+    }
+
+    return false;
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::evict(const uint64_t blockId)
+{
+    auto residentBlock = _residentBlocks.take(blockId);
+    _residentMemoryUsage -= residentBlock.memoryUsage;
+    _evictions++;
+
+    // Block leaves the cache now, or once the last query that references it releases it
+    owner->releaseReference(blockId, residentBlock.dataBlock);
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::enforceBudget()
+{
+    typedef ClockEvictionList<uint64_t>::Candidate Candidate;
+
+    _clock.evictWhile(
+        [this]
+        () -> bool
+        {
+            return _residentMemoryUsage > owner->memoryBudget;
+        },
+        [this]
+        (const uint64_t blockId) -> Candidate
+        {
+            auto& residentBlock = _residentBlocks[blockId];
+            if (residentBlock.pinned || owner->getReferencesCount(blockId) > 1)
+                return Candidate::Keep;
+            if (residentBlock.recentlyUsed)
+            {
+                residentBlock.recentlyUsed = false;
+                return Candidate::SecondChance;
+            }
+
+            evict(blockId);
+            return Candidate::Evict;
+        });
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::onBlockObtained(
+    const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& dataBlock,
+    const bool wasRead)
+{
+    QMutexLocker scopedLocker(&_residentBlocksMutex);
+
+    if (wasRead)
+        _misses++;
+    else
+        _hits++;
+
+    const auto itResidentBlock = _residentBlocks.find(dataBlock->id);
+    if (itResidentBlock != _residentBlocks.end())
+    {
+        itResidentBlock->recentlyUsed = true;
+        return;
+    }
+
+    // Cache holds a reference of its own, so that block is not removed once queries release it
+    ResidentBlock residentBlock;
+    if (!owner->obtainReference(dataBlock->id, residentBlock.dataBlock))
+        return;
+    residentBlock.memoryUsage = sizeof(ObfRoutingSectionReader::DataBlock);
+    for (const auto& road : constOf(dataBlock->roads))
+        residentBlock.memoryUsage += road->getMemoryUsage();
+    residentBlock.recentlyUsed = true;
+    residentBlock.pinned = isPinned(dataBlock->area31);
+
+    _clock.insert(dataBlock->id);
+    _residentBlocks.insert(dataBlock->id, residentBlock);
+    _residentMemoryUsage += residentBlock.memoryUsage;
+
+    enforceBudget();
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::pinAreas(const QList<AreaI>& areas31)
+{
+    QMutexLocker scopedLocker(&_residentBlocksMutex);
+
+    _pinnedAreas.append(areas31);
+    for (auto& residentBlock : _residentBlocks)
+    {
+        if (!residentBlock.pinned)
+            residentBlock.pinned = isPinned(residentBlock.dataBlock->area31);
+    }
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::pinRoute(const QVector<PointI>& points31, const double corridorInMeters)
+{
+    if (points31.isEmpty())
+        return;
+
+    // Route is covered by bboxes of consecutive parts of it, each part shares its first point with previous one
+    const PointI corridor31(
+        static_cast<int32_t>(Utilities::metersToX31(corridorInMeters)),
+        static_cast<int32_t>(Utilities::metersToY31(corridorInMeters)));
+    QList<AreaI> areas31;
+    for (auto firstPointIdx = 0, pointsCount = points31.size(); firstPointIdx < pointsCount; firstPointIdx += RoutePointsPerPinnedArea)
+    {
+        AreaI area31(points31[firstPointIdx], points31[firstPointIdx]);
+        const auto lastPointIdx = qMin(firstPointIdx + RoutePointsPerPinnedArea, pointsCount - 1);
+        for (auto pointIdx = firstPointIdx + 1; pointIdx <= lastPointIdx; pointIdx++)
+            area31.enlargeToInclude(points31[pointIdx]);
+        area31.enlargeBy(corridor31);
+        areas31.push_back(area31);
+    }
+
+    pinAreas(areas31);
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::unpinAll()
+{
+    QMutexLocker scopedLocker(&_residentBlocksMutex);
+
+    _pinnedAreas.clear();
+    for (auto& residentBlock : _residentBlocks)
+        residentBlock.pinned = false;
+
+    enforceBudget();
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::evictUnpinned()
+{
+    QMutexLocker scopedLocker(&_residentBlocksMutex);
+
+    _clock.evictIf(
+        [this]
+        (const uint64_t blockId) -> bool
+        {
+            if (_residentBlocks[blockId].pinned)
+                return false;
+
+            evict(blockId);
+            return true;
+        });
+}
+
+void OsmAnd::BudgetedRoutingDataBlocksCache_P::obtainMetric(
+    ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache& outMetric) const
+{
+    QMutexLocker scopedLocker(&_residentBlocksMutex);
+
+    outMetric.hits = _hits;
+    outMetric.misses = _misses;
+    outMetric.evictions = _evictions;
+    outMetric.residentBlocks = _residentBlocks.size();
+    outMetric.pinnedBlocks = 0;
+    for (const auto& residentBlock : constOf(_residentBlocks))
+    {
+        if (residentBlock.pinned)
+            outMetric.pinnedBlocks++;
+    }
+    outMetric.residentMemoryUsage = static_cast<unsigned int>(_residentMemoryUsage / 1024);
+}
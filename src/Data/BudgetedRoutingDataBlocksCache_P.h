@@ -0,0 +1,74 @@
+#ifndef _OSMAND_CORE_BUDGETED_ROUTING_DATA_BLOCKS_CACHE_P_H_
+#define _OSMAND_CORE_BUDGETED_ROUTING_DATA_BLOCKS_CACHE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "ClockEvictionList.h"
+#include "ObfRoutingSectionReader.h"
+#include "ObfRoutingSectionReader_Metrics.h"
+
+namespace OsmAnd
+{
+    class BudgetedRoutingDataBlocksCache;
+    class BudgetedRoutingDataBlocksCache_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(BudgetedRoutingDataBlocksCache_P);
+
+    public:
+        // Number of consecutive route points covered by single pinned area
+        static const int RoutePointsPerPinnedArea;
+
+    private:
+        struct ResidentBlock
+        {
+            // Reference owned by cache itself
+            std::shared_ptr<const ObfRoutingSectionReader::DataBlock> dataBlock;
+            size_t memoryUsage;
+            // CLOCK reference bit, block gets a second chance if it was used since hand passed it last time
+            bool recentlyUsed;
+            bool pinned;
+        };
+
+        mutable QMutex _residentBlocksMutex;
+        QHash<uint64_t, ResidentBlock> _residentBlocks;
+        ClockEvictionList<uint64_t> _clock;
+        size_t _residentMemoryUsage;
+        QList<AreaI> _pinnedAreas;
+        unsigned int _hits;
+        unsigned int _misses;
+        unsigned int _evictions;
+
+        bool isPinned(const AreaI& area31) const;
+        void evict(const uint64_t blockId);
+        void enforceBudget();
+    protected:
+        BudgetedRoutingDataBlocksCache_P(BudgetedRoutingDataBlocksCache* const owner);
+
+        void onBlockObtained(const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& dataBlock, const bool wasRead);
+
+        void pinAreas(const QList<AreaI>& areas31);
+        void pinRoute(const QVector<PointI>& points31, const double corridorInMeters);
+        void unpinAll();
+
+        void evictUnpinned();
+
+        void obtainMetric(ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache& outMetric) const;
+    public:
+        ~BudgetedRoutingDataBlocksCache_P();
+
+        ImplementationInterface<BudgetedRoutingDataBlocksCache> owner;
+
+    friend class OsmAnd::BudgetedRoutingDataBlocksCache;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_BUDGETED_ROUTING_DATA_BLOCKS_CACHE_P_H_)
@@ -13,7 +13,7 @@ OsmAnd::ObfAddressSectionReader::~ObfAddressSectionReader()
 }
 
 void OsmAnd::ObfAddressSectionReader::loadStreetGroups(
-    const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const ObfAddressSectionInfo>& section,
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const ObfAddressSectionInfo>& section,
     QList< std::shared_ptr<const StreetGroup> >* resultOut /*= nullptr*/,
     std::function<bool (const std::shared_ptr<const OsmAnd::StreetGroup>&)> visitor /*= nullptr*/,
     const IQueryController* const controller /*= nullptr*/, QSet<ObfAddressBlockType>* blockTypeFilter /*= nullptr*/ )
@@ -22,7 +22,7 @@ void OsmAnd::ObfAddressSectionReader::loadStreetGroups(
 }
 
 void OsmAnd::ObfAddressSectionReader::loadStreetsFromGroup(
-    const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const StreetGroup>& group,
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const StreetGroup>& group,
     QList< std::shared_ptr<const Street> >* resultOut /*= nullptr*/,
     std::function<bool (const std::shared_ptr<const OsmAnd::Street>&)> visitor /*= nullptr*/, const IQueryController* const controller /*= nullptr*/ )
 {
@@ -30,7 +30,7 @@ void OsmAnd::ObfAddressSectionReader::loadStreetsFromGroup(
 }
 
 void OsmAnd::ObfAddressSectionReader::loadBuildingsFromStreet(
-    const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const Street>& street,
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const Street>& street,
     QList< std::shared_ptr<const Building> >* resultOut /*= nullptr*/,
     std::function<bool (const std::shared_ptr<const OsmAnd::Building>&)> visitor /*= nullptr*/, const IQueryController* const controller /*= nullptr*/ )
 {
@@ -38,7 +38,7 @@ void OsmAnd::ObfAddressSectionReader::loadBuildingsFromStreet(
 }
 
 void OsmAnd::ObfAddressSectionReader::loadIntersectionsFromStreet(
-    const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const Street>& street,
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const Street>& street,
     QList< std::shared_ptr<const StreetIntersection> >* resultOut /*= nullptr*/,
     std::function<bool (const std::shared_ptr<const OsmAnd::StreetIntersection>&)> visitor /*= nullptr*/, const IQueryController* const controller /*= nullptr*/ )
 {
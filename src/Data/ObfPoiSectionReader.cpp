@@ -12,17 +12,51 @@ OsmAnd::ObfPoiSectionReader::~ObfPoiSectionReader()
 }
 
 void OsmAnd::ObfPoiSectionReader::loadCategories(
-    const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
     QList< std::shared_ptr<const AmenityCategory> >& categories)
 {
     ObfPoiSectionReader_P::loadCategories(*reader->_p, section, categories);
 }
 
 void OsmAnd::ObfPoiSectionReader::loadAmenities(
-    const std::shared_ptr<ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
     const ZoomLevel zoom, uint32_t zoomDepth /*= 3*/, const AreaI* bbox31 /*= nullptr*/, QSet<uint32_t>* desiredCategories /*= nullptr*/,
     QList< std::shared_ptr<const Amenity> >* amenitiesOut /*= nullptr*/,
     std::function<bool(std::shared_ptr<const Amenity>)> visitor /*= nullptr*/, const IQueryController* const controller /*= nullptr*/)
 {
     ObfPoiSectionReader_P::loadAmenities(*reader->_p, section, zoom, zoomDepth, bbox31, desiredCategories, amenitiesOut, visitor, controller);
 }
+
+void OsmAnd::ObfPoiSectionReader::searchAmenitiesByName(
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+    const QString& namePrefix,
+    const AreaI* bbox31 /*= nullptr*/, QSet<uint32_t>* desiredCategories /*= nullptr*/,
+    QList< std::shared_ptr<const Amenity> >* amenitiesOut /*= nullptr*/,
+    std::function<bool(std::shared_ptr<const Amenity>)> visitor /*= nullptr*/, const IQueryController* const controller /*= nullptr*/)
+{
+    ObfPoiSectionReader_P::searchAmenitiesByName(*reader->_p, section, namePrefix, bbox31, desiredCategories, amenitiesOut, visitor, controller);
+}
+
+void OsmAnd::ObfPoiSectionReader::findNearestAmenities(
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+    const PointI& position31,
+    const unsigned int count,
+    QSet<uint32_t>* desiredCategories,
+    QList< std::shared_ptr<const Amenity> >& outAmenities,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    QVector< QList< std::shared_ptr<const Amenity> > > amenities;
+    ObfPoiSectionReader_P::findNearestAmenities(*reader->_p, section, QVector<PointI>() << position31, count, desiredCategories, amenities, controller);
+    outAmenities = amenities.first();
+}
+
+void OsmAnd::ObfPoiSectionReader::findNearestAmenities(
+    const std::shared_ptr<const ObfReader>& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+    const QVector<PointI>& positions31,
+    const unsigned int count,
+    QSet<uint32_t>* desiredCategories,
+    QVector< QList< std::shared_ptr<const Amenity> > >& outAmenities,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    ObfPoiSectionReader_P::findNearestAmenities(*reader->_p, section, positions31, count, desiredCategories, outAmenities, controller);
+}
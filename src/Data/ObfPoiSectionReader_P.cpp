@@ -1,6 +1,12 @@
 #include "ObfPoiSectionReader_P.h"
 
+#include "stdlib_common.h"
+#include <queue>
+#include <vector>
+
+#include "QtExtensions.h"
 #include "ignore_warnings_on_external_includes.h"
+#include <QRegExp>
 #include "OBF.pb.h"
 #include <google/protobuf/wire_format_lite.h>
 #include "restore_internal_warnings.h"
@@ -12,6 +18,7 @@
 #include "ObfReaderUtilities.h"
 #include "IQueryController.h"
 #include "ICU.h"
+#include "BaseSearchEngine.h"
 #include "Utilities.h"
 
 OsmAnd::ObfPoiSectionReader_P::ObfPoiSectionReader_P()
@@ -206,7 +213,8 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenities(
     QList< std::shared_ptr<const Amenity> >* amenitiesOut,
     const ZoomLevel zoom, uint32_t zoomDepth, const AreaI* bbox31,
     std::function<bool (std::shared_ptr<const Amenity>)> visitor,
-    const IQueryController* const controller)
+    const IQueryController* const controller,
+    const QString* const namePrefix /*= nullptr*/)
 {
     const auto cis = reader.getCodedInputStream().get();
     QList< std::shared_ptr<Tile> > tiles;
@@ -249,7 +257,7 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenities(
                     const auto offset = cis->CurrentPosition();
                     const auto oldLimit = cis->PushLimit(length);
 
-                    readAmenitiesFromTile(reader, section, tile.get(), desiredCategories, amenitiesOut, zoom, zoomDepth, bbox31, visitor, controller, nullptr);
+                    readAmenitiesFromTile(reader, section, tile.get(), desiredCategories, amenitiesOut, zoom, zoomDepth, bbox31, visitor, controller, nullptr, namePrefix);
 
                     ObfReaderUtilities::ensureAllDataWasRead(cis);
                     cis->PopLimit(oldLimit);
@@ -459,7 +467,8 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenitiesFromTile(
     const ZoomLevel zoom, uint32_t zoomDepth, const AreaI* bbox31,
     std::function<bool (std::shared_ptr<const Amenity>)> visitor,
     const IQueryController* const controller,
-    QSet< uint64_t >* amenitiesToSkip)
+    QSet< uint64_t >* amenitiesToSkip,
+    const QString* const namePrefix /*= nullptr*/)
 {
     const auto cis = reader.getCodedInputStream().get();
 
@@ -513,7 +522,7 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenitiesFromTile(
                 const auto oldLimit = cis->PushLimit(length);
 
                 std::shared_ptr<const Amenity> amenity;
-                readAmenity(reader, section, pTile, zoomTile, amenity, desiredCategories, bbox31, controller);
+                readAmenity(reader, section, pTile, zoomTile, amenity, desiredCategories, bbox31, controller, namePrefix);
 
                 ObfReaderUtilities::ensureAllDataWasRead(cis);
                 cis->PopLimit(oldLimit);
@@ -560,7 +569,8 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenity(
     std::shared_ptr<const Amenity>& outAmenity,
     QSet<uint32_t>* desiredCategories,
     const AreaI* bbox31,
-    const IQueryController* const controller)
+    const IQueryController* const controller,
+    const QString* const namePrefix /*= nullptr*/)
 {
     const auto cis = reader.getCodedInputStream().get();
     PointI point;
@@ -579,6 +589,20 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenity(
             if (!ObfReaderUtilities::reachedDataEnd(cis))
                 return;
 
+            if (namePrefix)
+            {
+                // Transliteration is costly, so it's performed only if native and latin names don't match
+                auto nameMatches =
+                    nameHasWordWithPrefix(amenity->_name, *namePrefix) ||
+                    nameHasWordWithPrefix(amenity->_latinName, *namePrefix);
+                if (!nameMatches && amenity->_latinName.isEmpty())
+                {
+                    amenity->_latinName = ICU::transliterateToLatin(amenity->_name);
+                    nameMatches = nameHasWordWithPrefix(amenity->_latinName, *namePrefix);
+                }
+                if (!nameMatches)
+                    return;
+            }
             if (amenity->_latinName.isEmpty())
                 amenity->_latinName = ICU::transliterateToLatin(amenity->_name);
             amenity->_point31 = point;
@@ -608,7 +632,7 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenity(
                 {
                     const uint32_t allSubsId = (catId << 16) | 0xFFFF;
                     const uint32_t mixedId = (catId << 16) | subId;
-                    if (desiredCategories->contains(allSubsId) || desiredCategories->contains(mixedId))
+                    if (!desiredCategories->contains(allSubsId) && !desiredCategories->contains(mixedId))
                     {
                         cis->Skip(cis->BytesUntilLimit());
                         return;
@@ -645,4 +669,671 @@ void OsmAnd::ObfPoiSectionReader_P::readAmenity(
             break;
         }
     }
-}
\ No newline at end of file
+}
+QString OsmAnd::ObfPoiSectionReader_P::normalizeName(const QString& name)
+{
+    return ICU::stripAccentsAndDiacritics(name).toLower();
+}
+
+bool OsmAnd::ObfPoiSectionReader_P::nameHasWordWithPrefix(const QString& name, const QString& normalizedPrefix)
+{
+    // Same matching as search engines use later on, so an amenity accepted here is never rejected there
+    return BaseSearchEngine::match(normalizedPrefix, name);
+}
+
+void OsmAnd::ObfPoiSectionReader_P::readNameIndex(
+    const ObfReader_P& reader,
+    const QString& normalizedPrefix,
+    const AreaI* bbox31,
+    QSet<uint32_t>& outTilesOffsets,
+    const IQueryController* const controller)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    for(;;)
+    {
+        if (controller && controller->isAborted())
+            return;
+
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return;
+
+            return;
+        case OBF::OsmAndPoiNameIndex::kTableFieldNumber:
+            {
+                const auto length = gpb::internal::WireFormatLite::GetTagWireType(tag) == gpb::internal::WireFormatLite::WIRETYPE_FIXED32_LENGTH_DELIMITED
+                    ? ObfReaderUtilities::readBigEndianInt(cis)
+                    : ObfReaderUtilities::readLength(cis);
+                const auto tableOffset = cis->CurrentPosition();
+                auto oldLimit = cis->PushLimit(length);
+
+                QList<uint32_t> fullMatchesOffsets;
+                QList<uint32_t> partialMatchesOffsets;
+                int partialMatchLength = -1;
+                readNameIndexTable(reader, normalizedPrefix, QString(), fullMatchesOffsets, partialMatchesOffsets, partialMatchLength);
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+
+                // If no key starts with the prefix, the longest key that is a prefix of it is used:
+                // its data is a superset of what's needed, and amenities are filtered by name later
+                auto dataOffsets = (fullMatchesOffsets.isEmpty() ? partialMatchesOffsets : fullMatchesOffsets).toSet().toList();
+                qSort(dataOffsets);
+
+                // Offsets of data are relative to the beginning of the table
+                for (const auto dataOffset : constOf(dataOffsets))
+                {
+                    if (controller && controller->isAborted())
+                        return;
+
+                    cis->Seek(tableOffset + dataOffset);
+                    const auto dataLength = ObfReaderUtilities::readLength(cis);
+                    oldLimit = cis->PushLimit(dataLength);
+
+                    readNameIndexData(reader, bbox31, outTilesOffsets);
+
+                    ObfReaderUtilities::ensureAllDataWasRead(cis);
+                    cis->PopLimit(oldLimit);
+                }
+                cis->Skip(cis->BytesUntilLimit());
+            }
+            return;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfPoiSectionReader_P::readNameIndexTable(
+    const ObfReader_P& reader,
+    const QString& normalizedPrefix,
+    const QString& keyPrefix,
+    QList<uint32_t>& outFullMatchesOffsets,
+    QList<uint32_t>& outPartialMatchesOffsets,
+    int& outPartialMatchLength)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    QString key;
+    bool keyFullyMatches = false;
+    bool keyPartiallyMatches = false;
+    for(;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return;
+
+            return;
+        case OBF::IndexedStringTable::kKeyFieldNumber:
+            {
+                ObfReaderUtilities::readQString(cis, key);
+                key.prepend(keyPrefix);
+
+                // Key either starts with the prefix, or is itself a prefix of it (and then only the longest one counts)
+                const auto normalizedKey = normalizeName(key);
+                keyFullyMatches = normalizedKey.startsWith(normalizedPrefix);
+                keyPartiallyMatches = !keyFullyMatches && normalizedPrefix.startsWith(normalizedKey);
+                if (keyPartiallyMatches && normalizedKey.length() > outPartialMatchLength)
+                {
+                    outPartialMatchesOffsets.clear();
+                    outPartialMatchLength = normalizedKey.length();
+                }
+                else if (keyPartiallyMatches && normalizedKey.length() < outPartialMatchLength)
+                {
+                    keyPartiallyMatches = false;
+                }
+            }
+            break;
+        case OBF::IndexedStringTable::kValFieldNumber:
+            {
+                const auto value = ObfReaderUtilities::readBigEndianInt(cis);
+                if (keyFullyMatches)
+                    outFullMatchesOffsets.push_back(value);
+                else if (keyPartiallyMatches)
+                    outPartialMatchesOffsets.push_back(value);
+            }
+            break;
+        case OBF::IndexedStringTable::kSubtablesFieldNumber:
+            {
+                const auto length = gpb::internal::WireFormatLite::GetTagWireType(tag) == gpb::internal::WireFormatLite::WIRETYPE_FIXED32_LENGTH_DELIMITED
+                    ? ObfReaderUtilities::readBigEndianInt(cis)
+                    : ObfReaderUtilities::readLength(cis);
+                const auto oldLimit = cis->PushLimit(length);
+
+                // Subtable holds continuations of the key, so it's interesting only if the prefix is longer than key
+                if (keyPartiallyMatches)
+                    readNameIndexTable(reader, normalizedPrefix, key, outFullMatchesOffsets, outPartialMatchesOffsets, outPartialMatchLength);
+                else
+                    cis->Skip(cis->BytesUntilLimit());
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfPoiSectionReader_P::readNameIndexData(
+    const ObfReader_P& reader,
+    const AreaI* bbox31,
+    QSet<uint32_t>& outTilesOffsets)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    for(;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return;
+
+            return;
+        case OBF::OsmAndPoiNameIndex_OsmAndPoiNameIndexData::kAtomsFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readLength(cis);
+                const auto oldLimit = cis->PushLimit(length);
+
+                readNameIndexDataAtom(reader, bbox31, outTilesOffsets);
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfPoiSectionReader_P::readNameIndexDataAtom(
+    const ObfReader_P& reader,
+    const AreaI* bbox31,
+    QSet<uint32_t>& outTilesOffsets)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    gpb::uint32 zoom = 0;
+    gpb::uint32 x = 0;
+    gpb::uint32 y = 0;
+    uint32_t tileOffset = 0;
+    for(;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return;
+
+            if (tileOffset == 0)
+                return;
+            if (bbox31 && zoom <= ZoomLevel31)
+            {
+                // Right and bottom edges of the last tile in a row are at 2^31, which doesn't fit into 31-bit coordinates
+                const auto shift = 31 - zoom;
+                const int64_t maxCoordinate31 = std::numeric_limits<int32_t>::max();
+                AreaI area31;
+                area31.left() = static_cast<int32_t>(qMin(static_cast<int64_t>(x) << shift, maxCoordinate31));
+                area31.right() = static_cast<int32_t>(qMin(static_cast<int64_t>(x + 1) << shift, maxCoordinate31));
+                area31.top() = static_cast<int32_t>(qMin(static_cast<int64_t>(y) << shift, maxCoordinate31));
+                area31.bottom() = static_cast<int32_t>(qMin(static_cast<int64_t>(y + 1) << shift, maxCoordinate31));
+                if (!bbox31->contains(area31) && !area31.contains(*bbox31) && !bbox31->intersects(area31))
+                    return;
+            }
+            outTilesOffsets.insert(tileOffset);
+            return;
+        case OBF::OsmAndPoiNameIndexDataAtom::kZoomFieldNumber:
+            cis->ReadVarint32(&zoom);
+            break;
+        case OBF::OsmAndPoiNameIndexDataAtom::kXFieldNumber:
+            cis->ReadVarint32(&x);
+            break;
+        case OBF::OsmAndPoiNameIndexDataAtom::kYFieldNumber:
+            cis->ReadVarint32(&y);
+            break;
+        case OBF::OsmAndPoiNameIndexDataAtom::kShiftToFieldNumber:
+            tileOffset = ObfReaderUtilities::readBigEndianInt(cis);
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfPoiSectionReader_P::searchAmenitiesByName(
+    const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
+    const QString& namePrefix,
+    const AreaI* bbox31 /*= nullptr*/,
+    QSet<uint32_t>* desiredCategories /*= nullptr*/,
+    QList< std::shared_ptr<const Amenity> >* amenitiesOut /*= nullptr*/,
+    std::function<bool (std::shared_ptr<const Amenity>)> visitor /*= nullptr*/,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    const auto normalizedPrefix = normalizeName(namePrefix.trimmed());
+    if (normalizedPrefix.isEmpty())
+        return;
+
+    // Index is built over separate words, so only the first word of the prefix is looked up there
+    const auto indexKey = normalizedPrefix.split(QRegExp(QLatin1String("\\s+")), QString::SkipEmptyParts).first();
+
+    const auto cis = reader.getCodedInputStream().get();
+    cis->Seek(section->offset);
+    auto oldLimit = cis->PushLimit(section->length);
+
+    QSet<uint32_t> tilesOffsets;
+    bool nameIndexRead = false;
+    bool nameIndexPresent = false;
+    while (!nameIndexRead)
+    {
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            nameIndexRead = true;
+            break;
+        case OBF::OsmAndPoiIndex::kNameIndexFieldNumber:
+            {
+                const auto length = gpb::internal::WireFormatLite::GetTagWireType(tag) == gpb::internal::WireFormatLite::WIRETYPE_FIXED32_LENGTH_DELIMITED
+                    ? ObfReaderUtilities::readBigEndianInt(cis)
+                    : ObfReaderUtilities::readLength(cis);
+                const auto nameIndexLimit = cis->PushLimit(length);
+
+                readNameIndex(reader, indexKey, bbox31, tilesOffsets, controller);
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(nameIndexLimit);
+                nameIndexRead = true;
+                nameIndexPresent = true;
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+
+    // Sections written without name index are scanned completely, filtering amenities by name the same way
+    if (!nameIndexPresent)
+    {
+        cis->Seek(section->offset);
+        readAmenities(reader, section, desiredCategories, amenitiesOut, ZoomLevel28, 3, bbox31, visitor, controller, &normalizedPrefix);
+
+        ObfReaderUtilities::ensureAllDataWasRead(cis);
+        cis->PopLimit(oldLimit);
+        return;
+    }
+
+    // Read only tiles referenced from the name index, in order of their location in file
+    auto sortedTilesOffsets = tilesOffsets.toList();
+    qSort(sortedTilesOffsets);
+    for (const auto tileOffset : constOf(sortedTilesOffsets))
+    {
+        if (controller && controller->isAborted())
+            break;
+
+        cis->Seek(section->offset + tileOffset);
+        const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+        const auto tileLimit = cis->PushLimit(length);
+
+        readAmenitiesFromTile(reader, section, nullptr, desiredCategories, amenitiesOut, ZoomLevel28, 3, bbox31, visitor, controller, nullptr, &normalizedPrefix);
+
+        ObfReaderUtilities::ensureAllDataWasRead(cis);
+        cis->PopLimit(tileLimit);
+    }
+
+    cis->Skip(cis->BytesUntilLimit());
+    cis->PopLimit(oldLimit);
+}
+
+bool OsmAnd::ObfPoiSectionReader_P::readNearestAmenitiesBox(
+    const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
+    const NearestAmenitiesBox* parent,
+    QSet<uint32_t>* desiredCategories,
+    NearestAmenitiesBox& outBox)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    outBox.zoom = 0;
+    outBox.x = 0;
+    outBox.y = 0;
+    outBox.containsDesired = true;
+    outBox.dataOffset = -1;
+    outBox.subBoxesParsed = false;
+    outBox.dataDecoded = false;
+    gpb::uint32 lzoom = 0;
+
+    for(;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            return ObfReaderUtilities::reachedDataEnd(cis);
+        case OBF::OsmAndPoiBox::kZoomFieldNumber:
+            cis->ReadVarint32(&lzoom);
+            outBox.zoom = parent ? parent->zoom + lzoom : lzoom;
+            break;
+        case OBF::OsmAndPoiBox::kLeftFieldNumber:
+            {
+                const auto x = ObfReaderUtilities::readSInt32(cis);
+                outBox.x = parent ? x + (parent->x << lzoom) : x;
+            }
+            break;
+        case OBF::OsmAndPoiBox::kTopFieldNumber:
+            {
+                const auto y = ObfReaderUtilities::readSInt32(cis);
+                outBox.y = parent ? y + (parent->y << lzoom) : y;
+            }
+            break;
+        case OBF::OsmAndPoiBox::kCategoriesFieldNumber:
+            {
+                if (!desiredCategories)
+                {
+                    ObfReaderUtilities::skipUnknownField(cis, tag);
+                    break;
+                }
+                gpb::uint32 length;
+                cis->ReadLittleEndian32(&length);
+                const auto oldLimit = cis->PushLimit(length);
+
+                outBox.containsDesired = checkTileCategories(reader, section, desiredCategories);
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+
+                // Nothing of this box will be used, so there's no need to read the rest of it
+                if (!outBox.containsDesired)
+                {
+                    cis->Skip(cis->BytesUntilLimit());
+                    return true;
+                }
+            }
+            break;
+        case OBF::OsmAndPoiBox::kSubBoxesFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+                const auto offset = cis->CurrentPosition();
+                outBox.subBoxesRefs.push_back(qMakePair(static_cast<uint32_t>(offset), length));
+                cis->Skip(length);
+            }
+            break;
+        case OBF::OsmAndPoiBox::kShiftToDataFieldNumber:
+            outBox.dataOffset = ObfReaderUtilities::readBigEndianInt(cis);
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfPoiSectionReader_P::readNearestAmenitiesBoxData(
+    const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
+    QSet<uint32_t>* desiredCategories,
+    NearestAmenitiesBox& box,
+    const IQueryController* const controller)
+{
+    const auto cis = reader.getCodedInputStream().get();
+    box.dataDecoded = true;
+
+    cis->Seek(section->offset + box.dataOffset);
+    const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+    const auto oldLimit = cis->PushLimit(length);
+
+    // Unlike readAmenitiesFromTile(), every amenity of desired categories is kept, since the nearest
+    // ones may be close to each other
+    PointI pTile;
+    uint32_t zoomTile = 0;
+    auto dataRead = false;
+    while (!dataRead)
+    {
+        if (controller && controller->isAborted())
+            break;
+
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            dataRead = true;
+            break;
+        case OBF::OsmAndPoiBoxData::kZoomFieldNumber:
+            {
+                gpb::uint32 value;
+                cis->ReadVarint32(&value);
+                zoomTile = value;
+            }
+            break;
+        case OBF::OsmAndPoiBoxData::kXFieldNumber:
+            {
+                gpb::uint32 value;
+                cis->ReadVarint32(&value);
+                pTile.x = value;
+            }
+            break;
+        case OBF::OsmAndPoiBoxData::kYFieldNumber:
+            {
+                gpb::uint32 value;
+                cis->ReadVarint32(&value);
+                pTile.y = value;
+            }
+            break;
+        case OBF::OsmAndPoiBoxData::kPoiDataFieldNumber:
+            {
+                gpb::uint32 length;
+                cis->ReadVarint32(&length);
+                const auto amenityLimit = cis->PushLimit(length);
+
+                std::shared_ptr<const Amenity> amenity;
+                readAmenity(reader, section, pTile, zoomTile, amenity, desiredCategories, nullptr, controller);
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(amenityLimit);
+
+                if (amenity)
+                    box.amenities.push_back(qMove(amenity));
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+
+    cis->Skip(cis->BytesUntilLimit());
+    cis->PopLimit(oldLimit);
+}
+
+uint64_t OsmAnd::ObfPoiSectionReader_P::squareDistance31ToBox(const PointI& position31, const NearestAmenitiesBox& box)
+{
+    // Computed in 64 bits, since right and bottom edges of boxes on zoom 0 don't fit in 31 bits
+    const auto shift = 31 - box.zoom;
+    const auto left = static_cast<int64_t>(box.x) << shift;
+    const auto right = (static_cast<int64_t>(box.x + 1) << shift) - 1;
+    const auto top = static_cast<int64_t>(box.y) << shift;
+    const auto bottom = (static_cast<int64_t>(box.y + 1) << shift) - 1;
+
+    const auto dx = qMax<int64_t>(0, qMax(left - position31.x, position31.x - right));
+    const auto dy = qMax<int64_t>(0, qMax(top - position31.y, position31.y - bottom));
+    return static_cast<uint64_t>(dx * dx) + static_cast<uint64_t>(dy * dy);
+}
+
+void OsmAnd::ObfPoiSectionReader_P::findNearestAmenities(
+    const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
+    const QVector<PointI>& positions31,
+    const unsigned int count,
+    QSet<uint32_t>* desiredCategories,
+    QVector< QList< std::shared_ptr<const Amenity> > >& outAmenities,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    outAmenities.clear();
+    outAmenities.resize(positions31.size());
+    if (count == 0 || positions31.isEmpty())
+        return;
+
+    const auto cis = reader.getCodedInputStream().get();
+    cis->Seek(section->offset);
+    auto oldLimit = cis->PushLimit(section->length);
+
+    // Boxes and amenities decoded from them are shared by all positions, so each of them is read at most once
+    QVector<NearestAmenitiesBox> boxes;
+    QVector<int> rootBoxes;
+    auto boxesRead = false;
+    while (!boxesRead)
+    {
+        const auto tag = cis->ReadTag();
+        switch(gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            boxesRead = true;
+            break;
+        case OBF::OsmAndPoiIndex::kBoxesFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+                const auto boxLimit = cis->PushLimit(length);
+
+                NearestAmenitiesBox box;
+                const auto boxRead = readNearestAmenitiesBox(reader, section, nullptr, desiredCategories, box);
+
+                cis->Skip(cis->BytesUntilLimit());
+                cis->PopLimit(boxLimit);
+
+                if (boxRead && box.containsDesired)
+                {
+                    rootBoxes.push_back(boxes.size());
+                    boxes.push_back(qMove(box));
+                }
+            }
+            break;
+        case OBF::OsmAndPoiIndex::kPoiDataFieldNumber:
+            // All boxes precede tiles data
+            boxesRead = true;
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+
+    // Queue holds boxes keyed by distance to their area, which is a lower bound of distance to any amenity
+    // inside them, and amenities keyed by exact distance. Once amenity is on top of the queue, nothing
+    // else can be closer.
+    enum class EntryType
+    {
+        Amenity,
+        BoxData,
+        Box,
+    };
+    struct Entry
+    {
+        uint64_t squareDistance;
+        EntryType type;
+        int boxIndex;
+        int amenityIndex;
+
+        bool operator>(const Entry& that) const
+        {
+            if (squareDistance != that.squareDistance)
+                return squareDistance > that.squareDistance;
+            return type > that.type;
+        }
+    };
+
+    for (auto positionIdx = 0; positionIdx < positions31.size(); positionIdx++)
+    {
+        if (controller && controller->isAborted())
+            break;
+
+        const auto& position31 = positions31[positionIdx];
+        auto& amenities = outAmenities[positionIdx];
+
+        std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > queue;
+        for (const auto boxIdx : constOf(rootBoxes))
+            queue.push({ squareDistance31ToBox(position31, boxes[boxIdx]), EntryType::Box, boxIdx, -1 });
+
+        while (!queue.empty() && amenities.size() < static_cast<int>(count))
+        {
+            if (controller && controller->isAborted())
+                break;
+
+            const auto entry = queue.top();
+            queue.pop();
+
+            switch (entry.type)
+            {
+            case EntryType::Amenity:
+                amenities.push_back(boxes[entry.boxIndex].amenities[entry.amenityIndex]);
+                break;
+            case EntryType::BoxData:
+                {
+                    auto& box = boxes[entry.boxIndex];
+                    if (!box.dataDecoded)
+                        readNearestAmenitiesBoxData(reader, section, desiredCategories, box, controller);
+
+                    for (auto amenityIdx = 0; amenityIdx < box.amenities.size(); amenityIdx++)
+                    {
+                        const auto& point31 = box.amenities[amenityIdx]->point31;
+                        const auto dx = static_cast<int64_t>(point31.x) - position31.x;
+                        const auto dy = static_cast<int64_t>(point31.y) - position31.y;
+                        const auto squareDistance = static_cast<uint64_t>(dx * dx) + static_cast<uint64_t>(dy * dy);
+                        queue.push({ squareDistance, EntryType::Amenity, entry.boxIndex, amenityIdx });
+                    }
+                }
+                break;
+            case EntryType::Box:
+                {
+                    if (!boxes[entry.boxIndex].subBoxesParsed)
+                    {
+                        const auto parent = boxes[entry.boxIndex];
+                        QVector<NearestAmenitiesBox> subBoxes;
+                        for (const auto& subBoxRef : constOf(parent.subBoxesRefs))
+                        {
+                            cis->Seek(subBoxRef.first);
+                            const auto subBoxLimit = cis->PushLimit(subBoxRef.second);
+
+                            NearestAmenitiesBox subBox;
+                            const auto subBoxRead = readNearestAmenitiesBox(reader, section, &parent, desiredCategories, subBox);
+
+                            cis->Skip(cis->BytesUntilLimit());
+                            cis->PopLimit(subBoxLimit);
+
+                            if (subBoxRead && subBox.containsDesired)
+                                subBoxes.push_back(qMove(subBox));
+                        }
+
+                        auto& box = boxes[entry.boxIndex];
+                        box.subBoxesParsed = true;
+                        for (auto subBoxIdx = 0; subBoxIdx < subBoxes.size(); subBoxIdx++)
+                            box.subBoxes.push_back(boxes.size() + subBoxIdx);
+                        boxes += subBoxes;
+                    }
+
+                    const auto& box = boxes[entry.boxIndex];
+                    if (box.dataOffset >= 0)
+                        queue.push({ entry.squareDistance, EntryType::BoxData, entry.boxIndex, -1 });
+                    for (const auto subBoxIdx : constOf(box.subBoxes))
+                        queue.push({ squareDistance31ToBox(position31, boxes[subBoxIdx]), EntryType::Box, subBoxIdx, -1 });
+                }
+                break;
+            }
+        }
+    }
+
+    cis->Skip(cis->BytesUntilLimit());
+    cis->PopLimit(oldLimit);
+}
@@ -5,6 +5,10 @@
 #include <functional>
 
 #include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
@@ -39,7 +43,8 @@ namespace OsmAnd
             QList< std::shared_ptr<const Amenity>  >* amenitiesOut,
             const ZoomLevel zoom, uint32_t zoomDepth, const AreaI* bbox31,
             std::function<bool(std::shared_ptr<const Amenity> )> visitor,
-            const IQueryController* const controller);
+            const IQueryController* const controller,
+            const QString* const namePrefix = nullptr);
 
         struct Tile
         {
@@ -64,12 +69,60 @@ namespace OsmAnd
             const ZoomLevel zoom, uint32_t zoomDepth, const AreaI* bbox31,
             std::function<bool(std::shared_ptr<const Amenity> )> visitor,
             const IQueryController* const controller,
-            QSet< uint64_t >* amenitiesToSkip);
+            QSet< uint64_t >* amenitiesToSkip,
+            const QString* const namePrefix = nullptr);
         static void readAmenity(const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
             const PointI& pTile, uint32_t pzoom, std::shared_ptr<const Amenity> & amenity,
             QSet<uint32_t>* desiredCategories,
             const AreaI* bbox31,
+            const IQueryController* const controller,
+            const QString* const namePrefix = nullptr);
+
+        static QString normalizeName(const QString& name);
+        static bool nameHasWordWithPrefix(const QString& name, const QString& normalizedPrefix);
+        static void readNameIndex(const ObfReader_P& reader,
+            const QString& normalizedPrefix,
+            const AreaI* bbox31,
+            QSet<uint32_t>& outTilesOffsets,
+            const IQueryController* const controller);
+        static void readNameIndexTable(const ObfReader_P& reader,
+            const QString& normalizedPrefix,
+            const QString& keyPrefix,
+            QList<uint32_t>& outFullMatchesOffsets,
+            QList<uint32_t>& outPartialMatchesOffsets,
+            int& outPartialMatchLength);
+        static void readNameIndexData(const ObfReader_P& reader,
+            const AreaI* bbox31,
+            QSet<uint32_t>& outTilesOffsets);
+        static void readNameIndexDataAtom(const ObfReader_P& reader,
+            const AreaI* bbox31,
+            QSet<uint32_t>& outTilesOffsets);
+
+        // Box of POI tiles hierarchy, as seen by nearest amenities search. Boxes are parsed without their
+        // subboxes, which are parsed only when the box is reached
+        struct NearestAmenitiesBox
+        {
+            uint32_t zoom;
+            uint32_t x;
+            uint32_t y;
+            bool containsDesired;
+            int32_t dataOffset;
+            QVector< QPair<uint32_t, uint32_t> > subBoxesRefs;
+
+            bool subBoxesParsed;
+            QVector<int> subBoxes;
+            bool dataDecoded;
+            QList< std::shared_ptr<const Amenity> > amenities;
+        };
+        static bool readNearestAmenitiesBox(const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
+            const NearestAmenitiesBox* parent,
+            QSet<uint32_t>* desiredCategories,
+            NearestAmenitiesBox& outBox);
+        static void readNearestAmenitiesBoxData(const ObfReader_P& reader, const std::shared_ptr<const ObfPoiSectionInfo>& section,
+            QSet<uint32_t>* desiredCategories,
+            NearestAmenitiesBox& box,
             const IQueryController* const controller);
+        static uint64_t squareDistance31ToBox(const PointI& position31, const NearestAmenitiesBox& box);
 
         static void loadCategories(const ObfReader_P& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
             QList< std::shared_ptr<const AmenityCategory> >& categories);
@@ -81,6 +134,21 @@ namespace OsmAnd
             std::function<bool(std::shared_ptr<const Amenity> )> visitor = nullptr,
             const IQueryController* const controller = nullptr);
 
+        static void searchAmenitiesByName(const ObfReader_P& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+            const QString& namePrefix,
+            const AreaI* bbox31 = nullptr,
+            QSet<uint32_t>* desiredCategories = nullptr,
+            QList< std::shared_ptr<const Amenity> >* amenitiesOut = nullptr,
+            std::function<bool(std::shared_ptr<const Amenity> )> visitor = nullptr,
+            const IQueryController* const controller = nullptr);
+
+        static void findNearestAmenities(const ObfReader_P& reader, const std::shared_ptr<const OsmAnd::ObfPoiSectionInfo>& section,
+            const QVector<PointI>& positions31,
+            const unsigned int count,
+            QSet<uint32_t>* desiredCategories,
+            QVector< QList< std::shared_ptr<const Amenity> > >& outAmenities,
+            const IQueryController* const controller = nullptr);
+
         friend class OsmAnd::ObfReader_P;
         friend class OsmAnd::ObfPoiSectionReader;
     };
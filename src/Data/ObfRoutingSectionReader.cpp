@@ -70,3 +70,9 @@ bool OsmAnd::ObfRoutingSectionReader::DataBlocksCache::shouldCacheBlock(
 {
     return true;
 }
+
+void OsmAnd::ObfRoutingSectionReader::DataBlocksCache::onBlockObtained(
+    const std::shared_ptr<const DataBlock>& dataBlock,
+    const bool wasRead)
+{
+}
@@ -30,3 +30,33 @@ QString OsmAnd::ObfRoutingSectionReader_Metrics::Metric_loadRoads::toString(cons
 
     return output;
 }
+
+OsmAnd::ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache::Metric_dataBlocksCache()
+{
+    reset();
+}
+
+OsmAnd::ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache::~Metric_dataBlocksCache()
+{
+}
+
+void OsmAnd::ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache::reset()
+{
+    OsmAnd__ObfRoutingSectionReader_Metrics__Metric_dataBlocksCache__FIELDS(RESET_METRIC_FIELD);
+
+    Metric::reset();
+}
+
+QString OsmAnd::ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache::toString(const bool shortFormat /*= false*/, const QString& prefix /*= QString::null*/) const
+{
+    QString output;
+
+    OsmAnd__ObfRoutingSectionReader_Metrics__Metric_dataBlocksCache__FIELDS(PRINT_METRIC_FIELD);
+
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("~hit-ratio = %1%")).arg(hits * 100.0f / static_cast<float>(qMax(hits + misses, 1u)));
+    const auto submetricsString = Metric::toString(shortFormat, prefix);
+    if (!submetricsString.isEmpty())
+        output += QLatin1String("\n") + Metric::toString(shortFormat, prefix);
+
+    return output;
+}
@@ -949,6 +949,7 @@ void OsmAnd::ObfRoutingSectionReader_P::loadRoads(
             // In case cache is provided, read and cache
 
             std::shared_ptr<const DataBlock> dataBlock;
+            bool wasRead = false;
             std::shared_ptr<const DataBlock> sharedBlockReference;
             proper::shared_future< std::shared_ptr<const DataBlock> > futureSharedBlockReference;
             if (cache->obtainReferenceOrFutureReferenceOrMakePromise(blockId, sharedBlockReference, futureSharedBlockReference))
@@ -1003,7 +1004,9 @@ void OsmAnd::ObfRoutingSectionReader_P::loadRoads(
                 // Create a data block and share it
                 dataBlock.reset(new DataBlock(blockId, dataLevel, treeNode->area31, roads));
                 cache->fulfilPromiseAndReference(blockId, dataBlock);
+                wasRead = true;
             }
+            cache->onBlockObtained(dataBlock, wasRead);
 
             if (outReferencedCacheEntries)
                 outReferencedCacheEntries->push_back(dataBlock);
@@ -2,6 +2,10 @@
 
 OsmAnd::ObfTransportSectionInfo::ObfTransportSectionInfo(const std::shared_ptr<const ObfInfo>& container)
     : ObfSectionInfo(container)
+    , _stopsOffset(0)
+    , _stopsLength(0)
+    , _stringTableOffset(0)
+    , _stringTableLength(0)
     , area24(_area24)
 {
 }
@@ -1,4 +1,7 @@
 #include "ObfTransportSectionReader.h"
+#include "ObfTransportSectionReader_P.h"
+
+#include "ObfReader.h"
 
 OsmAnd::ObfTransportSectionReader::ObfTransportSectionReader()
 {
@@ -7,3 +10,24 @@ OsmAnd::ObfTransportSectionReader::ObfTransportSectionReader()
 OsmAnd::ObfTransportSectionReader::~ObfTransportSectionReader()
 {
 }
+
+void OsmAnd::ObfTransportSectionReader::loadStops(
+    const std::shared_ptr<const ObfReader>& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const AreaI* const bbox31 /*= nullptr*/,
+    QList< std::shared_ptr<const OsmAnd::TransportStop> >* resultOut /*= nullptr*/,
+    const VisitorFunction visitor /*= nullptr*/,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    ObfTransportSectionReader_P::loadStops(*reader->_p, section, bbox31, resultOut, visitor, controller);
+}
+
+void OsmAnd::ObfTransportSectionReader::loadRoutes(
+    const std::shared_ptr<const ObfReader>& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const QList<uint32_t>& routesOffsets,
+    QList< std::shared_ptr<const OsmAnd::TransportRoute> >* resultOut /*= nullptr*/,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    ObfTransportSectionReader_P::loadRoutes(*reader->_p, section, routesOffsets, resultOut, controller);
+}
@@ -7,6 +7,9 @@
 
 #include "ObfReader_P.h"
 #include "ObfTransportSectionInfo.h"
+#include "TransportStop.h"
+#include "TransportRoute.h"
+#include "IQueryController.h"
 #include "ObfReaderUtilities.h"
 #include "Utilities.h"
 
@@ -52,19 +55,13 @@ void OsmAnd::ObfTransportSectionReader_P::read( const ObfReader_P& reader, const
             break;
         case OBF::OsmAndTransportIndex::kStringTableFieldNumber:
             {
+                // String table is read only when stops or routes are loaded, to save memory
                 gpb::uint32 length;
                 cis->ReadVarint32(&length);
-                auto offset = cis->CurrentPosition();
-                cis->Seek(offset + length);
+                section->_stringTableLength = length;
+                section->_stringTableOffset = cis->CurrentPosition();
+                cis->Seek(section->_stringTableOffset + section->_stringTableLength);
             }
-            //TODO:
-            /*IndexStringTable st = new IndexStringTable();
-            st.length = codedIS.readRawVarint32();
-            st.fileOffset = codedIS.getTotalBytesRead();
-            // Do not cache for now save memory
-            // readStringTable(st, 0, 20, true);
-            ind.stringTable = st;
-            codedIS.seek(st.length + st.fileOffset);*/
             break;
         default:
             ObfReaderUtilities::skipUnknownField(cis, tag);
@@ -105,3 +102,398 @@ void OsmAnd::ObfTransportSectionReader_P::readTransportStopsBounds( const ObfRea
         }
     }
 }
+
+void OsmAnd::ObfTransportSectionReader_P::readStringTable(
+    const ObfReader_P& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    QStringList& outStringTable)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    if (section->_stringTableLength == 0)
+        return;
+
+    cis->Seek(section->_stringTableOffset);
+    const auto oldLimit = cis->PushLimit(section->_stringTableLength);
+
+    ObfReaderUtilities::readStringTable(cis, outStringTable);
+
+    ObfReaderUtilities::ensureAllDataWasRead(cis);
+    cis->PopLimit(oldLimit);
+}
+
+OsmAnd::PointI OsmAnd::ObfTransportSectionReader_P::convertToPoint31(const PointI& point24)
+{
+    return PointI(point24.x << (31 - StopsZoom), point24.y << (31 - StopsZoom));
+}
+
+void OsmAnd::ObfTransportSectionReader_P::readStopsTree(
+    const ObfReader_P& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const AreaI& parentArea24,
+    const QStringList& stringTable,
+    const AreaI* const bbox31,
+    QList< std::shared_ptr<const TransportStop> >* resultOut,
+    const ObfTransportSectionReader::VisitorFunction visitor,
+    const IQueryController* const controller)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    // Bounds are stored relative to bounds of parent node, and ids of stops relative to base id that
+    // follows them, so stops of the node are published only once node is read completely
+    AreaI area24 = parentArea24;
+    bool boundsChecked = false;
+    QList< std::shared_ptr<TransportStop> > nodeStops;
+    uint64_t baseId = 0;
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        const auto fieldNumber = gpb::internal::WireFormatLite::GetTagFieldNumber(tag);
+
+        if (!boundsChecked &&
+            (fieldNumber == 0 || fieldNumber == OBF::TransportStopsTree::kSubtreesFieldNumber || fieldNumber == OBF::TransportStopsTree::kLeafsFieldNumber))
+        {
+            boundsChecked = true;
+
+            const AreaI area31(convertToPoint31(area24.topLeft), convertToPoint31(area24.bottomRight));
+            if (bbox31 && !bbox31->contains(area31) && !bbox31->intersects(area31))
+            {
+                cis->Skip(cis->BytesUntilLimit());
+                return;
+            }
+        }
+
+        switch (fieldNumber)
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return;
+
+            for (const auto& stop : constOf(nodeStops))
+            {
+                stop->id += baseId;
+
+                if (bbox31 && !bbox31->contains(stop->position31))
+                    continue;
+
+                if (!visitor || visitor(stop))
+                {
+                    if (resultOut)
+                        resultOut->push_back(stop);
+                }
+            }
+            return;
+        case OBF::TransportStopsTree::kLeftFieldNumber:
+            area24.left() = ObfReaderUtilities::readSInt32(cis) + parentArea24.left();
+            break;
+        case OBF::TransportStopsTree::kRightFieldNumber:
+            area24.right() = ObfReaderUtilities::readSInt32(cis) + parentArea24.right();
+            break;
+        case OBF::TransportStopsTree::kTopFieldNumber:
+            area24.top() = ObfReaderUtilities::readSInt32(cis) + parentArea24.top();
+            break;
+        case OBF::TransportStopsTree::kBottomFieldNumber:
+            area24.bottom() = ObfReaderUtilities::readSInt32(cis) + parentArea24.bottom();
+            break;
+        case OBF::TransportStopsTree::kSubtreesFieldNumber:
+            {
+                const auto length = ObfReaderUtilities::readBigEndianInt(cis);
+                const auto offset = cis->CurrentPosition();
+                const auto oldLimit = cis->PushLimit(length);
+
+                readStopsTree(reader, section, area24, stringTable, bbox31, resultOut, visitor, controller);
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+                cis->Seek(offset + length);
+
+                if (controller && controller->isAborted())
+                    return;
+            }
+            break;
+        case OBF::TransportStopsTree::kLeafsFieldNumber:
+            {
+                // Routes are referenced by stop relative to offset of stop itself
+                const auto stopOffset = cis->CurrentPosition();
+                gpb::uint32 length;
+                cis->ReadVarint32(&length);
+                const auto oldLimit = cis->PushLimit(length);
+
+                nodeStops.push_back(readStop(reader, section, stopOffset, area24, stringTable));
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+            }
+            break;
+        case OBF::TransportStopsTree::kBaseIdFieldNumber:
+            cis->ReadVarint64(reinterpret_cast<gpb::uint64*>(&baseId));
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+std::shared_ptr<OsmAnd::TransportStop> OsmAnd::ObfTransportSectionReader_P::readStop(
+    const ObfReader_P& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const uint32_t stopOffset,
+    const AreaI& area24,
+    const QStringList& stringTable)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    const std::shared_ptr<TransportStop> stop(new TransportStop(section));
+    PointI position24 = area24.topLeft;
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch (gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return stop;
+
+            stop->position31 = convertToPoint31(position24);
+            return stop;
+        case OBF::TransportStop::kDxFieldNumber:
+            position24.x = ObfReaderUtilities::readSInt32(cis) + area24.left();
+            break;
+        case OBF::TransportStop::kDyFieldNumber:
+            position24.y = ObfReaderUtilities::readSInt32(cis) + area24.top();
+            break;
+        case OBF::TransportStop::kIdFieldNumber:
+            stop->id = ObfReaderUtilities::readSInt64(cis);
+            break;
+        case OBF::TransportStop::kNameFieldNumber:
+            {
+                gpb::uint32 stringId;
+                cis->ReadVarint32(&stringId);
+                stop->name = stringTable.value(stringId);
+            }
+            break;
+        case OBF::TransportStop::kNameEnFieldNumber:
+            {
+                gpb::uint32 stringId;
+                cis->ReadVarint32(&stringId);
+                stop->latinName = stringTable.value(stringId);
+            }
+            break;
+        case OBF::TransportStop::kRoutesFieldNumber:
+            {
+                gpb::uint32 relativeOffset;
+                cis->ReadVarint32(&relativeOffset);
+                stop->routesOffsets.push_back(stopOffset - relativeOffset);
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+std::shared_ptr<OsmAnd::TransportRoute> OsmAnd::ObfTransportSectionReader_P::readRoute(
+    const ObfReader_P& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const uint32_t routeOffset,
+    const QStringList& stringTable)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    const std::shared_ptr<TransportRoute> route(new TransportRoute(section));
+    route->offset = routeOffset;
+
+    // Each stop is stored relative to previous one of the same direction
+    int64_t directStopId = 0;
+    PointI directStopPosition24;
+    int64_t reverseStopId = 0;
+    PointI reverseStopPosition24;
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch (gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return route;
+
+            return route;
+        case OBF::TransportRoute::kIdFieldNumber:
+            cis->ReadVarint64(reinterpret_cast<gpb::uint64*>(&route->id));
+            break;
+        case OBF::TransportRoute::kDistanceFieldNumber:
+            cis->ReadVarint32(&route->distance);
+            break;
+        case OBF::TransportRoute::kRefFieldNumber:
+            ObfReaderUtilities::readQString(cis, route->ref);
+            break;
+        case OBF::TransportRoute::kTypeFieldNumber:
+        case OBF::TransportRoute::kOperatorFieldNumber:
+        case OBF::TransportRoute::kNameFieldNumber:
+        case OBF::TransportRoute::kNameEnFieldNumber:
+            {
+                gpb::uint32 stringId;
+                cis->ReadVarint32(&stringId);
+                const auto value = stringTable.value(stringId);
+
+                const auto fieldNumber = gpb::internal::WireFormatLite::GetTagFieldNumber(tag);
+                if (fieldNumber == OBF::TransportRoute::kTypeFieldNumber)
+                    route->type = value;
+                else if (fieldNumber == OBF::TransportRoute::kOperatorFieldNumber)
+                    route->operatorName = value;
+                else if (fieldNumber == OBF::TransportRoute::kNameFieldNumber)
+                    route->name = value;
+                else
+                    route->latinName = value;
+            }
+            break;
+        case OBF::TransportRoute::kDirectStopsFieldNumber:
+        case OBF::TransportRoute::kReverseStopsFieldNumber:
+            {
+                gpb::uint32 length;
+                cis->ReadVarint32(&length);
+                const auto oldLimit = cis->PushLimit(length);
+
+                TransportRoute::Stop stop;
+                if (gpb::internal::WireFormatLite::GetTagFieldNumber(tag) == OBF::TransportRoute::kDirectStopsFieldNumber)
+                {
+                    readRouteStop(reader, directStopId, directStopPosition24, stringTable, stop);
+                    route->forwardStops.push_back(stop);
+                }
+                else
+                {
+                    readRouteStop(reader, reverseStopId, reverseStopPosition24, stringTable, stop);
+                    route->reverseStops.push_back(stop);
+                }
+
+                ObfReaderUtilities::ensureAllDataWasRead(cis);
+                cis->PopLimit(oldLimit);
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfTransportSectionReader_P::readRouteStop(
+    const ObfReader_P& reader,
+    int64_t& stopId,
+    PointI& stopPosition24,
+    const QStringList& stringTable,
+    TransportRoute::Stop& outStop)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    for (;;)
+    {
+        const auto tag = cis->ReadTag();
+        switch (gpb::internal::WireFormatLite::GetTagFieldNumber(tag))
+        {
+        case 0:
+            outStop.id = stopId;
+            outStop.position31 = convertToPoint31(stopPosition24);
+
+            if (!ObfReaderUtilities::reachedDataEnd(cis))
+                return;
+
+            return;
+        case OBF::TransportRouteStop::kIdFieldNumber:
+            stopId += ObfReaderUtilities::readSInt64(cis);
+            break;
+        case OBF::TransportRouteStop::kDxFieldNumber:
+            stopPosition24.x += ObfReaderUtilities::readSInt32(cis);
+            break;
+        case OBF::TransportRouteStop::kDyFieldNumber:
+            stopPosition24.y += ObfReaderUtilities::readSInt32(cis);
+            break;
+        case OBF::TransportRouteStop::kNameFieldNumber:
+            {
+                gpb::uint32 stringId;
+                cis->ReadVarint32(&stringId);
+                outStop.name = stringTable.value(stringId);
+            }
+            break;
+        case OBF::TransportRouteStop::kNameEnFieldNumber:
+            {
+                gpb::uint32 stringId;
+                cis->ReadVarint32(&stringId);
+                outStop.latinName = stringTable.value(stringId);
+            }
+            break;
+        default:
+            ObfReaderUtilities::skipUnknownField(cis, tag);
+            break;
+        }
+    }
+}
+
+void OsmAnd::ObfTransportSectionReader_P::loadStops(
+    const ObfReader_P& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const AreaI* const bbox31,
+    QList< std::shared_ptr<const TransportStop> >* resultOut,
+    const ObfTransportSectionReader::VisitorFunction visitor,
+    const IQueryController* const controller)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    if (section->_stopsLength == 0)
+        return;
+
+    QStringList stringTable;
+    readStringTable(reader, section, stringTable);
+
+    cis->Seek(section->_stopsOffset);
+    const auto oldLimit = cis->PushLimit(section->_stopsLength);
+
+    readStopsTree(reader, section, AreaI(0, 0, 0, 0), stringTable, bbox31, resultOut, visitor, controller);
+
+    cis->PopLimit(oldLimit);
+}
+
+void OsmAnd::ObfTransportSectionReader_P::loadRoutes(
+    const ObfReader_P& reader,
+    const std::shared_ptr<const ObfTransportSectionInfo>& section,
+    const QList<uint32_t>& routesOffsets,
+    QList< std::shared_ptr<const TransportRoute> >* resultOut,
+    const IQueryController* const controller)
+{
+    const auto cis = reader.getCodedInputStream().get();
+
+    QStringList stringTable;
+    readStringTable(reader, section, stringTable);
+
+    // Routes are read in order of their offsets to force forward-only seeking
+    auto sortedRoutesOffsets = routesOffsets;
+    qSort(sortedRoutesOffsets.begin(), sortedRoutesOffsets.end());
+    auto itPreviousRouteOffset = sortedRoutesOffsets.cend();
+    for (auto itRouteOffset = sortedRoutesOffsets.cbegin(); itRouteOffset != sortedRoutesOffsets.cend(); ++itRouteOffset)
+    {
+        if (controller && controller->isAborted())
+            return;
+        if (itPreviousRouteOffset != sortedRoutesOffsets.cend() && *itPreviousRouteOffset == *itRouteOffset)
+            continue;
+        itPreviousRouteOffset = itRouteOffset;
+
+        const auto routeOffset = *itRouteOffset;
+        if (routeOffset < section->offset || routeOffset >= section->offset + section->length)
+            continue;
+
+        cis->Seek(routeOffset);
+        gpb::uint32 length;
+        cis->ReadVarint32(&length);
+        const auto oldLimit = cis->PushLimit(length);
+
+        const auto route = readRoute(reader, section, routeOffset, stringTable);
+
+        ObfReaderUtilities::ensureAllDataWasRead(cis);
+        cis->PopLimit(oldLimit);
+
+        if (resultOut)
+            resultOut->push_back(route);
+    }
+}
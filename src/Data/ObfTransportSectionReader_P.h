@@ -5,14 +5,19 @@
 #include <functional>
 
 #include "QtExtensions.h"
+#include <QList>
+#include <QStringList>
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
+#include "ObfTransportSectionReader.h"
+#include "TransportRoute.h"
 
 namespace OsmAnd {
 
     class ObfReader_P;
     class ObfTransportSectionInfo;
+    class TransportStop;
     class IQueryController;
 
     class ObfTransportSectionReader_P Q_DECL_FINAL
@@ -21,11 +26,51 @@ namespace OsmAnd {
         ObfTransportSectionReader_P();
         ~ObfTransportSectionReader_P();
     protected:
+        // Zoom of tiles that stop coordinates are stored in
+        enum {
+            StopsZoom = 24,
+        };
+
         static void read(const ObfReader_P& reader, const std::shared_ptr<ObfTransportSectionInfo>& section);
 
         static void readTransportStopsBounds(const ObfReader_P& reader, const std::shared_ptr<ObfTransportSectionInfo>& section);
 
+        static void readStringTable(const ObfReader_P& reader, const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            QStringList& outStringTable);
+        static PointI convertToPoint31(const PointI& point24);
+        static void readStopsTree(const ObfReader_P& reader, const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const AreaI& parentArea24,
+            const QStringList& stringTable,
+            const AreaI* const bbox31,
+            QList< std::shared_ptr<const TransportStop> >* resultOut,
+            const ObfTransportSectionReader::VisitorFunction visitor,
+            const IQueryController* const controller);
+        static std::shared_ptr<TransportStop> readStop(const ObfReader_P& reader, const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const uint32_t stopOffset,
+            const AreaI& area24,
+            const QStringList& stringTable);
+        static std::shared_ptr<TransportRoute> readRoute(const ObfReader_P& reader, const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const uint32_t routeOffset,
+            const QStringList& stringTable);
+        static void readRouteStop(const ObfReader_P& reader,
+            int64_t& stopId,
+            PointI& stopPosition24,
+            const QStringList& stringTable,
+            TransportRoute::Stop& outStop);
+
+        static void loadStops(const ObfReader_P& reader, const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const AreaI* const bbox31,
+            QList< std::shared_ptr<const TransportStop> >* resultOut,
+            const ObfTransportSectionReader::VisitorFunction visitor,
+            const IQueryController* const controller);
+
+        static void loadRoutes(const ObfReader_P& reader, const std::shared_ptr<const ObfTransportSectionInfo>& section,
+            const QList<uint32_t>& routesOffsets,
+            QList< std::shared_ptr<const TransportRoute> >* resultOut,
+            const IQueryController* const controller);
+
     friend class OsmAnd::ObfReader_P;
+    friend class OsmAnd::ObfTransportSectionReader;
     };
 
 } // namespace OsmAnd
@@ -42,6 +42,22 @@ OsmAnd::Road::~Road()
 {
 }
 
+size_t OsmAnd::Road::getMemoryUsage() const
+{
+    // Hash entries are counted with key, value and two pointers of node overhead
+    auto memoryUsage =
+        sizeof(Road) +
+        static_cast<size_t>(points31.capacity()) * sizeof(PointI) +
+        static_cast<size_t>(typesRuleIds.capacity() + additionalTypesRuleIds.capacity()) * sizeof(uint32_t) +
+        static_cast<size_t>(restrictions.size()) * (sizeof(ObfObjectId) + sizeof(RoadRestriction) + 2 * sizeof(void*));
+    for (const auto& pointTypes : constOf(pointsTypes))
+        memoryUsage += sizeof(uint32_t) + sizeof(QVector<uint32_t>) + 2 * sizeof(void*) + pointTypes.capacity() * sizeof(uint32_t);
+    for (const auto& caption : constOf(captions))
+        memoryUsage += sizeof(uint32_t) + sizeof(QString) + 2 * sizeof(void*) + caption.capacity() * sizeof(QChar);
+
+    return memoryUsage;
+}
+
 //double OsmAnd::Road::getDirectionDelta( uint32_t originIdx, bool forward ) const
 //{
 //    //NOTE: Victor: the problem to put more than 5 meters that BinaryRoutePlanner will treat
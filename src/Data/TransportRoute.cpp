@@ -0,0 +1,24 @@
+#include "TransportRoute.h"
+
+#include "ObfTransportSectionInfo.h"
+
+OsmAnd::TransportRoute::TransportRoute(const std::shared_ptr<const ObfTransportSectionInfo>& section_)
+    : section(section_)
+    , offset(0)
+    , id(0)
+    , distance(0)
+{
+}
+
+OsmAnd::TransportRoute::~TransportRoute()
+{
+}
+
+OsmAnd::TransportRoute::Stop::Stop()
+    : id(0)
+{
+}
+
+OsmAnd::TransportRoute::Stop::~Stop()
+{
+}
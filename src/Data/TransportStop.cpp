@@ -0,0 +1,13 @@
+#include "TransportStop.h"
+
+#include "ObfTransportSectionInfo.h"
+
+OsmAnd::TransportStop::TransportStop(const std::shared_ptr<const ObfTransportSectionInfo>& section_)
+    : section(section_)
+    , id(0)
+{
+}
+
+OsmAnd::TransportStop::~TransportStop()
+{
+}
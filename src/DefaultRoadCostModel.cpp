@@ -0,0 +1,180 @@
+#include "DefaultRoadCostModel.h"
+
+#include "Road.h"
+
+OsmAnd::DefaultRoadCostModel::DefaultRoadCostModel(const Profile profile_ /*= Profile::Car*/)
+    : _maxSpeed(0.0f)
+    , _oneWayAware(true)
+    , _restrictionsAware(false)
+    , _trafficSignalsPenalty(0.0f)
+    , profile(profile_)
+{
+    switch (profile)
+    {
+        case Profile::Car:
+            _speedsByHighwayType.insert(QLatin1String("motorway"), 110.0f);
+            _speedsByHighwayType.insert(QLatin1String("motorway_link"), 60.0f);
+            _speedsByHighwayType.insert(QLatin1String("trunk"), 90.0f);
+            _speedsByHighwayType.insert(QLatin1String("trunk_link"), 50.0f);
+            _speedsByHighwayType.insert(QLatin1String("primary"), 70.0f);
+            _speedsByHighwayType.insert(QLatin1String("primary_link"), 45.0f);
+            _speedsByHighwayType.insert(QLatin1String("secondary"), 60.0f);
+            _speedsByHighwayType.insert(QLatin1String("secondary_link"), 40.0f);
+            _speedsByHighwayType.insert(QLatin1String("tertiary"), 50.0f);
+            _speedsByHighwayType.insert(QLatin1String("tertiary_link"), 35.0f);
+            _speedsByHighwayType.insert(QLatin1String("unclassified"), 40.0f);
+            _speedsByHighwayType.insert(QLatin1String("residential"), 30.0f);
+            _speedsByHighwayType.insert(QLatin1String("living_street"), 10.0f);
+            _speedsByHighwayType.insert(QLatin1String("service"), 20.0f);
+            _speedsByHighwayType.insert(QLatin1String("road"), 30.0f);
+            _speedsByHighwayType.insert(QLatin1String("track"), 15.0f);
+            _trafficSignalsPenalty = 15.0f;
+            _restrictionsAware = true;
+            break;
+
+        case Profile::Bicycle:
+            for (const auto& highwayType : {
+                "primary", "primary_link", "secondary", "secondary_link", "tertiary", "tertiary_link",
+                "unclassified", "residential", "living_street", "service", "road", "cycleway" })
+            {
+                _speedsByHighwayType.insert(QLatin1String(highwayType), 16.0f);
+            }
+            _speedsByHighwayType.insert(QLatin1String("track"), 12.0f);
+            _speedsByHighwayType.insert(QLatin1String("path"), 10.0f);
+            _speedsByHighwayType.insert(QLatin1String("footway"), 6.0f);
+            _speedsByHighwayType.insert(QLatin1String("pedestrian"), 6.0f);
+            _trafficSignalsPenalty = 10.0f;
+            break;
+
+        case Profile::Pedestrian:
+            for (const auto& highwayType : {
+                "primary", "primary_link", "secondary", "secondary_link", "tertiary", "tertiary_link",
+                "unclassified", "residential", "living_street", "service", "road", "track", "path",
+                "footway", "pedestrian", "steps", "cycleway", "bridleway" })
+            {
+                _speedsByHighwayType.insert(QLatin1String(highwayType), 5.0f);
+            }
+            _oneWayAware = false;
+            break;
+    }
+
+    for (const auto& speed : constOf(_speedsByHighwayType))
+        _maxSpeed = qMax(_maxSpeed, speed);
+}
+
+OsmAnd::DefaultRoadCostModel::~DefaultRoadCostModel()
+{
+}
+
+QString OsmAnd::DefaultRoadCostModel::getSignature() const
+{
+    switch (profile)
+    {
+        case Profile::Car:
+            return QLatin1String("default/car");
+        case Profile::Bicycle:
+            return QLatin1String("default/bicycle");
+        case Profile::Pedestrian:
+            return QLatin1String("default/pedestrian");
+    }
+
+    return QString();
+}
+
+bool OsmAnd::DefaultRoadCostModel::obtainHighwayType(
+    const std::shared_ptr<const Road>& road,
+    QString& outHighwayType,
+    float* const outMaxSpeed) const
+{
+    bool found = false;
+    for (const auto typeRuleId : constOf(road->typesRuleIds))
+    {
+        const auto citDecodingRule = road->encodingDecodingRules->decodingRules.constFind(typeRuleId);
+        if (citDecodingRule == road->encodingDecodingRules->decodingRules.cend())
+            continue;
+        const auto& decodingRule = *citDecodingRule;
+
+        if (decodingRule.tag == QLatin1String("highway"))
+        {
+            outHighwayType = decodingRule.value;
+            found = true;
+        }
+        else if (outMaxSpeed && decodingRule.tag == QLatin1String("maxspeed"))
+        {
+            bool ok = false;
+            const auto maxSpeed = decodingRule.value.toFloat(&ok);
+            if (ok && maxSpeed > 0.0f)
+                *outMaxSpeed = maxSpeed;
+        }
+    }
+
+    return found;
+}
+
+bool OsmAnd::DefaultRoadCostModel::acceptsRoad(const std::shared_ptr<const Road>& road) const
+{
+    QString highwayType;
+    if (!obtainHighwayType(road, highwayType, nullptr))
+        return false;
+
+    return _speedsByHighwayType.contains(highwayType);
+}
+
+OsmAnd::RoadDirection OsmAnd::DefaultRoadCostModel::getDirection(const std::shared_ptr<const Road>& road) const
+{
+    if (!_oneWayAware)
+        return RoadDirection::TwoWay;
+
+    const auto& encodingDecodingRules = road->encodingDecodingRules;
+    if (road->containsType(encodingDecodingRules->oneway_encodingRuleId))
+        return RoadDirection::OneWayForward;
+    if (road->containsType(encodingDecodingRules->onewayReverse_encodingRuleId))
+        return RoadDirection::OneWayReverse;
+    return RoadDirection::TwoWay;
+}
+
+float OsmAnd::DefaultRoadCostModel::getSpeed(const std::shared_ptr<const Road>& road) const
+{
+    QString highwayType;
+    float maxSpeed = 0.0f;
+    if (!obtainHighwayType(road, highwayType, profile == Profile::Car ? &maxSpeed : nullptr))
+        return 0.0f;
+
+    auto speed = _speedsByHighwayType.value(highwayType, 0.0f);
+    if (maxSpeed > 0.0f)
+        speed = qMin(maxSpeed, _maxSpeed);
+
+    return speed / 3.6f;
+}
+
+float OsmAnd::DefaultRoadCostModel::getMaxSpeed() const
+{
+    return _maxSpeed / 3.6f;
+}
+
+float OsmAnd::DefaultRoadCostModel::getPointPenalty(const std::shared_ptr<const Road>& road, const int pointIndex) const
+{
+    if (_trafficSignalsPenalty <= 0.0f)
+        return 0.0f;
+
+    const auto citPointTypes = road->pointsTypes.constFind(pointIndex);
+    if (citPointTypes == road->pointsTypes.cend())
+        return 0.0f;
+
+    for (const auto typeRuleId : constOf(*citPointTypes))
+    {
+        const auto citDecodingRule = road->encodingDecodingRules->decodingRules.constFind(typeRuleId);
+        if (citDecodingRule == road->encodingDecodingRules->decodingRules.cend())
+            continue;
+
+        if (citDecodingRule->tag == QLatin1String("highway") && citDecodingRule->value == QLatin1String("traffic_signals"))
+            return _trafficSignalsPenalty;
+    }
+
+    return 0.0f;
+}
+
+bool OsmAnd::DefaultRoadCostModel::isRestrictionsAware() const
+{
+    return _restrictionsAware;
+}
@@ -0,0 +1,65 @@
+#ifndef _OSMAND_CORE_FLAT_ARRAYS_IO_H_
+#define _OSMAND_CORE_FLAT_ARRAYS_IO_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QIODevice>
+#include <QByteArray>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+
+namespace OsmAnd
+{
+    // Precomputed indices are stored as header followed by arrays of plain structures, exactly as they're
+    // laid out in memory, so that loading is just reading. Sizes of arrays come from header and have to be
+    // set before reading. Data is not checked while being read: references between arrays are validated
+    // once after loading, so queries don't need to.
+    struct FlatArraysIO Q_DECL_FINAL
+    {
+        template<typename T>
+        static bool read(QIODevice& input, T& value)
+        {
+            return input.read(reinterpret_cast<char*>(&value), sizeof(T)) == sizeof(T);
+        }
+
+        template<typename T>
+        static bool readArray(QIODevice& input, QVector<T>& array)
+        {
+            const auto size = static_cast<qint64>(array.size()) * sizeof(T);
+            return input.read(reinterpret_cast<char*>(array.data()), size) == size;
+        }
+
+        static bool readArray(QIODevice& input, QByteArray& array)
+        {
+            return input.read(array.data(), array.size()) == array.size();
+        }
+
+        template<typename T>
+        static bool write(QIODevice& output, const T& value)
+        {
+            return output.write(reinterpret_cast<const char*>(&value), sizeof(T)) == sizeof(T);
+        }
+
+        template<typename T>
+        static bool writeArray(QIODevice& output, const QVector<T>& array)
+        {
+            const auto size = static_cast<qint64>(array.size()) * sizeof(T);
+            return output.write(reinterpret_cast<const char*>(array.constData()), size) == size;
+        }
+
+        static bool writeArray(QIODevice& output, const QByteArray& array)
+        {
+            return output.write(array) == array.size();
+        }
+
+    private:
+        FlatArraysIO();
+        ~FlatArraysIO();
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_FLAT_ARRAYS_IO_H_)
@@ -0,0 +1,9 @@
+#include "IRoadCostModel.h"
+
+OsmAnd::IRoadCostModel::IRoadCostModel()
+{
+}
+
+OsmAnd::IRoadCostModel::~IRoadCostModel()
+{
+}
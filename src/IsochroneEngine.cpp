@@ -0,0 +1,149 @@
+#include "IsochroneEngine.h"
+#include "IsochroneEngine_P.h"
+
+#include "MapObjectsProvider.h"
+
+OsmAnd::IsochroneEngine::IsochroneEngine(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection_,
+    const std::shared_ptr<const IRoadCostModel>& costModel_,
+    const std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache>& cache_ /*= nullptr*/)
+    : _p(new IsochroneEngine_P(this))
+    , obfsCollection(obfsCollection_)
+    , costModel(costModel_)
+    , cache(cache_)
+{
+}
+
+OsmAnd::IsochroneEngine::~IsochroneEngine()
+{
+}
+
+bool OsmAnd::IsochroneEngine::compute(
+    const PointI origin31,
+    const QList<float>& times,
+    QList<Isochrone>& outIsochrones,
+    const double cellSizeInMeters /*= 100.0*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->compute(origin31, times, outIsochrones, cellSizeInMeters, controller);
+}
+
+std::shared_ptr<OsmAnd::IMapObjectsProvider> OsmAnd::IsochroneEngine::createMapObjectsProvider(
+    const QList<Isochrone>& isochrones)
+{
+    QList< std::shared_ptr<const MapObject> > mapObjects;
+    for (auto bandIndex = 0; bandIndex < isochrones.size() && bandIndex < MapObject::MaxBandsCount; bandIndex++)
+    {
+        const auto& isochrone = isochrones[bandIndex];
+        for (const auto& polygon : constOf(isochrone.polygons))
+        {
+            const std::shared_ptr<MapObject> newMapObject(new MapObject(
+                polygon,
+                isochrone.time,
+                bandIndex));
+            mapObjects.append(newMapObject);
+        }
+    }
+
+    return std::shared_ptr<MapObjectsProvider>(new MapObjectsProvider(
+        copyAs< QList< std::shared_ptr<const OsmAnd::MapObject> > >(mapObjects)));
+}
+
+OsmAnd::IsochroneEngine::Polygon::Polygon()
+{
+}
+
+OsmAnd::IsochroneEngine::Polygon::~Polygon()
+{
+}
+
+OsmAnd::IsochroneEngine::Isochrone::Isochrone()
+    : time(0.0f)
+{
+}
+
+OsmAnd::IsochroneEngine::Isochrone::~Isochrone()
+{
+}
+
+std::shared_ptr<const OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules> OsmAnd::IsochroneEngine::MapObject::defaultEncodingDecodingRules(OsmAnd::modifyAndReturn(
+    std::shared_ptr<OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules>(new OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules()),
+    static_cast< std::function<void(std::shared_ptr<OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules>& instance)> >([]
+    (std::shared_ptr<OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules>& rules) -> void
+    {
+        rules->verifyRequiredRulesExist();
+    })));
+
+OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules::EncodingDecodingRules()
+    : isochrone_encodingRuleId(std::numeric_limits<uint32_t>::max())
+{
+    std::fill(
+        isochroneBand_encodingRuleIds,
+        isochroneBand_encodingRuleIds + MaxBandsCount,
+        std::numeric_limits<uint32_t>::max());
+}
+
+OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules::~EncodingDecodingRules()
+{
+}
+
+void OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules::createRequiredRules(uint32_t& lastUsedRuleId)
+{
+    if (isochrone_encodingRuleId == std::numeric_limits<uint32_t>::max())
+    {
+        addRule(lastUsedRuleId++,
+            QLatin1String("osmand"), QLatin1String("isochrone"));
+    }
+
+    for (auto bandIndex = 0; bandIndex < MaxBandsCount; bandIndex++)
+    {
+        if (isochroneBand_encodingRuleIds[bandIndex] == std::numeric_limits<uint32_t>::max())
+        {
+            addRule(lastUsedRuleId++,
+                QLatin1String("isochrone_band"), QString::number(bandIndex));
+        }
+    }
+}
+
+uint32_t OsmAnd::IsochroneEngine::MapObject::EncodingDecodingRules::addRule(const uint32_t ruleId, const QString& ruleTag, const QString& ruleValue)
+{
+    OsmAnd::MapObject::EncodingDecodingRules::addRule(ruleId, ruleTag, ruleValue);
+
+    if (QLatin1String("osmand") == ruleTag && QLatin1String("isochrone") == ruleValue)
+        isochrone_encodingRuleId = ruleId;
+    else if (QLatin1String("isochrone_band") == ruleTag)
+    {
+        bool ok = false;
+        const auto bandIndex = ruleValue.toInt(&ok);
+        if (ok && bandIndex >= 0 && bandIndex < MaxBandsCount)
+            isochroneBand_encodingRuleIds[bandIndex] = ruleId;
+    }
+
+    return ruleId;
+}
+
+OsmAnd::IsochroneEngine::MapObject::MapObject(
+    const Polygon& polygon,
+    const float time_,
+    const int bandIndex_)
+    : time(time_)
+    , bandIndex(bandIndex_)
+{
+    encodingDecodingRules = defaultEncodingDecodingRules;
+
+    isArea = true;
+    points31 = polygon.outerRing31;
+    innerPolygonsPoints31 = polygon.innerRings31;
+    computeBBox31();
+
+    // Caption is time in minutes
+    captionsOrder.push_back(defaultEncodingDecodingRules->name_encodingRuleId);
+    captions[defaultEncodingDecodingRules->name_encodingRuleId] = QString::number(qRound(time / 60.0f));
+
+    typesRuleIds.append(defaultEncodingDecodingRules->isochrone_encodingRuleId);
+    additionalTypesRuleIds.append(defaultEncodingDecodingRules->isochroneBand_encodingRuleIds[bandIndex]);
+}
+
+OsmAnd::IsochroneEngine::MapObject::~MapObject()
+{
+}
@@ -0,0 +1,471 @@
+#include "IsochroneEngine_P.h"
+#include "IsochroneEngine.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QtMath>
+#include "restore_internal_warnings.h"
+
+#include "IQueryController.h"
+#include "Utilities.h"
+
+const double OsmAnd::IsochroneEngine_P::AttachRadiusInMeters = 1000.0;
+const int OsmAnd::IsochroneEngine_P::MaxGridCellsCount = 4 * 1024 * 1024;
+
+OsmAnd::IsochroneEngine_P::IsochroneEngine_P(IsochroneEngine* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::IsochroneEngine_P::~IsochroneEngine_P()
+{
+}
+
+bool OsmAnd::IsochroneEngine_P::heapEntryComparator(const HeapEntry& l, const HeapEntry& r)
+{
+    // Makes std::*_heap() functions maintain min-heap
+    return l.time > r.time;
+}
+
+void OsmAnd::IsochroneEngine_P::Grid::put(const PointI& position31, const float time)
+{
+    const auto x = (static_cast<int64_t>(position31.x) - origin31.x) / cellWidth31;
+    const auto y = (static_cast<int64_t>(position31.y) - origin31.y) / cellHeight31;
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return;
+
+    auto& cellTime = times[static_cast<int>(y) * width + static_cast<int>(x)];
+    if (time < cellTime)
+        cellTime = time;
+}
+
+void OsmAnd::IsochroneEngine_P::Grid::dilate()
+{
+    const auto sourceTimes = times;
+    const auto pSourceTimes = sourceTimes.constData();
+    const auto pTimes = times.data();
+    for (auto y = 0; y < height; y++)
+    {
+        for (auto x = 0; x < width; x++)
+        {
+            auto minTime = pSourceTimes[y * width + x];
+            for (auto neighbourY = qMax(y - 1, 0); neighbourY <= qMin(y + 1, height - 1); neighbourY++)
+            {
+                for (auto neighbourX = qMax(x - 1, 0); neighbourX <= qMin(x + 1, width - 1); neighbourX++)
+                    minTime = qMin(minTime, pSourceTimes[neighbourY * width + neighbourX]);
+            }
+            pTimes[y * width + x] = minTime;
+        }
+    }
+}
+
+bool OsmAnd::IsochroneEngine_P::searchReachableNodes(
+    RoadGraph& graph,
+    const RoadGraph::Attachment& originAttachment,
+    const float maxTime,
+    QVector<float>& outNodeTimes,
+    const IQueryController* const controller)
+{
+    // Search is edge-based, so that turn restrictions are obeyed. Time of a node is the best time of edges
+    // that arrive at it
+    QVector<float> edgeTimes;
+    QVector<bool> settled;
+    QVector<HeapEntry> heap;
+    const auto resize =
+        [&graph, &outNodeTimes, &edgeTimes, &settled]
+        () -> void
+        {
+            const auto oldNodesCount = outNodeTimes.size();
+            outNodeTimes.resize(graph.getNodesCount());
+            std::fill(outNodeTimes.begin() + oldNodesCount, outNodeTimes.end(), std::numeric_limits<float>::infinity());
+
+            const auto oldEdgesCount = edgeTimes.size();
+            edgeTimes.resize(graph.getEdgesCount());
+            settled.resize(graph.getEdgesCount());
+            std::fill(edgeTimes.begin() + oldEdgesCount, edgeTimes.end(), std::numeric_limits<float>::infinity());
+            std::fill(settled.begin() + oldEdgesCount, settled.end(), false);
+        };
+    const auto push =
+        [&edgeTimes, &heap]
+        (const int edge, const float time) -> void
+        {
+            edgeTimes[edge] = time;
+
+            HeapEntry entry;
+            entry.time = time;
+            entry.edge = edge;
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), heapEntryComparator);
+        };
+
+    // Edges of attached segment are passed only partially
+    outNodeTimes.clear();
+    resize();
+    if (originAttachment.timeToStart >= 0.0f && originAttachment.timeToStart <= maxTime)
+        push(originAttachment.backwardEdge, originAttachment.timeToStart);
+    if (originAttachment.timeToEnd >= 0.0f && originAttachment.timeToEnd <= maxTime)
+        push(originAttachment.forwardEdge, originAttachment.timeToEnd);
+
+    // Only edges within time bound are ever pushed, so every one of them gets settled
+    while (!heap.isEmpty())
+    {
+        const auto edgeIdx = heap.first().edge;
+        std::pop_heap(heap.begin(), heap.end(), heapEntryComparator);
+        heap.removeLast();
+        if (settled[edgeIdx])
+            continue;
+        settled[edgeIdx] = true;
+
+        const auto node = graph.getEdge(edgeIdx).target;
+        const auto time = edgeTimes[edgeIdx];
+        outNodeTimes[node] = qMin(outNodeTimes[node], time);
+
+        if (graph.completeNode(node, controller))
+            resize();
+        if (controller && controller->isAborted())
+            return false;
+
+        for (auto nextEdgeIdx = graph.getFirstOutgoingEdge(node); nextEdgeIdx >= 0; nextEdgeIdx = graph.getEdge(nextEdgeIdx).nextOutgoing)
+        {
+            if (!graph.isTurnAllowed(edgeIdx, nextEdgeIdx))
+                continue;
+
+            const auto newTime = time + graph.getEdge(nextEdgeIdx).time;
+            if (newTime <= maxTime && newTime < edgeTimes[nextEdgeIdx])
+                push(nextEdgeIdx, newTime);
+        }
+    }
+
+    return true;
+}
+
+void OsmAnd::IsochroneEngine_P::rasterize(
+    const RoadGraph& graph,
+    const RoadGraph::Attachment& originAttachment,
+    const QVector<float>& nodeTimes,
+    const float maxTime,
+    const double cellSizeInMeters,
+    Grid& outGrid)
+{
+    const auto nodesCount = nodeTimes.size();
+
+    auto left = originAttachment.position31.x;
+    auto right = left;
+    auto top = originAttachment.position31.y;
+    auto bottom = top;
+    for (auto node = 0; node < nodesCount; node++)
+    {
+        if (nodeTimes[node] > maxTime)
+            continue;
+
+        const auto& position31 = graph.getNodePosition(node);
+        left = qMin(left, position31.x);
+        right = qMax(right, position31.x);
+        top = qMin(top, position31.y);
+        bottom = qMax(bottom, position31.y);
+    }
+
+    // Margin keeps border cells unreached even after dilation
+    const auto marginCellsCount = 2;
+    auto cellSize = qMax(cellSizeInMeters, 1.0);
+    for (;;)
+    {
+        outGrid.cellWidth31 = qMax(Utilities::metersToX31(cellSize), static_cast<int64_t>(1));
+        outGrid.cellHeight31 = qMax(Utilities::metersToY31(cellSize), static_cast<int64_t>(1));
+        const auto width = (static_cast<int64_t>(right) - left) / outGrid.cellWidth31 + 1 + 2 * marginCellsCount;
+        const auto height = (static_cast<int64_t>(bottom) - top) / outGrid.cellHeight31 + 1 + 2 * marginCellsCount;
+        const auto cellsCount = width * height;
+        if (cellsCount <= MaxGridCellsCount)
+        {
+            outGrid.width = static_cast<int>(width);
+            outGrid.height = static_cast<int>(height);
+            break;
+        }
+
+        cellSize *= qSqrt(static_cast<double>(cellsCount) / MaxGridCellsCount);
+    }
+    outGrid.origin31 = PointI64(
+        static_cast<int64_t>(left) - marginCellsCount * outGrid.cellWidth31,
+        static_cast<int64_t>(top) - marginCellsCount * outGrid.cellHeight31);
+    outGrid.times.resize(outGrid.width * outGrid.height);
+    std::fill(outGrid.times.begin(), outGrid.times.end(), std::numeric_limits<float>::infinity());
+
+    // Edges are sampled twice per cell, with time interpolated along edge
+    outGrid.put(originAttachment.position31, 0.0f);
+    const auto sampleStepInMeters = cellSize * 0.5;
+    for (auto node = 0; node < nodesCount; node++)
+    {
+        const auto time = nodeTimes[node];
+        if (time > maxTime)
+            continue;
+
+        const auto& position31 = graph.getNodePosition(node);
+        outGrid.put(position31, time);
+
+        for (auto edgeIdx = graph.getFirstOutgoingEdge(node); edgeIdx >= 0; edgeIdx = graph.getEdge(edgeIdx).nextOutgoing)
+        {
+            const auto& edge = graph.getEdge(edgeIdx);
+            const auto& targetPosition31 = graph.getNodePosition(edge.target);
+            const auto stepsCount = qMax(static_cast<int>(qCeil(edge.length / sampleStepInMeters)), 1);
+            for (auto stepIdx = 1; stepIdx <= stepsCount; stepIdx++)
+            {
+                const auto factor = static_cast<float>(stepIdx) / stepsCount;
+                const auto sampleTime = time + edge.time * factor;
+                if (sampleTime > maxTime)
+                    break;
+
+                outGrid.put(
+                    PointI(
+                        position31.x + static_cast<int32_t>((static_cast<int64_t>(targetPosition31.x) - position31.x) * factor),
+                        position31.y + static_cast<int32_t>((static_cast<int64_t>(targetPosition31.y) - position31.y) * factor)),
+                    sampleTime);
+            }
+        }
+    }
+}
+
+void OsmAnd::IsochroneEngine_P::traceRings(const Grid& grid, const float time, QList< QVector<PointI64> >& outRings)
+{
+    enum Direction
+    {
+        East = 0,
+        South = 1,
+        West = 2,
+        North = 3,
+    };
+    static const int directionDX[4] = { 1, 0, -1, 0 };
+    static const int directionDY[4] = { 0, 1, 0, -1 };
+
+    const auto pTimes = grid.times.constData();
+    const auto isReached =
+        [&grid, pTimes, time]
+        (const int x, const int y) -> bool
+        {
+            return x >= 0 && y >= 0 && x < grid.width && y < grid.height && pTimes[y * grid.width + x] <= time;
+        };
+
+    // Each reached cell contributes sides it shares with unreached cells, directed clockwise around the cell.
+    // Sides are kept as mask of directions of edges that go out of each vertex of the grid
+    const auto verticesWidth = grid.width + 1;
+    QVector<uint8_t> outgoingEdges((grid.height + 1) * verticesWidth);
+    std::fill(outgoingEdges.begin(), outgoingEdges.end(), 0);
+    const auto pOutgoingEdges = outgoingEdges.data();
+    for (auto y = 0; y < grid.height; y++)
+    {
+        for (auto x = 0; x < grid.width; x++)
+        {
+            if (!isReached(x, y))
+                continue;
+
+            if (!isReached(x, y - 1))
+                pOutgoingEdges[y * verticesWidth + x] |= (1u << East);
+            if (!isReached(x + 1, y))
+                pOutgoingEdges[y * verticesWidth + x + 1] |= (1u << South);
+            if (!isReached(x, y + 1))
+                pOutgoingEdges[(y + 1) * verticesWidth + x + 1] |= (1u << West);
+            if (!isReached(x - 1, y))
+                pOutgoingEdges[(y + 1) * verticesWidth + x] |= (1u << North);
+        }
+    }
+
+    const auto verticesCount = outgoingEdges.size();
+    for (auto startVertex = 0; startVertex < verticesCount; startVertex++)
+    {
+        while (pOutgoingEdges[startVertex] != 0)
+        {
+            auto direction = 0;
+            while ((pOutgoingEdges[startVertex] & (1u << direction)) == 0)
+                direction++;
+
+            // Ring passes midpoints of edges, which cuts corners of cells
+            QVector<PointI64> ring;
+            auto x = startVertex % verticesWidth;
+            auto y = startVertex / verticesWidth;
+            for (;;)
+            {
+                pOutgoingEdges[y * verticesWidth + x] &= ~(1u << direction);
+                ring.push_back(PointI64(2 * x + directionDX[direction], 2 * y + directionDY[direction]));
+                x += directionDX[direction];
+                y += directionDY[direction];
+
+                const auto vertex = y * verticesWidth + x;
+                if (vertex == startVertex)
+                    break;
+
+                // At vertex shared by two diagonally adjacent reached cells, turning right keeps them apart
+                const auto edges = pOutgoingEdges[vertex];
+                if (edges & (1u << ((direction + 1) % 4)))
+                    direction = (direction + 1) % 4;
+                else if (edges & (1u << direction))
+                    continue;
+                else if (edges & (1u << ((direction + 3) % 4)))
+                    direction = (direction + 3) % 4;
+                else
+                    break;
+            }
+
+            // Remove points that lie on straight line between their neighbours
+            QVector<PointI64> simplifiedRing;
+            simplifiedRing.reserve(ring.size());
+            const auto pointsCount = ring.size();
+            for (auto pointIdx = 0; pointIdx < pointsCount; pointIdx++)
+            {
+                const auto& previous = ring[(pointIdx + pointsCount - 1) % pointsCount];
+                const auto& current = ring[pointIdx];
+                const auto& next = ring[(pointIdx + 1) % pointsCount];
+                const auto crossProduct =
+                    (current.x - previous.x) * (next.y - current.y) -
+                    (current.y - previous.y) * (next.x - current.x);
+                if (crossProduct != 0)
+                    simplifiedRing.push_back(current);
+            }
+            if (simplifiedRing.size() >= 3)
+                outRings.push_back(simplifiedRing);
+        }
+    }
+}
+
+void OsmAnd::IsochroneEngine_P::assemblePolygons(
+    const Grid& grid,
+    const QList< QVector<PointI64> >& rings,
+    QList<Polygon>& outPolygons)
+{
+    const auto ringsCount = rings.size();
+    QVector<int64_t> doubledAreas(ringsCount);
+    QVector<int> polygonIndices(ringsCount);
+    for (auto ringIdx = 0; ringIdx < ringsCount; ringIdx++)
+    {
+        doubledAreas[ringIdx] = computeDoubledArea(rings[ringIdx]);
+        polygonIndices[ringIdx] = -1;
+        if (doubledAreas[ringIdx] <= 0)
+            continue;
+
+        polygonIndices[ringIdx] = outPolygons.size();
+        Polygon polygon;
+        polygon.outerRing31 = convertToRing31(grid, rings[ringIdx]);
+        outPolygons.push_back(polygon);
+    }
+
+    // Hole belongs to the smallest outer ring that contains it, since unreached hole may contain reached island
+    for (auto holeIdx = 0; holeIdx < ringsCount; holeIdx++)
+    {
+        if (doubledAreas[holeIdx] >= 0)
+            continue;
+
+        auto ownerRingIdx = -1;
+        for (auto ringIdx = 0; ringIdx < ringsCount; ringIdx++)
+        {
+            if (doubledAreas[ringIdx] <= 0)
+                continue;
+            if (ownerRingIdx >= 0 && doubledAreas[ringIdx] >= doubledAreas[ownerRingIdx])
+                continue;
+            if (containsPoint(rings[ringIdx], rings[holeIdx].first()))
+                ownerRingIdx = ringIdx;
+        }
+        if (ownerRingIdx < 0)
+            continue;
+
+        outPolygons[polygonIndices[ownerRingIdx]].innerRings31.push_back(convertToRing31(grid, rings[holeIdx]));
+    }
+}
+
+QVector<OsmAnd::PointI> OsmAnd::IsochroneEngine_P::convertToRing31(const Grid& grid, const QVector<PointI64>& ring)
+{
+    QVector<PointI> ring31;
+    ring31.reserve(ring.size() + 1);
+    for (const auto& point : constOf(ring))
+    {
+        const auto x31 = grid.origin31.x + point.x * grid.cellWidth31 / 2;
+        const auto y31 = grid.origin31.y + point.y * grid.cellHeight31 / 2;
+        ring31.push_back(PointI(
+            static_cast<int32_t>(qBound(static_cast<int64_t>(0), x31, static_cast<int64_t>(std::numeric_limits<int32_t>::max()))),
+            static_cast<int32_t>(qBound(static_cast<int64_t>(0), y31, static_cast<int64_t>(std::numeric_limits<int32_t>::max())))));
+    }
+    ring31.push_back(ring31.first());
+
+    return ring31;
+}
+
+int64_t OsmAnd::IsochroneEngine_P::computeDoubledArea(const QVector<PointI64>& ring)
+{
+    int64_t doubledArea = 0;
+    const auto pointsCount = ring.size();
+    for (auto pointIdx = 0; pointIdx < pointsCount; pointIdx++)
+    {
+        const auto& current = ring[pointIdx];
+        const auto& next = ring[(pointIdx + 1) % pointsCount];
+        doubledArea += current.x * next.y - next.x * current.y;
+    }
+
+    return doubledArea;
+}
+
+bool OsmAnd::IsochroneEngine_P::containsPoint(const QVector<PointI64>& ring, const PointI64& point)
+{
+    auto contains = false;
+    const auto pointsCount = ring.size();
+    for (auto pointIdx = 0, previousPointIdx = pointsCount - 1; pointIdx < pointsCount; previousPointIdx = pointIdx++)
+    {
+        const auto& a = ring[pointIdx];
+        const auto& b = ring[previousPointIdx];
+        if ((a.y > point.y) == (b.y > point.y))
+            continue;
+
+        // Compares X of point with X of crossing without division, so sign of denominator matters
+        const auto lhs = (point.x - a.x) * (b.y - a.y);
+        const auto rhs = (b.x - a.x) * (point.y - a.y);
+        if ((b.y > a.y) ? (lhs < rhs) : (lhs > rhs))
+            contains = !contains;
+    }
+
+    return contains;
+}
+
+bool OsmAnd::IsochroneEngine_P::compute(
+    const PointI origin31,
+    const QList<float>& times,
+    QList<Isochrone>& outIsochrones,
+    const double cellSizeInMeters,
+    const IQueryController* const controller) const
+{
+    outIsochrones.clear();
+    if (times.isEmpty() || times.size() > IsochroneEngine::MapObject::MaxBandsCount)
+        return false;
+
+    auto maxTime = 0.0f;
+    for (const auto time : constOf(times))
+        maxTime = qMax(maxTime, time);
+
+    RoadGraph graph(owner->obfsCollection, owner->costModel, owner->cache.get());
+    RoadGraph::Attachment originAttachment;
+    if (!graph.attach(origin31, AttachRadiusInMeters, originAttachment, controller))
+        return false;
+
+    // Single search bounded by the largest time serves all bands
+    QVector<float> nodeTimes;
+    if (!searchReachableNodes(graph, originAttachment, maxTime, nodeTimes, controller))
+        return false;
+
+    Grid grid;
+    rasterize(graph, originAttachment, nodeTimes, maxTime, cellSizeInMeters, grid);
+    grid.dilate();
+
+    for (const auto time : constOf(times))
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        Isochrone isochrone;
+        isochrone.time = time;
+        QList< QVector<PointI64> > rings;
+        traceRings(grid, time, rings);
+        assemblePolygons(grid, rings, isochrone.polygons);
+        outIsochrones.push_back(isochrone);
+    }
+
+    return true;
+}
@@ -0,0 +1,97 @@
+#ifndef _OSMAND_CORE_ISOCHRONE_ENGINE_P_H_
+#define _OSMAND_CORE_ISOCHRONE_ENGINE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "IsochroneEngine.h"
+#include "RoadGraph.h"
+
+namespace OsmAnd
+{
+    class IsochroneEngine;
+    class IsochroneEngine_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(IsochroneEngine_P);
+
+    public:
+        typedef IsochroneEngine::Isochrone Isochrone;
+        typedef IsochroneEngine::Polygon Polygon;
+
+        // Maximal distance from origin to the road it's attached to
+        static const double AttachRadiusInMeters;
+        // Cells are enlarged when area reached within the largest time doesn't fit into this many cells
+        static const int MaxGridCellsCount;
+
+    private:
+        struct HeapEntry
+        {
+            float time;
+            int edge;
+        };
+
+        // Minimal travel time to reach each cell, infinity for cells that were not reached.
+        // Grid has margin of unreached cells on each side, so that every outline is closed inside of it
+        struct Grid
+        {
+            PointI64 origin31;
+            int64_t cellWidth31;
+            int64_t cellHeight31;
+            int width;
+            int height;
+            QVector<float> times;
+
+            void put(const PointI& position31, const float time);
+            // Each cell takes minimal time of its neighbours, so that area around reached roads is covered
+            void dilate();
+        };
+
+        static bool heapEntryComparator(const HeapEntry& l, const HeapEntry& r);
+        // Settles all nodes reachable from attachment within given time, times of other nodes are left infinite
+        static bool searchReachableNodes(
+            RoadGraph& graph,
+            const RoadGraph::Attachment& originAttachment,
+            const float maxTime,
+            QVector<float>& outNodeTimes,
+            const IQueryController* const controller);
+        static void rasterize(
+            const RoadGraph& graph,
+            const RoadGraph::Attachment& originAttachment,
+            const QVector<float>& nodeTimes,
+            const float maxTime,
+            const double cellSizeInMeters,
+            Grid& outGrid);
+        // Traces outlines of cells reachable within given time. Points are given in half-cell units,
+        // outer rings go clockwise and have positive area, holes go counter-clockwise
+        static void traceRings(const Grid& grid, const float time, QList< QVector<PointI64> >& outRings);
+        static void assemblePolygons(const Grid& grid, const QList< QVector<PointI64> >& rings, QList<Polygon>& outPolygons);
+        static QVector<PointI> convertToRing31(const Grid& grid, const QVector<PointI64>& ring);
+        static int64_t computeDoubledArea(const QVector<PointI64>& ring);
+        static bool containsPoint(const QVector<PointI64>& ring, const PointI64& point);
+    protected:
+        IsochroneEngine_P(IsochroneEngine* const owner);
+    public:
+        ~IsochroneEngine_P();
+
+        ImplementationInterface<IsochroneEngine> owner;
+
+        bool compute(
+            const PointI origin31,
+            const QList<float>& times,
+            QList<Isochrone>& outIsochrones,
+            const double cellSizeInMeters,
+            const IQueryController* const controller) const;
+
+    friend class OsmAnd::IsochroneEngine;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ISOCHRONE_ENGINE_P_H_)
@@ -34,6 +34,8 @@
 #include "Stopwatch.h"
 #include "GlmExtensions.h"
 
+const OsmAnd::AreaI::CoordType OsmAnd::AtlasMapRendererSymbolsStage::IntersectionsGridCellSize = 64;
+
 OsmAnd::AtlasMapRendererSymbolsStage::AtlasMapRendererSymbolsStage(AtlasMapRenderer* const renderer_)
     : AtlasMapRendererStage(renderer_)
 {
@@ -45,13 +47,21 @@ OsmAnd::AtlasMapRendererSymbolsStage::~AtlasMapRendererSymbolsStage()
 
 void OsmAnd::AtlasMapRendererSymbolsStage::prepare(AtlasMapRenderer_Metrics::Metric_renderFrame* const metric)
 {
+    // Symbols prepared for previous frame are still valid, unless anything they depend on was changed
+    if (setupOptions.skipUnchangedFrames && !areSymbolsInvalidated())
+    {
+        if (metric)
+            metric->preparingSymbolsSkipped = true;
+
+        return;
+    }
+
     Stopwatch stopwatch(metric != nullptr);
 
-    IntersectionsQuadTree intersections;
-    if (!obtainRenderableSymbols(renderableSymbols, intersections, metric))
+    if (!obtainRenderableSymbols(renderableSymbols, _preparingIntersections, metric))
     {
-        // In case obtain failed due to lock, schedule another frame
-        invalidateFrame();
+        // In case obtain failed due to lock, schedule another frame that prepares symbols again
+        invalidateSymbols();
 
         if (metric)
             metric->elapsedTimeForPreparingSymbols = stopwatch.elapsed();
@@ -62,7 +72,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::prepare(AtlasMapRenderer_Metrics::Met
     Stopwatch preparedSymbolsPublishingStopwatch(metric != nullptr);
     {
         QWriteLocker scopedLocker(&_lastPreparedIntersectionsLock);
-        _lastPreparedIntersections = qMove(intersections);
+        _lastPreparedIntersections.swap(_preparingIntersections);
     }
     if (metric)
         metric->elapsedTimeForPublishingPreparedSymbols = preparedSymbolsPublishingStopwatch.elapsed();
@@ -95,7 +105,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::queryLastPreparedSymbolsAt(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
     QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
-    IntersectionsQuadTree& outIntersections,
+    IntersectionsGrid& outIntersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     Stopwatch stopwatch(metric != nullptr);
@@ -139,7 +149,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
 bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
     const MapRenderer::PublishedMapSymbolsByOrder& mapSymbolsByOrder,
     QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
-    IntersectionsQuadTree& outIntersections,
+    IntersectionsGrid& outIntersections,
     MapRenderer::PublishedMapSymbolsByOrder* pOutAcceptedMapSymbolsByOrder,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
@@ -160,7 +170,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
         void discard(
             const AtlasMapRendererSymbolsStage* const stage,
             PlottedSymbols& plottedSymbols,
-            IntersectionsQuadTree& intersections)
+            IntersectionsGrid& intersections)
         {
             // Discard entire group
             for (auto& symbolRef : symbolsRefs)
@@ -180,7 +190,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
         void discardSpecific(
             const AtlasMapRendererSymbolsStage* const stage,
             PlottedSymbols& plottedSymbols,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             const std::function<bool(const std::shared_ptr<const RenderableSymbol>&)> acceptor)
         {
             auto itSymbolRef = mutableIteratorOf(symbolsRefs);
@@ -206,7 +216,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
         void discardAllOf(
             const AtlasMapRendererSymbolsStage* const stage,
             PlottedSymbols& plottedSymbols,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             const MapSymbol::ContentClass contentClass)
         {
             auto itSymbolRef = mutableIteratorOf(symbolsRefs);
@@ -233,7 +243,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
     {
         QHash< std::shared_ptr<const MapSymbolsGroup::AdditionalInstance>, PlottedSymbolsRefGroupInstance > instancesRefs;
 
-        void discard(const AtlasMapRendererSymbolsStage* const stage, PlottedSymbols& plottedSymbols, IntersectionsQuadTree& intersections)
+        void discard(const AtlasMapRendererSymbolsStage* const stage, PlottedSymbols& plottedSymbols, IntersectionsGrid& intersections)
         {
             // Discard all instances
             for (auto& instanceRef : instancesRefs)
@@ -246,11 +256,8 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderableSymbols(
     // Iterate over map symbols layer sorted by "order" in ascending direction.
     // This means that map symbols with smaller order value are more important than map symbols with
     // larger order value.
-    // Tree depth should satisfy following condition:
-    // (max(width, height) / 2^depth) >= 64
-    const auto viewportMaxDimension = qMax(currentState.viewport.height(), currentState.viewport.width());
-    const auto treeDepth = 32u - SkCLZ(viewportMaxDimension >> 6);
-    outIntersections = qMove(IntersectionsQuadTree(currentState.viewport, qMax(treeDepth, 1u)));
+    // Cells of 64x64 pixels fit most of the symbols into one to four cells
+    outIntersections.reset(currentState.viewport, IntersectionsGridCellSize);
     ComputedPathsDataCache computedPathsDataCache;
     for (const auto& mapSymbolsByOrderEntry : rangeOf(constOf(mapSymbolsByOrder)))
     {
@@ -676,7 +683,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotSymbol(
     const std::shared_ptr<RenderableSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     Stopwatch stopwatch(metric != nullptr);
@@ -780,7 +787,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromBillboardSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotBillboardSymbol(
     const std::shared_ptr<RenderableBillboardSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     bool plotted = false;
@@ -803,7 +810,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::plotBillboardSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotBillboardRasterSymbol(
     const std::shared_ptr<RenderableBillboardSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     const auto& internalState = getInternalState();
@@ -847,7 +854,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::plotBillboardRasterSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotBillboardVectorSymbol(
     const std::shared_ptr<RenderableBillboardSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     assert(false);
@@ -915,7 +922,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromOnSurfaceSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnSurfaceSymbol(
     const std::shared_ptr<RenderableOnSurfaceSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     if (std::dynamic_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol))
@@ -939,7 +946,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnSurfaceSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnSurfaceRasterSymbol(
     const std::shared_ptr<RenderableOnSurfaceSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     const auto& internalState = getInternalState();
@@ -952,7 +959,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnSurfaceRasterSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnSurfaceVectorSymbol(
     const std::shared_ptr<RenderableOnSurfaceSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     const auto& internalState = getInternalState();
@@ -1007,9 +1014,14 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromOnPathSymbol(
     ////////////////////////////////////////////////////////////////////////////
 
     // Get GPU resource for this map symbol, since it's useless to perform any calculations unless it's possible to draw it
-    const auto gpuResource = std::dynamic_pointer_cast<const GPUAPI::TextureInGPU>(captureGpuResource(referenceOrigins, onPathMapSymbol));
-    if (!gpuResource)
+    // Glyphs of on-path symbol are either taken from its own texture or from pages of glyph atlas
+    const auto gpuResource = captureGpuResource(referenceOrigins, onPathMapSymbol);
+    if (!gpuResource ||
+        (gpuResource->type != GPUAPI::ResourceInGPU::Type::Texture &&
+            gpuResource->type != GPUAPI::ResourceInGPU::Type::SdfGlyphs))
+    {
         return;
+    }
 
     // Processing pin-point needs path in world and path on screen, as well as lengths of all segments. This may have already been computed
     auto itComputedPathData = computedPathsDataCache.find(onPathMapSymbol->shareablePath31);
@@ -1271,7 +1283,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::obtainRenderablesFromOnPathSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnPathSymbol(
     const std::shared_ptr<RenderableOnPathSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     const auto& internalState = getInternalState();
@@ -1375,8 +1387,8 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::plotOnPathSymbol(
 }
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::applyVisibilityFiltering(
-    const IntersectionsQuadTree::BBox& visibleBBox,
-    const IntersectionsQuadTree& intersections,
+    const IntersectionsGrid::BBox& visibleBBox,
+    const IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     Stopwatch stopwatch(metric != nullptr);
@@ -1401,7 +1413,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyVisibilityFiltering(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::applyIntersectionWithOtherSymbolsFiltering(
     const std::shared_ptr<const RenderableSymbol>& renderable,
-    const IntersectionsQuadTree& intersections,
+    const IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     if (Q_UNLIKELY(debugSettings->skipSymbolsIntersectionCheck))
@@ -1426,7 +1438,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyIntersectionWithOtherSymbolsFilt
         : nullptr;
     const auto intersects = intersections.test(renderable->intersectionBBox, false,
         [symbolGroupPtr, symbolIntersectsWithClasses, symbolIntersectsWithAnyClass, anyIntersectionClass, symbolGroupInstancePtr, checkIntersectionsWithinGroup]
-        (const std::shared_ptr<const RenderableSymbol>& otherRenderable, const IntersectionsQuadTree::BBox& otherBBox) -> bool
+        (const std::shared_ptr<const RenderableSymbol>& otherRenderable, const IntersectionsGrid::BBox& otherBBox) -> bool
         {
             const auto& otherSymbol = otherRenderable->mapSymbol;
 
@@ -1475,7 +1487,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyIntersectionWithOtherSymbolsFilt
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::applyMinDistanceToSameContentFromOtherSymbolFiltering(
     const std::shared_ptr<const RenderableSymbol>& renderable,
-    const IntersectionsQuadTree& intersections,
+    const IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     if (Q_UNLIKELY(debugSettings->skipSymbolsMinDistanceToSameContentFromOtherSymbolCheck))
@@ -1496,7 +1508,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyMinDistanceToSameContentFromOthe
     const auto& symbolContent = symbol->content;
     const auto hasSimilarContent = intersections.test(renderable->intersectionBBox.getEnlargedBy(symbol->minDistance), false,
         [symbolContent, symbolGroupPtr, symbolGroupInstancePtr]
-        (const std::shared_ptr<const RenderableSymbol>& otherRenderable, const IntersectionsQuadTree::BBox& otherBBox) -> bool
+        (const std::shared_ptr<const RenderableSymbol>& otherRenderable, const IntersectionsGrid::BBox& otherBBox) -> bool
         {
             const auto otherSymbol = std::dynamic_pointer_cast<const RasterMapSymbol>(otherRenderable->mapSymbol);
             if (!otherSymbol)
@@ -1541,7 +1553,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage::applyMinDistanceToSameContentFromOthe
 
 bool OsmAnd::AtlasMapRendererSymbolsStage::addToIntersections(
     const std::shared_ptr<const RenderableSymbol>& renderable,
-    IntersectionsQuadTree& intersections,
+    IntersectionsGrid& intersections,
     AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const
 {
     if (Q_UNLIKELY(debugSettings->allSymbolsTransparentForIntersectionLookup))
@@ -2278,11 +2290,11 @@ void OsmAnd::AtlasMapRendererSymbolsStage::addIntersectionDebugBox(
 }
 
 void OsmAnd::AtlasMapRendererSymbolsStage::addIntersectionDebugBox(
-    const IntersectionsQuadTree::BBox intersectionBBox,
+    const IntersectionsGrid::BBox intersectionBBox,
     const ColorARGB color,
     const bool drawBorder /*= true*/) const
 {
-    if (intersectionBBox.type == IntersectionsQuadTree::BBoxType::AABB)
+    if (intersectionBBox.type == IntersectionsGrid::BBoxType::AABB)
     {
         const auto& boundsInWindow = intersectionBBox.asAABB;
 
@@ -2298,7 +2310,7 @@ void OsmAnd::AtlasMapRendererSymbolsStage::addIntersectionDebugBox(
             }, color.withAlpha(255).argb);
         }
     }
-    else /* if (intersectionBBox.type == IntersectionsQuadTree::BBoxType::OOBB) */
+    else /* if (intersectionBBox.type == IntersectionsGrid::BBoxType::OOBB) */
     {
         const auto& oobb = intersectionBBox.asOOBB;
 
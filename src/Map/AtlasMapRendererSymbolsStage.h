@@ -15,6 +15,7 @@
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "QuadTree.h"
+#include "UniformGrid.h"
 #include "AtlasMapRendererStage.h"
 #include "GPUAPI.h"
 
@@ -30,7 +31,9 @@ namespace OsmAnd
     {
     public:
         struct RenderableSymbol;
-        typedef QuadTree< std::shared_ptr<const RenderableSymbol>, AreaI::CoordType > IntersectionsQuadTree;
+        typedef UniformGrid< std::shared_ptr<const RenderableSymbol>, AreaI::CoordType > IntersectionsGrid;
+        // Side of grid cell, in pixels
+        static const AreaI::CoordType IntersectionsGridCellSize;
 
         struct RenderableSymbol
         {
@@ -42,7 +45,7 @@ namespace OsmAnd
 
             std::shared_ptr<const GPUAPI::ResourceInGPU> gpuResource;
             double distanceToCamera;
-            IntersectionsQuadTree::BBox intersectionBBox;
+            IntersectionsGrid::BBox intersectionBBox;
         };
 
         struct RenderableBillboardSymbol : RenderableSymbol
@@ -109,18 +112,21 @@ namespace OsmAnd
     private:
         bool obtainRenderableSymbols(
             QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
-            IntersectionsQuadTree& outIntersections,
+            IntersectionsGrid& outIntersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool obtainRenderableSymbols(
             const MapRenderer::PublishedMapSymbolsByOrder& mapSymbolsByOrder,
             QList< std::shared_ptr<const RenderableSymbol> >& outRenderableSymbols,
-            IntersectionsQuadTree& outIntersections,
+            IntersectionsGrid& outIntersections,
             MapRenderer::PublishedMapSymbolsByOrder* pOutAcceptedMapSymbolsByOrder,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         mutable MapRenderer::PublishedMapSymbolsByOrder _lastAcceptedMapSymbolsByOrder;
 
         mutable QReadWriteLock _lastPreparedIntersectionsLock;
-        IntersectionsQuadTree _lastPreparedIntersections;
+        IntersectionsGrid _lastPreparedIntersections;
+        // Grids are swapped on publishing, so the one published a frame before is refilled with
+        // its pools of entries kept
+        IntersectionsGrid _preparingIntersections;
 
         // Path calculations cache
         struct ComputedPathData
@@ -143,7 +149,7 @@ namespace OsmAnd
 
         bool plotSymbol(
             const std::shared_ptr<RenderableSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
 
         // Billboard symbols:
@@ -156,15 +162,15 @@ namespace OsmAnd
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotBillboardSymbol(
             const std::shared_ptr<RenderableBillboardSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotBillboardRasterSymbol(
             const std::shared_ptr<RenderableBillboardSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotBillboardVectorSymbol(
             const std::shared_ptr<RenderableBillboardSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
 
         // On-surface symbols:
@@ -177,15 +183,15 @@ namespace OsmAnd
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotOnSurfaceSymbol(
             const std::shared_ptr<RenderableOnSurfaceSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotOnSurfaceRasterSymbol(
             const std::shared_ptr<RenderableOnSurfaceSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotOnSurfaceVectorSymbol(
             const std::shared_ptr<RenderableOnSurfaceSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
 
         // On-path symbols:
@@ -199,25 +205,25 @@ namespace OsmAnd
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool plotOnPathSymbol(
             const std::shared_ptr<RenderableOnPathSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
 
         // Intersection-related:
         bool applyVisibilityFiltering(
-            const IntersectionsQuadTree::BBox& visibleBBox,
-            const IntersectionsQuadTree& intersections,
+            const IntersectionsGrid::BBox& visibleBBox,
+            const IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool applyIntersectionWithOtherSymbolsFiltering(
             const std::shared_ptr<const RenderableSymbol>& renderable,
-            const IntersectionsQuadTree& intersections,
+            const IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool applyMinDistanceToSameContentFromOtherSymbolFiltering(
             const std::shared_ptr<const RenderableSymbol>& renderable,
-            const IntersectionsQuadTree& intersections,
+            const IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
         bool addToIntersections(
             const std::shared_ptr<const RenderableSymbol>& renderable,
-            IntersectionsQuadTree& intersections,
+            IntersectionsGrid& intersections,
             AtlasMapRenderer_Metrics::Metric_renderFrame* const metric) const;
 
         // Utilities:
@@ -307,7 +313,7 @@ namespace OsmAnd
             const bool drawBorder = true) const;
 
         void addIntersectionDebugBox(
-            const IntersectionsQuadTree::BBox intersectionBBox,
+            const IntersectionsGrid::BBox intersectionBBox,
             const ColorARGB color,
             const bool drawBorder = true) const;
     protected:
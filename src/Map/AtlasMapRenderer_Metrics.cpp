@@ -25,6 +25,8 @@ QString OsmAnd::AtlasMapRenderer_Metrics::Metric_renderFrame::toString(const boo
     output += QLatin1String("\n") + prefix + QString(QLatin1String("~time/billboard-symbol-render = %1ms")).arg((elapsedTimeForBillboardSymbolsRendering / static_cast<float>(billboardSymbolsRendered)) * 1000.0f);
     output += QLatin1String("\n") + prefix + QString(QLatin1String("~time/on-path-symbol-render = %1ms")).arg((elapsedTimeForOnPathSymbolsRendering / static_cast<float>(onPathSymbolsRendered)) * 1000.0f);
     output += QLatin1String("\n") + prefix + QString(QLatin1String("~time/on-surface-symbol-render = %1ms")).arg((elapsedTimeForOnSurfaceSymbolsRendering / static_cast<float>(onSurfaceSymbolsRendered)) * 1000.0f);
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("~draw-calls/symbol = %1")).arg(static_cast<float>(symbolsDrawCalls) / static_cast<float>(billboardSymbolsRendered + onPathSymbolsRendered + onSurfaceSymbolsRendered));
+    output += QLatin1String("\n") + prefix + QString(QLatin1String("~quads/batched-draw-call = %1")).arg(static_cast<float>(symbolsBatchedQuads) / static_cast<float>(symbolsBatchedDrawCalls));
     output += QLatin1String("\n") + IMapRenderer_Metrics::Metric_renderFrame::toString(shortFormat, prefix);
 
     return output;
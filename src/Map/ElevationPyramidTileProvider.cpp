@@ -0,0 +1,72 @@
+#include "ElevationPyramidTileProvider.h"
+#include "ElevationPyramidTileProvider_P.h"
+
+const uint32_t OsmAnd::ElevationPyramidTileProvider::defaultTileSize = 32;
+
+OsmAnd::ElevationPyramidTileProvider::ElevationPyramidTileProvider(const QString& filename_)
+    : _p(new ElevationPyramidTileProvider_P(this))
+    , filename(filename_)
+{
+    _p->open();
+}
+
+OsmAnd::ElevationPyramidTileProvider::~ElevationPyramidTileProvider()
+{
+}
+
+bool OsmAnd::ElevationPyramidTileProvider::isValid() const
+{
+    return _p->isValid();
+}
+
+OsmAnd::ElevationPyramidTileProvider::Encoding OsmAnd::ElevationPyramidTileProvider::getEncoding() const
+{
+    return _p->getEncoding();
+}
+
+OsmAnd::ZoomLevel OsmAnd::ElevationPyramidTileProvider::getMinZoom() const
+{
+    return _p->getMinZoom();
+}
+
+OsmAnd::ZoomLevel OsmAnd::ElevationPyramidTileProvider::getMaxZoom() const
+{
+    return _p->getMaxZoom();
+}
+
+uint32_t OsmAnd::ElevationPyramidTileProvider::getTileSize() const
+{
+    return _p->getTileSize();
+}
+
+bool OsmAnd::ElevationPyramidTileProvider::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    std::shared_ptr<IMapTiledDataProvider::Data>& outTiledData,
+    std::shared_ptr<Metric>* pOutMetric /*= nullptr*/,
+    const IQueryController* const queryController /*= nullptr*/)
+{
+    if (pOutMetric)
+        pOutMetric->reset();
+
+    std::shared_ptr<Data> tiledData;
+    const auto result = _p->obtainData(tileId, zoom, tiledData, queryController);
+    outTiledData = tiledData;
+
+    return result;
+}
+
+bool OsmAnd::ElevationPyramidTileProvider::convertFromTileDB(
+    const QString& tileDbDataPath,
+    const QString& tileDbIndexFilename,
+    const QString& outputFilename,
+    const Encoding encoding /*= Encoding::Float32*/,
+    const ZoomLevel minZoom /*= MinZoomLevel*/)
+{
+    return ElevationPyramidTileProvider_P::convertFromTileDB(
+        tileDbDataPath,
+        tileDbIndexFilename,
+        outputFilename,
+        encoding,
+        minZoom);
+}
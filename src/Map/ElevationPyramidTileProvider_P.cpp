@@ -0,0 +1,468 @@
+#include "ElevationPyramidTileProvider_P.h"
+#include "ElevationPyramidTileProvider.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <cmath>
+
+#include "QtExtensions.h"
+#include <QDir>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include "TileDB.h"
+#include "HeightmapTileProvider_P.h"
+#include "QKeyValueIterator.h"
+#include "Logging.h"
+
+// 'OEPY' in native (little-endian) byte order
+const uint32_t OsmAnd::ElevationPyramidTileProvider_P::Signature = 0x5950454F;
+const uint32_t OsmAnd::ElevationPyramidTileProvider_P::Version = 1;
+const uint32_t OsmAnd::ElevationPyramidTileProvider_P::DataAlignment = 16;
+
+OsmAnd::ElevationPyramidTileProvider_P::ElevationPyramidTileProvider_P(ElevationPyramidTileProvider* const owner_)
+    : _tileSize(0)
+    , _encoding(Encoding::Float32)
+    , _tileStride(0)
+    , _minZoom(InvalidZoom)
+    , _maxZoom(InvalidZoom)
+    , owner(owner_)
+{
+}
+
+OsmAnd::ElevationPyramidTileProvider_P::~ElevationPyramidTileProvider_P()
+{
+}
+
+static inline size_t alignedSize(const size_t size, const size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static inline size_t tileStrideFor(const OsmAnd::ElevationPyramidTileProvider::Encoding encoding, const uint32_t tileSize)
+{
+    const auto samplesCount = tileSize * tileSize;
+    if (encoding == OsmAnd::ElevationPyramidTileProvider::Encoding::QuantizedInt16)
+    {
+        return alignedSize(
+            sizeof(OsmAnd::ElevationPyramidTileProvider_P::QuantizedTileHeader) + samplesCount * sizeof(int16_t),
+            sizeof(float));
+    }
+    return samplesCount * sizeof(float);
+}
+
+bool OsmAnd::ElevationPyramidTileProvider_P::open()
+{
+    const std::shared_ptr<MappedFile> mappedFile(new MappedFile(owner->filename));
+    if (!mappedFile->pMemory)
+        return false;
+
+    if (mappedFile->size < static_cast<qint64>(sizeof(FileHeader)))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Elevation pyramid '%s' is truncated", qPrintable(owner->filename));
+        return false;
+    }
+    const auto pHeader = reinterpret_cast<const FileHeader*>(mappedFile->pMemory);
+    if (pHeader->signature != Signature || pHeader->version != Version)
+    {
+        LogPrintf(LogSeverityLevel::Error, "'%s' is not an elevation pyramid of version %d", qPrintable(owner->filename), Version);
+        return false;
+    }
+    if (pHeader->encoding != static_cast<uint32_t>(Encoding::Float32) &&
+        pHeader->encoding != static_cast<uint32_t>(Encoding::QuantizedInt16))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Elevation pyramid '%s' has unknown encoding %d", qPrintable(owner->filename), pHeader->encoding);
+        return false;
+    }
+    const auto encoding = static_cast<Encoding>(pHeader->encoding);
+    const auto tileStride = tileStrideFor(encoding, pHeader->tileSize);
+
+    const auto levelsTableSize = pHeader->levelsCount * sizeof(LevelHeader);
+    if (mappedFile->size < static_cast<qint64>(sizeof(FileHeader) + levelsTableSize))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Elevation pyramid '%s' is truncated", qPrintable(owner->filename));
+        return false;
+    }
+
+    QVector<Level> levels;
+    levels.reserve(pHeader->levelsCount);
+    auto pLevelHeader = reinterpret_cast<const LevelHeader*>(mappedFile->pMemory + sizeof(FileHeader));
+    for (auto levelIdx = 0u; levelIdx < pHeader->levelsCount; levelIdx++, pLevelHeader++)
+    {
+        const auto indexEnd = pLevelHeader->indexOffset + pLevelHeader->tilesCount * sizeof(uint64_t);
+        const auto dataEnd = pLevelHeader->dataOffset + pLevelHeader->tilesCount * tileStride;
+        if (pLevelHeader->zoom > static_cast<uint32_t>(MaxZoomLevel) ||
+            pLevelHeader->indexOffset % DataAlignment != 0 || pLevelHeader->dataOffset % DataAlignment != 0 ||
+            indexEnd > static_cast<uint64_t>(mappedFile->size) || dataEnd > static_cast<uint64_t>(mappedFile->size))
+        {
+            LogPrintf(LogSeverityLevel::Error, "Elevation pyramid '%s' has corrupted level #%d", qPrintable(owner->filename), levelIdx);
+            return false;
+        }
+
+        Level level;
+        level.zoom = static_cast<ZoomLevel>(pLevelHeader->zoom);
+        level.tilesCount = pLevelHeader->tilesCount;
+        level.pIndex = reinterpret_cast<const uint64_t*>(mappedFile->pMemory + pLevelHeader->indexOffset);
+        level.pData = mappedFile->pMemory + pLevelHeader->dataOffset;
+        levels.push_back(level);
+    }
+    std::sort(levels.begin(), levels.end(),
+        []
+        (const Level& l, const Level& r) -> bool
+        {
+            return l.zoom < r.zoom;
+        });
+
+    _mappedFile = mappedFile;
+    _tileSize = pHeader->tileSize;
+    _encoding = encoding;
+    _tileStride = tileStride;
+    _levels = levels;
+    _minZoom = levels.isEmpty() ? InvalidZoom : levels.first().zoom;
+    _maxZoom = levels.isEmpty() ? InvalidZoom : levels.last().zoom;
+
+    return true;
+}
+
+bool OsmAnd::ElevationPyramidTileProvider_P::isValid() const
+{
+    return static_cast<bool>(_mappedFile);
+}
+
+OsmAnd::ElevationPyramidTileProvider_P::Encoding OsmAnd::ElevationPyramidTileProvider_P::getEncoding() const
+{
+    return _encoding;
+}
+
+OsmAnd::ZoomLevel OsmAnd::ElevationPyramidTileProvider_P::getMinZoom() const
+{
+    return _minZoom;
+}
+
+OsmAnd::ZoomLevel OsmAnd::ElevationPyramidTileProvider_P::getMaxZoom() const
+{
+    return _maxZoom;
+}
+
+uint32_t OsmAnd::ElevationPyramidTileProvider_P::getTileSize() const
+{
+    return _tileSize;
+}
+
+const OsmAnd::ElevationPyramidTileProvider_P::Level* OsmAnd::ElevationPyramidTileProvider_P::findLevel(const ZoomLevel zoom) const
+{
+    for (const auto& level : constOf(_levels))
+    {
+        if (level.zoom == zoom)
+            return &level;
+    }
+    return nullptr;
+}
+
+bool OsmAnd::ElevationPyramidTileProvider_P::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    std::shared_ptr<ElevationPyramidTileProvider::Data>& outTiledData,
+    const IQueryController* const queryController)
+{
+    Q_UNUSED(queryController);
+
+    if (!_mappedFile)
+        return false;
+
+    // Absence of level or tile means there's no data, so mark tile as empty
+    const auto pLevel = findLevel(zoom);
+    if (!pLevel)
+    {
+        outTiledData.reset();
+        return true;
+    }
+    const auto pIndexEnd = pLevel->pIndex + pLevel->tilesCount;
+    const auto pIndexEntry = std::lower_bound(pLevel->pIndex, pIndexEnd, tileId.id);
+    if (pIndexEntry == pIndexEnd || *pIndexEntry != tileId.id)
+    {
+        outTiledData.reset();
+        return true;
+    }
+    const auto pTile = pLevel->pData + (pIndexEntry - pLevel->pIndex) * _tileStride;
+
+    if (_encoding == Encoding::Float32)
+    {
+        outTiledData.reset(new MappedData(
+            tileId,
+            zoom,
+            _tileSize,
+            reinterpret_cast<const float*>(pTile),
+            _mappedFile));
+        return true;
+    }
+
+    const auto pQuantizedHeader = reinterpret_cast<const QuantizedTileHeader*>(pTile);
+    const auto pQuantizedSamples = reinterpret_cast<const int16_t*>(pTile + sizeof(QuantizedTileHeader));
+    const auto samplesCount = _tileSize * _tileSize;
+    const auto buffer = new float[samplesCount];
+    for (auto sampleIdx = 0u; sampleIdx < samplesCount; sampleIdx++)
+        buffer[sampleIdx] = pQuantizedHeader->base + pQuantizedSamples[sampleIdx] * pQuantizedHeader->scale;
+
+    outTiledData.reset(new IMapElevationDataProvider::Data(
+        tileId,
+        zoom,
+        sizeof(float)*_tileSize,
+        _tileSize,
+        buffer));
+    return true;
+}
+
+void OsmAnd::ElevationPyramidTileProvider_P::downsample(
+    const QVector<const float*>& children,
+    const uint32_t tileSize,
+    float* const outSamples)
+{
+    // Children are ordered as top-left, top-right, bottom-left, bottom-right. Parent spans 2*(N-1) intervals of
+    // children samples using N-1 own intervals, so each parent sample lands exactly on a sample of some child.
+    const auto intervals = tileSize - 1;
+    for (auto row = 0u; row < tileSize; row++)
+    {
+        const auto mosaicY = 2 * row;
+        const auto childY = mosaicY <= intervals ? 0u : 1u;
+        const auto localY = mosaicY - childY * intervals;
+
+        for (auto col = 0u; col < tileSize; col++)
+        {
+            const auto mosaicX = 2 * col;
+            const auto childX = mosaicX <= intervals ? 0u : 1u;
+            const auto localX = mosaicX - childX * intervals;
+
+            const auto pChild = children[childY * 2 + childX];
+            outSamples[row * tileSize + col] = pChild ? pChild[localY * tileSize + localX] : 0.0f;
+        }
+    }
+}
+
+bool OsmAnd::ElevationPyramidTileProvider_P::convertFromTileDB(
+    const QString& tileDbDataPath,
+    const QString& tileDbIndexFilename,
+    const QString& outputFilename,
+    const Encoding encoding,
+    const ZoomLevel minZoom)
+{
+    const auto tileSize = ElevationPyramidTileProvider::defaultTileSize;
+    const auto samplesCount = tileSize * tileSize;
+    const auto tileStride = tileStrideFor(encoding, tileSize);
+
+    TileDB tileDb(QDir(tileDbDataPath), tileDbIndexFilename);
+    QList< std::pair<TileId, ZoomLevel> > storedTiles;
+    if (!tileDb.obtainTilesList(storedTiles))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to list tiles of '%s' tiledb", qPrintable(tileDbDataPath));
+        return false;
+    }
+
+    // Collect identifiers of tiles for each level. Levels that are missing in TileDB are derived from next level
+    QMap< ZoomLevel, QSet<uint64_t> > tilesIdsByZoom;
+    for (const auto& storedTile : constOf(storedTiles))
+        tilesIdsByZoom[storedTile.second].insert(storedTile.first.id);
+    if (tilesIdsByZoom.isEmpty())
+    {
+        LogPrintf(LogSeverityLevel::Error, "Tiledb '%s' contains no tiles", qPrintable(tileDbDataPath));
+        return false;
+    }
+    const auto storedZooms = tilesIdsByZoom.keys().toSet();
+    const auto maxZoom = tilesIdsByZoom.lastKey();
+    for (int zoom = maxZoom - 1; zoom >= minZoom; zoom--)
+    {
+        if (storedZooms.contains(static_cast<ZoomLevel>(zoom)))
+            continue;
+
+        auto& parentTilesIds = tilesIdsByZoom[static_cast<ZoomLevel>(zoom)];
+        for (const auto childTileIdValue : constOf(tilesIdsByZoom[static_cast<ZoomLevel>(zoom + 1)]))
+        {
+            TileId childTileId;
+            childTileId.id = childTileIdValue;
+            TileId parentTileId;
+            parentTileId.x = childTileId.x >> 1;
+            parentTileId.y = childTileId.y >> 1;
+            parentTilesIds.insert(parentTileId.id);
+        }
+    }
+
+    // Compute layout: header, levels table, then index and data of each level
+    QMap< ZoomLevel, QVector<uint64_t> > sortedTilesIdsByZoom;
+    QMap< ZoomLevel, LevelHeader > levelHeaders;
+    uint64_t offset = sizeof(FileHeader) + tilesIdsByZoom.size() * sizeof(LevelHeader);
+    for (const auto& itTilesIds : rangeOf(constOf(tilesIdsByZoom)))
+    {
+        auto sortedTilesIds = itTilesIds.value().toList().toVector();
+        std::sort(sortedTilesIds.begin(), sortedTilesIds.end());
+
+        LevelHeader levelHeader;
+        levelHeader.zoom = itTilesIds.key();
+        levelHeader.tilesCount = sortedTilesIds.size();
+        offset = alignedSize(offset, DataAlignment);
+        levelHeader.indexOffset = offset;
+        offset += levelHeader.tilesCount * sizeof(uint64_t);
+        offset = alignedSize(offset, DataAlignment);
+        levelHeader.dataOffset = offset;
+        offset += levelHeader.tilesCount * tileStride;
+
+        levelHeaders.insert(itTilesIds.key(), levelHeader);
+        sortedTilesIdsByZoom.insert(itTilesIds.key(), sortedTilesIds);
+    }
+
+    QFile output(outputFilename);
+    if (!output.open(QIODevice::ReadWrite | QIODevice::Truncate) || !output.resize(offset))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to create elevation pyramid '%s': %s", qPrintable(outputFilename), qPrintable(output.errorString()));
+        return false;
+    }
+
+    FileHeader fileHeader;
+    fileHeader.signature = Signature;
+    fileHeader.version = Version;
+    fileHeader.tileSize = tileSize;
+    fileHeader.encoding = static_cast<uint32_t>(encoding);
+    fileHeader.levelsCount = levelHeaders.size();
+    fileHeader.reserved = 0;
+    bool ok = output.write(reinterpret_cast<const char*>(&fileHeader), sizeof(FileHeader)) == sizeof(FileHeader);
+    for (const auto& levelHeader : constOf(levelHeaders))
+        ok = ok && output.write(reinterpret_cast<const char*>(&levelHeader), sizeof(LevelHeader)) == sizeof(LevelHeader);
+
+    // Process levels from most detailed one, since less detailed ones may be derived from it
+    QHash< uint64_t, QVector<float> > previousLevelTiles;
+    QByteArray encodedTile(static_cast<int>(tileStride), 0);
+    for (int zoom = maxZoom; ok && zoom >= MinZoomLevel; zoom--)
+    {
+        const auto levelZoom = static_cast<ZoomLevel>(zoom);
+        if (!levelHeaders.contains(levelZoom))
+        {
+            previousLevelTiles.clear();
+            continue;
+        }
+        const auto& levelHeader = levelHeaders[levelZoom];
+        const auto& sortedTilesIds = sortedTilesIdsByZoom[levelZoom];
+
+        ok = output.seek(levelHeader.indexOffset);
+        ok = ok && output.write(
+            reinterpret_cast<const char*>(sortedTilesIds.constData()),
+            sortedTilesIds.size() * sizeof(uint64_t)) == static_cast<qint64>(sortedTilesIds.size() * sizeof(uint64_t));
+        ok = ok && output.seek(levelHeader.dataOffset);
+
+        const bool isStored = storedZooms.contains(levelZoom);
+        QHash< uint64_t, QVector<float> > levelTiles;
+        for (const auto tileIdValue : constOf(sortedTilesIds))
+        {
+            if (!ok)
+                break;
+
+            TileId tileId;
+            tileId.id = tileIdValue;
+            QVector<float> samples(samplesCount, 0.0f);
+
+            if (isStored)
+            {
+                QByteArray data;
+                if (!tileDb.obtainTileData(tileId, levelZoom, data) ||
+                    !HeightmapTileProvider_P::decodeTileData(data, tileId, levelZoom, tileSize, samples.data()))
+                {
+                    LogPrintf(LogSeverityLevel::Warning, "Height tile %dx%d@%d can not be decoded, stored as flat", tileId.x, tileId.y, zoom);
+                    samples.fill(0.0f);
+                }
+            }
+            else
+            {
+                QVector<const float*> children(4, nullptr);
+                for (auto childIdx = 0; childIdx < 4; childIdx++)
+                {
+                    TileId childTileId;
+                    childTileId.x = (tileId.x << 1) + (childIdx % 2);
+                    childTileId.y = (tileId.y << 1) + (childIdx / 2);
+                    const auto citChild = previousLevelTiles.constFind(childTileId.id);
+                    if (citChild != previousLevelTiles.cend())
+                        children[childIdx] = citChild->constData();
+                }
+                downsample(children, tileSize, samples.data());
+            }
+
+            if (encoding == Encoding::Float32)
+            {
+                memcpy(encodedTile.data(), samples.constData(), samplesCount * sizeof(float));
+            }
+            else
+            {
+                const auto minMax = std::minmax_element(samples.cbegin(), samples.cend());
+                const auto pQuantizedHeader = reinterpret_cast<QuantizedTileHeader*>(encodedTile.data());
+                const auto pQuantizedSamples = reinterpret_cast<int16_t*>(encodedTile.data() + sizeof(QuantizedTileHeader));
+                pQuantizedHeader->base = (*minMax.first + *minMax.second) * 0.5f;
+                pQuantizedHeader->scale = (*minMax.second - *minMax.first) / 65534.0f;
+                for (auto sampleIdx = 0u; sampleIdx < samplesCount; sampleIdx++)
+                {
+                    pQuantizedSamples[sampleIdx] = pQuantizedHeader->scale > 0.0f
+                        ? static_cast<int16_t>(qRound((samples[sampleIdx] - pQuantizedHeader->base) / pQuantizedHeader->scale))
+                        : 0;
+                }
+            }
+            ok = output.write(encodedTile) == encodedTile.size();
+
+            levelTiles.insert(tileIdValue, samples);
+        }
+
+        previousLevelTiles = levelTiles;
+    }
+    output.close();
+
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to write elevation pyramid '%s'", qPrintable(outputFilename));
+        QFile::remove(outputFilename);
+        return false;
+    }
+
+    return true;
+}
+
+OsmAnd::ElevationPyramidTileProvider_P::MappedFile::MappedFile(const QString& filename)
+    : file(filename)
+    , pMemory(nullptr)
+    , size(0)
+{
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open elevation pyramid '%s': %s", qPrintable(filename), qPrintable(file.errorString()));
+        return;
+    }
+
+    size = file.size();
+    pMemory = file.map(0, size);
+    if (!pMemory)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to map elevation pyramid '%s': %s", qPrintable(filename), qPrintable(file.errorString()));
+        file.close();
+    }
+}
+
+OsmAnd::ElevationPyramidTileProvider_P::MappedFile::~MappedFile()
+{
+    if (pMemory)
+        file.unmap(const_cast<uchar*>(pMemory));
+    file.close();
+}
+
+OsmAnd::ElevationPyramidTileProvider_P::MappedData::MappedData(
+    const TileId tileId_,
+    const ZoomLevel zoom_,
+    const uint32_t tileSize_,
+    const float* const pSamples_,
+    const std::shared_ptr<const MappedFile>& mappedFile_)
+    : IMapElevationDataProvider::Data(tileId_, zoom_, sizeof(float)*tileSize_, tileSize_, pSamples_)
+    , mappedFile(mappedFile_)
+{
+}
+
+OsmAnd::ElevationPyramidTileProvider_P::MappedData::~MappedData()
+{
+    // Samples belong to mapped file, so prevent base class from deleting them
+    pRawData = nullptr;
+
+    release();
+}
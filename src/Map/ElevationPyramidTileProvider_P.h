@@ -0,0 +1,139 @@
+#ifndef _OSMAND_CORE_ELEVATION_PYRAMID_TILE_PROVIDER_P_H_
+#define _OSMAND_CORE_ELEVATION_PYRAMID_TILE_PROVIDER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include <QFile>
+#include <QVector>
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "IMapElevationDataProvider.h"
+#include "ElevationPyramidTileProvider.h"
+
+namespace OsmAnd
+{
+    class ElevationPyramidTileProvider_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(ElevationPyramidTileProvider_P);
+    public:
+        typedef ElevationPyramidTileProvider::Encoding Encoding;
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t signature;
+            uint32_t version;
+            uint32_t tileSize;
+            uint32_t encoding;
+            uint32_t levelsCount;
+            uint32_t reserved;
+        };
+
+        struct LevelHeader
+        {
+            uint32_t zoom;
+            uint32_t tilesCount;
+            uint64_t indexOffset;
+            uint64_t dataOffset;
+        };
+
+        // Prefix of each QuantizedInt16 tile: height = base + sample * scale
+        struct QuantizedTileHeader
+        {
+            float base;
+            float scale;
+        };
+#pragma pack(pop)
+
+        static const uint32_t Signature;
+        static const uint32_t Version;
+        static const uint32_t DataAlignment;
+
+        struct Level
+        {
+            ZoomLevel zoom;
+            uint32_t tilesCount;
+            const uint64_t* pIndex;
+            const uint8_t* pData;
+        };
+
+        // Mapped file has to outlive every tile data handed out as a slice of it
+        struct MappedFile
+        {
+            MappedFile(const QString& filename);
+            ~MappedFile();
+
+            QFile file;
+            const uint8_t* pMemory;
+            qint64 size;
+        };
+
+        // Data that references mapped memory instead of owning a buffer
+        class MappedData : public IMapElevationDataProvider::Data
+        {
+            Q_DISABLE_COPY_AND_MOVE(MappedData);
+        private:
+        protected:
+        public:
+            MappedData(
+                const TileId tileId,
+                const ZoomLevel zoom,
+                const uint32_t tileSize,
+                const float* const pSamples,
+                const std::shared_ptr<const MappedFile>& mappedFile);
+            virtual ~MappedData();
+
+            const std::shared_ptr<const MappedFile> mappedFile;
+        };
+
+    private:
+        std::shared_ptr<const MappedFile> _mappedFile;
+        uint32_t _tileSize;
+        Encoding _encoding;
+        size_t _tileStride;
+        QVector<Level> _levels;
+        ZoomLevel _minZoom;
+        ZoomLevel _maxZoom;
+
+        const Level* findLevel(const ZoomLevel zoom) const;
+
+        static void downsample(
+            const QVector<const float*>& children,
+            const uint32_t tileSize,
+            float* const outSamples);
+    protected:
+        ElevationPyramidTileProvider_P(ElevationPyramidTileProvider* const owner);
+
+        bool open();
+    public:
+        ~ElevationPyramidTileProvider_P();
+
+        ImplementationInterface<ElevationPyramidTileProvider> owner;
+
+        bool isValid() const;
+        Encoding getEncoding() const;
+
+        ZoomLevel getMinZoom() const;
+        ZoomLevel getMaxZoom() const;
+        uint32_t getTileSize() const;
+        bool obtainData(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            std::shared_ptr<ElevationPyramidTileProvider::Data>& outTiledData,
+            const IQueryController* const queryController);
+
+        static bool convertFromTileDB(
+            const QString& tileDbDataPath,
+            const QString& tileDbIndexFilename,
+            const QString& outputFilename,
+            const Encoding encoding,
+            const ZoomLevel minZoom);
+
+    friend class OsmAnd::ElevationPyramidTileProvider;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ELEVATION_PYRAMID_TILE_PROVIDER_P_H_)
@@ -2,6 +2,7 @@
 
 #include <cassert>
 
+#include "QtCommon.h"
 #include "Logging.h"
 
 OsmAnd::GPUAPI::GPUAPI()
@@ -57,10 +58,175 @@ std::shared_ptr<OsmAnd::GPUAPI::SlotOnAtlasTextureInGPU> OsmAnd::GPUAPI::allocat
     return pool->allocateTile(alphaChannelType, atlasTextureAllocator);
 }
 
+std::shared_ptr<OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU> OsmAnd::GPUAPI::allocateAreaOnSymbolsAtlasTexture(
+    const TextureFormat textureFormat,
+    const AlphaChannelType alphaChannelType,
+    const PointI& size,
+    SymbolsAtlasTextureAllocator symbolsAtlasTextureAllocator)
+{
+    QMutexLocker scopedLocker(&_symbolsAtlasTexturesMutex);
+
+    // Only bitmaps of the same format and alpha channel type may share atlas
+    const auto key = (static_cast<uint64_t>(textureFormat) << 32) | static_cast<uint64_t>(alphaChannelType);
+    auto& atlasTextures = _symbolsAtlasTextures[key];
+
+    const PointI paddedSize(
+        size.x + 2 * SymbolsAtlasTextureInGPU::AreaPadding,
+        size.y + 2 * SymbolsAtlasTextureInGPU::AreaPadding);
+    AreaI allocatedArea;
+
+    // Look for space on existing atlases, forgetting ones that were released
+    auto itAtlasTexture = mutableIteratorOf(atlasTextures);
+    while (itAtlasTexture.hasNext())
+    {
+        const auto atlasTexture = itAtlasTexture.next().lock();
+        if (!atlasTexture)
+        {
+            itAtlasTexture.remove();
+            continue;
+        }
+
+        if (atlasTexture->allocateArea(paddedSize, allocatedArea))
+        {
+            const auto areaInGPU = std::make_shared<AreaOnSymbolsAtlasTextureInGPU>(atlasTexture, allocatedArea);
+            atlasTexture->attachArea(areaInGPU);
+            return areaInGPU;
+        }
+    }
+
+    const std::shared_ptr<SymbolsAtlasTextureInGPU> atlasTexture(symbolsAtlasTextureAllocator());
+    if (!atlasTexture || !atlasTexture->allocateArea(paddedSize, allocatedArea))
+        return nullptr;
+    atlasTextures.push_back(atlasTexture);
+
+    const auto areaInGPU = std::make_shared<AreaOnSymbolsAtlasTextureInGPU>(atlasTexture, allocatedArea);
+    atlasTexture->attachArea(areaInGPU);
+    return areaInGPU;
+}
+
+unsigned int OsmAnd::GPUAPI::migrateSymbolsAtlasAreas(
+    const unsigned int maxAreasToMigrate,
+    SymbolsAtlasAreaCopier symbolsAtlasAreaCopier)
+{
+    QMutexLocker scopedLocker(&_symbolsAtlasTexturesMutex);
+
+    unsigned int areasMigrated = 0;
+    for (auto& atlasTextures : _symbolsAtlasTextures)
+    {
+        if (areasMigrated >= maxAreasToMigrate)
+            break;
+
+        QList< std::shared_ptr<SymbolsAtlasTextureInGPU> > liveAtlasTextures;
+        for (const auto& atlasTextureWeak : constOf(atlasTextures))
+        {
+            if (const auto atlasTexture = atlasTextureWeak.lock())
+                liveAtlasTextures.push_back(atlasTexture);
+        }
+        if (liveAtlasTextures.size() < 2)
+            continue;
+
+        // All atlases of the same format are either compactable or not
+        if (!liveAtlasTextures.first()->compactable)
+            continue;
+
+        // Drain the least occupied atlas, if it's sparse enough
+        std::shared_ptr<SymbolsAtlasTextureInGPU> sourceAtlasTexture;
+        float minOccupancy = SymbolsAtlasTextureInGPU::CompactionOccupancyThreshold;
+        for (const auto& atlasTexture : constOf(liveAtlasTextures))
+        {
+            const auto occupancy = static_cast<float>(
+                static_cast<double>(atlasTexture->getOccupiedTexelsCount()) / (atlasTexture->width * atlasTexture->height));
+            if (occupancy >= minOccupancy)
+                continue;
+
+            minOccupancy = occupancy;
+            sourceAtlasTexture = atlasTexture;
+        }
+        if (!sourceAtlasTexture)
+            continue;
+
+        // Drained atlas goes last, so that new areas are allocated on other atlases first
+        liveAtlasTextures.removeOne(sourceAtlasTexture);
+        atlasTextures.clear();
+        for (const auto& atlasTexture : constOf(liveAtlasTextures))
+            atlasTextures.push_back(atlasTexture);
+        atlasTextures.push_back(sourceAtlasTexture);
+
+        const auto areas = sourceAtlasTexture->getAreas();
+        for (const auto& areaInGPU : constOf(areas))
+        {
+            if (areasMigrated >= maxAreasToMigrate)
+                break;
+
+            const auto sourceArea = areaInGPU->getAllocatedArea();
+            std::shared_ptr<SymbolsAtlasTextureInGPU> destinationAtlasTexture;
+            AreaI destinationArea;
+            for (const auto& atlasTexture : constOf(liveAtlasTextures))
+            {
+                if (!atlasTexture->allocateArea(PointI(sourceArea.width(), sourceArea.height()), destinationArea))
+                    continue;
+
+                destinationAtlasTexture = atlasTexture;
+                break;
+            }
+
+            // If other atlases are full as well, there's nothing to gain by now
+            if (!destinationAtlasTexture)
+                break;
+
+            if (!symbolsAtlasAreaCopier(sourceAtlasTexture, sourceArea, destinationAtlasTexture, destinationArea))
+            {
+                destinationAtlasTexture->releaseArea(destinationArea);
+                break;
+            }
+
+            sourceAtlasTexture->detachArea(areaInGPU.get());
+            sourceAtlasTexture->releaseArea(sourceArea);
+            areaInGPU->setLocation(destinationAtlasTexture, destinationArea);
+            destinationAtlasTexture->attachArea(areaInGPU);
+
+            areasMigrated++;
+        }
+    }
+
+    return areasMigrated;
+}
+
+OsmAnd::GPUAPI::AtlasTexturesStatistics OsmAnd::GPUAPI::getSymbolsAtlasTexturesStatistics() const
+{
+    QMutexLocker scopedLocker(&_symbolsAtlasTexturesMutex);
+
+    AtlasTexturesStatistics statistics;
+    for (const auto& atlasTextures : constOf(_symbolsAtlasTextures))
+    {
+        for (const auto& atlasTextureWeak : constOf(atlasTextures))
+        {
+            if (const auto atlasTexture = atlasTextureWeak.lock())
+                atlasTexture->collectStatistics(statistics);
+        }
+    }
+
+    return statistics;
+}
+
+void OsmAnd::GPUAPI::countUploadedBytes(const size_t bytes)
+{
+    _uploadedBytesCounter.fetchAndAddOrdered(static_cast<qint64>(bytes));
+}
+
+size_t OsmAnd::GPUAPI::takeUploadedBytesCount()
+{
+    return static_cast<size_t>(_uploadedBytesCounter.fetchAndStoreOrdered(0));
+}
+
 OsmAnd::AlphaChannelType OsmAnd::GPUAPI::getGpuResourceAlphaChannelType(const std::shared_ptr<const ResourceInGPU> gpuResource)
 {
     if (gpuResource->type == ResourceInGPU::Type::SlotOnAtlasTexture)
         return std::static_pointer_cast<const SlotOnAtlasTextureInGPU>(gpuResource)->alphaChannelType;
+    else if (gpuResource->type == ResourceInGPU::Type::SdfGlyphs)
+        return AlphaChannelType::Straight;
+    else if (gpuResource->type == ResourceInGPU::Type::AreaOnSymbolsAtlasTexture)
+        return std::static_pointer_cast<const AreaOnSymbolsAtlasTextureInGPU>(gpuResource)->getAtlasTexture()->alphaChannelType;
     else //if (gpuResource->type == ResourceInGPU::Type::Texture)
         return std::static_pointer_cast<const TextureInGPU>(gpuResource)->alphaChannelType;
 }
@@ -326,3 +492,280 @@ OsmAnd::GPUAPI::MeshInGPU::MeshInGPU(
 OsmAnd::GPUAPI::MeshInGPU::~MeshInGPU()
 {
 }
+
+OsmAnd::GPUAPI::SdfGlyphsInGPU::SdfGlyphsInGPU(
+    GPUAPI* api_,
+    const QVector< std::shared_ptr<const TextureInGPU> >& pagesTextures_)
+    : MetaResourceInGPU(Type::SdfGlyphs, api_)
+    , pagesTextures(pagesTextures_)
+{
+}
+
+OsmAnd::GPUAPI::SdfGlyphsInGPU::~SdfGlyphsInGPU()
+{
+}
+
+OsmAnd::GPUAPI::AtlasTexturesStatistics::AtlasTexturesStatistics()
+    : atlasTexturesCount(0)
+    , areasCount(0)
+    , texelsCount(0)
+    , occupiedTexelsCount(0)
+    , fragmentedTexelsCount(0)
+{
+}
+
+float OsmAnd::GPUAPI::AtlasTexturesStatistics::getOccupancy() const
+{
+    if (texelsCount == 0)
+        return 0.0f;
+    return static_cast<float>(static_cast<double>(occupiedTexelsCount) / texelsCount);
+}
+
+float OsmAnd::GPUAPI::AtlasTexturesStatistics::getFragmentation() const
+{
+    const auto unoccupiedTexelsCount = texelsCount - occupiedTexelsCount;
+    if (unoccupiedTexelsCount == 0)
+        return 0.0f;
+    return static_cast<float>(static_cast<double>(fragmentedTexelsCount) / unoccupiedTexelsCount);
+}
+
+const int OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::AreaPadding = 1;
+const float OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::CompactionOccupancyThreshold = 0.5f;
+
+OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::SymbolsAtlasTextureInGPU(
+    GPUAPI* api_,
+    const RefInGPU& refInGPU_,
+    const unsigned int textureSize_,
+    const AlphaChannelType alphaChannelType_,
+    const bool compactable_)
+    : TextureInGPU(api_, refInGPU_, textureSize_, textureSize_, 1, alphaChannelType_)
+    , _shelvesBottom(0)
+    , _areasCount(0)
+    , _occupiedTexelsCount(0)
+    , compactable(compactable_)
+{
+}
+
+OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::~SymbolsAtlasTextureInGPU()
+{
+    if (_areasCount > 0)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "By the time of symbols atlas texture destruction, it still contained %d allocated areas",
+            _areasCount);
+    }
+    assert(_areasCount == 0);
+}
+
+bool OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::allocateArea(const PointI& size, AreaI& outArea)
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    if (size.x <= 0 || size.y <= 0 || size.x > static_cast<int>(width) || size.y > static_cast<int>(height))
+        return false;
+
+    // Take the lowest shelf that fits, but don't waste more than half of shelf height
+    Shelf* pBestShelf = nullptr;
+    QMap<int, int>::iterator itBestSpan;
+    for (auto& shelf : _shelves)
+    {
+        if (shelf.height < size.y || shelf.height > 2 * size.y)
+            continue;
+        if (pBestShelf && pBestShelf->height <= shelf.height)
+            continue;
+
+        for (auto itSpan = shelf.freeSpans.begin(); itSpan != shelf.freeSpans.end(); ++itSpan)
+        {
+            if (itSpan.value() < size.x)
+                continue;
+
+            pBestShelf = &shelf;
+            itBestSpan = itSpan;
+            break;
+        }
+    }
+
+    // Otherwise start new shelf below the last one
+    if (!pBestShelf)
+    {
+        if (_shelvesBottom + size.y > static_cast<int>(height))
+            return false;
+
+        Shelf shelf;
+        shelf.top = _shelvesBottom;
+        shelf.height = size.y;
+        shelf.freeSpans.insert(0, width);
+        _shelves.push_back(shelf);
+        _shelvesBottom += size.y;
+
+        pBestShelf = &_shelves.last();
+        itBestSpan = pBestShelf->freeSpans.begin();
+    }
+
+    const auto spanLeft = itBestSpan.key();
+    const auto spanWidth = itBestSpan.value();
+    pBestShelf->freeSpans.erase(itBestSpan);
+    if (spanWidth > size.x)
+        pBestShelf->freeSpans.insert(spanLeft + size.x, spanWidth - size.x);
+
+    outArea = AreaI(pBestShelf->top, spanLeft, pBestShelf->top + size.y, spanLeft + size.x);
+    _areasCount++;
+    _occupiedTexelsCount += size.x * size.y;
+
+    return true;
+}
+
+void OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::releaseArea(const AreaI& area)
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    for (auto itShelf = _shelves.begin(); itShelf != _shelves.end(); ++itShelf)
+    {
+        if (itShelf->top != area.top())
+            continue;
+        auto& freeSpans = itShelf->freeSpans;
+
+        // Return span, merging it with adjacent free spans
+        auto left = area.left();
+        auto spanWidth = area.width();
+        auto itNext = freeSpans.lowerBound(left);
+        if (itNext != freeSpans.end() && itNext.key() == left + spanWidth)
+        {
+            spanWidth += itNext.value();
+            itNext = freeSpans.erase(itNext);
+        }
+        if (itNext != freeSpans.begin())
+        {
+            auto itPrevious = itNext;
+            --itPrevious;
+            if (itPrevious.key() + itPrevious.value() == left)
+            {
+                left = itPrevious.key();
+                spanWidth += itPrevious.value();
+                freeSpans.erase(itPrevious);
+            }
+        }
+        freeSpans.insert(left, spanWidth);
+
+        // Empty shelves at the bottom are given back, so that space may be used by shelves of other height
+        while (!_shelves.isEmpty() && _shelves.last().freeSpans.value(0) == static_cast<int>(width))
+        {
+            _shelvesBottom = _shelves.last().top;
+            _shelves.removeLast();
+        }
+
+        break;
+    }
+
+    _areasCount--;
+    _occupiedTexelsCount -= area.width() * area.height();
+}
+
+void OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::attachArea(const std::shared_ptr<AreaOnSymbolsAtlasTextureInGPU>& area)
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    _areas.insert(area.get(), area);
+}
+
+void OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::detachArea(const AreaOnSymbolsAtlasTextureInGPU* const area)
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    _areas.remove(area);
+}
+
+QList< std::shared_ptr<OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU> > OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::getAreas() const
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    QList< std::shared_ptr<AreaOnSymbolsAtlasTextureInGPU> > areas;
+    for (const auto& areaWeak : constOf(_areas))
+    {
+        if (const auto area = areaWeak.lock())
+            areas.push_back(area);
+    }
+    return areas;
+}
+
+int OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::getAreasCount() const
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    return _areasCount;
+}
+
+uint64_t OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::getOccupiedTexelsCount() const
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    return _occupiedTexelsCount;
+}
+
+void OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU::collectStatistics(AtlasTexturesStatistics& statistics) const
+{
+    QMutexLocker scopedLocker(&_shelvesMutex);
+
+    const uint64_t texelsCount = width * height;
+    const uint64_t freeTexelsBelowShelvesCount = (height - _shelvesBottom) * width;
+
+    statistics.atlasTexturesCount++;
+    statistics.areasCount += _areasCount;
+    statistics.texelsCount += texelsCount;
+    statistics.occupiedTexelsCount += _occupiedTexelsCount;
+    statistics.fragmentedTexelsCount += texelsCount - _occupiedTexelsCount - freeTexelsBelowShelvesCount;
+}
+
+OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::AreaOnSymbolsAtlasTextureInGPU(
+    const std::shared_ptr<SymbolsAtlasTextureInGPU>& atlasTexture_,
+    const AreaI& allocatedArea_)
+    : ResourceInGPU(Type::AreaOnSymbolsAtlasTexture, atlasTexture_->api, atlasTexture_->refInGPU)
+{
+    setLocation(atlasTexture_, allocatedArea_);
+}
+
+OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::~AreaOnSymbolsAtlasTextureInGPU()
+{
+    _atlasTexture->detachArea(this);
+    _atlasTexture->releaseArea(_allocatedArea);
+
+    // Clear reference to GPU resource to avoid removal in base class
+    _refInGPU = nullptr;
+}
+
+void OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::setLocation(
+    const std::shared_ptr<SymbolsAtlasTextureInGPU>& atlasTexture_,
+    const AreaI& allocatedArea_)
+{
+    _atlasTexture = atlasTexture_;
+    _allocatedArea = allocatedArea_;
+    _area = AreaI(
+        allocatedArea_.top() + SymbolsAtlasTextureInGPU::AreaPadding,
+        allocatedArea_.left() + SymbolsAtlasTextureInGPU::AreaPadding,
+        allocatedArea_.bottom() - SymbolsAtlasTextureInGPU::AreaPadding,
+        allocatedArea_.right() - SymbolsAtlasTextureInGPU::AreaPadding);
+    _refInGPU = _atlasTexture->refInGPU;
+}
+
+std::shared_ptr<OsmAnd::GPUAPI::SymbolsAtlasTextureInGPU> OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::getAtlasTexture() const
+{
+    return _atlasTexture;
+}
+
+OsmAnd::AreaI OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::getAllocatedArea() const
+{
+    return _allocatedArea;
+}
+
+OsmAnd::AreaI OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::getArea() const
+{
+    return _area;
+}
+
+void OsmAnd::GPUAPI::AreaOnSymbolsAtlasTextureInGPU::lostRefInGPU() const
+{
+    ResourceInGPU::lostRefInGPU();
+
+    // Atlas texture is gone with the context as well
+    atlasTexture->lostRefInGPU();
+}
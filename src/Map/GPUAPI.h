@@ -7,15 +7,20 @@
 #include "QtExtensions.h"
 #include <QHash>
 #include <QMultiMap>
+#include <QMap>
+#include <QList>
 #include <QReadWriteLock>
 #include <QMutex>
 #include <QSet>
 #include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QVector>
 
 #include "OsmAndCore.h"
 #include "Common.h"
 #include "CommonTypes.h"
 #include "MapCommonTypes.h"
+#include "PointsAndAreas.h"
 #include "IMapTiledDataProvider.h"
 
 class SkBitmap;
@@ -50,7 +55,9 @@ namespace OsmAnd
                 SlotOnAtlasTexture,
                 ArrayBuffer,
                 ElementArrayBuffer,
-                Mesh
+                Mesh,
+                SdfGlyphs,
+                AreaOnSymbolsAtlasTexture
             };
         private:
         protected:
@@ -264,6 +271,127 @@ namespace OsmAnd
             const std::shared_ptr<ElementArrayBufferInGPU> indexBuffer;
         };
 
+        class SdfGlyphsInGPU : public MetaResourceInGPU
+        {
+            Q_DISABLE_COPY_AND_MOVE(SdfGlyphsInGPU);
+        private:
+        protected:
+        public:
+            SdfGlyphsInGPU(
+                GPUAPI* api,
+                const QVector< std::shared_ptr<const TextureInGPU> >& pagesTextures);
+            virtual ~SdfGlyphsInGPU();
+
+            // Textures of pages of glyph run, in the same order. Textures are shared by all runs that
+            // reference the same page
+            const QVector< std::shared_ptr<const TextureInGPU> > pagesTextures;
+        };
+
+        // Occupancy of atlas textures. Texels that are neither occupied nor fragmented are free ones that
+        // are left in one piece below all shelves
+        struct AtlasTexturesStatistics
+        {
+            AtlasTexturesStatistics();
+
+            int atlasTexturesCount;
+            int areasCount;
+            uint64_t texelsCount;
+            // Texels taken by areas, including padding
+            uint64_t occupiedTexelsCount;
+            // Texels of shelves that are not taken by areas: free spans and space above lower areas
+            uint64_t fragmentedTexelsCount;
+
+            // Part of texels that are occupied
+            float getOccupancy() const;
+            // Part of unoccupied texels that may be used only by areas that fit existing shelves
+            float getFragmentation() const;
+        };
+
+        // Texture shared by bitmaps of several symbols, so that they may be drawn in a single batch.
+        // Areas are allocated on shelves of fixed height: each area takes a span of the first shelf that
+        // is tall enough and not much taller. Spans are returned to shelf when area is released.
+        // Sparse atlases are compacted by moving their areas to other atlases of the same format
+        class AreaOnSymbolsAtlasTextureInGPU;
+        class SymbolsAtlasTextureInGPU : public TextureInGPU
+        {
+            Q_DISABLE_COPY_AND_MOVE(SymbolsAtlasTextureInGPU);
+        private:
+            struct Shelf
+            {
+                int top;
+                int height;
+                // Free spans of shelf: width by left edge
+                QMap<int, int> freeSpans;
+            };
+
+            mutable QMutex _shelvesMutex;
+            QList<Shelf> _shelves;
+            int _shelvesBottom;
+            int _areasCount;
+            uint64_t _occupiedTexelsCount;
+
+            // Areas that reference this atlas, to be moved away on compaction
+            QHash< const AreaOnSymbolsAtlasTextureInGPU*, std::weak_ptr<AreaOnSymbolsAtlasTextureInGPU> > _areas;
+        protected:
+        public:
+            SymbolsAtlasTextureInGPU(
+                GPUAPI* api,
+                const RefInGPU& refInGPU,
+                const unsigned int textureSize,
+                const AlphaChannelType alphaChannelType,
+                const bool compactable);
+            virtual ~SymbolsAtlasTextureInGPU();
+
+            // Texels of atlas can be copied to another one on GPU side, which requires renderable format
+            const bool compactable;
+
+            // Transparent border kept around each area, so that filtering never picks texels of neighbours
+            static const int AreaPadding;
+            // Atlas that has smaller part of its texels occupied is drained on compaction
+            static const float CompactionOccupancyThreshold;
+
+            // Both area and size include padding
+            bool allocateArea(const PointI& size, AreaI& outArea);
+            void releaseArea(const AreaI& area);
+
+            void attachArea(const std::shared_ptr<AreaOnSymbolsAtlasTextureInGPU>& area);
+            void detachArea(const AreaOnSymbolsAtlasTextureInGPU* const area);
+            QList< std::shared_ptr<AreaOnSymbolsAtlasTextureInGPU> > getAreas() const;
+
+            int getAreasCount() const;
+            uint64_t getOccupiedTexelsCount() const;
+            void collectStatistics(AtlasTexturesStatistics& statistics) const;
+        };
+
+        class AreaOnSymbolsAtlasTextureInGPU : public ResourceInGPU
+        {
+            Q_DISABLE_COPY_AND_MOVE(AreaOnSymbolsAtlasTextureInGPU);
+        private:
+            std::shared_ptr<SymbolsAtlasTextureInGPU> _atlasTexture;
+            AreaI _allocatedArea;
+            AreaI _area;
+
+            void setLocation(const std::shared_ptr<SymbolsAtlasTextureInGPU>& atlasTexture, const AreaI& allocatedArea);
+        protected:
+        public:
+            AreaOnSymbolsAtlasTextureInGPU(
+                const std::shared_ptr<SymbolsAtlasTextureInGPU>& atlasTexture,
+                const AreaI& allocatedArea);
+            virtual ~AreaOnSymbolsAtlasTextureInGPU();
+
+            // Location of area changes only when atlases are compacted, which is done by render thread
+            // between frames
+            std::shared_ptr<SymbolsAtlasTextureInGPU> getAtlasTexture() const;
+            // Area as allocated on atlas, including padding
+            AreaI getAllocatedArea() const;
+            // Area occupied by symbol bitmap
+            AreaI getArea() const;
+
+            virtual void lostRefInGPU() const;
+
+        friend OsmAnd::GPUAPI;
+        };
+
     private:
 #if OSMAND_DEBUG
         mutable QMutex _allocatedResourcesMutex;
@@ -273,6 +401,12 @@ namespace OsmAnd
 #endif
 
         QHash< AtlasTypeId, std::shared_ptr<AtlasTexturesPool> > _atlasTexturesPools;
+
+        mutable QMutex _symbolsAtlasTexturesMutex;
+        QHash< uint64_t, QList< std::weak_ptr<SymbolsAtlasTextureInGPU> > > _symbolsAtlasTextures;
+
+        // Counted in 64 bits, since bytes of several large textures uploaded between takes may exceed 2GB
+        QAtomicInteger<qint64> _uploadedBytesCounter;
     protected:
         GPUAPI();
 
@@ -282,8 +416,27 @@ namespace OsmAnd
             const std::shared_ptr<AtlasTexturesPool>& pool,
             AtlasTexturesPool::AtlasTextureAllocator atlasTextureAllocator);
 
+        typedef std::function< SymbolsAtlasTextureInGPU*() > SymbolsAtlasTextureAllocator;
+        std::shared_ptr<AreaOnSymbolsAtlasTextureInGPU> allocateAreaOnSymbolsAtlasTexture(
+            const TextureFormat textureFormat,
+            const AlphaChannelType alphaChannelType,
+            const PointI& size,
+            SymbolsAtlasTextureAllocator symbolsAtlasTextureAllocator);
+
+        // Copies texels of area of one atlas texture to area of the same size on another one
+        typedef std::function< bool(
+            const std::shared_ptr<SymbolsAtlasTextureInGPU>& sourceAtlasTexture,
+            const AreaI& sourceArea,
+            const std::shared_ptr<SymbolsAtlasTextureInGPU>& destinationAtlasTexture,
+            const AreaI& destinationArea) > SymbolsAtlasAreaCopier;
+        unsigned int migrateSymbolsAtlasAreas(
+            const unsigned int maxAreasToMigrate,
+            SymbolsAtlasAreaCopier symbolsAtlasAreaCopier);
+
         virtual bool releaseResourceInGPU(const ResourceInGPU::Type type, const RefInGPU& refInGPU) = 0;
 
+        void countUploadedBytes(const size_t bytes);
+
         bool _isSupported_8bitPaletteRGBA8;
     public:
         virtual ~GPUAPI();
@@ -302,6 +455,14 @@ namespace OsmAnd
 
         virtual void waitUntilUploadIsComplete() = 0;
 
+        // Moves up to specified number of areas out of the sparsest symbols atlas textures, so that these
+        // textures are released once empty. Returns number of areas moved
+        virtual unsigned int compactSymbolsAtlasTextures(const unsigned int maxAreasToMigrate) = 0;
+        AtlasTexturesStatistics getSymbolsAtlasTexturesStatistics() const;
+
+        // Returns number of bytes of textures and buffers data uploaded since previous call
+        size_t takeUploadedBytesCount();
+
         virtual AlphaChannelType getGpuResourceAlphaChannelType(const std::shared_ptr<const ResourceInGPU> gpuResource);
 
     friend OsmAnd::GPUAPI::ResourceInGPU;
@@ -59,10 +59,33 @@ bool OsmAnd::HeightmapTileProvider_P::obtainData(
 
     // We have the data, use GDAL to decode this GeoTIFF
     const auto tileSize = getTileSize();
+    const auto buffer = new float[tileSize*tileSize];
+    if (!decodeTileData(data, tileId, zoom, tileSize, buffer))
+    {
+        delete[] buffer;
+        return false;
+    }
+
+    outTiledData.reset(new IMapElevationDataProvider::Data(
+        tileId,
+        zoom,
+        tileSize,
+        sizeof(float)*tileSize,
+        buffer));
+    return true;
+}
+
+bool OsmAnd::HeightmapTileProvider_P::decodeTileData(
+    const QByteArray& data,
+    const TileId tileId,
+    const ZoomLevel zoom,
+    const uint32_t tileSize,
+    float* const outBuffer)
+{
     bool success = false;
     QString vmemFilename;
-    vmemFilename.sprintf("/vsimem/heightmapTile@%p", data.data());
-    VSIFileFromMemBuffer(qPrintable(vmemFilename), reinterpret_cast<GByte*>(data.data()), data.length(), FALSE);
+    vmemFilename.sprintf("/vsimem/heightmapTile@%p", data.constData());
+    VSIFileFromMemBuffer(qPrintable(vmemFilename), reinterpret_cast<GByte*>(const_cast<char*>(data.constData())), data.length(), FALSE);
     auto dataset = reinterpret_cast<GDALDataset*>(GDALOpen(qPrintable(vmemFilename), GA_ReadOnly));
     if (dataset != nullptr)
     {
@@ -96,24 +119,11 @@ bool OsmAnd::HeightmapTileProvider_P::obtainData(
             }
             else
             {
-                auto buffer = new float[tileSize*tileSize];
-
-                auto res = dataset->RasterIO(GF_Read, 0, 0, tileSize, tileSize, buffer, tileSize, tileSize, GDT_Float32, 1, nullptr, 0, 0, 0);
+                auto res = dataset->RasterIO(GF_Read, 0, 0, tileSize, tileSize, outBuffer, tileSize, tileSize, GDT_Float32, 1, nullptr, 0, 0, 0);
                 if (res != CE_None)
-                {
-                    delete[] buffer;
                     LogPrintf(LogSeverityLevel::Error, "Failed to decode height tile %dx%d@%d: %s", tileId.x, tileId.y, zoom, CPLGetLastErrorMsg());
-                }
                 else
-                {
-                    outTiledData.reset(new IMapElevationDataProvider::Data(
-                        tileId,
-                        zoom,
-                        tileSize,
-                        sizeof(float)*tileSize,
-                        buffer));
                     success = true;
-                }
             }
         }
 
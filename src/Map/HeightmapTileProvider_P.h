@@ -44,6 +44,13 @@ namespace OsmAnd
             std::shared_ptr<HeightmapTileProvider::Data>& outTiledData,
             const IQueryController* const queryController);
 
+        static bool decodeTileData(
+            const QByteArray& data,
+            const TileId tileId,
+            const ZoomLevel zoom,
+            const uint32_t tileSize,
+            float* const outBuffer);
+
     friend class OsmAnd::HeightmapTileProvider;
     };
 }
@@ -0,0 +1,24 @@
+#include "IVectorMapLayerProvider.h"
+
+OsmAnd::IVectorMapLayerProvider::IVectorMapLayerProvider()
+{
+}
+
+OsmAnd::IVectorMapLayerProvider::~IVectorMapLayerProvider()
+{
+}
+
+OsmAnd::IVectorMapLayerProvider::Data::Data(
+    const TileId tileId_,
+    const ZoomLevel zoom_,
+    const QVector<Vertex>& vertices_,
+    const RetainableCacheMetadata* const pRetainableCacheMetadata_ /*= nullptr*/)
+    : IMapLayerProvider::Data(tileId_, zoom_, pRetainableCacheMetadata_)
+    , vertices(vertices_)
+{
+}
+
+OsmAnd::IVectorMapLayerProvider::Data::~Data()
+{
+    release();
+}
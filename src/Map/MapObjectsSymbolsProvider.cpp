@@ -30,10 +30,21 @@ bool OsmAnd::MapObjectsSymbolsProvider::obtainData(
     const FilterCallback filterCallback /*= nullptr*/)
 {
     if (pOutMetric)
-        pOutMetric->reset();
+    {
+        if (!pOutMetric->get() || !dynamic_cast<SymbolRasterizer_Metrics::Metric_rasterize*>(pOutMetric->get()))
+            pOutMetric->reset(new SymbolRasterizer_Metrics::Metric_rasterize());
+        else
+            pOutMetric->get()->reset();
+    }
 
     std::shared_ptr<Data> tiledData;
-    const auto result = _p->obtainData(tileId, zoom, tiledData, queryController, filterCallback);
+    const auto result = _p->obtainData(
+        tileId,
+        zoom,
+        tiledData,
+        pOutMetric ? static_cast<SymbolRasterizer_Metrics::Metric_rasterize*>(pOutMetric->get()) : nullptr,
+        queryController,
+        filterCallback);
     outTiledData = tiledData;
 
     return result;
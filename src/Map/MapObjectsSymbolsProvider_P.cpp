@@ -32,6 +32,7 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
     const TileId tileId,
     const ZoomLevel zoom,
     std::shared_ptr<MapObjectsSymbolsProvider::Data>& outTiledData,
+    SymbolRasterizer_Metrics::Metric_rasterize* const metric,
     const IQueryController* const queryController,
     const FilterCallback filterCallback)
 {
@@ -71,7 +72,8 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
         rasterizedSymbolsGroups,
         owner->symbolsScaleFactor,
         rasterizationFilter,
-        nullptr);
+        nullptr,
+        metric);
 
     // Convert results
     auto& mapSymbolIntersectionClassesRegistry = MapSymbolIntersectionClassesRegistry::globalInstance();
@@ -101,7 +103,7 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
         bool hasAtLeastOneSimpleBillboard = false;
         for (const auto& rasterizedSymbol : constOf(rasterizedGroup->symbols))
         {
-            assert(static_cast<bool>(rasterizedSymbol->bitmap));
+            assert(rasterizedSymbol->bitmap || rasterizedSymbol->sdfGlyphRun);
 
             std::shared_ptr<MapSymbol> symbol;
             if (const auto rasterizedSpriteSymbol = std::dynamic_pointer_cast<const SymbolRasterizer::RasterizedSpriteSymbol>(rasterizedSymbol))
@@ -114,7 +116,10 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
                 const auto billboardRasterSymbol = new BillboardRasterMapSymbol(group);
                 billboardRasterSymbol->order = rasterizedSpriteSymbol->order;
                 billboardRasterSymbol->bitmap = rasterizedSpriteSymbol->bitmap;
-                billboardRasterSymbol->size = PointI(rasterizedSpriteSymbol->bitmap->width(), rasterizedSpriteSymbol->bitmap->height());
+                billboardRasterSymbol->sdfGlyphRun = rasterizedSpriteSymbol->sdfGlyphRun;
+                billboardRasterSymbol->size = rasterizedSpriteSymbol->bitmap
+                    ? PointI(rasterizedSpriteSymbol->bitmap->width(), rasterizedSpriteSymbol->bitmap->height())
+                    : rasterizedSpriteSymbol->sdfGlyphRun->size;
                 billboardRasterSymbol->content = rasterizedSpriteSymbol->content;
                 billboardRasterSymbol->languageId = rasterizedSpriteSymbol->languageId;
                 billboardRasterSymbol->minDistance = rasterizedSpriteSymbol->minDistance;
@@ -147,7 +152,10 @@ bool OsmAnd::MapObjectsSymbolsProvider_P::obtainData(
                 const auto onPathSymbol = new OnPathRasterMapSymbol(group);
                 onPathSymbol->order = rasterizedOnPathSymbol->order;
                 onPathSymbol->bitmap = rasterizedOnPathSymbol->bitmap;
-                onPathSymbol->size = PointI(rasterizedOnPathSymbol->bitmap->width(), rasterizedOnPathSymbol->bitmap->height());
+                onPathSymbol->sdfGlyphRun = rasterizedOnPathSymbol->sdfGlyphRun;
+                onPathSymbol->size = rasterizedOnPathSymbol->bitmap
+                    ? PointI(rasterizedOnPathSymbol->bitmap->width(), rasterizedOnPathSymbol->bitmap->height())
+                    : rasterizedOnPathSymbol->sdfGlyphRun->size;
                 onPathSymbol->content = rasterizedOnPathSymbol->content;
                 onPathSymbol->languageId = rasterizedOnPathSymbol->languageId;
                 onPathSymbol->minDistance = rasterizedOnPathSymbol->minDistance;
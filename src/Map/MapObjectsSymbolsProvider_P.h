@@ -98,6 +98,7 @@ namespace OsmAnd
             const TileId tileId,
             const ZoomLevel zoom,
             std::shared_ptr<MapObjectsSymbolsProvider::Data>& outTiledData,
+            SymbolRasterizer_Metrics::Metric_rasterize* const metric,
             const IQueryController* const queryController,
             const FilterCallback filterCallback);
 
@@ -41,6 +41,10 @@ OsmAnd::MapRenderer::MapRenderer(
     , _currentConfigurationAsConst(_currentConfiguration)
     , _requestedConfiguration(baseConfiguration_->createCopy())
     , _suspendSymbolsUpdateCounter(0)
+    , _symbolsInvalidatesCounter(0)
+    , _symbolsInvalidatesToBeProcessed(0)
+    , _lastFrameSkipped(false)
+    , _framesStatisticsStopwatch(true)
     , _gpuWorkerThreadId(nullptr)
     , _gpuWorkerThreadIsAlive(false)
     , _gpuWorkerIsSuspended(false)
@@ -218,6 +222,15 @@ void OsmAnd::MapRenderer::invalidateFrame()
         _setupOptions.frameUpdateRequestCallback(this);
 }
 
+void OsmAnd::MapRenderer::invalidateSymbols()
+{
+    // Symbols counter is incremented prior to frame one, so that frame that captures symbols invalidation
+    // is never skipped
+    _symbolsInvalidatesCounter.fetchAndAddOrdered(1);
+
+    invalidateFrame();
+}
+
 void OsmAnd::MapRenderer::gpuWorkerThreadProcedure()
 {
     assert(_setupOptions.gpuWorkerThreadEnabled);
@@ -263,25 +276,32 @@ void OsmAnd::MapRenderer::processGpuWorker()
             const auto requestsToProcess = _resourcesGpuSyncRequestsCounter.fetchAndAddOrdered(0);
             unsigned int resourcesUploaded = 0u;
             unsigned int resourcesUnloaded = 0u;
-            _resources->syncResourcesInGPU(0, nullptr, &resourcesUploaded, &resourcesUnloaded);
+            _resources->syncResourcesInGPU(0.0f, 0u, nullptr, &resourcesUploaded, &resourcesUnloaded);
             if (resourcesUploaded > 0 || resourcesUnloaded > 0)
-                invalidateFrame();
+                invalidateSymbols();
             unprocessedRequests = _resourcesGpuSyncRequestsCounter.fetchAndAddOrdered(-requestsToProcess) - requestsToProcess;
         } while (unprocessedRequests > 0);
     }
     else if (isInRenderThread())
     {
-        // To reduce FPS drop, upload not more than 1 resource per frame.
+        // To reduce FPS drop, upload not more than budget allows per frame
         const auto requestsToProcess = _resourcesGpuSyncRequestsCounter.fetchAndAddOrdered(0);
         bool moreUploadThanLimitAvailable = false;
         unsigned int resourcesUploaded = 0u;
         unsigned int resourcesUnloaded = 0u;
-        _resources->syncResourcesInGPU(1u, &moreUploadThanLimitAvailable, &resourcesUploaded, &resourcesUnloaded);
+        _resources->syncResourcesInGPU(
+            _setupOptions.resourcesUploadTimeBudgetPerFrame,
+            _setupOptions.resourcesUploadBytesBudgetPerFrame,
+            &moreUploadThanLimitAvailable,
+            &resourcesUploaded,
+            &resourcesUnloaded);
         const auto unprocessedRequests = _resourcesGpuSyncRequestsCounter.fetchAndAddOrdered(-requestsToProcess) - requestsToProcess;
 
         // If any resource was uploaded or there is more resources to uploaded, invalidate frame
-        // to use that resource
-        if (resourcesUploaded > 0 || moreUploadThanLimitAvailable || resourcesUnloaded > 0 || unprocessedRequests > 0)
+        // to use that resource. Uploaded or unloaded resource may be the one of symbols
+        if (resourcesUploaded > 0 || resourcesUnloaded > 0)
+            invalidateSymbols();
+        else if (moreUploadThanLimitAvailable || unprocessedRequests > 0)
             invalidateFrame();
     }
     else
@@ -317,7 +337,7 @@ bool OsmAnd::MapRenderer::initializeRendering()
         return false;
 
     // Once rendering is initialized, invalidate frame
-    invalidateFrame();
+    invalidateSymbols();
 
     return true;
 }
@@ -394,8 +414,9 @@ bool OsmAnd::MapRenderer::preUpdate(IMapRenderer_Metrics::Metric_update* const m
 {
     // Check for resources updates
     Stopwatch updatesStopwatch(metric != nullptr);
+    // Updates change symbols (e.g. of map markers) in place
     if (_resources->checkForUpdatesAndApply())
-        invalidateFrame();
+        invalidateSymbols();
     if (metric)
         metric->elapsedTimeForUpdatesProcessing = updatesStopwatch.elapsed();
 
@@ -406,8 +427,38 @@ bool OsmAnd::MapRenderer::doUpdate(IMapRenderer_Metrics::Metric_update* const me
 {
     // If GPU worker thread is not enabled, upload resource to GPU from render thread.
     if (!_gpuWorkerThread && !_gpuWorkerIsSuspended)
+    {
         processGpuWorker();
 
+        // Symbols are moved between atlas textures only here, since all stages of frame have to see
+        // same location of symbol
+        Stopwatch atlasTexturesCompactionStopwatch(metric != nullptr);
+        const auto areasMigrated = gpuAPI->compactSymbolsAtlasTextures(_setupOptions.atlasTexturesCompactionAreasPerFrame);
+        if (metric)
+        {
+            metric->elapsedTimeForAtlasTexturesCompaction = atlasTexturesCompactionStopwatch.elapsed();
+            metric->symbolsAtlasAreasMigrated = areasMigrated;
+        }
+        if (areasMigrated > 0)
+            invalidateSymbols();
+    }
+
+    if (metric)
+    {
+        const auto symbolsAtlasTexturesStatistics = gpuAPI->getSymbolsAtlasTexturesStatistics();
+        metric->symbolsAtlasTexturesCount = symbolsAtlasTexturesStatistics.atlasTexturesCount;
+        metric->symbolsAtlasTexturesOccupancy = symbolsAtlasTexturesStatistics.getOccupancy();
+        metric->symbolsAtlasTexturesFragmentation = symbolsAtlasTexturesStatistics.getFragmentation();
+    }
+
+    if (metric)
+    {
+        _resources->takeFinishedZoomGesturesStatistics(
+            metric->zoomGesturesFinished,
+            metric->tiledResourcesRequested,
+            metric->tiledResourcesRequestsPostponed);
+    }
+
     // Process render thread dispatcher
     Stopwatch renderThreadDispatcherStopwatch(metric != nullptr);
     _renderThreadDispatcher.runAll();
@@ -455,6 +506,7 @@ bool OsmAnd::MapRenderer::prePrepareFrame()
     if (currentDebugSettingsInvalidatedCounter > 0)
     {
         updateCurrentDebugSettings();
+        invalidateSymbols();
 
         _currentDebugSettingsInvalidatedCounter.fetchAndAddOrdered(-currentDebugSettingsInvalidatedCounter);
     }
@@ -505,8 +557,8 @@ bool OsmAnd::MapRenderer::prePrepareFrame()
     {
         ok = updateInternalState(*getInternalStateRef(), _currentState, *currentConfiguration);
 
-        // Anyways, invalidate the frame
-        invalidateFrame();
+        // Anyways, invalidate the frame and symbols, since they depend on state
+        invalidateSymbols();
 
         if (!ok)
         {
@@ -547,14 +599,31 @@ bool OsmAnd::MapRenderer::renderFrame(IMapRenderer_Metrics::Metric_renderFrame*
 
     bool ok = true;
 
-    Stopwatch totalStopwatch(metric != nullptr);
+    Stopwatch totalStopwatch(true);
 
     ok = ok && preRenderFrame(metric);
-    ok = ok && doRenderFrame(metric);
+    ok = ok && (_lastFrameSkipped || doRenderFrame(metric));
     ok = ok && postRenderFrame(metric);
 
+    const auto elapsedTime = totalStopwatch.elapsed();
     if (metric)
-        metric->elapsedTime = totalStopwatch.elapsed();
+    {
+        metric->elapsedTime = elapsedTime;
+        metric->frameSkipped = _lastFrameSkipped;
+    }
+
+    if (ok)
+    {
+        QMutexLocker scopedLocker(&_framesStatisticsMutex);
+
+        if (_lastFrameSkipped)
+            _framesStatistics.skippedFramesCount++;
+        else
+        {
+            _framesStatistics.renderedFramesCount++;
+            _framesStatistics.activeTime += elapsedTime;
+        }
+    }
 
     return ok;
 }
@@ -567,6 +636,11 @@ bool OsmAnd::MapRenderer::preRenderFrame(IMapRenderer_Metrics::Metric_renderFram
     // Capture how many "frame-invalidates" are going to be processed
     _frameInvalidatesToBeProcessed = _frameInvalidatesCounter.fetchAndAddOrdered(0);
 
+    // Frame that has nothing to process would be identical to previous one. Symbols invalidated meanwhile
+    // are left for next frame
+    _lastFrameSkipped = _setupOptions.skipUnchangedFrames && (_frameInvalidatesToBeProcessed == 0);
+    _symbolsInvalidatesToBeProcessed = _lastFrameSkipped ? 0 : _symbolsInvalidatesCounter.fetchAndAddOrdered(0);
+
     return true;
 }
 
@@ -576,6 +650,10 @@ bool OsmAnd::MapRenderer::postRenderFrame(IMapRenderer_Metrics::Metric_renderFra
     _frameInvalidatesCounter.fetchAndAddOrdered(-_frameInvalidatesToBeProcessed);
     _frameInvalidatesToBeProcessed = 0;
 
+    // Same for "symbols-invalidates"
+    _symbolsInvalidatesCounter.fetchAndAddOrdered(-_symbolsInvalidatesToBeProcessed);
+    _symbolsInvalidatesToBeProcessed = 0;
+
     return true;
 }
 
@@ -865,17 +943,25 @@ void OsmAnd::MapRenderer::publishMapSymbol(
     const std::shared_ptr<const MapSymbol>& symbol,
     const std::shared_ptr<MapRendererBaseResource>& resource)
 {
-    QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
+    {
+        QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
+
+        doPublishMapSymbol(symbolGroup, symbol, resource);
+    }
 
-    doPublishMapSymbol(symbolGroup, symbol, resource);
+    invalidateSymbols();
 }
 
 void OsmAnd::MapRenderer::batchPublishMapSymbols(const QList< PublishOrUnpublishMapSymbol >& mapSymbolsToPublish)
 {
-    QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
+    {
+        QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
 
-    for (const auto& mapSymbolToPublish : constOf(mapSymbolsToPublish))
-        doPublishMapSymbol(mapSymbolToPublish.symbolGroup, mapSymbolToPublish.symbol, mapSymbolToPublish.resource);
+        for (const auto& mapSymbolToPublish : constOf(mapSymbolsToPublish))
+            doPublishMapSymbol(mapSymbolToPublish.symbolGroup, mapSymbolToPublish.symbol, mapSymbolToPublish.resource);
+    }
+
+    invalidateSymbols();
 }
 
 void OsmAnd::MapRenderer::doPublishMapSymbol(
@@ -921,17 +1007,25 @@ void OsmAnd::MapRenderer::unpublishMapSymbol(
     const std::shared_ptr<const MapSymbol>& symbol,
     const std::shared_ptr<MapRendererBaseResource>& resource)
 {
-    QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
+    {
+        QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
 
-    doUnpublishMapSymbol(symbolGroup, symbol, resource);
+        doUnpublishMapSymbol(symbolGroup, symbol, resource);
+    }
+
+    invalidateSymbols();
 }
 
 void OsmAnd::MapRenderer::batchUnpublishMapSymbols(const QList< PublishOrUnpublishMapSymbol >& mapSymbolsToUnpublish)
 {
-    QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
+    {
+        QWriteLocker scopedLocker(&_publishedMapSymbolsByOrderLock);
 
-    for (const auto& mapSymbolToUnpublish : constOf(mapSymbolsToUnpublish))
-        doUnpublishMapSymbol(mapSymbolToUnpublish.symbolGroup, mapSymbolToUnpublish.symbol, mapSymbolToUnpublish.resource);
+        for (const auto& mapSymbolToUnpublish : constOf(mapSymbolsToUnpublish))
+            doUnpublishMapSymbol(mapSymbolToUnpublish.symbolGroup, mapSymbolToUnpublish.symbol, mapSymbolToUnpublish.resource);
+    }
+
+    invalidateSymbols();
 }
 
 void OsmAnd::MapRenderer::doUnpublishMapSymbol(
@@ -1068,7 +1162,7 @@ bool OsmAnd::MapRenderer::suspendSymbolsUpdate()
 {
     const auto prevCounter = _suspendSymbolsUpdateCounter.fetchAndAddOrdered(+1);
     if (prevCounter == 0)
-        invalidateFrame();
+        invalidateSymbols();
 
     return (prevCounter >= 1);
 }
@@ -1077,7 +1171,7 @@ bool OsmAnd::MapRenderer::resumeSymbolsUpdate()
 {
     const auto prevCounter = _suspendSymbolsUpdateCounter.fetchAndAddOrdered(-1);
     if (prevCounter == 1)
-        invalidateFrame();
+        invalidateSymbols();
 
     return (prevCounter <= 1);
 }
@@ -1105,6 +1199,28 @@ void OsmAnd::MapRenderer::forcedGpuProcessingCycle()
     requestResourcesUploadOrUnload();
 }
 
+bool OsmAnd::MapRenderer::isLastFrameSkipped() const
+{
+    return _lastFrameSkipped;
+}
+
+OsmAnd::FramesStatistics OsmAnd::MapRenderer::getFramesStatistics() const
+{
+    QMutexLocker scopedLocker(&_framesStatisticsMutex);
+
+    auto framesStatistics = _framesStatistics;
+    framesStatistics.idleTime = qMax(0.0f, _framesStatisticsStopwatch.elapsed() - framesStatistics.activeTime);
+    return framesStatistics;
+}
+
+void OsmAnd::MapRenderer::resetFramesStatistics()
+{
+    QMutexLocker scopedLocker(&_framesStatisticsMutex);
+
+    _framesStatistics = FramesStatistics();
+    _framesStatisticsStopwatch.start();
+}
+
 OsmAnd::Concurrent::Dispatcher& OsmAnd::MapRenderer::getRenderThreadDispatcher()
 {
     return _renderThreadDispatcher;
@@ -25,6 +25,7 @@
 #include "MapRendererInternalState.h"
 #include "MapRendererResourcesManager.h"
 #include "MapSymbolsGroup.h"
+#include "Stopwatch.h"
 
 namespace OsmAnd
 {
@@ -88,6 +89,8 @@ namespace OsmAnd
             const std::shared_ptr<MapRendererBaseResource>& resource);
         bool validatePublishedMapSymbolsIntegrity();
         QAtomicInt _suspendSymbolsUpdateCounter;
+        mutable QAtomicInt _symbolsInvalidatesCounter;
+        int _symbolsInvalidatesToBeProcessed;
         
         // GPU worker related:
         Qt::HANDLE _gpuWorkerThreadId;
@@ -99,8 +102,15 @@ namespace OsmAnd
         void gpuWorkerThreadProcedure();
         void processGpuWorker();
 
+        // Frames-related:
+        bool _lastFrameSkipped;
+        mutable QMutex _framesStatisticsMutex;
+        FramesStatistics _framesStatistics;
+        Stopwatch _framesStatisticsStopwatch;
+
         // General:
         void invalidateFrame();
+        void invalidateSymbols();
         Qt::HANDLE _renderThreadId;
         Concurrent::Dispatcher _renderThreadDispatcher;
         Concurrent::Dispatcher _gpuThreadDispatcher;
@@ -243,6 +253,10 @@ namespace OsmAnd
         virtual void forcedFrameInvalidate();
         virtual void forcedGpuProcessingCycle();
 
+        virtual bool isLastFrameSkipped() const;
+        virtual FramesStatistics getFramesStatistics() const;
+        virtual void resetFramesStatistics();
+
         Concurrent::Dispatcher& getRenderThreadDispatcher();
         Concurrent::Dispatcher& getGpuThreadDispatcher();
 
@@ -39,14 +39,14 @@ bool OsmAnd::MapRendererRasterMapLayerResource::obtainData(bool& dataAvailable,
     
     // Store data
     if (dataAvailable)
-        _sourceData = std::static_pointer_cast<IRasterMapLayerProvider::Data>(tiledData);
+        _sourceData = tiledData;
 
-    // Convert data if such is present
-    if (_sourceData)
+    // Convert data if such is present, vector data is uploaded as is
+    if (const auto rasterData = std::dynamic_pointer_cast<IRasterMapLayerProvider::Data>(_sourceData))
     {
-        _sourceData->bitmap = resourcesManager->adjustBitmapToConfiguration(
-            _sourceData->bitmap,
-            _sourceData->alphaChannelPresence);
+        rasterData->bitmap = resourcesManager->adjustBitmapToConfiguration(
+            rasterData->bitmap,
+            rasterData->alphaChannelPresence);
     }
 
     return true;
@@ -26,7 +26,8 @@ namespace OsmAnd
             const TileId tileId,
             const ZoomLevel zoom);
 
-        std::shared_ptr<IRasterMapLayerProvider::Data> _sourceData;
+        // Either raster or vector data of map layer
+        std::shared_ptr<IMapTiledDataProvider::Data> _sourceData;
         std::shared_ptr<const GPUAPI::ResourceInGPU> _resourceInGPU;
 
         virtual bool obtainData(bool& dataAvailable, const IQueryController* queryController);
@@ -1,6 +1,7 @@
 #include "MapRendererResourcesManager.h"
 
 #include <cassert>
+#include <cmath>
 
 #include "QtCommon.h"
 
@@ -25,6 +26,7 @@
 #include "QKeyValueIterator.h"
 #include "QCachingIterator.h"
 #include "Utilities.h"
+#include "Stopwatch.h"
 #include "Logging.h"
 
 //#define OSMAND_LOG_RESOURCE_STATE_CHANGE 1
@@ -60,6 +62,11 @@ OsmAnd::MapRendererResourcesManager::MapRendererResourcesManager(MapRenderer* co
     , _workerThreadIsAlive(false)
     , _workerThreadId(nullptr)
     , _workerThread(new Concurrent::Thread(std::bind(&MapRendererResourcesManager::workerThreadProcedure, this)))
+    , _zoomGestureInProgress(false)
+    , _zoomGestureTiledResourcesRequested(0)
+    , _finishedZoomGesturesCount(0)
+    , _finishedZoomGesturesTiledResourcesRequested(0)
+    , _finishedZoomGesturesTiledResourcesRequestsPostponed(0)
     , renderer(owner_)
     , processingTileStub(_processingTileStub)
     , unavailableTileStub(_unavailableTileStub)
@@ -390,6 +397,8 @@ void OsmAnd::MapRendererResourcesManager::updateActiveZone(const QSet<TileId>& t
         QMutexLocker scopedLocker(&_workerThreadWakeupMutex);
 
         // Update active zone
+        if (_activeZoom != zoom)
+            _activeZoomChangeStopwatch.start();
         _activeTiles = tiles;
         _activeZoom = zoom;
 
@@ -492,33 +501,92 @@ void OsmAnd::MapRendererResourcesManager::workerThreadProcedure()
     // Capture worker thread ID
     _workerThreadId = QThread::currentThreadId();
 
+    const auto tilesRequestsDelay = renderer->setupOptions.tilesRequestsDelayAfterZoomChange;
+    bool tilesRequestsPostponed = false;
     while (_workerThreadIsAlive)
     {
         // Local copy of active zone
         QSet<TileId> activeTiles;
         ZoomLevel activeZoom;
+        bool zoomSettled;
 
         // Wait until we're unblocked by host
         {
             QMutexLocker scopedLocker(&_workerThreadWakeupMutex);
-            REPEAT_UNTIL(_workerThreadWakeup.wait(&_workerThreadWakeupMutex));
+
+            // Postponed requests have to be made and zoom gesture has to end once zoom settles, even if host
+            // doesn't update active zone anymore
+            if (tilesRequestsPostponed || _zoomGestureInProgress)
+            {
+                const auto timeLeft = tilesRequestsDelay - _activeZoomChangeStopwatch.elapsed();
+                _workerThreadWakeup.wait(&_workerThreadWakeupMutex, qMax(1, qCeil(timeLeft * 1000.0f)));
+            }
+            else
+                REPEAT_UNTIL(_workerThreadWakeup.wait(&_workerThreadWakeupMutex));
 
             // Copy active zone to local copy
             activeTiles = _activeTiles;
             activeZoom = _activeZoom;
+            zoomSettled = (_activeZoomChangeStopwatch.elapsed() >= tilesRequestsDelay);
         }
         if (!_workerThreadIsAlive)
             break;
 
         // Update resources
-        updateResources(activeTiles, activeZoom);
+        if (!zoomSettled)
+            _zoomGestureInProgress = true;
+        tilesRequestsPostponed = updateResources(activeTiles, activeZoom, zoomSettled);
+        if (zoomSettled && _zoomGestureInProgress)
+            finishZoomGesture();
     }
 
     _workerThreadId = nullptr;
 }
 
-void OsmAnd::MapRendererResourcesManager::requestNeededResources(const QSet<TileId>& activeTiles, const ZoomLevel activeZoom)
+void OsmAnd::MapRendererResourcesManager::finishZoomGesture()
+{
+    // Tile postponed and then requested once zoom settled is counted both as postponed and as requested
+    unsigned int tiledResourcesRequestsPostponed = 0;
+    for (auto& postponedTiles : _zoomGesturePostponedTiles)
+    {
+        tiledResourcesRequestsPostponed += postponedTiles.size();
+        postponedTiles.clear();
+    }
+
+    {
+        QMutexLocker scopedLocker(&_finishedZoomGesturesMutex);
+
+        _finishedZoomGesturesCount++;
+        _finishedZoomGesturesTiledResourcesRequested += _zoomGestureTiledResourcesRequested;
+        _finishedZoomGesturesTiledResourcesRequestsPostponed += tiledResourcesRequestsPostponed;
+    }
+
+    _zoomGestureInProgress = false;
+    _zoomGestureTiledResourcesRequested = 0;
+}
+
+void OsmAnd::MapRendererResourcesManager::takeFinishedZoomGesturesStatistics(
+    unsigned int& outGesturesCount,
+    unsigned int& outTiledResourcesRequested,
+    unsigned int& outTiledResourcesRequestsPostponed)
+{
+    QMutexLocker scopedLocker(&_finishedZoomGesturesMutex);
+
+    outGesturesCount = _finishedZoomGesturesCount;
+    outTiledResourcesRequested = _finishedZoomGesturesTiledResourcesRequested;
+    outTiledResourcesRequestsPostponed = _finishedZoomGesturesTiledResourcesRequestsPostponed;
+
+    _finishedZoomGesturesCount = 0;
+    _finishedZoomGesturesTiledResourcesRequested = 0;
+    _finishedZoomGesturesTiledResourcesRequestsPostponed = 0;
+}
+
+bool OsmAnd::MapRendererResourcesManager::requestNeededResources(
+    const QSet<TileId>& activeTiles,
+    const ZoomLevel activeZoom,
+    const bool zoomSettled)
 {
+    bool requestsPostponed = false;
     for (const auto& resourcesCollections : constOf(_storageByType))
     {
         for (const auto& resourcesCollection : constOf(resourcesCollections))
@@ -531,20 +599,40 @@ void OsmAnd::MapRendererResourcesManager::requestNeededResources(const QSet<Tile
                 continue;
 
             if (const auto tiledResourcesCollection = std::dynamic_pointer_cast<MapRendererTiledResourcesCollection>(resourcesCollection))
-                requestNeededTiledResources(tiledResourcesCollection, activeTiles, activeZoom);
+            {
+                if (requestNeededTiledResources(tiledResourcesCollection, activeTiles, activeZoom, zoomSettled))
+                    requestsPostponed = true;
+            }
             else if (const auto keyedResourcesCollection = std::dynamic_pointer_cast<MapRendererKeyedResourcesCollection>(resourcesCollection))
                 requestNeededKeyedResources(keyedResourcesCollection);
         }
     }
+
+    return requestsPostponed;
 }
 
-void OsmAnd::MapRendererResourcesManager::requestNeededTiledResources(
+bool OsmAnd::MapRendererResourcesManager::requestNeededTiledResources(
     const std::shared_ptr<MapRendererTiledResourcesCollection>& resourcesCollection,
     const QSet<TileId>& activeTiles,
-    const ZoomLevel activeZoom)
+    const ZoomLevel activeZoom,
+    const bool zoomSettled)
 {
+    // While zoom gesture goes on, map layer tiles that are shown using tiles of neighbour zoom levels are not
+    // requested, since gesture may pass this zoom level
+    const auto mayPostponeRequests = !zoomSettled && (resourcesCollection->type == MapRendererResourceType::MapLayer);
+
+    bool requestsPostponed = false;
     for (const auto& activeTileId : constOf(activeTiles))
     {
+        if (mayPostponeRequests &&
+            !resourcesCollection->containsResource(activeTileId, activeZoom) &&
+            containsReplacementResources(resourcesCollection, activeTileId, activeZoom))
+        {
+            _zoomGesturePostponedTiles[activeZoom].insert(activeTileId);
+            requestsPostponed = true;
+            continue;
+        }
+
         // Obtain a resource entry and if it's state is "Unknown", create a task that will
         // request resource data
         std::shared_ptr<MapRendererBaseTiledResource> resource;
@@ -563,8 +651,58 @@ void OsmAnd::MapRendererResourcesManager::requestNeededTiledResources(
                     return nullptr;
             });
 
-        requestNeededResource(resource);
+        if (requestNeededResource(resource) && _zoomGestureInProgress)
+            _zoomGestureTiledResourcesRequested++;
+    }
+
+    return requestsPostponed;
+}
+
+bool OsmAnd::MapRendererResourcesManager::containsReplacementResources(
+    const std::shared_ptr<const IMapRendererTiledResourcesCollection>& resourcesCollection,
+    const TileId tileId,
+    const ZoomLevel zoom)
+{
+    const auto isUsableResource =
+        []
+        (const std::shared_ptr<MapRendererBaseTiledResource>& entry) -> bool
+        {
+            if (entry->isJunk)
+                return false;
+
+            const auto state = entry->getState();
+            return (state == MapRendererResourceState::Uploaded || state == MapRendererResourceState::IsBeingUsed);
+        };
+
+    // Underscaled tiles are accepted only if all of them are present
+    if (zoom < MaxZoomLevel)
+    {
+        const auto underscaledTileIds = Utilities::getTileIdsUnderscaledByZoomShift(tileId, 1);
+        const auto allUnderscaledPresent = std::all_of(underscaledTileIds.cbegin(), underscaledTileIds.cend(),
+            [resourcesCollection, zoom, isUsableResource]
+            (const TileId underscaledTileId) -> bool
+            {
+                return resourcesCollection->containsResource(
+                    underscaledTileId,
+                    static_cast<ZoomLevel>(zoom + 1),
+                    isUsableResource);
+            });
+        if (allUnderscaledPresent)
+            return true;
+    }
+
+    for (int absZoomShift = 1; absZoomShift <= MapRenderer::MaxMissingDataZoomShift; absZoomShift++)
+    {
+        const auto overscaleZoom = static_cast<int>(zoom) - absZoomShift;
+        if (overscaleZoom < static_cast<int>(MinZoomLevel))
+            break;
+
+        const auto overscaledTileId = Utilities::getTileIdOverscaledByZoomShift(tileId, -absZoomShift);
+        if (resourcesCollection->containsResource(overscaledTileId, static_cast<ZoomLevel>(overscaleZoom), isUsableResource))
+            return true;
     }
+
+    return false;
 }
 
 void OsmAnd::MapRendererResourcesManager::requestNeededKeyedResources(const std::shared_ptr<MapRendererKeyedResourcesCollection>& resourcesCollection)
@@ -599,11 +737,11 @@ void OsmAnd::MapRendererResourcesManager::requestNeededKeyedResources(const std:
     }
 }
 
-void OsmAnd::MapRendererResourcesManager::requestNeededResource(const std::shared_ptr<MapRendererBaseResource>& resource)
+bool OsmAnd::MapRendererResourcesManager::requestNeededResource(const std::shared_ptr<MapRendererBaseResource>& resource)
 {
     // Only if tile entry has "Unknown" state proceed to "Requesting" state
     if (!resource->setStateIf(MapRendererResourceState::Unknown, MapRendererResourceState::Requesting))
-        return;
+        return false;
     LOG_RESOURCE_STATE_CHANGE(resource, MapRendererResourceState::Unknown, MapRendererResourceState::Requesting);
 
     // Create async-task that will obtain needed resource data
@@ -711,6 +849,8 @@ void OsmAnd::MapRendererResourcesManager::requestNeededResource(const std::share
 
     // Finally start the request
     _resourcesRequestWorkersPool.start(asyncTask);
+
+    return true;
 }
 
 void OsmAnd::MapRendererResourcesManager::invalidateAllResources()
@@ -855,7 +995,7 @@ bool OsmAnd::MapRendererResourcesManager::checkForUpdatesAndApply() const
     return (updatesApplied || updatesPresent);
 }
 
-void OsmAnd::MapRendererResourcesManager::updateResources(const QSet<TileId>& tiles, const ZoomLevel zoom)
+bool OsmAnd::MapRendererResourcesManager::updateResources(const QSet<TileId>& tiles, const ZoomLevel zoom, const bool zoomSettled)
 {
     // Before requesting missing tiled resources, clean up cache to free some space
     if (!renderer->currentDebugSettings->disableJunkResourcesCleanup)
@@ -864,7 +1004,9 @@ void OsmAnd::MapRendererResourcesManager::updateResources(const QSet<TileId>& ti
     // In the end of rendering processing, request tiled resources that are neither
     // present in requested list, nor in pending, nor in uploaded
     if (!renderer->currentDebugSettings->disableNeededResourcesRequests)
-        requestNeededResources(tiles, zoom);
+        return requestNeededResources(tiles, zoom, zoomSettled);
+
+    return false;
 }
 
 unsigned int OsmAnd::MapRendererResourcesManager::unloadResources()
@@ -921,101 +1063,155 @@ void OsmAnd::MapRendererResourcesManager::unloadResourcesFrom(
     }
 }
 
-unsigned int OsmAnd::MapRendererResourcesManager::uploadResources(const unsigned int limit /*= 0u*/, bool* const outMoreThanLimitAvailable /*= nullptr*/)
+unsigned int OsmAnd::MapRendererResourcesManager::uploadResources(
+    const float timeBudget /*= 0.0f*/,
+    const size_t bytesBudget /*= 0u*/,
+    bool* const outMoreThanBudgetAvailable /*= nullptr*/)
 {
-    unsigned int totalUploaded = 0u;
-    bool moreThanLimitAvailable = false;
-    bool atLeastOneUploadFailed = false;
+    Stopwatch stopwatch(timeBudget > 0.0f);
+
+    // Local copy of active zone
+    QSet<TileId> activeTiles;
+    ZoomLevel activeZoom;
+    {
+        QMutexLocker scopedLocker(&_workerThreadWakeupMutex);
+
+        activeTiles = _activeTiles;
+        activeZoom = _activeZoom;
+    }
+    PointD activeTilesCenter;
+    for (const auto& activeTileId : constOf(activeTiles))
+    {
+        activeTilesCenter.x += activeTileId.x + 0.5;
+        activeTilesCenter.y += activeTileId.y + 0.5;
+    }
+    if (!activeTiles.isEmpty())
+        activeTilesCenter /= activeTiles.size();
 
+    // Select all resources with "Ready" state from all collections
+    QList<ResourceToUpload> resourcesToUpload;
     const auto& resourcesCollections = safeGetAllResourcesCollections();
     for (const auto& resourcesCollection : constOf(resourcesCollections))
-        uploadResourcesFrom(resourcesCollection, limit, totalUploaded, moreThanLimitAvailable, atLeastOneUploadFailed);
+        collectResourcesToUpload(resourcesCollection, activeTiles, activeZoom, activeTilesCenter, resourcesToUpload);
+    std::stable_sort(resourcesToUpload.begin(), resourcesToUpload.end());
+
+    // Upload most important resources first, until budget is spent
+    unsigned int totalUploaded = 0u;
+    size_t totalUploadedBytes = 0u;
+    bool moreThanBudgetAvailable = false;
+    bool atLeastOneUploadFailed = false;
+    renderer->gpuAPI->takeUploadedBytesCount();
+    for (const auto& resourceToUpload : constOf(resourcesToUpload))
+    {
+        if (totalUploaded > 0u &&
+            ((timeBudget > 0.0f && stopwatch.elapsed() >= timeBudget) ||
+            (bytesBudget > 0u && totalUploadedBytes >= bytesBudget)))
+        {
+            // Tell that more resources are available for upload
+            moreThanBudgetAvailable = true;
+            break;
+        }
+
+        if (!uploadResource(resourceToUpload.resource, atLeastOneUploadFailed))
+            continue;
+        totalUploadedBytes += renderer->gpuAPI->takeUploadedBytesCount();
+
+        // Count uploaded resources
+        totalUploaded++;
+    }
 
     // If any resource failed to upload, report that more ready resources are available
     if (atLeastOneUploadFailed)
-        moreThanLimitAvailable = true;
+        moreThanBudgetAvailable = true;
 
-    if (outMoreThanLimitAvailable)
-        *outMoreThanLimitAvailable = moreThanLimitAvailable;
+    if (outMoreThanBudgetAvailable)
+        *outMoreThanBudgetAvailable = moreThanBudgetAvailable;
     return totalUploaded;
 }
 
-void OsmAnd::MapRendererResourcesManager::uploadResourcesFrom(
+void OsmAnd::MapRendererResourcesManager::collectResourcesToUpload(
     const std::shared_ptr<MapRendererBaseResourcesCollection>& collection,
-    const unsigned int limit,
-    unsigned int& totalUploaded,
-    bool& moreThanLimitAvailable,
-    bool& atLeastOneUploadFailed)
+    const QSet<TileId>& activeTiles,
+    const ZoomLevel activeZoom,
+    const PointD& activeTilesCenter,
+    QList<ResourceToUpload>& outResourcesToUpload)
 {
-    // Select all resources with "Ready" state
-    QList< std::shared_ptr<MapRendererBaseResource> > resources;
-    collection->obtainResources(&resources,
-        [&resources, limit, totalUploaded, &moreThanLimitAvailable]
+    collection->obtainResources(nullptr,
+        [&outResourcesToUpload, &activeTiles, activeZoom, &activeTilesCenter]
         (const std::shared_ptr<MapRendererBaseResource>& entry, bool& cancel) -> bool
         {
             // Skip not-ready resources
             if (entry->getState() != MapRendererResourceState::Ready)
                 return false;
 
-            // Check if limit was reached
-            if (limit > 0 && (totalUploaded + resources.size()) > limit)
-            {
-                // Tell that more resources are available for upload
-                moreThanLimitAvailable = true;
+            ResourceToUpload resourceToUpload;
+            resourceToUpload.resource = entry;
+            resourceToUpload.zoomDistance = 0;
+            resourceToUpload.distanceToCenter = 0.0;
 
-                cancel = true;
-                return false;
+            // Keyed resources are not bound to tiles, so they're treated as visible ones. Tiled resources
+            // are ordered by how far their zoom is from active zoom, and then by how far they are from
+            // center of active tiles, in tiles of active zoom
+            if (const auto tiledEntry = std::dynamic_pointer_cast<const MapRendererBaseTiledResource>(entry))
+            {
+                const auto deltaZoom = static_cast<int>(tiledEntry->zoom) - static_cast<int>(activeZoom);
+                if (deltaZoom != 0 || !activeTiles.contains(tiledEntry->tileId))
+                    resourceToUpload.zoomDistance = qAbs(deltaZoom) + 1;
+
+                const auto scale = std::ldexp(1.0, -deltaZoom);
+                const PointD tileCenter(
+                    (tiledEntry->tileId.x + 0.5) * scale,
+                    (tiledEntry->tileId.y + 0.5) * scale);
+                resourceToUpload.distanceToCenter = (tileCenter - activeTilesCenter).norm();
             }
 
-            // Accept this resource
-            return true;
+            outResourcesToUpload.push_back(qMove(resourceToUpload));
+            return false;
         });
-    if (resources.isEmpty())
-        return;
+}
 
-    // Upload to GPU all selected resources
-    for (const auto& resource : constOf(resources))
-    {
-        // Since state change is allowed (it's not changed to "Uploading" during query), check state here
-        if (!resource->setStateIf(MapRendererResourceState::Ready, MapRendererResourceState::Uploading))
-            continue;
-        LOG_RESOURCE_STATE_CHANGE(resource, MapRendererResourceState::Ready, MapRendererResourceState::Uploading);
+bool OsmAnd::MapRendererResourcesManager::uploadResource(
+    const std::shared_ptr<MapRendererBaseResource>& resource,
+    bool& atLeastOneUploadFailed)
+{
+    // Since state change is allowed (it's not changed to "Uploading" during query), check state here
+    if (!resource->setStateIf(MapRendererResourceState::Ready, MapRendererResourceState::Uploading))
+        return false;
+    LOG_RESOURCE_STATE_CHANGE(resource, MapRendererResourceState::Ready, MapRendererResourceState::Uploading);
 
-        // Actually upload resource to GPU
-        const auto didUpload = resource->uploadToGPU();
-        if (!atLeastOneUploadFailed && !didUpload)
-            atLeastOneUploadFailed = true;
-        if (!didUpload)
+    // Actually upload resource to GPU
+    const auto didUpload = resource->uploadToGPU();
+    if (!atLeastOneUploadFailed && !didUpload)
+        atLeastOneUploadFailed = true;
+    if (!didUpload)
+    {
+        if (const auto tiledResource = std::dynamic_pointer_cast<const MapRendererBaseTiledResource>(resource))
         {
-            if (const auto tiledResource = std::dynamic_pointer_cast<const MapRendererBaseTiledResource>(resource))
-            {
-                LogPrintf(LogSeverityLevel::Error,
-                    "Failed to upload tiled resource %p for %dx%d@%d to GPU",
-                    resource.get(),
-                    tiledResource->tileId.x, tiledResource->tileId.y, tiledResource->zoom);
-            }
-            else
-            {
-                LogPrintf(LogSeverityLevel::Error,
-                    "Failed to upload resource %p to GPU",
-                    resource.get());
-            }
-            continue;
+            LogPrintf(LogSeverityLevel::Error,
+                "Failed to upload tiled resource %p for %dx%d@%d to GPU",
+                resource.get(),
+                tiledResource->tileId.x, tiledResource->tileId.y, tiledResource->zoom);
+        }
+        else
+        {
+            LogPrintf(LogSeverityLevel::Error,
+                "Failed to upload resource %p to GPU",
+                resource.get());
         }
+        return false;
+    }
 
-        // Before marking as uploaded, if uploading is done from GPU worker thread,
-        // wait until operation completes
-        if (renderer->setupOptions.gpuWorkerThreadEnabled)
-            renderer->gpuAPI->waitUntilUploadIsComplete();
+    // Before marking as uploaded, if uploading is done from GPU worker thread,
+    // wait until operation completes
+    if (renderer->setupOptions.gpuWorkerThreadEnabled)
+        renderer->gpuAPI->waitUntilUploadIsComplete();
 
-        // Mark as uploaded
-        assert(resource->getState() == MapRendererResourceState::Uploading);
-        resource->setState(MapRendererResourceState::Uploaded);
-        LOG_RESOURCE_STATE_CHANGE(resource, MapRendererResourceState::Uploading, MapRendererResourceState::Uploaded);
+    // Mark as uploaded
+    assert(resource->getState() == MapRendererResourceState::Uploading);
+    resource->setState(MapRendererResourceState::Uploaded);
+    LOG_RESOURCE_STATE_CHANGE(resource, MapRendererResourceState::Uploading, MapRendererResourceState::Uploaded);
 
-        // Count uploaded resources
-        totalUploaded++;
-    }
+    return true;
 }
 
 void OsmAnd::MapRendererResourcesManager::cleanupJunkResources(const QSet<TileId>& activeTiles, const ZoomLevel activeZoom)
@@ -1151,7 +1347,27 @@ void OsmAnd::MapRendererResourcesManager::cleanupJunkResources(const QSet<TileId
                     // giving preference to underscaled resource
                     for (int absZoomShift = 1; absZoomShift <= MapRenderer::MaxMissingDataZoomShift; absZoomShift++)
                     {
-                        //TODO: Try to find underscaled first (that is, currentState.zoomBase + 1). Only full match is accepted
+                        // Try to find underscaled first (that is, activeZoom + 1). Only full match is accepted
+                        const auto underscaleZoom = static_cast<int>(activeZoom) + absZoomShift;
+                        if (absZoomShift == 1 && underscaleZoom <= static_cast<int>(MaxZoomLevel))
+                        {
+                            const auto underscaledTileIds = Utilities::getTileIdsUnderscaledByZoomShift(activeTileId, absZoomShift);
+                            const auto allUnderscaledUsable = std::all_of(underscaledTileIds.cbegin(), underscaledTileIds.cend(),
+                                [tiledResourcesCollection, underscaleZoom, isUsableResource]
+                                (const TileId underscaledTileId) -> bool
+                                {
+                                    return tiledResourcesCollection->containsResource(
+                                        underscaledTileId,
+                                        static_cast<ZoomLevel>(underscaleZoom),
+                                        isUsableResource);
+                                });
+                            if (allUnderscaledUsable)
+                            {
+                                for (const auto& underscaledTileId : constOf(underscaledTileIds))
+                                    neededTilesMap[static_cast<ZoomLevel>(underscaleZoom)].insert(underscaledTileId);
+                                break;
+                            }
+                        }
 
                         // If underscaled was not found, look for overscaled (surely, if such zoom level exists at all)
                         const auto overscaleZoom = static_cast<int>(activeZoom) - absZoomShift;
@@ -1485,8 +1701,9 @@ void OsmAnd::MapRendererResourcesManager::releaseAllResources(const bool gpuCont
 }
 
 void OsmAnd::MapRendererResourcesManager::syncResourcesInGPU(
-    const unsigned int limitUploads /*= 0u*/,
-    bool* const outMoreUploadsThanLimitAvailable /*= nullptr*/,
+    const float uploadTimeBudget /*= 0.0f*/,
+    const size_t uploadBytesBudget /*= 0u*/,
+    bool* const outMoreUploadsThanBudgetAvailable /*= nullptr*/,
     unsigned int* const outResourcesUploaded /*= nullptr*/,
     unsigned int* const outResourcesUnloaded /*= nullptr*/)
 {
@@ -1496,7 +1713,7 @@ void OsmAnd::MapRendererResourcesManager::syncResourcesInGPU(
         *outResourcesUnloaded = resourcesUnloaded;
 
     // Upload resources
-    const auto resourcesUploaded = uploadResources(limitUploads, outMoreUploadsThanLimitAvailable);
+    const auto resourcesUploaded = uploadResources(uploadTimeBudget, uploadBytesBudget, outMoreUploadsThanBudgetAvailable);
     if (outResourcesUploaded)
         *outResourcesUploaded = resourcesUploaded;
 }
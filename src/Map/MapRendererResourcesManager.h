@@ -35,6 +35,7 @@
 #include "SharedResourcesContainer.h"
 #include "Concurrent.h"
 #include "IQueryController.h"
+#include "Stopwatch.h"
 
 namespace OsmAnd
 {
@@ -115,26 +116,69 @@ namespace OsmAnd
         // Resources management:
         QSet<TileId> _activeTiles;
         ZoomLevel _activeZoom;
+        // Measures time since active zoom was changed, to postpone requests of tiles until zoom settles
+        Stopwatch _activeZoomChangeStopwatch;
+        // Zoom gesture lasts from the first change of active zoom until zoom settles and postponed requests
+        // are made. Requests are counted by resources worker during gesture, postponed tiles are counted once
+        // however many times they are postponed. Counters are published and reset when gesture ends
+        bool _zoomGestureInProgress;
+        unsigned int _zoomGestureTiledResourcesRequested;
+        QSet<TileId> _zoomGesturePostponedTiles[ZoomLevelsCount];
+        void finishZoomGesture();
+        mutable QMutex _finishedZoomGesturesMutex;
+        unsigned int _finishedZoomGesturesCount;
+        unsigned int _finishedZoomGesturesTiledResourcesRequested;
+        unsigned int _finishedZoomGesturesTiledResourcesRequestsPostponed;
+        void takeFinishedZoomGesturesStatistics(
+            unsigned int& outGesturesCount,
+            unsigned int& outTiledResourcesRequested,
+            unsigned int& outTiledResourcesRequestsPostponed);
         bool updatesPresent() const;
         bool checkForUpdatesAndApply() const;
-        void updateResources(const QSet<TileId>& tiles, const ZoomLevel zoom);
-        void requestNeededResources(const QSet<TileId>& activeTiles, const ZoomLevel activeZoom);
-        void requestNeededTiledResources(const std::shared_ptr<MapRendererTiledResourcesCollection>& resourcesCollection, const QSet<TileId>& activeTiles, const ZoomLevel activeZoom);
+        bool updateResources(const QSet<TileId>& tiles, const ZoomLevel zoom, const bool zoomSettled);
+        bool requestNeededResources(const QSet<TileId>& activeTiles, const ZoomLevel activeZoom, const bool zoomSettled);
+        bool requestNeededTiledResources(
+            const std::shared_ptr<MapRendererTiledResourcesCollection>& resourcesCollection,
+            const QSet<TileId>& activeTiles,
+            const ZoomLevel activeZoom,
+            const bool zoomSettled);
+        static bool containsReplacementResources(
+            const std::shared_ptr<const IMapRendererTiledResourcesCollection>& resourcesCollection,
+            const TileId tileId,
+            const ZoomLevel zoom);
         void requestNeededKeyedResources(const std::shared_ptr<MapRendererKeyedResourcesCollection>& resourcesCollection);
-        void requestNeededResource(const std::shared_ptr<MapRendererBaseResource>& resource);
+        bool requestNeededResource(const std::shared_ptr<MapRendererBaseResource>& resource);
         void cleanupJunkResources(const QSet<TileId>& activeTiles, const ZoomLevel activeZoom);
         bool cleanupJunkResource(const std::shared_ptr<MapRendererBaseResource>& resource, bool& needsResourcesUploadOrUnload);
         unsigned int unloadResources();
         void unloadResourcesFrom(
             const std::shared_ptr<MapRendererBaseResourcesCollection>& collection,
             unsigned int& totalUnloaded);
-        unsigned int uploadResources(const unsigned int limit = 0u, bool* const outMoreThanLimitAvailable = nullptr);
-        void uploadResourcesFrom(
+        struct ResourceToUpload
+        {
+            std::shared_ptr<MapRendererBaseResource> resource;
+            // 0 for visible resources, otherwise 1 + difference between zoom of resource and active zoom
+            int zoomDistance;
+            double distanceToCenter;
+
+            inline bool operator<(const ResourceToUpload& that) const
+            {
+                if (zoomDistance != that.zoomDistance)
+                    return zoomDistance < that.zoomDistance;
+                return distanceToCenter < that.distanceToCenter;
+            }
+        };
+        unsigned int uploadResources(
+            const float timeBudget = 0.0f,
+            const size_t bytesBudget = 0u,
+            bool* const outMoreThanBudgetAvailable = nullptr);
+        void collectResourcesToUpload(
             const std::shared_ptr<MapRendererBaseResourcesCollection>& collection,
-            const unsigned int limit,
-            unsigned int& totalUploaded,
-            bool& moreThanLimitAvailable,
-            bool& atLeastOneUploadFailed);
+            const QSet<TileId>& activeTiles,
+            const ZoomLevel activeZoom,
+            const PointD& activeTilesCenter,
+            QList<ResourceToUpload>& outResourcesToUpload);
+        bool uploadResource(const std::shared_ptr<MapRendererBaseResource>& resource, bool& atLeastOneUploadFailed);
         void blockingReleaseResourcesFrom(
             const std::shared_ptr<MapRendererBaseResourcesCollection>& collection,
             const bool gpuContextLost);
@@ -169,8 +213,9 @@ namespace OsmAnd
         void updateBindings(const MapRendererState& state, const MapRendererStateChanges updatedMask);
         void updateActiveZone(const QSet<TileId>& tiles, const ZoomLevel zoom);
         void syncResourcesInGPU(
-            const unsigned int limitUploads = 0u,
-            bool* const outMoreUploadsThanLimitAvailable = nullptr,
+            const float uploadTimeBudget = 0.0f,
+            const size_t uploadBytesBudget = 0u,
+            bool* const outMoreUploadsThanBudgetAvailable = nullptr,
             unsigned int* const outResourcesUploaded = nullptr,
             unsigned int* const outResourcesUnloaded = nullptr);
 
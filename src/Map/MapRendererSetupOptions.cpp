@@ -6,6 +6,11 @@ OsmAnd::MapRendererSetupOptions::MapRendererSetupOptions()
     , gpuWorkerThreadEpilogue(nullptr)
     , frameUpdateRequestCallback(nullptr)
     , maxNumberOfRasterMapLayersInBatch(0)
+    , resourcesUploadTimeBudgetPerFrame(0.004f)
+    , resourcesUploadBytesBudgetPerFrame(2 * 1024 * 1024)
+    , atlasTexturesCompactionAreasPerFrame(16)
+    , tilesRequestsDelayAfterZoomChange(0.3f)
+    , skipUnchangedFrames(false)
 {
 }
 
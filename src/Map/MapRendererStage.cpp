@@ -28,3 +28,13 @@ void OsmAnd::MapRendererStage::invalidateFrame()
 {
     renderer->invalidateFrame();
 }
+
+void OsmAnd::MapRendererStage::invalidateSymbols()
+{
+    renderer->invalidateSymbols();
+}
+
+bool OsmAnd::MapRendererStage::areSymbolsInvalidated() const
+{
+    return (renderer->_symbolsInvalidatesToBeProcessed > 0);
+}
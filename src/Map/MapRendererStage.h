@@ -24,6 +24,8 @@ namespace OsmAnd
         Q_DISABLE_COPY_AND_MOVE(MapRendererStage);
     protected:
         void invalidateFrame();
+        void invalidateSymbols();
+        bool areSymbolsInvalidated() const;
     public:
         MapRendererStage(MapRenderer* const renderer);
         virtual ~MapRendererStage();
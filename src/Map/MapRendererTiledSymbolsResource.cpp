@@ -115,8 +115,9 @@ bool OsmAnd::MapRendererTiledSymbolsResource::obtainData(bool& dataAvailable, co
     {
         for (const auto& mapSymbol : constOf(symbolsGroup->symbols))
         {
+            // Text drawn from SDF glyphs has no bitmap to adjust
             const auto rasterMapSymbol = std::dynamic_pointer_cast<RasterMapSymbol>(mapSymbol);
-            if (!rasterMapSymbol)
+            if (!rasterMapSymbol || !rasterMapSymbol->bitmap)
                 continue;
 
             rasterMapSymbol->bitmap = resourcesManager->adjustBitmapToConfiguration(
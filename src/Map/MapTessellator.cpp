@@ -0,0 +1,23 @@
+#include "MapTessellator.h"
+#include "MapTessellator_P.h"
+
+OsmAnd::MapTessellator::MapTessellator(const std::shared_ptr<const MapPresentationEnvironment>& mapPresentationEnvironment_)
+    : _p(new MapTessellator_P(this))
+    , mapPresentationEnvironment(mapPresentationEnvironment_)
+{
+}
+
+OsmAnd::MapTessellator::~MapTessellator()
+{
+}
+
+void OsmAnd::MapTessellator::tessellate(
+    const AreaI area31,
+    const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
+    QVector<Vertex>& outVertices,
+    const bool fillBackground /*= true*/,
+    MapTessellator_Metrics::Metric_tessellate* const metric /*= nullptr*/,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    _p->tessellate(area31, primitivisedObjects, outVertices, fillBackground, metric, controller);
+}
@@ -0,0 +1,29 @@
+#include "MapTessellator_Metrics.h"
+
+OsmAnd::MapTessellator_Metrics::Metric_tessellate::Metric_tessellate()
+{
+    reset();
+}
+
+OsmAnd::MapTessellator_Metrics::Metric_tessellate::~Metric_tessellate()
+{
+}
+
+void OsmAnd::MapTessellator_Metrics::Metric_tessellate::reset()
+{
+    OsmAnd__MapTessellator_Metrics__Metric_tessellate__FIELDS(RESET_METRIC_FIELD);
+
+    Metric::reset();
+}
+
+QString OsmAnd::MapTessellator_Metrics::Metric_tessellate::toString(const bool shortFormat /*= false*/, const QString& prefix /*= QString::null*/) const
+{
+    QString output;
+
+    OsmAnd__MapTessellator_Metrics__Metric_tessellate__FIELDS(PRINT_METRIC_FIELD);
+    const auto submetricsString = Metric::toString(shortFormat, prefix);
+    if (!submetricsString.isEmpty())
+        output += QLatin1String("\n") + Metric::toString(shortFormat, prefix);
+
+    return output;
+}
@@ -0,0 +1,1322 @@
+#include "MapTessellator_P.h"
+#include "MapTessellator.h"
+
+#include "stdlib_common.h"
+#include <deque>
+#include <algorithm>
+#include <limits>
+
+#include "QtCommon.h"
+
+#include "MapPresentationEnvironment.h"
+#include "MapStyleEvaluationResult.h"
+#include "MapStyleBuiltinValueDefinitions.h"
+#include "MapPrimitiviser.h"
+#include "IQueryController.h"
+#include "Stopwatch.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+// Port of mapbox/earcut: ear clipping with holes bridged into outer ring, z-order curve to speed up
+// ear tests of big polygons, and fallbacks for self-intersecting and degenerate input. Original is
+// distributed under the following license:
+//
+// ISC License
+//
+// Copyright (c) 2016, Mapbox
+//
+// Permission to use, copy, modify, and/or distribute this software for any purpose
+// with or without fee is hereby granted, provided that the above copyright notice
+// and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND ISC DISCLAIMS ALL WARRANTIES WITH REGARD TO
+// THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+// IN NO EVENT SHALL ISC BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+// CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA
+// OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+struct OsmAnd::MapTessellator_P::Earcut
+{
+    struct Node
+    {
+        Node(const int i_, const double x_, const double y_)
+            : i(i_)
+            , x(x_)
+            , y(y_)
+            , prev(nullptr)
+            , next(nullptr)
+            , z(0)
+            , prevZ(nullptr)
+            , nextZ(nullptr)
+            , steiner(false)
+        {
+        }
+
+        // Index of vertex in source points
+        int i;
+        double x;
+        double y;
+
+        // Polygon ring
+        Node* prev;
+        Node* next;
+
+        // Z-order curve value and list sorted by it
+        int32_t z;
+        Node* prevZ;
+        Node* nextZ;
+
+        // Hole that is a single point
+        bool steiner;
+    };
+
+    Earcut(const QVector<PointD>& points_, const QVector<int>& holesStarts_, QVector<int>& outIndices_)
+        : points(points_)
+        , holesStarts(holesStarts_)
+        , indices(outIndices_)
+        , minX(0.0)
+        , minY(0.0)
+        , invSize(0.0)
+    {
+    }
+
+    const QVector<PointD>& points;
+    const QVector<int>& holesStarts;
+    QVector<int>& indices;
+
+    // Deque keeps nodes in place while new ones are added
+    std::deque<Node> nodes;
+    double minX;
+    double minY;
+    double invSize;
+
+    void triangulate()
+    {
+        const auto outerEnd = holesStarts.isEmpty() ? points.size() : holesStarts.first();
+        auto outerNode = linkedList(0, outerEnd, true);
+        if (!outerNode || outerNode->next == outerNode->prev)
+            return;
+
+        if (!holesStarts.isEmpty())
+            outerNode = eliminateHoles(outerNode);
+
+        // Hash ear tests only for polygons where it pays off
+        if (points.size() > 80)
+        {
+            auto maxX = minX = points[0].x;
+            auto maxY = minY = points[0].y;
+            for (auto idx = 1; idx < outerEnd; idx++)
+            {
+                const auto& point = points[idx];
+                minX = qMin(minX, point.x);
+                minY = qMin(minY, point.y);
+                maxX = qMax(maxX, point.x);
+                maxY = qMax(maxY, point.y);
+            }
+
+            invSize = qMax(maxX - minX, maxY - minY);
+            invSize = invSize != 0.0 ? 32767.0 / invSize : 0.0;
+        }
+
+        earcutLinked(outerNode, 0);
+    }
+
+    Node* createNode(const int i, const double x, const double y)
+    {
+        nodes.emplace_back(i, x, y);
+        return &nodes.back();
+    }
+
+    Node* insertNode(const int i, Node* const last)
+    {
+        const auto p = createNode(i, points[i].x, points[i].y);
+        if (!last)
+        {
+            p->prev = p;
+            p->next = p;
+        }
+        else
+        {
+            p->next = last->next;
+            p->prev = last;
+            last->next->prev = p;
+            last->next = p;
+        }
+        return p;
+    }
+
+    static void removeNode(Node* const p)
+    {
+        p->next->prev = p->prev;
+        p->prev->next = p->next;
+
+        if (p->prevZ)
+            p->prevZ->nextZ = p->nextZ;
+        if (p->nextZ)
+            p->nextZ->prevZ = p->prevZ;
+    }
+
+    double signedArea(const int start, const int end) const
+    {
+        double sum = 0.0;
+        for (int i = start, j = end - 1; i < end; j = i++)
+            sum += (points[j].x - points[i].x) * (points[i].y + points[j].y);
+        return sum;
+    }
+
+    // Circular linked list of ring with specified winding
+    Node* linkedList(const int start, const int end, const bool clockwise)
+    {
+        Node* last = nullptr;
+        if (clockwise == (signedArea(start, end) > 0.0))
+        {
+            for (auto i = start; i < end; i++)
+                last = insertNode(i, last);
+        }
+        else
+        {
+            for (auto i = end - 1; i >= start; i--)
+                last = insertNode(i, last);
+        }
+
+        if (last && equals(last, last->next))
+        {
+            removeNode(last);
+            last = last->next;
+        }
+
+        return last;
+    }
+
+    // Removes duplicate and collinear points
+    Node* filterPoints(Node* const start, Node* end)
+    {
+        if (!start)
+            return start;
+        if (!end)
+            end = start;
+
+        auto p = start;
+        bool again;
+        do
+        {
+            again = false;
+
+            if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0.0))
+            {
+                removeNode(p);
+                p = end = p->prev;
+                if (p == p->next)
+                    break;
+                again = true;
+            }
+            else
+            {
+                p = p->next;
+            }
+        } while (again || p != end);
+
+        return end;
+    }
+
+    void earcutLinked(Node* ear, const int pass)
+    {
+        if (!ear)
+            return;
+
+        if (pass == 0 && invSize != 0.0)
+            indexCurve(ear);
+
+        auto stop = ear;
+        while (ear->prev != ear->next)
+        {
+            const auto prev = ear->prev;
+            const auto next = ear->next;
+
+            if (invSize != 0.0 ? isEarHashed(ear) : isEar(ear))
+            {
+                indices.push_back(prev->i);
+                indices.push_back(ear->i);
+                indices.push_back(next->i);
+
+                removeNode(ear);
+
+                // Skipping the next vertex leads to less sliver triangles
+                ear = next->next;
+                stop = next->next;
+                continue;
+            }
+
+            ear = next;
+
+            // Whole ring was walked without finding an ear
+            if (ear == stop)
+            {
+                if (pass == 0)
+                {
+                    earcutLinked(filterPoints(ear, nullptr), 1);
+                }
+                else if (pass == 1)
+                {
+                    ear = cureLocalIntersections(filterPoints(ear, nullptr));
+                    earcutLinked(ear, 2);
+                }
+                else if (pass == 2)
+                {
+                    splitEarcut(ear);
+                }
+                break;
+            }
+        }
+    }
+
+    bool isEar(const Node* const ear) const
+    {
+        const auto a = ear->prev;
+        const auto b = ear;
+        const auto c = ear->next;
+
+        // Reflex, can't be an ear
+        if (area(a, b, c) >= 0.0)
+            return false;
+
+        // No points of ring may be inside of ear
+        auto p = ear->next->next;
+        while (p != ear->prev)
+        {
+            if (pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && area(p->prev, p, p->next) >= 0.0)
+                return false;
+            p = p->next;
+        }
+
+        return true;
+    }
+
+    bool isEarHashed(const Node* const ear) const
+    {
+        const auto a = ear->prev;
+        const auto b = ear;
+        const auto c = ear->next;
+
+        if (area(a, b, c) >= 0.0)
+            return false;
+
+        const auto minTX = qMin(a->x, qMin(b->x, c->x));
+        const auto minTY = qMin(a->y, qMin(b->y, c->y));
+        const auto maxTX = qMax(a->x, qMax(b->x, c->x));
+        const auto maxTY = qMax(a->y, qMax(b->y, c->y));
+
+        // Only points within z-range of triangle bbox need to be checked
+        const auto minZ = zOrder(minTX, minTY);
+        const auto maxZ = zOrder(maxTX, maxTY);
+
+        const auto isBlocking =
+            [a, b, c, ear]
+            (const Node* const p) -> bool
+            {
+                return p != ear->prev && p != ear->next &&
+                    pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) &&
+                    area(p->prev, p, p->next) >= 0.0;
+            };
+
+        auto p = ear->prevZ;
+        auto n = ear->nextZ;
+        while (p && p->z >= minZ && n && n->z <= maxZ)
+        {
+            if (isBlocking(p))
+                return false;
+            p = p->prevZ;
+
+            if (isBlocking(n))
+                return false;
+            n = n->nextZ;
+        }
+        while (p && p->z >= minZ)
+        {
+            if (isBlocking(p))
+                return false;
+            p = p->prevZ;
+        }
+        while (n && n->z <= maxZ)
+        {
+            if (isBlocking(n))
+                return false;
+            n = n->nextZ;
+        }
+
+        return true;
+    }
+
+    Node* cureLocalIntersections(Node* start)
+    {
+        auto p = start;
+        do
+        {
+            const auto a = p->prev;
+            const auto b = p->next->next;
+
+            if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a))
+            {
+                indices.push_back(a->i);
+                indices.push_back(p->i);
+                indices.push_back(b->i);
+
+                removeNode(p);
+                removeNode(p->next);
+
+                p = start = b;
+            }
+            p = p->next;
+        } while (p != start);
+
+        return filterPoints(p, nullptr);
+    }
+
+    // Last resort: split polygon by valid diagonal and triangulate both halves
+    void splitEarcut(Node* const start)
+    {
+        auto a = start;
+        do
+        {
+            auto b = a->next->next;
+            while (b != a->prev)
+            {
+                if (a->i != b->i && isValidDiagonal(a, b))
+                {
+                    auto c = splitPolygon(a, b);
+
+                    a = filterPoints(a, a->next);
+                    c = filterPoints(c, c->next);
+
+                    earcutLinked(a, 0);
+                    earcutLinked(c, 0);
+                    return;
+                }
+                b = b->next;
+            }
+            a = a->next;
+        } while (a != start);
+    }
+
+    Node* eliminateHoles(Node* outerNode)
+    {
+        QVector<Node*> queue;
+        queue.reserve(holesStarts.size());
+        for (auto holeIdx = 0; holeIdx < holesStarts.size(); holeIdx++)
+        {
+            const auto start = holesStarts[holeIdx];
+            const auto end = (holeIdx + 1 < holesStarts.size()) ? holesStarts[holeIdx + 1] : points.size();
+            const auto list = linkedList(start, end, false);
+            if (!list)
+                continue;
+            if (list == list->next)
+                list->steiner = true;
+            queue.push_back(getLeftmost(list));
+        }
+
+        std::sort(queue.begin(), queue.end(),
+            []
+            (const Node* const l, const Node* const r) -> bool
+            {
+                return l->x < r->x;
+            });
+
+        // Bridge holes from left to right
+        for (const auto hole : constOf(queue))
+            outerNode = eliminateHole(hole, outerNode);
+
+        return outerNode;
+    }
+
+    Node* eliminateHole(Node* const hole, Node* const outerNode)
+    {
+        const auto bridge = findHoleBridge(hole, outerNode);
+        if (!bridge)
+            return outerNode;
+
+        const auto bridgeReverse = splitPolygon(bridge, hole);
+        filterPoints(bridgeReverse, bridgeReverse->next);
+        return filterPoints(bridge, bridge->next);
+    }
+
+    // David Eberly's algorithm for finding a bridge between hole and outer polygon
+    Node* findHoleBridge(const Node* const hole, Node* const outerNode) const
+    {
+        const auto hx = hole->x;
+        const auto hy = hole->y;
+        auto qx = -std::numeric_limits<double>::infinity();
+        Node* m = nullptr;
+
+        // Find a segment intersected by a ray from the hole's leftmost point to the left;
+        // segment's endpoint with lesser x will be potential connection point
+        auto p = outerNode;
+        do
+        {
+            if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+            {
+                const auto x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+                if (x <= hx && x > qx)
+                {
+                    qx = x;
+                    m = p->x < p->next->x ? p : p->next;
+                    if (x == hx)
+                        return m;
+                }
+            }
+            p = p->next;
+        } while (p != outerNode);
+
+        if (!m)
+            return nullptr;
+
+        // Look for points inside the triangle of hole point, segment intersection and endpoint;
+        // if there are none, connection is valid, otherwise use the point with minimum angle with the ray
+        const auto stop = m;
+        const auto mx = m->x;
+        const auto my = m->y;
+        auto tanMin = std::numeric_limits<double>::infinity();
+
+        p = m;
+        do
+        {
+            if (hx >= p->x && p->x >= mx && hx != p->x &&
+                pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y))
+            {
+                const auto tan = qAbs(hy - p->y) / (hx - p->x);
+
+                if (locallyInside(p, hole) &&
+                    (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p))))))
+                {
+                    m = p;
+                    tanMin = tan;
+                }
+            }
+            p = p->next;
+        } while (p != stop);
+
+        return m;
+    }
+
+    static bool sectorContainsSector(const Node* const m, const Node* const p)
+    {
+        return area(m->prev, m, p->prev) < 0.0 && area(p->next, m, m->next) < 0.0;
+    }
+
+    void indexCurve(Node* const start) const
+    {
+        auto p = start;
+        do
+        {
+            if (p->z == 0)
+                p->z = zOrder(p->x, p->y);
+            p->prevZ = p->prev;
+            p->nextZ = p->next;
+            p = p->next;
+        } while (p != start);
+
+        p->prevZ->nextZ = nullptr;
+        p->prevZ = nullptr;
+
+        sortLinked(p);
+    }
+
+    // Simon Tatham's linked list merge sort
+    static Node* sortLinked(Node* list)
+    {
+        int numMerges;
+        int inSize = 1;
+
+        do
+        {
+            auto p = list;
+            list = nullptr;
+            Node* tail = nullptr;
+            numMerges = 0;
+
+            while (p)
+            {
+                numMerges++;
+                auto q = p;
+                auto pSize = 0;
+                for (auto i = 0; i < inSize; i++)
+                {
+                    pSize++;
+                    q = q->nextZ;
+                    if (!q)
+                        break;
+                }
+                auto qSize = inSize;
+
+                while (pSize > 0 || (qSize > 0 && q))
+                {
+                    Node* e;
+                    if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z))
+                    {
+                        e = p;
+                        p = p->nextZ;
+                        pSize--;
+                    }
+                    else
+                    {
+                        e = q;
+                        q = q->nextZ;
+                        qSize--;
+                    }
+
+                    if (tail)
+                        tail->nextZ = e;
+                    else
+                        list = e;
+
+                    e->prevZ = tail;
+                    tail = e;
+                }
+
+                p = q;
+            }
+
+            tail->nextZ = nullptr;
+            inSize *= 2;
+        } while (numMerges > 1);
+
+        return list;
+    }
+
+    // Z-order of point, coordinates are mapped to 15-bit integers
+    int32_t zOrder(const double x_, const double y_) const
+    {
+        auto x = static_cast<int32_t>((x_ - minX) * invSize);
+        auto y = static_cast<int32_t>((y_ - minY) * invSize);
+
+        x = (x | (x << 8)) & 0x00FF00FF;
+        x = (x | (x << 4)) & 0x0F0F0F0F;
+        x = (x | (x << 2)) & 0x33333333;
+        x = (x | (x << 1)) & 0x55555555;
+
+        y = (y | (y << 8)) & 0x00FF00FF;
+        y = (y | (y << 4)) & 0x0F0F0F0F;
+        y = (y | (y << 2)) & 0x33333333;
+        y = (y | (y << 1)) & 0x55555555;
+
+        return x | (y << 1);
+    }
+
+    static Node* getLeftmost(Node* const start)
+    {
+        auto p = start;
+        auto leftmost = start;
+        do
+        {
+            if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+                leftmost = p;
+            p = p->next;
+        } while (p != start);
+
+        return leftmost;
+    }
+
+    static bool pointInTriangle(
+        const double ax, const double ay,
+        const double bx, const double by,
+        const double cx, const double cy,
+        const double px, const double py)
+    {
+        return
+            (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+            (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+            (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    // Diagonal doesn't intersect edges and lies inside of polygon
+    static bool isValidDiagonal(const Node* const a, const Node* const b)
+    {
+        return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b) &&
+            ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+                (area(a->prev, a, b->prev) != 0.0 || area(a, b->prev, b) != 0.0)) ||
+            (equals(a, b) && area(a->prev, a, a->next) > 0.0 && area(b->prev, b, b->next) > 0.0));
+    }
+
+    static double area(const Node* const p, const Node* const q, const Node* const r)
+    {
+        return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+    }
+
+    static bool equals(const Node* const p1, const Node* const p2)
+    {
+        return p1->x == p2->x && p1->y == p2->y;
+    }
+
+    static int sign(const double value)
+    {
+        return (value > 0.0) - (value < 0.0);
+    }
+
+    static bool onSegment(const Node* const p, const Node* const q, const Node* const r)
+    {
+        return
+            q->x <= qMax(p->x, r->x) && q->x >= qMin(p->x, r->x) &&
+            q->y <= qMax(p->y, r->y) && q->y >= qMin(p->y, r->y);
+    }
+
+    static bool intersects(const Node* const p1, const Node* const q1, const Node* const p2, const Node* const q2)
+    {
+        const auto o1 = sign(area(p1, q1, p2));
+        const auto o2 = sign(area(p1, q1, q2));
+        const auto o3 = sign(area(p2, q2, p1));
+        const auto o4 = sign(area(p2, q2, q1));
+
+        if (o1 != o2 && o3 != o4)
+            return true;
+
+        // Collinear cases
+        if (o1 == 0 && onSegment(p1, p2, q1))
+            return true;
+        if (o2 == 0 && onSegment(p1, q2, q1))
+            return true;
+        if (o3 == 0 && onSegment(p2, p1, q2))
+            return true;
+        if (o4 == 0 && onSegment(p2, q1, q2))
+            return true;
+
+        return false;
+    }
+
+    static bool intersectsPolygon(const Node* const a, const Node* const b)
+    {
+        auto p = a;
+        do
+        {
+            if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+                intersects(p, p->next, a, b))
+            {
+                return true;
+            }
+            p = p->next;
+        } while (p != a);
+
+        return false;
+    }
+
+    static bool locallyInside(const Node* const a, const Node* const b)
+    {
+        return area(a->prev, a, a->next) < 0.0
+            ? area(a, b, a->next) >= 0.0 && area(a, a->prev, b) >= 0.0
+            : area(a, b, a->prev) < 0.0 || area(a, a->next, b) < 0.0;
+    }
+
+    static bool middleInside(const Node* const a, const Node* const b)
+    {
+        auto p = a;
+        auto inside = false;
+        const auto px = (a->x + b->x) / 2.0;
+        const auto py = (a->y + b->y) / 2.0;
+        do
+        {
+            if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+                (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+            {
+                inside = !inside;
+            }
+            p = p->next;
+        } while (p != a);
+
+        return inside;
+    }
+
+    // Links a and b with a bridge; if they belong to the same ring, splits it in two
+    Node* splitPolygon(Node* const a, Node* const b)
+    {
+        const auto a2 = createNode(a->i, a->x, a->y);
+        const auto b2 = createNode(b->i, b->x, b->y);
+        const auto an = a->next;
+        const auto bp = b->prev;
+
+        a->next = b;
+        b->prev = a;
+
+        a2->next = an;
+        an->prev = a2;
+
+        b2->next = a2;
+        a2->prev = b2;
+
+        bp->next = b2;
+        b2->prev = bp;
+
+        return b2;
+    }
+};
+
+OsmAnd::MapTessellator_P::MapTessellator_P(MapTessellator* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::MapTessellator_P::~MapTessellator_P()
+{
+}
+
+void OsmAnd::MapTessellator_P::tessellate(
+    const AreaI area31,
+    const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
+    QVector<Vertex>& outVertices,
+    const bool fillBackground,
+    MapTessellator_Metrics::Metric_tessellate* const metric,
+    const IQueryController* const controller)
+{
+    const Stopwatch totalStopwatch(metric != nullptr);
+
+    const Context context(area31, primitivisedObjects, outVertices);
+    const auto initialVerticesCount = outVertices.size();
+
+    if (fillBackground)
+    {
+        const auto defaultBackgroundColor = context.env->getDefaultBackgroundColor(context.zoom);
+
+        const PointD topLeft(0.0, 0.0);
+        const PointD topRight(context.tileSize.x, 0.0);
+        const PointD bottomLeft(0.0, context.tileSize.y);
+        const PointD bottomRight(context.tileSize.x, context.tileSize.y);
+        addTriangle(context, topLeft, bottomLeft, topRight, defaultBackgroundColor);
+        addTriangle(context, topRight, bottomLeft, bottomRight, defaultBackgroundColor);
+    }
+
+    // Polygons go first, same as on raster path
+    const Stopwatch polygonsStopwatch(metric != nullptr);
+    for (const auto& primitive : constOf(primitivisedObjects->polygons))
+    {
+        if (controller && controller->isAborted())
+            return;
+
+        tessellatePolygon(context, primitive);
+    }
+    if (metric)
+    {
+        metric->polygonsTriangulated += primitivisedObjects->polygons.size();
+        metric->elapsedTimeForPolygons += polygonsStopwatch.elapsed();
+    }
+
+    const Stopwatch polylinesStopwatch(metric != nullptr);
+    for (const auto& primitive : constOf(primitivisedObjects->polylines))
+    {
+        if (controller && controller->isAborted())
+            return;
+
+        tessellatePolyline(context, primitive);
+    }
+    if (metric)
+    {
+        metric->polylinesExtruded += primitivisedObjects->polylines.size();
+        metric->elapsedTimeForPolylines += polylinesStopwatch.elapsed();
+    }
+
+    if (metric)
+    {
+        metric->trianglesCount += (outVertices.size() - initialVerticesCount) / 3;
+        metric->elapsedTime += totalStopwatch.elapsed();
+    }
+}
+
+bool OsmAnd::MapTessellator_P::obtainStroke(
+    const Context& context,
+    const MapStyleEvaluationResult& evalResult,
+    const PaintValuesSet valueSetSelector,
+    Stroke& outStroke) const
+{
+    const auto& env = context.env;
+
+    int valueDefId_color = -1;
+    int valueDefId_strokeWidth = -1;
+    int valueDefId_cap = -1;
+    switch (valueSetSelector)
+    {
+        case PaintValuesSet::Layer_minus2:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR__2;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH__2;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP__2;
+            break;
+        case PaintValuesSet::Layer_minus1:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR__1;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH__1;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP__1;
+            break;
+        case PaintValuesSet::Layer_0:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR_0;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH_0;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP_0;
+            break;
+        case PaintValuesSet::Layer_1:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP;
+            break;
+        case PaintValuesSet::Layer_2:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR_2;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH_2;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP_2;
+            break;
+        case PaintValuesSet::Layer_3:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR_3;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH_3;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP_3;
+            break;
+        case PaintValuesSet::Layer_4:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR_4;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH_4;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP_4;
+            break;
+        case PaintValuesSet::Layer_5:
+            valueDefId_color = env->styleBuiltinValueDefs->id_OUTPUT_COLOR_5;
+            valueDefId_strokeWidth = env->styleBuiltinValueDefs->id_OUTPUT_STROKE_WIDTH_5;
+            valueDefId_cap = env->styleBuiltinValueDefs->id_OUTPUT_CAP_5;
+            break;
+        default:
+            return false;
+    }
+
+    float strokeWidth = 0.0f;
+    if (!evalResult.getFloatValue(valueDefId_strokeWidth, strokeWidth) || strokeWidth <= 0.0f)
+        return false;
+    outStroke.width = strokeWidth;
+
+    outStroke.color = ColorARGB(0x00000000);
+    evalResult.getIntegerValue(valueDefId_color, outStroke.color.argb);
+
+    QString cap;
+    const auto ok = evalResult.getStringValue(valueDefId_cap, cap);
+    if (ok && cap.compare(QLatin1String("ROUND"), Qt::CaseInsensitive) == 0)
+        outStroke.cap = Cap::Round;
+    else if (ok && cap.compare(QLatin1String("SQUARE"), Qt::CaseInsensitive) == 0)
+        outStroke.cap = Cap::Square;
+    else
+        outStroke.cap = Cap::Butt;
+
+    return true;
+}
+
+void OsmAnd::MapTessellator_P::tessellatePolygon(
+    const Context& context,
+    const std::shared_ptr<const MapPrimitiviser::Primitive>& primitive)
+{
+    const auto& env = context.env;
+    const auto& evalResult = primitive->evaluationResult;
+
+    assert(primitive->sourceObject->points31.size() > 2);
+    assert(primitive->sourceObject->isClosedFigure());
+
+    // Shader-only areas are not filled, but still get an outline
+    ColorARGB fillColor(0x00000000);
+    const auto hasColor = evalResult.getIntegerValue(env->styleBuiltinValueDefs->id_OUTPUT_COLOR, fillColor.argb);
+    if (!hasColor && !evalResult.contains(env->styleBuiltinValueDefs->id_OUTPUT_SHADER))
+        return;
+
+    QVector<PointD> outerRing;
+    obtainRing(context, primitive->sourceObject->points31, outerRing);
+    if (outerRing.size() < 3)
+        return;
+
+    QVector< QVector<PointD> > innerRings;
+    for (const auto& innerPolygon : constOf(primitive->sourceObject->innerPolygonsPoints31))
+    {
+        QVector<PointD> innerRing;
+        obtainRing(context, innerPolygon, innerRing);
+        if (innerRing.size() >= 3)
+            innerRings.push_back(qMove(innerRing));
+    }
+
+    // Rings are clipped one by one, holes stay holes inside of clipped outer ring
+    QVector<PointD> points;
+    clipRing(outerRing, context.clipArea, points);
+    if (points.size() < 3)
+        return;
+
+    if (!fillColor.isTransparent())
+    {
+        QVector<int> holesStarts;
+        QVector<PointD> clippedInnerRing;
+        for (const auto& innerRing : constOf(innerRings))
+        {
+            clipRing(innerRing, context.clipArea, clippedInnerRing);
+            if (clippedInnerRing.size() < 3)
+                continue;
+
+            holesStarts.push_back(points.size());
+            points += clippedInnerRing;
+        }
+
+        QVector<int> indices;
+        indices.reserve(3 * points.size());
+        Earcut(points, holesStarts, indices).triangulate();
+
+        context.vertices.reserve(context.vertices.size() + indices.size());
+        for (auto idx = 0; idx + 2 < indices.size(); idx += 3)
+            addTriangle(context, points[indices[idx]], points[indices[idx + 1]], points[indices[idx + 2]], fillColor);
+    }
+
+    Stroke stroke;
+    if (obtainStroke(context, evalResult, PaintValuesSet::Layer_2, stroke))
+    {
+        extrudePolyline(context, outerRing, true, stroke);
+        for (const auto& innerRing : constOf(innerRings))
+            extrudePolyline(context, innerRing, true, stroke);
+    }
+}
+
+void OsmAnd::MapTessellator_P::tessellatePolyline(
+    const Context& context,
+    const std::shared_ptr<const MapPrimitiviser::Primitive>& primitive)
+{
+    const auto& evalResult = primitive->evaluationResult;
+
+    assert(primitive->sourceObject->points31.size() >= 2);
+
+    Stroke stroke;
+    if (!obtainStroke(context, evalResult, PaintValuesSet::Layer_1, stroke))
+        return;
+
+    // Closed polyline loses its repeated last point, so its closing segment has to be extruded explicitly
+    const auto& points31 = primitive->sourceObject->points31;
+    QVector<PointD> points;
+    obtainRing(context, points31, points);
+    if (points.size() < 2)
+        return;
+    const auto closed = points31.first() == points31.last() && points.size() > 2;
+
+    static const PaintValuesSet layers[] =
+    {
+        PaintValuesSet::Layer_minus2,
+        PaintValuesSet::Layer_minus1,
+        PaintValuesSet::Layer_0,
+        PaintValuesSet::Layer_1,
+        PaintValuesSet::Layer_2,
+        PaintValuesSet::Layer_3,
+        PaintValuesSet::Layer_4,
+        PaintValuesSet::Layer_5,
+    };
+    for (const auto layer : layers)
+    {
+        if (obtainStroke(context, evalResult, layer, stroke))
+            extrudePolyline(context, points, closed, stroke);
+    }
+}
+
+void OsmAnd::MapTessellator_P::extrudePolyline(
+    const Context& context,
+    const QVector<PointD>& points,
+    const bool closed,
+    const Stroke& stroke)
+{
+    if (stroke.color.isTransparent())
+        return;
+
+    const auto halfWidth = stroke.width / 2.0;
+    const auto visibleArea = context.clipArea.getEnlargedBy(halfWidth);
+
+    // Skia's default miter limit
+    const auto miterLimit = 4.0;
+
+    const auto pointsCount = points.size();
+    const auto segmentsCount = closed ? pointsCount : pointsCount - 1;
+    if (segmentsCount <= 0)
+        return;
+
+    QVector<PointD> directions(segmentsCount);
+    QVector<double> lengths(segmentsCount);
+    QVector<bool> visibilities(segmentsCount);
+    for (auto segmentIdx = 0; segmentIdx < segmentsCount; segmentIdx++)
+    {
+        const auto& start = points[segmentIdx];
+        const auto& end = points[(segmentIdx + 1) % pointsCount];
+
+        const auto delta = end - start;
+        const auto length = qSqrt(delta.x * delta.x + delta.y * delta.y);
+        directions[segmentIdx] = PointD(delta.x / length, delta.y / length);
+        lengths[segmentIdx] = length;
+        visibilities[segmentIdx] = visibleArea.intersects(
+            qMin(start.y, end.y),
+            qMin(start.x, end.x),
+            qMax(start.y, end.y),
+            qMax(start.x, end.x));
+    }
+
+    // Point N joins segment N - 1 with segment N, first point of closed ring joins with last segment
+    const auto hasJoin =
+        [closed, segmentsCount]
+        (const int pointIdx) -> bool
+        {
+            return closed || (pointIdx > 0 && pointIdx < segmentsCount);
+        };
+
+    // All triangles of a stroke are drawn at once, so any overlap is blended twice and shows up on semi-transparent
+    // strokes. Segments overlap on the inner side of a join, so there they end where their inner edges intersect,
+    // which is tan(turnAngle / 2) of half-width away from joint point. Sign tells on which side of segments inner
+    // edge is: positive for the side of normal. Joins of too short segments are left overlapping
+    QVector<double> innerShifts(pointsCount, 0.0);
+    for (auto pointIdx = 0; pointIdx < pointsCount; pointIdx++)
+    {
+        if (!hasJoin(pointIdx))
+            continue;
+
+        const auto prevSegmentIdx = (pointIdx + segmentsCount - 1) % segmentsCount;
+        const auto& prevDirection = directions[prevSegmentIdx];
+        const auto& direction = directions[pointIdx];
+        const auto cross = prevDirection.x * direction.y - prevDirection.y * direction.x;
+        const auto dot = prevDirection.x * direction.x + prevDirection.y * direction.y;
+        if (qAbs(cross) <= 1.0e-6 || 1.0 + dot <= 1.0e-6)
+            continue;
+
+        const auto shift = halfWidth * qAbs(cross) / (1.0 + dot);
+        if (2.0 * shift <= qMin(lengths[prevSegmentIdx], lengths[pointIdx]))
+            innerShifts[pointIdx] = cross > 0.0 ? shift : -shift;
+    }
+
+    for (auto segmentIdx = 0; segmentIdx < segmentsCount; segmentIdx++)
+    {
+        if (!visibilities[segmentIdx])
+            continue;
+
+        const auto& start = points[segmentIdx];
+        const auto& end = points[(segmentIdx + 1) % pointsCount];
+        const auto& direction = directions[segmentIdx];
+        const PointD normal(-direction.y * halfWidth, direction.x * halfWidth);
+
+        auto extrudedStart = start;
+        auto extrudedEnd = end;
+        if (!closed && stroke.cap == Cap::Square)
+        {
+            if (segmentIdx == 0)
+                extrudedStart -= direction * halfWidth;
+            if (segmentIdx == segmentsCount - 1)
+                extrudedEnd += direction * halfWidth;
+        }
+
+        auto startLeft = extrudedStart + normal;
+        auto startRight = extrudedStart - normal;
+        auto endLeft = extrudedEnd + normal;
+        auto endRight = extrudedEnd - normal;
+        const auto startShift = innerShifts[segmentIdx];
+        if (startShift > 0.0)
+            startLeft += direction * startShift;
+        else if (startShift < 0.0)
+            startRight -= direction * startShift;
+        const auto endShift = innerShifts[(segmentIdx + 1) % pointsCount];
+        if (endShift > 0.0)
+            endLeft -= direction * endShift;
+        else if (endShift < 0.0)
+            endRight += direction * endShift;
+        addTriangle(context, startLeft, startRight, endLeft, stroke.color);
+        addTriangle(context, endLeft, startRight, endRight, stroke.color);
+
+        if (!closed && stroke.cap == Cap::Round)
+        {
+            const auto normalAngle = qAtan2(normal.y, normal.x);
+            if (segmentIdx == 0)
+                addArc(context, start, halfWidth, normalAngle, M_PI, stroke.color);
+            if (segmentIdx == segmentsCount - 1)
+                addArc(context, end, halfWidth, normalAngle, -M_PI, stroke.color);
+        }
+    }
+
+    for (auto pointIdx = 0; pointIdx < pointsCount; pointIdx++)
+    {
+        if (!hasJoin(pointIdx))
+            continue;
+        const auto prevSegmentIdx = (pointIdx + segmentsCount - 1) % segmentsCount;
+        if (!visibilities[prevSegmentIdx] && !visibilities[pointIdx])
+            continue;
+
+        const auto& point = points[pointIdx];
+        const auto& prevDirection = directions[prevSegmentIdx];
+        const auto& direction = directions[pointIdx];
+        const auto cross = prevDirection.x * direction.y - prevDirection.y * direction.x;
+        const auto dot = prevDirection.x * direction.x + prevDirection.y * direction.y;
+        if (qAbs(cross) <= 1.0e-6 && dot >= 0.0)
+            continue;
+
+        // Gap opens on the side opposite to the turn
+        const auto side = cross > 0.0 ? -halfWidth : halfWidth;
+        const PointD outer1(-prevDirection.y * side, prevDirection.x * side);
+        const PointD outer2(-direction.y * side, direction.x * side);
+
+        // Join is fanned from where inner edges of segments end
+        const auto innerShift = qAbs(innerShifts[pointIdx]);
+        const auto apex = innerShift > 0.0
+            ? point - outer2 + direction * innerShift
+            : point;
+
+        const auto cosHalfAngle = qSqrt(qMax(0.0, (1.0 + dot) / 2.0));
+        if (cosHalfAngle * miterLimit >= 1.0)
+        {
+            const auto bisector = outer1 + outer2;
+            const auto bisectorLength = qSqrt(bisector.x * bisector.x + bisector.y * bisector.y);
+            const auto miter = point + bisector * (halfWidth / (cosHalfAngle * bisectorLength));
+            addTriangle(context, apex, point + outer1, miter, stroke.color);
+            addTriangle(context, apex, miter, point + outer2, stroke.color);
+        }
+        else
+        {
+            addTriangle(context, apex, point + outer1, point + outer2, stroke.color);
+        }
+    }
+}
+
+void OsmAnd::MapTessellator_P::obtainRing(
+    const Context& context,
+    const QVector<PointI>& points31,
+    QVector<PointD>& outRing)
+{
+    const auto& scaleDivisor31ToPixel = context.primitivisedObjects->scaleDivisor31ToPixel;
+    const auto& area31 = context.area31;
+
+    outRing.clear();
+    outRing.reserve(points31.size());
+    for (const auto& point31 : constOf(points31))
+    {
+        const PointD vertex(
+            (static_cast<double>(point31.x) - area31.left()) / scaleDivisor31ToPixel.x,
+            (static_cast<double>(point31.y) - area31.top()) / scaleDivisor31ToPixel.y);
+
+        // Repeated points produce degenerate segments
+        if (!outRing.isEmpty() && outRing.last() == vertex)
+            continue;
+        outRing.push_back(vertex);
+    }
+
+    // Closed figures repeat the first point at the end
+    if (outRing.size() > 1 && outRing.first() == outRing.last())
+        outRing.removeLast();
+}
+
+void OsmAnd::MapTessellator_P::clipRing(
+    const QVector<PointD>& ring,
+    const AreaD& clipArea,
+    QVector<PointD>& outRing)
+{
+    outRing.clear();
+    if (ring.isEmpty())
+        return;
+
+    AreaD bbox(ring.first(), ring.first());
+    for (const auto& point : constOf(ring))
+        bbox.enlargeToInclude(point);
+    if (!clipArea.intersects(bbox))
+        return;
+    if (clipArea.contains(bbox))
+    {
+        outRing = ring;
+        return;
+    }
+
+    // Sutherland-Hodgman, clip area is convex so each edge is processed separately
+    QVector<PointD> input;
+    outRing = ring;
+    for (auto edge = 0; edge < 4 && !outRing.isEmpty(); edge++)
+    {
+        input.swap(outRing);
+        outRing.clear();
+
+        const auto isInside =
+            [edge, &clipArea]
+            (const PointD& p) -> bool
+            {
+                switch (edge)
+                {
+                    case 0:
+                        return p.x >= clipArea.left();
+                    case 1:
+                        return p.x <= clipArea.right();
+                    case 2:
+                        return p.y >= clipArea.top();
+                    default:
+                        return p.y <= clipArea.bottom();
+                }
+            };
+        const auto intersection =
+            [edge, &clipArea]
+            (const PointD& p, const PointD& q) -> PointD
+            {
+                if (edge < 2)
+                {
+                    const auto x = (edge == 0) ? clipArea.left() : clipArea.right();
+                    return PointD(x, p.y + (x - p.x) * (q.y - p.y) / (q.x - p.x));
+                }
+                const auto y = (edge == 2) ? clipArea.top() : clipArea.bottom();
+                return PointD(p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y), y);
+            };
+
+        auto prev = input.last();
+        auto prevInside = isInside(prev);
+        for (const auto& point : constOf(input))
+        {
+            const auto inside = isInside(point);
+            if (inside != prevInside)
+                outRing.push_back(intersection(prev, point));
+            if (inside)
+                outRing.push_back(point);
+
+            prev = point;
+            prevInside = inside;
+        }
+    }
+}
+
+void OsmAnd::MapTessellator_P::addTriangle(
+    const Context& context,
+    const PointD& a,
+    const PointD& b,
+    const PointD& c,
+    const ColorARGB color)
+{
+    Vertex vertex;
+    vertex.color = color;
+
+    vertex.positionXY[0] = static_cast<float>(a.x / context.tileSize.x);
+    vertex.positionXY[1] = static_cast<float>(a.y / context.tileSize.y);
+    context.vertices.push_back(vertex);
+
+    vertex.positionXY[0] = static_cast<float>(b.x / context.tileSize.x);
+    vertex.positionXY[1] = static_cast<float>(b.y / context.tileSize.y);
+    context.vertices.push_back(vertex);
+
+    vertex.positionXY[0] = static_cast<float>(c.x / context.tileSize.x);
+    vertex.positionXY[1] = static_cast<float>(c.y / context.tileSize.y);
+    context.vertices.push_back(vertex);
+}
+
+void OsmAnd::MapTessellator_P::addArc(
+    const Context& context,
+    const PointD& center,
+    const double radius,
+    const double startAngle,
+    const double sweepAngle,
+    const ColorARGB color)
+{
+    // Segment per 22.5 degrees is smooth enough for line widths in use
+    const auto stepsCount = qMax(1, qCeil(qAbs(sweepAngle) / (M_PI / 8.0)));
+    const auto stepAngle = sweepAngle / stepsCount;
+
+    PointD prev(center.x + radius * qCos(startAngle), center.y + radius * qSin(startAngle));
+    for (auto stepIdx = 1; stepIdx <= stepsCount; stepIdx++)
+    {
+        const auto angle = startAngle + stepIdx * stepAngle;
+        const PointD current(center.x + radius * qCos(angle), center.y + radius * qSin(angle));
+        addTriangle(context, center, prev, current, color);
+        prev = current;
+    }
+}
+
+OsmAnd::MapTessellator_P::Context::Context(
+    const AreaI area31_,
+    const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects_,
+    QVector<Vertex>& vertices_)
+    : area31(area31_)
+    , primitivisedObjects(primitivisedObjects_)
+    , env(primitivisedObjects->mapPresentationEnvironment)
+    , zoom(primitivisedObjects->zoom)
+    , tileSize(
+        (static_cast<double>(area31.right()) - area31.left()) / primitivisedObjects->scaleDivisor31ToPixel.x,
+        (static_cast<double>(area31.bottom()) - area31.top()) / primitivisedObjects->scaleDivisor31ToPixel.y)
+    , clipArea(AreaD(0.0, 0.0, tileSize.y, tileSize.x).getEnlargedBy(1.0))
+    , vertices(vertices_)
+{
+}
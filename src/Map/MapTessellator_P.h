@@ -0,0 +1,144 @@
+#ifndef _OSMAND_CORE_MAP_TESSELLATOR_P_H_
+#define _OSMAND_CORE_MAP_TESSELLATOR_P_H_
+
+#include "stdlib_common.h"
+#include <functional>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "MapCommonTypes.h"
+#include "MapPrimitiviser.h"
+#include "MapPresentationEnvironment.h"
+#include "MapTessellator.h"
+#include "MapTessellator_Metrics.h"
+
+namespace OsmAnd
+{
+    class IQueryController;
+
+    class MapTessellator;
+    class MapTessellator_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapTessellator_P);
+    public:
+        typedef MapTessellator::Vertex Vertex;
+
+    private:
+        struct Context
+        {
+            Context(
+                const AreaI area31,
+                const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
+                QVector<Vertex>& vertices);
+
+            const AreaI area31;
+            const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects> primitivisedObjects;
+            const std::shared_ptr<const MapPresentationEnvironment> env;
+            const ZoomLevel zoom;
+
+            // Size of tile in pixels, as primitives were primitivised for
+            const PointD tileSize;
+            // Tile in pixels, slightly enlarged so that neighbour tiles have no seams between them
+            const AreaD clipArea;
+
+            QVector<Vertex>& vertices;
+
+        private:
+            Q_DISABLE_COPY_AND_MOVE(Context);
+        };
+
+        enum class PaintValuesSet
+        {
+            Layer_minus2,
+            Layer_minus1,
+            Layer_0,
+            Layer_1,
+            Layer_2,
+            Layer_3,
+            Layer_4,
+            Layer_5,
+        };
+
+        enum class Cap
+        {
+            Butt,
+            Round,
+            Square,
+        };
+
+        struct Stroke
+        {
+            ColorARGB color;
+            double width;
+            Cap cap;
+        };
+
+        // Ear clipping triangulation of polygons with holes, see MapTessellator_P.cpp
+        struct Earcut;
+
+        bool obtainStroke(
+            const Context& context,
+            const MapStyleEvaluationResult& evalResult,
+            const PaintValuesSet valueSetSelector,
+            Stroke& outStroke) const;
+
+        void tessellatePolygon(
+            const Context& context,
+            const std::shared_ptr<const MapPrimitiviser::Primitive>& primitive);
+
+        void tessellatePolyline(
+            const Context& context,
+            const std::shared_ptr<const MapPrimitiviser::Primitive>& primitive);
+
+        void extrudePolyline(
+            const Context& context,
+            const QVector<PointD>& points,
+            const bool closed,
+            const Stroke& stroke);
+
+        static void obtainRing(
+            const Context& context,
+            const QVector<PointI>& points31,
+            QVector<PointD>& outRing);
+        static void clipRing(
+            const QVector<PointD>& ring,
+            const AreaD& clipArea,
+            QVector<PointD>& outRing);
+        static void addTriangle(
+            const Context& context,
+            const PointD& a,
+            const PointD& b,
+            const PointD& c,
+            const ColorARGB color);
+        static void addArc(
+            const Context& context,
+            const PointD& center,
+            const double radius,
+            const double startAngle,
+            const double sweepAngle,
+            const ColorARGB color);
+    protected:
+        MapTessellator_P(MapTessellator* const owner);
+    public:
+        ~MapTessellator_P();
+
+        ImplementationInterface<MapTessellator> owner;
+
+        void tessellate(
+            const AreaI area31,
+            const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
+            QVector<Vertex>& outVertices,
+            const bool fillBackground,
+            MapTessellator_Metrics::Metric_tessellate* const metric,
+            const IQueryController* const controller);
+
+    friend class OsmAnd::MapTessellator;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_TESSELLATOR_P_H_)
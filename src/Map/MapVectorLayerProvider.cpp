@@ -0,0 +1,93 @@
+#include "MapVectorLayerProvider.h"
+#include "MapVectorLayerProvider_P.h"
+
+#include "MapPrimitivesProvider.h"
+#include "MapPrimitiviser.h"
+#include "MapPresentationEnvironment.h"
+
+OsmAnd::MapVectorLayerProvider::MapVectorLayerProvider(
+    const std::shared_ptr<MapPrimitivesProvider>& primitivesProvider_,
+    const bool fillBackground_ /*= true*/)
+    : _p(new MapVectorLayerProvider_P(this))
+    , primitivesProvider(primitivesProvider_)
+    , fillBackground(fillBackground_)
+{
+    _p->initialize();
+}
+
+OsmAnd::MapVectorLayerProvider::~MapVectorLayerProvider()
+{
+}
+
+float OsmAnd::MapVectorLayerProvider::getTileDensityFactor() const
+{
+    return primitivesProvider->primitiviser->environment->displayDensityFactor;
+}
+
+uint32_t OsmAnd::MapVectorLayerProvider::getTileSize() const
+{
+    return primitivesProvider->tileSize;
+}
+
+bool OsmAnd::MapVectorLayerProvider::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    std::shared_ptr<IMapTiledDataProvider::Data>& outTiledData,
+    std::shared_ptr<Metric>* pOutMetric /*= nullptr*/,
+    const IQueryController* const queryController /*= nullptr*/)
+{
+    if (pOutMetric)
+    {
+        if (!pOutMetric->get() || !dynamic_cast<MapTessellator_Metrics::Metric_tessellate*>(pOutMetric->get()))
+            pOutMetric->reset(new MapTessellator_Metrics::Metric_tessellate());
+        else
+            pOutMetric->get()->reset();
+    }
+
+    std::shared_ptr<Data> tiledData;
+    const auto result = _p->obtainData(
+        tileId,
+        zoom,
+        tiledData,
+        pOutMetric ? static_cast<MapTessellator_Metrics::Metric_tessellate*>(pOutMetric->get()) : nullptr,
+        queryController);
+    outTiledData = tiledData;
+
+    return result;
+}
+
+bool OsmAnd::MapVectorLayerProvider::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    std::shared_ptr<Data>& outTiledData,
+    MapTessellator_Metrics::Metric_tessellate* const metric,
+    const IQueryController* const queryController)
+{
+    return _p->obtainData(tileId, zoom, outTiledData, metric, queryController);
+}
+
+OsmAnd::ZoomLevel OsmAnd::MapVectorLayerProvider::getMinZoom() const
+{
+    return _p->getMinZoom();
+}
+
+OsmAnd::ZoomLevel OsmAnd::MapVectorLayerProvider::getMaxZoom() const
+{
+    return _p->getMaxZoom();
+}
+
+OsmAnd::MapVectorLayerProvider::Data::Data(
+    const TileId tileId_,
+    const ZoomLevel zoom_,
+    const QVector<Vertex>& vertices_,
+    const std::shared_ptr<const MapPrimitivesProvider::Data>& binaryMapData_,
+    const RetainableCacheMetadata* const pRetainableCacheMetadata_ /*= nullptr*/)
+    : IVectorMapLayerProvider::Data(tileId_, zoom_, vertices_, pRetainableCacheMetadata_)
+    , binaryMapData(binaryMapData_)
+{
+}
+
+OsmAnd::MapVectorLayerProvider::Data::~Data()
+{
+    release();
+}
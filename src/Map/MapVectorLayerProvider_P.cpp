@@ -0,0 +1,82 @@
+#include "MapVectorLayerProvider_P.h"
+#include "MapVectorLayerProvider.h"
+
+#include "MapPrimitivesProvider.h"
+#include "MapPrimitiviser.h"
+#include "MapTessellator.h"
+#include "IQueryController.h"
+#include "Utilities.h"
+
+OsmAnd::MapVectorLayerProvider_P::MapVectorLayerProvider_P(MapVectorLayerProvider* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::MapVectorLayerProvider_P::~MapVectorLayerProvider_P()
+{
+}
+
+void OsmAnd::MapVectorLayerProvider_P::initialize()
+{
+    _mapTessellator.reset(new MapTessellator(owner->primitivesProvider->primitiviser->environment));
+}
+
+OsmAnd::ZoomLevel OsmAnd::MapVectorLayerProvider_P::getMinZoom() const
+{
+    return owner->primitivesProvider->getMinZoom();
+}
+
+OsmAnd::ZoomLevel OsmAnd::MapVectorLayerProvider_P::getMaxZoom() const
+{
+    return owner->primitivesProvider->getMaxZoom();
+}
+
+bool OsmAnd::MapVectorLayerProvider_P::obtainData(
+    const TileId tileId,
+    const ZoomLevel zoom,
+    std::shared_ptr<MapVectorLayerProvider::Data>& outTiledData,
+    MapTessellator_Metrics::Metric_tessellate* const metric,
+    const IQueryController* const queryController)
+{
+    // Obtain offline map primitives tile
+    std::shared_ptr<MapPrimitivesProvider::Data> primitivesTile;
+    owner->primitivesProvider->obtainData(tileId, zoom, primitivesTile, nullptr, queryController);
+    if (queryController && queryController->isAborted())
+        return false;
+    if (!primitivesTile || primitivesTile->primitivisedObjects->isEmpty())
+    {
+        outTiledData.reset();
+        return true;
+    }
+
+    // Tessellate once per tile, mesh is kept by renderer as long as tile is
+    QVector<MapVectorLayerProvider::Vertex> vertices;
+    _mapTessellator->tessellate(
+        Utilities::tileBoundingBox31(tileId, zoom),
+        primitivesTile->primitivisedObjects,
+        vertices,
+        owner->fillBackground,
+        metric,
+        queryController);
+    if (queryController && queryController->isAborted())
+        return false;
+
+    outTiledData.reset(new MapVectorLayerProvider::Data(
+        tileId,
+        zoom,
+        vertices,
+        primitivesTile,
+        new RetainableCacheMetadata(primitivesTile->retainableCacheMetadata)));
+
+    return true;
+}
+
+OsmAnd::MapVectorLayerProvider_P::RetainableCacheMetadata::RetainableCacheMetadata(
+    const std::shared_ptr<const IMapDataProvider::RetainableCacheMetadata>& binaryMapPrimitivesRetainableCacheMetadata_)
+    : binaryMapPrimitivesRetainableCacheMetadata(binaryMapPrimitivesRetainableCacheMetadata_)
+{
+}
+
+OsmAnd::MapVectorLayerProvider_P::RetainableCacheMetadata::~RetainableCacheMetadata()
+{
+}
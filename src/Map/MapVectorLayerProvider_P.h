@@ -0,0 +1,56 @@
+#ifndef _OSMAND_CORE_MAP_VECTOR_LAYER_PROVIDER_P_H_
+#define _OSMAND_CORE_MAP_VECTOR_LAYER_PROVIDER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "IVectorMapLayerProvider.h"
+#include "MapVectorLayerProvider.h"
+#include "MapTessellator_Metrics.h"
+
+namespace OsmAnd
+{
+    class MapTessellator;
+
+    class MapVectorLayerProvider_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapVectorLayerProvider_P);
+    private:
+        std::unique_ptr<MapTessellator> _mapTessellator;
+
+        struct RetainableCacheMetadata : public IMapDataProvider::RetainableCacheMetadata
+        {
+            RetainableCacheMetadata(
+                const std::shared_ptr<const IMapDataProvider::RetainableCacheMetadata>& binaryMapPrimitivesRetainableCacheMetadata);
+            virtual ~RetainableCacheMetadata();
+
+            std::shared_ptr<const IMapDataProvider::RetainableCacheMetadata> binaryMapPrimitivesRetainableCacheMetadata;
+        };
+    protected:
+        MapVectorLayerProvider_P(MapVectorLayerProvider* const owner);
+
+        void initialize();
+    public:
+        ~MapVectorLayerProvider_P();
+
+        ImplementationInterface<MapVectorLayerProvider> owner;
+
+        bool obtainData(
+            const TileId tileId,
+            const ZoomLevel zoom,
+            std::shared_ptr<MapVectorLayerProvider::Data>& outTiledData,
+            MapTessellator_Metrics::Metric_tessellate* const metric,
+            const IQueryController* const queryController);
+
+        ZoomLevel getMinZoom() const;
+        ZoomLevel getMaxZoom() const;
+
+    friend class OsmAnd::MapVectorLayerProvider;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_VECTOR_LAYER_PROVIDER_P_H_)
@@ -0,0 +1,42 @@
+#include "MapViewsBatchRenderer.h"
+#include "MapViewsBatchRenderer_P.h"
+
+#include "IMapRenderer.h"
+
+OsmAnd::MapViewsBatchRenderer::MapViewsBatchRenderer(const std::shared_ptr<IMapRenderer>& renderer_)
+    : _p(new MapViewsBatchRenderer_P(this))
+    , renderer(renderer_)
+{
+}
+
+OsmAnd::MapViewsBatchRenderer::~MapViewsBatchRenderer()
+{
+}
+
+unsigned int OsmAnd::MapViewsBatchRenderer::render(
+    const QList<View>& views,
+    const ViewRenderedCallback callback,
+    const float viewTimeout /*= 10.0f * 60.0f*/) const
+{
+    return _p->render(views, callback, viewTimeout);
+}
+
+OsmAnd::MapViewsBatchRenderer::View::View()
+    : zoom(15.0f)
+    , azimuth(0.0f)
+    , elevationAngle(90.0f)
+{
+}
+
+OsmAnd::MapViewsBatchRenderer::View::~View()
+{
+}
+
+OsmAnd::MapViewsBatchRenderer::ViewStatistics::ViewStatistics()
+    : elapsedTime(0.0f)
+{
+}
+
+OsmAnd::MapViewsBatchRenderer::ViewStatistics::~ViewStatistics()
+{
+}
@@ -0,0 +1,188 @@
+#include "MapViewsBatchRenderer_P.h"
+#include "MapViewsBatchRenderer.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <cstring>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkBitmap.h>
+#include "restore_internal_warnings.h"
+
+#include "IMapRenderer.h"
+#include "Stopwatch.h"
+
+#if defined(OSMAND_OPENGL_RENDERERS_SUPPORTED)
+#   include "OpenGL/GPUAPI_OpenGL.h"
+#endif // defined(OSMAND_OPENGL_RENDERERS_SUPPORTED)
+
+OsmAnd::MapViewsBatchRenderer_P::MapViewsBatchRenderer_P(MapViewsBatchRenderer* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::MapViewsBatchRenderer_P::~MapViewsBatchRenderer_P()
+{
+}
+
+unsigned int OsmAnd::MapViewsBatchRenderer_P::render(
+    const QList<View>& views,
+    const ViewRenderedCallback callback,
+    const float viewTimeout) const
+{
+    const auto sortedViews = sortInRenderingOrder(views);
+
+    auto renderedViewsCount = 0u;
+    for (const auto& view : constOf(sortedViews))
+    {
+        ViewStatistics statistics;
+        QString error;
+        const auto image = renderView(view, viewTimeout, statistics, error);
+        if (image)
+            renderedViewsCount++;
+
+        if (callback)
+            callback(view, image, statistics, error);
+    }
+
+    return renderedViewsCount;
+}
+
+QList<OsmAnd::MapViewsBatchRenderer_P::View> OsmAnd::MapViewsBatchRenderer_P::sortInRenderingOrder(const QList<View>& views)
+{
+    // Views of the same zoom level are ordered along Z-order curve of tiles containing their targets, so
+    // that views rendered one after another are most likely to share tiles
+    const auto getZoomLevel =
+        []
+        (const View& view) -> int
+        {
+            return qBound(
+                static_cast<int>(MinZoomLevel),
+                static_cast<int>(view.zoom),
+                static_cast<int>(MaxZoomLevel));
+        };
+    const auto getZOrder =
+        []
+        (const View& view, const int zoomLevel) -> uint64_t
+        {
+            const auto tileX = static_cast<uint32_t>(view.target31.x) >> (MaxZoomLevel - zoomLevel);
+            const auto tileY = static_cast<uint32_t>(view.target31.y) >> (MaxZoomLevel - zoomLevel);
+
+            uint64_t zOrder = 0;
+            for (int bitIndex = 0; bitIndex < zoomLevel; bitIndex++)
+            {
+                zOrder |= static_cast<uint64_t>((tileX >> bitIndex) & 1u) << (2 * bitIndex);
+                zOrder |= static_cast<uint64_t>((tileY >> bitIndex) & 1u) << (2 * bitIndex + 1);
+            }
+            return zOrder;
+        };
+
+    auto sortedViews = views;
+    std::stable_sort(sortedViews.begin(), sortedViews.end(),
+        [getZoomLevel, getZOrder]
+        (const View& l, const View& r) -> bool
+        {
+            const auto lZoomLevel = getZoomLevel(l);
+            const auto rZoomLevel = getZoomLevel(r);
+            if (lZoomLevel != rZoomLevel)
+                return lZoomLevel < rZoomLevel;
+
+            return getZOrder(l, lZoomLevel) < getZOrder(r, rZoomLevel);
+        });
+    return sortedViews;
+}
+
+std::shared_ptr<SkBitmap> OsmAnd::MapViewsBatchRenderer_P::renderView(
+    const View& view,
+    const float timeout,
+    ViewStatistics& outStatistics,
+    QString& outError) const
+{
+#if defined(OSMAND_OPENGL_RENDERERS_SUPPORTED)
+    const auto& renderer = owner->renderer;
+    if (!renderer || !renderer->isRenderingInitialized())
+    {
+        outError = QLatin1String("Map renderer has no rendering initialized");
+        return nullptr;
+    }
+
+    // Error left by previous view must not fail this one
+    glGetError();
+
+    renderer->setTarget(view.target31);
+    renderer->setZoom(view.zoom);
+    renderer->setAzimuth(view.azimuth);
+    renderer->setElevationAngle(view.elevationAngle);
+
+    // Repeat processing and rendering until everything is complete
+    const Stopwatch renderingStopwatch(true);
+    for (;;)
+    {
+        const Stopwatch frameStopwatch(true);
+
+        // Update must be performed before each frame
+        if (!renderer->update())
+        {
+            outError = QLatin1String("Map renderer: update failed");
+            return nullptr;
+        }
+
+        // If frame was prepared, it means there's something to render
+        if (renderer->prepareFrame() && !renderer->renderFrame())
+        {
+            outError = QLatin1String("Map renderer: frame rendering failed");
+            return nullptr;
+        }
+
+        // Send everything to GPU
+        glFlush();
+        outStatistics.framesTimes.push_back(frameStopwatch.elapsed());
+
+        // Check if map renderer finished processing
+        if (renderer->isIdle())
+            break;
+
+        if (renderingStopwatch.elapsed() > timeout)
+        {
+            outError = QString("Rendering was interrupted since it took longer than %1s. Probably it's stuck: %2")
+                .arg(timeout)
+                .arg(renderer->getNotIdleReason());
+            return nullptr;
+        }
+    }
+    outStatistics.elapsedTime = renderingStopwatch.elapsed();
+    std::sort(outStatistics.framesTimes.begin(), outStatistics.framesTimes.end());
+
+    // Wait until everything is ready on GPU and read result from render-target
+    glFinish();
+    const auto windowSize = renderer->getState().windowSize;
+    SkBitmap renderTargetBitmap;
+    renderTargetBitmap.allocPixels(SkImageInfo::MakeN32Premul(windowSize.x, windowSize.y));
+    glReadPixels(0, 0, windowSize.x, windowSize.y, GL_RGBA, GL_UNSIGNED_BYTE, renderTargetBitmap.getPixels());
+    const auto glError = glGetError();
+    if (glError != GL_NO_ERROR)
+    {
+        outError = QString("OpenGL error 0x%1").arg(glError, 0, 16);
+        return nullptr;
+    }
+
+    // Rows of render-target go bottom-up
+    const std::shared_ptr<SkBitmap> image(new SkBitmap());
+    image->allocPixels(SkImageInfo::MakeN32Premul(windowSize.x, windowSize.y));
+    const auto rowSizeInBytes = renderTargetBitmap.rowBytes();
+    for (int row = 0; row < windowSize.y; row++)
+    {
+        const auto pSrcRow = reinterpret_cast<const uint8_t*>(renderTargetBitmap.getPixels()) + (row * rowSizeInBytes);
+        const auto pDstRow = reinterpret_cast<uint8_t*>(image->getPixels()) + ((windowSize.y - row - 1) * rowSizeInBytes);
+        memcpy(pDstRow, pSrcRow, rowSizeInBytes);
+    }
+
+    return image;
+#else
+    Q_UNUSED(view);
+    Q_UNUSED(timeout);
+    Q_UNUSED(outStatistics);
+    outError = QLatin1String("OpenGL renderers are not supported");
+    return nullptr;
+#endif // defined(OSMAND_OPENGL_RENDERERS_SUPPORTED)
+}
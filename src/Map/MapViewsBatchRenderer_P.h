@@ -0,0 +1,51 @@
+#ifndef _OSMAND_CORE_MAP_VIEWS_BATCH_RENDERER_P_H_
+#define _OSMAND_CORE_MAP_VIEWS_BATCH_RENDERER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QString>
+#include <QList>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "MapViewsBatchRenderer.h"
+
+namespace OsmAnd
+{
+    class MapViewsBatchRenderer;
+    class MapViewsBatchRenderer_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(MapViewsBatchRenderer_P);
+    public:
+        typedef MapViewsBatchRenderer::View View;
+        typedef MapViewsBatchRenderer::ViewStatistics ViewStatistics;
+        typedef MapViewsBatchRenderer::ViewRenderedCallback ViewRenderedCallback;
+
+    private:
+        static QList<View> sortInRenderingOrder(const QList<View>& views);
+
+        std::shared_ptr<SkBitmap> renderView(
+            const View& view,
+            const float timeout,
+            ViewStatistics& outStatistics,
+            QString& outError) const;
+    protected:
+        MapViewsBatchRenderer_P(MapViewsBatchRenderer* const owner);
+    public:
+        ~MapViewsBatchRenderer_P();
+
+        ImplementationInterface<MapViewsBatchRenderer> owner;
+
+        unsigned int render(
+            const QList<View>& views,
+            const ViewRenderedCallback callback,
+            const float viewTimeout) const;
+
+    friend class OsmAnd::MapViewsBatchRenderer;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_MAP_VIEWS_BATCH_RENDERER_P_H_)
@@ -16,6 +16,7 @@
 #include "AtlasMapRenderer_Metrics.h"
 #include "IMapTiledDataProvider.h"
 #include "IRasterMapLayerProvider.h"
+#include "IVectorMapLayerProvider.h"
 #include "IMapElevationDataProvider.h"
 #include "QKeyValueIterator.h"
 #include "Utilities.h"
@@ -36,6 +37,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initialize()
 {
     bool ok = true;
     ok = ok && initializeRasterLayers();
+    ok = ok && initializeVectorLayers();
     return ok;
 }
 
@@ -67,20 +69,24 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::render(IMapRenderer_Metrics:
     {
         // Any layer or layers batch after first one has to be rendered using blending,
         // since output color of new batch needs to be blended with destination color.
-        if (!batchedLayersByTile->containsOriginLayer != blendingEnabled)
+        // Vector layer always needs blending, since its triangles overlap each other within the tile.
+        const auto needsBlending =
+            !batchedLayersByTile->containsOriginLayer ||
+            batchedLayersByTile->layers.first()->type == BatchedLayerType::Vector;
+        if (needsBlending != blendingEnabled)
         {
-            if (batchedLayersByTile->containsOriginLayer)
+            if (needsBlending)
             {
-                glDisable(GL_BLEND);
+                glEnable(GL_BLEND);
                 GL_CHECK_RESULT;
             }
             else
             {
-                glEnable(GL_BLEND);
+                glDisable(GL_BLEND);
                 GL_CHECK_RESULT;
             }
 
-            blendingEnabled = !batchedLayersByTile->containsOriginLayer;
+            blendingEnabled = needsBlending;
         }
 
         // Depending on type of first (and all others) batched layer, batch is rendered differently
@@ -92,6 +98,14 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::render(IMapRenderer_Metrics:
                 elevationDataVertexAttribArray,
                 lastUsedProgram);
         }
+        else if (batchedLayersByTile->layers.first()->type == BatchedLayerType::Vector)
+        {
+            renderVectorLayer(
+                batchedLayersByTile,
+                currentAlphaChannelType,
+                elevationDataVertexAttribArray,
+                lastUsedProgram);
+        }
     }
 
     // Deactivate program
@@ -124,6 +138,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::release(const bool gpuContex
 {
     bool ok = true;
     ok = ok && releaseRasterLayers(gpuContextLost);
+    ok = ok && releaseVectorLayers(gpuContextLost);
     return ok;
 }
 
@@ -152,6 +167,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayers()
               1 /*param_vs_groundCameraPosition*/ +
               1 /*param_vs_scaleToRetainProjectedSize*/) +
         1 /*param_vs_tileCoordsOffset*/ +
+        1 /*param_vs_nSubTile*/ +
         1 /*param_vs_elevationData_scaleFactor*/ +
         1 /*param_vs_elevationData_upperMetersPerUnit*/ +
         1 /*param_vs_elevationData_lowerMetersPerUnit*/ +
@@ -243,6 +259,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayersProgra
         "                                                                                                                   ""\n"
         // Parameters: per-tile data
         "uniform vec2 param_vs_tileCoordsOffset;                                                                            ""\n"
+        "uniform vec4 param_vs_nSubTile;                                                                                    ""\n"
         "uniform float param_vs_elevationData_scaleFactor;                                                                  ""\n"
         "uniform float param_vs_elevationData_upperMetersPerUnit;                                                           ""\n"
         "uniform float param_vs_elevationData_lowerMetersPerUnit;                                                           ""\n"
@@ -261,15 +278,19 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayersProgra
         "    uniform VsRasterLayerTile param_vs_elevationDataLayer;                                                         ""\n"
         "#endif // !VERTEX_TEXTURE_FETCH_SUPPORTED                                                                          ""\n"
         "                                                                                                                   ""\n"
-        "void calculateTextureCoordinates(in VsRasterLayerTile tileLayer, out vec2 outTexCoords)                            ""\n"
+        "void calculateTextureCoordinates(in VsRasterLayerTile tileLayer, in vec2 texCoords, out vec2 outTexCoords)         ""\n"
         "{                                                                                                                  ""\n"
-        "    outTexCoords = in_vs_vertexTexCoords * tileLayer.nSizeInTile + tileLayer.nOffsetInTile;                        ""\n"
+        "    outTexCoords = texCoords * tileLayer.nSizeInTile + tileLayer.nOffsetInTile;                                    ""\n"
         "}                                                                                                                  ""\n"
         "                                                                                                                   ""\n"
         "void main()                                                                                                        ""\n"
         "{                                                                                                                  ""\n"
         "    vec4 v = vec4(in_vs_vertexPosition.x, 0.0, in_vs_vertexPosition.y, 1.0);                                       ""\n"
         "                                                                                                                   ""\n"
+        //   Fit vertex into part of the tile that is rendered, whole tile unless resources are underscaled
+        "    vec2 tileTexCoords = in_vs_vertexTexCoords * param_vs_nSubTile.zw + param_vs_nSubTile.xy;                      ""\n"
+        "    v.xz = v.xz * param_vs_nSubTile.zw + %TileSize3D%.0 * param_vs_nSubTile.xy;                                    ""\n"
+        "                                                                                                                   ""\n"
         //   Shift vertex to it's proper position
         "    v.xz += %TileSize3D%.0 * (param_vs_tileCoordsOffset - param_vs_targetInTilePosN);                              ""\n"
         "                                                                                                                   ""\n"
@@ -280,7 +301,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayersProgra
         "    if (abs(param_vs_elevationData_scaleFactor) > 0.0)                                                             ""\n"
         "    {                                                                                                              ""\n"
         "        float metersToUnits = mix(param_vs_elevationData_upperMetersPerUnit,                                       ""\n"
-        "            param_vs_elevationData_lowerMetersPerUnit, in_vs_vertexTexCoords.t);                                   ""\n"
+        "            param_vs_elevationData_lowerMetersPerUnit, tileTexCoords.t);                                           ""\n"
         "                                                                                                                   ""\n"
         //       Calculate texcoords for elevation data (pixel-is-area)
         "        float heightInMeters;                                                                                      ""\n"
@@ -288,6 +309,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayersProgra
         "        vec2 elevationDataTexCoords;                                                                               ""\n"
         "        calculateTextureCoordinates(                                                                               ""\n"
         "            param_vs_elevationDataLayer,                                                                           ""\n"
+        "            tileTexCoords,                                                                                         ""\n"
         "            elevationDataTexCoords);                                                                               ""\n"
         "        heightInMeters = SAMPLE_TEXTURE_2D(param_vs_elevationData_sampler, elevationDataTexCoords).r;              ""\n"
         "#else // !VERTEX_TEXTURE_FETCH_SUPPORTED                                                                           ""\n"
@@ -318,6 +340,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayersProgra
     const auto& vertexShader_perRasterLayerTexCoordsProcessing = QString::fromLatin1(
         "    calculateTextureCoordinates(                                                                                   ""\n"
         "        param_vs_rasterTileLayer_%rasterLayerIndex%,                                                               ""\n"
+        "        in_vs_vertexTexCoords,                                                                                     ""\n"
         "        v2f_texCoordsPerLayer_%rasterLayerIndex%);                                                                 ""\n"
         "                                                                                                                   ""\n");
 
@@ -508,6 +531,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeRasterLayersProgra
         ok = ok && lookup->lookupLocation(outRasterLayerTileProgram.vs.param.scaleToRetainProjectedSize, "param_vs_scaleToRetainProjectedSize", GlslVariableType::Uniform);
     }
     ok = ok && lookup->lookupLocation(outRasterLayerTileProgram.vs.param.tileCoordsOffset, "param_vs_tileCoordsOffset", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(outRasterLayerTileProgram.vs.param.nSubTile, "param_vs_nSubTile", GlslVariableType::Uniform);
     ok = ok && lookup->lookupLocation(outRasterLayerTileProgram.vs.param.elevationData_scaleFactor, "param_vs_elevationData_scaleFactor", GlslVariableType::Uniform);
     ok = ok && lookup->lookupLocation(outRasterLayerTileProgram.vs.param.elevationData_upperMetersPerUnit, "param_vs_elevationData_upperMetersPerUnit", GlslVariableType::Uniform);
     ok = ok && lookup->lookupLocation(outRasterLayerTileProgram.vs.param.elevationData_lowerMetersPerUnit, "param_vs_elevationData_lowerMetersPerUnit", GlslVariableType::Uniform);
@@ -559,6 +583,7 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::renderRasterLayersBatch(
     GL_CHECK_PRESENT(glUniform2f);
     GL_CHECK_PRESENT(glUniform2i);
     GL_CHECK_PRESENT(glUniform2fv);
+    GL_CHECK_PRESENT(glUniform4f);
     GL_CHECK_PRESENT(glActiveTexture);
     GL_CHECK_PRESENT(glEnableVertexAttribArray);
     GL_CHECK_PRESENT(glVertexAttribPointer);
@@ -606,9 +631,28 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::renderRasterLayersBatch(
         currentAlphaChannelType = AlphaChannelType::Premultiplied;
     }
 
-    // Single pass tile rendering is possible for exact-scale and overscale cases
-    if (batch->layers.first()->resourcesInGPU.size() == 1)
+    // Single pass tile rendering is possible for exact-scale and overscale cases. Underscaled resources cover only
+    // part of the tile each, so tile is rendered part by part
+    const auto partsCount = batch->layers.first()->resourcesInGPU.size();
+    for (int partIndex = 0; partIndex < partsCount; partIndex++)
     {
+        const auto& partResourceInGPU = batch->layers.first()->resourcesInGPU[partIndex];
+        const auto isUnderscaledPart = (partResourceInGPU->zoomShift > 0);
+        if (isUnderscaledPart)
+        {
+            glUniform4f(program.vs.param.nSubTile,
+                partResourceInGPU->nOffsetInTile.x,
+                partResourceInGPU->nOffsetInTile.y,
+                partResourceInGPU->nSizeInTile.x,
+                partResourceInGPU->nSizeInTile.y);
+            GL_CHECK_RESULT;
+        }
+        else
+        {
+            glUniform4f(program.vs.param.nSubTile, 0.0f, 0.0f, 1.0f, 1.0f);
+            GL_CHECK_RESULT;
+        }
+
         // Set uniform variables for each raster layer
         for (int layerIndexInBatch = 0; layerIndexInBatch < batchedLayersCount; layerIndexInBatch++)
         {
@@ -631,8 +675,12 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::renderRasterLayersBatch(
                 GL_CHECK_RESULT;
             }
 
-            // Since it's single-pass tile rendering, there's only one resource per layer
-            const auto& batchedResourceInGPU = layer->resourcesInGPU.first();
+            // Layers are batched only if their resources match, so resources of the same part share index
+            const auto& batchedResourceInGPU = layer->resourcesInGPU[partIndex];
+
+            // Underscaled resource is shown entirely over its part of the tile
+            const auto nOffsetInResource = isUnderscaledPart ? PointF(0.0f, 0.0f) : batchedResourceInGPU->nOffsetInTile;
+            const auto nSizeInResource = isUnderscaledPart ? PointF(1.0f, 1.0f) : batchedResourceInGPU->nSizeInTile;
 
             switch (gpuAPI->getGpuResourceAlphaChannelType(batchedResourceInGPU->resourceInGPU))
             {
@@ -668,8 +716,8 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::renderRasterLayersBatch(
                 const auto nSizeInAtlas = tileSizeN - 2.0f * tilePaddingN;
                 PointF nOffsetInTile(colIndex * tileSizeN + tilePaddingN, rowIndex * tileSizeN + tilePaddingN);
 
-                nOffsetInTile += batchedResourceInGPU->nOffsetInTile * nSizeInAtlas;
-                const auto nSizeInTile = batchedResourceInGPU->nSizeInTile * nSizeInAtlas;
+                nOffsetInTile += nOffsetInResource * nSizeInAtlas;
+                const auto nSizeInTile = nSizeInResource * nSizeInAtlas;
 
                 glUniform2f(perTile_vs.nOffsetInTile, nOffsetInTile.x,nOffsetInTile.y);
                 GL_CHECK_RESULT;
@@ -678,27 +726,16 @@ bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::renderRasterLayersBatch(
             }
             else // if (resourceInGPU->type == GPUAPI::ResourceInGPU::Type::Texture)
             {
-                glUniform2f(perTile_vs.nOffsetInTile,
-                    batchedResourceInGPU->nOffsetInTile.x,
-                    batchedResourceInGPU->nOffsetInTile.y);
+                glUniform2f(perTile_vs.nOffsetInTile, nOffsetInResource.x, nOffsetInResource.y);
                 GL_CHECK_RESULT;
-                glUniform2f(perTile_vs.nSizeInTile,
-                    batchedResourceInGPU->nSizeInTile.x,
-                    batchedResourceInGPU->nSizeInTile.y);
+                glUniform2f(perTile_vs.nSizeInTile, nSizeInResource.x, nSizeInResource.y);
                 GL_CHECK_RESULT;
             }
         }
 
-        // Single-pass tile rendering always processes full tile
         glDrawElements(GL_TRIANGLES, _rasterTileIndicesCount, GL_UNSIGNED_SHORT, nullptr);
         GL_CHECK_RESULT;
     }
-    else
-    {
-        //TODO: underscale cases are not supported so far, since they require multipass rendering
-        assert(false);
-        LogPrintf(LogSeverityLevel::Error, "Underscale is not supported!");
-    }
 
     // Unbind textures from texture samplers, that were used
     const auto usedSamplersCount = batchedLayersCount + (gpuAPI->isSupported_vertexShaderTextureLookup ? 1 : 0);
@@ -1106,6 +1143,296 @@ void OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::releaseRasterTile(const bool
     _rasterTileIndicesCount = -1;
 }
 
+bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::initializeVectorLayers()
+{
+    const auto gpuAPI = getGPUAPI();
+
+    GL_CHECK_PRESENT(glDeleteShader);
+    GL_CHECK_PRESENT(glDeleteProgram);
+
+    // Compile vertex shader
+    const QString vertexShader = QLatin1String(
+        // Input data
+        "INPUT vec2 in_vs_vertexPosition;                                                                                   ""\n"
+        "INPUT vec4 in_vs_vertexColor;                                                                                      ""\n"
+        "                                                                                                                   ""\n"
+        // Output data to next shader stages
+        "PARAM_OUTPUT vec2 v2f_positionInTileN;                                                                             ""\n"
+        "PARAM_OUTPUT lowp vec4 v2f_color;                                                                                  ""\n"
+        "                                                                                                                   ""\n"
+        // Parameters: common data
+        "uniform mat4 param_vs_mProjectionView;                                                                             ""\n"
+        "uniform vec2 param_vs_targetInTilePosN;                                                                            ""\n"
+        "                                                                                                                   ""\n"
+        // Parameters: per-tile data
+        "uniform vec2 param_vs_tileCoordsOffset;                                                                            ""\n"
+        "uniform vec2 param_vs_nOffsetInTile;                                                                               ""\n"
+        "uniform vec2 param_vs_nSizeInTile;                                                                                 ""\n"
+        "uniform lowp float param_vs_opacityFactor;                                                                         ""\n"
+        "                                                                                                                   ""\n"
+        "void main()                                                                                                        ""\n"
+        "{                                                                                                                  ""\n"
+        //   Map vertex from source tile to rendered tile, which differ in case of overscale
+        "    v2f_positionInTileN = (in_vs_vertexPosition - param_vs_nOffsetInTile) / param_vs_nSizeInTile;                  ""\n"
+        "    vec4 v = vec4(v2f_positionInTileN.x * %TileSize3D%.0, 0.0, v2f_positionInTileN.y * %TileSize3D%.0, 1.0);       ""\n"
+        "                                                                                                                   ""\n"
+        //   Shift vertex to it's proper position
+        "    v.xz += %TileSize3D%.0 * (param_vs_tileCoordsOffset - param_vs_targetInTilePosN);                              ""\n"
+        "                                                                                                                   ""\n"
+        //   Color is stored as BGRA bytes
+        "    v2f_color = in_vs_vertexColor.zyxw;                                                                            ""\n"
+        "    v2f_color.a *= param_vs_opacityFactor;                                                                         ""\n"
+        "                                                                                                                   ""\n"
+        "    gl_Position = param_vs_mProjectionView * v;                                                                    ""\n"
+        "}                                                                                                                  ""\n");
+    auto preprocessedVertexShader = vertexShader;
+    preprocessedVertexShader.replace("%TileSize3D%", QString::number(AtlasMapRenderer::TileSize3D));
+    gpuAPI->preprocessVertexShader(preprocessedVertexShader);
+    gpuAPI->optimizeVertexShader(preprocessedVertexShader);
+    const auto vsId = gpuAPI->compileShader(GL_VERTEX_SHADER, qPrintable(preprocessedVertexShader));
+    if (vsId == 0)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to compile AtlasMapRendererMapLayersStage_OpenGL vertex shader for vector map layer");
+        return false;
+    }
+
+    // Compile fragment shader
+    const QString fragmentShader = QLatin1String(
+        // Input data
+        "PARAM_INPUT vec2 v2f_positionInTileN;                                                                              ""\n"
+        "PARAM_INPUT lowp vec4 v2f_color;                                                                                   ""\n"
+        "                                                                                                                   ""\n"
+        "void main()                                                                                                        ""\n"
+        "{                                                                                                                  ""\n"
+        //   Geometry that lies outside of rendered tile belongs to other tiles
+        "    if (any(lessThan(v2f_positionInTileN, vec2(0.0))) || any(greaterThan(v2f_positionInTileN, vec2(1.0))))         ""\n"
+        "        discard;                                                                                                   ""\n"
+        "                                                                                                                   ""\n"
+        "    FRAGMENT_COLOR_OUTPUT = v2f_color;                                                                             ""\n"
+        "}                                                                                                                  ""\n");
+    auto preprocessedFragmentShader = fragmentShader;
+    gpuAPI->preprocessFragmentShader(preprocessedFragmentShader);
+    gpuAPI->optimizeFragmentShader(preprocessedFragmentShader);
+    const auto fsId = gpuAPI->compileShader(GL_FRAGMENT_SHADER, qPrintable(preprocessedFragmentShader));
+    if (fsId == 0)
+    {
+        glDeleteShader(vsId);
+        GL_CHECK_RESULT;
+
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to compile AtlasMapRendererMapLayersStage_OpenGL fragment shader for vector map layer");
+        return false;
+    }
+
+    // Link everything into program object
+    GLuint shaders[] = { vsId, fsId };
+    QHash< QString, GPUAPI_OpenGL::GlslProgramVariable > variablesMap;
+    _vectorLayerTileProgram.id = gpuAPI->linkProgram(2, shaders, true, &variablesMap);
+    if (!_vectorLayerTileProgram.id.isValid())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to link AtlasMapRendererMapLayersStage_OpenGL program for vector map layer");
+        return false;
+    }
+
+    bool ok = true;
+    const auto& lookup = gpuAPI->obtainVariablesLookupContext(_vectorLayerTileProgram.id, variablesMap);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.in.vertexPosition, "in_vs_vertexPosition", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.in.vertexColor, "in_vs_vertexColor", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.param.mProjectionView, "param_vs_mProjectionView", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.param.targetInTilePosN, "param_vs_targetInTilePosN", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.param.tileCoordsOffset, "param_vs_tileCoordsOffset", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.param.nOffsetInTile, "param_vs_nOffsetInTile", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.param.nSizeInTile, "param_vs_nSizeInTile", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(_vectorLayerTileProgram.vs.param.opacityFactor, "param_vs_opacityFactor", GlslVariableType::Uniform);
+    if (!ok)
+    {
+        glDeleteProgram(_vectorLayerTileProgram.id);
+        GL_CHECK_RESULT;
+        _vectorLayerTileProgram.id.reset();
+
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::renderVectorLayer(
+    const Ref<PerTileBatchedLayers>& batch,
+    AlphaChannelType& currentAlphaChannelType,
+    GLlocation& activeElevationVertexAttribArray,
+    GLname& lastUsedProgram)
+{
+    const auto gpuAPI = getGPUAPI();
+
+    GL_CHECK_PRESENT(glUseProgram);
+    GL_CHECK_PRESENT(glUniformMatrix4fv);
+    GL_CHECK_PRESENT(glUniform1f);
+    GL_CHECK_PRESENT(glUniform2f);
+    GL_CHECK_PRESENT(glEnableVertexAttribArray);
+    GL_CHECK_PRESENT(glVertexAttribPointer);
+    GL_CHECK_PRESENT(glDisableVertexAttribArray);
+    GL_CHECK_PRESENT(glDrawArrays);
+
+    const auto& internalState = getInternalState();
+
+    // Vector layers are never batched, so there's exactly one layer. It has several resources only if underscaled
+    const auto& layer = batch->layers.first();
+
+    GL_PUSH_GROUP_MARKER(QString("%1x%2@%3 vector").arg(batch->tileId.x).arg(batch->tileId.y).arg(currentState.zoomBase));
+
+    if (lastUsedProgram != _vectorLayerTileProgram.id)
+    {
+        // Elevation vertex attrib is bound to raster program
+        if (activeElevationVertexAttribArray.isValid())
+        {
+            glDisableVertexAttribArray(*activeElevationVertexAttribArray);
+            GL_CHECK_RESULT;
+
+            activeElevationVertexAttribArray.reset();
+        }
+
+        // Raster tile VAO must not capture vertex attributes of vector layer
+        gpuAPI->unuseVAO();
+
+        glUseProgram(_vectorLayerTileProgram.id);
+        GL_CHECK_RESULT;
+
+        glUniformMatrix4fv(_vectorLayerTileProgram.vs.param.mProjectionView,
+            1, GL_FALSE, glm::value_ptr(internalState.mPerspectiveProjectionView));
+        GL_CHECK_RESULT;
+
+        glUniform2f(_vectorLayerTileProgram.vs.param.targetInTilePosN,
+            internalState.targetInTileOffsetN.x,
+            internalState.targetInTileOffsetN.y);
+        GL_CHECK_RESULT;
+
+        lastUsedProgram = _vectorLayerTileProgram.id;
+    }
+
+    // Set tile coordinates offset
+    glUniform2f(_vectorLayerTileProgram.vs.param.tileCoordsOffset,
+        batch->tileId.x - internalState.targetTileId.x,
+        batch->tileId.y - internalState.targetTileId.y);
+    GL_CHECK_RESULT;
+
+    if (currentState.mapLayersProviders.isEmpty() ||
+        layer->layerIndex == currentState.mapLayersProviders.firstKey())
+    {
+        glUniform1f(_vectorLayerTileProgram.vs.param.opacityFactor, 1.0f);
+        GL_CHECK_RESULT;
+    }
+    else
+    {
+        const auto& layerConfiguration = currentState.mapLayersConfigurations[layer->layerIndex];
+        glUniform1f(_vectorLayerTileProgram.vs.param.opacityFactor, layerConfiguration.opacityFactor);
+        GL_CHECK_RESULT;
+    }
+
+    // Colors of vertices are not premultiplied
+    if (currentAlphaChannelType != AlphaChannelType::Straight)
+    {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GL_CHECK_RESULT;
+
+        currentAlphaChannelType = AlphaChannelType::Straight;
+    }
+
+    // All triangles of the tile lie in the same plane and overlap each other, so they must not write depth,
+    // otherwise later triangles would be rejected by earlier ones
+    glDepthMask(GL_FALSE);
+    GL_CHECK_RESULT;
+
+    glEnableVertexAttribArray(*_vectorLayerTileProgram.vs.in.vertexPosition);
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_vectorLayerTileProgram.vs.in.vertexColor);
+    GL_CHECK_RESULT;
+
+    for (const auto& batchedResourceInGPU : constOf(layer->resourcesInGPU))
+    {
+        const auto meshInGPU = std::dynamic_pointer_cast<const GPUAPI::MeshInGPU>(batchedResourceInGPU->resourceInGPU);
+        if (!meshInGPU || meshInGPU->vertexBuffer->itemsCount == 0)
+            continue;
+
+        // Shader maps part of source tile onto rendered tile. In case of overscale it's part of the resource,
+        // in case of underscale the resource is part of the tile, so it's inverted
+        if (batchedResourceInGPU->zoomShift > 0)
+        {
+            glUniform2f(_vectorLayerTileProgram.vs.param.nOffsetInTile,
+                -batchedResourceInGPU->nOffsetInTile.x / batchedResourceInGPU->nSizeInTile.x,
+                -batchedResourceInGPU->nOffsetInTile.y / batchedResourceInGPU->nSizeInTile.y);
+            GL_CHECK_RESULT;
+            glUniform2f(_vectorLayerTileProgram.vs.param.nSizeInTile,
+                1.0f / batchedResourceInGPU->nSizeInTile.x,
+                1.0f / batchedResourceInGPU->nSizeInTile.y);
+            GL_CHECK_RESULT;
+        }
+        else
+        {
+            glUniform2f(_vectorLayerTileProgram.vs.param.nOffsetInTile,
+                batchedResourceInGPU->nOffsetInTile.x,
+                batchedResourceInGPU->nOffsetInTile.y);
+            GL_CHECK_RESULT;
+            glUniform2f(_vectorLayerTileProgram.vs.param.nSizeInTile,
+                batchedResourceInGPU->nSizeInTile.x,
+                batchedResourceInGPU->nSizeInTile.y);
+            GL_CHECK_RESULT;
+        }
+
+        // Activate vertex buffer
+        glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(reinterpret_cast<intptr_t>(meshInGPU->vertexBuffer->refInGPU)));
+        GL_CHECK_RESULT;
+
+        glVertexAttribPointer(*_vectorLayerTileProgram.vs.in.vertexPosition,
+            2, GL_FLOAT, GL_FALSE,
+            sizeof(IVectorMapLayerProvider::Vertex),
+            reinterpret_cast<GLvoid*>(offsetof(IVectorMapLayerProvider::Vertex, positionXY)));
+        GL_CHECK_RESULT;
+        glVertexAttribPointer(*_vectorLayerTileProgram.vs.in.vertexColor,
+            4, GL_UNSIGNED_BYTE, GL_TRUE,
+            sizeof(IVectorMapLayerProvider::Vertex),
+            reinterpret_cast<GLvoid*>(offsetof(IVectorMapLayerProvider::Vertex, color)));
+        GL_CHECK_RESULT;
+
+        glDrawArrays(GL_TRIANGLES, 0, meshInGPU->vertexBuffer->itemsCount);
+        GL_CHECK_RESULT;
+    }
+
+    glDisableVertexAttribArray(*_vectorLayerTileProgram.vs.in.vertexPosition);
+    GL_CHECK_RESULT;
+    glDisableVertexAttribArray(*_vectorLayerTileProgram.vs.in.vertexColor);
+    GL_CHECK_RESULT;
+
+    glDepthMask(GL_TRUE);
+    GL_CHECK_RESULT;
+
+    // Unbind any binded buffer
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_RESULT;
+
+    GL_POP_GROUP_MARKER;
+
+    return true;
+}
+
+bool OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::releaseVectorLayers(const bool gpuContextLost)
+{
+    GL_CHECK_PRESENT(glDeleteProgram);
+
+    if (_vectorLayerTileProgram.id.isValid())
+    {
+        if (!gpuContextLost)
+        {
+            glDeleteProgram(_vectorLayerTileProgram.id);
+            GL_CHECK_RESULT;
+        }
+        _vectorLayerTileProgram = VectorLayerTileProgram();
+    }
+
+    return true;
+}
+
 void OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::configureElevationData(
     const RasterLayerTileProgram& program,
     const TileId tileId,
@@ -1253,11 +1580,12 @@ OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::batchLayersByTiles(const AtlasMap
             if (!resourcesCollection)
                 continue;
 
-            Ref<BatchedLayer> batchedLayer = new BatchedLayer(
-                (std::dynamic_pointer_cast<IRasterMapLayerProvider>(provider) != nullptr)
-                    ? BatchedLayerType::Raster
-                    : BatchedLayerType::Other,
-                layerIndex);
+            auto batchedLayerType = BatchedLayerType::Other;
+            if (std::dynamic_pointer_cast<IRasterMapLayerProvider>(provider))
+                batchedLayerType = BatchedLayerType::Raster;
+            else if (std::dynamic_pointer_cast<IVectorMapLayerProvider>(provider))
+                batchedLayerType = BatchedLayerType::Vector;
+            Ref<BatchedLayer> batchedLayer = new BatchedLayer(batchedLayerType, layerIndex);
 
             // Try to obtain exact match resource
             const auto exactMatchGpuResource = captureLayerResource(
@@ -1280,8 +1608,44 @@ OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::batchLayersByTiles(const AtlasMap
                 // giving preference to underscaled resource
                 for (int absZoomShift = 1; absZoomShift <= MapRenderer::MaxMissingDataZoomShift; absZoomShift++)
                 {
-                    //TODO: Try to find underscaled first (that is, currentState.zoomBase + 1). Only full match is accepted
-                    
+                    // Try to find underscaled first (that is, currentState.zoomBase + 1). Only full match is accepted.
+                    // Elevation passed as vertex attribute can not be fit into part of the tile, so it prevents underscale
+                    const auto underscaleZoom = static_cast<int>(currentState.zoomBase) + absZoomShift;
+                    if (absZoomShift == 1 &&
+                        !debugSettings->rasterLayersUnderscaleForbidden &&
+                        underscaleZoom <= static_cast<int>(MaxZoomLevel) &&
+                        (!currentState.elevationDataProvider || gpuAPI->isSupported_vertexShaderTextureLookup))
+                    {
+                        QVector<PointF> nOffsetsInTile;
+                        PointF nSizeInTile;
+                        const auto underscaledTileIdsN = Utilities::getTileIdsUnderscaledByZoomShift(
+                            tileIdN,
+                            absZoomShift,
+                            &nOffsetsInTile,
+                            &nSizeInTile);
+                        QList< Ref<BatchedLayerResource> > underscaledResources;
+                        for (auto underscaledTileIdx = 0; underscaledTileIdx < underscaledTileIdsN.size(); underscaledTileIdx++)
+                        {
+                            const auto gpuResource = captureLayerResource(
+                                resourcesCollection,
+                                underscaledTileIdsN[underscaledTileIdx],
+                                static_cast<ZoomLevel>(underscaleZoom));
+                            if (!gpuResource)
+                                break;
+
+                            underscaledResources.push_back(Ref<BatchedLayerResource>(new BatchedLayerResource(
+                                gpuResource,
+                                absZoomShift,
+                                nOffsetsInTile[underscaledTileIdx],
+                                nSizeInTile)));
+                        }
+                        if (underscaledResources.size() == underscaledTileIdsN.size())
+                        {
+                            batchedLayer->resourcesInGPU = underscaledResources;
+                            break;
+                        }
+                    }
+
                     // If underscaled was not found, look for overscaled (surely, if such zoom level exists at all)
                     if (!debugSettings->rasterLayersOverscaleForbidden)
                     {
@@ -1335,8 +1699,10 @@ OsmAnd::AtlasMapRendererMapLayersStage_OpenGL::batchLayersByTiles(const AtlasMap
             {
                 const auto& lastBatchedLayer = batch->layers.last();
 
-                // Only raster layers can be batched
-                canBeBatched = (lastBatchedLayer->type == BatchedLayerType::Raster);
+                // Only raster layers can be batched, each vector layer is drawn separately
+                canBeBatched =
+                    lastBatchedLayer->type == BatchedLayerType::Raster &&
+                    batchedLayer->type == BatchedLayerType::Raster;
 
                 // Number of batched raster layers is limited
                 canBeBatched = canBeBatched && (batch->layers.size() <= _maxNumberOfRasterMapLayersInBatch);
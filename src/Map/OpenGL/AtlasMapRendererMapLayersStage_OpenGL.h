@@ -34,6 +34,7 @@ namespace OsmAnd
         enum class BatchedLayerType
         {
             Raster,
+            Vector,
             Other
         };
 
@@ -47,6 +48,8 @@ namespace OsmAnd
 
             std::shared_ptr<const GPUAPI::ResourceInGPU> resourceInGPU;
             int zoomShift;
+            // Overscaled resource (negative zoom shift): part of resource that covers the tile.
+            // Underscaled resource (positive zoom shift): part of the tile that is covered by resource
             PointF nOffsetInTile;
             PointF nSizeInTile;
 
@@ -114,6 +117,7 @@ namespace OsmAnd
 
                     // Per-tile data
                     GLlocation tileCoordsOffset;
+                    GLlocation nSubTile;
                     GLlocation elevationData_scaleFactor;
                     GLlocation elevationData_sampler;
                     GLlocation elevationData_upperMetersPerUnit;
@@ -173,6 +177,40 @@ namespace OsmAnd
             const ZoomLevel zoomLevel,
             MapRendererResourceState* const outState = nullptr);
         bool releaseRasterLayers(const bool gpuContextLost);
+
+        // Vector layers support:
+        struct VectorLayerTileProgram
+        {
+            GLname id;
+
+            struct {
+                // Input data
+                struct {
+                    GLlocation vertexPosition;
+                    GLlocation vertexColor;
+                } in;
+
+                // Parameters
+                struct {
+                    // Common data
+                    GLlocation mProjectionView;
+                    GLlocation targetInTilePosN;
+
+                    // Per-tile data
+                    GLlocation tileCoordsOffset;
+                    GLlocation nOffsetInTile;
+                    GLlocation nSizeInTile;
+                    GLlocation opacityFactor;
+                } param;
+            } vs;
+        } _vectorLayerTileProgram;
+        bool initializeVectorLayers();
+        bool renderVectorLayer(
+            const Ref<PerTileBatchedLayers>& batch,
+            AlphaChannelType& currentAlphaChannelType,
+            GLlocation& activeElevationVertexAttribArray,
+            GLname& lastUsedProgram);
+        bool releaseVectorLayers(const bool gpuContextLost);
     public:
         AtlasMapRendererMapLayersStage_OpenGL(AtlasMapRenderer_OpenGL* const renderer);
         virtual ~AtlasMapRendererMapLayersStage_OpenGL();
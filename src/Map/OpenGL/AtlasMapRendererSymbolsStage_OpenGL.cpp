@@ -5,6 +5,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/transform.hpp>
 
+#include "QtExtensions.h"
+#include <QtMath>
+
 #include "AtlasMapRenderer_OpenGL.h"
 #include "AtlasMapRenderer_Metrics.h"
 #include "MapSymbol.h"
@@ -17,9 +20,14 @@
 #include "MapSymbolsGroup.h"
 #include "Stopwatch.h"
 
+const int OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::MaxQuadsPerSymbolsBatch = 1024;
+
 OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::AtlasMapRendererSymbolsStage_OpenGL(AtlasMapRenderer_OpenGL* const renderer_)
     : AtlasMapRendererSymbolsStage(renderer_)
     , AtlasMapRendererStageHelper_OpenGL(this)
+    , _symbolsDrawCalls(0)
+    , _symbolsBatchedDrawCalls(0)
+    , _symbolsBatchedQuads(0)
     , _onPathSymbol2dMaxGlyphsPerDrawCall(0)
     , _onPathSymbol3dMaxGlyphsPerDrawCall(0)
 {
@@ -34,6 +42,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initialize()
     bool ok = true;
     ok = ok && initializeBillboardRaster();
     ok = ok && initializeOnPath();
+    ok = ok && initializeSdfText();
     ok = ok && initializeOnSurfaceRaster();
     ok = ok && initializeOnSurfaceVector();
     return ok;
@@ -59,13 +68,19 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::render(IMapRenderer_Metrics::M
 
     prepare(metric);
 
+    _symbolsDrawCalls = 0;
+    _symbolsBatchedDrawCalls = 0;
+    _symbolsBatchedQuads = 0;
+    QList< std::shared_ptr<const RenderableSymbol> > sortedRenderableSymbols;
+    sortRenderableSymbolsForBatching(sortedRenderableSymbols);
+
     // Initially, configure for straight alpha channel type
     auto currentAlphaChannelType = AlphaChannelType::Straight;
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     GL_CHECK_RESULT;
 
     GLname lastUsedProgram;
-    for (const auto& renderable_ : constOf(renderableSymbols))
+    for (const auto& renderable_ : constOf(sortedRenderableSymbols))
     {
         if (const auto& renderable = std::dynamic_pointer_cast<const RenderableBillboardSymbol>(renderable_))
         {
@@ -108,6 +123,15 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::render(IMapRenderer_Metrics::M
         }
     }
 
+    // Draw what's left in the last batch
+    ok = flushSymbolsBatch(currentAlphaChannelType, lastUsedProgram) && ok;
+    if (metric)
+    {
+        metric->symbolsDrawCalls = _symbolsDrawCalls;
+        metric->symbolsBatchedDrawCalls = _symbolsBatchedDrawCalls;
+        metric->symbolsBatchedQuads = _symbolsBatchedQuads;
+    }
+
     // Unbind symbol texture from texture sampler
     glActiveTexture(GL_TEXTURE0 + 0);
     GL_CHECK_RESULT;
@@ -130,8 +154,16 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderBillboardSymbol(
     AlphaChannelType &currentAlphaChannelType,
     GLname& lastUsedProgram)
 {
-    if (std::dynamic_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol))
+    if (const auto rasterMapSymbol = std::dynamic_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol))
     {
+        if (rasterMapSymbol->sdfGlyphRun)
+        {
+            return renderBillboardSdfTextSymbol(
+                renderable,
+                currentAlphaChannelType,
+                lastUsedProgram);
+        }
+
         return renderBillboardRasterSymbol(
             renderable,
             currentAlphaChannelType,
@@ -155,6 +187,19 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnPathSymbol(
     AlphaChannelType &currentAlphaChannelType,
     GLname& lastUsedProgram)
 {
+    // Glyphs of text from atlas are placed by the same rules, but don't come from symbol texture
+    if (std::static_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol)->sdfGlyphRun)
+    {
+        return renderOnPathSdfTextSymbol(
+            renderable,
+            currentAlphaChannelType,
+            lastUsedProgram);
+    }
+
+    // Glyphs are drawn straight away, so whatever was batched before has to be drawn first
+    if (!flushSymbolsBatch(currentAlphaChannelType, lastUsedProgram))
+        return false;
+
     // Draw the glyphs
     if (renderable->is2D)
     {
@@ -177,6 +222,10 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnSurfaceSymbol(
     AlphaChannelType &currentAlphaChannelType,
     GLname& lastUsedProgram)
 {
+    // On-surface symbols are drawn straight away, so whatever was batched before has to be drawn first
+    if (!flushSymbolsBatch(currentAlphaChannelType, lastUsedProgram))
+        return false;
+
     if (std::dynamic_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol))
     {
         return renderOnSurfaceRasterSymbol(
@@ -197,14 +246,300 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnSurfaceSymbol(
 
 bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::release(const bool gpuContextLost)
 {
+    // Whatever was left in batch can't be drawn anymore
+    _symbolsBatch = SymbolsBatch();
+
     bool ok = true;
     ok = ok && releaseBillboardRaster(gpuContextLost);
     ok = ok && releaseOnPath(gpuContextLost);
+    ok = ok && releaseSdfText(gpuContextLost);
     ok = ok && releaseOnSurfaceRaster(gpuContextLost);
     ok = ok && releaseOnSurfaceVector(gpuContextLost);
     return ok;
 }
 
+void OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::getSymbolsBatchKey(
+    const std::shared_ptr<const RenderableSymbol>& renderable,
+    SymbolsBatchType& outType,
+    GPUAPI::RefInGPU& outTexture) const
+{
+    outType = SymbolsBatchType::None;
+    outTexture = nullptr;
+
+    const auto& gpuResource = renderable->gpuResource;
+    if (gpuResource->type == GPUAPI::ResourceInGPU::Type::SdfGlyphs)
+    {
+        // Label may span several pages, the first one is enough to make labels of one font go together
+        const auto& glyphRun = std::static_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol)->sdfGlyphRun;
+        if (glyphRun->quads.isEmpty())
+            return;
+
+        const auto& sdfGlyphsInGPU = std::static_pointer_cast<const GPUAPI::SdfGlyphsInGPU>(gpuResource);
+        outType = SymbolsBatchType::SdfText;
+        outTexture = sdfGlyphsInGPU->pagesTextures[glyphRun->quads.first().pageIndex]->refInGPU;
+    }
+    else if (std::dynamic_pointer_cast<const RenderableBillboardSymbol>(renderable) &&
+        std::dynamic_pointer_cast<const RasterMapSymbol>(renderable->mapSymbol))
+    {
+        outType = SymbolsBatchType::BillboardRaster;
+        if (gpuResource->type == GPUAPI::ResourceInGPU::Type::AreaOnSymbolsAtlasTexture)
+            outTexture = std::static_pointer_cast<const GPUAPI::AreaOnSymbolsAtlasTextureInGPU>(gpuResource)->getAtlasTexture()->refInGPU;
+        else
+            outTexture = gpuResource->refInGPU;
+    }
+}
+
+void OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::sortRenderableSymbolsForBatching(
+    QList< std::shared_ptr<const RenderableSymbol> >& outSortedRenderableSymbols) const
+{
+    struct SortableRenderable
+    {
+        std::shared_ptr<const RenderableSymbol> renderable;
+        int segment;
+        SymbolsBatchType batchType;
+        uintptr_t batchTexture;
+    };
+
+    // Symbols accepted by intersection check with the same order don't overlap, so they may be reordered by
+    // program and texture. Symbols that were not checked, e.g. that intersect with no classes, may overlap
+    // anything: each of them stays in place and nothing is moved across it. Renderables come sorted by order
+    const auto skipIntersectionCheck =
+        debugSettings->skipSymbolsIntersectionCheck || debugSettings->allSymbolsTransparentForIntersectionLookup;
+    QVector<SortableRenderable> sortableRenderables;
+    sortableRenderables.reserve(renderableSymbols.size());
+    auto segment = 0;
+    auto previousOrder = 0;
+    auto previousIntersectionChecked = false;
+    for (const auto& renderable : constOf(renderableSymbols))
+    {
+        const auto order = renderable->mapSymbol->order;
+        const auto intersectionChecked = !skipIntersectionCheck && !renderable->mapSymbol->intersectsWithClasses.isEmpty();
+        if (!sortableRenderables.isEmpty() &&
+            (order != previousOrder || !intersectionChecked || !previousIntersectionChecked))
+        {
+            segment++;
+        }
+        previousOrder = order;
+        previousIntersectionChecked = intersectionChecked;
+
+        SortableRenderable sortableRenderable;
+        sortableRenderable.renderable = renderable;
+        sortableRenderable.segment = segment;
+
+        GPUAPI::RefInGPU batchTexture;
+        getSymbolsBatchKey(renderable, sortableRenderable.batchType, batchTexture);
+        sortableRenderable.batchTexture = reinterpret_cast<uintptr_t>(batchTexture);
+
+        sortableRenderables.push_back(sortableRenderable);
+    }
+
+    std::stable_sort(sortableRenderables.begin(), sortableRenderables.end(),
+        []
+        (const SortableRenderable& l, const SortableRenderable& r) -> bool
+        {
+            if (l.segment != r.segment)
+                return l.segment < r.segment;
+            if (l.batchType != r.batchType)
+                return l.batchType < r.batchType;
+            return l.batchTexture < r.batchTexture;
+        });
+
+    outSortedRenderableSymbols.clear();
+    outSortedRenderableSymbols.reserve(sortableRenderables.size());
+    for (const auto& sortableRenderable : constOf(sortableRenderables))
+        outSortedRenderableSymbols.push_back(sortableRenderable.renderable);
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::beginSymbolsBatch(
+    const SymbolsBatchType type,
+    const GPUAPI::RefInGPU texture,
+    const AlphaChannelType alphaChannelType,
+    AlphaChannelType &currentAlphaChannelType,
+    GLname& lastUsedProgram)
+{
+    const auto batchIsFull = (_symbolsBatch.quadsCount >= MaxQuadsPerSymbolsBatch);
+    if (_symbolsBatch.type == type &&
+        _symbolsBatch.texture == texture &&
+        _symbolsBatch.alphaChannelType == alphaChannelType &&
+        !batchIsFull)
+    {
+        return true;
+    }
+
+    if (!flushSymbolsBatch(currentAlphaChannelType, lastUsedProgram))
+        return false;
+
+    _symbolsBatch.type = type;
+    _symbolsBatch.texture = texture;
+    _symbolsBatch.alphaChannelType = alphaChannelType;
+    _symbolsBatch.quadsCount = 0;
+
+    return true;
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::flushSymbolsBatch(
+    AlphaChannelType &currentAlphaChannelType,
+    GLname& lastUsedProgram)
+{
+    if (_symbolsBatch.type == SymbolsBatchType::None)
+        return true;
+
+    const auto gpuAPI = getGPUAPI();
+
+    GL_CHECK_PRESENT(glUseProgram);
+    GL_CHECK_PRESENT(glBindBuffer);
+    GL_CHECK_PRESENT(glBufferData);
+    GL_CHECK_PRESENT(glBufferSubData);
+    GL_CHECK_PRESENT(glDrawElements);
+
+    GLname program;
+    GLname vao;
+    GLname vbo;
+    GLlocation sampler;
+    const void* vertices = nullptr;
+    size_t vertexSize = 0;
+    size_t maxVerticesSize = 0;
+    QString programName;
+    switch (_symbolsBatch.type)
+    {
+        case SymbolsBatchType::BillboardRaster:
+            program = _billboardRasterProgram.id;
+            vao = _billboardRasterSymbolVAO;
+            vbo = _billboardRasterSymbolVBO;
+            sampler = _billboardRasterProgram.fs.param.sampler;
+            vertices = _billboardRasterVertices.constData();
+            vertexSize = sizeof(BillboardRasterVertex);
+            programName = QLatin1String("billboard-raster");
+            break;
+        case SymbolsBatchType::SdfText:
+            program = _sdfTextProgram.id;
+            vao = _sdfTextSymbolVAO;
+            vbo = _sdfTextSymbolVBO;
+            sampler = _sdfTextProgram.fs.param.sampler;
+            vertices = _sdfTextVertices.constData();
+            vertexSize = sizeof(SdfTextVertex);
+            programName = QLatin1String("sdf-text");
+            break;
+        default:
+            return false;
+    }
+    maxVerticesSize = 4 * MaxQuadsPerSymbolsBatch * vertexSize;
+
+    // Check if correct program is being used
+    if (lastUsedProgram != program)
+    {
+        GL_PUSH_GROUP_MARKER(QString("use '%1' program").arg(programName));
+
+        // Set symbol VAO
+        gpuAPI->useVAO(vao);
+
+        // Activate program
+        glUseProgram(program);
+        GL_CHECK_RESULT;
+
+        // Activate texture block for symbol textures
+        glActiveTexture(GL_TEXTURE0 + 0);
+        GL_CHECK_RESULT;
+
+        // Set proper sampler for texture block
+        gpuAPI->setTextureBlockSampler(GL_TEXTURE0 + 0, GPUAPI_OpenGL::SamplerType::Symbol);
+
+        // Bind texture to sampler
+        glUniform1i(sampler, 0);
+        GL_CHECK_RESULT;
+
+        lastUsedProgram = program;
+
+        GL_POP_GROUP_MARKER;
+    }
+
+    GL_PUSH_GROUP_MARKER(QString("[batch of %1 %2 quads]")
+        .arg(_symbolsBatch.quadsCount)
+        .arg(programName));
+
+    if (currentAlphaChannelType != _symbolsBatch.alphaChannelType)
+    {
+        switch (_symbolsBatch.alphaChannelType)
+        {
+            case AlphaChannelType::Premultiplied:
+                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                GL_CHECK_RESULT;
+                break;
+            case AlphaChannelType::Straight:
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                GL_CHECK_RESULT;
+                break;
+            default:
+                break;
+        }
+
+        currentAlphaChannelType = _symbolsBatch.alphaChannelType;
+    }
+
+    // Activate texture of batch
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(reinterpret_cast<intptr_t>(_symbolsBatch.texture)));
+    GL_CHECK_RESULT;
+
+    // Apply settings from texture block to texture
+    gpuAPI->applyTextureBlockToTexture(GL_TEXTURE_2D, GL_TEXTURE0 + 0);
+
+    // Storage of buffer is orphaned before it's filled, so that driver doesn't have to wait until previous
+    // batch is drawn from it
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    GL_CHECK_RESULT;
+    glBufferData(GL_ARRAY_BUFFER, maxVerticesSize, nullptr, GL_STREAM_DRAW);
+    GL_CHECK_RESULT;
+    glBufferSubData(GL_ARRAY_BUFFER, 0, 4 * _symbolsBatch.quadsCount * vertexSize, vertices);
+    GL_CHECK_RESULT;
+
+    // Draw quads of all symbols in batch actually
+    glDrawElements(GL_TRIANGLES, 6 * _symbolsBatch.quadsCount, GL_UNSIGNED_SHORT, nullptr);
+    GL_CHECK_RESULT;
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_RESULT;
+
+    GL_POP_GROUP_MARKER;
+
+    _symbolsDrawCalls++;
+    _symbolsBatchedDrawCalls++;
+    _symbolsBatchedQuads += _symbolsBatch.quadsCount;
+
+    _billboardRasterVertices.resize(0);
+    _sdfTextVertices.resize(0);
+    _symbolsBatch = SymbolsBatch();
+
+    return true;
+}
+
+QVector<GLushort> OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::generateQuadsIndices(const int quadsCount)
+{
+    QVector<GLushort> indices(6 * quadsCount);
+    auto pIndex = indices.data();
+    for (int quadIdx = 0; quadIdx < quadsCount; quadIdx++)
+    {
+        const auto firstVertex = static_cast<GLushort>(quadIdx * 4);
+
+        *(pIndex++) = firstVertex + 0;
+        *(pIndex++) = firstVertex + 1;
+        *(pIndex++) = firstVertex + 2;
+
+        *(pIndex++) = firstVertex + 0;
+        *(pIndex++) = firstVertex + 2;
+        *(pIndex++) = firstVertex + 3;
+    }
+
+    return indices;
+}
+
+OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::SymbolsBatch::SymbolsBatch()
+    : type(SymbolsBatchType::None)
+    , texture(nullptr)
+    , alphaChannelType(AlphaChannelType::Invalid)
+    , quadsCount(0)
+{
+}
+
 bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeBillboardRaster()
 {
     const auto gpuAPI = getGPUAPI();
@@ -220,78 +555,22 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeBillboardRaster()
     // Compile vertex shader
     const QString vertexShader = QLatin1String(
         // Input data
-        "INPUT vec2 in_vs_vertexPosition;                                                                                   ""\n"
+        "INPUT vec4 in_vs_vertexPosition;                                                                                   ""\n"
         "INPUT vec2 in_vs_vertexTexCoords;                                                                                  ""\n"
+        "INPUT vec4 in_vs_vertexModulationColor;                                                                            ""\n"
         "                                                                                                                   ""\n"
         // Output data to next shader stages
         "PARAM_OUTPUT vec2 v2f_texCoords;                                                                                   ""\n"
-        "                                                                                                                   ""\n"
-        // Parameters: common data
-        "uniform mat4 param_vs_mPerspectiveProjectionView;                                                                  ""\n"
-        "uniform mat4 param_vs_mOrthographicProjection;                                                                     ""\n"
-        "uniform vec4 param_vs_viewport; // x, y, width, height                                                             ""\n"
-        "                                                                                                                   ""\n"
-        // Parameters: per-symbol data
-        "uniform vec2 param_vs_symbolOffsetFromTarget;                                                                      ""\n"
-        "uniform ivec2 param_vs_symbolSize;                                                                                 ""\n"
-        "uniform float param_vs_distanceFromCamera;                                                                         ""\n"
-        "uniform ivec2 param_vs_onScreenOffset;                                                                             ""\n"
+        "PARAM_OUTPUT vec4 v2f_modulationColor;                                                                             ""\n"
         "                                                                                                                   ""\n"
         "void main()                                                                                                        ""\n"
         "{                                                                                                                  ""\n"
-        // Calculate location of symbol in world coordinate system.
-        "    vec4 symbolLocation;                                                                                           ""\n"
-        "    symbolLocation.xz = param_vs_symbolOffsetFromTarget.xy * %TileSize3D%.0;                                       ""\n"
-        "    symbolLocation.y = 0.0; //TODO: A height from heightmap should be used here                                    ""\n"
-        "    symbolLocation.w = 1.0;                                                                                        ""\n"
-        "                                                                                                                   ""\n"
-        // Project location of symbol from world coordinate system to screen
-        "    vec4 projectedSymbolLocation = param_vs_mPerspectiveProjectionView * symbolLocation;                           ""\n"
-        "                                                                                                                   ""\n"
-        // "Normalize" location in screen coordinates to get [-1 .. 1] range
-        "    vec3 symbolLocationOnScreen = projectedSymbolLocation.xyz / projectedSymbolLocation.w;                         ""\n"
-        "                                                                                                                   ""\n"
-        // Using viewport size, get real screen coordinates and correct depth to be [0 .. 1]
-        "    symbolLocationOnScreen.xy = symbolLocationOnScreen.xy * 0.5 + 0.5;                                             ""\n"
-        "    symbolLocationOnScreen.x = symbolLocationOnScreen.x * param_vs_viewport.z + param_vs_viewport.x;               ""\n"
-        "    symbolLocationOnScreen.y = symbolLocationOnScreen.y * param_vs_viewport.w + param_vs_viewport.y;               ""\n"
-        "    symbolLocationOnScreen.z = (1.0 + symbolLocationOnScreen.z) * 0.5;                                             ""\n"
-        "                                                                                                                   ""\n"
-        // Add on-screen offset
-        "    symbolLocationOnScreen.xy += vec2(param_vs_onScreenOffset);                                                    ""\n"
-        "                                                                                                                   ""\n"
-        // symbolLocationOnScreen.xy now contains correct coordinates in viewport,
-        // which can be used in orthographic projection (if it was configured to match viewport).
-        //
-        // To provide pixel-perfect rendering of billboard raster symbols:
-        // symbolLocationOnScreen.(x|y) has to be rounded and +0.5 in case param_vs_symbolSize.(x|y) is even
-        // symbolLocationOnScreen.(x|y) has to be rounded in case param_vs_symbolSize.(x|y) is odd
-        "    symbolLocationOnScreen.x = floor(symbolLocationOnScreen.x) + mod(float(param_vs_symbolSize.x), 2.0) * 0.5;     ""\n"
-        "    symbolLocationOnScreen.y = floor(symbolLocationOnScreen.y) + mod(float(param_vs_symbolSize.y), 2.0) * 0.5;     ""\n"
-        "                                                                                                                   ""\n"
-        // So it's possible to calculate current vertex location:
-        // Initially, get location of current vertex in screen coordinates
-        "    vec2 vertexOnScreen;                                                                                           ""\n"
-        "    vertexOnScreen.x = in_vs_vertexPosition.x * float(param_vs_symbolSize.x);                                      ""\n"
-        "    vertexOnScreen.y = in_vs_vertexPosition.y * float(param_vs_symbolSize.y);                                      ""\n"
-        "    vertexOnScreen = vertexOnScreen + symbolLocationOnScreen.xy;                                                   ""\n"
-        "                                                                                                                   ""\n"
-        // To provide pixel-perfect result, vertexOnScreen needs to be rounded
-        "    vertexOnScreen = floor(vertexOnScreen + vec2(0.5, 0.5));                                                       ""\n"
-        "                                                                                                                   ""\n"
-        // There's no need to perform unprojection into orthographic world space, just multiply these coordinates by
-        // orthographic projection matrix (View and Model being identity)
-        "  vec4 vertex;                                                                                                     ""\n"
-        "  vertex.xy = vertexOnScreen.xy;                                                                                   ""\n"
-        "  vertex.z = -param_vs_distanceFromCamera;                                                                         ""\n"
-        "  vertex.w = 1.0;                                                                                                  ""\n"
-        "  gl_Position = param_vs_mOrthographicProjection * vertex;                                                         ""\n"
-        "                                                                                                                   ""\n"
-        // Texture coordinates are simply forwarded from input
-        "   v2f_texCoords = in_vs_vertexTexCoords;                                                                          ""\n"
+        // Vertices are already placed and projected, so that quads of all symbols from the same texture are drawn at once
+        "    gl_Position = in_vs_vertexPosition;                                                                            ""\n"
+        "    v2f_texCoords = in_vs_vertexTexCoords;                                                                         ""\n"
+        "    v2f_modulationColor = in_vs_vertexModulationColor;                                                             ""\n"
         "}                                                                                                                  ""\n");
     auto preprocessedVertexShader = vertexShader;
-    preprocessedVertexShader.replace("%TileSize3D%", QString::number(AtlasMapRenderer::TileSize3D));
     gpuAPI->preprocessVertexShader(preprocessedVertexShader);
     gpuAPI->optimizeVertexShader(preprocessedVertexShader);
     const auto vsId = gpuAPI->compileShader(GL_VERTEX_SHADER, qPrintable(preprocessedVertexShader));
@@ -306,20 +585,18 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeBillboardRaster()
     const QString fragmentShader = QLatin1String(
         // Input data
         "PARAM_INPUT vec2 v2f_texCoords;                                                                                    ""\n"
+        "PARAM_INPUT vec4 v2f_modulationColor;                                                                              ""\n"
         "                                                                                                                   ""\n"
         // Parameters: common data
-        // Parameters: per-symbol data
         "uniform lowp sampler2D param_fs_sampler;                                                                           ""\n"
-        "uniform lowp vec4 param_fs_modulationColor;                                                                        ""\n"
         "                                                                                                                   ""\n"
         "void main()                                                                                                        ""\n"
         "{                                                                                                                  ""\n"
         "    FRAGMENT_COLOR_OUTPUT = SAMPLE_TEXTURE_2D(                                                                     ""\n"
         "        param_fs_sampler,                                                                                          ""\n"
-        "        v2f_texCoords) * param_fs_modulationColor;                                                                 ""\n"
+        "        v2f_texCoords) * v2f_modulationColor;                                                                      ""\n"
         "}                                                                                                                  ""\n");
     auto preprocessedFragmentShader = fragmentShader;
-    QString preprocessedFragmentShader_UnrolledPerLayerProcessingCode;
     gpuAPI->preprocessFragmentShader(preprocessedFragmentShader);
     gpuAPI->optimizeFragmentShader(preprocessedFragmentShader);
     const auto fsId = gpuAPI->compileShader(GL_FRAGMENT_SHADER, qPrintable(preprocessedFragmentShader));
@@ -348,15 +625,8 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeBillboardRaster()
     const auto& lookup = gpuAPI->obtainVariablesLookupContext(_billboardRasterProgram.id, variablesMap);
     ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.in.vertexPosition, "in_vs_vertexPosition", GlslVariableType::In);
     ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.in.vertexTexCoords, "in_vs_vertexTexCoords", GlslVariableType::In);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.mPerspectiveProjectionView, "param_vs_mPerspectiveProjectionView", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.mOrthographicProjection, "param_vs_mOrthographicProjection", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.viewport, "param_vs_viewport", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.symbolOffsetFromTarget, "param_vs_symbolOffsetFromTarget", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.symbolSize, "param_vs_symbolSize", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.distanceFromCamera, "param_vs_distanceFromCamera", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.param.onScreenOffset, "param_vs_onScreenOffset", GlslVariableType::Uniform);
+    ok = ok && lookup->lookupLocation(_billboardRasterProgram.vs.in.vertexModulationColor, "in_vs_vertexModulationColor", GlslVariableType::In);
     ok = ok && lookup->lookupLocation(_billboardRasterProgram.fs.param.sampler, "param_fs_sampler", GlslVariableType::Uniform);
-    ok = ok && lookup->lookupLocation(_billboardRasterProgram.fs.param.modulationColor, "param_fs_modulationColor", GlslVariableType::Uniform);
     if (!ok)
     {
         glDeleteProgram(_billboardRasterProgram.id);
@@ -366,53 +636,29 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeBillboardRaster()
         return false;
     }
 
-#pragma pack(push, 1)
-    struct Vertex
-    {
-        // XY coordinates. Z is assumed to be 0
-        float positionXY[2];
-
-        // UV coordinates
-        float textureUV[2];
-    };
-#pragma pack(pop)
-
-    // Vertex data
-    Vertex vertices[4] =
-    {
-        // In OpenGL, UV origin is BL. But since same rule applies to uploading texture data,
-        // texture in memory is vertically flipped, so swap bottom and top UVs
-        { { -0.5f, -0.5f }, { 0.0f, 1.0f } },//BL
-        { { -0.5f,  0.5f }, { 0.0f, 0.0f } },//TL
-        { {  0.5f,  0.5f }, { 1.0f, 0.0f } },//TR
-        { {  0.5f, -0.5f }, { 1.0f, 1.0f } } //BR
-    };
-    const auto verticesCount = 4;
-
-    // Index data
-    GLushort indices[6] =
-    {
-        0, 1, 2,
-        0, 2, 3
-    };
-    const auto indicesCount = 6;
+    const auto indices = generateQuadsIndices(MaxQuadsPerSymbolsBatch);
+    _billboardRasterVertices.reserve(4 * MaxQuadsPerSymbolsBatch);
 
     _billboardRasterSymbolVAO = gpuAPI->allocateUninitializedVAO();
 
-    // Create vertex buffer and associate it with VAO
+    // Create vertex buffer and associate it with VAO. It's filled for each batch of quads
     glGenBuffers(1, &_billboardRasterSymbolVBO);
     GL_CHECK_RESULT;
     glBindBuffer(GL_ARRAY_BUFFER, _billboardRasterSymbolVBO);
     GL_CHECK_RESULT;
-    glBufferData(GL_ARRAY_BUFFER, verticesCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, 4 * MaxQuadsPerSymbolsBatch * sizeof(BillboardRasterVertex), nullptr, GL_STREAM_DRAW);
     GL_CHECK_RESULT;
     glEnableVertexAttribArray(*_billboardRasterProgram.vs.in.vertexPosition);
     GL_CHECK_RESULT;
-    glVertexAttribPointer(*_billboardRasterProgram.vs.in.vertexPosition, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<GLvoid*>(offsetof(Vertex, positionXY)));
+    glVertexAttribPointer(*_billboardRasterProgram.vs.in.vertexPosition, 4, GL_FLOAT, GL_FALSE, sizeof(BillboardRasterVertex), reinterpret_cast<GLvoid*>(offsetof(BillboardRasterVertex, position)));
     GL_CHECK_RESULT;
     glEnableVertexAttribArray(*_billboardRasterProgram.vs.in.vertexTexCoords);
     GL_CHECK_RESULT;
-    glVertexAttribPointer(*_billboardRasterProgram.vs.in.vertexTexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<GLvoid*>(offsetof(Vertex, textureUV)));
+    glVertexAttribPointer(*_billboardRasterProgram.vs.in.vertexTexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(BillboardRasterVertex), reinterpret_cast<GLvoid*>(offsetof(BillboardRasterVertex, texCoords)));
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_billboardRasterProgram.vs.in.vertexModulationColor);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_billboardRasterProgram.vs.in.vertexModulationColor, 4, GL_FLOAT, GL_FALSE, sizeof(BillboardRasterVertex), reinterpret_cast<GLvoid*>(offsetof(BillboardRasterVertex, modulationColor)));
     GL_CHECK_RESULT;
 
     // Create index buffer and associate it with VAO
@@ -420,7 +666,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeBillboardRaster()
     GL_CHECK_RESULT;
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _billboardRasterSymbolIBO);
     GL_CHECK_RESULT;
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesCount * sizeof(GLushort), indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.constData(), GL_STATIC_DRAW);
     GL_CHECK_RESULT;
 
     gpuAPI->initializeVAO(_billboardRasterSymbolVAO);
@@ -437,119 +683,117 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderBillboardRasterSymbol(
     AlphaChannelType &currentAlphaChannelType,
     GLname& lastUsedProgram)
 {
-    const auto gpuAPI = getGPUAPI();
     const auto& internalState = getInternalState();
 
     const auto& symbol = std::static_pointer_cast<const BillboardRasterMapSymbol>(renderable->mapSymbol);
-    const auto& gpuResource = std::static_pointer_cast<const GPUAPI::TextureInGPU>(renderable->gpuResource);
-    const auto& symbolGroupPtr = symbol->groupPtr;
 
-    // Check if correct program is being used
-    if (lastUsedProgram != _billboardRasterProgram.id)
+    // Bitmap of symbol either has texture of its own, or occupies area of shared atlas texture. In OpenGL,
+    // UV origin is BL. But since same rule applies to uploading texture data, texture in memory is
+    // vertically flipped, so top of bitmap is at lower V
+    GPUAPI::RefInGPU texture;
+    AlphaChannelType alphaChannelType;
+    PointI size;
+    glm::vec2 topLeftTexCoords;
+    glm::vec2 bottomRightTexCoords;
+    if (renderable->gpuResource->type == GPUAPI::ResourceInGPU::Type::AreaOnSymbolsAtlasTexture)
     {
-        GL_PUSH_GROUP_MARKER("use 'billboard-raster' program");
+        const auto& areaInGPU = std::static_pointer_cast<const GPUAPI::AreaOnSymbolsAtlasTextureInGPU>(renderable->gpuResource);
+        const auto atlasTexture = areaInGPU->getAtlasTexture();
+        const auto area = areaInGPU->getArea();
 
-        // Set symbol VAO
-        gpuAPI->useVAO(_billboardRasterSymbolVAO);
-
-        // Activate program
-        glUseProgram(_billboardRasterProgram.id);
-        GL_CHECK_RESULT;
-
-        // Set perspective projection-view matrix
-        glUniformMatrix4fv(_billboardRasterProgram.vs.param.mPerspectiveProjectionView, 1, GL_FALSE, glm::value_ptr(internalState.mPerspectiveProjectionView));
-        GL_CHECK_RESULT;
-
-        // Set orthographic projection matrix
-        glUniformMatrix4fv(_billboardRasterProgram.vs.param.mOrthographicProjection, 1, GL_FALSE, glm::value_ptr(internalState.mOrthographicProjection));
-        GL_CHECK_RESULT;
-
-        // Set viewport
-        glUniform4fv(_billboardRasterProgram.vs.param.viewport, 1, glm::value_ptr(internalState.glmViewport));
-        GL_CHECK_RESULT;
-
-        // Activate texture block for symbol textures
-        glActiveTexture(GL_TEXTURE0 + 0);
-        GL_CHECK_RESULT;
-
-        // Set proper sampler for texture block
-        gpuAPI->setTextureBlockSampler(GL_TEXTURE0 + 0, GPUAPI_OpenGL::SamplerType::Symbol);
-
-        // Bind texture to sampler
-        glUniform1i(_billboardRasterProgram.fs.param.sampler, 0);
-        GL_CHECK_RESULT;
-
-        lastUsedProgram = _billboardRasterProgram.id;
-
-        GL_POP_GROUP_MARKER;
+        texture = atlasTexture->refInGPU;
+        alphaChannelType = atlasTexture->alphaChannelType;
+        size = PointI(area.width(), area.height());
+        topLeftTexCoords.x = area.left() * atlasTexture->uTexelSizeN;
+        topLeftTexCoords.y = area.top() * atlasTexture->vTexelSizeN;
+        bottomRightTexCoords.x = area.right() * atlasTexture->uTexelSizeN;
+        bottomRightTexCoords.y = area.bottom() * atlasTexture->vTexelSizeN;
     }
-
-    GL_PUSH_GROUP_MARKER(QString("[%1(%2) billboard raster \"%3\"]")
-        .arg(QString().sprintf("%p", symbol->groupPtr))
-        .arg(symbol->group.lock()->toString())
-        .arg(qPrintable(symbol->content)));
-
-    // Set symbol offset from target
-    glUniform2f(_billboardRasterProgram.vs.param.symbolOffsetFromTarget, renderable->offsetFromTarget.x, renderable->offsetFromTarget.y);
-    GL_CHECK_RESULT;
-
-    // Set symbol size
-    glUniform2i(_billboardRasterProgram.vs.param.symbolSize, gpuResource->width, gpuResource->height);
-    GL_CHECK_RESULT;
-
-    // Set distance from camera to symbol
-    glUniform1f(_billboardRasterProgram.vs.param.distanceFromCamera, renderable->distanceToCamera);
-    GL_CHECK_RESULT;
-
-    // Set on-screen offset
-    const auto& offsetOnScreen =
-        (renderable->instanceParameters && renderable->instanceParameters->overridesOffset)
-        ? renderable->instanceParameters->offset
-        : symbol->offset;
-    glUniform2i(_billboardRasterProgram.vs.param.onScreenOffset, offsetOnScreen.x, -offsetOnScreen.y);
-    GL_CHECK_RESULT;
-
-    if (currentAlphaChannelType != gpuResource->alphaChannelType)
+    else //if (renderable->gpuResource->type == GPUAPI::ResourceInGPU::Type::Texture)
     {
-        switch (gpuResource->alphaChannelType)
-        {
-            case AlphaChannelType::Premultiplied:
-                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-                GL_CHECK_RESULT;
-                break;
-            case AlphaChannelType::Straight:
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                GL_CHECK_RESULT;
-                break;
-            default:
-                break;
-        }
+        const auto& textureInGPU = std::static_pointer_cast<const GPUAPI::TextureInGPU>(renderable->gpuResource);
 
-        currentAlphaChannelType = gpuResource->alphaChannelType;
+        texture = textureInGPU->refInGPU;
+        alphaChannelType = textureInGPU->alphaChannelType;
+        size = PointI(textureInGPU->width, textureInGPU->height);
+        topLeftTexCoords = glm::vec2(0.0f, 0.0f);
+        bottomRightTexCoords = glm::vec2(1.0f, 1.0f);
     }
 
-    // Activate symbol texture
-    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(reinterpret_cast<intptr_t>(gpuResource->refInGPU)));
-    GL_CHECK_RESULT;
+    if (!beginSymbolsBatch(SymbolsBatchType::BillboardRaster, texture, alphaChannelType, currentAlphaChannelType, lastUsedProgram))
+        return false;
 
-    // Set modulation color
-    glUniform4f(_billboardRasterProgram.fs.param.modulationColor,
+    const auto symbolLocationOnScreen = getBillboardLocationOnScreen(renderable, size);
+    const auto left = symbolLocationOnScreen.x - size.x * 0.5f;
+    const auto right = symbolLocationOnScreen.x + size.x * 0.5f;
+    const auto top = symbolLocationOnScreen.y + size.y * 0.5f;
+    const auto bottom = symbolLocationOnScreen.y - size.y * 0.5f;
+    const auto z = -renderable->distanceToCamera;
+    const glm::vec4 modulationColor(
         symbol->modulationColor.r,
         symbol->modulationColor.g,
         symbol->modulationColor.b,
         symbol->modulationColor.a);
-    GL_CHECK_RESULT;
 
-    // Apply settings from texture block to texture
-    gpuAPI->applyTextureBlockToTexture(GL_TEXTURE_2D, GL_TEXTURE0 + 0);
+    // There's no need to perform unprojection into orthographic world space, just multiply these coordinates by
+    // orthographic projection matrix (View and Model being identity)
+    BillboardRasterVertex vertex;
+    vertex.modulationColor = modulationColor;
+    vertex.position = internalState.mOrthographicProjection * glm::vec4(left, bottom, z, 1.0f);
+    vertex.texCoords = glm::vec2(topLeftTexCoords.x, bottomRightTexCoords.y);
+    _billboardRasterVertices.push_back(vertex);
+    vertex.position = internalState.mOrthographicProjection * glm::vec4(left, top, z, 1.0f);
+    vertex.texCoords = topLeftTexCoords;
+    _billboardRasterVertices.push_back(vertex);
+    vertex.position = internalState.mOrthographicProjection * glm::vec4(right, top, z, 1.0f);
+    vertex.texCoords = glm::vec2(bottomRightTexCoords.x, topLeftTexCoords.y);
+    _billboardRasterVertices.push_back(vertex);
+    vertex.position = internalState.mOrthographicProjection * glm::vec4(right, bottom, z, 1.0f);
+    vertex.texCoords = bottomRightTexCoords;
+    _billboardRasterVertices.push_back(vertex);
+    _symbolsBatch.quadsCount++;
 
-    // Draw symbol actually
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
-    GL_CHECK_RESULT;
+    return true;
+}
 
-    GL_POP_GROUP_MARKER;
+glm::vec2 OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::getBillboardLocationOnScreen(
+    const std::shared_ptr<const RenderableBillboardSymbol>& renderable,
+    const PointI& size) const
+{
+    const auto& internalState = getInternalState();
 
-    return true;
+    // Calculate location of symbol in world coordinate system
+    //TODO: A height from heightmap should be used here
+    const glm::vec4 symbolLocation(
+        renderable->offsetFromTarget.x * AtlasMapRenderer::TileSize3D,
+        0.0f,
+        renderable->offsetFromTarget.y * AtlasMapRenderer::TileSize3D,
+        1.0f);
+
+    // Project location of symbol from world coordinate system to screen and using viewport size, get real
+    // screen coordinates
+    const auto projectedSymbolLocation = internalState.mPerspectiveProjectionView * symbolLocation;
+    glm::vec2 symbolLocationOnScreen(projectedSymbolLocation.x, projectedSymbolLocation.y);
+    symbolLocationOnScreen /= projectedSymbolLocation.w;
+    symbolLocationOnScreen = symbolLocationOnScreen * 0.5f + 0.5f;
+    symbolLocationOnScreen.x = symbolLocationOnScreen.x * internalState.glmViewport.z + internalState.glmViewport.x;
+    symbolLocationOnScreen.y = symbolLocationOnScreen.y * internalState.glmViewport.w + internalState.glmViewport.y;
+
+    // Add on-screen offset
+    const auto& symbol = std::static_pointer_cast<const BillboardRasterMapSymbol>(renderable->mapSymbol);
+    const auto& offsetOnScreen =
+        (renderable->instanceParameters && renderable->instanceParameters->overridesOffset)
+        ? renderable->instanceParameters->offset
+        : symbol->offset;
+    symbolLocationOnScreen.x += offsetOnScreen.x;
+    symbolLocationOnScreen.y -= offsetOnScreen.y;
+
+    // To provide pixel-perfect rendering of billboard symbols:
+    // location has to be rounded and +0.5 in case size is odd, or just rounded in case size is even
+    symbolLocationOnScreen.x = qFloor(symbolLocationOnScreen.x) + (size.x % 2) * 0.5f;
+    symbolLocationOnScreen.y = qFloor(symbolLocationOnScreen.y) + (size.y % 2) * 0.5f;
+
+    return symbolLocationOnScreen;
 }
 
 bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::releaseBillboardRaster(const bool gpuContextLost)
@@ -593,6 +837,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::releaseBillboardRaster(const b
         }
         _billboardRasterProgram = BillboardRasterSymbolProgram();
     }
+    _billboardRasterVertices.clear();
 
     return true;
 }
@@ -1353,6 +1598,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnPath2dSymbol(
         // Draw chain of glyphs actually
         glDrawElements(GL_TRIANGLES, 6 * glyphsToDraw, GL_UNSIGNED_SHORT, nullptr);
         GL_CHECK_RESULT;
+        _symbolsDrawCalls++;
 
         glyphsDrawn += glyphsToDraw;
     }
@@ -1497,6 +1743,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnPath3dSymbol(
         // Draw chain of glyphs actually
         glDrawElements(GL_TRIANGLES, 6 * glyphsToDraw, GL_UNSIGNED_SHORT, nullptr);
         GL_CHECK_RESULT;
+        _symbolsDrawCalls++;
 
         glyphsDrawn += glyphsToDraw;
     }
@@ -1604,6 +1851,445 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::releaseOnPath3D(const bool gpu
     return true;
 }
 
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeSdfText()
+{
+    const auto gpuAPI = getGPUAPI();
+
+    GL_CHECK_PRESENT(glGenBuffers);
+    GL_CHECK_PRESENT(glBindBuffer);
+    GL_CHECK_PRESENT(glBufferData);
+    GL_CHECK_PRESENT(glEnableVertexAttribArray);
+    GL_CHECK_PRESENT(glVertexAttribPointer);
+    GL_CHECK_PRESENT(glDeleteShader);
+    GL_CHECK_PRESENT(glDeleteProgram);
+
+    // Compile vertex shader
+    const QString vertexShader = QLatin1String(
+        // Input data
+        "INPUT vec4 in_vs_vertexPosition;                                                                                   ""\n"
+        "INPUT vec2 in_vs_vertexTexCoords;                                                                                  ""\n"
+        "INPUT vec4 in_vs_vertexTextColor;                                                                                  ""\n"
+        "INPUT vec4 in_vs_vertexHaloColor;                                                                                  ""\n"
+        "INPUT vec2 in_vs_vertexFieldParams;                                                                                ""\n"
+        "INPUT vec4 in_vs_vertexModulationColor;                                                                            ""\n"
+        "                                                                                                                   ""\n"
+        // Output data to next shader stages
+        "PARAM_OUTPUT vec2 v2f_texCoords;                                                                                   ""\n"
+        "PARAM_OUTPUT vec4 v2f_textColor;                                                                                   ""\n"
+        "PARAM_OUTPUT vec4 v2f_haloColor;                                                                                   ""\n"
+        "PARAM_OUTPUT vec2 v2f_fieldParams;                                                                                 ""\n"
+        "PARAM_OUTPUT vec4 v2f_modulationColor;                                                                             ""\n"
+        "                                                                                                                   ""\n"
+        "void main()                                                                                                        ""\n"
+        "{                                                                                                                  ""\n"
+        // Vertices are already placed and projected, since quads of glyphs follow different paths. Style of label is
+        // passed with each vertex, so that labels of different style that use the same page are drawn at once
+        "    gl_Position = in_vs_vertexPosition;                                                                            ""\n"
+        "    v2f_texCoords = in_vs_vertexTexCoords;                                                                         ""\n"
+        "    v2f_textColor = in_vs_vertexTextColor;                                                                         ""\n"
+        "    v2f_haloColor = in_vs_vertexHaloColor;                                                                         ""\n"
+        "    v2f_fieldParams = in_vs_vertexFieldParams;                                                                     ""\n"
+        "    v2f_modulationColor = in_vs_vertexModulationColor;                                                             ""\n"
+        "}                                                                                                                  ""\n");
+    auto preprocessedVertexShader = vertexShader;
+    gpuAPI->preprocessVertexShader(preprocessedVertexShader);
+    gpuAPI->optimizeVertexShader(preprocessedVertexShader);
+    const auto vsId = gpuAPI->compileShader(GL_VERTEX_SHADER, qPrintable(preprocessedVertexShader));
+    if (vsId == 0)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to compile AtlasMapRendererSymbolsStage_OpenGL vertex shader");
+        return false;
+    }
+
+    // Compile fragment shader
+    const QString fragmentShader = QLatin1String(
+        // Input data
+        "PARAM_INPUT vec2 v2f_texCoords;                                                                                    ""\n"
+        "PARAM_INPUT vec4 v2f_textColor;                                                                                    ""\n"
+        "PARAM_INPUT vec4 v2f_haloColor;                                                                                    ""\n"
+        "PARAM_INPUT vec2 v2f_fieldParams; // halo edge, smoothing                                                          ""\n"
+        "PARAM_INPUT vec4 v2f_modulationColor;                                                                              ""\n"
+        "                                                                                                                   ""\n"
+        // Parameters: common data
+        "uniform lowp sampler2D param_fs_sampler;                                                                           ""\n"
+        "                                                                                                                   ""\n"
+        "void main()                                                                                                        ""\n"
+        "{                                                                                                                  ""\n"
+        // Glyph outline is at 0.5, distance grows towards 1.0 inside of glyph
+        "    lowp float fieldValue = SAMPLE_TEXTURE_2D(param_fs_sampler, v2f_texCoords).r;                                  ""\n"
+        "    lowp float smoothing = v2f_fieldParams.y;                                                                      ""\n"
+        "    lowp float textAlpha = v2f_textColor.a * smoothstep(0.5 - smoothing, 0.5 + smoothing, fieldValue);             ""\n"
+        "    lowp float haloAlpha = v2f_haloColor.a * smoothstep(                                                           ""\n"
+        "        v2f_fieldParams.x - smoothing,                                                                             ""\n"
+        "        v2f_fieldParams.x + smoothing,                                                                             ""\n"
+        "        fieldValue);                                                                                               ""\n"
+        "                                                                                                                   ""\n"
+        // Text is drawn over halo, result has straight alpha
+        "    lowp float alpha = textAlpha + haloAlpha * (1.0 - textAlpha);                                                  ""\n"
+        "    lowp vec3 color = v2f_textColor.rgb * textAlpha + v2f_haloColor.rgb * haloAlpha * (1.0 - textAlpha);           ""\n"
+        "    FRAGMENT_COLOR_OUTPUT = vec4(color / max(alpha, 0.001), alpha) * v2f_modulationColor;                          ""\n"
+        "}                                                                                                                  ""\n");
+    auto preprocessedFragmentShader = fragmentShader;
+    gpuAPI->preprocessFragmentShader(preprocessedFragmentShader);
+    gpuAPI->optimizeFragmentShader(preprocessedFragmentShader);
+    const auto fsId = gpuAPI->compileShader(GL_FRAGMENT_SHADER, qPrintable(preprocessedFragmentShader));
+    if (fsId == 0)
+    {
+        glDeleteShader(vsId);
+        GL_CHECK_RESULT;
+
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to compile AtlasMapRendererSymbolsStage_OpenGL fragment shader");
+        return false;
+    }
+
+    // Link everything into program object
+    GLuint shaders[] = { vsId, fsId };
+    QHash< QString, GPUAPI_OpenGL::GlslProgramVariable > variablesMap;
+    _sdfTextProgram.id = gpuAPI->linkProgram(2, shaders, true, &variablesMap);
+    if (!_sdfTextProgram.id.isValid())
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to link AtlasMapRendererSymbolsStage_OpenGL program");
+        return false;
+    }
+
+    bool ok = true;
+    const auto& lookup = gpuAPI->obtainVariablesLookupContext(_sdfTextProgram.id, variablesMap);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.vs.in.vertexPosition, "in_vs_vertexPosition", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.vs.in.vertexTexCoords, "in_vs_vertexTexCoords", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.vs.in.vertexTextColor, "in_vs_vertexTextColor", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.vs.in.vertexHaloColor, "in_vs_vertexHaloColor", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.vs.in.vertexFieldParams, "in_vs_vertexFieldParams", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.vs.in.vertexModulationColor, "in_vs_vertexModulationColor", GlslVariableType::In);
+    ok = ok && lookup->lookupLocation(_sdfTextProgram.fs.param.sampler, "param_fs_sampler", GlslVariableType::Uniform);
+    if (!ok)
+    {
+        glDeleteProgram(_sdfTextProgram.id);
+        GL_CHECK_RESULT;
+        _sdfTextProgram.id.reset();
+
+        return false;
+    }
+
+    const auto indices = generateQuadsIndices(MaxQuadsPerSymbolsBatch);
+    _sdfTextVertices.reserve(4 * MaxQuadsPerSymbolsBatch);
+
+    _sdfTextSymbolVAO = gpuAPI->allocateUninitializedVAO();
+
+    // Create vertex buffer and associate it with VAO. It's filled for each batch of quads
+    glGenBuffers(1, &_sdfTextSymbolVBO);
+    GL_CHECK_RESULT;
+    glBindBuffer(GL_ARRAY_BUFFER, _sdfTextSymbolVBO);
+    GL_CHECK_RESULT;
+    glBufferData(GL_ARRAY_BUFFER, 4 * MaxQuadsPerSymbolsBatch * sizeof(SdfTextVertex), nullptr, GL_STREAM_DRAW);
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_sdfTextProgram.vs.in.vertexPosition);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_sdfTextProgram.vs.in.vertexPosition, 4, GL_FLOAT, GL_FALSE, sizeof(SdfTextVertex), reinterpret_cast<GLvoid*>(offsetof(SdfTextVertex, position)));
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_sdfTextProgram.vs.in.vertexTexCoords);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_sdfTextProgram.vs.in.vertexTexCoords, 2, GL_FLOAT, GL_FALSE, sizeof(SdfTextVertex), reinterpret_cast<GLvoid*>(offsetof(SdfTextVertex, texCoords)));
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_sdfTextProgram.vs.in.vertexTextColor);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_sdfTextProgram.vs.in.vertexTextColor, 4, GL_FLOAT, GL_FALSE, sizeof(SdfTextVertex), reinterpret_cast<GLvoid*>(offsetof(SdfTextVertex, textColor)));
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_sdfTextProgram.vs.in.vertexHaloColor);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_sdfTextProgram.vs.in.vertexHaloColor, 4, GL_FLOAT, GL_FALSE, sizeof(SdfTextVertex), reinterpret_cast<GLvoid*>(offsetof(SdfTextVertex, haloColor)));
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_sdfTextProgram.vs.in.vertexFieldParams);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_sdfTextProgram.vs.in.vertexFieldParams, 2, GL_FLOAT, GL_FALSE, sizeof(SdfTextVertex), reinterpret_cast<GLvoid*>(offsetof(SdfTextVertex, fieldParams)));
+    GL_CHECK_RESULT;
+    glEnableVertexAttribArray(*_sdfTextProgram.vs.in.vertexModulationColor);
+    GL_CHECK_RESULT;
+    glVertexAttribPointer(*_sdfTextProgram.vs.in.vertexModulationColor, 4, GL_FLOAT, GL_FALSE, sizeof(SdfTextVertex), reinterpret_cast<GLvoid*>(offsetof(SdfTextVertex, modulationColor)));
+    GL_CHECK_RESULT;
+
+    // Create index buffer and associate it with VAO
+    glGenBuffers(1, &_sdfTextSymbolIBO);
+    GL_CHECK_RESULT;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _sdfTextSymbolIBO);
+    GL_CHECK_RESULT;
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.constData(), GL_STATIC_DRAW);
+    GL_CHECK_RESULT;
+
+    gpuAPI->initializeVAO(_sdfTextSymbolVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_RESULT;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL_CHECK_RESULT;
+
+    return true;
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderBillboardSdfTextSymbol(
+    const std::shared_ptr<const RenderableBillboardSymbol>& renderable,
+    AlphaChannelType &currentAlphaChannelType,
+    GLname& lastUsedProgram)
+{
+    const auto& internalState = getInternalState();
+
+    const auto& symbol = std::static_pointer_cast<const BillboardRasterMapSymbol>(renderable->mapSymbol);
+    const auto& gpuResource = std::static_pointer_cast<const GPUAPI::SdfGlyphsInGPU>(renderable->gpuResource);
+    const auto& size = symbol->sdfGlyphRun->size;
+
+    // Glyphs are placed exactly where they'd be in rasterized text
+    const auto symbolLocationOnScreen = getBillboardLocationOnScreen(renderable, size);
+
+    const glm::vec2 topLeftOnScreen(
+        symbolLocationOnScreen.x - size.x * 0.5f,
+        symbolLocationOnScreen.y + size.y * 0.5f);
+    const auto z = -renderable->distanceToCamera;
+    const auto& mOrthographicProjection = internalState.mOrthographicProjection;
+    const auto placeQuad =
+        [topLeftOnScreen, z, mOrthographicProjection]
+        (const SdfGlyphAtlas::GlyphQuad& quad, glm::vec4* const outCorners)
+        {
+            const auto left = topLeftOnScreen.x + quad.area.left();
+            const auto right = topLeftOnScreen.x + quad.area.right();
+            const auto top = topLeftOnScreen.y - quad.area.top();
+            const auto bottom = topLeftOnScreen.y - quad.area.bottom();
+
+            outCorners[0] = mOrthographicProjection * glm::vec4(left, bottom, z, 1.0f);
+            outCorners[1] = mOrthographicProjection * glm::vec4(left, top, z, 1.0f);
+            outCorners[2] = mOrthographicProjection * glm::vec4(right, top, z, 1.0f);
+            outCorners[3] = mOrthographicProjection * glm::vec4(right, bottom, z, 1.0f);
+        };
+
+    return renderSdfTextQuads(
+        symbol,
+        gpuResource,
+        placeQuad,
+        currentAlphaChannelType,
+        lastUsedProgram);
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnPathSdfTextSymbol(
+    const std::shared_ptr<const RenderableOnPathSymbol>& renderable,
+    AlphaChannelType &currentAlphaChannelType,
+    GLname& lastUsedProgram)
+{
+    const auto& internalState = getInternalState();
+
+    const auto& symbol = std::static_pointer_cast<const OnPathRasterMapSymbol>(renderable->mapSymbol);
+    const auto& gpuResource = std::static_pointer_cast<const GPUAPI::SdfGlyphsInGPU>(renderable->gpuResource);
+    const auto& size = symbol->sdfGlyphRun->size;
+
+    // Each glyph of rasterized text is a slice of the bitmap, centered at its anchor point. Glyph quads are
+    // placed relative to center of slice they belong to
+    QVector<float> glyphsCenter(symbol->glyphsWidth.size());
+    float widthOfPrevious = 0.0f;
+    for (int glyphIdx = 0; glyphIdx < symbol->glyphsWidth.size(); glyphIdx++)
+    {
+        const auto glyphWidth = symbol->glyphsWidth[glyphIdx];
+        glyphsCenter[glyphIdx] = widthOfPrevious + glyphWidth * 0.5f;
+        widthOfPrevious += glyphWidth;
+    }
+    const auto centerY = size.y * 0.5f;
+
+    const auto& glyphsPlacement = renderable->glyphsPlacement;
+    SdfTextQuadPlacer placeQuad;
+    if (renderable->is2D)
+    {
+        const auto z = -renderable->distanceToCamera;
+        const auto& mOrthographicProjection = internalState.mOrthographicProjection;
+        placeQuad =
+            [&glyphsPlacement, &glyphsCenter, centerY, z, mOrthographicProjection]
+            (const SdfGlyphAtlas::GlyphQuad& quad, glm::vec4* const outCorners)
+            {
+                const auto glyphIdx = qBound(0, quad.glyphIndex, qMin(glyphsPlacement.size(), glyphsCenter.size()) - 1);
+                const auto& glyph = glyphsPlacement[glyphIdx];
+                const auto cos_a = qCos(glyph.angle);
+                const auto sin_a = qSin(glyph.angle);
+
+                const glm::vec2 corners[4] =
+                {
+                    glm::vec2(quad.area.left(), quad.area.bottom()),
+                    glm::vec2(quad.area.left(), quad.area.top()),
+                    glm::vec2(quad.area.right(), quad.area.top()),
+                    glm::vec2(quad.area.right(), quad.area.bottom())
+                };
+                for (int cornerIdx = 0; cornerIdx < 4; cornerIdx++)
+                {
+                    // On screen, Y axis points up
+                    const glm::vec2 p(corners[cornerIdx].x - glyphsCenter[glyphIdx], centerY - corners[cornerIdx].y);
+
+                    const glm::vec4 vertexOnScreen(
+                        glyph.anchorPoint.x + (p.x*cos_a - p.y*sin_a),
+                        glyph.anchorPoint.y + (p.x*sin_a + p.y*cos_a),
+                        z,
+                        1.0f);
+                    outCorners[cornerIdx] = mOrthographicProjection * vertexOnScreen;
+                }
+            };
+    }
+    else
+    {
+        const auto zDistanceFromCamera =
+            (internalState.mOrthographicProjection * glm::vec4(0.0f, 0.0f, -renderable->distanceToCamera, 1.0f)).z;
+        const auto pixelInWorld = internalState.pixelInWorldProjectionScale;
+        const auto& mPerspectiveProjectionView = internalState.mPerspectiveProjectionView;
+        placeQuad =
+            [&glyphsPlacement, &glyphsCenter, centerY, zDistanceFromCamera, pixelInWorld, mPerspectiveProjectionView]
+            (const SdfGlyphAtlas::GlyphQuad& quad, glm::vec4* const outCorners)
+            {
+                const auto glyphIdx = qBound(0, quad.glyphIndex, qMin(glyphsPlacement.size(), glyphsCenter.size()) - 1);
+                const auto& glyph = glyphsPlacement[glyphIdx];
+                const auto angle = Utilities::normalizedAngleRadians(glyph.angle + M_PI);
+                const auto cos_a = qCos(angle);
+                const auto sin_a = qSin(angle);
+
+                const glm::vec2 corners[4] =
+                {
+                    glm::vec2(quad.area.left(), quad.area.bottom()),
+                    glm::vec2(quad.area.left(), quad.area.top()),
+                    glm::vec2(quad.area.right(), quad.area.top()),
+                    glm::vec2(quad.area.right(), quad.area.bottom())
+                };
+                for (int cornerIdx = 0; cornerIdx < 4; cornerIdx++)
+                {
+                    const glm::vec2 p(
+                        (corners[cornerIdx].x - glyphsCenter[glyphIdx]) * pixelInWorld,
+                        (centerY - corners[cornerIdx].y) * pixelInWorld);
+
+                    const glm::vec4 vertexInWorld(
+                        glyph.anchorPoint.x + (p.x*cos_a - p.y*sin_a),
+                        0.0f,
+                        glyph.anchorPoint.y + (p.x*sin_a + p.y*cos_a),
+                        1.0f);
+                    outCorners[cornerIdx] = mPerspectiveProjectionView * vertexInWorld;
+                    outCorners[cornerIdx].z = zDistanceFromCamera;
+                }
+            };
+    }
+
+    return renderSdfTextQuads(
+        symbol,
+        gpuResource,
+        placeQuad,
+        currentAlphaChannelType,
+        lastUsedProgram);
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderSdfTextQuads(
+    const std::shared_ptr<const RasterMapSymbol>& symbol,
+    const std::shared_ptr<const GPUAPI::SdfGlyphsInGPU>& gpuResource,
+    const SdfTextQuadPlacer& placeQuad,
+    AlphaChannelType &currentAlphaChannelType,
+    GLname& lastUsedProgram)
+{
+    const auto& glyphRun = symbol->sdfGlyphRun;
+
+    // Colors of text and halo, as well as modulation color, go with each vertex
+    SdfTextVertex vertex;
+    const FColorARGB textColor = glyphRun->color;
+    vertex.textColor = glm::vec4(textColor.r, textColor.g, textColor.b, textColor.a);
+    const FColorARGB haloColor = glyphRun->haloRadius > 0 ? FColorARGB(glyphRun->haloColor) : FColorARGB(0.0f, 0.0f, 0.0f, 0.0f);
+    vertex.haloColor = glm::vec4(haloColor.r, haloColor.g, haloColor.b, haloColor.a);
+    vertex.modulationColor = glm::vec4(
+        symbol->modulationColor.r,
+        symbol->modulationColor.g,
+        symbol->modulationColor.b,
+        symbol->modulationColor.a);
+
+    // Halo stroke is centered at glyph outline, so only half of it is outside. Field values are
+    // 1/(2*Spread) per texel, and a texel covers 'scale' pixels of label
+    const auto fieldPerTexel = 1.0f / (2.0f * SdfGlyphAtlas::Spread);
+    vertex.fieldParams.x = qMax(0.0f, 0.5f - (glyphRun->haloRadius * 0.5f / glyphRun->scale) * fieldPerTexel);
+    vertex.fieldParams.y = (0.5f / glyphRun->scale) * fieldPerTexel;
+
+    // Quads are added to batch of the page they use, distance field always has straight alpha
+    for (const auto& quad : constOf(glyphRun->quads))
+    {
+        const auto& pageTexture = gpuResource->pagesTextures[quad.pageIndex];
+        if (!beginSymbolsBatch(
+            SymbolsBatchType::SdfText,
+            pageTexture->refInGPU,
+            AlphaChannelType::Straight,
+            currentAlphaChannelType,
+            lastUsedProgram))
+        {
+            return false;
+        }
+
+        glm::vec4 corners[4];
+        placeQuad(quad, corners);
+
+        // Page is uploaded row by row from top, so V grows downwards
+        const auto sLeft = quad.texels.left() * pageTexture->uTexelSizeN;
+        const auto sRight = quad.texels.right() * pageTexture->uTexelSizeN;
+        const auto tTop = quad.texels.top() * pageTexture->vTexelSizeN;
+        const auto tBottom = quad.texels.bottom() * pageTexture->vTexelSizeN;
+
+        vertex.position = corners[0];
+        vertex.texCoords = glm::vec2(sLeft, tBottom);
+        _sdfTextVertices.push_back(vertex);
+        vertex.position = corners[1];
+        vertex.texCoords = glm::vec2(sLeft, tTop);
+        _sdfTextVertices.push_back(vertex);
+        vertex.position = corners[2];
+        vertex.texCoords = glm::vec2(sRight, tTop);
+        _sdfTextVertices.push_back(vertex);
+        vertex.position = corners[3];
+        vertex.texCoords = glm::vec2(sRight, tBottom);
+        _sdfTextVertices.push_back(vertex);
+        _symbolsBatch.quadsCount++;
+    }
+
+    return true;
+}
+
+bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::releaseSdfText(const bool gpuContextLost)
+{
+    const auto gpuAPI = getGPUAPI();
+
+    GL_CHECK_PRESENT(glDeleteBuffers);
+    GL_CHECK_PRESENT(glDeleteProgram);
+
+    if (_sdfTextSymbolVAO.isValid())
+    {
+        gpuAPI->releaseVAO(_sdfTextSymbolVAO, gpuContextLost);
+        _sdfTextSymbolVAO.reset();
+    }
+
+    if (_sdfTextSymbolIBO.isValid())
+    {
+        if (!gpuContextLost)
+        {
+            glDeleteBuffers(1, &_sdfTextSymbolIBO);
+            GL_CHECK_RESULT;
+        }
+        _sdfTextSymbolIBO.reset();
+    }
+    if (_sdfTextSymbolVBO.isValid())
+    {
+        if (!gpuContextLost)
+        {
+            glDeleteBuffers(1, &_sdfTextSymbolVBO);
+            GL_CHECK_RESULT;
+        }
+        _sdfTextSymbolVBO.reset();
+    }
+
+    if (_sdfTextProgram.id.isValid())
+    {
+        if (!gpuContextLost)
+        {
+            glDeleteProgram(_sdfTextProgram.id);
+            GL_CHECK_RESULT;
+        }
+        _sdfTextProgram = SdfTextSymbolProgram();
+    }
+    _sdfTextVertices.clear();
+
+    return true;
+}
+
 bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::initializeOnSurfaceRaster()
 {
     const auto gpuAPI = getGPUAPI();
@@ -1896,6 +2582,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnSurfaceRasterSymbol(
     // Draw symbol actually
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
     GL_CHECK_RESULT;
+    _symbolsDrawCalls++;
 
     GL_POP_GROUP_MARKER;
 
@@ -2201,6 +2888,7 @@ bool OsmAnd::AtlasMapRendererSymbolsStage_OpenGL::renderOnSurfaceVectorSymbol(
         glDrawArrays(primitivesType, 0, count);
         GL_CHECK_RESULT;
     }
+    _symbolsDrawCalls++;
 
     // Turn off all buffers
     glBindBuffer(GL_ARRAY_BUFFER, 0);
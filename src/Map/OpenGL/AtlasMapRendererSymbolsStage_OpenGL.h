@@ -4,11 +4,15 @@
 #include "stdlib_common.h"
 
 #include "QtExtensions.h"
+#include <QVector>
+
+#include <glm/glm.hpp>
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "AtlasMapRendererSymbolsStage.h"
 #include "AtlasMapRendererStageHelper_OpenGL.h"
+#include "SdfGlyphAtlas.h"
 
 namespace OsmAnd
 {
@@ -23,6 +27,43 @@ namespace OsmAnd
             AlphaChannelType &currentAlphaChannelType,
             GLname& lastUsedProgram);
 
+        // Quads of consecutive symbols that are drawn by the same program from the same texture are collected
+        // into streaming vertex buffer and drawn with a single call. Per-symbol data goes with vertices
+        enum class SymbolsBatchType
+        {
+            None,
+            BillboardRaster,
+            SdfText
+        };
+        struct SymbolsBatch
+        {
+            SymbolsBatch();
+
+            SymbolsBatchType type;
+            GPUAPI::RefInGPU texture;
+            AlphaChannelType alphaChannelType;
+            int quadsCount;
+        } _symbolsBatch;
+        static const int MaxQuadsPerSymbolsBatch;
+        unsigned int _symbolsDrawCalls;
+        unsigned int _symbolsBatchedDrawCalls;
+        unsigned int _symbolsBatchedQuads;
+        void getSymbolsBatchKey(
+            const std::shared_ptr<const RenderableSymbol>& renderable,
+            SymbolsBatchType& outType,
+            GPUAPI::RefInGPU& outTexture) const;
+        void sortRenderableSymbolsForBatching(QList< std::shared_ptr<const RenderableSymbol> >& outSortedRenderableSymbols) const;
+        bool beginSymbolsBatch(
+            const SymbolsBatchType type,
+            const GPUAPI::RefInGPU texture,
+            const AlphaChannelType alphaChannelType,
+            AlphaChannelType &currentAlphaChannelType,
+            GLname& lastUsedProgram);
+        bool flushSymbolsBatch(
+            AlphaChannelType &currentAlphaChannelType,
+            GLname& lastUsedProgram);
+        static QVector<GLushort> generateQuadsIndices(const int quadsCount);
+
         GLname _billboardRasterSymbolVAO;
         GLname _billboardRasterSymbolVBO;
         GLname _billboardRasterSymbolIBO;
@@ -34,40 +75,37 @@ namespace OsmAnd
                 struct {
                     GLlocation vertexPosition;
                     GLlocation vertexTexCoords;
+                    GLlocation vertexModulationColor;
                 } in;
-
-                // Parameters
-                struct {
-                    // Common data
-                    GLlocation mPerspectiveProjectionView;
-                    GLlocation mOrthographicProjection;
-                    GLlocation viewport;
-
-                    // Per-symbol data
-                    GLlocation symbolOffsetFromTarget;
-                    GLlocation symbolSize;
-                    GLlocation distanceFromCamera;
-                    GLlocation onScreenOffset;
-                } param;
             } vs;
 
             struct {
                 // Parameters
                 struct {
                     // Common data
-
-                    // Per-symbol data
                     GLlocation sampler;
-                    GLlocation modulationColor;
                 } param;
             } fs;
         } _billboardRasterProgram;
+        struct BillboardRasterVertex
+        {
+            // Position in clip space
+            glm::vec4 position;
+            // UV coordinates on texture
+            glm::vec2 texCoords;
+            glm::vec4 modulationColor;
+        };
+        QVector<BillboardRasterVertex> _billboardRasterVertices;
         bool initializeBillboardRaster();
         bool renderBillboardRasterSymbol(
             const std::shared_ptr<const RenderableBillboardSymbol>& renderable,
             AlphaChannelType &currentAlphaChannelType,
             GLname& lastUsedProgram);
         bool releaseBillboardRaster(const bool gpuContextLost);
+        // Location of billboard center in viewport, snapped so that symbol of given size covers whole pixels
+        glm::vec2 getBillboardLocationOnScreen(
+            const std::shared_ptr<const RenderableBillboardSymbol>& renderable,
+            const PointI& size) const;
 
         bool initializeOnPath();
         bool renderOnPathSymbol(
@@ -180,6 +218,66 @@ namespace OsmAnd
             GLname& lastUsedProgram);
         bool releaseOnPath3D(const bool gpuContextLost);
 
+        // Text of symbols that reference glyph atlas is drawn as quads of glyphs, with vertices computed on CPU
+        // since quads of one label may span several pages
+        GLname _sdfTextSymbolVAO;
+        GLname _sdfTextSymbolVBO;
+        GLname _sdfTextSymbolIBO;
+        struct SdfTextSymbolProgram {
+            GLname id;
+
+            struct {
+                // Input data
+                struct {
+                    GLlocation vertexPosition;
+                    GLlocation vertexTexCoords;
+                    GLlocation vertexTextColor;
+                    GLlocation vertexHaloColor;
+                    GLlocation vertexFieldParams;
+                    GLlocation vertexModulationColor;
+                } in;
+            } vs;
+
+            struct {
+                // Parameters
+                struct {
+                    // Common data
+                    GLlocation sampler;
+                } param;
+            } fs;
+        } _sdfTextProgram;
+        struct SdfTextVertex
+        {
+            // Position in clip space
+            glm::vec4 position;
+            // UV coordinates on page
+            glm::vec2 texCoords;
+            glm::vec4 textColor;
+            glm::vec4 haloColor;
+            // Field value at halo edge and half-width of smoothed edge, both depend on size of label
+            glm::vec2 fieldParams;
+            glm::vec4 modulationColor;
+        };
+        QVector<SdfTextVertex> _sdfTextVertices;
+        // Computes corners of quad in clip space, in BL, TL, TR, BR order
+        typedef std::function<void (const SdfGlyphAtlas::GlyphQuad& quad, glm::vec4* const outCorners)> SdfTextQuadPlacer;
+        bool initializeSdfText();
+        bool renderBillboardSdfTextSymbol(
+            const std::shared_ptr<const RenderableBillboardSymbol>& renderable,
+            AlphaChannelType &currentAlphaChannelType,
+            GLname& lastUsedProgram);
+        bool renderOnPathSdfTextSymbol(
+            const std::shared_ptr<const RenderableOnPathSymbol>& renderable,
+            AlphaChannelType &currentAlphaChannelType,
+            GLname& lastUsedProgram);
+        bool renderSdfTextQuads(
+            const std::shared_ptr<const RasterMapSymbol>& symbol,
+            const std::shared_ptr<const GPUAPI::SdfGlyphsInGPU>& gpuResource,
+            const SdfTextQuadPlacer& placeQuad,
+            AlphaChannelType &currentAlphaChannelType,
+            GLname& lastUsedProgram);
+        bool releaseSdfText(const bool gpuContextLost);
+
         bool renderOnSurfaceSymbol(
             const std::shared_ptr<const RenderableOnSurfaceSymbol>& renderable,
             AlphaChannelType &currentAlphaChannelType,
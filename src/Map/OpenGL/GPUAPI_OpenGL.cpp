@@ -4,6 +4,7 @@
 
 #include "QtExtensions.h"
 #include <QtMath>
+#include <QByteArray>
 #include <QRegularExpression>
 #include <QRegExp>
 
@@ -15,9 +16,11 @@
 #include "IMapRenderer.h"
 #include "IMapTiledDataProvider.h"
 #include "IRasterMapLayerProvider.h"
+#include "IVectorMapLayerProvider.h"
 #include "IMapElevationDataProvider.h"
 #include "MapSymbol.h"
 #include "RasterMapSymbol.h"
+#include "BillboardRasterMapSymbol.h"
 #include "VectorMapSymbol.h"
 #include "Logging.h"
 #include "Utilities.h"
@@ -36,6 +39,9 @@
 #   define GL_GET_AND_CHECK_RESULT glGetError()
 #endif
 
+const unsigned int OsmAnd::GPUAPI_OpenGL::SymbolsAtlasTextureSize = 1024;
+const unsigned int OsmAnd::GPUAPI_OpenGL::MaxSymbolSizeOnAtlasTexture = 128;
+
 OsmAnd::GPUAPI_OpenGL::GPUAPI_OpenGL()
     : _vaoSimulationLastUnusedId(1)
     , _glVersion(0)
@@ -758,6 +764,10 @@ bool OsmAnd::GPUAPI_OpenGL::uploadTiledDataToGPU(
     {
         return uploadTiledDataAsTextureToGPU(rasterMapLayerData, resourceInGPU);
     }
+    else if (const auto vectorMapLayerData = std::dynamic_pointer_cast<const IVectorMapLayerProvider::Data>(tile))
+    {
+        return uploadTiledDataAsMeshToGPU(vectorMapLayerData, resourceInGPU);
+    }
     else if (const auto elevationData = std::dynamic_pointer_cast<const IMapElevationDataProvider::Data>(tile))
     {
         if (isSupported_vertexShaderTextureLookup)
@@ -780,6 +790,8 @@ bool OsmAnd::GPUAPI_OpenGL::uploadSymbolToGPU(
 {
     if (const auto rasterMapSymbol = std::dynamic_pointer_cast<const RasterMapSymbol>(symbol))
     {
+        if (rasterMapSymbol->sdfGlyphRun)
+            return uploadSymbolAsSdfGlyphsToGPU(rasterMapSymbol, resourceInGPU);
         return uploadSymbolAsTextureToGPU(rasterMapSymbol, resourceInGPU);
     }
     else if (const auto primitiveMapSymbol = std::dynamic_pointer_cast<const VectorMapSymbol>(symbol))
@@ -1146,6 +1158,7 @@ bool OsmAnd::GPUAPI_OpenGL::uploadTiledDataAsArrayBufferToGPU(
     assert(elevationData->size*sizeof(float) == elevationData->rowLength);
     glBufferData(GL_ARRAY_BUFFER, itemsCount*sizeof(float), elevationData->pRawData, GL_STATIC_DRAW);
     GL_CHECK_RESULT;
+    countUploadedBytes(itemsCount*sizeof(float));
 
     // Unbind it
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -1157,6 +1170,47 @@ bool OsmAnd::GPUAPI_OpenGL::uploadTiledDataAsArrayBufferToGPU(
     return true;
 }
 
+bool OsmAnd::GPUAPI_OpenGL::uploadTiledDataAsMeshToGPU(
+    const std::shared_ptr< const IVectorMapLayerProvider::Data >& tile,
+    std::shared_ptr< const ResourceInGPU >& resourceInGPU)
+{
+    GL_CHECK_PRESENT(glGenBuffers);
+    GL_CHECK_PRESENT(glBindBuffer);
+    GL_CHECK_PRESENT(glBufferData);
+
+    // Create vertex buffer
+    GLuint vertexBuffer;
+    glGenBuffers(1, &vertexBuffer);
+    GL_CHECK_RESULT;
+
+    // Bind it
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    GL_CHECK_RESULT;
+
+    // Upload data. Tile may have no triangles at all, in that case buffer stays empty
+    const auto verticesCount = tile->vertices.size();
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        verticesCount*sizeof(IVectorMapLayerProvider::Vertex),
+        verticesCount > 0 ? tile->vertices.constData() : nullptr,
+        GL_STATIC_DRAW);
+    GL_CHECK_RESULT;
+    countUploadedBytes(verticesCount*sizeof(IVectorMapLayerProvider::Vertex));
+
+    // Unbind it
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL_CHECK_RESULT;
+
+    // Triangles are not indexed, so mesh has only vertex buffer
+    const std::shared_ptr<ArrayBufferInGPU> vertexBufferResource(new ArrayBufferInGPU(
+        this,
+        reinterpret_cast<RefInGPU>(vertexBuffer),
+        verticesCount));
+    resourceInGPU.reset(new MeshInGPU(this, vertexBufferResource, nullptr));
+
+    return true;
+}
+
 bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsTextureToGPU(
     const std::shared_ptr< const RasterMapSymbol >& symbol,
     std::shared_ptr< const ResourceInGPU >& resourceInGPU)
@@ -1207,6 +1261,21 @@ bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsTextureToGPU(
     }
     const auto textureFormat = getTextureFormat(symbol);
 
+    // Billboards are drawn in batches, provided they share texture
+    if (!symbolUsesPalette &&
+        std::dynamic_pointer_cast<const BillboardRasterMapSymbol>(symbol) &&
+        symbol->bitmap->width() <= static_cast<int>(MaxSymbolSizeOnAtlasTexture) &&
+        symbol->bitmap->height() <= static_cast<int>(MaxSymbolSizeOnAtlasTexture))
+    {
+        return uploadSymbolToSymbolsAtlasTexture(
+            symbol,
+            textureFormat,
+            getSourceFormat(symbol),
+            sourcePixelByteSize,
+            alphaChannelType,
+            resourceInGPU);
+    }
+
     // Symbols don't use mipmapping, so there is no difference between POT vs NPOT size of texture.
     // In OpenGLES 2.0 and OpenGL 2.0+, NPOT textures are supported in general.
     // OpenGLES 2.0 has some limitations without isSupported_texturesNPOT:
@@ -1259,6 +1328,93 @@ bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsTextureToGPU(
     return true;
 }
 
+bool OsmAnd::GPUAPI_OpenGL::uploadSymbolToSymbolsAtlasTexture(
+    const std::shared_ptr< const RasterMapSymbol >& symbol,
+    const TextureFormat textureFormat,
+    const SourceFormat sourceFormat,
+    const GLsizei sourcePixelByteSize,
+    const AlphaChannelType alphaChannelType,
+    std::shared_ptr< const ResourceInGPU >& resourceInGPU)
+{
+    GL_CHECK_PRESENT(glGenTextures);
+    GL_CHECK_PRESENT(glBindTexture);
+
+    const auto& bitmap = *symbol->bitmap;
+
+    const auto areaInGPU = allocateAreaOnSymbolsAtlasTexture(
+        textureFormat,
+        alphaChannelType,
+        PointI(bitmap.width(), bitmap.height()),
+        [this, textureFormat, sourceFormat, sourcePixelByteSize, alphaChannelType]
+        () -> SymbolsAtlasTextureInGPU*
+        {
+            // Allocate texture id
+            GLuint texture;
+            glGenTextures(1, &texture);
+            GL_CHECK_RESULT;
+            assert(texture != 0);
+
+            // Select this texture
+            glBindTexture(GL_TEXTURE_2D, texture);
+            GL_CHECK_RESULT;
+
+            // Allocate space for this texture
+            allocateTexture2D(GL_TEXTURE_2D, 1, SymbolsAtlasTextureSize, SymbolsAtlasTextureSize, textureFormat);
+
+            // Padding around areas has to be transparent, so whole texture is cleared once
+            const QByteArray emptyData(SymbolsAtlasTextureSize * SymbolsAtlasTextureSize * sourcePixelByteSize, 0);
+            uploadDataToTexture2D(GL_TEXTURE_2D, 0,
+                0, 0, SymbolsAtlasTextureSize, SymbolsAtlasTextureSize,
+                emptyData.constData(), SymbolsAtlasTextureSize, sourcePixelByteSize,
+                sourceFormat);
+
+            // Set maximal mipmap level to 0
+            setMipMapLevelsLimit(GL_TEXTURE_2D, 0);
+
+            // Deselect texture
+            glBindTexture(GL_TEXTURE_2D, 0);
+            GL_CHECK_RESULT;
+
+            return new SymbolsAtlasTextureInGPU(
+                this,
+                reinterpret_cast<RefInGPU>(texture),
+                SymbolsAtlasTextureSize,
+                alphaChannelType,
+                isRenderableTextureFormat(textureFormat, texture));
+        });
+    if (!areaInGPU)
+        return false;
+
+    // Select atlas as active texture
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(reinterpret_cast<intptr_t>(areaInGPU->getAtlasTexture()->refInGPU)));
+    GL_CHECK_RESULT;
+
+    // Area may be reused after another symbol, so padding is uploaded along with bitmap
+    const auto allocatedArea = areaInGPU->getAllocatedArea();
+    const auto padding = SymbolsAtlasTextureInGPU::AreaPadding;
+    const auto paddedRowLength = allocatedArea.width();
+    QByteArray paddedData(paddedRowLength * allocatedArea.height() * sourcePixelByteSize, 0);
+    for (int rowIdx = 0; rowIdx < bitmap.height(); rowIdx++)
+    {
+        memcpy(
+            paddedData.data() + ((rowIdx + padding) * paddedRowLength + padding) * sourcePixelByteSize,
+            reinterpret_cast<const uint8_t*>(bitmap.getPixels()) + rowIdx * bitmap.rowBytes(),
+            bitmap.width() * sourcePixelByteSize);
+    }
+    uploadDataToTexture2D(GL_TEXTURE_2D, 0,
+        allocatedArea.left(), allocatedArea.top(), allocatedArea.width(), allocatedArea.height(),
+        paddedData.constData(), paddedRowLength, sourcePixelByteSize,
+        sourceFormat);
+
+    // Deselect atlas as active texture
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GL_CHECK_RESULT;
+
+    resourceInGPU = areaInGPU;
+
+    return true;
+}
+
 bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsMeshToGPU(
     const std::shared_ptr< const VectorMapSymbol >& symbol,
     std::shared_ptr< const ResourceInGPU >& resourceInGPU)
@@ -1282,6 +1438,7 @@ bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsMeshToGPU(
     // Upload data
     glBufferData(GL_ARRAY_BUFFER, symbol->verticesCount*sizeof(VectorMapSymbol::Vertex), symbol->vertices, GL_STATIC_DRAW);
     GL_CHECK_RESULT;
+    countUploadedBytes(symbol->verticesCount*sizeof(VectorMapSymbol::Vertex));
 
     // Unbind it
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -1313,6 +1470,7 @@ bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsMeshToGPU(
             symbol->indices,
             GL_STATIC_DRAW);
         GL_CHECK_RESULT;
+        countUploadedBytes(symbol->indicesCount*sizeof(VectorMapSymbol::Index));
 
         // Unbind it
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -1331,6 +1489,128 @@ bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsMeshToGPU(
     return true;
 }
 
+bool OsmAnd::GPUAPI_OpenGL::uploadSymbolAsSdfGlyphsToGPU(
+    const std::shared_ptr< const RasterMapSymbol >& symbol,
+    std::shared_ptr< const ResourceInGPU >& resourceInGPU)
+{
+    const auto& glyphRun = symbol->sdfGlyphRun;
+
+    QVector< std::shared_ptr<const TextureInGPU> > pagesTextures;
+    pagesTextures.reserve(glyphRun->pages.size());
+    for (const auto& page : constOf(glyphRun->pages))
+    {
+        const auto pageTexture = obtainSdfGlyphsPageTexture(page);
+        if (!pageTexture)
+            return false;
+        pagesTextures.push_back(pageTexture);
+    }
+
+    resourceInGPU.reset(new SdfGlyphsInGPU(this, pagesTextures));
+
+    return true;
+}
+
+std::shared_ptr<const OsmAnd::GPUAPI::TextureInGPU> OsmAnd::GPUAPI_OpenGL::obtainSdfGlyphsPageTexture(
+    const std::shared_ptr<const SdfGlyphAtlas::Page>& page)
+{
+    GL_CHECK_PRESENT(glGenTextures);
+    GL_CHECK_PRESENT(glBindTexture);
+
+    QMutexLocker scopedLocker(&_sdfGlyphsPagesTexturesMutex);
+
+    // Forget textures of pages that are gone, since page address may be reused
+    auto itPageTexture = mutableIteratorOf(_sdfGlyphsPagesTextures);
+    while (itPageTexture.hasNext())
+    {
+        const auto& pageTexture = itPageTexture.next().value();
+        if (pageTexture.page.expired() || pageTexture.texture.expired())
+            itPageTexture.remove();
+    }
+
+    QReadLocker pageLocker(&page->lock);
+
+    std::shared_ptr<const TextureInGPU> texture;
+    const auto citPageTexture = _sdfGlyphsPagesTextures.constFind(page.get());
+    if (citPageTexture != _sdfGlyphsPagesTextures.cend())
+    {
+        texture = citPageTexture->texture.lock();
+        if (texture && citPageTexture->version == page->version)
+            return texture;
+    }
+
+    // Page has to be A8 with field distances
+    const auto& bitmap = *page->bitmap;
+    assert(bitmap.colorType() == SkColorType::kAlpha_8_SkColorType);
+
+    // Sized single-channel format is used when possible, otherwise luminance is the only option.
+    // In both cases field value is read from red component
+    TextureFormat textureFormat;
+    SourceFormat sourceFormat;
+    const auto byteTextureSizedFormat = getTextureSizedFormat_byte();
+    if (isSupported_texture_storage && isValidTextureSizedFormat(byteTextureSizedFormat))
+    {
+        textureFormat = byteTextureSizedFormat;
+        sourceFormat = getSourceFormat_byte();
+    }
+    else
+    {
+        const GLenum format = GL_LUMINANCE;
+        const GLenum type = GL_UNSIGNED_BYTE;
+        textureFormat = (static_cast<TextureFormat>(format) << 16) | type;
+        sourceFormat.format = format;
+        sourceFormat.type = type;
+    }
+
+    if (!texture)
+    {
+        // Create texture id
+        GLuint textureName;
+        glGenTextures(1, &textureName);
+        GL_CHECK_RESULT;
+        assert(textureName != 0);
+
+        // Activate texture
+        glBindTexture(GL_TEXTURE_2D, textureName);
+        GL_CHECK_RESULT;
+
+        allocateTexture2D(GL_TEXTURE_2D, 1, bitmap.width(), bitmap.height(), textureFormat);
+
+        // Set maximal mipmap level to 0
+        setMipMapLevelsLimit(GL_TEXTURE_2D, 0);
+
+        texture.reset(new TextureInGPU(
+            this,
+            reinterpret_cast<RefInGPU>(textureName),
+            bitmap.width(),
+            bitmap.height(),
+            1,
+            AlphaChannelType::Straight));
+    }
+    else
+    {
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(reinterpret_cast<intptr_t>(texture->refInGPU)));
+        GL_CHECK_RESULT;
+    }
+
+    // Whole page is uploaded, since glyphs are added to it by shelves anyway
+    uploadDataToTexture2D(GL_TEXTURE_2D, 0,
+        0, 0, (GLsizei)bitmap.width(), (GLsizei)bitmap.height(),
+        bitmap.getPixels(), bitmap.rowBytes(), 1,
+        sourceFormat);
+
+    // Deselect page as active texture
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GL_CHECK_RESULT;
+
+    SdfGlyphsPageTexture pageTexture;
+    pageTexture.page = page;
+    pageTexture.texture = texture;
+    pageTexture.version = page->version;
+    _sdfGlyphsPagesTextures.insert(page.get(), pageTexture);
+
+    return texture;
+}
+
 void OsmAnd::GPUAPI_OpenGL::waitUntilUploadIsComplete()
 {
     // glFinish won't return until all current instructions for GPU (in current context) are complete
@@ -1338,6 +1618,122 @@ void OsmAnd::GPUAPI_OpenGL::waitUntilUploadIsComplete()
     GL_CHECK_RESULT;
 }
 
+bool OsmAnd::GPUAPI_OpenGL::isRenderableTextureFormat(const TextureFormat textureFormat, const GLuint texture)
+{
+    GL_CHECK_PRESENT(glGenFramebuffers);
+    GL_CHECK_PRESENT(glBindFramebuffer);
+    GL_CHECK_PRESENT(glFramebufferTexture2D);
+    GL_CHECK_PRESENT(glCheckFramebufferStatus);
+    GL_CHECK_PRESENT(glDeleteFramebuffers);
+
+    QMutexLocker scopedLocker(&_renderableTextureFormatsMutex);
+
+    const auto citRenderable = _renderableTextureFormats.constFind(textureFormat);
+    if (citRenderable != _renderableTextureFormats.cend())
+        return *citRenderable;
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    GL_CHECK_RESULT;
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    GL_CHECK_RESULT;
+    assert(framebuffer != 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    GL_CHECK_RESULT;
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    GL_CHECK_RESULT;
+    const auto renderable = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    GL_CHECK_RESULT;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+    GL_CHECK_RESULT;
+    glDeleteFramebuffers(1, &framebuffer);
+    GL_CHECK_RESULT;
+
+    _renderableTextureFormats.insert(textureFormat, renderable);
+    return renderable;
+}
+
+unsigned int OsmAnd::GPUAPI_OpenGL::compactSymbolsAtlasTextures(const unsigned int maxAreasToMigrate)
+{
+    GL_CHECK_PRESENT(glGenFramebuffers);
+    GL_CHECK_PRESENT(glBindFramebuffer);
+    GL_CHECK_PRESENT(glFramebufferTexture2D);
+    GL_CHECK_PRESENT(glCheckFramebufferStatus);
+    GL_CHECK_PRESENT(glDeleteFramebuffers);
+    GL_CHECK_PRESENT(glCopyTexSubImage2D);
+
+    if (maxAreasToMigrate == 0)
+        return 0;
+
+    // Texels are copied on GPU side: source atlas is attached to temporary framebuffer and read from it
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    GL_CHECK_RESULT;
+    GLuint framebuffer = 0;
+    GLuint attachedTexture = 0;
+
+    const auto areasMigrated = migrateSymbolsAtlasAreas(maxAreasToMigrate,
+        [this, &framebuffer, &attachedTexture]
+        (const std::shared_ptr<SymbolsAtlasTextureInGPU>& sourceAtlasTexture,
+            const AreaI& sourceArea,
+            const std::shared_ptr<SymbolsAtlasTextureInGPU>& destinationAtlasTexture,
+            const AreaI& destinationArea) -> bool
+        {
+            if (framebuffer == 0)
+            {
+                glGenFramebuffers(1, &framebuffer);
+                GL_CHECK_RESULT;
+                assert(framebuffer != 0);
+
+                glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                GL_CHECK_RESULT;
+            }
+
+            const auto sourceTexture = static_cast<GLuint>(reinterpret_cast<intptr_t>(sourceAtlasTexture->refInGPU));
+            if (attachedTexture != sourceTexture)
+            {
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sourceTexture, 0);
+                GL_CHECK_RESULT;
+                attachedTexture = sourceTexture;
+
+                // Atlases of formats that aren't renderable are not compacted, so this is not expected to fail
+                const auto framebufferStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+                GL_CHECK_RESULT;
+                if (framebufferStatus != GL_FRAMEBUFFER_COMPLETE)
+                    return false;
+            }
+
+            glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(reinterpret_cast<intptr_t>(destinationAtlasTexture->refInGPU)));
+            GL_CHECK_RESULT;
+
+            // Padding is copied along with bitmap, since it's transparent on source
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0,
+                destinationArea.left(), destinationArea.top(),
+                sourceArea.left(), sourceArea.top(), sourceArea.width(), sourceArea.height());
+            GL_CHECK_RESULT;
+
+            glBindTexture(GL_TEXTURE_2D, 0);
+            GL_CHECK_RESULT;
+
+            return true;
+        });
+
+    if (framebuffer != 0)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+        GL_CHECK_RESULT;
+
+        glDeleteFramebuffers(1, &framebuffer);
+        GL_CHECK_RESULT;
+    }
+
+    return areasMigrated;
+}
+
 void OsmAnd::GPUAPI_OpenGL::pushDebugGroupMarker(const QString& title)
 {
     if (isSupported_EXT_debug_marker)
@@ -13,6 +13,7 @@
 #include <QString>
 #include <QVector>
 #include <QHash>
+#include <QMutex>
 #include "restore_internal_warnings.h"
 
 #include "ignore_warnings_on_external_includes.h"
@@ -55,6 +56,8 @@
 #include "CommonTypes.h"
 #include "SmartPOD.h"
 #include "GPUAPI.h"
+#include "SdfGlyphAtlas.h"
+#include "IVectorMapLayerProvider.h"
 #include "Logging.h"
 
 #if !defined(OSMAND_GPU_DEBUG)
@@ -208,9 +211,41 @@ namespace OsmAnd
     private:
         bool uploadTiledDataAsTextureToGPU(const std::shared_ptr< const IMapTiledDataProvider::Data >& tile, std::shared_ptr< const ResourceInGPU >& resourceInGPU);
         bool uploadTiledDataAsArrayBufferToGPU(const std::shared_ptr< const IMapTiledDataProvider::Data >& tile, std::shared_ptr< const ResourceInGPU >& resourceInGPU);
+        bool uploadTiledDataAsMeshToGPU(const std::shared_ptr< const IVectorMapLayerProvider::Data >& tile, std::shared_ptr< const ResourceInGPU >& resourceInGPU);
 
         bool uploadSymbolAsTextureToGPU(const std::shared_ptr< const RasterMapSymbol >& symbol, std::shared_ptr< const ResourceInGPU >& resourceInGPU);
         bool uploadSymbolAsMeshToGPU(const std::shared_ptr< const VectorMapSymbol >& symbol, std::shared_ptr< const ResourceInGPU >& resourceInGPU);
+        bool uploadSymbolAsSdfGlyphsToGPU(const std::shared_ptr< const RasterMapSymbol >& symbol, std::shared_ptr< const ResourceInGPU >& resourceInGPU);
+
+        // Small billboard bitmaps are packed into shared atlas textures, so that symbols may be drawn in batches
+        static const unsigned int SymbolsAtlasTextureSize;
+        static const unsigned int MaxSymbolSizeOnAtlasTexture;
+        bool uploadSymbolToSymbolsAtlasTexture(
+            const std::shared_ptr< const RasterMapSymbol >& symbol,
+            const TextureFormat textureFormat,
+            const SourceFormat sourceFormat,
+            const GLsizei sourcePixelByteSize,
+            const AlphaChannelType alphaChannelType,
+            std::shared_ptr< const ResourceInGPU >& resourceInGPU);
+
+        // Atlas textures are compacted by copying texels from framebuffer they are attached to, so formats that
+        // are not renderable (like single-channel ones on some GPUs) are never compacted. Each format is checked
+        // once, on the first texture that has it
+        QMutex _renderableTextureFormatsMutex;
+        QHash<TextureFormat, bool> _renderableTextureFormats;
+        bool isRenderableTextureFormat(const TextureFormat textureFormat, const GLuint texture);
+
+        // Pages of glyph atlas are shared by many symbols, so each page is uploaded once and kept while
+        // any symbol references its texture. Page that got new glyphs since upload is uploaded again
+        struct SdfGlyphsPageTexture
+        {
+            std::weak_ptr<const SdfGlyphAtlas::Page> page;
+            std::weak_ptr<const TextureInGPU> texture;
+            unsigned int version;
+        };
+        QMutex _sdfGlyphsPagesTexturesMutex;
+        QHash<const SdfGlyphAtlas::Page*, SdfGlyphsPageTexture> _sdfGlyphsPagesTextures;
+        std::shared_ptr<const TextureInGPU> obtainSdfGlyphsPageTexture(const std::shared_ptr<const SdfGlyphAtlas::Page>& page);
 
         GLuint _vaoSimulationLastUnusedId;
         struct SimulatedVAO
@@ -263,10 +298,12 @@ namespace OsmAnd
         virtual TextureFormat getTextureFormat(const SkColorType skBitmapConfig) const;
         virtual TextureFormat getTextureSizedFormat(const SkColorType skBitmapConfig) const = 0;
         virtual TextureFormat getTextureSizedFormat_float() const = 0;
+        virtual TextureFormat getTextureSizedFormat_byte() const = 0;
         virtual bool isValidTextureSizedFormat(const TextureFormat textureFormat) const = 0;
 
         virtual SourceFormat getSourceFormat(const SkColorType skBitmapConfig) const;
         virtual SourceFormat getSourceFormat_float() const = 0;
+        virtual SourceFormat getSourceFormat_byte() const = 0;
         virtual bool isValidSourceFormat(const SourceFormat sourceFormat) const = 0;
 
         virtual void glGenVertexArrays_wrapper(GLsizei n, GLuint* arrays) = 0;
@@ -356,6 +393,8 @@ namespace OsmAnd
 
         virtual void waitUntilUploadIsComplete();
 
+        virtual unsigned int compactSymbolsAtlasTextures(const unsigned int maxAreasToMigrate);
+
         virtual void pushDebugGroupMarker(const QString& title);
         virtual void popDebugGroupMarker();
 
@@ -384,6 +384,18 @@ OsmAnd::GPUAPI_OpenGL2plus::TextureFormat OsmAnd::GPUAPI_OpenGL2plus::getTexture
     return static_cast<TextureFormat>(textureFormat);
 }
 
+OsmAnd::GPUAPI_OpenGL2plus::TextureFormat OsmAnd::GPUAPI_OpenGL2plus::getTextureSizedFormat_byte() const
+{
+    GLenum textureFormat = GL_INVALID_ENUM;
+
+    if (isSupported_texture_rg)
+        textureFormat = GL_R8;
+    else
+        textureFormat = GL_LUMINANCE8_EXT; //NOTE: only available in GL_EXT_texture
+
+    return static_cast<TextureFormat>(textureFormat);
+}
+
 bool OsmAnd::GPUAPI_OpenGL2plus::isValidTextureSizedFormat(const TextureFormat textureFormat) const
 {
     return (static_cast<GLenum>(textureFormat) != GL_INVALID_ENUM);
@@ -408,6 +420,15 @@ OsmAnd::GPUAPI_OpenGL2plus::SourceFormat OsmAnd::GPUAPI_OpenGL2plus::getSourceFo
     return sourceFormat;
 }
 
+OsmAnd::GPUAPI_OpenGL2plus::SourceFormat OsmAnd::GPUAPI_OpenGL2plus::getSourceFormat_byte() const
+{
+    SourceFormat sourceFormat;
+    sourceFormat.format = isSupported_texture_rg ? GL_RED : GL_LUMINANCE;
+    sourceFormat.type = GL_UNSIGNED_BYTE;
+
+    return sourceFormat;
+}
+
 bool OsmAnd::GPUAPI_OpenGL2plus::isValidSourceFormat(const SourceFormat sourceFormat) const
 {
     return
@@ -442,6 +463,8 @@ void OsmAnd::GPUAPI_OpenGL2plus::uploadDataToTexture2D(
     GL_CHECK_PRESENT(glPixelStorei);
     GL_CHECK_PRESENT(glTexSubImage2D);
 
+    countUploadedBytes(width * height * elementSize);
+
     // GL_UNPACK_ROW_LENGTH is supported from OpenGL 1.1+
     glPixelStorei(GL_UNPACK_ROW_LENGTH, dataRowLengthInElements);
     GL_CHECK_RESULT;
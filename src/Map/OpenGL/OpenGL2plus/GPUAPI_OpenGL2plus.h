@@ -42,9 +42,11 @@ namespace OsmAnd
     protected:
         virtual TextureFormat getTextureSizedFormat(const SkColorType skColorFormat) const;
         virtual TextureFormat getTextureSizedFormat_float() const;
+        virtual TextureFormat getTextureSizedFormat_byte() const;
         virtual bool isValidTextureSizedFormat(const TextureFormat textureFormat) const;
 
         virtual SourceFormat getSourceFormat_float() const;
+        virtual SourceFormat getSourceFormat_byte() const;
         virtual bool isValidSourceFormat(const SourceFormat sourceFormat) const;
 
         virtual void glPushGroupMarkerEXT_wrapper(GLsizei length, const GLchar* marker);
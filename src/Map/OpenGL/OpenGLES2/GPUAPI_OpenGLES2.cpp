@@ -453,6 +453,18 @@ OsmAnd::GPUAPI_OpenGLES2::TextureFormat OsmAnd::GPUAPI_OpenGLES2::getTextureSize
     return static_cast<TextureFormat>(textureFormat);
 }
 
+OsmAnd::GPUAPI_OpenGLES2::TextureFormat OsmAnd::GPUAPI_OpenGLES2::getTextureSizedFormat_byte() const
+{
+    GLenum textureFormat = GL_INVALID_ENUM;
+
+    if (isSupported_texture_rg)
+        textureFormat = GL_R8_EXT;
+    else if (isSupported_EXT_texture || isSupported_EXT_texture_storage)
+        textureFormat = GL_LUMINANCE8_EXT;
+
+    return static_cast<TextureFormat>(textureFormat);
+}
+
 bool OsmAnd::GPUAPI_OpenGLES2::isValidTextureSizedFormat(const TextureFormat textureFormat) const
 {
     return (static_cast<GLenum>(textureFormat) != GL_INVALID_ENUM);
@@ -477,6 +489,15 @@ OsmAnd::GPUAPI_OpenGLES2::SourceFormat OsmAnd::GPUAPI_OpenGLES2::getSourceFormat
     return sourceFormat;
 }
 
+OsmAnd::GPUAPI_OpenGLES2::SourceFormat OsmAnd::GPUAPI_OpenGLES2::getSourceFormat_byte() const
+{
+    SourceFormat sourceFormat;
+    sourceFormat.format = isSupported_EXT_texture_rg ? GL_RED_EXT : GL_LUMINANCE;
+    sourceFormat.type = GL_UNSIGNED_BYTE;
+
+    return sourceFormat;
+}
+
 bool OsmAnd::GPUAPI_OpenGLES2::isValidSourceFormat(const SourceFormat sourceFormat) const
 {
     return
@@ -508,6 +529,8 @@ void OsmAnd::GPUAPI_OpenGLES2::uploadDataToTexture2D(
 {
     GL_CHECK_PRESENT(glTexSubImage2D);
 
+    countUploadedBytes(width * height * elementSize);
+
     // Try to use glPixelStorei to unpack
     if (isSupported_EXT_unpack_subimage)
     {
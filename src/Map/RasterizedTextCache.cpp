@@ -0,0 +1,178 @@
+#include "RasterizedTextCache.h"
+
+#include "QtCommon.h"
+
+OsmAnd::RasterizedTextCache::RasterizedTextCache(const size_t sizeLimit_)
+    : _residentMemoryUsage(0)
+    , sizeLimit(sizeLimit_)
+{
+}
+
+OsmAnd::RasterizedTextCache::~RasterizedTextCache()
+{
+}
+
+size_t OsmAnd::RasterizedTextCache::getMemoryUsage(const Key& key, const RasterizedText& rasterizedText)
+{
+    auto memoryUsage = sizeof(ResidentText) + sizeof(RasterizedText) + sizeof(Key);
+    memoryUsage += 2 * (key.text.size() + key.shieldResourceName.size()) * sizeof(QChar);
+    memoryUsage += rasterizedText.glyphsWidth.size() * sizeof(SkScalar);
+    if (rasterizedText.bitmap)
+        memoryUsage += rasterizedText.bitmap->getSize();
+    if (rasterizedText.glyphRun)
+    {
+        memoryUsage += sizeof(SdfGlyphAtlas::GlyphRun);
+        memoryUsage += rasterizedText.glyphRun->quads.size() * sizeof(SdfGlyphAtlas::GlyphQuad);
+    }
+    return memoryUsage;
+}
+
+void OsmAnd::RasterizedTextCache::enforceSizeLimit()
+{
+    typedef ClockEvictionList<Key>::Candidate Candidate;
+
+    _clock.evictWhile(
+        [this]
+        () -> bool
+        {
+            return _residentMemoryUsage > sizeLimit;
+        },
+        [this]
+        (const Key& key) -> Candidate
+        {
+            auto& residentText = _residentTexts[key];
+            if (residentText.recentlyUsed)
+            {
+                residentText.recentlyUsed = false;
+                return Candidate::SecondChance;
+            }
+
+            // Symbols that already reference the bitmap or glyph run keep it alive
+            _residentMemoryUsage -= residentText.memoryUsage;
+            _residentTexts.remove(key);
+            return Candidate::Evict;
+        });
+}
+
+std::shared_ptr<const OsmAnd::RasterizedTextCache::RasterizedText> OsmAnd::RasterizedTextCache::obtain(
+    const Key& key,
+    const RasterizeFunction rasterize,
+    Outcome* const outOutcome /*= nullptr*/)
+{
+    std::shared_ptr<PendingText> pendingText;
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        const auto itResidentText = _residentTexts.find(key);
+        if (itResidentText != _residentTexts.end())
+        {
+            itResidentText->recentlyUsed = true;
+            if (outOutcome)
+                *outOutcome = Outcome::Hit;
+            return itResidentText->rasterizedText;
+        }
+
+        const auto citPendingText = _pendingTexts.constFind(key);
+        if (citPendingText != _pendingTexts.cend())
+        {
+            // Wait outside of lock, other labels may be obtained meanwhile
+            const auto sharedFuture = (*citPendingText)->sharedFuture;
+            scopedLocker.unlock();
+
+            if (outOutcome)
+                *outOutcome = Outcome::Joined;
+            return sharedFuture.get();
+        }
+
+        pendingText.reset(new PendingText());
+        _pendingTexts.insert(key, pendingText);
+    }
+
+    const auto rasterizedText = rasterize();
+
+    {
+        QMutexLocker scopedLocker(&_mutex);
+
+        _pendingTexts.remove(key);
+        if (rasterizedText)
+        {
+            ResidentText residentText;
+            residentText.rasterizedText = rasterizedText;
+            residentText.memoryUsage = getMemoryUsage(key, *rasterizedText);
+            residentText.recentlyUsed = true;
+
+            _clock.insert(key);
+            _residentTexts.insert(key, residentText);
+            _residentMemoryUsage += residentText.memoryUsage;
+
+            enforceSizeLimit();
+        }
+    }
+    pendingText->promise.set_value(rasterizedText);
+
+    if (outOutcome)
+        *outOutcome = Outcome::Miss;
+    return rasterizedText;
+}
+
+int OsmAnd::RasterizedTextCache::getResidentTextsCount() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _residentTexts.size();
+}
+
+size_t OsmAnd::RasterizedTextCache::getResidentMemoryUsage() const
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    return _residentMemoryUsage;
+}
+
+void OsmAnd::RasterizedTextCache::clear()
+{
+    QMutexLocker scopedLocker(&_mutex);
+
+    _residentTexts.clear();
+    _clock.clear();
+    _residentMemoryUsage = 0;
+}
+
+OsmAnd::RasterizedTextCache::PendingText::PendingText()
+    : sharedFuture(promise.get_future().share())
+{
+}
+
+bool OsmAnd::RasterizedTextCache::Key::operator==(const Key& that) const
+{
+    return
+        text == that.text &&
+        languageId == that.languageId &&
+        style.wrapWidth == that.style.wrapWidth &&
+        qFuzzyCompare(style.size, that.style.size) &&
+        style.bold == that.style.bold &&
+        style.italic == that.style.italic &&
+        style.color == that.style.color &&
+        style.haloRadius == that.style.haloRadius &&
+        style.haloColor == that.style.haloColor &&
+        style.textAlignment == that.style.textAlignment &&
+        shieldResourceName == that.shieldResourceName &&
+        qFuzzyCompare(scaleFactor, that.scaleFactor) &&
+        environment == that.environment;
+}
+
+uint OsmAnd::qHash(const RasterizedTextCache::Key& key, uint seed /*= 0*/)
+{
+    // Sizes and scale factors are left out, since they're compared fuzzily
+    auto hash = ::qHash(key.text, seed);
+    hash = hash * 31 + static_cast<uint>(key.languageId);
+    hash = hash * 31 + ::qHash(key.shieldResourceName, seed);
+    hash = hash * 31 + key.style.wrapWidth;
+    hash = hash * 31 + key.style.color.argb;
+    hash = hash * 31 + key.style.haloColor.argb;
+    hash = hash * 31 + key.style.haloRadius;
+    hash = hash * 31 + (key.style.bold ? 1u : 0u) + (key.style.italic ? 2u : 0u);
+    hash = hash * 31 + static_cast<uint>(key.style.textAlignment);
+    hash = hash * 31 + ::qHash(reinterpret_cast<quintptr>(key.environment.get()), seed);
+    return hash;
+}
@@ -0,0 +1,124 @@
+#ifndef _OSMAND_CORE_RASTERIZED_TEXT_CACHE_H_
+#define _OSMAND_CORE_RASTERIZED_TEXT_CACHE_H_
+
+#include "stdlib_common.h"
+#include <functional>
+#include <proper/future.h>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkBitmap.h>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "TextRasterizer.h"
+#include "SdfGlyphAtlas.h"
+#include "ClockEvictionList.h"
+
+namespace OsmAnd
+{
+    class MapPresentationEnvironment;
+
+    // Keeps rasterized text labels, so that label crossing many tiles and zoom levels is shaped and
+    // rasterized only once. Total size of kept bitmaps is bounded, labels not used recently are evicted
+    // first (CLOCK). Concurrent requests of the same label wait for the one that rasterizes it.
+    class RasterizedTextCache Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RasterizedTextCache);
+
+    public:
+        struct Key
+        {
+            QString text;
+            LanguageId languageId;
+            TextRasterizer::Style style;
+            // Background bitmap of style is identified by its resource, since scaled bitmaps are new
+            // objects each time they're obtained
+            QString shieldResourceName;
+            float scaleFactor;
+            // Resources of the same name may differ between presentation environments. Environment is
+            // referenced, so that another one can't get the same address while label is cached
+            std::shared_ptr<const MapPresentationEnvironment> environment;
+
+            bool operator==(const Key& that) const;
+        };
+
+        struct RasterizedText
+        {
+            // Either bitmap or glyph run is set, depending on how text is drawn
+            std::shared_ptr<const SkBitmap> bitmap;
+            std::shared_ptr<const SdfGlyphAtlas::GlyphRun> glyphRun;
+            PointI size;
+            QVector<SkScalar> glyphsWidth;
+            float extraTopSpace;
+            float extraBottomSpace;
+            float lineSpacing;
+        };
+
+        enum class Outcome
+        {
+            // Label was kept by cache
+            Hit,
+            // Label was being rasterized by another request
+            Joined,
+            // Label was rasterized by this request
+            Miss,
+        };
+
+        typedef std::function<std::shared_ptr<const RasterizedText>()> RasterizeFunction;
+
+    private:
+        struct ResidentText
+        {
+            std::shared_ptr<const RasterizedText> rasterizedText;
+            size_t memoryUsage;
+            bool recentlyUsed;
+        };
+
+        struct PendingText
+        {
+            PendingText();
+
+            proper::promise< std::shared_ptr<const RasterizedText> > promise;
+            const proper::shared_future< std::shared_ptr<const RasterizedText> > sharedFuture;
+        };
+
+        mutable QMutex _mutex;
+        QHash<Key, ResidentText> _residentTexts;
+        QHash< Key, std::shared_ptr<PendingText> > _pendingTexts;
+        ClockEvictionList<Key> _clock;
+        size_t _residentMemoryUsage;
+
+        static size_t getMemoryUsage(const Key& key, const RasterizedText& rasterizedText);
+        void enforceSizeLimit();
+    public:
+        RasterizedTextCache(const size_t sizeLimit);
+        ~RasterizedTextCache();
+
+        const size_t sizeLimit;
+
+        // Returns rasterized text of given key, calling 'rasterize' only if no other request did that.
+        // Result may be null, if text can't be rasterized
+        std::shared_ptr<const RasterizedText> obtain(
+            const Key& key,
+            const RasterizeFunction rasterize,
+            Outcome* const outOutcome = nullptr);
+
+        int getResidentTextsCount() const;
+        size_t getResidentMemoryUsage() const;
+        void clear();
+    };
+
+    uint qHash(const RasterizedTextCache::Key& key, uint seed = 0);
+}
+
+#endif // !defined(_OSMAND_CORE_RASTERIZED_TEXT_CACHE_H_)
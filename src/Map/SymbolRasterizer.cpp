@@ -1,11 +1,19 @@
 #include "SymbolRasterizer.h"
 #include "SymbolRasterizer_P.h"
 
+const size_t OsmAnd::SymbolRasterizer::DefaultTextCacheSizeLimit = 16 * 1024 * 1024;
+
 OsmAnd::SymbolRasterizer::SymbolRasterizer(
-    const std::shared_ptr<const TextRasterizer>& textRasterizer_ /*= TextRasterizer::getDefault()*/)
+    const std::shared_ptr<const TextRasterizer>& textRasterizer_ /*= TextRasterizer::getDefault()*/,
+    const size_t textCacheSizeLimit_ /*= DefaultTextCacheSizeLimit*/,
+    const TextMode textMode_ /*= TextMode::Bitmap*/)
     : _p(new SymbolRasterizer_P(this))
     , textRasterizer(textRasterizer_)
+    , textCacheSizeLimit(textCacheSizeLimit_)
+    , textMode(textMode_)
+    , sdfGlyphAtlas(textMode_ == TextMode::SdfGlyphs ? new SdfGlyphAtlas(textRasterizer_->fontsCollection) : nullptr)
 {
+    _p->initialize();
 }
 
 OsmAnd::SymbolRasterizer::~SymbolRasterizer()
@@ -17,9 +25,15 @@ void OsmAnd::SymbolRasterizer::rasterize(
     QList< std::shared_ptr<const RasterizedSymbolsGroup> >& outSymbolsGroups,
     const float scaleFactor /*= 1.0f*/,
     const FilterByMapObject filter /*= nullptr*/,
-    const IQueryController* const controller /*= nullptr*/) const
+    const IQueryController* const controller /*= nullptr*/,
+    SymbolRasterizer_Metrics::Metric_rasterize* const metric /*= nullptr*/) const
+{
+    _p->rasterize(primitivisedObjects, outSymbolsGroups, scaleFactor, filter, controller, metric);
+}
+
+void OsmAnd::SymbolRasterizer::clearTextCache() const
 {
-    _p->rasterize(primitivisedObjects, outSymbolsGroups, scaleFactor, filter, controller);
+    _p->clearTextCache();
 }
 
 OsmAnd::SymbolRasterizer::RasterizedSymbolsGroup::RasterizedSymbolsGroup(const std::shared_ptr<const MapObject>& mapObject_)
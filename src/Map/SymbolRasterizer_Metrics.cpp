@@ -0,0 +1,29 @@
+#include "SymbolRasterizer_Metrics.h"
+
+OsmAnd::SymbolRasterizer_Metrics::Metric_rasterize::Metric_rasterize()
+{
+    reset();
+}
+
+OsmAnd::SymbolRasterizer_Metrics::Metric_rasterize::~Metric_rasterize()
+{
+}
+
+void OsmAnd::SymbolRasterizer_Metrics::Metric_rasterize::reset()
+{
+    OsmAnd__SymbolRasterizer_Metrics__Metric_rasterize__FIELDS(RESET_METRIC_FIELD);
+
+    Metric::reset();
+}
+
+QString OsmAnd::SymbolRasterizer_Metrics::Metric_rasterize::toString(const bool shortFormat /*= false*/, const QString& prefix /*= QString::null*/) const
+{
+    QString output;
+
+    OsmAnd__SymbolRasterizer_Metrics__Metric_rasterize__FIELDS(PRINT_METRIC_FIELD);
+    const auto submetricsString = Metric::toString(shortFormat, prefix);
+    if (!submetricsString.isEmpty())
+        output += QLatin1String("\n") + Metric::toString(shortFormat, prefix);
+
+    return output;
+}
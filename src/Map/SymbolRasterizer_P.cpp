@@ -15,6 +15,7 @@
 #include "MapStyleEvaluationResult.h"
 #include "MapPrimitiviser.h"
 #include "TextRasterizer.h"
+#include "RasterizedTextCache.h"
 #include "MapObject.h"
 #include "ObfMapSectionInfo.h"
 #include "QKeyValueIterator.h"
@@ -42,13 +43,26 @@ OsmAnd::SymbolRasterizer_P::~SymbolRasterizer_P()
 {
 }
 
+void OsmAnd::SymbolRasterizer_P::initialize()
+{
+    _textCache.reset(new RasterizedTextCache(owner->textCacheSizeLimit));
+}
+
+void OsmAnd::SymbolRasterizer_P::clearTextCache() const
+{
+    _textCache->clear();
+}
+
 void OsmAnd::SymbolRasterizer_P::rasterize(
     const std::shared_ptr<const MapPrimitiviser::PrimitivisedObjects>& primitivisedObjects,
     QList< std::shared_ptr<const RasterizedSymbolsGroup> >& outSymbolsGroups,
     const float scaleFactor,
     const FilterByMapObject filter,
-    const IQueryController* const controller) const
+    const IQueryController* const controller,
+    SymbolRasterizer_Metrics::Metric_rasterize* const metric) const
 {
+    Stopwatch totalStopwatch(metric != nullptr);
+
     const auto& env = primitivisedObjects->mapPresentationEnvironment;
 
     for (const auto& symbolGroupEntry : rangeOf(constOf(primitivisedObjects->symbolsGroups)))
@@ -85,20 +99,15 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
 
             if (const auto& textSymbol = std::dynamic_pointer_cast<const MapPrimitiviser::TextSymbol>(symbol))
             {
-                TextRasterizer::Style style;
+                RasterizedTextCache::Key textKey;
+                textKey.text = textSymbol->value;
+                textKey.languageId = textSymbol->languageId;
+                textKey.shieldResourceName = textSymbol->shieldResourceName;
+                textKey.scaleFactor = scaleFactor;
+                textKey.environment = env;
+                auto& style = textKey.style;
                 if (!textSymbol->drawOnPath && textSymbol->shieldResourceName.isEmpty())
                     style.wrapWidth = textSymbol->wrapWidth;
-                if (!textSymbol->shieldResourceName.isEmpty())
-                {
-                    env->obtainTextShield(textSymbol->shieldResourceName, style.backgroundBitmap);
-
-                    if (!qFuzzyCompare(scaleFactor, 1.0f) && style.backgroundBitmap) {
-                        style.backgroundBitmap = SkiaUtilities::scaleBitmap(
-                            style.backgroundBitmap,
-                            scaleFactor,
-                            scaleFactor);
-                    }
-                }
                 style
                     .setBold(textSymbol->isBold)
                     .setItalic(textSymbol->isItalic)
@@ -112,21 +121,90 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                         .setHaloRadius(textSymbol->shadowRadius);
                 }
 
-                float lineSpacing;
-                float symbolExtraTopSpace;
-                float symbolExtraBottomSpace;
-                QVector<SkScalar> glyphsWidth;
-                const auto rasterizedText = owner->textRasterizer->rasterize(
-                    textSymbol->value,
-                    style,
-                    textSymbol->drawOnPath ? &glyphsWidth : nullptr,
-                    &symbolExtraTopSpace,
-                    &symbolExtraBottomSpace,
-                    &lineSpacing);
-                if (!rasterizedText)
+                // Same label is usually met in many tiles, so it's rasterized only once. Shield is obtained
+                // and scaled only when label is really rasterized
+                const auto rasterizeText =
+                    [this, &textKey, &env]
+                    () -> std::shared_ptr<const RasterizedTextCache::RasterizedText>
+                    {
+                        auto rasterizationStyle = textKey.style;
+                        if (!textKey.shieldResourceName.isEmpty())
+                        {
+                            env->obtainTextShield(textKey.shieldResourceName, rasterizationStyle.backgroundBitmap);
+
+                            if (!qFuzzyCompare(textKey.scaleFactor, 1.0f) && rasterizationStyle.backgroundBitmap) {
+                                rasterizationStyle.backgroundBitmap = SkiaUtilities::scaleBitmap(
+                                    rasterizationStyle.backgroundBitmap,
+                                    textKey.scaleFactor,
+                                    textKey.scaleFactor);
+                            }
+                        }
+
+                        const std::shared_ptr<RasterizedTextCache::RasterizedText> rasterizedText(
+                            new RasterizedTextCache::RasterizedText());
+                        // Text that glyph atlas can't lay out, e.g. with halo too wide for glyph fields, is
+                        // rasterized to a bitmap
+                        if (owner->sdfGlyphAtlas && !rasterizationStyle.backgroundBitmap)
+                        {
+                            rasterizedText->glyphRun = owner->sdfGlyphAtlas->layoutText(
+                                textKey.text,
+                                rasterizationStyle,
+                                &rasterizedText->glyphsWidth,
+                                &rasterizedText->extraTopSpace,
+                                &rasterizedText->extraBottomSpace,
+                                &rasterizedText->lineSpacing);
+                            if (rasterizedText->glyphRun)
+                            {
+                                rasterizedText->size = rasterizedText->glyphRun->size;
+                                return rasterizedText;
+                            }
+                        }
+
+                        rasterizedText->bitmap = owner->textRasterizer->rasterize(
+                            textKey.text,
+                            rasterizationStyle,
+                            &rasterizedText->glyphsWidth,
+                            &rasterizedText->extraTopSpace,
+                            &rasterizedText->extraBottomSpace,
+                            &rasterizedText->lineSpacing);
+                        if (!rasterizedText->bitmap)
+                            return nullptr;
+                        rasterizedText->size = PointI(rasterizedText->bitmap->width(), rasterizedText->bitmap->height());
+                        return rasterizedText;
+                    };
+
+                Stopwatch textStopwatch(metric != nullptr);
+                auto textOutcome = RasterizedTextCache::Outcome::Miss;
+                const auto cachedText = _textCache->obtain(textKey, rasterizeText, &textOutcome);
+                if (metric)
+                {
+                    metric->elapsedTimeForTextSymbols += textStopwatch.elapsed();
+                    metric->textSymbols++;
+                    switch (textOutcome)
+                    {
+                        case RasterizedTextCache::Outcome::Hit:
+                            metric->textCacheHits++;
+                            break;
+                        case RasterizedTextCache::Outcome::Joined:
+                            metric->textCacheJoins++;
+                            break;
+                        case RasterizedTextCache::Outcome::Miss:
+                            metric->textCacheMisses++;
+                            break;
+                    }
+                }
+                if (!cachedText)
                     continue;
 
+                const auto& rasterizedText = cachedText->bitmap;
+                const auto& textSize = cachedText->size;
+                const auto& glyphsWidth = cachedText->glyphsWidth;
+                const auto symbolExtraTopSpace = cachedText->extraTopSpace;
+                const auto symbolExtraBottomSpace = cachedText->extraBottomSpace;
+                const auto lineSpacing = cachedText->lineSpacing;
+
 #if OSMAND_DUMP_SYMBOLS
+                if (rasterizedText)
                 {
                     QDir::current().mkpath("text_symbols");
                     std::unique_ptr<SkImageEncoder> encoder(CreatePNGImageEncoder());
@@ -142,7 +220,8 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     const std::shared_ptr<RasterizedOnPathSymbol> rasterizedSymbol(new RasterizedOnPathSymbol(
                         group,
                         textSymbol));
-                    rasterizedSymbol->bitmap = qMove(rasterizedText);
+                    rasterizedSymbol->bitmap = rasterizedText;
+                    rasterizedSymbol->sdfGlyphRun = cachedText->glyphRun;
                     rasterizedSymbol->order = textSymbol->order;
                     rasterizedSymbol->contentType = RasterizedSymbol::ContentType::Text;
                     rasterizedSymbol->content = textSymbol->value;
@@ -166,7 +245,7 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     if (!group->symbols.isEmpty() && !textSymbol->drawAlongPath)
                     {
                         localOffset.y += symbolExtraTopSpace;
-                        localOffset.y += rasterizedText->height() / 2;
+                        localOffset.y += textSize.y / 2;
                     }
 
                     // Increment total offset
@@ -176,6 +255,7 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     // Publish new rasterized symbol
                     const std::shared_ptr<RasterizedSpriteSymbol> rasterizedSymbol(new RasterizedSpriteSymbol(group, textSymbol));
                     rasterizedSymbol->bitmap = rasterizedText;
+                    rasterizedSymbol->sdfGlyphRun = cachedText->glyphRun;
                     rasterizedSymbol->order = textSymbol->order;
                     rasterizedSymbol->contentType = RasterizedSymbol::ContentType::Text;
                     rasterizedSymbol->content = textSymbol->value;
@@ -187,8 +267,8 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     if (!qIsNaN(textSymbol->intersectionSizeFactor))
                     {
                         rasterizedSymbol->intersectionBBox = AreaI::fromCenterAndSize(PointI(), PointI(
-                            static_cast<int>(textSymbol->intersectionSizeFactor * rasterizedText->width()),
-                            static_cast<int>(textSymbol->intersectionSizeFactor * rasterizedText->height())));
+                            static_cast<int>(textSymbol->intersectionSizeFactor * textSize.x),
+                            static_cast<int>(textSymbol->intersectionSizeFactor * textSize.y)));
                     }
                     else if (!qIsNaN(textSymbol->intersectionSize))
                     {
@@ -199,14 +279,14 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     else if (!qIsNaN(textSymbol->intersectionMargin))
                     {
                         rasterizedSymbol->intersectionBBox = AreaI::fromCenterAndSize(PointI(), PointI(
-                            rasterizedText->width() + static_cast<int>(textSymbol->intersectionMargin),
-                            rasterizedText->height() + static_cast<int>(textSymbol->intersectionMargin)));
+                            textSize.x + static_cast<int>(textSymbol->intersectionMargin),
+                            textSize.y + static_cast<int>(textSymbol->intersectionMargin)));
                     }
                     else
                     {
                         rasterizedSymbol->intersectionBBox = AreaI::fromCenterAndSize(PointI(), PointI(
-                            static_cast<int>(rasterizedText->width()),
-                            static_cast<int>(rasterizedText->height())));
+                            static_cast<int>(textSize.x),
+                            static_cast<int>(textSize.y)));
 
                         rasterizedSymbol->intersectionBBox.top() -= static_cast<int>(symbolExtraTopSpace);
                         rasterizedSymbol->intersectionBBox.bottom() += static_cast<int>(symbolExtraBottomSpace);
@@ -221,7 +301,7 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
                     //  - spacing between lines
                     if (!textSymbol->drawAlongPath)
                     {
-                        totalOffset.y += rasterizedText->height() / 2;
+                        totalOffset.y += textSize.y / 2;
                         totalOffset.y += symbolExtraBottomSpace;
                         totalOffset.y += qCeil(lineSpacing);
                     }
@@ -229,6 +309,8 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
             }
             else if (const auto& iconSymbol = std::dynamic_pointer_cast<const MapPrimitiviser::IconSymbol>(symbol))
             {
+                Stopwatch iconStopwatch(metric != nullptr);
+
                 std::shared_ptr<const SkBitmap> iconBitmap;
                 if (!env->obtainMapIcon(iconSymbol->resourceName, iconBitmap) || !iconBitmap)
                     continue;
@@ -274,6 +356,11 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
 
                 // Compose final image
                 const auto rasterizedIcon = SkiaUtilities::mergeBitmaps(layers);
+                if (metric)
+                {
+                    metric->elapsedTimeForIconSymbols += iconStopwatch.elapsed();
+                    metric->iconSymbols++;
+                }
 
 #if OSMAND_DUMP_SYMBOLS
                 {
@@ -345,4 +432,7 @@ void OsmAnd::SymbolRasterizer_P::rasterize(
         // Add group to output
         outSymbolsGroups.push_back(qMove(group));
     }
+
+    if (metric)
+        metric->elapsedTime += totalStopwatch.elapsed();
 }
@@ -20,11 +20,13 @@
 #include "MapCommonTypes.h"
 #include "MapPrimitiviser.h"
 #include "SymbolRasterizer.h"
+#include "SymbolRasterizer_Metrics.h"
 
 namespace OsmAnd
 {
     class MapObject;
     class IQueryController;
+    class RasterizedTextCache;
 
     class SymbolRasterizer_P Q_DECL_FINAL
     {
@@ -36,8 +38,11 @@ namespace OsmAnd
         typedef SymbolRasterizer::FilterByMapObject FilterByMapObject;
 
     private:
+        std::unique_ptr<RasterizedTextCache> _textCache;
     protected:
         SymbolRasterizer_P(SymbolRasterizer* const owner);
+
+        void initialize();
     public:
         ~SymbolRasterizer_P();
 
@@ -48,7 +53,10 @@ namespace OsmAnd
             QList< std::shared_ptr<const RasterizedSymbolsGroup> >& outSymbolsGroups,
             const float scaleFactor,
             const FilterByMapObject filter,
-            const IQueryController* const controller) const;
+            const IQueryController* const controller,
+            SymbolRasterizer_Metrics::Metric_rasterize* const metric) const;
+
+        void clearTextCache() const;
 
     friend class OsmAnd::SymbolRasterizer;
     };
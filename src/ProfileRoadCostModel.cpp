@@ -0,0 +1,82 @@
+#include "ProfileRoadCostModel.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QStringList>
+#include <QMutexLocker>
+#include "restore_internal_warnings.h"
+
+#include "RoutingProfileContext.h"
+#include "Road.h"
+
+OsmAnd::ProfileRoadCostModel::ProfileRoadCostModel(
+    const std::shared_ptr<RoutingProfile>& profile_,
+    const QHash<QString, QString>& parameters_ /*= QHash<QString, QString>()*/)
+    : profile(profile_)
+    , parameters(parameters_)
+{
+    auto contextValues = parameters;
+    _context.reset(new RoutingProfileContext(profile, &contextValues));
+}
+
+OsmAnd::ProfileRoadCostModel::~ProfileRoadCostModel()
+{
+}
+
+QString OsmAnd::ProfileRoadCostModel::getSignature() const
+{
+    // Parameters change evaluation of rulesets, so they're part of the signature
+    QStringList parametersList;
+    for (auto itParameter = parameters.cbegin(); itParameter != parameters.cend(); ++itParameter)
+        parametersList.push_back(itParameter.key() + QLatin1String("=") + itParameter.value());
+    parametersList.sort();
+
+    return QLatin1String("profile/") + profile->name + QLatin1String("?") + parametersList.join(QLatin1String("&"));
+}
+
+bool OsmAnd::ProfileRoadCostModel::acceptsRoad(const std::shared_ptr<const Road>& road) const
+{
+    QMutexLocker scopedLocker(&_contextMutex);
+
+    const auto compiledRoadTypes = _context->getCompiledRoadTypes(road);
+    return compiledRoadTypes.accepted && compiledRoadTypes.speed > 0.0f;
+}
+
+OsmAnd::RoadDirection OsmAnd::ProfileRoadCostModel::getDirection(const std::shared_ptr<const Road>& road) const
+{
+    QMutexLocker scopedLocker(&_contextMutex);
+
+    return _context->getDirection(road);
+}
+
+float OsmAnd::ProfileRoadCostModel::getSpeed(const std::shared_ptr<const Road>& road) const
+{
+    QMutexLocker scopedLocker(&_contextMutex);
+
+    // Priority scales the speed used for routing, same as in profiles of the mobile applications.
+    // Result is capped by maximal speed of the profile, so remaining time is never overestimated
+    const auto compiledRoadTypes = _context->getCompiledRoadTypes(road);
+    return qMin(compiledRoadTypes.speed * compiledRoadTypes.speedPriority, profile->maxDefaultSpeed);
+}
+
+float OsmAnd::ProfileRoadCostModel::getMaxSpeed() const
+{
+    return profile->maxDefaultSpeed;
+}
+
+float OsmAnd::ProfileRoadCostModel::getPointPenalty(const std::shared_ptr<const Road>& road, const int pointIndex) const
+{
+    QMutexLocker scopedLocker(&_contextMutex);
+
+    // Negative routing obstacle means the point can't be passed at all, and a road can't be cut at a point
+    // in the graph, so such points get a penalty that no alternative can exceed
+    const auto penalty = _context->getRoutingObstaclesExtraTime(road, static_cast<uint32_t>(pointIndex));
+    if (penalty < 0.0f)
+        return 24.0f * 60.0f * 60.0f;
+    return penalty;
+}
+
+bool OsmAnd::ProfileRoadCostModel::isRestrictionsAware() const
+{
+    return profile->restrictionsAware;
+}
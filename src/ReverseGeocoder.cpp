@@ -0,0 +1,59 @@
+#include "ReverseGeocoder.h"
+#include "ReverseGeocoder_P.h"
+
+const double OsmAnd::ReverseGeocoder::DefaultMaxDistance = 500.0;
+
+OsmAnd::ReverseGeocoder::ReverseGeocoder(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection_,
+    const QString& indexFilename_ /*= QString()*/)
+    : _p(new ReverseGeocoder_P(this))
+    , obfsCollection(obfsCollection_)
+    , indexFilename(indexFilename_)
+{
+}
+
+OsmAnd::ReverseGeocoder::~ReverseGeocoder()
+{
+}
+
+bool OsmAnd::ReverseGeocoder::prepareIndex(const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->prepareIndex(controller);
+}
+
+bool OsmAnd::ReverseGeocoder::isIndexPrepared() const
+{
+    return _p->isIndexPrepared();
+}
+
+int OsmAnd::ReverseGeocoder::getEntriesCount() const
+{
+    return _p->getEntriesCount();
+}
+
+bool OsmAnd::ReverseGeocoder::findNearestAddress(
+    const PointI position31,
+    Address& outAddress,
+    const double maxDistance /*= DefaultMaxDistance*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->findNearestAddress(position31, outAddress, maxDistance, controller);
+}
+
+unsigned int OsmAnd::ReverseGeocoder::findNearestAddresses(
+    const QVector<PointI>& positions31,
+    QVector<Address>& outAddresses,
+    const double maxDistance /*= DefaultMaxDistance*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->findNearestAddresses(positions31, outAddresses, maxDistance, controller);
+}
+
+OsmAnd::ReverseGeocoder::Address::Address()
+    : distance(-1.0)
+{
+}
+
+OsmAnd::ReverseGeocoder::Address::~Address()
+{
+}
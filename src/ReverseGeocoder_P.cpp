@@ -0,0 +1,575 @@
+#include "ReverseGeocoder_P.h"
+#include "ReverseGeocoder.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QFile>
+#include <QSet>
+#include <QMutexLocker>
+#include "restore_internal_warnings.h"
+
+#include "IObfsCollection.h"
+#include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfInfo.h"
+#include "ObfAddressSectionInfo.h"
+#include "ObfAddressSectionReader.h"
+#include "StreetGroup.h"
+#include "Street.h"
+#include "Building.h"
+#include "StreetIntersection.h"
+#include "FlatArraysIO.h"
+#include "IQueryController.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+// 'OARG' in native (little-endian) byte order
+const uint32_t OsmAnd::ReverseGeocoder_P::Signature = 0x4752414F;
+const uint32_t OsmAnd::ReverseGeocoder_P::Version = 1;
+const uint32_t OsmAnd::ReverseGeocoder_P::NoString = std::numeric_limits<uint32_t>::max();
+const int OsmAnd::ReverseGeocoder_P::CellSizeShift = 15;
+
+OsmAnd::ReverseGeocoder_P::ReverseGeocoder_P(ReverseGeocoder* const owner_)
+    : _isIndexPrepared(0)
+    , _maxEntryExtent31(0)
+    , owner(owner_)
+{
+}
+
+OsmAnd::ReverseGeocoder_P::~ReverseGeocoder_P()
+{
+}
+
+uint64_t OsmAnd::ReverseGeocoder_P::makeCellKey(const int32_t cellX, const int32_t cellY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+double OsmAnd::ReverseGeocoder_P::squareDistanceToEntry(const PointI& position31, const Entry& entry, PointI& outNearestPoint31)
+{
+    outNearestPoint31 = entry.start31;
+    if (entry.start31 != entry.end31)
+    {
+        const auto segmentX = static_cast<double>(entry.end31.x) - entry.start31.x;
+        const auto segmentY = static_cast<double>(entry.end31.y) - entry.start31.y;
+        const auto t = qBound(0.0,
+            ((static_cast<double>(position31.x) - entry.start31.x) * segmentX +
+                (static_cast<double>(position31.y) - entry.start31.y) * segmentY) /
+                (segmentX * segmentX + segmentY * segmentY),
+            1.0);
+        outNearestPoint31.x = entry.start31.x + static_cast<int32_t>(qRound64(t * segmentX));
+        outNearestPoint31.y = entry.start31.y + static_cast<int32_t>(qRound64(t * segmentY));
+    }
+
+    return Utilities::squareDistance31(position31, outNearestPoint31);
+}
+
+QString OsmAnd::ReverseGeocoder_P::getString(const uint32_t index) const
+{
+    if (index == NoString)
+        return QString();
+
+    const auto offset = _stringsOffsets[index];
+    return QString::fromUtf8(_stringsData.constData() + offset, _stringsOffsets[index + 1] - offset);
+}
+
+void OsmAnd::ReverseGeocoder_P::clear() const
+{
+    _stringsData.clear();
+    _stringsOffsets.clear();
+    _settlements.clear();
+    _streets.clear();
+    _entries.clear();
+    _cellKeys.clear();
+    _cellFirstEntries.clear();
+    _maxEntryExtent31 = 0;
+}
+
+uint32_t OsmAnd::ReverseGeocoder_P::addString(const QString& value, QHash<QString, uint32_t>& stringsIndices) const
+{
+    if (value.isEmpty())
+        return NoString;
+
+    const auto citIndex = stringsIndices.constFind(value);
+    if (citIndex != stringsIndices.cend())
+        return *citIndex;
+
+    const uint32_t index = _stringsOffsets.size() - 1;
+    _stringsData.append(value.toUtf8());
+    _stringsOffsets.push_back(_stringsData.size());
+    stringsIndices.insert(value, index);
+
+    return index;
+}
+
+bool OsmAnd::ReverseGeocoder_P::build(const IQueryController* const controller) const
+{
+    clear();
+    _stringsOffsets.push_back(0);
+
+    // Postcode groups contain the same streets as settlements do, so they are skipped
+    QSet<ObfAddressBlockType> blockTypes;
+    blockTypes.insert(ObfAddressBlockType::CitiesOrTowns);
+    blockTypes.insert(ObfAddressBlockType::Villages);
+
+    QHash<QString, uint32_t> stringsIndices;
+    const auto dataInterface = owner->obfsCollection->obtainDataInterface();
+    for (const auto& obfReader : constOf(dataInterface->obfReaders))
+    {
+        const auto& obfInfo = obfReader->obtainInfo();
+        for (const auto& addressSection : constOf(obfInfo->addressSections))
+        {
+            QList< std::shared_ptr<const StreetGroup> > streetGroups;
+            ObfAddressSectionReader::loadStreetGroups(
+                obfReader,
+                addressSection,
+                &streetGroups,
+                nullptr,
+                controller,
+                &blockTypes);
+
+            for (const auto& streetGroup : constOf(streetGroups))
+            {
+                if (controller && controller->isAborted())
+                    return false;
+
+                Settlement settlement;
+                settlement.name = addString(streetGroup->_name, stringsIndices);
+                settlement.latinName = addString(streetGroup->_latinName, stringsIndices);
+                const uint32_t settlementIndex = _settlements.size();
+                _settlements.push_back(settlement);
+
+                QList< std::shared_ptr<const OsmAnd::Street> > streets;
+                ObfAddressSectionReader::loadStreetsFromGroup(obfReader, streetGroup, &streets, nullptr, controller);
+                for (const auto& street : constOf(streets))
+                {
+                    Street streetRecord;
+                    streetRecord.name = addString(street->name, stringsIndices);
+                    streetRecord.latinName = addString(street->latinName, stringsIndices);
+                    streetRecord.settlement = settlementIndex;
+                    const uint32_t streetIndex = _streets.size();
+                    _streets.push_back(streetRecord);
+
+                    // Street has no geometry of its own: its position and its intersections with other streets
+                    // are points that approximate it
+                    Entry streetEntry;
+                    streetEntry.street = streetIndex;
+                    streetEntry.houseNumber = NoString;
+                    streetEntry.postcode = NoString;
+                    streetEntry.start31 = streetEntry.end31 = PointI(street->tile24.x << 7, street->tile24.y << 7);
+                    _entries.push_back(streetEntry);
+
+                    QList< std::shared_ptr<const StreetIntersection> > intersections;
+                    ObfAddressSectionReader::loadIntersectionsFromStreet(obfReader, street, &intersections, nullptr, controller);
+                    for (const auto& intersection : constOf(intersections))
+                    {
+                        streetEntry.start31 = streetEntry.end31 = PointI(intersection->tile24.x << 7, intersection->tile24.y << 7);
+                        _entries.push_back(streetEntry);
+                    }
+
+                    QList< std::shared_ptr<const Building> > buildings;
+                    ObfAddressSectionReader::loadBuildingsFromStreet(obfReader, street, &buildings, nullptr, controller);
+                    for (const auto& building : constOf(buildings))
+                    {
+                        Entry buildingEntry;
+                        buildingEntry.street = streetIndex;
+                        buildingEntry.postcode = addString(building->_postcode, stringsIndices);
+                        buildingEntry.start31 = buildingEntry.end31 = PointI(building->_xTile24 << 7, building->_yTile24 << 7);
+
+                        const auto isInterpolated =
+                            (building->_interpolation != Building::Interpolation::Invalid || building->_interpolationInterval > 0) &&
+                            (building->_x2Tile24 != 0 || building->_y2Tile24 != 0);
+                        if (isInterpolated)
+                        {
+                            buildingEntry.end31 = PointI(building->_x2Tile24 << 7, building->_y2Tile24 << 7);
+                            buildingEntry.houseNumber = addString(
+                                building->_name2.isEmpty() ? building->_name : building->_name + QLatin1Char('-') + building->_name2,
+                                stringsIndices);
+                        }
+                        else
+                            buildingEntry.houseNumber = addString(building->_name, stringsIndices);
+                        _entries.push_back(buildingEntry);
+                    }
+                }
+            }
+        }
+    }
+
+    buildGrid();
+
+    return true;
+}
+
+void OsmAnd::ReverseGeocoder_P::buildGrid() const
+{
+    // Entries are placed into cell of their start by counting sort over sorted cell keys
+    const auto entriesCount = _entries.size();
+    QVector<uint64_t> entriesCellKeys(entriesCount);
+    _maxEntryExtent31 = 0;
+    for (auto entryIdx = 0; entryIdx < entriesCount; entryIdx++)
+    {
+        const auto& entry = _entries[entryIdx];
+        entriesCellKeys[entryIdx] = makeCellKey(entry.start31.x >> CellSizeShift, entry.start31.y >> CellSizeShift);
+        _maxEntryExtent31 = qMax(_maxEntryExtent31, qAbs(entry.end31.x - entry.start31.x));
+        _maxEntryExtent31 = qMax(_maxEntryExtent31, qAbs(entry.end31.y - entry.start31.y));
+    }
+
+    _cellKeys = entriesCellKeys;
+    std::sort(_cellKeys.begin(), _cellKeys.end());
+    _cellKeys.erase(std::unique(_cellKeys.begin(), _cellKeys.end()), _cellKeys.end());
+    _cellKeys.squeeze();
+
+    const auto cellsCount = _cellKeys.size();
+    QVector<uint32_t> entriesCells(entriesCount);
+    _cellFirstEntries.resize(cellsCount + 1);
+    std::fill(_cellFirstEntries.begin(), _cellFirstEntries.end(), 0u);
+    for (auto entryIdx = 0; entryIdx < entriesCount; entryIdx++)
+    {
+        const auto cell = static_cast<uint32_t>(
+            std::lower_bound(_cellKeys.cbegin(), _cellKeys.cend(), entriesCellKeys[entryIdx]) - _cellKeys.cbegin());
+        entriesCells[entryIdx] = cell;
+        _cellFirstEntries[cell + 1]++;
+    }
+    for (auto cell = 0; cell < cellsCount; cell++)
+        _cellFirstEntries[cell + 1] += _cellFirstEntries[cell];
+
+    QVector<uint32_t> nextEntries(_cellFirstEntries.mid(0, cellsCount));
+    QVector<Entry> sortedEntries(entriesCount);
+    for (auto entryIdx = 0; entryIdx < entriesCount; entryIdx++)
+        sortedEntries[nextEntries[entriesCells[entryIdx]]++] = _entries[entryIdx];
+    _entries = sortedEntries;
+}
+
+bool OsmAnd::ReverseGeocoder_P::load() const
+{
+    const auto& filename = owner->indexFilename;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open reverse geocoding index '%s': %s", qPrintable(filename), qPrintable(file.errorString()));
+        return false;
+    }
+
+    FileHeader header;
+    if (!FlatArraysIO::read(file, header))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Reverse geocoding index '%s' is truncated", qPrintable(filename));
+        return false;
+    }
+    if (header.signature != Signature || header.version != Version)
+    {
+        LogPrintf(LogSeverityLevel::Error, "'%s' is not a reverse geocoding index of version %d", qPrintable(filename), Version);
+        return false;
+    }
+    const auto sourceSignature = Utilities::computeObfFilesSignature(owner->obfsCollection->getObfFiles());
+    if (memcmp(header.sourceSignature, sourceSignature.constData(), sizeof(header.sourceSignature)) != 0)
+    {
+        LogPrintf(LogSeverityLevel::Info, "Reverse geocoding index '%s' is out of date", qPrintable(filename));
+        return false;
+    }
+
+    const auto expectedSize =
+        sizeof(FileHeader) +
+        (static_cast<uint64_t>(header.stringsCount) + 1) * sizeof(uint32_t) +
+        header.stringsDataSize +
+        static_cast<uint64_t>(header.settlementsCount) * sizeof(Settlement) +
+        static_cast<uint64_t>(header.streetsCount) * sizeof(Street) +
+        static_cast<uint64_t>(header.entriesCount) * sizeof(Entry) +
+        static_cast<uint64_t>(header.cellsCount) * sizeof(uint64_t) +
+        (static_cast<uint64_t>(header.cellsCount) + 1) * sizeof(uint32_t);
+    if (static_cast<uint64_t>(file.size()) != expectedSize)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Reverse geocoding index '%s' is corrupted", qPrintable(filename));
+        return false;
+    }
+
+    _stringsOffsets.resize(header.stringsCount + 1);
+    _stringsData.resize(header.stringsDataSize);
+    _settlements.resize(header.settlementsCount);
+    _streets.resize(header.streetsCount);
+    _entries.resize(header.entriesCount);
+    _cellKeys.resize(header.cellsCount);
+    _cellFirstEntries.resize(header.cellsCount + 1);
+    _maxEntryExtent31 = header.maxEntryExtent31;
+    auto ok = FlatArraysIO::readArray(file, _stringsOffsets);
+    ok = ok && FlatArraysIO::readArray(file, _stringsData);
+    ok = ok && FlatArraysIO::readArray(file, _settlements);
+    ok = ok && FlatArraysIO::readArray(file, _streets);
+    ok = ok && FlatArraysIO::readArray(file, _entries);
+    ok = ok && FlatArraysIO::readArray(file, _cellKeys);
+    ok = ok && FlatArraysIO::readArray(file, _cellFirstEntries);
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to read reverse geocoding index '%s'", qPrintable(filename));
+        return false;
+    }
+
+    const auto isValidString =
+        [&header]
+        (const uint32_t index) -> bool
+        {
+            return index == NoString || index < header.stringsCount;
+        };
+    auto isValid = (_stringsOffsets.first() == 0 && _stringsOffsets.last() == header.stringsDataSize);
+    for (auto stringIdx = 0u; isValid && stringIdx < header.stringsCount; stringIdx++)
+        isValid = (_stringsOffsets[stringIdx] <= _stringsOffsets[stringIdx + 1]);
+    for (const auto& settlement : constOf(_settlements))
+        isValid = isValid && isValidString(settlement.name) && isValidString(settlement.latinName);
+    for (const auto& street : constOf(_streets))
+    {
+        isValid = isValid && isValidString(street.name) && isValidString(street.latinName) &&
+            street.settlement < header.settlementsCount;
+    }
+    for (const auto& entry : constOf(_entries))
+    {
+        isValid = isValid && entry.street < header.streetsCount &&
+            isValidString(entry.houseNumber) && isValidString(entry.postcode);
+    }
+    isValid = isValid && (_cellFirstEntries.first() == 0 && _cellFirstEntries.last() == header.entriesCount);
+    for (auto cell = 0u; isValid && cell < header.cellsCount; cell++)
+    {
+        isValid = (_cellFirstEntries[cell] <= _cellFirstEntries[cell + 1]) &&
+            (cell == 0 || _cellKeys[cell - 1] < _cellKeys[cell]);
+    }
+    if (!isValid)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Reverse geocoding index '%s' is corrupted", qPrintable(filename));
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::ReverseGeocoder_P::save() const
+{
+    const auto& filename = owner->indexFilename;
+    QFile output(filename);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open '%s' for writing: %s", qPrintable(filename), qPrintable(output.errorString()));
+        return false;
+    }
+
+    FileHeader header;
+    header.signature = Signature;
+    header.version = Version;
+    header.stringsCount = _stringsOffsets.size() - 1;
+    header.stringsDataSize = _stringsData.size();
+    header.settlementsCount = _settlements.size();
+    header.streetsCount = _streets.size();
+    header.entriesCount = _entries.size();
+    header.cellsCount = _cellKeys.size();
+    header.maxEntryExtent31 = _maxEntryExtent31;
+    const auto sourceSignature = Utilities::computeObfFilesSignature(owner->obfsCollection->getObfFiles());
+    memcpy(header.sourceSignature, sourceSignature.constData(), sizeof(header.sourceSignature));
+
+    auto ok = FlatArraysIO::write(output, header);
+    ok = ok && FlatArraysIO::writeArray(output, _stringsOffsets);
+    ok = ok && FlatArraysIO::writeArray(output, _stringsData);
+    ok = ok && FlatArraysIO::writeArray(output, _settlements);
+    ok = ok && FlatArraysIO::writeArray(output, _streets);
+    ok = ok && FlatArraysIO::writeArray(output, _entries);
+    ok = ok && FlatArraysIO::writeArray(output, _cellKeys);
+    ok = ok && FlatArraysIO::writeArray(output, _cellFirstEntries);
+    output.close();
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to write reverse geocoding index '%s'", qPrintable(filename));
+        QFile::remove(filename);
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::ReverseGeocoder_P::prepareIndex(const IQueryController* const controller) const
+{
+    if (_isIndexPrepared.loadAcquire() != 0)
+        return true;
+
+    QMutexLocker scopedLocker(&_indexMutex);
+    if (_isIndexPrepared.loadAcquire() != 0)
+        return true;
+
+    const auto& filename = owner->indexFilename;
+    auto isPrepared = false;
+    if (!filename.isEmpty() && QFile::exists(filename))
+        isPrepared = load();
+    if (!isPrepared)
+    {
+        isPrepared = build(controller);
+        if (isPrepared && !filename.isEmpty())
+            save();
+    }
+    if (!isPrepared)
+    {
+        clear();
+        return false;
+    }
+
+    _isIndexPrepared.storeRelease(1);
+    return true;
+}
+
+bool OsmAnd::ReverseGeocoder_P::isIndexPrepared() const
+{
+    return _isIndexPrepared.loadAcquire() != 0;
+}
+
+int OsmAnd::ReverseGeocoder_P::getEntriesCount() const
+{
+    if (!isIndexPrepared())
+        return 0;
+
+    return _entries.size();
+}
+
+bool OsmAnd::ReverseGeocoder_P::findNearestEntry(
+    const PointI& position31,
+    const double maxDistance,
+    int& outEntry,
+    PointI& outNearestPoint31,
+    double& outDistance) const
+{
+    const auto maxCell = (1 << (31 - CellSizeShift)) - 1;
+    const auto cellX = position31.x >> CellSizeShift;
+    const auto cellY = position31.y >> CellSizeShift;
+    const auto maxDistance31 = qMax(Utilities::metersToX31(maxDistance), Utilities::metersToY31(maxDistance)) + _maxEntryExtent31;
+    const auto maxRing = static_cast<int>(qMin<int64_t>(maxDistance31 >> CellSizeShift, maxCell)) + 1;
+
+    auto bestSquareDistance = maxDistance * maxDistance;
+    auto bestEntry = -1;
+    const auto scanCell =
+        [this, maxCell, position31, &bestSquareDistance, &bestEntry, &outNearestPoint31]
+        (const int32_t x, const int32_t y)
+        {
+            if (x < 0 || y < 0 || x > maxCell || y > maxCell)
+                return;
+            const auto key = makeCellKey(x, y);
+            const auto citKey = std::lower_bound(_cellKeys.cbegin(), _cellKeys.cend(), key);
+            if (citKey == _cellKeys.cend() || *citKey != key)
+                return;
+
+            const auto cell = citKey - _cellKeys.cbegin();
+            for (auto entryIdx = _cellFirstEntries[cell], entriesEnd = _cellFirstEntries[cell + 1]; entryIdx < entriesEnd; entryIdx++)
+            {
+                PointI nearestPoint31;
+                const auto squareDistance = squareDistanceToEntry(position31, _entries[entryIdx], nearestPoint31);
+                if (squareDistance < bestSquareDistance)
+                {
+                    bestSquareDistance = squareDistance;
+                    bestEntry = entryIdx;
+                    outNearestPoint31 = nearestPoint31;
+                }
+            }
+        };
+
+    // Rings of cells around cell of position are scanned until any entry of next ring is surely farther
+    // than the best one. Meters per 31-coordinate are smaller along X, so that gives the lower bound
+    for (auto ring = 0; ring <= maxRing; ring++)
+    {
+        if (ring > 0 && bestEntry >= 0)
+        {
+            const auto ringDistance31 = (static_cast<int64_t>(ring - 1) << CellSizeShift) - _maxEntryExtent31;
+            const auto ringDistance = Utilities::x31toMeters(static_cast<int32_t>(ringDistance31));
+            if (ringDistance31 > 0 && ringDistance * ringDistance > bestSquareDistance)
+                break;
+        }
+
+        if (ring == 0)
+        {
+            scanCell(cellX, cellY);
+            continue;
+        }
+        for (auto x = cellX - ring; x <= cellX + ring; x++)
+        {
+            scanCell(x, cellY - ring);
+            scanCell(x, cellY + ring);
+        }
+        for (auto y = cellY - ring + 1; y <= cellY + ring - 1; y++)
+        {
+            scanCell(cellX - ring, y);
+            scanCell(cellX + ring, y);
+        }
+    }
+    if (bestEntry < 0)
+        return false;
+
+    outEntry = bestEntry;
+    outDistance = qSqrt(bestSquareDistance);
+    return true;
+}
+
+void OsmAnd::ReverseGeocoder_P::fillAddress(
+    const int entryIndex,
+    const PointI& nearestPoint31,
+    const double distance,
+    Address& outAddress) const
+{
+    const auto& entry = _entries[entryIndex];
+    const auto& street = _streets[entry.street];
+    const auto& settlement = _settlements[street.settlement];
+
+    outAddress.houseNumber = getString(entry.houseNumber);
+    outAddress.postcode = getString(entry.postcode);
+    outAddress.streetName = getString(street.name);
+    outAddress.streetLatinName = getString(street.latinName);
+    outAddress.settlementName = getString(settlement.name);
+    outAddress.settlementLatinName = getString(settlement.latinName);
+    outAddress.position31 = nearestPoint31;
+    outAddress.distance = distance;
+}
+
+bool OsmAnd::ReverseGeocoder_P::findNearestAddress(
+    const PointI position31,
+    Address& outAddress,
+    const double maxDistance,
+    const IQueryController* const controller) const
+{
+    if (!prepareIndex(controller))
+        return false;
+
+    int entry;
+    PointI nearestPoint31;
+    double distance;
+    if (!findNearestEntry(position31, maxDistance, entry, nearestPoint31, distance))
+        return false;
+
+    fillAddress(entry, nearestPoint31, distance, outAddress);
+    return true;
+}
+
+unsigned int OsmAnd::ReverseGeocoder_P::findNearestAddresses(
+    const QVector<PointI>& positions31,
+    QVector<Address>& outAddresses,
+    const double maxDistance,
+    const IQueryController* const controller) const
+{
+    outAddresses.clear();
+    if (!prepareIndex(controller))
+        return 0;
+
+    unsigned int foundCount = 0;
+    outAddresses.resize(positions31.size());
+    for (auto positionIdx = 0, positionsCount = positions31.size(); positionIdx < positionsCount; positionIdx++)
+    {
+        if (controller && controller->isAborted())
+            break;
+
+        int entry;
+        PointI nearestPoint31;
+        double distance;
+        if (!findNearestEntry(positions31[positionIdx], maxDistance, entry, nearestPoint31, distance))
+            continue;
+
+        fillAddress(entry, nearestPoint31, distance, outAddresses[positionIdx]);
+        foundCount++;
+    }
+
+    return foundCount;
+}
@@ -0,0 +1,137 @@
+#ifndef _OSMAND_CORE_REVERSE_GEOCODER_P_H_
+#define _OSMAND_CORE_REVERSE_GEOCODER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "ReverseGeocoder.h"
+
+namespace OsmAnd
+{
+    class ReverseGeocoder;
+    class ReverseGeocoder_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(ReverseGeocoder_P);
+
+    public:
+        typedef ReverseGeocoder::Address Address;
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t signature;
+            uint32_t version;
+            uint32_t stringsCount;
+            uint32_t stringsDataSize;
+            uint32_t settlementsCount;
+            uint32_t streetsCount;
+            uint32_t entriesCount;
+            uint32_t cellsCount;
+            int32_t maxEntryExtent31;
+            uint8_t sourceSignature[16];
+        };
+
+        struct Settlement
+        {
+            uint32_t name;
+            uint32_t latinName;
+        };
+
+        struct Street
+        {
+            uint32_t name;
+            uint32_t latinName;
+            uint32_t settlement;
+        };
+
+        // Building or street point has equal start and end, interpolated buildings span a segment
+        struct Entry
+        {
+            PointI start31;
+            PointI end31;
+            uint32_t street;
+            uint32_t houseNumber;
+            uint32_t postcode;
+        };
+#pragma pack(pop)
+
+        static const uint32_t Signature;
+        static const uint32_t Version;
+        static const uint32_t NoString;
+        // Cells of 2^15 31-coordinates are about 600 meters wide at equator
+        static const int CellSizeShift;
+
+    private:
+        // Index is prepared lazily by first query, and never changes after that
+        mutable QMutex _indexMutex;
+        mutable QAtomicInt _isIndexPrepared;
+
+        mutable QByteArray _stringsData;
+        // String N is [_stringsOffsets[N]; _stringsOffsets[N + 1])
+        mutable QVector<uint32_t> _stringsOffsets;
+        mutable QVector<Settlement> _settlements;
+        mutable QVector<Street> _streets;
+        mutable QVector<Entry> _entries;
+        // Entries of cell N are [_cellFirstEntries[N]; _cellFirstEntries[N + 1]), cells are sorted by key
+        mutable QVector<uint64_t> _cellKeys;
+        mutable QVector<uint32_t> _cellFirstEntries;
+        // Largest distance from start of entry to its end along either axis, so that segments starting in
+        // other cells are not missed
+        mutable int32_t _maxEntryExtent31;
+
+        static uint64_t makeCellKey(const int32_t cellX, const int32_t cellY);
+        static double squareDistanceToEntry(const PointI& position31, const Entry& entry, PointI& outNearestPoint31);
+
+        QString getString(const uint32_t index) const;
+        void clear() const;
+        uint32_t addString(const QString& value, QHash<QString, uint32_t>& stringsIndices) const;
+        bool build(const IQueryController* const controller) const;
+        void buildGrid() const;
+        bool load() const;
+        bool save() const;
+        bool findNearestEntry(
+            const PointI& position31,
+            const double maxDistance,
+            int& outEntry,
+            PointI& outNearestPoint31,
+            double& outDistance) const;
+        void fillAddress(const int entryIndex, const PointI& nearestPoint31, const double distance, Address& outAddress) const;
+    protected:
+        ReverseGeocoder_P(ReverseGeocoder* const owner);
+    public:
+        ~ReverseGeocoder_P();
+
+        ImplementationInterface<ReverseGeocoder> owner;
+
+        bool prepareIndex(const IQueryController* const controller) const;
+        bool isIndexPrepared() const;
+        int getEntriesCount() const;
+
+        bool findNearestAddress(
+            const PointI position31,
+            Address& outAddress,
+            const double maxDistance,
+            const IQueryController* const controller) const;
+        unsigned int findNearestAddresses(
+            const QVector<PointI>& positions31,
+            QVector<Address>& outAddresses,
+            const double maxDistance,
+            const IQueryController* const controller) const;
+
+    friend class OsmAnd::ReverseGeocoder;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_REVERSE_GEOCODER_P_H_)
@@ -0,0 +1,193 @@
+#include "RoadBlockGraph.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+
+#include "IRoadCostModel.h"
+#include "Utilities.h"
+
+OsmAnd::RoadBlockGraph::RoadBlockGraph(
+    const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& block,
+    const std::shared_ptr<const IRoadCostModel>& costModel)
+    : blockId(block->id)
+{
+    // Cost model is queried here once per road, graphs that load the block only copy evaluated edges
+    const auto& roads = block->roads;
+    auto pointsCount = 0;
+    for (auto roadIdx = 0, roadsCount = roads.size(); roadIdx < roadsCount; roadIdx++)
+    {
+        const auto& road = roads[roadIdx];
+        if (road->points31.size() < 2 || !costModel->acceptsRoad(road))
+            continue;
+        const auto speed = costModel->getSpeed(road);
+        if (speed <= 0.0f)
+            continue;
+
+        _roadBlockIndices.push_back(roadIdx);
+        _roadSpeeds.push_back(speed);
+        _roadDirections.push_back(costModel->getDirection(road));
+        pointsCount += road->points31.size();
+    }
+
+    // Every road point is a node, points shared by roads are merged
+    _nodePositionKeys.reserve(pointsCount);
+    for (const auto roadBlockIndex : constOf(_roadBlockIndices))
+    {
+        for (const auto& point31 : constOf(roads[roadBlockIndex]->points31))
+            _nodePositionKeys.push_back(makePositionKey(point31));
+    }
+    std::sort(_nodePositionKeys.begin(), _nodePositionKeys.end());
+    _nodePositionKeys.erase(std::unique(_nodePositionKeys.begin(), _nodePositionKeys.end()), _nodePositionKeys.end());
+    _nodePositionKeys.squeeze();
+    _nodePositions.resize(_nodePositionKeys.size());
+    for (auto node = 0, nodesCount = _nodePositionKeys.size(); node < nodesCount; node++)
+    {
+        const auto key = _nodePositionKeys[node];
+        _nodePositions[node] = PointI(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFFu));
+    }
+
+    // Edges are collected with their sources and then placed into rows of their sources by counting sort
+    QVector<uint32_t> edgeSources;
+    QVector<Edge> edges;
+    edgeSources.reserve(pointsCount * 2);
+    edges.reserve(pointsCount * 2);
+    for (auto road = 0, roadsCount = _roadBlockIndices.size(); road < roadsCount; road++)
+    {
+        const auto& blockRoad = roads[_roadBlockIndices[road]];
+        const auto& points31 = blockRoad->points31;
+        const auto speed = _roadSpeeds[road];
+        const auto direction = _roadDirections[road];
+        const auto forwardAllowed = (direction != RoadDirection::OneWayReverse);
+        const auto backwardAllowed = (direction != RoadDirection::OneWayForward);
+
+        auto previousNode = findNode(points31[0]);
+        for (auto pointIdx = 1, roadPointsCount = points31.size(); pointIdx < roadPointsCount; pointIdx++)
+        {
+            const auto node = findNode(points31[pointIdx]);
+            if (node == previousNode)
+                continue;
+
+            const auto length = static_cast<float>(Utilities::distance31(
+                points31[pointIdx - 1].x, points31[pointIdx - 1].y,
+                points31[pointIdx].x, points31[pointIdx].y));
+            const auto time = length / speed;
+
+            Edge edge;
+            edge.length = length;
+            edge.road = road;
+            if (forwardAllowed)
+            {
+                edge.target = node;
+                edge.time = time + costModel->getPointPenalty(blockRoad, pointIdx);
+                edge.sourcePointIndex = pointIdx - 1;
+                edge.targetPointIndex = pointIdx;
+                edgeSources.push_back(previousNode);
+                edges.push_back(edge);
+            }
+            if (backwardAllowed)
+            {
+                edge.target = previousNode;
+                edge.time = time + costModel->getPointPenalty(blockRoad, pointIdx - 1);
+                edge.sourcePointIndex = pointIdx;
+                edge.targetPointIndex = pointIdx - 1;
+                edgeSources.push_back(node);
+                edges.push_back(edge);
+            }
+
+            previousNode = node;
+        }
+    }
+
+    const auto nodesCount = _nodePositions.size();
+    const auto edgesCount = edges.size();
+    _firstEdges.resize(nodesCount + 1);
+    std::fill(_firstEdges.begin(), _firstEdges.end(), 0u);
+    for (const auto source : constOf(edgeSources))
+        _firstEdges[source + 1]++;
+    for (auto node = 0; node < nodesCount; node++)
+        _firstEdges[node + 1] += _firstEdges[node];
+
+    QVector<uint32_t> nextEdges(_firstEdges.mid(0, nodesCount));
+    _edges.resize(edgesCount);
+    for (auto edgeIdx = 0; edgeIdx < edgesCount; edgeIdx++)
+        _edges[nextEdges[edgeSources[edgeIdx]]++] = edges[edgeIdx];
+}
+
+OsmAnd::RoadBlockGraph::~RoadBlockGraph()
+{
+}
+
+uint64_t OsmAnd::RoadBlockGraph::makePositionKey(const PointI& position31)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(position31.x)) << 32) | static_cast<uint32_t>(position31.y);
+}
+
+int OsmAnd::RoadBlockGraph::getNodesCount() const
+{
+    return _nodePositions.size();
+}
+
+int OsmAnd::RoadBlockGraph::getEdgesCount() const
+{
+    return _edges.size();
+}
+
+int OsmAnd::RoadBlockGraph::getRoadsCount() const
+{
+    return _roadBlockIndices.size();
+}
+
+int OsmAnd::RoadBlockGraph::findNode(const PointI& position31) const
+{
+    const auto key = makePositionKey(position31);
+    const auto citKey = std::lower_bound(_nodePositionKeys.cbegin(), _nodePositionKeys.cend(), key);
+    if (citKey == _nodePositionKeys.cend() || *citKey != key)
+        return -1;
+
+    return static_cast<int>(citKey - _nodePositionKeys.cbegin());
+}
+
+const OsmAnd::PointI& OsmAnd::RoadBlockGraph::getNodePosition(const int node) const
+{
+    return _nodePositions[node];
+}
+
+int OsmAnd::RoadBlockGraph::getEdgesBegin(const int node) const
+{
+    return _firstEdges[node];
+}
+
+int OsmAnd::RoadBlockGraph::getEdgesEnd(const int node) const
+{
+    return _firstEdges[node + 1];
+}
+
+const OsmAnd::RoadBlockGraph::Edge& OsmAnd::RoadBlockGraph::getEdge(const int edge) const
+{
+    return _edges[edge];
+}
+
+int OsmAnd::RoadBlockGraph::getRoadBlockIndex(const int road) const
+{
+    return _roadBlockIndices[road];
+}
+
+float OsmAnd::RoadBlockGraph::getRoadSpeed(const int road) const
+{
+    return _roadSpeeds[road];
+}
+
+OsmAnd::RoadDirection OsmAnd::RoadBlockGraph::getRoadDirection(const int road) const
+{
+    return _roadDirections[road];
+}
+
+size_t OsmAnd::RoadBlockGraph::getMemoryUsage() const
+{
+    return
+        static_cast<size_t>(_nodePositionKeys.capacity()) * sizeof(uint64_t) +
+        static_cast<size_t>(_nodePositions.capacity()) * sizeof(PointI) +
+        static_cast<size_t>(_firstEdges.capacity()) * sizeof(uint32_t) +
+        static_cast<size_t>(_edges.capacity()) * sizeof(Edge) +
+        static_cast<size_t>(_roadBlockIndices.capacity()) * (sizeof(uint32_t) + sizeof(float) + sizeof(RoadDirection));
+}
@@ -0,0 +1,83 @@
+#ifndef _OSMAND_CORE_ROAD_BLOCK_GRAPH_H_
+#define _OSMAND_CORE_ROAD_BLOCK_GRAPH_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "ObfRoutingSectionReader.h"
+#include "Road.h"
+
+namespace OsmAnd
+{
+    class IRoadCostModel;
+
+    // Routing graph of a single roads data block, evaluated for a single cost model. Unlike roads, that keep
+    // hashes and vectors per object, everything is packed into flat arrays: node positions sorted by position,
+    // outgoing edges of all nodes in compressed sparse row layout, and attributes of roads accepted by cost
+    // model together with references back to roads of the block. Block graph never changes once built, and
+    // stays valid for the same block read again, since roads are referenced by their order in the block.
+    // Turn restrictions are not copied: they reference target roads by id, so they are read from roads.
+    class RoadBlockGraph Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadBlockGraph);
+
+    public:
+        struct Edge
+        {
+            uint32_t target;
+            float time;
+            float length;
+            // Index of road in block graph, and indices of road points edge goes between
+            uint32_t road;
+            uint32_t sourcePointIndex;
+            uint32_t targetPointIndex;
+        };
+
+    private:
+        // Sorted by position key, so that node is found by binary search
+        QVector<uint64_t> _nodePositionKeys;
+        QVector<PointI> _nodePositions;
+        // Outgoing edges of node N are [_firstEdges[N]; _firstEdges[N + 1])
+        QVector<uint32_t> _firstEdges;
+        QVector<Edge> _edges;
+
+        QVector<uint32_t> _roadBlockIndices;
+        QVector<float> _roadSpeeds;
+        QVector<RoadDirection> _roadDirections;
+
+        static uint64_t makePositionKey(const PointI& position31);
+    protected:
+    public:
+        RoadBlockGraph(
+            const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& block,
+            const std::shared_ptr<const IRoadCostModel>& costModel);
+        ~RoadBlockGraph();
+
+        const ObfRoutingSectionReader::DataBlockId blockId;
+
+        int getNodesCount() const;
+        int getEdgesCount() const;
+        int getRoadsCount() const;
+
+        int findNode(const PointI& position31) const;
+        const PointI& getNodePosition(const int node) const;
+        int getEdgesBegin(const int node) const;
+        int getEdgesEnd(const int node) const;
+        const Edge& getEdge(const int edge) const;
+
+        // Index of road in roads of the block
+        int getRoadBlockIndex(const int road) const;
+        float getRoadSpeed(const int road) const;
+        RoadDirection getRoadDirection(const int road) const;
+
+        size_t getMemoryUsage() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_BLOCK_GRAPH_H_)
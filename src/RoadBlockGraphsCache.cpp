@@ -0,0 +1,108 @@
+#include "RoadBlockGraphsCache.h"
+
+#include "RoadBlockGraph.h"
+
+const size_t OsmAnd::RoadBlockGraphsCache::DefaultMemoryLimit = 64 * 1024 * 1024;
+
+OsmAnd::RoadBlockGraphsCache::RoadBlockGraphsCache(
+    const std::shared_ptr<const IRoadCostModel>& costModel_,
+    const size_t memoryLimit_ /*= DefaultMemoryLimit*/)
+    : _tick(0)
+    , _memoryUsage(0)
+    , _builtCount(0)
+    , _reusedCount(0)
+    , costModel(costModel_)
+    , memoryLimit(memoryLimit_)
+{
+}
+
+OsmAnd::RoadBlockGraphsCache::~RoadBlockGraphsCache()
+{
+}
+
+void OsmAnd::RoadBlockGraphsCache::evictLeastRecentlyUsed()
+{
+    auto itLeastRecentlyUsedEntry = _entries.end();
+    for (auto itEntry = _entries.begin(); itEntry != _entries.end(); ++itEntry)
+    {
+        if (itLeastRecentlyUsedEntry == _entries.end() || itEntry->lastUseTick < itLeastRecentlyUsedEntry->lastUseTick)
+            itLeastRecentlyUsedEntry = itEntry;
+    }
+    if (itLeastRecentlyUsedEntry == _entries.end())
+        return;
+
+    // Graphs that still use evicted block graph keep it alive
+    _memoryUsage -= itLeastRecentlyUsedEntry->blockGraph->getMemoryUsage();
+    _entries.erase(itLeastRecentlyUsedEntry);
+}
+
+std::shared_ptr<const OsmAnd::RoadBlockGraph> OsmAnd::RoadBlockGraphsCache::obtain(
+    const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& block)
+{
+    {
+        QMutexLocker scopedLocker(&_entriesMutex);
+
+        const auto itEntry = _entries.find(block->id);
+        if (itEntry != _entries.end())
+        {
+            itEntry->lastUseTick = ++_tick;
+            _reusedCount++;
+            return itEntry->blockGraph;
+        }
+    }
+
+    // Graph is built outside of lock, so that threads loading different blocks don't wait for each other
+    const std::shared_ptr<const RoadBlockGraph> blockGraph(new RoadBlockGraph(block, costModel));
+
+    {
+        QMutexLocker scopedLocker(&_entriesMutex);
+
+        // Same block may have been built by another thread meanwhile
+        const auto itEntry = _entries.find(block->id);
+        if (itEntry != _entries.end())
+        {
+            itEntry->lastUseTick = ++_tick;
+            return itEntry->blockGraph;
+        }
+
+        Entry entry;
+        entry.blockGraph = blockGraph;
+        entry.lastUseTick = ++_tick;
+        _entries.insert(block->id, entry);
+        _memoryUsage += blockGraph->getMemoryUsage();
+        _builtCount++;
+
+        while (_memoryUsage > memoryLimit && _entries.size() > 1)
+            evictLeastRecentlyUsed();
+    }
+
+    return blockGraph;
+}
+
+int OsmAnd::RoadBlockGraphsCache::getBlockGraphsCount() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    return _entries.size();
+}
+
+size_t OsmAnd::RoadBlockGraphsCache::getMemoryUsage() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    return _memoryUsage;
+}
+
+unsigned int OsmAnd::RoadBlockGraphsCache::getBuiltCount() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    return _builtCount;
+}
+
+unsigned int OsmAnd::RoadBlockGraphsCache::getReusedCount() const
+{
+    QMutexLocker scopedLocker(&_entriesMutex);
+
+    return _reusedCount;
+}
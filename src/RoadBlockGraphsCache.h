@@ -0,0 +1,65 @@
+#ifndef _OSMAND_CORE_ROAD_BLOCK_GRAPHS_CACHE_H_
+#define _OSMAND_CORE_ROAD_BLOCK_GRAPHS_CACHE_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "ObfRoutingSectionReader.h"
+
+namespace OsmAnd
+{
+    class IRoadCostModel;
+    class RoadBlockGraph;
+
+    // Graphs of roads data blocks built for a single cost model and shared by all routing graphs of its owner.
+    // Graph is keyed by block id, so it stays valid when block is evicted from blocks cache and read again.
+    // Least recently used graphs are dropped once their total size exceeds memory limit.
+    class RoadBlockGraphsCache Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadBlockGraphsCache);
+
+    public:
+        static const size_t DefaultMemoryLimit;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const RoadBlockGraph> blockGraph;
+            uint64_t lastUseTick;
+        };
+
+        mutable QMutex _entriesMutex;
+        QHash<uint64_t, Entry> _entries;
+        uint64_t _tick;
+        size_t _memoryUsage;
+        unsigned int _builtCount;
+        unsigned int _reusedCount;
+
+        void evictLeastRecentlyUsed();
+    protected:
+    public:
+        RoadBlockGraphsCache(
+            const std::shared_ptr<const IRoadCostModel>& costModel,
+            const size_t memoryLimit = DefaultMemoryLimit);
+        ~RoadBlockGraphsCache();
+
+        const std::shared_ptr<const IRoadCostModel> costModel;
+        const size_t memoryLimit;
+
+        std::shared_ptr<const RoadBlockGraph> obtain(const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& block);
+
+        int getBlockGraphsCount() const;
+        size_t getMemoryUsage() const;
+        unsigned int getBuiltCount() const;
+        unsigned int getReusedCount() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_BLOCK_GRAPHS_CACHE_H_)
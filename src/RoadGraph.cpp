@@ -0,0 +1,570 @@
+#include "RoadGraph.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+
+#include "Road.h"
+#include "IObfsCollection.h"
+#include "ObfDataInterface.h"
+#include "IRoadCostModel.h"
+#include "IQueryController.h"
+#include "RoadLocator.h"
+#include "RoadBlockGraph.h"
+#include "RoadBlockGraphsCache.h"
+#include "Utilities.h"
+
+const OsmAnd::ZoomLevel OsmAnd::RoadGraph::TileZoom = OsmAnd::ZoomLevel13;
+
+OsmAnd::RoadGraph::RoadGraph(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection_,
+    const std::shared_ptr<const IRoadCostModel>& costModel_,
+    ObfRoutingSectionReader::DataBlocksCache* const cache_,
+    RoadBlockGraphsCache* const blockGraphsCache_ /*= nullptr*/,
+    const RoutingDataLevel dataLevel_ /*= RoutingDataLevel::Detailed*/)
+    : _obfsCollection(obfsCollection_)
+    , _costModel(costModel_)
+    , _cache(cache_)
+    , _blockGraphsCache(cache_ && blockGraphsCache_ && blockGraphsCache_->costModel == costModel_ ? blockGraphsCache_ : nullptr)
+    , _restrictionsAware(costModel_->isRestrictionsAware())
+    , _allLoaded(false)
+    , dataLevel(dataLevel_)
+{
+}
+
+OsmAnd::RoadGraph::~RoadGraph()
+{
+    for (const auto& block : constOf(_loadedBlocks))
+        releaseBlock(block);
+}
+
+uint64_t OsmAnd::RoadGraph::makePositionKey(const PointI& position31)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(position31.x)) << 32) | static_cast<uint32_t>(position31.y);
+}
+
+int OsmAnd::RoadGraph::obtainNode(const PointI& position31)
+{
+    const auto key = makePositionKey(position31);
+    const auto citNode = _nodesByPosition.constFind(key);
+    if (citNode != _nodesByPosition.cend())
+        return *citNode;
+
+    const auto node = _nodePositions.size();
+    _nodesByPosition.insert(key, node);
+    _nodePositions.push_back(position31);
+    _firstOutgoingEdges.push_back(-1);
+    _firstIncomingEdges.push_back(-1);
+    _nodesComplete.push_back(false);
+    return node;
+}
+
+int OsmAnd::RoadGraph::findSegmentEdge(const int source, const int target, const int road, const int pointIndex) const
+{
+    // Edges are identified by road point they start from, since the same road may pass through the same nodes twice
+    for (auto edgeIdx = _firstOutgoingEdges[source]; edgeIdx >= 0; edgeIdx = _edges[edgeIdx].nextOutgoing)
+    {
+        const auto& edge = _edges[edgeIdx];
+        if (edge.target == target && edge.road == road && edge.sourcePointIndex == pointIndex)
+            return edgeIdx;
+    }
+
+    return -1;
+}
+
+void OsmAnd::RoadGraph::addEdge(
+    const int source,
+    const int target,
+    const float time,
+    const float length,
+    const int road,
+    const int sourcePointIndex,
+    const int targetPointIndex)
+{
+    Edge edge;
+    edge.source = source;
+    edge.target = target;
+    edge.time = time;
+    edge.length = length;
+    edge.nextOutgoing = _firstOutgoingEdges[source];
+    edge.nextIncoming = _firstIncomingEdges[target];
+    edge.road = road;
+    edge.sourcePointIndex = sourcePointIndex;
+    edge.targetPointIndex = targetPointIndex;
+
+    const auto edgeIndex = _edges.size();
+    _edges.push_back(edge);
+    _firstOutgoingEdges[source] = edgeIndex;
+    _firstIncomingEdges[target] = edgeIndex;
+}
+
+void OsmAnd::RoadGraph::addRoad(const std::shared_ptr<const Road>& road)
+{
+    if (_roadsIndicesById.contains(road->id))
+        return;
+
+    const auto& points31 = road->points31;
+    if (points31.size() < 2 || !_costModel->acceptsRoad(road))
+    {
+        _roadsIndicesById.insert(road->id, -1);
+        return;
+    }
+    const auto speed = _costModel->getSpeed(road);
+    if (speed <= 0.0f)
+    {
+        _roadsIndicesById.insert(road->id, -1);
+        return;
+    }
+
+    const auto roadIndex = _roads.size();
+    _roadsIndicesById.insert(road->id, roadIndex);
+    _roads.push_back(road);
+    _roadSpeeds.push_back(speed);
+    const auto direction = _costModel->getDirection(road);
+    _roadDirections.push_back(direction);
+
+    const auto forwardAllowed = (direction != RoadDirection::OneWayReverse);
+    const auto backwardAllowed = (direction != RoadDirection::OneWayForward);
+
+    auto previousNode = obtainNode(points31[0]);
+    for (auto pointIdx = 1, pointsCount = points31.size(); pointIdx < pointsCount; pointIdx++)
+    {
+        const auto node = obtainNode(points31[pointIdx]);
+        if (node == previousNode)
+            continue;
+
+        const auto length = static_cast<float>(Utilities::distance31(
+            points31[pointIdx - 1].x, points31[pointIdx - 1].y,
+            points31[pointIdx].x, points31[pointIdx].y));
+        const auto time = length / speed;
+        if (forwardAllowed)
+        {
+            addEdge(previousNode, node, time + _costModel->getPointPenalty(road, pointIdx),
+                length, roadIndex, pointIdx - 1, pointIdx);
+        }
+        if (backwardAllowed)
+        {
+            addEdge(node, previousNode, time + _costModel->getPointPenalty(road, pointIdx - 1),
+                length, roadIndex, pointIdx, pointIdx - 1);
+        }
+
+        previousNode = node;
+    }
+}
+
+void OsmAnd::RoadGraph::addBlockGraph(
+    const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& block,
+    const std::shared_ptr<const RoadBlockGraph>& blockGraph)
+{
+    // Road of the block may have been already added from plain roads list, then its edges are skipped
+    const auto blockRoadsCount = blockGraph->getRoadsCount();
+    QVector<int> roadIndices(blockRoadsCount);
+    for (auto blockRoad = 0; blockRoad < blockRoadsCount; blockRoad++)
+    {
+        const auto& road = block->roads[blockGraph->getRoadBlockIndex(blockRoad)];
+        if (_roadsIndicesById.contains(road->id))
+        {
+            roadIndices[blockRoad] = -1;
+            continue;
+        }
+
+        const auto roadIndex = _roads.size();
+        roadIndices[blockRoad] = roadIndex;
+        _roadsIndicesById.insert(road->id, roadIndex);
+        _roads.push_back(road);
+        _roadSpeeds.push_back(blockGraph->getRoadSpeed(blockRoad));
+        _roadDirections.push_back(blockGraph->getRoadDirection(blockRoad));
+    }
+
+    // Roads rejected by cost model are remembered too, so that they are not evaluated again
+    for (const auto& road : constOf(block->roads))
+    {
+        if (!_roadsIndicesById.contains(road->id))
+            _roadsIndicesById.insert(road->id, -1);
+    }
+
+    const auto blockNodesCount = blockGraph->getNodesCount();
+    QVector<int> nodes(blockNodesCount);
+    for (auto blockNode = 0; blockNode < blockNodesCount; blockNode++)
+        nodes[blockNode] = obtainNode(blockGraph->getNodePosition(blockNode));
+
+    for (auto blockNode = 0; blockNode < blockNodesCount; blockNode++)
+    {
+        for (auto edgeIdx = blockGraph->getEdgesBegin(blockNode), edgesEnd = blockGraph->getEdgesEnd(blockNode); edgeIdx < edgesEnd; edgeIdx++)
+        {
+            const auto& edge = blockGraph->getEdge(edgeIdx);
+            const auto roadIndex = roadIndices[edge.road];
+            if (roadIndex < 0)
+                continue;
+
+            addEdge(nodes[blockNode], nodes[edge.target], edge.time, edge.length, roadIndex, edge.sourcePointIndex, edge.targetPointIndex);
+        }
+    }
+
+    _blockGraphs.push_back(blockGraph);
+}
+
+void OsmAnd::RoadGraph::releaseBlock(std::shared_ptr<const ObfRoutingSectionReader::DataBlock> block)
+{
+    _cache->releaseReference(block->id, block);
+}
+
+bool OsmAnd::RoadGraph::loadTile(const PointI& position31, const IQueryController* const controller /*= nullptr*/)
+{
+    const auto zoomShift = ZoomLevel31 - TileZoom;
+    const auto tileId = TileId::fromXY(position31.x >> zoomShift, position31.y >> zoomShift);
+    if (_allLoaded || _loadedTiles.contains(tileId.id))
+        return false;
+
+    // Roads are shared with other graphs through blocks cache, so repeated queries in the same area
+    // don't read data again
+    const auto tileBBox31 = Utilities::tileBoundingBox31(tileId, TileZoom);
+    QList< std::shared_ptr<const Road> > roads;
+    QList< std::shared_ptr<const ObfRoutingSectionReader::DataBlock> > referencedBlocks;
+    const auto obfDataInterface = _obfsCollection->obtainDataInterface(tileBBox31);
+    obfDataInterface->loadRoads(
+        dataLevel,
+        &tileBBox31,
+        &roads,
+        nullptr,
+        nullptr,
+        _cache,
+        _blockGraphsCache ? &referencedBlocks : nullptr,
+        controller,
+        nullptr);
+    if (controller && controller->isAborted())
+    {
+        for (const auto& block : constOf(referencedBlocks))
+            releaseBlock(block);
+        return false;
+    }
+
+    // Every block is added once as a whole, while graph keeps single reference to it
+    for (const auto& block : constOf(referencedBlocks))
+    {
+        if (_loadedBlocks.contains(block->id))
+        {
+            releaseBlock(block);
+            continue;
+        }
+
+        _loadedBlocks.insert(block->id, block);
+        addBlockGraph(block, _blockGraphsCache->obtain(block));
+    }
+
+    // Roads of blocks that were not cached are added one by one
+    _loadedTiles.insert(tileId.id);
+    for (const auto& road : constOf(roads))
+        addRoad(road);
+
+    return true;
+}
+
+bool OsmAnd::RoadGraph::loadAll(const IQueryController* const controller /*= nullptr*/)
+{
+    if (_allLoaded)
+        return false;
+
+    const auto obfDataInterface = _obfsCollection->obtainDataInterface();
+    const auto loaded = obfDataInterface->loadRoads(
+        dataLevel,
+        nullptr,
+        nullptr,
+        nullptr,
+        [this]
+        (const std::shared_ptr<const OsmAnd::Road>& road) -> bool
+        {
+            addRoad(road);
+            return false;
+        },
+        _cache,
+        nullptr,
+        controller,
+        nullptr);
+    if (!loaded || (controller && controller->isAborted()))
+        return false;
+
+    _allLoaded = true;
+    std::fill(_nodesComplete.begin(), _nodesComplete.end(), true);
+
+    return true;
+}
+
+bool OsmAnd::RoadGraph::loadArea(const AreaI& area31, const IQueryController* const controller /*= nullptr*/)
+{
+    const auto zoomShift = ZoomLevel31 - TileZoom;
+    const auto tileSize31 = 1 << zoomShift;
+
+    bool changed = false;
+    for (auto y31 = area31.top() >> zoomShift; y31 <= (area31.bottom() >> zoomShift); y31++)
+    {
+        for (auto x31 = area31.left() >> zoomShift; x31 <= (area31.right() >> zoomShift); x31++)
+        {
+            if (controller && controller->isAborted())
+                return changed;
+
+            if (loadTile(PointI(x31 * tileSize31, y31 * tileSize31), controller))
+                changed = true;
+        }
+    }
+
+    return changed;
+}
+
+bool OsmAnd::RoadGraph::attach(
+    const PointI& position31,
+    const double radiusInMeters,
+    Attachment& outAttachment,
+    const IQueryController* const controller /*= nullptr*/)
+{
+    const auto bbox31 = (AreaI)Utilities::boundingBox31FromAreaInMeters(radiusInMeters, position31);
+    loadArea(bbox31, controller);
+    if (controller && controller->isAborted())
+        return false;
+
+    // Only roads near the position are checked, they are taken from blocks cache
+    QList< std::shared_ptr<const Road> > roadsInBBox;
+    const auto obfDataInterface = _obfsCollection->obtainDataInterface(bbox31);
+    obfDataInterface->loadRoads(
+        dataLevel,
+        &bbox31,
+        nullptr,
+        nullptr,
+        [this, &roadsInBBox]
+        (const std::shared_ptr<const OsmAnd::Road>& road) -> bool
+        {
+            if (getRoadIndex(road) >= 0)
+                roadsInBBox.push_back(road);
+            return false;
+        },
+        _cache,
+        nullptr,
+        controller,
+        nullptr);
+
+    int endPointIndex = -1;
+    double distance = 0.0;
+    const auto road = RoadLocator::findNearestRoad(roadsInBBox, position31, radiusInMeters, &endPointIndex, &distance);
+    if (!road)
+        return false;
+    const auto roadIndex = getRoadIndex(road);
+
+    // Segment between duplicated points has no edges, so the nearest segment between distinct points is taken
+    const auto& points31 = road->points31;
+    auto startPointIndex = endPointIndex - 1;
+    while (startPointIndex > 0 && points31[startPointIndex] == points31[startPointIndex + 1])
+        startPointIndex--;
+    while (startPointIndex + 2 < points31.size() && points31[startPointIndex] == points31[startPointIndex + 1])
+        startPointIndex++;
+    if (points31[startPointIndex] == points31[startPointIndex + 1])
+        return false;
+    endPointIndex = startPointIndex + 1;
+    const auto& start31 = points31[startPointIndex];
+    const auto& end31 = points31[endPointIndex];
+    const auto segmentSquareLength = Utilities::squareDistance31(start31, end31);
+    auto factor = segmentSquareLength > 0.0
+        ? Utilities::projection31(start31.x, start31.y, end31.x, end31.y, position31.x, position31.y) / segmentSquareLength
+        : 0.0;
+    factor = qBound(0.0, factor, 1.0);
+
+    outAttachment.position31 = PointI(
+        start31.x + static_cast<int32_t>((static_cast<int64_t>(end31.x) - start31.x) * factor),
+        start31.y + static_cast<int32_t>((static_cast<int64_t>(end31.y) - start31.y) * factor));
+    outAttachment.distance = distance;
+    outAttachment.road = roadIndex;
+    outAttachment.startPointIndex = startPointIndex;
+    outAttachment.endPointIndex = endPointIndex;
+    outAttachment.startNode = findNode(start31);
+    outAttachment.endNode = findNode(end31);
+
+    const auto speed = _roadSpeeds[roadIndex];
+    const auto direction = _roadDirections[roadIndex];
+    const auto timeToStart = static_cast<float>(Utilities::distance31(
+        outAttachment.position31.x, outAttachment.position31.y, start31.x, start31.y)) / speed;
+    const auto timeToEnd = static_cast<float>(Utilities::distance31(
+        outAttachment.position31.x, outAttachment.position31.y, end31.x, end31.y)) / speed;
+    const auto forwardAllowed = (direction != RoadDirection::OneWayReverse);
+    const auto backwardAllowed = (direction != RoadDirection::OneWayForward);
+    outAttachment.timeToStart = backwardAllowed ? timeToStart : -1.0f;
+    outAttachment.timeToEnd = forwardAllowed ? timeToEnd : -1.0f;
+    outAttachment.timeFromStart = forwardAllowed ? timeToStart : -1.0f;
+    outAttachment.timeFromEnd = backwardAllowed ? timeToEnd : -1.0f;
+    outAttachment.forwardEdge = forwardAllowed
+        ? findSegmentEdge(outAttachment.startNode, outAttachment.endNode, roadIndex, startPointIndex)
+        : -1;
+    outAttachment.backwardEdge = backwardAllowed
+        ? findSegmentEdge(outAttachment.endNode, outAttachment.startNode, roadIndex, endPointIndex)
+        : -1;
+
+    return true;
+}
+
+bool OsmAnd::RoadGraph::completeNode(const int node, const IQueryController* const controller /*= nullptr*/)
+{
+    if (_nodesComplete[node])
+        return false;
+
+    // All roads that pass through the node are in the tile that contains the node
+    const auto changed = loadTile(_nodePositions[node], controller);
+    if (controller && controller->isAborted())
+        return changed;
+    _nodesComplete[node] = true;
+
+    return changed;
+}
+
+int OsmAnd::RoadGraph::getNodesCount() const
+{
+    return _nodePositions.size();
+}
+
+int OsmAnd::RoadGraph::getEdgesCount() const
+{
+    return _edges.size();
+}
+
+int OsmAnd::RoadGraph::findNode(const PointI& position31) const
+{
+    return _nodesByPosition.value(makePositionKey(position31), -1);
+}
+
+const OsmAnd::PointI& OsmAnd::RoadGraph::getNodePosition(const int node) const
+{
+    return _nodePositions[node];
+}
+
+int OsmAnd::RoadGraph::getFirstOutgoingEdge(const int node) const
+{
+    return _firstOutgoingEdges[node];
+}
+
+int OsmAnd::RoadGraph::getFirstIncomingEdge(const int node) const
+{
+    return _firstIncomingEdges[node];
+}
+
+const OsmAnd::RoadGraph::Edge& OsmAnd::RoadGraph::getEdge(const int edge) const
+{
+    return _edges[edge];
+}
+
+bool OsmAnd::RoadGraph::isTurnAllowed(const int fromEdge, const int toEdge) const
+{
+    if (!_restrictionsAware)
+        return true;
+
+    // Restrictions are kept by the road they start from, and going on along the same road is never restricted
+    const auto& from = _edges[fromEdge];
+    const auto& to = _edges[toEdge];
+    if (from.road == to.road)
+        return true;
+    const auto& restrictions = _roads[from.road]->restrictions;
+    if (restrictions.isEmpty())
+        return true;
+
+    const auto citRestriction = restrictions.constFind(_roads[to.road]->id);
+    if (citRestriction != restrictions.cend())
+    {
+        switch (*citRestriction)
+        {
+            case RoadRestriction::NoRightTurn:
+            case RoadRestriction::NoLeftTurn:
+            case RoadRestriction::NoUTurn:
+            case RoadRestriction::NoStraightOn:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    // Mandatory turn forbids all other ones, but only at the junction where its road is
+    for (auto itRestriction = restrictions.cbegin(); itRestriction != restrictions.cend(); ++itRestriction)
+    {
+        const auto restriction = itRestriction.value();
+        if (restriction != RoadRestriction::OnlyRightTurn &&
+            restriction != RoadRestriction::OnlyLeftTurn &&
+            restriction != RoadRestriction::OnlyStraightOn)
+        {
+            continue;
+        }
+
+        const auto onlyRoad = _roadsIndicesById.value(itRestriction.key(), -1);
+        if (onlyRoad < 0)
+            continue;
+        for (auto edgeIdx = _firstOutgoingEdges[from.target]; edgeIdx >= 0; edgeIdx = _edges[edgeIdx].nextOutgoing)
+        {
+            if (_edges[edgeIdx].road == onlyRoad)
+                return false;
+        }
+        for (auto edgeIdx = _firstIncomingEdges[from.target]; edgeIdx >= 0; edgeIdx = _edges[edgeIdx].nextIncoming)
+        {
+            if (_edges[edgeIdx].road == onlyRoad)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+const QList< std::shared_ptr<const OsmAnd::Road> >& OsmAnd::RoadGraph::getRoads() const
+{
+    return _roads;
+}
+
+int OsmAnd::RoadGraph::getRoadIndex(const std::shared_ptr<const Road>& road) const
+{
+    return _roadsIndicesById.value(road->id, -1);
+}
+
+float OsmAnd::RoadGraph::getRoadSpeed(const int road) const
+{
+    return _roadSpeeds[road];
+}
+
+OsmAnd::RoadDirection OsmAnd::RoadGraph::getRoadDirection(const int road) const
+{
+    return _roadDirections[road];
+}
+
+const std::shared_ptr<const OsmAnd::IRoadCostModel>& OsmAnd::RoadGraph::getCostModel() const
+{
+    return _costModel;
+}
+
+size_t OsmAnd::RoadGraph::getMemoryUsage() const
+{
+    const auto nodesCount = static_cast<size_t>(_nodePositions.size());
+    return
+        nodesCount * (sizeof(PointI) + 2 * sizeof(int) + sizeof(bool)) +
+        static_cast<size_t>(_nodesByPosition.size()) * (sizeof(uint64_t) + sizeof(int) + 2 * sizeof(void*)) +
+        static_cast<size_t>(_edges.capacity()) * sizeof(Edge) +
+        static_cast<size_t>(_roads.size()) * (sizeof(std::shared_ptr<const Road>) + sizeof(float) + sizeof(RoadDirection)) +
+        static_cast<size_t>(_roadsIndicesById.size()) * (sizeof(uint64_t) + sizeof(int) + 2 * sizeof(void*));
+}
+
+size_t OsmAnd::RoadGraph::getRoadsMemoryUsage() const
+{
+    size_t memoryUsage = 0;
+    for (const auto& road : constOf(_roads))
+        memoryUsage += road->getMemoryUsage();
+
+    return memoryUsage;
+}
+
+size_t OsmAnd::RoadGraph::getBlockGraphsMemoryUsage() const
+{
+    size_t memoryUsage = 0;
+    for (const auto& blockGraph : constOf(_blockGraphs))
+        memoryUsage += blockGraph->getMemoryUsage();
+
+    return memoryUsage;
+}
+
+int OsmAnd::RoadGraph::getBlockGraphsCount() const
+{
+    return _blockGraphs.size();
+}
+
+int OsmAnd::RoadGraph::getLoadedTilesCount() const
+{
+    return _loadedTiles.size();
+}
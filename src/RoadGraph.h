@@ -0,0 +1,165 @@
+#ifndef _OSMAND_CORE_ROAD_GRAPH_H_
+#define _OSMAND_CORE_ROAD_GRAPH_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PointsAndAreas.h"
+#include "ObfRoutingSectionReader.h"
+#include "Road.h"
+
+namespace OsmAnd
+{
+    class IObfsCollection;
+    class IRoadCostModel;
+    class IQueryController;
+    class Road;
+    class RoadBlockGraph;
+    class RoadBlockGraphsCache;
+
+    // Routing graph that is loaded lazily, tile by tile, as search proceeds. Every road point is a node,
+    // nodes are addressed by dense indices, and both outgoing and incoming edges of a node are kept as
+    // singly-linked lists inside flat arrays, so adding a tile never relocates per-node containers.
+    // Travel time of edges is evaluated by cost model only once, when road is added. If blocks cache and
+    // block graphs cache are given, whole data blocks are added from their prebuilt block graphs instead,
+    // and blocks are referenced until graph is destroyed. Turn restrictions are not expanded into extra
+    // nodes, since roads of a junction may arrive with different tiles: searches that obey them are
+    // edge-based and check every transition from edge to edge instead.
+    class RoadGraph Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadGraph);
+
+    public:
+        struct Edge
+        {
+            int source;
+            int target;
+            float time;
+            float length;
+            int nextOutgoing;
+            int nextIncoming;
+            int road;
+            int sourcePointIndex;
+            int targetPointIndex;
+        };
+
+        // Position attached to the nearest segment of a road that is accepted by cost model.
+        // Segment goes from start node to end node, in order of road points
+        struct Attachment
+        {
+            PointI position31;
+            double distance;
+            int road;
+            int startPointIndex;
+            int endPointIndex;
+            int startNode;
+            int endNode;
+            // Time to leave attached position towards start or end node, negative if not allowed by direction
+            float timeToStart;
+            float timeToEnd;
+            // Time to arrive at attached position from start or end node, negative if not allowed by direction
+            float timeFromStart;
+            float timeFromEnd;
+            // Edges of attached segment from start node to end node and back, -1 if not allowed by direction
+            int forwardEdge;
+            int backwardEdge;
+        };
+
+        // Tiles of this zoom are loaded at once
+        static const ZoomLevel TileZoom;
+
+    private:
+        const std::shared_ptr<const IObfsCollection> _obfsCollection;
+        const std::shared_ptr<const IRoadCostModel> _costModel;
+        ObfRoutingSectionReader::DataBlocksCache* const _cache;
+        RoadBlockGraphsCache* const _blockGraphsCache;
+
+        QHash<uint64_t, int> _nodesByPosition;
+        QVector<PointI> _nodePositions;
+        QVector<int> _firstOutgoingEdges;
+        QVector<int> _firstIncomingEdges;
+        QVector<bool> _nodesComplete;
+        QVector<Edge> _edges;
+        QList< std::shared_ptr<const Road> > _roads;
+        QVector<float> _roadSpeeds;
+        QVector<RoadDirection> _roadDirections;
+        // Index of road for each road seen, or -1 if road is not accepted by cost model
+        QHash<uint64_t, int> _roadsIndicesById;
+        const bool _restrictionsAware;
+        QSet<uint64_t> _loadedTiles;
+        bool _allLoaded;
+        QHash< uint64_t, std::shared_ptr<const ObfRoutingSectionReader::DataBlock> > _loadedBlocks;
+        QList< std::shared_ptr<const RoadBlockGraph> > _blockGraphs;
+
+        static uint64_t makePositionKey(const PointI& position31);
+        int obtainNode(const PointI& position31);
+        int findSegmentEdge(const int source, const int target, const int road, const int pointIndex) const;
+        void addEdge(const int source, const int target, const float time, const float length, const int road, const int sourcePointIndex, const int targetPointIndex);
+        void addRoad(const std::shared_ptr<const Road>& road);
+        void addBlockGraph(
+            const std::shared_ptr<const ObfRoutingSectionReader::DataBlock>& block,
+            const std::shared_ptr<const RoadBlockGraph>& blockGraph);
+        void releaseBlock(std::shared_ptr<const ObfRoutingSectionReader::DataBlock> block);
+    protected:
+    public:
+        RoadGraph(
+            const std::shared_ptr<const IObfsCollection>& obfsCollection,
+            const std::shared_ptr<const IRoadCostModel>& costModel,
+            ObfRoutingSectionReader::DataBlocksCache* const cache,
+            RoadBlockGraphsCache* const blockGraphsCache = nullptr,
+            const RoutingDataLevel dataLevel = RoutingDataLevel::Detailed);
+        ~RoadGraph();
+
+        const RoutingDataLevel dataLevel;
+
+        // Loads tile that contains given position, if it was not loaded yet
+        bool loadTile(const PointI& position31, const IQueryController* const controller = nullptr);
+        // Loads all tiles that intersect given area
+        bool loadArea(const AreaI& area31, const IQueryController* const controller = nullptr);
+        // Loads all roads at once and marks every node as complete
+        bool loadAll(const IQueryController* const controller = nullptr);
+        // Attaches position to the nearest accepted road within radius, loading tiles around if needed
+        bool attach(
+            const PointI& position31,
+            const double radiusInMeters,
+            Attachment& outAttachment,
+            const IQueryController* const controller = nullptr);
+        // Makes sure that all edges of the node are known. Returns true if graph was changed
+        bool completeNode(const int node, const IQueryController* const controller = nullptr);
+
+        int getNodesCount() const;
+        int getEdgesCount() const;
+        int findNode(const PointI& position31) const;
+        const PointI& getNodePosition(const int node) const;
+        int getFirstOutgoingEdge(const int node) const;
+        int getFirstIncomingEdge(const int node) const;
+        const Edge& getEdge(const int edge) const;
+        // Whether route may continue from one edge to another, that starts at target node of the first one
+        bool isTurnAllowed(const int fromEdge, const int toEdge) const;
+
+        const QList< std::shared_ptr<const Road> >& getRoads() const;
+        int getRoadIndex(const std::shared_ptr<const Road>& road) const;
+        float getRoadSpeed(const int road) const;
+        RoadDirection getRoadDirection(const int road) const;
+        const std::shared_ptr<const IRoadCostModel>& getCostModel() const;
+
+        // Approximate amount of memory occupied by graph structures (not including roads data itself)
+        size_t getMemoryUsage() const;
+        // Approximate amount of memory occupied by loaded roads, and by block graphs they were added from
+        size_t getRoadsMemoryUsage() const;
+        size_t getBlockGraphsMemoryUsage() const;
+        int getBlockGraphsCount() const;
+        int getLoadedTilesCount() const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_GRAPH_H_)
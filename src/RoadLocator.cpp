@@ -52,6 +52,17 @@ QList< std::shared_ptr<const OsmAnd::Road> > OsmAnd::RoadLocator::findRoadsInAre
     return _p->findRoadsInAreaEx(position31, radiusInMeters, dataLevel, outReferencedCacheEntries);
 }
 
+bool OsmAnd::RoadLocator::matchPoints(
+    const QVector<PointI>& points31,
+    const double radiusInMeters,
+    const RoutingDataLevel dataLevel,
+    QVector<MatchedPoint>& outMatchedPoints,
+    const MatchingMode mode /*= MatchingMode::Nearest*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->matchPoints(points31, radiusInMeters, dataLevel, outMatchedPoints, mode, controller);
+}
+
 std::shared_ptr<const OsmAnd::Road> OsmAnd::RoadLocator::findNearestRoad(
     const QList< std::shared_ptr<const Road> >& collection,
     const PointI position31,
@@ -78,3 +89,13 @@ QList< std::shared_ptr<const OsmAnd::Road> > OsmAnd::RoadLocator::findRoadsInAre
 {
     return RoadLocator_P::findRoadsInArea(collection, position31, radiusInMeters);
 }
+
+OsmAnd::RoadLocator::MatchedPoint::MatchedPoint()
+    : roadPointIndex(-1)
+    , distance(-1.0)
+{
+}
+
+OsmAnd::RoadLocator::MatchedPoint::~MatchedPoint()
+{
+}
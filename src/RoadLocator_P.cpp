@@ -1,11 +1,22 @@
 #include "RoadLocator_P.h"
 #include "RoadLocator.h"
 
+#include "stdlib_common.h"
+#include <algorithm>
+
 #include "Road.h"
 #include "IObfsCollection.h"
 #include "ObfDataInterface.h"
+#include "IQueryController.h"
+#include "RoadSegmentsIndex.h"
 #include "Utilities.h"
 
+const double OsmAnd::RoadLocator_P::MaxMatchingAreaSizeInMeters = 20000.0;
+const int OsmAnd::RoadLocator_P::MaxCandidatesPerPoint = 8;
+const double OsmAnd::RoadLocator_P::EmissionSigmaInMeters = 5.0;
+const double OsmAnd::RoadLocator_P::TransitionBetaInMeters = 5.0;
+const double OsmAnd::RoadLocator_P::RoadChangePenalty = 1.0;
+
 OsmAnd::RoadLocator_P::RoadLocator_P(RoadLocator* const owner_)
     : owner(owner_)
 {
@@ -66,6 +77,214 @@ QList< std::shared_ptr<const OsmAnd::Road> > OsmAnd::RoadLocator_P::findRoadsInA
     return findRoadsInArea(roadsInBBox, position31, radiusInMeters);
 }
 
+bool OsmAnd::RoadLocator_P::matchPoints(
+    const QVector<PointI>& points31,
+    const double radiusInMeters,
+    const RoutingDataLevel dataLevel,
+    QVector<MatchedPoint>& outMatchedPoints,
+    const MatchingMode mode,
+    const IQueryController* const controller) const
+{
+    outMatchedPoints.clear();
+    outMatchedPoints.resize(points31.size());
+
+    const auto pointsCount = points31.size();
+    auto firstPoint = 0;
+    while (firstPoint < pointsCount)
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        // Collect as many consecutive points as fit into area of limited size
+        AreaI64 area64(PointI64(points31[firstPoint]), PointI64(points31[firstPoint]));
+        auto piecePointsCount = 1;
+        while (firstPoint + piecePointsCount < pointsCount)
+        {
+            const auto enlargedArea64 = area64.getEnlargedToInclude(PointI64(points31[firstPoint + piecePointsCount]));
+            if (Utilities::x31toMeters(enlargedArea64.width()) > MaxMatchingAreaSizeInMeters ||
+                Utilities::y31toMeters(enlargedArea64.height()) > MaxMatchingAreaSizeInMeters)
+            {
+                break;
+            }
+
+            area64 = enlargedArea64;
+            piecePointsCount++;
+        }
+        area64.enlargeBy(PointI64(Utilities::metersToX31(radiusInMeters), Utilities::metersToY31(radiusInMeters)));
+        const auto bbox31 = (AreaI)area64;
+
+        // Roads of the whole piece are loaded once, and segments index is built once for all its points
+        QList< std::shared_ptr<const Road> > roadsInBBox;
+        const auto obfDataInterface = owner->obfsCollection->obtainDataInterface(bbox31);
+        obfDataInterface->loadRoads(
+            dataLevel,
+            &bbox31,
+            &roadsInBBox,
+            nullptr,
+            nullptr,
+            owner->cache.get(),
+            nullptr,
+            controller,
+            nullptr);
+        if (controller && controller->isAborted())
+            return false;
+
+        const RoadSegmentsIndex index(roadsInBBox, bbox31.center());
+        if (mode == MatchingMode::Continuous)
+            matchContinuous(index, points31, firstPoint, piecePointsCount, radiusInMeters, outMatchedPoints);
+        else
+            matchNearest(index, points31, firstPoint, piecePointsCount, radiusInMeters, outMatchedPoints);
+
+        firstPoint += piecePointsCount;
+    }
+
+    return true;
+}
+
+void OsmAnd::RoadLocator_P::matchNearest(
+    const RoadSegmentsIndex& index,
+    const QVector<PointI>& points31,
+    const int firstPoint,
+    const int pointsCount,
+    const double radiusInMeters,
+    QVector<MatchedPoint>& outMatchedPoints) const
+{
+    QVector<RoadSegmentsIndex::Candidate> candidates;
+    for (auto pointIdx = firstPoint; pointIdx < firstPoint + pointsCount; pointIdx++)
+    {
+        index.queryNearest(points31[pointIdx], radiusInMeters, 1, candidates);
+        if (candidates.isEmpty())
+            continue;
+        const auto& candidate = candidates.first();
+
+        auto& matchedPoint = outMatchedPoints[pointIdx];
+        matchedPoint.road = index.getSegmentRoad(candidate.segmentIndex);
+        matchedPoint.roadPointIndex = index.getSegmentEndPointIndex(candidate.segmentIndex);
+        matchedPoint.position31 = index.getProjection31(candidate);
+        matchedPoint.distance = qSqrt(candidate.squareDistance);
+    }
+}
+
+void OsmAnd::RoadLocator_P::matchContinuous(
+    const RoadSegmentsIndex& index,
+    const QVector<PointI>& points31,
+    const int firstPoint,
+    const int pointsCount,
+    const double radiusInMeters,
+    QVector<MatchedPoint>& outMatchedPoints) const
+{
+    struct State
+    {
+        RoadSegmentsIndex::Candidate candidate;
+        PointI projection31;
+        const Road* road;
+        double score;
+        int previousStateIndex;
+    };
+
+    // States of all points are kept in a flat array, each point owns a range of it
+    QVector<State> states;
+    QVector<int> pointStatesOffsets(pointsCount + 1);
+    states.reserve(pointsCount * MaxCandidatesPerPoint);
+
+    const auto backtrack =
+        [&index, &states, &pointStatesOffsets, firstPoint, &outMatchedPoints]
+        (const int lastPointOffset)
+        {
+            const auto lastStatesBegin = pointStatesOffsets[lastPointOffset];
+            const auto lastStatesEnd = pointStatesOffsets[lastPointOffset + 1];
+            if (lastStatesBegin == lastStatesEnd)
+                return;
+
+            auto stateIdx = lastStatesBegin;
+            for (auto idx = lastStatesBegin + 1; idx < lastStatesEnd; idx++)
+            {
+                if (states[idx].score > states[stateIdx].score)
+                    stateIdx = idx;
+            }
+
+            auto pointOffset = lastPointOffset;
+            while (stateIdx >= 0)
+            {
+                const auto& state = states[stateIdx];
+
+                auto& matchedPoint = outMatchedPoints[firstPoint + pointOffset];
+                matchedPoint.road = index.getSegmentRoad(state.candidate.segmentIndex);
+                matchedPoint.roadPointIndex = index.getSegmentEndPointIndex(state.candidate.segmentIndex);
+                matchedPoint.position31 = state.projection31;
+                matchedPoint.distance = qSqrt(state.candidate.squareDistance);
+
+                stateIdx = state.previousStateIndex;
+                pointOffset--;
+            }
+        };
+
+    const auto sigmaSq = EmissionSigmaInMeters * EmissionSigmaInMeters;
+    QVector<RoadSegmentsIndex::Candidate> candidates;
+    for (auto pointOffset = 0; pointOffset < pointsCount; pointOffset++)
+    {
+        const auto& point31 = points31[firstPoint + pointOffset];
+        pointStatesOffsets[pointOffset] = states.size();
+
+        index.queryNearest(point31, radiusInMeters, MaxCandidatesPerPoint, candidates);
+        if (candidates.isEmpty())
+        {
+            // Point without candidates breaks the chain: best path so far is fixed and a new chain starts
+            pointStatesOffsets[pointOffset + 1] = states.size();
+            if (pointOffset > 0)
+                backtrack(pointOffset - 1);
+            continue;
+        }
+
+        const auto previousStatesBegin = pointOffset > 0 ? pointStatesOffsets[pointOffset - 1] : 0;
+        const auto previousStatesEnd = pointStatesOffsets[pointOffset];
+        const auto observedDistance = pointOffset > 0
+            ? Utilities::distance31(point31.x, point31.y, points31[firstPoint + pointOffset - 1].x, points31[firstPoint + pointOffset - 1].y)
+            : 0.0;
+
+        for (const auto& candidate : constOf(candidates))
+        {
+            State state;
+            state.candidate = candidate;
+            state.projection31 = index.getProjection31(candidate);
+            state.road = index.getSegmentRoad(candidate.segmentIndex).get();
+            state.previousStateIndex = -1;
+
+            const auto emissionScore = -0.5 * static_cast<double>(candidate.squareDistance) / sigmaSq;
+            if (previousStatesBegin == previousStatesEnd)
+            {
+                state.score = emissionScore;
+                states.push_back(state);
+                continue;
+            }
+
+            // Distance along roads is approximated by straight distance between projections
+            state.score = -std::numeric_limits<double>::max();
+            for (auto previousStateIdx = previousStatesBegin; previousStateIdx < previousStatesEnd; previousStateIdx++)
+            {
+                const auto& previousState = states[previousStateIdx];
+
+                const auto projectedDistance = Utilities::distance31(
+                    state.projection31.x, state.projection31.y,
+                    previousState.projection31.x, previousState.projection31.y);
+                auto transitionScore = -qAbs(projectedDistance - observedDistance) / TransitionBetaInMeters;
+                if (previousState.road != state.road)
+                    transitionScore -= RoadChangePenalty;
+
+                const auto score = previousState.score + transitionScore + emissionScore;
+                if (score > state.score)
+                {
+                    state.score = score;
+                    state.previousStateIndex = previousStateIdx;
+                }
+            }
+            states.push_back(state);
+        }
+        pointStatesOffsets[pointOffset + 1] = states.size();
+    }
+    backtrack(pointsCount - 1);
+}
+
 std::shared_ptr<const OsmAnd::Road> OsmAnd::RoadLocator_P::findNearestRoad(
     const QList< std::shared_ptr<const Road> >& collection,
     const PointI position31,
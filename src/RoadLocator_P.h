@@ -5,22 +5,55 @@
 
 #include "QtExtensions.h"
 #include <QList>
+#include <QVector>
 
 #include "OsmAndCore.h"
 #include "CommonTypes.h"
 #include "PrivateImplementation.h"
 #include "ObfRoutingSectionReader.h"
+#include "RoadLocator.h"
 
 namespace OsmAnd
 {
     class IObfsCollection;
     class Road;
-    
+    class IQueryController;
+    class RoadSegmentsIndex;
+
     class RoadLocator;
     class RoadLocator_P Q_DECL_FINAL
     {
         Q_DISABLE_COPY_AND_MOVE(RoadLocator_P);
+    public:
+        typedef RoadLocator::MatchingMode MatchingMode;
+        typedef RoadLocator::MatchedPoint MatchedPoint;
+
+        // Trace is split into pieces not larger than this, and roads are loaded and indexed once per piece
+        static const double MaxMatchingAreaSizeInMeters;
+        // Number of nearest segments considered as candidates for each point in continuous mode
+        static const int MaxCandidatesPerPoint;
+        // Standard deviation of GPS noise, in meters
+        static const double EmissionSigmaInMeters;
+        // Scale of allowed difference between distance along roads and straight distance between points, in meters
+        static const double TransitionBetaInMeters;
+        // Log-probability penalty for switching to another road between consecutive points
+        static const double RoadChangePenalty;
+
     private:
+        void matchNearest(
+            const RoadSegmentsIndex& index,
+            const QVector<PointI>& points31,
+            const int firstPoint,
+            const int pointsCount,
+            const double radiusInMeters,
+            QVector<MatchedPoint>& outMatchedPoints) const;
+        void matchContinuous(
+            const RoadSegmentsIndex& index,
+            const QVector<PointI>& points31,
+            const int firstPoint,
+            const int pointsCount,
+            const double radiusInMeters,
+            QVector<MatchedPoint>& outMatchedPoints) const;
     protected:
         RoadLocator_P(RoadLocator* const owner);
     public:
@@ -41,6 +74,14 @@ namespace OsmAnd
             const RoutingDataLevel dataLevel,
             QList< std::shared_ptr<const ObfRoutingSectionReader::DataBlock> >* const outReferencedCacheEntries) const;
 
+        bool matchPoints(
+            const QVector<PointI>& points31,
+            const double radiusInMeters,
+            const RoutingDataLevel dataLevel,
+            QVector<MatchedPoint>& outMatchedPoints,
+            const MatchingMode mode,
+            const IQueryController* const controller) const;
+
         static std::shared_ptr<const Road> findNearestRoad(
             const QList< std::shared_ptr<const Road> >& collection,
             const PointI position31,
@@ -0,0 +1,81 @@
+#include "RoadRouter.h"
+#include "RoadRouter_P.h"
+
+OsmAnd::RoadRouter::RoadRouter(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection_,
+    const std::shared_ptr<const IRoadCostModel>& costModel_,
+    const std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache>& cache_ /*= nullptr*/,
+    const std::shared_ptr<const ContractionHierarchy>& contractionHierarchy_ /*= nullptr*/)
+    : _p(new RoadRouter_P(this))
+    , obfsCollection(obfsCollection_)
+    , costModel(costModel_)
+    , cache(cache_)
+    , contractionHierarchy(contractionHierarchy_)
+{
+    _p->initialize();
+}
+
+OsmAnd::RoadRouter::~RoadRouter()
+{
+}
+
+bool OsmAnd::RoadRouter::isUsingContractionHierarchy() const
+{
+    return _p->isUsingContractionHierarchy();
+}
+
+bool OsmAnd::RoadRouter::findRoute(
+    const PointI start31,
+    const PointI finish31,
+    Route& outRoute,
+    Statistics* const outStatistics /*= nullptr*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->findRoute(start31, finish31, outRoute, outStatistics, controller);
+}
+
+bool OsmAnd::RoadRouter::computeTravelTimes(
+    const QVector<PointI>& sources31,
+    const QVector<PointI>& targets31,
+    QVector<float>& outTimes,
+    const unsigned int threadsCount /*= 0*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->computeTravelTimes(sources31, targets31, outTimes, threadsCount, controller);
+}
+
+OsmAnd::RoadRouter::RouteSegment::RouteSegment()
+    : startPointIndex(-1)
+    , endPointIndex(-1)
+{
+}
+
+OsmAnd::RoadRouter::RouteSegment::~RouteSegment()
+{
+}
+
+OsmAnd::RoadRouter::Route::Route()
+    : time(0.0f)
+    , distance(0.0)
+{
+}
+
+OsmAnd::RoadRouter::Route::~Route()
+{
+}
+
+OsmAnd::RoadRouter::Statistics::Statistics()
+    : settledNodesCount(0)
+    , graphNodesCount(0)
+    , graphEdgesCount(0)
+    , loadedTilesCount(0)
+    , loadedRoadsCount(0)
+    , peakMemoryUsage(0)
+    , roadsMemoryUsage(0)
+    , blockGraphsMemoryUsage(0)
+{
+}
+
+OsmAnd::RoadRouter::Statistics::~Statistics()
+{
+}
@@ -0,0 +1,718 @@
+#include "RoadRouter_P.h"
+#include "RoadRouter.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <functional>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include "restore_internal_warnings.h"
+
+#include "Road.h"
+#include "IRoadCostModel.h"
+#include "IQueryController.h"
+#include "ContractionHierarchy.h"
+#include "RoadBlockGraphsCache.h"
+#include "Concurrent.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+const double OsmAnd::RoadRouter_P::AttachRadiusInMeters = 1000.0;
+const float OsmAnd::RoadRouter_P::TravelTimeCutoffFactor = 8.0f;
+
+OsmAnd::RoadRouter_P::RoadRouter_P(RoadRouter* const owner_)
+    : _useContractionHierarchy(false)
+    , owner(owner_)
+{
+}
+
+OsmAnd::RoadRouter_P::~RoadRouter_P()
+{
+}
+
+void OsmAnd::RoadRouter_P::initialize()
+{
+    _blockGraphsCache.reset(new RoadBlockGraphsCache(owner->costModel));
+
+    const auto& contractionHierarchy = owner->contractionHierarchy;
+    if (!contractionHierarchy || !contractionHierarchy->isValid())
+        return;
+
+    // Hierarchy built from other data or for other cost model would give wrong routes
+    if (!contractionHierarchy->isUpToDate(owner->obfsCollection, owner->costModel))
+    {
+        LogPrintf(LogSeverityLevel::Warning,
+            "Contraction hierarchy '%s' is stale, routes will be found without it",
+            qPrintable(contractionHierarchy->filename));
+        return;
+    }
+
+    _useContractionHierarchy = true;
+}
+
+bool OsmAnd::RoadRouter_P::isUsingContractionHierarchy() const
+{
+    return _useContractionHierarchy;
+}
+
+bool OsmAnd::RoadRouter_P::heapEntryComparator(const HeapEntry& l, const HeapEntry& r)
+{
+    // Makes std::*_heap() functions maintain min-heap
+    return l.key > r.key;
+}
+
+void OsmAnd::RoadRouter_P::SearchState::resize(const int edgesCount)
+{
+    const auto oldEdgesCount = times.size();
+    if (oldEdgesCount >= edgesCount)
+        return;
+
+    times.resize(edgesCount);
+    parentEdges.resize(edgesCount);
+    settled.resize(edgesCount);
+    std::fill(times.begin() + oldEdgesCount, times.end(), std::numeric_limits<float>::infinity());
+    std::fill(parentEdges.begin() + oldEdgesCount, parentEdges.end(), -1);
+    std::fill(settled.begin() + oldEdgesCount, settled.end(), false);
+}
+
+void OsmAnd::RoadRouter_P::SearchState::reset()
+{
+    for (const auto edge : constOf(touchedEdges))
+    {
+        times[edge] = std::numeric_limits<float>::infinity();
+        parentEdges[edge] = -1;
+        settled[edge] = false;
+    }
+    touchedEdges.clear();
+    heap.clear();
+}
+
+void OsmAnd::RoadRouter_P::SearchState::push(const int edge, const float time, const float key, const int parentEdge)
+{
+    if (times[edge] == std::numeric_limits<float>::infinity())
+        touchedEdges.push_back(edge);
+    times[edge] = time;
+    parentEdges[edge] = parentEdge;
+
+    HeapEntry entry;
+    entry.key = key;
+    entry.edge = edge;
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), heapEntryComparator);
+}
+
+bool OsmAnd::RoadRouter_P::SearchState::purgeTop()
+{
+    while (!heap.isEmpty() && settled[heap.first().edge])
+    {
+        std::pop_heap(heap.begin(), heap.end(), heapEntryComparator);
+        heap.removeLast();
+    }
+
+    return !heap.isEmpty();
+}
+
+size_t OsmAnd::RoadRouter_P::SearchState::getMemoryUsage() const
+{
+    return
+        static_cast<size_t>(times.capacity()) * sizeof(float) +
+        static_cast<size_t>(parentEdges.capacity()) * sizeof(int) +
+        static_cast<size_t>(settled.capacity()) * sizeof(bool) +
+        static_cast<size_t>(heap.capacity()) * sizeof(HeapEntry) +
+        static_cast<size_t>(touchedEdges.capacity()) * sizeof(int);
+}
+
+bool OsmAnd::RoadRouter_P::findRoute(
+    const PointI start31,
+    const PointI finish31,
+    Route& outRoute,
+    Statistics* const outStatistics,
+    const IQueryController* const controller) const
+{
+    RoadGraph graph(owner->obfsCollection, owner->costModel, owner->cache.get(), _blockGraphsCache.get());
+
+    RoadGraph::Attachment startAttachment;
+    RoadGraph::Attachment finishAttachment;
+    if (!graph.attach(start31, AttachRadiusInMeters, startAttachment, controller) ||
+        !graph.attach(finish31, AttachRadiusInMeters, finishAttachment, controller))
+    {
+        return false;
+    }
+
+    if (_useContractionHierarchy)
+    {
+        auto found = false;
+        if (findRouteInContractionHierarchy(graph, startAttachment, finishAttachment, outRoute, found, outStatistics, controller))
+            return found;
+    }
+
+    // Both directions use average of potentials towards finish and towards start, which keeps them
+    // consistent with each other. Then search can stop as soon as sum of top keys reaches best time found
+    const auto inverseDoubleMaxSpeed = 0.5f / owner->costModel->getMaxSpeed();
+    const auto potential =
+        [&graph, &startAttachment, &finishAttachment, inverseDoubleMaxSpeed]
+        (const int node) -> float
+        {
+            const auto& position31 = graph.getNodePosition(node);
+            const auto distanceToFinish = Utilities::distance31(
+                position31.x, position31.y, finishAttachment.position31.x, finishAttachment.position31.y);
+            const auto distanceToStart = Utilities::distance31(
+                position31.x, position31.y, startAttachment.position31.x, startAttachment.position31.y);
+            return static_cast<float>(distanceToFinish - distanceToStart) * inverseDoubleMaxSpeed;
+        };
+
+    SearchState forward;
+    SearchState backward;
+    forward.resize(graph.getEdgesCount());
+    backward.resize(graph.getEdgesCount());
+
+    // Forward and backward searches meet at the node where forward edge ends and backward one starts
+    auto bestTime = computeDirectTime(graph, startAttachment, finishAttachment);
+    auto meetingForwardEdge = -1;
+    auto meetingBackwardEdge = -1;
+    const auto checkMeeting =
+        [&forward, &backward, &bestTime, &meetingForwardEdge, &meetingBackwardEdge]
+        (const int forwardEdge, const int backwardEdge)
+        {
+            const auto time = forward.times[forwardEdge] + backward.times[backwardEdge];
+            if (time < bestTime)
+            {
+                bestTime = time;
+                meetingForwardEdge = forwardEdge;
+                meetingBackwardEdge = backwardEdge;
+            }
+        };
+
+    // Searches start from edges of attached segments, that are passed only partially
+    if (startAttachment.timeToStart >= 0.0f)
+    {
+        forward.push(startAttachment.backwardEdge, startAttachment.timeToStart,
+            startAttachment.timeToStart + potential(startAttachment.startNode), -1);
+    }
+    if (startAttachment.timeToEnd >= 0.0f)
+    {
+        forward.push(startAttachment.forwardEdge, startAttachment.timeToEnd,
+            startAttachment.timeToEnd + potential(startAttachment.endNode), -1);
+    }
+    if (finishAttachment.timeFromStart >= 0.0f)
+    {
+        backward.push(finishAttachment.forwardEdge, finishAttachment.timeFromStart,
+            finishAttachment.timeFromStart - potential(finishAttachment.startNode), -1);
+    }
+    if (finishAttachment.timeFromEnd >= 0.0f)
+    {
+        backward.push(finishAttachment.backwardEdge, finishAttachment.timeFromEnd,
+            finishAttachment.timeFromEnd - potential(finishAttachment.endNode), -1);
+    }
+    for (const auto forwardEdge : constOf(forward.touchedEdges))
+    {
+        for (const auto backwardEdge : constOf(backward.touchedEdges))
+        {
+            if (graph.getEdge(forwardEdge).target == graph.getEdge(backwardEdge).source &&
+                graph.isTurnAllowed(forwardEdge, backwardEdge))
+            {
+                checkMeeting(forwardEdge, backwardEdge);
+            }
+        }
+    }
+
+    unsigned int settledNodesCount = 0;
+    size_t peakMemoryUsage = 0;
+    while (forward.purgeTop() && backward.purgeTop())
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        if (forward.heap.first().key + backward.heap.first().key >= bestTime)
+            break;
+
+        // Direction with smaller frontier is expanded
+        const auto isForward = (forward.heap.size() <= backward.heap.size());
+        auto& state = isForward ? forward : backward;
+
+        const auto edgeIdx = state.heap.first().edge;
+        std::pop_heap(state.heap.begin(), state.heap.end(), heapEntryComparator);
+        state.heap.removeLast();
+        state.settled[edgeIdx] = true;
+        settledNodesCount++;
+
+        // Forward search goes on from target of the edge, backward one from its source
+        const auto node = isForward ? graph.getEdge(edgeIdx).target : graph.getEdge(edgeIdx).source;
+        if (graph.completeNode(node, controller))
+        {
+            forward.resize(graph.getEdgesCount());
+            backward.resize(graph.getEdgesCount());
+            peakMemoryUsage = qMax(peakMemoryUsage, graph.getMemoryUsage() + forward.getMemoryUsage() + backward.getMemoryUsage());
+        }
+        if (controller && controller->isAborted())
+            return false;
+
+        const auto time = state.times[edgeIdx];
+        if (isForward)
+        {
+            for (auto nextEdgeIdx = graph.getFirstOutgoingEdge(node); nextEdgeIdx >= 0; nextEdgeIdx = graph.getEdge(nextEdgeIdx).nextOutgoing)
+            {
+                if (!graph.isTurnAllowed(edgeIdx, nextEdgeIdx))
+                    continue;
+                checkMeeting(edgeIdx, nextEdgeIdx);
+
+                const auto& nextEdge = graph.getEdge(nextEdgeIdx);
+                const auto newTime = time + nextEdge.time;
+                if (newTime >= forward.times[nextEdgeIdx])
+                    continue;
+
+                forward.push(nextEdgeIdx, newTime, newTime + potential(nextEdge.target), edgeIdx);
+            }
+        }
+        else
+        {
+            for (auto previousEdgeIdx = graph.getFirstIncomingEdge(node); previousEdgeIdx >= 0; previousEdgeIdx = graph.getEdge(previousEdgeIdx).nextIncoming)
+            {
+                if (!graph.isTurnAllowed(previousEdgeIdx, edgeIdx))
+                    continue;
+                checkMeeting(previousEdgeIdx, edgeIdx);
+
+                const auto& previousEdge = graph.getEdge(previousEdgeIdx);
+                const auto newTime = time + previousEdge.time;
+                if (newTime >= backward.times[previousEdgeIdx])
+                    continue;
+
+                backward.push(previousEdgeIdx, newTime, newTime - potential(previousEdge.source), edgeIdx);
+            }
+        }
+    }
+    peakMemoryUsage = qMax(peakMemoryUsage, graph.getMemoryUsage() + forward.getMemoryUsage() + backward.getMemoryUsage());
+
+    if (outStatistics)
+    {
+        outStatistics->settledNodesCount = settledNodesCount;
+        outStatistics->graphNodesCount = graph.getNodesCount();
+        outStatistics->graphEdgesCount = graph.getEdgesCount();
+        outStatistics->loadedTilesCount = graph.getLoadedTilesCount();
+        outStatistics->loadedRoadsCount = graph.getRoads().size();
+        outStatistics->peakMemoryUsage = peakMemoryUsage;
+        outStatistics->roadsMemoryUsage = graph.getRoadsMemoryUsage();
+        outStatistics->blockGraphsMemoryUsage = graph.getBlockGraphsMemoryUsage();
+    }
+
+    if (bestTime == std::numeric_limits<float>::infinity())
+        return false;
+
+    buildRoute(graph, startAttachment, finishAttachment, forward, backward, meetingForwardEdge, meetingBackwardEdge, bestTime, outRoute);
+    return true;
+}
+
+float OsmAnd::RoadRouter_P::computeDirectTime(
+    const RoadGraph& graph,
+    const RoadGraph::Attachment& startAttachment,
+    const RoadGraph::Attachment& finishAttachment)
+{
+    // Both positions on the same segment may be connected directly
+    if (startAttachment.road != finishAttachment.road || startAttachment.startPointIndex != finishAttachment.startPointIndex)
+        return std::numeric_limits<float>::infinity();
+
+    const auto& segmentStart31 = graph.getNodePosition(startAttachment.startNode);
+    const auto startOffset = Utilities::distance31(
+        segmentStart31.x, segmentStart31.y, startAttachment.position31.x, startAttachment.position31.y);
+    const auto finishOffset = Utilities::distance31(
+        segmentStart31.x, segmentStart31.y, finishAttachment.position31.x, finishAttachment.position31.y);
+    const auto speed = graph.getRoadSpeed(startAttachment.road);
+    if ((startOffset <= finishOffset && startAttachment.timeToEnd >= 0.0f) ||
+        (startOffset >= finishOffset && startAttachment.timeToStart >= 0.0f))
+    {
+        return static_cast<float>(qAbs(finishOffset - startOffset)) / speed;
+    }
+
+    return std::numeric_limits<float>::infinity();
+}
+
+bool OsmAnd::RoadRouter_P::findRouteInContractionHierarchy(
+    const RoadGraph& graph,
+    const RoadGraph::Attachment& startAttachment,
+    const RoadGraph::Attachment& finishAttachment,
+    Route& outRoute,
+    bool& outFound,
+    Statistics* const outStatistics,
+    const IQueryController* const controller) const
+{
+    const auto& contractionHierarchy = owner->contractionHierarchy;
+
+    QList<ContractionHierarchy::Endpoint> sources;
+    QList<ContractionHierarchy::Endpoint> targets;
+    if (startAttachment.timeToStart >= 0.0f)
+        sources.push_back(ContractionHierarchy::Endpoint(graph.getNodePosition(startAttachment.startNode), startAttachment.timeToStart));
+    if (startAttachment.timeToEnd >= 0.0f)
+        sources.push_back(ContractionHierarchy::Endpoint(graph.getNodePosition(startAttachment.endNode), startAttachment.timeToEnd));
+    if (finishAttachment.timeFromStart >= 0.0f)
+        targets.push_back(ContractionHierarchy::Endpoint(graph.getNodePosition(finishAttachment.startNode), finishAttachment.timeFromStart));
+    if (finishAttachment.timeFromEnd >= 0.0f)
+        targets.push_back(ContractionHierarchy::Endpoint(graph.getNodePosition(finishAttachment.endNode), finishAttachment.timeFromEnd));
+
+    // Road that is missing in hierarchy means that hierarchy doesn't cover this area
+    for (const auto& endpoint : constOf(sources + targets))
+    {
+        if (!contractionHierarchy->containsNode(endpoint.position31))
+            return false;
+    }
+
+    const auto directTime = computeDirectTime(graph, startAttachment, finishAttachment);
+    ContractionHierarchy::Path path;
+    const auto pathFound = contractionHierarchy->findPath(sources, targets, path, controller);
+    if (controller && controller->isAborted())
+    {
+        outFound = false;
+        return true;
+    }
+
+    if (outStatistics)
+    {
+        outStatistics->settledNodesCount = path.settledNodesCount;
+        outStatistics->graphNodesCount = graph.getNodesCount();
+        outStatistics->graphEdgesCount = graph.getEdgesCount();
+        outStatistics->loadedTilesCount = graph.getLoadedTilesCount();
+        outStatistics->loadedRoadsCount = graph.getRoads().size();
+        outStatistics->peakMemoryUsage = graph.getMemoryUsage();
+        outStatistics->roadsMemoryUsage = graph.getRoadsMemoryUsage();
+        outStatistics->blockGraphsMemoryUsage = graph.getBlockGraphsMemoryUsage();
+    }
+
+    if (!pathFound || path.time >= directTime)
+    {
+        outFound = (directTime != std::numeric_limits<float>::infinity());
+        if (outFound)
+            buildRoute(graph, startAttachment, finishAttachment, SearchState(), SearchState(), -1, -1, directTime, outRoute);
+        return true;
+    }
+
+    outRoute = Route();
+    outRoute.time = path.time;
+    outRoute.points31.push_back(startAttachment.position31);
+    outRoute.points31 += path.points31;
+    outRoute.points31.push_back(finishAttachment.position31);
+    outRoute.distance =
+        Utilities::distance31(startAttachment.position31, path.points31.first()) +
+        path.distance +
+        Utilities::distance31(path.points31.last(), finishAttachment.position31);
+
+    outFound = true;
+    return true;
+}
+
+bool OsmAnd::RoadRouter_P::computeTravelTimes(
+    const QVector<PointI>& sources31,
+    const QVector<PointI>& targets31,
+    QVector<float>& outTimes,
+    const unsigned int threadsCount,
+    const IQueryController* const controller) const
+{
+    // Blocks read by one thread are reused by all others
+    std::shared_ptr<ObfRoutingSectionReader::DataBlocksCache> cache = owner->cache;
+    if (!cache)
+        cache.reset(new ObfRoutingSectionReader::DataBlocksCache());
+
+    if (_useContractionHierarchy &&
+        computeTravelTimesInContractionHierarchy(sources31, targets31, outTimes, cache.get(), threadsCount, controller))
+    {
+        return !(controller && controller->isAborted());
+    }
+
+    outTimes.resize(sources31.size() * targets31.size());
+    std::fill(outTimes.begin(), outTimes.end(), std::numeric_limits<float>::infinity());
+    if (outTimes.isEmpty())
+        return true;
+
+    // Each thread has own graph, that grows as its sources are processed
+    const auto pTimes = outTimes.data();
+    QAtomicInt nextSource(0);
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(qMin(
+        static_cast<int>(threadsCount > 0 ? threadsCount : QThread::idealThreadCount()),
+        sources31.size()));
+    for (auto workerIdx = 0, workersCount = threadPool.maxThreadCount(); workerIdx < workersCount; workerIdx++)
+    {
+        threadPool.start(new Concurrent::Task(
+            [this, &sources31, &targets31, &nextSource, pTimes, cache, controller]
+            (Concurrent::Task* const task)
+            {
+                Q_UNUSED(task);
+
+                computeTravelTimesInGraph(sources31, targets31, nextSource, pTimes, cache.get(), controller);
+            }));
+    }
+    threadPool.waitForDone();
+
+    return !(controller && controller->isAborted());
+}
+
+void OsmAnd::RoadRouter_P::computeTravelTimesInGraph(
+    const QVector<PointI>& sources31,
+    const QVector<PointI>& targets31,
+    QAtomicInt& nextSource,
+    float* const pTimes,
+    ObfRoutingSectionReader::DataBlocksCache* const cache,
+    const IQueryController* const controller) const
+{
+    RoadGraph graph(owner->obfsCollection, owner->costModel, cache, _blockGraphsCache.get());
+    const auto targetsCount = targets31.size();
+
+    // Edge of attached segment leads to target attached next to its source
+    QVector<RoadGraph::Attachment> targetAttachments(targetsCount);
+    QVector<bool> targetsAttached(targetsCount);
+    QHash< int, QVector< std::pair<int, float> > > targetsByEdge;
+    for (auto targetIdx = 0; targetIdx < targetsCount; targetIdx++)
+    {
+        auto& attachment = targetAttachments[targetIdx];
+        targetsAttached[targetIdx] = graph.attach(targets31[targetIdx], AttachRadiusInMeters, attachment, controller);
+        if (!targetsAttached[targetIdx])
+            continue;
+
+        if (attachment.timeFromStart >= 0.0f)
+            targetsByEdge[attachment.forwardEdge].push_back(std::make_pair(targetIdx, attachment.timeFromStart));
+        if (attachment.timeFromEnd >= 0.0f)
+            targetsByEdge[attachment.backwardEdge].push_back(std::make_pair(targetIdx, attachment.timeFromEnd));
+    }
+
+    // Plain Dijkstra from each source runs till all edges leading to targets are reached. Edges are settled
+    // in order of their times, so the first time target edge is reached from a settled edge is the best one.
+    // Target that can't be reached would make search load roads of the whole map, so it stops at cutoff
+    const auto inverseMaxSpeed = 1.0f / owner->costModel->getMaxSpeed();
+    SearchState state;
+    QSet<int> reachedTargetEdges;
+    for (auto sourceIdx = nextSource.fetchAndAddOrdered(1); sourceIdx < sources31.size(); sourceIdx = nextSource.fetchAndAddOrdered(1))
+    {
+        if (controller && controller->isAborted())
+            return;
+
+        RoadGraph::Attachment sourceAttachment;
+        if (!graph.attach(sources31[sourceIdx], AttachRadiusInMeters, sourceAttachment, controller))
+            continue;
+        const auto pRow = pTimes + sourceIdx * targetsCount;
+
+        auto farthestTargetDistance = 0.0;
+        for (auto targetIdx = 0; targetIdx < targetsCount; targetIdx++)
+        {
+            if (!targetsAttached[targetIdx])
+                continue;
+
+            pRow[targetIdx] = computeDirectTime(graph, sourceAttachment, targetAttachments[targetIdx]);
+            farthestTargetDistance = qMax(farthestTargetDistance,
+                Utilities::distance31(sourceAttachment.position31, targetAttachments[targetIdx].position31));
+        }
+        const auto cutoffTime = static_cast<float>(farthestTargetDistance + 2.0 * AttachRadiusInMeters) *
+            inverseMaxSpeed * TravelTimeCutoffFactor;
+
+        state.reset();
+        state.resize(graph.getEdgesCount());
+        if (sourceAttachment.timeToStart >= 0.0f)
+            state.push(sourceAttachment.backwardEdge, sourceAttachment.timeToStart, sourceAttachment.timeToStart, -1);
+        if (sourceAttachment.timeToEnd >= 0.0f)
+            state.push(sourceAttachment.forwardEdge, sourceAttachment.timeToEnd, sourceAttachment.timeToEnd, -1);
+
+        reachedTargetEdges.clear();
+        while (reachedTargetEdges.size() < targetsByEdge.size() && state.purgeTop())
+        {
+            const auto edgeIdx = state.heap.first().edge;
+            if (state.times[edgeIdx] > cutoffTime)
+                break;
+            std::pop_heap(state.heap.begin(), state.heap.end(), heapEntryComparator);
+            state.heap.removeLast();
+            state.settled[edgeIdx] = true;
+
+            const auto node = graph.getEdge(edgeIdx).target;
+            if (graph.completeNode(node, controller))
+                state.resize(graph.getEdgesCount());
+            if (controller && controller->isAborted())
+                return;
+
+            const auto time = state.times[edgeIdx];
+            for (auto nextEdgeIdx = graph.getFirstOutgoingEdge(node); nextEdgeIdx >= 0; nextEdgeIdx = graph.getEdge(nextEdgeIdx).nextOutgoing)
+            {
+                if (!graph.isTurnAllowed(edgeIdx, nextEdgeIdx))
+                    continue;
+
+                const auto citTargets = targetsByEdge.constFind(nextEdgeIdx);
+                if (citTargets != targetsByEdge.cend() && !reachedTargetEdges.contains(nextEdgeIdx))
+                {
+                    for (const auto& target : constOf(*citTargets))
+                        pRow[target.first] = qMin(pRow[target.first], time + target.second);
+                    reachedTargetEdges.insert(nextEdgeIdx);
+                }
+
+                const auto newTime = time + graph.getEdge(nextEdgeIdx).time;
+                if (newTime < state.times[nextEdgeIdx])
+                    state.push(nextEdgeIdx, newTime, newTime, edgeIdx);
+            }
+        }
+    }
+}
+
+bool OsmAnd::RoadRouter_P::computeTravelTimesInContractionHierarchy(
+    const QVector<PointI>& sources31,
+    const QVector<PointI>& targets31,
+    QVector<float>& outTimes,
+    ObfRoutingSectionReader::DataBlocksCache* const cache,
+    const unsigned int threadsCount,
+    const IQueryController* const controller) const
+{
+    const auto& contractionHierarchy = owner->contractionHierarchy;
+
+    // Graph is needed only to attach points to roads, so it contains just tiles around them
+    RoadGraph graph(owner->obfsCollection, owner->costModel, cache, _blockGraphsCache.get());
+    QVector<RoadGraph::Attachment> attachments(sources31.size() + targets31.size());
+    QVector<bool> attached(attachments.size());
+    QVector< QList<ContractionHierarchy::Endpoint> > sourcesEndpoints(sources31.size());
+    QVector< QList<ContractionHierarchy::Endpoint> > targetsEndpoints(targets31.size());
+    for (auto pointIdx = 0; pointIdx < attachments.size(); pointIdx++)
+    {
+        const auto isSource = (pointIdx < sources31.size());
+        const auto& position31 = isSource ? sources31[pointIdx] : targets31[pointIdx - sources31.size()];
+        auto& attachment = attachments[pointIdx];
+        attached[pointIdx] = graph.attach(position31, AttachRadiusInMeters, attachment, controller);
+        if (controller && controller->isAborted())
+            return true;
+        if (!attached[pointIdx])
+            continue;
+
+        auto& endpoints = isSource ? sourcesEndpoints[pointIdx] : targetsEndpoints[pointIdx - sources31.size()];
+        const auto startTime = isSource ? attachment.timeToStart : attachment.timeFromStart;
+        const auto endTime = isSource ? attachment.timeToEnd : attachment.timeFromEnd;
+        if (startTime >= 0.0f)
+            endpoints.push_back(ContractionHierarchy::Endpoint(graph.getNodePosition(attachment.startNode), startTime));
+        if (endTime >= 0.0f)
+            endpoints.push_back(ContractionHierarchy::Endpoint(graph.getNodePosition(attachment.endNode), endTime));
+
+        for (const auto& endpoint : constOf(endpoints))
+        {
+            if (!contractionHierarchy->containsNode(endpoint.position31))
+                return false;
+        }
+    }
+
+    if (!contractionHierarchy->findTravelTimes(sourcesEndpoints, targetsEndpoints, outTimes, threadsCount, controller))
+        return true;
+
+    const auto targetsCount = targets31.size();
+    for (auto sourceIdx = 0; sourceIdx < sources31.size(); sourceIdx++)
+    {
+        if (!attached[sourceIdx])
+            continue;
+
+        for (auto targetIdx = 0; targetIdx < targetsCount; targetIdx++)
+        {
+            if (!attached[sources31.size() + targetIdx])
+                continue;
+
+            auto& time = outTimes[sourceIdx * targetsCount + targetIdx];
+            time = qMin(time, computeDirectTime(graph, attachments[sourceIdx], attachments[sources31.size() + targetIdx]));
+        }
+    }
+
+    return true;
+}
+
+void OsmAnd::RoadRouter_P::appendSegment(
+    QList<RouteSegment>& segments,
+    const std::shared_ptr<const Road>& road,
+    const int startPointIndex,
+    const int endPointIndex)
+{
+    if (startPointIndex == endPointIndex)
+        return;
+
+    // Consecutive pieces of the same road in the same direction are merged
+    if (!segments.isEmpty())
+    {
+        auto& lastSegment = segments.last();
+        if (lastSegment.road == road &&
+            lastSegment.endPointIndex == startPointIndex &&
+            (lastSegment.endPointIndex > lastSegment.startPointIndex) == (endPointIndex > startPointIndex))
+        {
+            lastSegment.endPointIndex = endPointIndex;
+            return;
+        }
+    }
+
+    RouteSegment segment;
+    segment.road = road;
+    segment.startPointIndex = startPointIndex;
+    segment.endPointIndex = endPointIndex;
+    segments.push_back(segment);
+}
+
+void OsmAnd::RoadRouter_P::buildRoute(
+    const RoadGraph& graph,
+    const RoadGraph::Attachment& startAttachment,
+    const RoadGraph::Attachment& finishAttachment,
+    const SearchState& forward,
+    const SearchState& backward,
+    const int meetingForwardEdge,
+    const int meetingBackwardEdge,
+    const float time,
+    Route& outRoute) const
+{
+    outRoute = Route();
+    outRoute.time = time;
+
+    const auto& startRoad = graph.getRoads()[startAttachment.road];
+    const auto& finishRoad = graph.getRoads()[finishAttachment.road];
+    outRoute.points31.push_back(startAttachment.position31);
+
+    // Direct connection along a single segment
+    if (meetingForwardEdge < 0)
+    {
+        const auto startOffset = Utilities::distance31(
+            graph.getNodePosition(startAttachment.startNode), startAttachment.position31);
+        const auto finishOffset = Utilities::distance31(
+            graph.getNodePosition(startAttachment.startNode), finishAttachment.position31);
+        if (startOffset <= finishOffset)
+            appendSegment(outRoute.segments, startRoad, startAttachment.startPointIndex, startAttachment.endPointIndex);
+        else
+            appendSegment(outRoute.segments, startRoad, startAttachment.endPointIndex, startAttachment.startPointIndex);
+        outRoute.points31.push_back(finishAttachment.position31);
+        outRoute.distance = qAbs(finishOffset - startOffset);
+        return;
+    }
+
+    // Edges from start to meeting node are collected backwards. Each direction begins with edge of attached
+    // segment, that was passed only partially
+    QVector<int> edges;
+    for (auto edgeIdx = meetingForwardEdge; edgeIdx >= 0; edgeIdx = forward.parentEdges[edgeIdx])
+        edges.push_back(edgeIdx);
+    const auto firstNode = graph.getEdge(edges.last()).target;
+    edges.removeLast();
+    std::reverse(edges.begin(), edges.end());
+    auto lastEdge = meetingBackwardEdge;
+    for (; backward.parentEdges[lastEdge] >= 0; lastEdge = backward.parentEdges[lastEdge])
+        edges.push_back(lastEdge);
+    const auto lastNode = graph.getEdge(lastEdge).source;
+
+    const auto& firstPosition31 = graph.getNodePosition(firstNode);
+    outRoute.distance += Utilities::distance31(startAttachment.position31, firstPosition31);
+    if (firstNode == startAttachment.endNode)
+        appendSegment(outRoute.segments, startRoad, startAttachment.startPointIndex, startAttachment.endPointIndex);
+    else
+        appendSegment(outRoute.segments, startRoad, startAttachment.endPointIndex, startAttachment.startPointIndex);
+    outRoute.points31.push_back(firstPosition31);
+
+    for (const auto edgeIdx : constOf(edges))
+    {
+        const auto& edge = graph.getEdge(edgeIdx);
+
+        appendSegment(outRoute.segments, graph.getRoads()[edge.road], edge.sourcePointIndex, edge.targetPointIndex);
+        outRoute.points31.push_back(graph.getNodePosition(edge.target));
+        outRoute.distance += edge.length;
+    }
+
+    const auto& lastPosition31 = graph.getNodePosition(lastNode);
+    outRoute.distance += Utilities::distance31(lastPosition31, finishAttachment.position31);
+    if (lastNode == finishAttachment.startNode)
+        appendSegment(outRoute.segments, finishRoad, finishAttachment.startPointIndex, finishAttachment.endPointIndex);
+    else
+        appendSegment(outRoute.segments, finishRoad, finishAttachment.endPointIndex, finishAttachment.startPointIndex);
+    outRoute.points31.push_back(finishAttachment.position31);
+}
@@ -0,0 +1,143 @@
+#ifndef _OSMAND_CORE_ROAD_ROUTER_P_H_
+#define _OSMAND_CORE_ROAD_ROUTER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include <QAtomicInt>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "RoadRouter.h"
+#include "RoadGraph.h"
+
+namespace OsmAnd
+{
+    class RoadBlockGraphsCache;
+
+    class RoadRouter;
+    class RoadRouter_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadRouter_P);
+
+    public:
+        typedef RoadRouter::Route Route;
+        typedef RoadRouter::RouteSegment RouteSegment;
+        typedef RoadRouter::Statistics Statistics;
+
+        // Maximal distance from start or finish to the road they are attached to
+        static const double AttachRadiusInMeters;
+        // Plain graph search of travel times gives up on targets not reached within this many times of time
+        // needed to go straight to the farthest of them at maximal speed
+        static const float TravelTimeCutoffFactor;
+
+    private:
+        struct HeapEntry
+        {
+            float key;
+            int edge;
+        };
+
+        // State of search in one direction. Search is edge-based, so that a junction is entered once per incoming
+        // edge and turn restrictions can be obeyed: arrays are indexed by dense edge index of the graph. Forward
+        // time of an edge is time to arrive at its target through it, backward time is time to reach finish from
+        // its source through it. Outdated heap entries are not removed, but skipped when popped
+        struct SearchState
+        {
+            QVector<float> times;
+            QVector<int> parentEdges;
+            QVector<bool> settled;
+            QVector<HeapEntry> heap;
+            QVector<int> touchedEdges;
+
+            void resize(const int edgesCount);
+            // Prepares state for next search over the same graph, touching only edges reached by previous one
+            void reset();
+            void push(const int edge, const float time, const float key, const int parentEdge);
+            bool purgeTop();
+            size_t getMemoryUsage() const;
+        };
+
+        bool _useContractionHierarchy;
+        // Block graphs are built once and shared by all searches of this router
+        std::shared_ptr<RoadBlockGraphsCache> _blockGraphsCache;
+
+        static bool heapEntryComparator(const HeapEntry& l, const HeapEntry& r);
+        // Time to go directly from start to finish when both are attached to the same segment, or infinity
+        static float computeDirectTime(
+            const RoadGraph& graph,
+            const RoadGraph::Attachment& startAttachment,
+            const RoadGraph::Attachment& finishAttachment);
+        // Fills rows of sources taken from shared counter, using own graph
+        void computeTravelTimesInGraph(
+            const QVector<PointI>& sources31,
+            const QVector<PointI>& targets31,
+            QAtomicInt& nextSource,
+            float* const pTimes,
+            ObfRoutingSectionReader::DataBlocksCache* const cache,
+            const IQueryController* const controller) const;
+        // Returns false if hierarchy can't be used for these points, then plain graph has to be searched
+        bool computeTravelTimesInContractionHierarchy(
+            const QVector<PointI>& sources31,
+            const QVector<PointI>& targets31,
+            QVector<float>& outTimes,
+            ObfRoutingSectionReader::DataBlocksCache* const cache,
+            const unsigned int threadsCount,
+            const IQueryController* const controller) const;
+        // Returns false if hierarchy can't be used for these attachments, then plain graph has to be searched
+        bool findRouteInContractionHierarchy(
+            const RoadGraph& graph,
+            const RoadGraph::Attachment& startAttachment,
+            const RoadGraph::Attachment& finishAttachment,
+            Route& outRoute,
+            bool& outFound,
+            Statistics* const outStatistics,
+            const IQueryController* const controller) const;
+        static void appendSegment(
+            QList<RouteSegment>& segments,
+            const std::shared_ptr<const Road>& road,
+            const int startPointIndex,
+            const int endPointIndex);
+        void buildRoute(
+            const RoadGraph& graph,
+            const RoadGraph::Attachment& startAttachment,
+            const RoadGraph::Attachment& finishAttachment,
+            const SearchState& forward,
+            const SearchState& backward,
+            const int meetingForwardEdge,
+            const int meetingBackwardEdge,
+            const float time,
+            Route& outRoute) const;
+    protected:
+        RoadRouter_P(RoadRouter* const owner);
+
+        void initialize();
+    public:
+        ~RoadRouter_P();
+
+        ImplementationInterface<RoadRouter> owner;
+
+        bool isUsingContractionHierarchy() const;
+
+        bool findRoute(
+            const PointI start31,
+            const PointI finish31,
+            Route& outRoute,
+            Statistics* const outStatistics,
+            const IQueryController* const controller) const;
+        bool computeTravelTimes(
+            const QVector<PointI>& sources31,
+            const QVector<PointI>& targets31,
+            QVector<float>& outTimes,
+            const unsigned int threadsCount,
+            const IQueryController* const controller) const;
+
+    friend class OsmAnd::RoadRouter;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_ROUTER_P_H_)
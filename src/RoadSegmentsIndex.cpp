@@ -0,0 +1,280 @@
+#include "RoadSegmentsIndex.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QtMath>
+#include "restore_internal_warnings.h"
+
+#include "Road.h"
+
+namespace
+{
+    // Same scale factors as used by Utilities::squareDistance31()
+    const float X31ToMeters = 0.011f;
+    const float Y31ToMeters = 0.01863f;
+}
+
+OsmAnd::RoadSegmentsIndex::RoadSegmentsIndex(const QList< std::shared_ptr<const Road> >& roads, const PointI& origin31)
+    : _origin31(origin31)
+    , _roads(roads)
+    , _rootNodeIndex(-1)
+{
+    auto segmentsCount = 0;
+    for (const auto& road : constOf(_roads))
+        segmentsCount += qMax(road->points31.size() - 1, 0);
+    if (segmentsCount == 0)
+        return;
+
+    // Sort-Tile-Recursive: segments are sorted by X of their centers, split into vertical slices,
+    // and then sorted by Y of centers within each slice. Each NodeCapacity consecutive segments form a leaf
+    struct SegmentRef
+    {
+        PointF center;
+        int road;
+        int endPointIndex;
+    };
+    QVector<SegmentRef> segmentRefs;
+    segmentRefs.reserve(segmentsCount);
+    for (auto roadIdx = 0, roadsCount = _roads.size(); roadIdx < roadsCount; roadIdx++)
+    {
+        const auto& points31 = _roads[roadIdx]->points31;
+        for (auto pointIdx = 1, pointsCount = points31.size(); pointIdx < pointsCount; pointIdx++)
+        {
+            const auto p0 = toLocal(points31[pointIdx - 1]);
+            const auto p1 = toLocal(points31[pointIdx]);
+
+            SegmentRef segmentRef;
+            segmentRef.center = PointF((p0.x + p1.x) * 0.5f, (p0.y + p1.y) * 0.5f);
+            segmentRef.road = roadIdx;
+            segmentRef.endPointIndex = pointIdx;
+            segmentRefs.push_back(segmentRef);
+        }
+    }
+
+    const auto leavesCount = (segmentsCount + NodeCapacity - 1) / NodeCapacity;
+    const auto slicesCount = static_cast<int>(qCeil(qSqrt(leavesCount)));
+    const auto sliceSize = slicesCount * NodeCapacity;
+    std::sort(segmentRefs.begin(), segmentRefs.end(),
+        []
+        (const SegmentRef& l, const SegmentRef& r) -> bool
+        {
+            return l.center.x < r.center.x;
+        });
+    for (auto sliceStart = 0; sliceStart < segmentsCount; sliceStart += sliceSize)
+    {
+        std::sort(segmentRefs.begin() + sliceStart, segmentRefs.begin() + qMin(sliceStart + sliceSize, segmentsCount),
+            []
+            (const SegmentRef& l, const SegmentRef& r) -> bool
+            {
+                return l.center.y < r.center.y;
+            });
+    }
+
+    _x0.resize(segmentsCount);
+    _y0.resize(segmentsCount);
+    _x1.resize(segmentsCount);
+    _y1.resize(segmentsCount);
+    _segmentRoad.resize(segmentsCount);
+    _segmentEndPointIndex.resize(segmentsCount);
+    for (auto segmentIdx = 0; segmentIdx < segmentsCount; segmentIdx++)
+    {
+        const auto& segmentRef = segmentRefs[segmentIdx];
+        const auto& points31 = _roads[segmentRef.road]->points31;
+        const auto p0 = toLocal(points31[segmentRef.endPointIndex - 1]);
+        const auto p1 = toLocal(points31[segmentRef.endPointIndex]);
+
+        _x0[segmentIdx] = p0.x;
+        _y0[segmentIdx] = p0.y;
+        _x1[segmentIdx] = p1.x;
+        _y1[segmentIdx] = p1.y;
+        _segmentRoad[segmentIdx] = segmentRef.road;
+        _segmentEndPointIndex[segmentIdx] = segmentRef.endPointIndex;
+    }
+
+    // Leaves
+    _nodes.reserve(leavesCount * 2);
+    for (auto firstSegment = 0; firstSegment < segmentsCount; firstSegment += NodeCapacity)
+    {
+        Node node;
+        node.firstEntry = firstSegment;
+        node.entriesCount = qMin(static_cast<int>(NodeCapacity), segmentsCount - firstSegment);
+        node.isLeaf = true;
+        node.bbox.top() = node.bbox.left() = std::numeric_limits<float>::max();
+        node.bbox.bottom() = node.bbox.right() = -std::numeric_limits<float>::max();
+        for (auto segmentIdx = firstSegment; segmentIdx < firstSegment + node.entriesCount; segmentIdx++)
+        {
+            node.bbox.enlargeToInclude(PointF(_x0[segmentIdx], _y0[segmentIdx]));
+            node.bbox.enlargeToInclude(PointF(_x1[segmentIdx], _y1[segmentIdx]));
+        }
+        _nodes.push_back(node);
+    }
+
+    // Upper levels are built from consecutive nodes of level below, since STR order is preserved
+    auto levelStart = 0;
+    auto levelSize = _nodes.size();
+    while (levelSize > 1)
+    {
+        const auto nextLevelStart = _nodes.size();
+        for (auto firstChild = levelStart; firstChild < levelStart + levelSize; firstChild += NodeCapacity)
+        {
+            Node node;
+            node.firstEntry = firstChild;
+            node.entriesCount = qMin(static_cast<int>(NodeCapacity), levelStart + levelSize - firstChild);
+            node.isLeaf = false;
+            node.bbox = _nodes[firstChild].bbox;
+            for (auto childIdx = firstChild + 1; childIdx < firstChild + node.entriesCount; childIdx++)
+                node.bbox.enlargeToInclude(_nodes[childIdx].bbox);
+            _nodes.push_back(node);
+        }
+        levelStart = nextLevelStart;
+        levelSize = _nodes.size() - nextLevelStart;
+    }
+    _rootNodeIndex = _nodes.size() - 1;
+}
+
+OsmAnd::RoadSegmentsIndex::~RoadSegmentsIndex()
+{
+}
+
+OsmAnd::PointF OsmAnd::RoadSegmentsIndex::toLocal(const PointI& point31) const
+{
+    return PointF(
+        static_cast<float>(static_cast<int64_t>(point31.x) - _origin31.x) * X31ToMeters,
+        static_cast<float>(static_cast<int64_t>(point31.y) - _origin31.y) * Y31ToMeters);
+}
+
+void OsmAnd::RoadSegmentsIndex::computeSquareDistances(
+    const int firstSegment,
+    const int segmentsCount,
+    const PointF& point,
+    float* const outSquareDistances,
+    float* const outFactors) const
+{
+    const auto pX0 = _x0.constData() + firstSegment;
+    const auto pY0 = _y0.constData() + firstSegment;
+    const auto pX1 = _x1.constData() + firstSegment;
+    const auto pY1 = _y1.constData() + firstSegment;
+    const auto px = point.x;
+    const auto py = point.y;
+
+    // Branch-free body over plain arrays, so that it's vectorized by compiler
+    for (auto idx = 0; idx < segmentsCount; idx++)
+    {
+        const auto dx = pX1[idx] - pX0[idx];
+        const auto dy = pY1[idx] - pY0[idx];
+        const auto wx = px - pX0[idx];
+        const auto wy = py - pY0[idx];
+        const auto lengthSq = dx * dx + dy * dy;
+        const auto dot = wx * dx + wy * dy;
+        auto factor = dot / (lengthSq > 0.0f ? lengthSq : 1.0f);
+        factor = factor < 0.0f ? 0.0f : (factor > 1.0f ? 1.0f : factor);
+        const auto ex = wx - factor * dx;
+        const auto ey = wy - factor * dy;
+
+        outSquareDistances[idx] = ex * ex + ey * ey;
+        outFactors[idx] = factor;
+    }
+}
+
+int OsmAnd::RoadSegmentsIndex::getSegmentsCount() const
+{
+    return _x0.size();
+}
+
+void OsmAnd::RoadSegmentsIndex::query(
+    const PointI& position31,
+    const double radiusInMeters,
+    QVector<Candidate>& outCandidates) const
+{
+    outCandidates.clear();
+    if (_rootNodeIndex < 0)
+        return;
+
+    const auto point = toLocal(position31);
+    const auto radius = static_cast<float>(radiusInMeters);
+    const auto radiusSq = radius * radius;
+    const AreaF queryBBox(point.y - radius, point.x - radius, point.y + radius, point.x + radius);
+
+    float squareDistances[NodeCapacity];
+    float factors[NodeCapacity];
+    int nodesStack[NodeCapacity * 8];
+    auto nodesStackSize = 0;
+    nodesStack[nodesStackSize++] = _rootNodeIndex;
+    while (nodesStackSize > 0)
+    {
+        const auto& node = _nodes[nodesStack[--nodesStackSize]];
+        if (!node.bbox.intersects(queryBBox))
+            continue;
+
+        if (!node.isLeaf)
+        {
+            for (auto childIdx = node.firstEntry; childIdx < node.firstEntry + node.entriesCount; childIdx++)
+                nodesStack[nodesStackSize++] = childIdx;
+            continue;
+        }
+
+        computeSquareDistances(node.firstEntry, node.entriesCount, point, squareDistances, factors);
+        for (auto idx = 0; idx < node.entriesCount; idx++)
+        {
+            if (squareDistances[idx] > radiusSq)
+                continue;
+
+            Candidate candidate;
+            candidate.segmentIndex = node.firstEntry + idx;
+            candidate.squareDistance = squareDistances[idx];
+            candidate.factor = factors[idx];
+            outCandidates.push_back(candidate);
+        }
+    }
+}
+
+void OsmAnd::RoadSegmentsIndex::queryNearest(
+    const PointI& position31,
+    const double radiusInMeters,
+    const int maxCandidates,
+    QVector<Candidate>& outCandidates) const
+{
+    query(position31, radiusInMeters, outCandidates);
+
+    const auto candidatesComparator =
+        []
+        (const Candidate& l, const Candidate& r) -> bool
+        {
+            return l.squareDistance < r.squareDistance;
+        };
+    if (maxCandidates > 0 && outCandidates.size() > maxCandidates)
+    {
+        std::partial_sort(outCandidates.begin(), outCandidates.begin() + maxCandidates, outCandidates.end(), candidatesComparator);
+        outCandidates.resize(maxCandidates);
+    }
+    else
+    {
+        std::sort(outCandidates.begin(), outCandidates.end(), candidatesComparator);
+    }
+}
+
+std::shared_ptr<const OsmAnd::Road> OsmAnd::RoadSegmentsIndex::getSegmentRoad(const int segmentIndex) const
+{
+    return _roads[_segmentRoad[segmentIndex]];
+}
+
+int OsmAnd::RoadSegmentsIndex::getSegmentEndPointIndex(const int segmentIndex) const
+{
+    return _segmentEndPointIndex[segmentIndex];
+}
+
+OsmAnd::PointI OsmAnd::RoadSegmentsIndex::getProjection31(const Candidate& candidate) const
+{
+    // Projection is computed from original 31-coordinates to avoid precision loss of local ones
+    const auto& points31 = _roads[_segmentRoad[candidate.segmentIndex]]->points31;
+    const auto endPointIndex = _segmentEndPointIndex[candidate.segmentIndex];
+    const auto& p0 = points31[endPointIndex - 1];
+    const auto& p1 = points31[endPointIndex];
+
+    return PointI(
+        p0.x + static_cast<int32_t>((static_cast<int64_t>(p1.x) - p0.x) * candidate.factor),
+        p0.y + static_cast<int32_t>((static_cast<int64_t>(p1.y) - p0.y) * candidate.factor));
+}
@@ -0,0 +1,93 @@
+#ifndef _OSMAND_CORE_ROAD_SEGMENTS_INDEX_H_
+#define _OSMAND_CORE_ROAD_SEGMENTS_INDEX_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PointsAndAreas.h"
+
+namespace OsmAnd
+{
+    class Road;
+
+    // Packed R-tree over segments of roads, bulk-loaded once (Sort-Tile-Recursive) and then only queried.
+    // Segments are kept in structure-of-arrays layout in metric coordinates relative to an origin,
+    // so that distances from a point to all segments of a leaf are computed by a single tight loop
+    // that compilers vectorize.
+    class RoadSegmentsIndex Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoadSegmentsIndex);
+
+    public:
+        enum {
+            NodeCapacity = 16,
+        };
+
+        struct Candidate
+        {
+            int segmentIndex;
+            float squareDistance;
+            // Position of projection along the segment, [0; 1]
+            float factor;
+        };
+
+    private:
+        struct Node
+        {
+            AreaF bbox;
+            // For leaf nodes it's index of first segment, otherwise index of first child node
+            int firstEntry;
+            int entriesCount;
+            bool isLeaf;
+        };
+
+        PointI _origin31;
+        QList< std::shared_ptr<const Road> > _roads;
+
+        QVector<float> _x0;
+        QVector<float> _y0;
+        QVector<float> _x1;
+        QVector<float> _y1;
+        QVector<int> _segmentRoad;
+        QVector<int> _segmentEndPointIndex;
+
+        QVector<Node> _nodes;
+        int _rootNodeIndex;
+
+        PointF toLocal(const PointI& point31) const;
+        void computeSquareDistances(
+            const int firstSegment,
+            const int segmentsCount,
+            const PointF& point,
+            float* const outSquareDistances,
+            float* const outFactors) const;
+    protected:
+    public:
+        RoadSegmentsIndex(const QList< std::shared_ptr<const Road> >& roads, const PointI& origin31);
+        ~RoadSegmentsIndex();
+
+        int getSegmentsCount() const;
+
+        // Collects all segments that are not farther than radius from given point
+        void query(const PointI& position31, const double radiusInMeters, QVector<Candidate>& outCandidates) const;
+        // Collects at most maxCandidates nearest segments that are not farther than radius, nearest first
+        void queryNearest(
+            const PointI& position31,
+            const double radiusInMeters,
+            const int maxCandidates,
+            QVector<Candidate>& outCandidates) const;
+
+        std::shared_ptr<const Road> getSegmentRoad(const int segmentIndex) const;
+        int getSegmentEndPointIndex(const int segmentIndex) const;
+        PointI getProjection31(const Candidate& candidate) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ROAD_SEGMENTS_INDEX_H_)
@@ -1,6 +1,8 @@
 #include "RoutingConfiguration.h"
 #include "RoutingConfiguration_private.h"
 
+#include <cassert>
+
 #include <OsmAndCore/QtExtensions.h>
 #include <QByteArray>
 #include <QBuffer>
@@ -8,7 +10,7 @@
 #include <QStringList>
 
 #include "Common.h"
-#include "EmbeddedResources.h"
+#include "ICoreResourcesProvider.h"
 #include "Utilities.h"
 #include "Logging.h"
 #include "LoggingAssert.h"
@@ -152,16 +154,22 @@ void OsmAnd::RoutingConfiguration::parseRoutingParameter( QXmlStreamReader* xmlP
     }
 }
 
-void OsmAnd::RoutingConfiguration::loadDefault( RoutingConfiguration& outConfig )
+bool OsmAnd::RoutingConfiguration::loadDefault( RoutingConfiguration& outConfig )
 {
-    auto rawDefaultConfig = EmbeddedResources::decompressResource("routing.xml");
+    auto rawDefaultConfig = getCoreResourcesProvider()->getResource(QLatin1String("routing/routing.xml"));
+    if (rawDefaultConfig.isEmpty())
+    {
+        LogPrintf(LogSeverityLevel::Error, "Default routing configuration is not available");
+        return false;
+    }
+
     QBuffer defaultConfig(&rawDefaultConfig);
-    bool ok = false;
-    ok = defaultConfig.open(QIODevice::ReadOnly | QIODevice::Text);
-    assert(ok);
-    ok = parseConfiguration(&defaultConfig, outConfig);
-    assert(ok);
+    if (!defaultConfig.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+    const auto ok = parseConfiguration(&defaultConfig, outConfig);
     defaultConfig.close();
+
+    return ok;
 }
 
 void OsmAnd::RoutingConfiguration::parseRoutingProfile( QXmlStreamReader* xmlParser, RoutingProfile* routingProfile )
@@ -271,9 +279,8 @@ QString OsmAnd::RoutingConfiguration::resolveAttribute( const QString& vehicle,
 
 bool OsmAnd::RoutingConfiguration::parseTypedValue( const QString& value, const QString& type, float& parsedValue )
 {
-    parsedValue;
     bool ok;
-    
+
     if (type == "speed")
         parsedValue = Utilities::parseSpeed(value, 0, &ok);
     else if (type == "weight")
@@ -9,6 +9,9 @@ OsmAnd::RoutingProfile::RoutingProfile()
     : _restrictionsAware(true)
     , _oneWayAware(true)
     , _followSpeedLimitations(true)
+    , _leftTurn(0.0f)
+    , _roundaboutTurn(0.0f)
+    , _rightTurn(0.0f)
     , _minDefaultSpeed(10)
     , _maxDefaultSpeed(10)
     , name(_name)
@@ -1,10 +1,13 @@
 #include "RoutingProfileContext.h"
 
-#include "ObfRoutingSectionInfo.h"
+#include <cassert>
+#include <algorithm>
+
 #include "Road.h"
 
 OsmAnd::RoutingProfileContext::RoutingProfileContext( const std::shared_ptr<RoutingProfile>& profile, QHash<QString, QString>* contextValues /*= nullptr*/ )
-    : profile(profile)
+    : _lastCompiledSection(nullptr)
+    , profile(profile)
 {
     for(auto type = 0; type < RoutingRuleset::TypesCount; type++)
     {
@@ -24,52 +27,130 @@ std::shared_ptr<OsmAnd::RoutingRulesetContext> OsmAnd::RoutingProfileContext::ge
     return _rulesetContexts[static_cast<int>(type)];
 }
 
-OsmAnd::Model::RoadDirection OsmAnd::RoutingProfileContext::getDirection( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+OsmAnd::RoutingProfileContext::CompiledSection& OsmAnd::RoutingProfileContext::getCompiledSection(
+    const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules )
 {
-    auto value = getRulesetContext(RoutingRuleset::OneWay)->evaluateAsInteger(road, 0);
-    return static_cast<Model::RoadDirection>(value);
+    // Consecutive roads almost always come from the same section
+    if (_lastCompiledSectionKey == encodingDecodingRules)
+        return *_lastCompiledSection;
+
+    auto itCompiledSection = _compiledSections.find(encodingDecodingRules);
+    if (itCompiledSection == _compiledSections.end())
+        itCompiledSection = _compiledSections.insert(encodingDecodingRules, std::shared_ptr<CompiledSection>(new CompiledSection()));
+
+    _lastCompiledSectionKey = encodingDecodingRules;
+    _lastCompiledSection = itCompiledSection->get();
+    return *_lastCompiledSection;
 }
 
-bool OsmAnd::RoutingProfileContext::acceptsRoad( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+uint32_t OsmAnd::RoutingProfileContext::getAttributeId(
+    CompiledSection& compiledSection,
+    const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+    const uint32_t type )
 {
-    auto value = getRulesetContext(RoutingRuleset::Access)->evaluateAsInteger(road, 0);
-    return value >= 0;
+    if (compiledSection.attributeIds.size() <= static_cast<int>(type))
+    {
+        const auto oldSize = compiledSection.attributeIds.size();
+        compiledSection.attributeIds.resize(type + 1);
+        std::fill(compiledSection.attributeIds.begin() + oldSize, compiledSection.attributeIds.end(), -1);
+    }
+
+    auto& id = compiledSection.attributeIds[type];
+    if (id < 0)
+    {
+        const auto citDecodingRule = encodingDecodingRules->decodingRules.constFind(type);
+        assert(citDecodingRule != encodingDecodingRules->decodingRules.cend());
+
+        id = profile->registerTagValueAttribute(citDecodingRule->tag, citDecodingRule->value);
+    }
+
+    return static_cast<uint32_t>(id);
 }
 
-bool OsmAnd::RoutingProfileContext::acceptsBorderLinePoint( const std::shared_ptr<const ObfRoutingSectionInfo>& section, const std::shared_ptr<const ObfRoutingBorderLinePoint>& point )
+OsmAnd::RoutingProfileContext::CompiledRoadTypes OsmAnd::RoutingProfileContext::getCompiledRoadTypes( const std::shared_ptr<const Road>& road )
 {
-    auto value = getRulesetContext(RoutingRuleset::Access)->evaluateAsInteger(section, point->types, 0);
-    return value >= 0;
+    auto& compiledSection = getCompiledSection(road->encodingDecodingRules);
+
+    const auto citCompiledRoadTypes = compiledSection.roadTypes.constFind(road->typesRuleIds);
+    if (citCompiledRoadTypes != compiledSection.roadTypes.cend())
+        return *citCompiledRoadTypes;
+
+    // All rulesets share attributes of the same profile, so types are encoded only once
+    const auto types = _rulesetContexts[RoutingRuleset::Access]->encode(road->encodingDecodingRules, road->typesRuleIds);
+
+    CompiledRoadTypes compiledRoadTypes;
+    int intValue;
+    float floatValue;
+    compiledRoadTypes.accepted =
+        !_rulesetContexts[RoutingRuleset::Access]->evaluate(types, RoutingRuleExpression::ResultType::Integer, &intValue) ||
+        intValue >= 0;
+    compiledRoadTypes.direction =
+        _rulesetContexts[RoutingRuleset::OneWay]->evaluate(types, RoutingRuleExpression::ResultType::Integer, &intValue)
+        ? static_cast<RoadDirection>(intValue)
+        : RoadDirection::TwoWay;
+    compiledRoadTypes.speed =
+        _rulesetContexts[RoutingRuleset::RoadSpeed]->evaluate(types, RoutingRuleExpression::ResultType::Float, &floatValue)
+        ? floatValue
+        : profile->minDefaultSpeed;
+    compiledRoadTypes.speedPriority =
+        _rulesetContexts[RoutingRuleset::RoadPriorities]->evaluate(types, RoutingRuleExpression::ResultType::Float, &floatValue)
+        ? floatValue
+        : 1.0f;
+
+    compiledSection.roadTypes.insert(road->typesRuleIds, compiledRoadTypes);
+    return compiledRoadTypes;
 }
 
-float OsmAnd::RoutingProfileContext::getSpeedPriority( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+float OsmAnd::RoutingProfileContext::getCompiledObstaclesExtraTime(
+    const RoutingRuleset::Type rulesetType,
+    const std::shared_ptr<const Road>& road,
+    const uint32_t pointIndex )
 {
-    auto value = getRulesetContext(RoutingRuleset::RoadPriorities)->evaluateAsFloat(road, 1.0f);
-    return value;
+    const auto citPointTypes = road->pointsTypes.constFind(pointIndex);
+    if (citPointTypes == road->pointsTypes.cend())
+        return 0.0f;
+
+    auto& compiledSection = getCompiledSection(road->encodingDecodingRules);
+    auto& extraTimes = (rulesetType == RoutingRuleset::Obstacles)
+        ? compiledSection.obstaclesExtraTimes
+        : compiledSection.routingObstaclesExtraTimes;
+
+    auto itExtraTime = extraTimes.constFind(*citPointTypes);
+    if (itExtraTime == extraTimes.cend())
+    {
+        const auto value = getRulesetContext(rulesetType)->evaluateAsFloat(road->encodingDecodingRules, *citPointTypes, 0.0f);
+        itExtraTime = extraTimes.insert(*citPointTypes, value);
+    }
+
+    return *itExtraTime;
 }
 
-float OsmAnd::RoutingProfileContext::getSpeed( const std::shared_ptr<const OsmAnd::Model::Road>& road )
+OsmAnd::RoadDirection OsmAnd::RoutingProfileContext::getDirection( const std::shared_ptr<const Road>& road )
 {
-    auto value = getRulesetContext(RoutingRuleset::RoadSpeed)->evaluateAsFloat(road, profile->minDefaultSpeed);
-    return value;
+    return getCompiledRoadTypes(road).direction;
 }
 
-float OsmAnd::RoutingProfileContext::getObstaclesExtraTime( const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex )
+bool OsmAnd::RoutingProfileContext::acceptsRoad( const std::shared_ptr<const Road>& road )
 {
-    auto itPointTypes = road->pointsTypes.constFind(pointIndex);
-    if (itPointTypes == road->pointsTypes.cend())
-        return 0.0f;
+    return getCompiledRoadTypes(road).accepted;
+}
 
-    auto value = getRulesetContext(RoutingRuleset::Obstacles)->evaluateAsFloat(road->subsection->section, *itPointTypes, 0.0f);
-    return value;
+float OsmAnd::RoutingProfileContext::getSpeedPriority( const std::shared_ptr<const Road>& road )
+{
+    return getCompiledRoadTypes(road).speedPriority;
 }
 
-float OsmAnd::RoutingProfileContext::getRoutingObstaclesExtraTime( const std::shared_ptr<const OsmAnd::Model::Road>& road, uint32_t pointIndex )
+float OsmAnd::RoutingProfileContext::getSpeed( const std::shared_ptr<const Road>& road )
 {
-    auto itPointTypes = road->pointsTypes.constFind(pointIndex);
-    if (itPointTypes == road->pointsTypes.cend())
-        return 0.0f;
+    return getCompiledRoadTypes(road).speed;
+}
 
-    auto value = getRulesetContext(RoutingRuleset::RoutingObstacles)->evaluateAsFloat(road->subsection->section, *itPointTypes, 0.0f);
-    return value;
+float OsmAnd::RoutingProfileContext::getObstaclesExtraTime( const std::shared_ptr<const Road>& road, uint32_t pointIndex )
+{
+    return getCompiledObstaclesExtraTime(RoutingRuleset::Obstacles, road, pointIndex);
+}
+
+float OsmAnd::RoutingProfileContext::getRoutingObstaclesExtraTime( const std::shared_ptr<const Road>& road, uint32_t pointIndex )
+{
+    return getCompiledObstaclesExtraTime(RoutingRuleset::RoutingObstacles, road, pointIndex);
 }
@@ -3,8 +3,6 @@
 #include <cassert>
 
 #include "Road.h"
-#include "ObfRoutingSectionInfo.h"
-#include "ObfRoutingSectionInfo_P.h"
 #include "RoutingProfile.h"
 #include "RoutingProfileContext.h"
 
@@ -15,7 +13,7 @@ bool checkParameter(std::shared_ptr<OsmAnd::RoutingRuleExpression> rt,
         bool nott = false;
         if (p.startsWith("-")) {
             nott = true;
-            p = p.right(-1);
+            p = p.mid(1);
         }
         bool val = contextValues_.contains(p);
         if (nott && val) {
@@ -48,7 +46,7 @@ OsmAnd::RoutingRulesetContext::~RoutingRulesetContext()
 {
 }
 
-int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<const Model::Road>& road, int defaultValue )
+int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<const Road>& road, int defaultValue )
 {
     int result;
     if (!evaluate(road, RoutingRuleExpression::ResultType::Integer, &result))
@@ -56,7 +54,7 @@ int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<cons
     return result;
 }
 
-float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<const Model::Road>& road, float defaultValue )
+float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<const Road>& road, float defaultValue )
 {
     float result;
     if (!evaluate(road, RoutingRuleExpression::ResultType::Float, &result))
@@ -64,25 +62,31 @@ float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<cons
     return result;
 }
 
-int OsmAnd::RoutingRulesetContext::evaluateAsInteger( const std::shared_ptr<const ObfRoutingSectionInfo>& section, const QVector<uint32_t>& roadTypes, int defaultValue )
+int OsmAnd::RoutingRulesetContext::evaluateAsInteger(
+    const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+    const QVector<uint32_t>& roadTypes,
+    int defaultValue )
 {
     int result;
-    if (!evaluate(encode(section, roadTypes), RoutingRuleExpression::ResultType::Integer, &result))
+    if (!evaluate(encode(encodingDecodingRules, roadTypes), RoutingRuleExpression::ResultType::Integer, &result))
         return defaultValue;
     return result;
 }
 
-float OsmAnd::RoutingRulesetContext::evaluateAsFloat( const std::shared_ptr<const ObfRoutingSectionInfo>& section, const QVector<uint32_t>& roadTypes, float defaultValue )
+float OsmAnd::RoutingRulesetContext::evaluateAsFloat(
+    const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+    const QVector<uint32_t>& roadTypes,
+    float defaultValue )
 {
     float result;
-    if (!evaluate(encode(section, roadTypes), RoutingRuleExpression::ResultType::Float, &result))
+    if (!evaluate(encode(encodingDecodingRules, roadTypes), RoutingRuleExpression::ResultType::Float, &result))
         return defaultValue;
     return result;
 }
 
-bool OsmAnd::RoutingRulesetContext::evaluate( const std::shared_ptr<const Model::Road>& road, RoutingRuleExpression::ResultType type, void* result )
+bool OsmAnd::RoutingRulesetContext::evaluate( const std::shared_ptr<const Road>& road, RoutingRuleExpression::ResultType type, void* result )
 {
-    return evaluate(encode(road->subsection->section, road->types), type, result);
+    return evaluate(encode(road->encodingDecodingRules, road->typesRuleIds), type, result);
 }
 
 bool OsmAnd::RoutingRulesetContext::evaluate( const QBitArray& types, RoutingRuleExpression::ResultType type, void* result )
@@ -95,26 +99,16 @@ bool OsmAnd::RoutingRulesetContext::evaluate( const QBitArray& types, RoutingRul
     return false;
 }
 
-QBitArray OsmAnd::RoutingRulesetContext::encode( const std::shared_ptr<const ObfRoutingSectionInfo>& section, const QVector<uint32_t>& roadTypes )
+QBitArray OsmAnd::RoutingRulesetContext::encode(
+    const std::shared_ptr<const MapObject::EncodingDecodingRules>& encodingDecodingRules,
+    const QVector<uint32_t>& roadTypes )
 {
     QBitArray bitset(ruleset->owner->_universalRules.size());
-    
-    auto itTagValueAttribIdCache = owner->_tagValueAttribIdCache.find(section);
-    if (itTagValueAttribIdCache == owner->_tagValueAttribIdCache.end())
-        itTagValueAttribIdCache = owner->_tagValueAttribIdCache.insert(section, QMap<uint32_t, uint32_t>());
-    
+
+    auto& compiledSection = owner->getCompiledSection(encodingDecodingRules);
     for(const auto& type : constOf(roadTypes))
     {
-        auto itId = itTagValueAttribIdCache->find(type);
-        if (itId == itTagValueAttribIdCache->end())
-        {
-            const auto& encodingRule = section->_p->_encodingRules[type];
-            assert(encodingRule);
-
-            auto id = ruleset->owner->registerTagValueAttribute(encodingRule->_tag, encodingRule->_value);
-            itId = itTagValueAttribIdCache->insert(type, id);
-        }
-        auto id = *itId;
+        const auto id = owner->getAttributeId(compiledSection, encodingDecodingRules, type);
 
         if (bitset.size() <= id)
             bitset.resize(id + 1);
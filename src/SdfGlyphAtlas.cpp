@@ -0,0 +1,72 @@
+#include "SdfGlyphAtlas.h"
+#include "SdfGlyphAtlas_P.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkBitmap.h>
+#include "restore_internal_warnings.h"
+
+const float OsmAnd::SdfGlyphAtlas::GlyphSize = 32.0f;
+const int OsmAnd::SdfGlyphAtlas::Spread = 6;
+const int OsmAnd::SdfGlyphAtlas::PageSize = 512;
+// 16MB of A8 pages
+const int OsmAnd::SdfGlyphAtlas::DefaultMaxPagesCount = 64;
+
+OsmAnd::SdfGlyphAtlas::SdfGlyphAtlas(
+    const std::shared_ptr<const IFontsCollection>& fontsCollection_,
+    const int maxPagesCount_ /*= DefaultMaxPagesCount*/)
+    : _p(new SdfGlyphAtlas_P(this))
+    , fontsCollection(fontsCollection_)
+    , maxPagesCount(maxPagesCount_)
+{
+}
+
+OsmAnd::SdfGlyphAtlas::~SdfGlyphAtlas()
+{
+}
+
+std::shared_ptr<const OsmAnd::SdfGlyphAtlas::GlyphRun> OsmAnd::SdfGlyphAtlas::layoutText(
+    const QString& text,
+    const TextRasterizer::Style& style /*= TextRasterizer::Style()*/,
+    QVector<SkScalar>* const outGlyphWidths /*= nullptr*/,
+    float* const outExtraTopSpace /*= nullptr*/,
+    float* const outExtraBottomSpace /*= nullptr*/,
+    float* const outLineSpacing /*= nullptr*/) const
+{
+    return _p->layoutText(text, style, outGlyphWidths, outExtraTopSpace, outExtraBottomSpace, outLineSpacing);
+}
+
+int OsmAnd::SdfGlyphAtlas::getGlyphsCount() const
+{
+    return _p->getGlyphsCount();
+}
+
+int OsmAnd::SdfGlyphAtlas::getPagesCount() const
+{
+    return _p->getPagesCount();
+}
+
+size_t OsmAnd::SdfGlyphAtlas::getTextureMemoryUsage() const
+{
+    return _p->getTextureMemoryUsage();
+}
+
+OsmAnd::SdfGlyphAtlas::Page::Page(const QString& fontKey_)
+    : fontKey(fontKey_)
+    , bitmap(new SkBitmap())
+    , version(0)
+{
+}
+
+OsmAnd::SdfGlyphAtlas::Page::~Page()
+{
+}
+
+OsmAnd::SdfGlyphAtlas::GlyphRun::GlyphRun()
+    : scale(1.0f)
+    , haloRadius(0)
+{
+}
+
+OsmAnd::SdfGlyphAtlas::GlyphRun::~GlyphRun()
+{
+}
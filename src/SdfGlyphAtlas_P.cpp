@@ -0,0 +1,557 @@
+#include "SdfGlyphAtlas_P.h"
+#include "SdfGlyphAtlas.h"
+
+#include "stdlib_common.h"
+#include <cmath>
+#include <limits>
+
+#include "QtCommon.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkBitmapDevice.h>
+#include <SkCanvas.h>
+#include <SkTypeface.h>
+#include "restore_internal_warnings.h"
+
+#include "ICU.h"
+#include "Logging.h"
+
+OsmAnd::SdfGlyphAtlas_P::SdfGlyphAtlas_P(SdfGlyphAtlas* const owner_)
+    : owner(owner_)
+    , _glyphsCount(0)
+    , _pagesCount(0)
+    , _useCounter(0)
+{
+    _defaultPaint.setAntiAlias(true);
+    _defaultPaint.setTextEncoding(SkPaint::kUTF16_TextEncoding);
+    static_assert(sizeof(QChar) == 2, "If QChar is not 2 bytes, then encoding is not kUTF16_TextEncoding");
+}
+
+OsmAnd::SdfGlyphAtlas_P::~SdfGlyphAtlas_P()
+{
+}
+
+void OsmAnd::SdfGlyphAtlas_P::configurePaintForText(
+    SkPaint& paint,
+    QString& outFontKey,
+    const QString& text,
+    const bool bold,
+    const bool italic) const
+{
+    paint = _defaultPaint;
+
+    // Same font as TextRasterizer would use is picked, so that labels look the same in both modes
+    const auto fontName = owner->fontsCollection->findSuitableFont(text, bold, italic);
+    const auto typeface = fontName.isEmpty() ? nullptr : owner->fontsCollection->obtainTypeface(fontName);
+    if (fontName.isEmpty() || typeface == nullptr)
+    {
+        paint.setTypeface(nullptr);
+        if (bold)
+            paint.setFakeBoldText(true);
+    }
+    else
+    {
+        paint.setTypeface(typeface);
+        if ((typeface->style() & SkTypeface::kBold) != SkTypeface::kBold && bold)
+            paint.setFakeBoldText(true);
+    }
+
+    // Fake bold glyphs differ from regular ones, so they're kept apart
+    outFontKey = typeface ? fontName : QString();
+    if (paint.isFakeBoldText())
+        outFontKey += QLatin1String("#bold");
+}
+
+std::shared_ptr<OsmAnd::SdfGlyphAtlas_P::Font> OsmAnd::SdfGlyphAtlas_P::obtainFont(
+    const QString& fontKey,
+    const SkPaint& paint) const
+{
+    auto itFont = _fonts.find(fontKey);
+    if (itFont == _fonts.end())
+    {
+        const std::shared_ptr<Font> font(new Font());
+        font->key = fontKey;
+        font->paint = paint;
+        font->paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+        font->paint.setTextSize(SdfGlyphAtlas::GlyphSize);
+        font->paint.setColor(SK_ColorBLACK);
+        font->shelfTop = 0;
+        font->shelfHeight = 0;
+        font->shelfCursor = 0;
+        itFont = _fonts.insert(fontKey, font);
+    }
+    (*itFont)->lastUsed = ++_useCounter;
+
+    return *itFont;
+}
+
+void OsmAnd::SdfGlyphAtlas_P::releasePages(Font& font) const
+{
+    _pagesCount -= font.pages.size();
+    _glyphsCount -= font.glyphs.size();
+    font.pages.clear();
+    font.glyphs.clear();
+    font.shelfTop = 0;
+    font.shelfHeight = 0;
+    font.shelfCursor = 0;
+}
+
+void OsmAnd::SdfGlyphAtlas_P::enforcePagesLimit(Font& requestingFont) const
+{
+    // Glyphs can't be removed from pages one by one, so fonts are dropped as a whole, least recently used
+    // first. If the only font left is the one that needs a page, it starts over
+    while (_pagesCount >= owner->maxPagesCount)
+    {
+        auto itLeastRecentlyUsedFont = _fonts.end();
+        for (auto itFont = _fonts.begin(); itFont != _fonts.end(); ++itFont)
+        {
+            const auto& font = *itFont;
+            if (font.get() == &requestingFont || font->pages.isEmpty())
+                continue;
+            if (itLeastRecentlyUsedFont == _fonts.end() || font->lastUsed < (*itLeastRecentlyUsedFont)->lastUsed)
+                itLeastRecentlyUsedFont = itFont;
+        }
+
+        if (itLeastRecentlyUsedFont == _fonts.end())
+        {
+            releasePages(requestingFont);
+            break;
+        }
+        releasePages(**itLeastRecentlyUsedFont);
+        _fonts.erase(itLeastRecentlyUsedFont);
+    }
+}
+
+bool OsmAnd::SdfGlyphAtlas_P::allocateField(
+    Font& font,
+    const PointI& size,
+    int& outPageIndex,
+    PointI& outTopLeft) const
+{
+    // One texel gap keeps linear filtering from picking neighbour glyph
+    const auto cellWidth = size.x + 1;
+    const auto cellHeight = size.y + 1;
+    if (cellWidth > SdfGlyphAtlas::PageSize || cellHeight > SdfGlyphAtlas::PageSize)
+        return false;
+
+    if (!font.pages.isEmpty() && font.shelfCursor + cellWidth > SdfGlyphAtlas::PageSize)
+    {
+        font.shelfTop += font.shelfHeight;
+        font.shelfHeight = 0;
+        font.shelfCursor = 0;
+    }
+    if (font.pages.isEmpty() || font.shelfTop + cellHeight > SdfGlyphAtlas::PageSize)
+    {
+        enforcePagesLimit(font);
+
+        const std::shared_ptr<Page> page(new Page(font.key));
+        if (!page->bitmap->tryAllocPixels(SkImageInfo::MakeA8(SdfGlyphAtlas::PageSize, SdfGlyphAtlas::PageSize)))
+        {
+            LogPrintf(LogSeverityLevel::Error,
+                "Failed to allocate SDF glyphs page of size %dx%d",
+                SdfGlyphAtlas::PageSize,
+                SdfGlyphAtlas::PageSize);
+            return false;
+        }
+        page->bitmap->eraseColor(SK_ColorTRANSPARENT);
+
+        font.pages.push_back(page);
+        font.shelfTop = 0;
+        font.shelfHeight = 0;
+        font.shelfCursor = 0;
+        _pagesCount++;
+    }
+
+    outPageIndex = font.pages.size() - 1;
+    outTopLeft = PointI(font.shelfCursor, font.shelfTop);
+    font.shelfCursor += cellWidth;
+    font.shelfHeight = qMax(font.shelfHeight, cellHeight);
+    return true;
+}
+
+const OsmAnd::SdfGlyphAtlas_P::Glyph* OsmAnd::SdfGlyphAtlas_P::obtainGlyph(Font& font, const uint16_t glyphId) const
+{
+    const auto citGlyph = font.glyphs.constFind(glyphId);
+    if (citGlyph != font.glyphs.cend())
+        return &(*citGlyph);
+
+    Glyph glyph;
+    glyph.pageIndex = -1;
+
+    SkScalar advance;
+    SkRect bounds;
+    font.paint.getTextWidths(&glyphId, sizeof(uint16_t), &advance, &bounds);
+    if (!bounds.isEmpty())
+    {
+        const auto spread = SdfGlyphAtlas::Spread;
+        glyph.fieldOrigin = PointI(qFloor(bounds.left()) - spread, qFloor(bounds.top()) - spread);
+        const PointI fieldSize(
+            qCeil(bounds.right()) + spread - glyph.fieldOrigin.x,
+            qCeil(bounds.bottom()) + spread - glyph.fieldOrigin.y);
+
+        SkBitmap coverage;
+        if (!coverage.tryAllocPixels(SkImageInfo::MakeA8(fieldSize.x, fieldSize.y)))
+            return nullptr;
+        coverage.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkBitmapDevice target(coverage);
+            SkCanvas canvas(&target);
+            canvas.drawText(&glyphId, sizeof(uint16_t), -glyph.fieldOrigin.x, -glyph.fieldOrigin.y, font.paint);
+            canvas.flush();
+        }
+
+        QVector<uint8_t> field;
+        computeDistanceField(coverage, field);
+
+        PointI topLeft;
+        if (!allocateField(font, fieldSize, glyph.pageIndex, topLeft))
+            return nullptr;
+        glyph.texels = AreaI(topLeft, topLeft + fieldSize);
+
+        const auto& page = font.pages[glyph.pageIndex];
+        {
+            QWriteLocker scopedLocker(&page->lock);
+
+            for (auto y = 0; y < fieldSize.y; y++)
+            {
+                memcpy(
+                    page->bitmap->getAddr8(topLeft.x, topLeft.y + y),
+                    field.constData() + y * fieldSize.x,
+                    fieldSize.x);
+            }
+            page->version++;
+        }
+    }
+
+    _glyphsCount++;
+    return &(*font.glyphs.insert(glyphId, glyph));
+}
+
+void OsmAnd::SdfGlyphAtlas_P::transformDistances1D(
+    const float* const f,
+    float* const d,
+    int* const v,
+    float* const z,
+    const int n)
+{
+    // Lower envelope of parabolas rooted at samples (Felzenszwalb & Huttenlocher)
+    auto k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<float>::infinity();
+    z[1] = std::numeric_limits<float>::infinity();
+    for (auto q = 1; q < n; q++)
+    {
+        float s;
+        do
+        {
+            const auto r = v[k];
+            s = ((f[q] + q * q) - (f[r] + r * r)) / (2.0f * (q - r));
+        } while (s <= z[k] && --k >= 0);
+
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = std::numeric_limits<float>::infinity();
+    }
+
+    k = 0;
+    for (auto q = 0; q < n; q++)
+    {
+        while (z[k + 1] < q)
+            k++;
+        const auto r = v[k];
+        d[q] = (q - r) * (q - r) + f[r];
+    }
+}
+
+void OsmAnd::SdfGlyphAtlas_P::computeDistanceField(const SkBitmap& coverage, QVector<uint8_t>& outField)
+{
+    const auto width = coverage.width();
+    const auto height = coverage.height();
+    const auto length = qMax(width, height);
+    // Large enough to dominate any squared distance within field, yet finite for arithmetic above
+    const auto far = static_cast<float>(4 * length * length);
+
+    // Squared distances to nearest texel inside outline and to nearest texel outside of it
+    QVector<float> toInside(width * height);
+    QVector<float> toOutside(width * height);
+    for (auto y = 0; y < height; y++)
+    {
+        const auto pCoverage = coverage.getAddr8(0, y);
+        for (auto x = 0; x < width; x++)
+        {
+            const auto isInside = (pCoverage[x] >= 128);
+            toInside[y * width + x] = isInside ? 0.0f : far;
+            toOutside[y * width + x] = isInside ? far : 0.0f;
+        }
+    }
+
+    QVector<float> f(length);
+    QVector<float> d(length);
+    QVector<int> v(length);
+    QVector<float> z(length + 1);
+    for (auto pGrid : { &toInside, &toOutside })
+    {
+        auto& grid = *pGrid;
+        for (auto x = 0; x < width; x++)
+        {
+            for (auto y = 0; y < height; y++)
+                f[y] = grid[y * width + x];
+            transformDistances1D(f.constData(), d.data(), v.data(), z.data(), height);
+            for (auto y = 0; y < height; y++)
+                grid[y * width + x] = d[y];
+        }
+        for (auto y = 0; y < height; y++)
+        {
+            transformDistances1D(grid.constData() + y * width, d.data(), v.data(), z.data(), width);
+            memcpy(grid.data() + y * width, d.constData(), width * sizeof(float));
+        }
+    }
+
+    // Distances are measured between texel centers, while outline passes half a texel away from them
+    outField.resize(width * height);
+    const auto range = 2.0f * SdfGlyphAtlas::Spread;
+    for (auto idx = 0; idx < width * height; idx++)
+    {
+        const auto signedDistance = (toInside[idx] > 0.0f)
+            ? std::sqrt(toInside[idx]) - 0.5f
+            : 0.5f - std::sqrt(toOutside[idx]);
+        const auto value = qBound(0.0f, 0.5f - signedDistance / range, 1.0f);
+        outField[idx] = static_cast<uint8_t>(qRound(value * 255.0f));
+    }
+}
+
+std::shared_ptr<const OsmAnd::SdfGlyphAtlas_P::GlyphRun> OsmAnd::SdfGlyphAtlas_P::layoutText(
+    const QString& text_,
+    const TextRasterizer::Style& style,
+    QVector<SkScalar>* const outGlyphWidths,
+    float* const outExtraTopSpace,
+    float* const outExtraBottomSpace,
+    float* const outLineSpacing) const
+{
+    // Labels with shields are composed with a bitmap. Halo can't extend beyond field around glyph outline
+    if (style.backgroundBitmap)
+        return nullptr;
+    const auto scale = style.size / SdfGlyphAtlas::GlyphSize;
+    if (style.haloRadius > SdfGlyphAtlas::Spread * scale)
+        return nullptr;
+
+    const auto text = ICU::convertToVisualOrder(text_);
+    const auto lineRefs =
+        style.wrapWidth > 0
+        ? ICU::getTextWrappingRefs(text, style.wrapWidth)
+        : (QVector<QStringRef>() << QStringRef(&text));
+    const auto& linesCount = lineRefs.size();
+
+    SkPaint paint;
+    QString fontKey;
+    configurePaintForText(paint, fontKey, text, style.bold, style.italic);
+    paint.setTextSize(style.size);
+
+    // Metrics and line placement below follow TextRasterizer, so that label occupies the same area
+    SkPaint::FontMetrics fontMetrics;
+    paint.getFontMetrics(&fontMetrics);
+    auto lineSpacing = fontMetrics.fLeading;
+    auto fontMaxTop = -fontMetrics.fTop;
+    auto fontMaxBottom = fontMetrics.fBottom;
+
+    SkScalar maxLineWidthInPixels = 0;
+    QVector<SkRect> linesBounds(linesCount);
+    auto pLineBounds = linesBounds.data();
+    for (const auto& lineRef : constOf(lineRefs))
+    {
+        auto& lineBounds = *(pLineBounds++);
+
+        paint.measureText(lineRef.constData(), lineRef.length()*sizeof(QChar), &lineBounds);
+        maxLineWidthInPixels = qMax(maxLineWidthInPixels, lineBounds.width());
+    }
+
+    if (outGlyphWidths)
+    {
+        // This is supported only for one-line text
+        assert(lineRefs.size() == 1);
+        const auto& lineRef = lineRefs.first();
+
+        const auto glyphsCount = paint.countText(lineRef.constData(), lineRef.length()*sizeof(QChar));
+        outGlyphWidths->resize(glyphsCount);
+        paint.getTextWidths(lineRef.constData(), lineRef.length()*sizeof(QChar), outGlyphWidths->data());
+    }
+
+    if (style.haloRadius > 0)
+    {
+        SkPaint haloPaint = paint;
+        haloPaint.setStyle(SkPaint::kStroke_Style);
+        haloPaint.setStrokeWidth(style.haloRadius);
+
+        SkPaint::FontMetrics haloFontMetrics;
+        haloPaint.getFontMetrics(&haloFontMetrics);
+        lineSpacing = qMax(lineSpacing, haloFontMetrics.fLeading);
+        fontMaxTop = qMax(fontMaxTop, -haloFontMetrics.fTop);
+        fontMaxBottom = qMax(fontMaxBottom, haloFontMetrics.fBottom);
+
+        auto pLineBounds = linesBounds.data();
+        for (const auto& lineRef : constOf(lineRefs))
+        {
+            auto& lineBounds = *(pLineBounds++);
+
+            SkRect lineHaloBounds;
+            haloPaint.measureText(lineRef.constData(), lineRef.length()*sizeof(QChar), &lineHaloBounds);
+            maxLineWidthInPixels = qMax(maxLineWidthInPixels, lineHaloBounds.width());
+            lineBounds.join(lineHaloBounds);
+        }
+
+        if (outGlyphWidths)
+        {
+            const auto& lineRef = lineRefs.first();
+
+            haloPaint.getTextWidths(lineRef.constData(), lineRef.length()*sizeof(QChar), outGlyphWidths->data());
+        }
+    }
+
+    if (outLineSpacing)
+        *outLineSpacing = lineSpacing;
+    if (outExtraTopSpace)
+        *outExtraTopSpace = qMax(0.0f, fontMaxTop - (-linesBounds.first().fTop));
+    if (outExtraBottomSpace)
+        *outExtraBottomSpace = qMax(0.0f, fontMaxBottom - linesBounds.last().fBottom);
+    if (outGlyphWidths && !outGlyphWidths->isEmpty())
+        outGlyphWidths->first() += -linesBounds.first().left();
+
+    for (auto& lineBounds : linesBounds)
+    {
+        const auto widthDelta = maxLineWidthInPixels - lineBounds.width();
+
+        switch (style.textAlignment)
+        {
+            case TextRasterizer::Style::TextAlignment::Center:
+                lineBounds.offset(-widthDelta / 2.0f, 0);
+                break;
+
+            case TextRasterizer::Style::TextAlignment::Right:
+                lineBounds.offset(-widthDelta, 0);
+                break;
+
+            case TextRasterizer::Style::TextAlignment::Left:
+            default:
+                break;
+        }
+    }
+
+    // Pen position of each line is top-left corner of its normalized bounds
+    QVector<SkRect> linesNormalizedBounds(linesCount);
+    for (auto lineIdx = 0; lineIdx < linesCount; lineIdx++)
+    {
+        linesNormalizedBounds[lineIdx] = linesBounds[lineIdx];
+        linesNormalizedBounds[lineIdx].offset(-2.0f*linesBounds[lineIdx].left(), -2.0f*linesBounds[lineIdx].top());
+    }
+    auto textArea = linesNormalizedBounds.first();
+    auto linesHeightSum = textArea.height();
+    for (auto lineIdx = 1; lineIdx < linesCount; lineIdx++)
+    {
+        auto& lineNormalizedBounds = linesNormalizedBounds[lineIdx];
+        const auto& prevLineBounds = linesBounds[lineIdx - 1];
+        const auto& lineBounds = linesBounds[lineIdx];
+
+        const auto extraPrevGapHeight = qMax(0.0f, fontMaxBottom - prevLineBounds.fBottom);
+        const auto extraGapHeight = qMax(0.0f, fontMaxTop - (-lineBounds.fTop));
+        textArea.fBottom += extraPrevGapHeight + lineSpacing + extraGapHeight;
+        linesHeightSum += extraPrevGapHeight + lineSpacing + extraGapHeight;
+
+        lineNormalizedBounds.offset(0.0f, linesHeightSum);
+
+        const auto lineHeight = lineNormalizedBounds.height();
+        textArea.fBottom += lineHeight;
+        linesHeightSum += lineHeight;
+
+        textArea.fLeft = qMin(textArea.fLeft, lineNormalizedBounds.fLeft);
+        textArea.fRight = qMax(textArea.fRight, lineNormalizedBounds.fRight);
+    }
+
+    const std::shared_ptr<GlyphRun> glyphRun(new GlyphRun());
+    glyphRun->size = PointI(qCeil(textArea.width()), qCeil(textArea.height()));
+    glyphRun->scale = scale;
+    glyphRun->color = style.color;
+    glyphRun->haloColor = style.haloColor;
+    glyphRun->haloRadius = style.haloRadius;
+    if (glyphRun->size.x <= 0 || glyphRun->size.y <= 0)
+    {
+        LogPrintf(LogSeverityLevel::Error,
+            "Failed to lay out text '%s': resulting size %dx%d is invalid",
+            qPrintable(text),
+            glyphRun->size.x,
+            glyphRun->size.y);
+        return nullptr;
+    }
+
+    QMutexLocker scopedLocker(&_fontsMutex);
+
+    const auto font = obtainFont(fontKey, paint);
+    // Font may be dropped and start over while text is laid out, so pages of run are keyed by page itself
+    QHash<const Page*, int> runPageIndices;
+    auto glyphIndex = 0;
+    for (auto lineIdx = 0; lineIdx < linesCount; lineIdx++)
+    {
+        const auto& lineRef = lineRefs[lineIdx];
+        const auto lineByteLength = lineRef.length()*sizeof(QChar);
+
+        const auto glyphsCount = paint.countText(lineRef.constData(), lineByteLength);
+        QVector<uint16_t> glyphIds(glyphsCount);
+        QVector<SkScalar> advances(glyphsCount);
+        paint.textToGlyphs(lineRef.constData(), lineByteLength, glyphIds.data());
+        paint.getTextWidths(lineRef.constData(), lineByteLength, advances.data());
+
+        auto penX = linesNormalizedBounds[lineIdx].left();
+        const auto penY = linesNormalizedBounds[lineIdx].top();
+        for (auto idx = 0; idx < glyphsCount; idx++, glyphIndex++)
+        {
+            const auto glyph = obtainGlyph(*font, glyphIds[idx]);
+            if (glyph && glyph->pageIndex >= 0)
+            {
+                const auto& page = font->pages[glyph->pageIndex];
+                auto itRunPageIndex = runPageIndices.find(page.get());
+                if (itRunPageIndex == runPageIndices.end())
+                {
+                    itRunPageIndex = runPageIndices.insert(page.get(), glyphRun->pages.size());
+                    glyphRun->pages.push_back(page);
+                }
+
+                GlyphQuad quad;
+                quad.pageIndex = *itRunPageIndex;
+                quad.glyphIndex = glyphIndex;
+                quad.texels = glyph->texels;
+                quad.area.left() = penX + glyph->fieldOrigin.x * glyphRun->scale;
+                quad.area.top() = penY + glyph->fieldOrigin.y * glyphRun->scale;
+                quad.area.right() = quad.area.left() + glyph->texels.width() * glyphRun->scale;
+                quad.area.bottom() = quad.area.top() + glyph->texels.height() * glyphRun->scale;
+                glyphRun->quads.push_back(quad);
+            }
+
+            penX += advances[idx];
+        }
+    }
+
+    return glyphRun;
+}
+
+int OsmAnd::SdfGlyphAtlas_P::getGlyphsCount() const
+{
+    QMutexLocker scopedLocker(&_fontsMutex);
+
+    return _glyphsCount;
+}
+
+int OsmAnd::SdfGlyphAtlas_P::getPagesCount() const
+{
+    QMutexLocker scopedLocker(&_fontsMutex);
+
+    return _pagesCount;
+}
+
+size_t OsmAnd::SdfGlyphAtlas_P::getTextureMemoryUsage() const
+{
+    QMutexLocker scopedLocker(&_fontsMutex);
+
+    return static_cast<size_t>(_pagesCount) * SdfGlyphAtlas::PageSize * SdfGlyphAtlas::PageSize;
+}
@@ -0,0 +1,112 @@
+#ifndef _OSMAND_CORE_SDF_GLYPH_ATLAS_P_H_
+#define _OSMAND_CORE_SDF_GLYPH_ATLAS_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "ignore_warnings_on_external_includes.h"
+#include <SkPaint.h>
+#include <SkBitmap.h>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "SdfGlyphAtlas.h"
+
+namespace OsmAnd
+{
+    class SdfGlyphAtlas;
+    class SdfGlyphAtlas_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(SdfGlyphAtlas_P);
+
+    public:
+        typedef SdfGlyphAtlas::Page Page;
+        typedef SdfGlyphAtlas::GlyphQuad GlyphQuad;
+        typedef SdfGlyphAtlas::GlyphRun GlyphRun;
+
+    private:
+        struct Glyph
+        {
+            // Index of page in font
+            int pageIndex;
+            // Field of glyph on page, empty for glyphs without outline
+            AreaI texels;
+            // Top-left corner of field relative to pen position on baseline, at GlyphSize
+            PointI fieldOrigin;
+        };
+
+        // Glyphs of the same typeface rendered the same way share pages. Pages are filled by shelves:
+        // glyphs are placed left to right, new shelf is started below the tallest glyph of current one
+        struct Font
+        {
+            QString key;
+            SkPaint paint;
+            QVector< std::shared_ptr<Page> > pages;
+            QHash<uint16_t, Glyph> glyphs;
+            int shelfTop;
+            int shelfHeight;
+            int shelfCursor;
+            // Value of use counter when font was last used to lay text out
+            uint64_t lastUsed;
+        };
+
+        SkPaint _defaultPaint;
+
+        mutable QMutex _fontsMutex;
+        mutable QHash< QString, std::shared_ptr<Font> > _fonts;
+        mutable int _glyphsCount;
+        mutable int _pagesCount;
+        mutable uint64_t _useCounter;
+
+        void configurePaintForText(
+            SkPaint& paint,
+            QString& outFontKey,
+            const QString& text,
+            const bool bold,
+            const bool italic) const;
+        std::shared_ptr<Font> obtainFont(const QString& fontKey, const SkPaint& paint) const;
+        const Glyph* obtainGlyph(Font& font, const uint16_t glyphId) const;
+        bool allocateField(Font& font, const PointI& size, int& outPageIndex, PointI& outTopLeft) const;
+        void releasePages(Font& font) const;
+        void enforcePagesLimit(Font& requestingFont) const;
+
+        static void computeDistanceField(const SkBitmap& coverage, QVector<uint8_t>& outField);
+        static void transformDistances1D(
+            const float* const f,
+            float* const d,
+            int* const v,
+            float* const z,
+            const int n);
+    protected:
+        SdfGlyphAtlas_P(SdfGlyphAtlas* const owner);
+    public:
+        ~SdfGlyphAtlas_P();
+
+        ImplementationInterface<SdfGlyphAtlas> owner;
+
+        std::shared_ptr<const GlyphRun> layoutText(
+            const QString& text,
+            const TextRasterizer::Style& style,
+            QVector<SkScalar>* const outGlyphWidths,
+            float* const outExtraTopSpace,
+            float* const outExtraBottomSpace,
+            float* const outLineSpacing) const;
+
+        int getGlyphsCount() const;
+        int getPagesCount() const;
+        size_t getTextureMemoryUsage() const;
+
+    friend class OsmAnd::SdfGlyphAtlas;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_SDF_GLYPH_ATLAS_P_H_)
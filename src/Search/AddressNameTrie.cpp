@@ -0,0 +1,480 @@
+#include "AddressNameTrie.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QFile>
+#include <QSet>
+#include "restore_internal_warnings.h"
+
+#include "ObfReader.h"
+#include "ObfInfo.h"
+#include "ObfAddressSectionInfo.h"
+#include "ObfAddressSectionReader.h"
+#include "StreetGroup.h"
+#include "Street.h"
+#include "Building.h"
+#include "IQueryController.h"
+#include "ICU.h"
+#include "FlatArraysIO.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+// 'OAFG' in native (little-endian) byte order
+const uint32_t OsmAnd::AddressNameTrie::Signature = 0x4746414F;
+const uint32_t OsmAnd::AddressNameTrie::Version = 1;
+const uint32_t OsmAnd::AddressNameTrie::NoParent = std::numeric_limits<uint32_t>::max();
+
+OsmAnd::AddressNameTrie::AddressNameTrie()
+{
+}
+
+OsmAnd::AddressNameTrie::~AddressNameTrie()
+{
+}
+
+QStringList OsmAnd::AddressNameTrie::normalizeAndSplit(const QString& name)
+{
+    const auto normalizedName = ICU::transliterateToLatin(name, false, false).toLower();
+
+    QStringList words;
+    auto wordStart = -1;
+    for (auto position = 0, length = normalizedName.length(); position <= length; position++)
+    {
+        const auto isWordCharacter = (position < length && normalizedName[position].isLetterOrNumber());
+        if (isWordCharacter && wordStart < 0)
+            wordStart = position;
+        else if (!isWordCharacter && wordStart >= 0)
+        {
+            words.push_back(normalizedName.mid(wordStart, position - wordStart));
+            wordStart = -1;
+        }
+    }
+
+    return words;
+}
+
+uint32_t OsmAnd::AddressNameTrie::addString(const QString& value)
+{
+    const uint32_t index = _stringsOffsets.size() - 1;
+    _stringsData.append(value.toUtf8());
+    _stringsOffsets.push_back(_stringsData.size());
+
+    return index;
+}
+
+bool OsmAnd::AddressNameTrie::build(const std::shared_ptr<const ObfReader>& obfReader, const IQueryController* const controller)
+{
+    _stringsData.clear();
+    _stringsOffsets.clear();
+    _stringsOffsets.push_back(0);
+    _records.clear();
+
+    // Postcode groups contain the same streets as settlements do, so they are skipped
+    QSet<ObfAddressBlockType> blockTypes;
+    blockTypes.insert(ObfAddressBlockType::CitiesOrTowns);
+    blockTypes.insert(ObfAddressBlockType::Villages);
+
+    QHash<QString, QVector<uint32_t> > wordsPostings;
+    const auto addRecord =
+        [this, &wordsPostings]
+        (const RecordType type, const PointI& position31, const uint32_t parent, const QString& name, const QStringList& otherNames) -> uint32_t
+        {
+            const uint32_t recordIndex = _records.size();
+            Record record;
+            record.type = type;
+            record.position31 = position31;
+            record.parent = parent;
+            record.name = addString(name);
+            _records.push_back(record);
+
+            for (const auto& word : constOf(normalizeAndSplit(name)))
+                wordsPostings[word].push_back(recordIndex);
+            for (const auto& otherName : constOf(otherNames))
+            {
+                if (otherName.isEmpty() || otherName == name)
+                    continue;
+                for (const auto& word : constOf(normalizeAndSplit(otherName)))
+                    wordsPostings[word].push_back(recordIndex);
+            }
+
+            return recordIndex;
+        };
+
+    const auto& obfInfo = obfReader->obtainInfo();
+    for (const auto& addressSection : constOf(obfInfo->addressSections))
+    {
+        QList< std::shared_ptr<const StreetGroup> > streetGroups;
+        ObfAddressSectionReader::loadStreetGroups(
+            obfReader,
+            addressSection,
+            &streetGroups,
+            nullptr,
+            controller,
+            &blockTypes);
+
+        for (const auto& streetGroup : constOf(streetGroups))
+        {
+            if (controller && controller->isAborted())
+                return false;
+
+            const auto settlementRecord = addRecord(
+                RecordType::Settlement,
+                Utilities::convertLatLonTo31(LatLon(streetGroup->_latitude, streetGroup->_longitude)),
+                NoParent,
+                streetGroup->_name,
+                QStringList() << streetGroup->_latinName);
+
+            QList< std::shared_ptr<const Street> > streets;
+            ObfAddressSectionReader::loadStreetsFromGroup(obfReader, streetGroup, &streets, nullptr, controller);
+            for (const auto& street : constOf(streets))
+            {
+                const auto streetRecord = addRecord(
+                    RecordType::Street,
+                    PointI(street->tile24.x << 7, street->tile24.y << 7),
+                    settlementRecord,
+                    street->name,
+                    QStringList() << street->latinName);
+
+                QList< std::shared_ptr<const Building> > buildings;
+                ObfAddressSectionReader::loadBuildingsFromStreet(obfReader, street, &buildings, nullptr, controller);
+                for (const auto& building : constOf(buildings))
+                {
+                    addRecord(
+                        RecordType::Building,
+                        PointI(building->_xTile24 << 7, building->_yTile24 << 7),
+                        streetRecord,
+                        building->_name,
+                        QStringList() << building->_latinName << building->_name2 << building->_latinName2);
+                }
+            }
+        }
+    }
+
+    // Words are sorted, so that words sharing a prefix are adjacent and their postings form a single range
+    QStringList words = wordsPostings.keys();
+    std::sort(words.begin(), words.end());
+    QVector<uint32_t> wordsPostingsBegins;
+    wordsPostingsBegins.reserve(words.size() + 1);
+    _postings.clear();
+    for (const auto& word : constOf(words))
+    {
+        wordsPostingsBegins.push_back(_postings.size());
+
+        auto& wordPostings = wordsPostings[word];
+        std::sort(wordPostings.begin(), wordPostings.end());
+        wordPostings.erase(std::unique(wordPostings.begin(), wordPostings.end()), wordPostings.end());
+        for (const auto posting : constOf(wordPostings))
+            _postings.push_back(posting);
+    }
+    wordsPostingsBegins.push_back(_postings.size());
+
+    _nodes.clear();
+    _nodes.resize(1);
+    _nodes[0].label = 0;
+    buildNodes(0, words, wordsPostingsBegins, 0, words.size(), 0);
+
+    _stringsData.squeeze();
+    _stringsOffsets.squeeze();
+    _records.squeeze();
+    _nodes.squeeze();
+    _postings.squeeze();
+
+    return true;
+}
+
+void OsmAnd::AddressNameTrie::buildNodes(
+    const int node,
+    const QStringList& words,
+    const QVector<uint32_t>& wordsPostingsBegins,
+    const int wordsBegin,
+    const int wordsEnd,
+    const int depth)
+{
+    // All words in range share prefix of given length, and the shortest one goes first
+    auto childrenWordsBegin = wordsBegin;
+    if (childrenWordsBegin < wordsEnd && words[childrenWordsBegin].length() == depth)
+        childrenWordsBegin++;
+
+    auto childrenCount = 0u;
+    for (auto wordIdx = childrenWordsBegin; wordIdx < wordsEnd; wordIdx++)
+    {
+        if (wordIdx == childrenWordsBegin || words[wordIdx][depth] != words[wordIdx - 1][depth])
+            childrenCount++;
+    }
+
+    const uint32_t firstChild = _nodes.size();
+    _nodes.resize(_nodes.size() + childrenCount);
+    {
+        auto& nodeRecord = _nodes[node];
+        nodeRecord.firstChild = firstChild;
+        nodeRecord.childrenCount = childrenCount;
+        nodeRecord.postingsBegin = wordsPostingsBegins[wordsBegin];
+        nodeRecord.ownPostingsEnd = wordsPostingsBegins[childrenWordsBegin];
+        nodeRecord.postingsEnd = wordsPostingsBegins[wordsEnd];
+    }
+
+    auto child = firstChild;
+    for (auto childWordsBegin = childrenWordsBegin; childWordsBegin < wordsEnd; child++)
+    {
+        const auto label = words[childWordsBegin][depth];
+        auto childWordsEnd = childWordsBegin + 1;
+        while (childWordsEnd < wordsEnd && words[childWordsEnd][depth] == label)
+            childWordsEnd++;
+
+        _nodes[child].label = label.unicode();
+        buildNodes(child, words, wordsPostingsBegins, childWordsBegin, childWordsEnd, depth + 1);
+
+        childWordsBegin = childWordsEnd;
+    }
+}
+
+bool OsmAnd::AddressNameTrie::load(const QString& filename, const uint64_t sourceFileSize, const int64_t sourceLastModified)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    FileHeader header;
+    if (!FlatArraysIO::read(file, header))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Address names index '%s' is truncated", qPrintable(filename));
+        return false;
+    }
+    if (header.signature != Signature || header.version != Version)
+    {
+        LogPrintf(LogSeverityLevel::Error, "'%s' is not an address names index of version %d", qPrintable(filename), Version);
+        return false;
+    }
+    if (header.sourceFileSize != sourceFileSize || header.sourceLastModified != sourceLastModified)
+    {
+        LogPrintf(LogSeverityLevel::Info, "Address names index '%s' is out of date", qPrintable(filename));
+        return false;
+    }
+
+    const auto expectedSize =
+        sizeof(FileHeader) +
+        (static_cast<uint64_t>(header.stringsCount) + 1) * sizeof(uint32_t) +
+        header.stringsDataSize +
+        static_cast<uint64_t>(header.recordsCount) * sizeof(Record) +
+        static_cast<uint64_t>(header.nodesCount) * sizeof(Node) +
+        static_cast<uint64_t>(header.postingsCount) * sizeof(uint32_t);
+    if (static_cast<uint64_t>(file.size()) != expectedSize || header.nodesCount == 0)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Address names index '%s' is corrupted", qPrintable(filename));
+        return false;
+    }
+
+    _stringsOffsets.resize(header.stringsCount + 1);
+    _stringsData.resize(header.stringsDataSize);
+    _records.resize(header.recordsCount);
+    _nodes.resize(header.nodesCount);
+    _postings.resize(header.postingsCount);
+    auto ok = FlatArraysIO::readArray(file, _stringsOffsets);
+    ok = ok && FlatArraysIO::readArray(file, _stringsData);
+    ok = ok && FlatArraysIO::readArray(file, _records);
+    ok = ok && FlatArraysIO::readArray(file, _nodes);
+    ok = ok && FlatArraysIO::readArray(file, _postings);
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to read address names index '%s'", qPrintable(filename));
+        return false;
+    }
+
+    auto isValid = (_stringsOffsets.first() == 0 && _stringsOffsets.last() == header.stringsDataSize);
+    for (auto stringIdx = 0u; isValid && stringIdx < header.stringsCount; stringIdx++)
+        isValid = (_stringsOffsets[stringIdx] <= _stringsOffsets[stringIdx + 1]);
+    for (const auto& record : constOf(_records))
+    {
+        isValid = isValid && record.name < header.stringsCount &&
+            (record.parent == NoParent || record.parent < header.recordsCount);
+    }
+    for (const auto& node : constOf(_nodes))
+    {
+        isValid = isValid &&
+            static_cast<uint64_t>(node.firstChild) + node.childrenCount <= header.nodesCount &&
+            node.postingsBegin <= node.ownPostingsEnd &&
+            node.ownPostingsEnd <= node.postingsEnd &&
+            node.postingsEnd <= header.postingsCount;
+    }
+    for (const auto posting : constOf(_postings))
+        isValid = isValid && posting < header.recordsCount;
+    if (!isValid)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Address names index '%s' is corrupted", qPrintable(filename));
+        return false;
+    }
+
+    return true;
+}
+
+bool OsmAnd::AddressNameTrie::save(const QString& filename, const uint64_t sourceFileSize, const int64_t sourceLastModified) const
+{
+    QFile output(filename);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to open '%s' for writing: %s", qPrintable(filename), qPrintable(output.errorString()));
+        return false;
+    }
+
+    FileHeader header;
+    header.signature = Signature;
+    header.version = Version;
+    header.sourceFileSize = sourceFileSize;
+    header.sourceLastModified = sourceLastModified;
+    header.stringsCount = _stringsOffsets.size() - 1;
+    header.stringsDataSize = _stringsData.size();
+    header.recordsCount = _records.size();
+    header.nodesCount = _nodes.size();
+    header.postingsCount = _postings.size();
+
+    auto ok = FlatArraysIO::write(output, header);
+    ok = ok && FlatArraysIO::writeArray(output, _stringsOffsets);
+    ok = ok && FlatArraysIO::writeArray(output, _stringsData);
+    ok = ok && FlatArraysIO::writeArray(output, _records);
+    ok = ok && FlatArraysIO::writeArray(output, _nodes);
+    ok = ok && FlatArraysIO::writeArray(output, _postings);
+    output.close();
+    if (!ok)
+    {
+        LogPrintf(LogSeverityLevel::Error, "Failed to write address names index '%s'", qPrintable(filename));
+        QFile::remove(filename);
+        return false;
+    }
+
+    return true;
+}
+
+int OsmAnd::AddressNameTrie::getRecordsCount() const
+{
+    return _records.size();
+}
+
+const OsmAnd::AddressNameTrie::Record& OsmAnd::AddressNameTrie::getRecord(const int record) const
+{
+    return _records[record];
+}
+
+QString OsmAnd::AddressNameTrie::getRecordName(const int record) const
+{
+    const auto name = _records[record].name;
+    const auto offset = _stringsOffsets[name];
+    return QString::fromUtf8(_stringsData.constData() + offset, _stringsOffsets[name + 1] - offset);
+}
+
+size_t OsmAnd::AddressNameTrie::getMemoryUsage() const
+{
+    return
+        static_cast<size_t>(_stringsData.capacity()) +
+        static_cast<size_t>(_stringsOffsets.capacity()) * sizeof(uint32_t) +
+        static_cast<size_t>(_records.capacity()) * sizeof(Record) +
+        static_cast<size_t>(_nodes.capacity()) * sizeof(Node) +
+        static_cast<size_t>(_postings.capacity()) * sizeof(uint32_t);
+}
+
+void OsmAnd::AddressNameTrie::findPrefixMatches(
+    const QString& word,
+    const unsigned int maxEdits,
+    QHash<uint32_t, unsigned int>& outCosts) const
+{
+    if (word.isEmpty() || _nodes.isEmpty())
+        return;
+
+    // Row N of edit distances between prefixes of word and prefix of node path is derived from row of parent
+    QVector<int> rootRow(word.length() + 1);
+    for (auto position = 0; position <= word.length(); position++)
+        rootRow[position] = position;
+    findInSubtree(0, word, maxEdits, rootRow, std::numeric_limits<int>::max(), outCosts);
+}
+
+void OsmAnd::AddressNameTrie::findWholeWordMatches(
+    const QString& word,
+    QHash<uint32_t, unsigned int>& outCosts) const
+{
+    if (word.isEmpty() || _nodes.isEmpty())
+        return;
+
+    auto node = 0u;
+    for (const auto label : word)
+    {
+        const auto& nodeRecord = _nodes[node];
+        const auto pChildrenBegin = _nodes.constData() + nodeRecord.firstChild;
+        const auto pChildrenEnd = pChildrenBegin + nodeRecord.childrenCount;
+        const auto pChild = std::lower_bound(pChildrenBegin, pChildrenEnd, label.unicode(),
+            []
+            (const Node& child, const uint16_t label) -> bool
+            {
+                return child.label < label;
+            });
+        if (pChild == pChildrenEnd || pChild->label != label.unicode())
+            return;
+        node = static_cast<unsigned int>(pChild - _nodes.constData());
+    }
+
+    addPostings(_nodes[node].postingsBegin, _nodes[node].ownPostingsEnd, 0, outCosts);
+}
+
+void OsmAnd::AddressNameTrie::findInSubtree(
+    const int node,
+    const QString& word,
+    const unsigned int maxEdits,
+    const QVector<int>& parentRow,
+    const int parentBestEdits,
+    QHash<uint32_t, unsigned int>& outCosts) const
+{
+    const auto wordLength = word.length();
+    const auto& nodeRecord = _nodes[node];
+    QVector<int> row(wordLength + 1);
+    for (auto child = nodeRecord.firstChild, childrenEnd = nodeRecord.firstChild + nodeRecord.childrenCount; child < childrenEnd; child++)
+    {
+        const auto& childRecord = _nodes[child];
+        const QChar label(childRecord.label);
+
+        row[0] = parentRow[0] + 1;
+        auto minEdits = row[0];
+        for (auto position = 1; position <= wordLength; position++)
+        {
+            row[position] = qMin(
+                qMin(parentRow[position], row[position - 1]) + 1,
+                parentRow[position - 1] + (word[position - 1] == label ? 0 : 1));
+            minEdits = qMin(minEdits, row[position]);
+        }
+
+        // Best edits is the lowest distance between word and any prefix of path to this node. Once that's
+        // within limit and deeper nodes can't improve it, the whole subtree matches
+        const auto bestEdits = qMin(parentBestEdits, row[wordLength]);
+        const auto isWithinLimit = (bestEdits <= static_cast<int>(maxEdits));
+        const auto wholeWordCost = static_cast<unsigned int>(bestEdits) * 2 + (row[wordLength] == bestEdits ? 0 : 1);
+        if (isWithinLimit && minEdits >= bestEdits)
+        {
+            addPostings(childRecord.postingsBegin, childRecord.ownPostingsEnd, wholeWordCost, outCosts);
+            addPostings(childRecord.ownPostingsEnd, childRecord.postingsEnd, static_cast<unsigned int>(bestEdits) * 2 + 1, outCosts);
+            continue;
+        }
+
+        if (isWithinLimit)
+            addPostings(childRecord.postingsBegin, childRecord.ownPostingsEnd, wholeWordCost, outCosts);
+        if (minEdits <= static_cast<int>(maxEdits))
+            findInSubtree(child, word, maxEdits, row, bestEdits, outCosts);
+    }
+}
+
+void OsmAnd::AddressNameTrie::addPostings(
+    const uint32_t postingsBegin,
+    const uint32_t postingsEnd,
+    const unsigned int cost,
+    QHash<uint32_t, unsigned int>& outCosts) const
+{
+    for (auto postingIdx = postingsBegin; postingIdx < postingsEnd; postingIdx++)
+    {
+        const auto record = _postings[postingIdx];
+        const auto itCost = outCosts.find(record);
+        if (itCost == outCosts.end())
+            outCosts.insert(record, cost);
+        else if (cost < *itCost)
+            *itCost = cost;
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef _OSMAND_CORE_ADDRESS_NAME_TRIE_H_
+#define _OSMAND_CORE_ADDRESS_NAME_TRIE_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+
+namespace OsmAnd
+{
+    class ObfReader;
+    class IQueryController;
+
+    // Names of settlements, streets and buildings of all address sections of a single OBF file. Names are
+    // normalized (transliterated to Latin, without accents, lowercase) and split into words, and words are
+    // stored in a trie of flat arrays. Children of a node are contiguous and sorted by label, and postings
+    // (references to named records) are ordered as words are, so postings of all words that start with
+    // prefix of a node form a single range.
+    class AddressNameTrie Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(AddressNameTrie);
+
+    public:
+        enum class RecordType : uint8_t
+        {
+            Settlement,
+            Street,
+            Building
+        };
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32_t signature;
+            uint32_t version;
+            uint64_t sourceFileSize;
+            int64_t sourceLastModified;
+            uint32_t stringsCount;
+            uint32_t stringsDataSize;
+            uint32_t recordsCount;
+            uint32_t nodesCount;
+            uint32_t postingsCount;
+        };
+
+        // Building references its street, street references its settlement
+        struct Record
+        {
+            PointI position31;
+            uint32_t name;
+            uint32_t parent;
+            RecordType type;
+        };
+
+        // Postings of words that end at node are [postingsBegin; ownPostingsEnd), postings of all words
+        // in subtree are [postingsBegin; postingsEnd)
+        struct Node
+        {
+            uint32_t firstChild;
+            uint32_t childrenCount;
+            uint32_t postingsBegin;
+            uint32_t ownPostingsEnd;
+            uint32_t postingsEnd;
+            uint16_t label;
+        };
+#pragma pack(pop)
+
+        static const uint32_t Signature;
+        static const uint32_t Version;
+        static const uint32_t NoParent;
+
+    private:
+        QByteArray _stringsData;
+        // String N is [_stringsOffsets[N]; _stringsOffsets[N + 1])
+        QVector<uint32_t> _stringsOffsets;
+        QVector<Record> _records;
+        // Node 0 is root
+        QVector<Node> _nodes;
+        QVector<uint32_t> _postings;
+
+        uint32_t addString(const QString& value);
+        void buildNodes(
+            const int node,
+            const QStringList& words,
+            const QVector<uint32_t>& wordsPostingsBegins,
+            const int wordsBegin,
+            const int wordsEnd,
+            const int depth);
+        void findInSubtree(
+            const int node,
+            const QString& word,
+            const unsigned int maxEdits,
+            const QVector<int>& parentRow,
+            const int parentBestEdits,
+            QHash<uint32_t, unsigned int>& outCosts) const;
+        void addPostings(
+            const uint32_t postingsBegin,
+            const uint32_t postingsEnd,
+            const unsigned int cost,
+            QHash<uint32_t, unsigned int>& outCosts) const;
+    protected:
+    public:
+        AddressNameTrie();
+        ~AddressNameTrie();
+
+        // Words of name in the same form as they are stored in trie
+        static QStringList normalizeAndSplit(const QString& name);
+
+        bool build(const std::shared_ptr<const ObfReader>& obfReader, const IQueryController* const controller);
+        bool load(const QString& filename, const uint64_t sourceFileSize, const int64_t sourceLastModified);
+        bool save(const QString& filename, const uint64_t sourceFileSize, const int64_t sourceLastModified) const;
+
+        int getRecordsCount() const;
+        const Record& getRecord(const int record) const;
+        QString getRecordName(const int record) const;
+        size_t getMemoryUsage() const;
+
+        // Finds records that have a word starting with given word, allowing up to given count of edits
+        // (insertions, deletions and substitutions). Cost of match is twice the count of edits, plus one
+        // if word only matches beginning of record word. Lowest cost is kept for each record
+        void findPrefixMatches(
+            const QString& word,
+            const unsigned int maxEdits,
+            QHash<uint32_t, unsigned int>& outCosts) const;
+
+        // Finds records that have exactly given word, at zero cost
+        void findWholeWordMatches(
+            const QString& word,
+            QHash<uint32_t, unsigned int>& outCosts) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ADDRESS_NAME_TRIE_H_)
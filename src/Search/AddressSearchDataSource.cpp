@@ -0,0 +1,44 @@
+#include "AddressSearchDataSource.h"
+#include "AddressSearchDataSource_P.h"
+
+OsmAnd::AddressSearchDataSource::AddressSearchDataSource(const std::shared_ptr<const IObfsCollection>& obfsCollection_)
+    : _p(new AddressSearchDataSource_P(this))
+    , obfsCollection(obfsCollection_)
+{
+}
+
+OsmAnd::AddressSearchDataSource::~AddressSearchDataSource()
+{
+}
+
+bool OsmAnd::AddressSearchDataSource::obtainResults(
+    const QString& query,
+    const AreaI* const bbox31,
+    const NewResultCallback newResultCallback,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->obtainResults(query, bbox31, newResultCallback, controller);
+}
+
+std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResult> OsmAnd::AddressSearchDataSource::refineResult(
+    const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+    const QString& query) const
+{
+    return _p->refineResult(result, query);
+}
+
+OsmAnd::AddressSearchDataSource::ResultEntry::ResultEntry(
+    const std::shared_ptr<const StreetGroup>& streetGroup_,
+    const std::shared_ptr<const Street>& street_,
+    const QString& matchString_,
+    const float matchFactor_,
+    const QList< std::pair<int, int> >& matchedRanges_)
+    : BaseSearchResult(matchString_, matchFactor_, matchedRanges_)
+    , streetGroup(streetGroup_)
+    , street(street_)
+{
+}
+
+OsmAnd::AddressSearchDataSource::ResultEntry::~ResultEntry()
+{
+}
@@ -0,0 +1,120 @@
+#include "AddressSearchDataSource_P.h"
+#include "AddressSearchDataSource.h"
+
+#include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfInfo.h"
+#include "ObfAddressSectionInfo.h"
+#include "ObfAddressSectionReader.h"
+#include "StreetGroup.h"
+#include "Street.h"
+#include "BaseSearchEngine.h"
+#include "IQueryController.h"
+#include "Utilities.h"
+
+OsmAnd::AddressSearchDataSource_P::AddressSearchDataSource_P(AddressSearchDataSource* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::AddressSearchDataSource_P::~AddressSearchDataSource_P()
+{
+}
+
+bool OsmAnd::AddressSearchDataSource_P::obtainResults(
+    const QString& query,
+    const AreaI* const bbox31,
+    const NewResultCallback newResultCallback,
+    const IQueryController* const controller) const
+{
+    const auto dataInterface = bbox31
+        ? owner->obfsCollection->obtainDataInterface(*bbox31)
+        : owner->obfsCollection->obtainDataInterface();
+
+    for (const auto& obfReader : constOf(dataInterface->obfReaders))
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        const auto& obfInfo = obfReader->obtainInfo();
+        for (const auto& addressSection : constOf(obfInfo->addressSections))
+        {
+            if (controller && controller->isAborted())
+                return false;
+
+            // Street groups have to be loaded completely before streets, since both share same stream
+            QList< std::shared_ptr<const StreetGroup> > streetGroups;
+            ObfAddressSectionReader::loadStreetGroups(
+                obfReader,
+                addressSection,
+                &streetGroups,
+                nullptr,
+                controller);
+
+            for (const auto& streetGroup : constOf(streetGroups))
+            {
+                if (controller && controller->isAborted())
+                    return false;
+
+                if (bbox31)
+                {
+                    const auto groupPosition31 = Utilities::convertLatLonTo31(
+                        LatLon(streetGroup->_latitude, streetGroup->_longitude));
+                    if (!bbox31->contains(groupPosition31))
+                        continue;
+                }
+
+                if (const auto resultEntry = matchEntry(streetGroup, nullptr, query))
+                    newResultCallback(owner, resultEntry);
+
+                ObfAddressSectionReader::loadStreetsFromGroup(
+                    obfReader,
+                    streetGroup,
+                    nullptr,
+                    [this, query, newResultCallback, streetGroup]
+                    (const std::shared_ptr<const Street>& street) -> bool
+                    {
+                        const auto resultEntry = matchEntry(streetGroup, street, query);
+                        if (!resultEntry)
+                            return false;
+
+                        newResultCallback(owner, resultEntry);
+                        return true;
+                    },
+                    controller);
+            }
+        }
+    }
+
+    return !(controller && controller->isAborted());
+}
+
+std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResult> OsmAnd::AddressSearchDataSource_P::refineResult(
+    const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+    const QString& query) const
+{
+    const auto resultEntry = std::dynamic_pointer_cast<const ResultEntry>(result);
+    if (!resultEntry)
+        return nullptr;
+
+    return matchEntry(resultEntry->streetGroup, resultEntry->street, query);
+}
+
+std::shared_ptr<const OsmAnd::AddressSearchDataSource_P::ResultEntry> OsmAnd::AddressSearchDataSource_P::matchEntry(
+    const std::shared_ptr<const StreetGroup>& streetGroup,
+    const std::shared_ptr<const Street>& street,
+    const QString& query)
+{
+    const auto& name = street ? street->name : streetGroup->_name;
+    const auto& latinName = street ? street->latinName : streetGroup->_latinName;
+
+    float matchFactor = 0.0f;
+    QList< std::pair<int, int> > matchedRanges;
+    if (BaseSearchEngine::match(query, name, &matchFactor, &matchedRanges))
+        return std::make_shared<ResultEntry>(streetGroup, street, name, matchFactor, matchedRanges);
+
+    if (latinName != name && BaseSearchEngine::match(query, latinName, &matchFactor, &matchedRanges))
+        return std::make_shared<ResultEntry>(streetGroup, street, latinName, matchFactor, matchedRanges);
+
+    return nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef _OSMAND_CORE_ADDRESS_SEARCH_DATA_SOURCE_P_H_
+#define _OSMAND_CORE_ADDRESS_SEARCH_DATA_SOURCE_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "PrivateImplementation.h"
+#include "IObfsCollection.h"
+#include "AddressSearchDataSource.h"
+
+namespace OsmAnd
+{
+    class StreetGroup;
+    class Street;
+    class IQueryController;
+
+    class AddressSearchDataSource;
+    class AddressSearchDataSource_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(AddressSearchDataSource_P);
+
+    public:
+        typedef AddressSearchDataSource::ResultEntry ResultEntry;
+        typedef AddressSearchDataSource::NewResultCallback NewResultCallback;
+
+    private:
+        static std::shared_ptr<const ResultEntry> matchEntry(
+            const std::shared_ptr<const StreetGroup>& streetGroup,
+            const std::shared_ptr<const Street>& street,
+            const QString& query);
+    protected:
+        AddressSearchDataSource_P(AddressSearchDataSource* const owner);
+    public:
+        ~AddressSearchDataSource_P();
+
+        ImplementationInterface<AddressSearchDataSource> owner;
+
+        bool obtainResults(
+            const QString& query,
+            const AreaI* const bbox31,
+            const NewResultCallback newResultCallback,
+            const IQueryController* const controller) const;
+        std::shared_ptr<const ISearchEngine::ISearchResult> refineResult(
+            const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+            const QString& query) const;
+
+    friend class OsmAnd::AddressSearchDataSource;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_ADDRESS_SEARCH_DATA_SOURCE_P_H_)
@@ -1,6 +1,14 @@
 #include "BaseSearchEngine.h"
 #include "BaseSearchEngine_P.h"
 
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QStringList>
+#include <QRegExp>
+#include "restore_internal_warnings.h"
+
+#include "ICU.h"
+
 OsmAnd::BaseSearchEngine::BaseSearchEngine(BaseSearchEngine_P* const p_)
     : _p(p_)
 {
@@ -29,3 +37,133 @@ QList< std::shared_ptr<const OsmAnd::BaseSearchEngine::IDataSource> > OsmAnd::Ba
 {
     return _p->getDataSources();
 }
+
+bool OsmAnd::BaseSearchEngine::match(
+    const QString& query,
+    const QString& name,
+    float* const outMatchFactor /*= nullptr*/,
+    QList< std::pair<int, int> >* const outMatchedRanges /*= nullptr*/)
+{
+    if (name.isEmpty())
+        return false;
+    const auto queryTokens = ICU::stripAccentsAndDiacritics(query).split(QRegExp(QLatin1String("\\s+")), QString::SkipEmptyParts);
+    if (queryTokens.isEmpty())
+        return false;
+
+    // Accents and diacritics are ignored, as in name indexes of OBF. Stripping them from precomposed
+    // characters keeps the length, so matched ranges stay valid for the original name
+    const auto nameLength = name.length();
+    auto strippedName = ICU::stripAccentsAndDiacritics(name);
+    if (strippedName.length() != nameLength)
+        strippedName = name;
+
+    // Collect positions where words of name begin
+    QList<int> wordsStarts;
+    for (auto position = 0; position < nameLength; position++)
+    {
+        if (!name[position].isLetterOrNumber())
+            continue;
+        if (position > 0 && name[position - 1].isLetterOrNumber())
+            continue;
+        wordsStarts.push_back(position);
+    }
+
+    // Each token has to match beginning of a distinct word
+    QList< std::pair<int, int> > matchedRanges;
+    QList<int> unusedWordsStarts = wordsStarts;
+    auto matchedLength = 0;
+    bool matchesFromStart = false;
+    for (const auto& queryToken : constOf(queryTokens))
+    {
+        bool tokenMatched = false;
+        for (auto itWordStart = unusedWordsStarts.begin(); itWordStart != unusedWordsStarts.end(); ++itWordStart)
+        {
+            const auto wordStart = *itWordStart;
+            if (!strippedName.midRef(wordStart).startsWith(queryToken, Qt::CaseInsensitive))
+                continue;
+
+            matchedRanges.push_back(std::pair<int, int>(wordStart, queryToken.length()));
+            matchedLength += queryToken.length();
+            if (wordStart == wordsStarts.first())
+                matchesFromStart = true;
+            unusedWordsStarts.erase(itWordStart);
+            tokenMatched = true;
+            break;
+        }
+        if (!tokenMatched)
+            return false;
+    }
+
+    if (outMatchFactor)
+    {
+        // Longer coverage of the name and match from its beginning are preferred
+        *outMatchFactor = static_cast<float>(matchedLength) / static_cast<float>(nameLength);
+        if (matchesFromStart)
+            *outMatchFactor += 1.0f;
+    }
+    if (outMatchedRanges)
+        *outMatchedRanges = qMove(matchedRanges);
+
+    return true;
+}
+
+OsmAnd::BaseSearchEngine::BaseSearchResult::BaseSearchResult(
+    const QString& matchString_,
+    const float matchFactor_,
+    const QList< std::pair<int, int> >& matchedRanges_)
+    : matchString(matchString_)
+    , matchFactor(matchFactor_)
+    , matchedRanges(matchedRanges_)
+{
+}
+
+OsmAnd::BaseSearchEngine::BaseSearchResult::~BaseSearchResult()
+{
+}
+
+float OsmAnd::BaseSearchEngine::BaseSearchResult::getMatchFactor() const
+{
+    return matchFactor;
+}
+
+QString OsmAnd::BaseSearchEngine::BaseSearchResult::getMatchString() const
+{
+    return matchString;
+}
+
+QList<QStringRef> OsmAnd::BaseSearchEngine::BaseSearchResult::getMatchedSubstrings() const
+{
+    QList<QStringRef> matchedSubstrings;
+    for (const auto& matchedRange : constOf(matchedRanges))
+        matchedSubstrings.push_back(QStringRef(&matchString, matchedRange.first, matchedRange.second));
+    return matchedSubstrings;
+}
+
+OsmAnd::BaseSearchEngine::BaseSearchResults::BaseSearchResults(
+    const QString& query_,
+    const QLinkedList< std::shared_ptr<const ISearchResult> >& results_,
+    const bool complete_)
+    : query(query_)
+    , results(results_)
+    , complete(complete_)
+{
+}
+
+OsmAnd::BaseSearchEngine::BaseSearchResults::~BaseSearchResults()
+{
+}
+
+QString OsmAnd::BaseSearchEngine::BaseSearchResults::getQuery() const
+{
+    return query;
+}
+
+QLinkedList< std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResult> > OsmAnd::BaseSearchEngine::BaseSearchResults::getResults() const
+{
+    return results;
+}
+
+bool OsmAnd::BaseSearchEngine::BaseSearchResults::isComplete() const
+{
+    return complete;
+}
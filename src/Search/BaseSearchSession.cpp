@@ -11,6 +11,8 @@ OsmAnd::BaseSearchSession::BaseSearchSession(
 
 OsmAnd::BaseSearchSession::~BaseSearchSession()
 {
+    // Results callback must not be invoked once session is gone
+    _p->abortAllSearchesAndWait();
 }
 
 QList< std::shared_ptr<const OsmAnd::ISearchEngine::IDataSource> > OsmAnd::BaseSearchSession::getDataSources() const
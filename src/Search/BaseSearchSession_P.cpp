@@ -1,65 +1,378 @@
 #include "BaseSearchSession_P.h"
+#include "BaseSearchSession.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "BaseSearchEngine.h"
+#include "FunctorQueryController.h"
+
+const int OsmAnd::BaseSearchSession_P::PublishBatchSize = 16;
+const float OsmAnd::BaseSearchSession_P::PublishInterval = 0.1f;
+const int OsmAnd::BaseSearchSession_P::MaxRefinableResults = 10000;
 
 OsmAnd::BaseSearchSession_P::BaseSearchSession_P(BaseSearchSession* const owner_)
-    : owner(owner_)
+    : _taskHostBridge(this)
+    , _resultsLimit(0)
+    , _resultsUpdatedCallback(nullptr)
+    , _searchGeneration(0)
+    , _activeSearchTask(nullptr)
+    , _entriesHasBbox31(false)
+    , _entriesComplete(false)
+    , _entriesTruncated(false)
+    , _unpublishedResultsCount(0)
+    , owner(owner_)
 {
+    // Searches of the same session are serialized: a new search waits till the aborted one notices
+    // the abort, so that data sources are never queried concurrently on behalf of the same session
+    _searchThreadPool.setMaxThreadCount(1);
 }
 
 OsmAnd::BaseSearchSession_P::~BaseSearchSession_P()
 {
 }
 
-bool OsmAnd::BaseSearchSession_P::isSearching() const
+bool OsmAnd::BaseSearchSession_P::obtainSearchBbox31(AreaI& outBbox31) const
 {
+    Q_UNUSED(outBbox31);
+
     return false;
 }
 
+bool OsmAnd::BaseSearchSession_P::isSearching() const
+{
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    return (_activeSearchTask != nullptr);
+}
+
 bool OsmAnd::BaseSearchSession_P::startSearch()
 {
-    return false;
+    AreaI bbox31;
+    const auto hasBbox31 = obtainSearchBbox31(bbox31);
+
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    if (_query.trimmed().isEmpty())
+        return false;
+
+    abortActiveSearch();
+
+    SearchParameters parameters;
+    parameters.generation = ++_searchGeneration;
+    parameters.query = _query;
+    parameters.hasBbox31 = hasBbox31;
+    parameters.bbox31 = bbox31;
+    parameters.dataSources = owner->dataSources;
+
+    // Previous results can be refined only if they are complete and the new query is a continuation
+    // of the previous one in the same area. Otherwise data sources have to be queried again
+    parameters.isRefinement =
+        _entriesComplete &&
+        !_entriesTruncated &&
+        !_entriesQuery.isEmpty() &&
+        _query.startsWith(_entriesQuery, Qt::CaseInsensitive) &&
+        _entriesHasBbox31 == hasBbox31 &&
+        (!hasBbox31 || _entriesBbox31 == bbox31);
+    if (parameters.isRefinement)
+        parameters.refinedEntries = _entries;
+
+    _entries.clear();
+    _entriesQuery = _query;
+    _entriesHasBbox31 = hasBbox31;
+    _entriesBbox31 = bbox31;
+    _entriesComplete = false;
+    _entriesTruncated = false;
+    _unpublishedResultsCount = 0;
+    _publishStopwatch.start();
+
+    const auto searchTask = new Concurrent::HostedTask(
+        _taskHostBridge,
+        [this, parameters]
+        (Concurrent::Task* const task)
+        {
+            executeSearch(task, parameters);
+        },
+        nullptr,
+        [this]
+        (Concurrent::Task* const task, bool wasCancelled)
+        {
+            Q_UNUSED(wasCancelled);
+
+            QMutexLocker scopedLocker(&_stateMutex);
+
+            if (_activeSearchTask == task)
+                _activeSearchTask = nullptr;
+        });
+    _activeSearchTask = searchTask;
+    _searchThreadPool.start(searchTask);
+
+    return true;
 }
 
 bool OsmAnd::BaseSearchSession_P::pauseSearch()
 {
-    return false;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    if (!_activeSearchTask)
+        return false;
+
+    // Results found so far are kept, but they can not be refined later since they are incomplete
+    abortActiveSearch();
+    _searchGeneration++;
+
+    return true;
 }
 
 bool OsmAnd::BaseSearchSession_P::cancelSearch()
 {
-    return false;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    const auto wasSearching = (_activeSearchTask != nullptr);
+    abortActiveSearch();
+    _searchGeneration++;
+
+    _entries.clear();
+    _entriesQuery.clear();
+    _entriesComplete = false;
+    _entriesTruncated = false;
+    _results.reset();
+
+    return wasSearching;
+}
+
+void OsmAnd::BaseSearchSession_P::abortAllSearchesAndWait()
+{
+    {
+        QMutexLocker scopedLocker(&_stateMutex);
+
+        abortActiveSearch();
+        _searchGeneration++;
+    }
+
+    // This blocks until all searches (including aborted, but not yet finished) are gone
+    _taskHostBridge.onOwnerIsBeingDestructed();
+}
+
+void OsmAnd::BaseSearchSession_P::abortActiveSearch()
+{
+    if (!_activeSearchTask)
+        return;
+
+    // Task is guaranteed to be alive while it's referenced here, since it's unreferenced
+    // in post-execute handler under the same lock
+    _activeSearchTask->requestCancellation();
+    _activeSearchTask = nullptr;
+}
+
+void OsmAnd::BaseSearchSession_P::executeSearch(const Concurrent::Task* const task, const SearchParameters& parameters)
+{
+    const FunctorQueryController controller(
+        [task]
+        (const FunctorQueryController* const controller) -> bool
+        {
+            return task->isCancellationRequested();
+        });
+
+    ResultsUpdatedCallback callback;
+    std::shared_ptr<const ISearchResults> results;
+    if (parameters.isRefinement)
+    {
+        // Each next keystroke can only narrow results down, so there's no need to touch data again
+        for (const auto& entry : constOf(parameters.refinedEntries))
+        {
+            if (controller.isAborted())
+                return;
+
+            const auto refinedResult = entry.dataSource->refineResult(entry.result, parameters.query);
+            if (!refinedResult)
+                continue;
+
+            if (collectResult(parameters.generation, entry.dataSource, refinedResult, callback, results))
+                notifyResultsUpdated(task, callback, results);
+        }
+    }
+    else
+    {
+        for (const auto& dataSource : constOf(parameters.dataSources))
+        {
+            if (controller.isAborted())
+                return;
+
+            const auto completed = dataSource->obtainResults(
+                parameters.query,
+                parameters.hasBbox31 ? &parameters.bbox31 : nullptr,
+                [this, task, &parameters, dataSource]
+                (const IDataSource* const dataSource_, const std::shared_ptr<const ISearchResult>& result)
+                {
+                    Q_UNUSED(dataSource_);
+
+                    ResultsUpdatedCallback callback;
+                    std::shared_ptr<const ISearchResults> results;
+                    if (collectResult(parameters.generation, dataSource, result, callback, results))
+                        notifyResultsUpdated(task, callback, results);
+                },
+                &controller);
+            if (!completed)
+                return;
+        }
+    }
+
+    {
+        QMutexLocker scopedLocker(&_stateMutex);
+
+        if (parameters.generation != _searchGeneration || task->isCancellationRequested())
+            return;
+
+        _entriesComplete = true;
+        _unpublishedResultsCount = 0;
+        _results = buildResults(true);
+
+        callback = _resultsUpdatedCallback;
+        results = _results;
+    }
+    notifyResultsUpdated(task, callback, results);
+}
+
+bool OsmAnd::BaseSearchSession_P::collectResult(
+    const unsigned int generation,
+    const std::shared_ptr<const IDataSource>& dataSource,
+    const std::shared_ptr<const ISearchResult>& result,
+    ResultsUpdatedCallback& outCallback,
+    std::shared_ptr<const ISearchResults>& outResults)
+{
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    // Results of superseded search are not interesting anymore
+    if (generation != _searchGeneration)
+        return false;
+
+    if (_entries.size() >= MaxRefinableResults)
+    {
+        _entriesTruncated = true;
+        return false;
+    }
+
+    ResultEntry entry;
+    entry.dataSource = dataSource;
+    entry.result = result;
+    _entries.push_back(qMove(entry));
+    _unpublishedResultsCount++;
+
+    if (_unpublishedResultsCount < PublishBatchSize && _publishStopwatch.elapsed() < PublishInterval)
+        return false;
+    _unpublishedResultsCount = 0;
+    _publishStopwatch.start();
+    _results = buildResults(false);
+
+    outCallback = _resultsUpdatedCallback;
+    outResults = _results;
+    return true;
+}
+
+std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResults> OsmAnd::BaseSearchSession_P::buildResults(const bool complete) const
+{
+    QVector< std::shared_ptr<const ISearchResult> > sortedResults;
+    sortedResults.reserve(_entries.size());
+    for (const auto& entry : constOf(_entries))
+        sortedResults.push_back(entry.result);
+
+    const auto resultsComparator =
+        []
+        (const std::shared_ptr<const ISearchResult>& l, const std::shared_ptr<const ISearchResult>& r) -> bool
+        {
+            return l->getMatchFactor() > r->getMatchFactor();
+        };
+    auto resultsCount = sortedResults.size();
+    if (_resultsLimit > 0 && static_cast<unsigned int>(resultsCount) > _resultsLimit)
+    {
+        resultsCount = _resultsLimit;
+        std::partial_sort(sortedResults.begin(), sortedResults.begin() + resultsCount, sortedResults.end(), resultsComparator);
+    }
+    else
+    {
+        std::stable_sort(sortedResults.begin(), sortedResults.end(), resultsComparator);
+    }
+
+    QLinkedList< std::shared_ptr<const ISearchResult> > results;
+    for (auto resultIdx = 0; resultIdx < resultsCount; resultIdx++)
+        results.push_back(sortedResults[resultIdx]);
+
+    return std::make_shared<BaseSearchEngine::BaseSearchResults>(_entriesQuery, results, complete);
+}
+
+void OsmAnd::BaseSearchSession_P::notifyResultsUpdated(
+    const Concurrent::Task* const task,
+    const ResultsUpdatedCallback& callback,
+    const std::shared_ptr<const ISearchResults>& results)
+{
+    if (!callback || task->isCancellationRequested())
+        return;
+
+    callback(owner, results);
 }
 
 std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResults> OsmAnd::BaseSearchSession_P::getResults() const
 {
-    return nullptr;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    return _results;
 }
 
 void OsmAnd::BaseSearchSession_P::setResultsUpdatedCallback(const ResultsUpdatedCallback callback)
 {
-    int i = 5;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    _resultsUpdatedCallback = callback;
 }
 
 OsmAnd::BaseSearchSession_P::ResultsUpdatedCallback OsmAnd::BaseSearchSession_P::getResultsUpdatedCallback() const
 {
-    return nullptr;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    return _resultsUpdatedCallback;
 }
 
 void OsmAnd::BaseSearchSession_P::setQuery(const QString& queryText)
 {
-    int i = 5;
+    bool restartSearch = false;
+    {
+        QMutexLocker scopedLocker(&_stateMutex);
+
+        if (_query == queryText)
+            return;
+        _query = queryText;
+
+        // Search that is in progress is restarted with new query, possibly refining previous results
+        restartSearch = (_activeSearchTask != nullptr);
+    }
+
+    if (restartSearch)
+        startSearch();
 }
 
 QString OsmAnd::BaseSearchSession_P::getQuery() const
 {
-    return QString();
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    return _query;
 }
 
 void OsmAnd::BaseSearchSession_P::setResultsLimit(const unsigned int limit)
 {
-    int i = 5;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    _resultsLimit = limit;
 }
 
 unsigned int OsmAnd::BaseSearchSession_P::getResultsLimit() const
 {
-    return 0;
+    QMutexLocker scopedLocker(&_stateMutex);
+
+    return _resultsLimit;
 }
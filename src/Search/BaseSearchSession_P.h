@@ -7,11 +7,16 @@
 #include "ignore_warnings_on_external_includes.h"
 #include <QList>
 #include <QLinkedList>
+#include <QMutex>
+#include <QThreadPool>
 #include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
 #include "Callable.h"
 #include "PrivateImplementation.h"
+#include "CommonTypes.h"
+#include "Concurrent.h"
+#include "Stopwatch.h"
 #include "ISearchSession.h"
 
 namespace OsmAnd
@@ -23,10 +28,70 @@ namespace OsmAnd
 
     public:
         typedef ISearchSession::ResultsUpdatedCallback ResultsUpdatedCallback;
+        typedef ISearchEngine::IDataSource IDataSource;
+        typedef ISearchEngine::ISearchResult ISearchResult;
+        typedef ISearchEngine::ISearchResults ISearchResults;
+
+        // Results found are reported in batches of this size, or after this interval, whichever happens first
+        static const int PublishBatchSize;
+        static const float PublishInterval;
+        // Results of a query are kept for refinement of the next query only up to this number
+        static const int MaxRefinableResults;
 
     private:
+        struct ResultEntry
+        {
+            std::shared_ptr<const IDataSource> dataSource;
+            std::shared_ptr<const ISearchResult> result;
+        };
+
+        struct SearchParameters
+        {
+            unsigned int generation;
+            QString query;
+            bool hasBbox31;
+            AreaI bbox31;
+            QList< std::shared_ptr<const IDataSource> > dataSources;
+            QList<ResultEntry> refinedEntries;
+            bool isRefinement;
+        };
+
+        const Concurrent::TaskHost::Bridge _taskHostBridge;
+        QThreadPool _searchThreadPool;
+
+        mutable QMutex _stateMutex;
+        QString _query;
+        unsigned int _resultsLimit;
+        ResultsUpdatedCallback _resultsUpdatedCallback;
+        unsigned int _searchGeneration;
+        Concurrent::Task* _activeSearchTask;
+        QList<ResultEntry> _entries;
+        QString _entriesQuery;
+        bool _entriesHasBbox31;
+        AreaI _entriesBbox31;
+        bool _entriesComplete;
+        bool _entriesTruncated;
+        std::shared_ptr<const ISearchResults> _results;
+        int _unpublishedResultsCount;
+        Stopwatch _publishStopwatch;
+
+        void executeSearch(const Concurrent::Task* const task, const SearchParameters& parameters);
+        bool collectResult(
+            const unsigned int generation,
+            const std::shared_ptr<const IDataSource>& dataSource,
+            const std::shared_ptr<const ISearchResult>& result,
+            ResultsUpdatedCallback& outCallback,
+            std::shared_ptr<const ISearchResults>& outResults);
+        std::shared_ptr<const ISearchResults> buildResults(const bool complete) const;
+        void notifyResultsUpdated(
+            const Concurrent::Task* const task,
+            const ResultsUpdatedCallback& callback,
+            const std::shared_ptr<const ISearchResults>& results);
+        void abortActiveSearch();
     protected:
         BaseSearchSession_P(BaseSearchSession* const owner);
+
+        virtual bool obtainSearchBbox31(AreaI& outBbox31) const;
     public:
         virtual ~BaseSearchSession_P();
 
@@ -36,6 +101,7 @@ namespace OsmAnd
         bool startSearch();
         bool pauseSearch();
         bool cancelSearch();
+        void abortAllSearchesAndWait();
 
         std::shared_ptr<const ISearchEngine::ISearchResults> getResults() const;
 
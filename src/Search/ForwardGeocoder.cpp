@@ -0,0 +1,52 @@
+#include "ForwardGeocoder.h"
+#include "ForwardGeocoder_P.h"
+
+const unsigned int OsmAnd::ForwardGeocoder::DefaultMaxResultsCount = 20;
+const QString OsmAnd::ForwardGeocoder::IndexFileSuffix(QLatin1String(".geocoding"));
+
+OsmAnd::ForwardGeocoder::ForwardGeocoder(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection_,
+    const bool persistIndices_ /*= false*/)
+    : _p(new ForwardGeocoder_P(this))
+    , obfsCollection(obfsCollection_)
+    , persistIndices(persistIndices_)
+{
+}
+
+OsmAnd::ForwardGeocoder::~ForwardGeocoder()
+{
+}
+
+bool OsmAnd::ForwardGeocoder::prepareIndices(const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->prepareIndices(controller);
+}
+
+int OsmAnd::ForwardGeocoder::getIndexedNamesCount() const
+{
+    return _p->getIndexedNamesCount();
+}
+
+size_t OsmAnd::ForwardGeocoder::getMemoryUsage() const
+{
+    return _p->getMemoryUsage();
+}
+
+bool OsmAnd::ForwardGeocoder::geocode(
+    const QString& query,
+    QList<Result>& outResults,
+    const unsigned int maxResultsCount /*= DefaultMaxResultsCount*/,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->geocode(query, outResults, maxResultsCount, controller);
+}
+
+OsmAnd::ForwardGeocoder::Result::Result()
+    : type(ResultType::Settlement)
+    , cost(0)
+{
+}
+
+OsmAnd::ForwardGeocoder::Result::~Result()
+{
+}
@@ -0,0 +1,276 @@
+#include "ForwardGeocoder_P.h"
+#include "ForwardGeocoder.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSet>
+#include <QVector>
+#include <QMutexLocker>
+#include "restore_internal_warnings.h"
+
+#include "AddressNameTrie.h"
+#include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfFile.h"
+#include "ObfInfo.h"
+#include "IQueryController.h"
+#include "Logging.h"
+
+const int OsmAnd::ForwardGeocoder_P::MinPrefixLength = 3;
+
+OsmAnd::ForwardGeocoder_P::ForwardGeocoder_P(ForwardGeocoder* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::ForwardGeocoder_P::~ForwardGeocoder_P()
+{
+}
+
+unsigned int OsmAnd::ForwardGeocoder_P::getMaxEdits(const QString& word)
+{
+    // House numbers and short words have to be typed exactly, otherwise almost anything matches them
+    if (word[0].isDigit() || word.length() < 4)
+        return 0;
+    if (word.length() < 8)
+        return 1;
+    return 2;
+}
+
+bool OsmAnd::ForwardGeocoder_P::candidateComparator(const Candidate& l, const Candidate& r)
+{
+    if (l.cost != r.cost)
+        return l.cost < r.cost;
+
+    // Among equally good matches, settlements go before streets and streets before buildings
+    const auto& lRecord = l.index->getRecord(l.record);
+    const auto& rRecord = r.index->getRecord(r.record);
+    if (lRecord.type != rRecord.type)
+        return lRecord.type < rRecord.type;
+    if (l.index != r.index)
+        return l.index < r.index;
+    return l.record < r.record;
+}
+
+std::shared_ptr<const OsmAnd::AddressNameTrie> OsmAnd::ForwardGeocoder_P::obtainIndex(
+    const std::shared_ptr<const ObfReader>& obfReader,
+    const IQueryController* const controller) const
+{
+    // Readers of bare streams have no file to key index by
+    const auto& obfFile = obfReader->obfFile;
+    if (!obfFile || obfReader->obtainInfo()->addressSections.isEmpty())
+        return nullptr;
+
+    QMutexLocker scopedLocker(&_indicesMutex);
+
+    const auto citIndex = _indices.constFind(obfFile->filePath);
+    if (citIndex != _indices.cend())
+        return *citIndex;
+
+    const auto indexFilename = obfFile->filePath + ForwardGeocoder::IndexFileSuffix;
+    const auto lastModified = QFileInfo(obfFile->filePath).lastModified().toMSecsSinceEpoch();
+    const std::shared_ptr<AddressNameTrie> index(new AddressNameTrie());
+    auto isReady = false;
+    if (owner->persistIndices && QFileInfo(indexFilename).exists())
+        isReady = index->load(indexFilename, obfFile->fileSize, lastModified);
+    if (!isReady)
+    {
+        if (!index->build(obfReader, controller))
+            return nullptr;
+
+        // Index that failed to be saved is still usable, it will be built again next time
+        if (owner->persistIndices)
+            index->save(indexFilename, obfFile->fileSize, lastModified);
+    }
+
+    _indices.insert(obfFile->filePath, index);
+    return index;
+}
+
+bool OsmAnd::ForwardGeocoder_P::prepareIndices(const IQueryController* const controller) const
+{
+    const auto dataInterface = owner->obfsCollection->obtainDataInterface();
+    for (const auto& obfReader : constOf(dataInterface->obfReaders))
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        obtainIndex(obfReader, controller);
+    }
+
+    return !(controller && controller->isAborted());
+}
+
+int OsmAnd::ForwardGeocoder_P::getIndexedNamesCount() const
+{
+    QMutexLocker scopedLocker(&_indicesMutex);
+
+    auto count = 0;
+    for (const auto& index : constOf(_indices))
+        count += index->getRecordsCount();
+    return count;
+}
+
+size_t OsmAnd::ForwardGeocoder_P::getMemoryUsage() const
+{
+    QMutexLocker scopedLocker(&_indicesMutex);
+
+    size_t memoryUsage = 0;
+    for (const auto& index : constOf(_indices))
+        memoryUsage += index->getMemoryUsage();
+    return memoryUsage;
+}
+
+void OsmAnd::ForwardGeocoder_P::collectCandidates(
+    const AddressNameTrie& index,
+    const QStringList& words,
+    QList<Candidate>& outCandidates) const
+{
+    // Prefix of one or two letters starts too many words to be worth matching, so such words of query are
+    // only matched whole
+    const auto wordsCount = words.size();
+    QVector< QHash<uint32_t, unsigned int> > wordsCosts(wordsCount);
+    for (auto wordIdx = 0; wordIdx < wordsCount; wordIdx++)
+    {
+        const auto& word = words[wordIdx];
+        if (word.length() < MinPrefixLength)
+            index.findWholeWordMatches(word, wordsCosts[wordIdx]);
+        else
+            index.findPrefixMatches(word, getMaxEdits(word), wordsCosts[wordIdx]);
+
+        // Word that matches nothing can't be covered by any result
+        if (wordsCosts[wordIdx].isEmpty())
+            return;
+    }
+
+    // Words are checked from the most selective one, so that most records are rejected by the first check
+    QVector<int> wordsOrder(wordsCount);
+    for (auto wordIdx = 0; wordIdx < wordsCount; wordIdx++)
+        wordsOrder[wordIdx] = wordIdx;
+    std::sort(wordsOrder.begin(), wordsOrder.end(),
+        [&wordsCosts]
+        (const int l, const int r) -> bool
+        {
+            return wordsCosts[l].size() < wordsCosts[r].size();
+        });
+    const auto& shortestCosts = wordsCosts[wordsOrder.first()];
+
+    // Any result is matched by at least one word itself, other words may match its street or settlement.
+    // Result, its street or its settlement has to be in the shortest list, so records that aren't are
+    // rejected before being merged with other words
+    QSet<uint32_t> evaluatedRecords;
+    for (const auto& wordCosts : constOf(wordsCosts))
+    {
+        for (auto itCost = wordCosts.cbegin(); itCost != wordCosts.cend(); ++itCost)
+        {
+            const auto record = itCost.key();
+
+            uint32_t chain[3];
+            auto chainLength = 0;
+            auto isInShortest = false;
+            for (auto chainRecord = record;
+                chainRecord != AddressNameTrie::NoParent && chainLength < 3;
+                chainRecord = index.getRecord(chainRecord).parent)
+            {
+                chain[chainLength++] = chainRecord;
+                isInShortest = isInShortest || shortestCosts.contains(chainRecord);
+            }
+            if (!isInShortest || evaluatedRecords.contains(record))
+                continue;
+            evaluatedRecords.insert(record);
+
+            auto cost = 0u;
+            auto isMatched = true;
+            for (auto orderIdx = 0; isMatched && orderIdx < wordsCount; orderIdx++)
+            {
+                const auto& costs = wordsCosts[wordsOrder[orderIdx]];
+                auto bestCost = std::numeric_limits<unsigned int>::max();
+                for (auto chainIdx = 0; chainIdx < chainLength; chainIdx++)
+                {
+                    const auto citCost = costs.constFind(chain[chainIdx]);
+                    if (citCost != costs.cend())
+                        bestCost = qMin(bestCost, *citCost);
+                }
+                isMatched = (bestCost != std::numeric_limits<unsigned int>::max());
+                cost += bestCost;
+            }
+            if (!isMatched)
+                continue;
+
+            Candidate candidate;
+            candidate.cost = cost;
+            candidate.record = record;
+            candidate.index = &index;
+            outCandidates.push_back(candidate);
+        }
+    }
+}
+
+bool OsmAnd::ForwardGeocoder_P::geocode(
+    const QString& query,
+    QList<Result>& outResults,
+    const unsigned int maxResultsCount,
+    const IQueryController* const controller) const
+{
+    outResults.clear();
+    const auto words = AddressNameTrie::normalizeAndSplit(query);
+    if (words.isEmpty())
+        return false;
+
+    // Indices are kept alive until results are filled, candidates only point to them
+    QList< std::shared_ptr<const AddressNameTrie> > indices;
+    QList<Candidate> candidates;
+    const auto dataInterface = owner->obfsCollection->obtainDataInterface();
+    for (const auto& obfReader : constOf(dataInterface->obfReaders))
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        const auto index = obtainIndex(obfReader, controller);
+        if (!index)
+            continue;
+        indices.push_back(index);
+
+        collectCandidates(*index, words, candidates);
+    }
+    if (candidates.isEmpty())
+        return false;
+
+    const auto resultsCount = qMin(static_cast<int>(maxResultsCount), candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + resultsCount, candidates.end(), candidateComparator);
+    for (auto candidateIdx = 0; candidateIdx < resultsCount; candidateIdx++)
+    {
+        const auto& candidate = candidates[candidateIdx];
+        const auto& index = *candidate.index;
+        const auto& record = index.getRecord(candidate.record);
+
+        Result result;
+        result.name = index.getRecordName(candidate.record);
+        result.position31 = record.position31;
+        result.cost = candidate.cost;
+        switch (record.type)
+        {
+            case AddressNameTrie::RecordType::Settlement:
+                result.type = ResultType::Settlement;
+                break;
+            case AddressNameTrie::RecordType::Street:
+                result.type = ResultType::Street;
+                result.settlementName = index.getRecordName(record.parent);
+                break;
+            case AddressNameTrie::RecordType::Building:
+                result.type = ResultType::Building;
+                result.streetName = index.getRecordName(record.parent);
+                result.settlementName = index.getRecordName(index.getRecord(record.parent).parent);
+                break;
+        }
+        outResults.push_back(result);
+    }
+
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef _OSMAND_CORE_FORWARD_GEOCODER_P_H_
+#define _OSMAND_CORE_FORWARD_GEOCODER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "ForwardGeocoder.h"
+
+namespace OsmAnd
+{
+    class ObfReader;
+    class AddressNameTrie;
+    class IQueryController;
+
+    class ForwardGeocoder;
+    class ForwardGeocoder_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(ForwardGeocoder_P);
+
+    public:
+        typedef ForwardGeocoder::Result Result;
+        typedef ForwardGeocoder::ResultType ResultType;
+
+    private:
+        struct Candidate
+        {
+            unsigned int cost;
+            int record;
+            const AddressNameTrie* index;
+        };
+
+        // Indices are keyed by path of OBF file. Index is built while lock is held, so that concurrent
+        // queries don't build the same index twice
+        mutable QMutex _indicesMutex;
+        mutable QHash< QString, std::shared_ptr<const AddressNameTrie> > _indices;
+
+        // Shorter words of query are matched only as whole words
+        static const int MinPrefixLength;
+        static unsigned int getMaxEdits(const QString& word);
+        static bool candidateComparator(const Candidate& l, const Candidate& r);
+
+        std::shared_ptr<const AddressNameTrie> obtainIndex(
+            const std::shared_ptr<const ObfReader>& obfReader,
+            const IQueryController* const controller) const;
+        void collectCandidates(
+            const AddressNameTrie& index,
+            const QStringList& words,
+            QList<Candidate>& outCandidates) const;
+    protected:
+        ForwardGeocoder_P(ForwardGeocoder* const owner);
+    public:
+        ~ForwardGeocoder_P();
+
+        ImplementationInterface<ForwardGeocoder> owner;
+
+        bool prepareIndices(const IQueryController* const controller) const;
+        int getIndexedNamesCount() const;
+        size_t getMemoryUsage() const;
+
+        bool geocode(
+            const QString& query,
+            QList<Result>& outResults,
+            const unsigned int maxResultsCount,
+            const IQueryController* const controller) const;
+
+    friend class OsmAnd::ForwardGeocoder;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_FORWARD_GEOCODER_P_H_)
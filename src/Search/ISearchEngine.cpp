@@ -15,3 +15,19 @@ OsmAnd::ISearchEngine::IDataSource::IDataSource()
 OsmAnd::ISearchEngine::IDataSource::~IDataSource()
 {
 }
+
+OsmAnd::ISearchEngine::ISearchResult::ISearchResult()
+{
+}
+
+OsmAnd::ISearchEngine::ISearchResult::~ISearchResult()
+{
+}
+
+OsmAnd::ISearchEngine::ISearchResults::ISearchResults()
+{
+}
+
+OsmAnd::ISearchEngine::ISearchResults::~ISearchResults()
+{
+}
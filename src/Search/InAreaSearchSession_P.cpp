@@ -13,10 +13,31 @@ OsmAnd::InAreaSearchSession_P::~InAreaSearchSession_P()
 
 void OsmAnd::InAreaSearchSession_P::setArea(const AreaI64& area)
 {
-    int i = 5;
+    QWriteLocker scopedLocker(&_areaLock);
+
+    _area = area;
 }
 
 OsmAnd::AreaI64 OsmAnd::InAreaSearchSession_P::getArea() const
 {
-    return AreaI64();
+    QReadLocker scopedLocker(&_areaLock);
+
+    return _area;
+}
+
+bool OsmAnd::InAreaSearchSession_P::obtainSearchBbox31(AreaI& outBbox31) const
+{
+    QReadLocker scopedLocker(&_areaLock);
+
+    if (_area.width() <= 0 || _area.height() <= 0)
+        return false;
+
+    // Area may exceed 31-bit space, so limit it to valid range
+    const int64_t maxCoordinate31 = std::numeric_limits<int32_t>::max();
+    outBbox31.top() = static_cast<int32_t>(qBound<int64_t>(0, _area.top(), maxCoordinate31));
+    outBbox31.left() = static_cast<int32_t>(qBound<int64_t>(0, _area.left(), maxCoordinate31));
+    outBbox31.bottom() = static_cast<int32_t>(qBound<int64_t>(0, _area.bottom(), maxCoordinate31));
+    outBbox31.right() = static_cast<int32_t>(qBound<int64_t>(0, _area.right(), maxCoordinate31));
+
+    return true;
 }
@@ -7,6 +7,7 @@
 #include "ignore_warnings_on_external_includes.h"
 #include <QList>
 #include <QLinkedList>
+#include <QReadWriteLock>
 #include "restore_internal_warnings.h"
 
 #include "OsmAndCore.h"
@@ -22,8 +23,12 @@ namespace OsmAnd
         Q_DISABLE_COPY_AND_MOVE(InAreaSearchSession_P);
 
     private:
+        AreaI64 _area;
+        mutable QReadWriteLock _areaLock;
     protected:
         InAreaSearchSession_P(InAreaSearchSession* const owner);
+
+        virtual bool obtainSearchBbox31(AreaI& outBbox31) const;
     public:
         virtual ~InAreaSearchSession_P();
 
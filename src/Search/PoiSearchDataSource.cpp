@@ -10,3 +10,33 @@ OsmAnd::PoiSearchDataSource::PoiSearchDataSource(const std::shared_ptr<const IOb
 OsmAnd::PoiSearchDataSource::~PoiSearchDataSource()
 {
 }
+
+bool OsmAnd::PoiSearchDataSource::obtainResults(
+    const QString& query,
+    const AreaI* const bbox31,
+    const NewResultCallback newResultCallback,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->obtainResults(query, bbox31, newResultCallback, controller);
+}
+
+std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResult> OsmAnd::PoiSearchDataSource::refineResult(
+    const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+    const QString& query) const
+{
+    return _p->refineResult(result, query);
+}
+
+OsmAnd::PoiSearchDataSource::ResultEntry::ResultEntry(
+    const std::shared_ptr<const Amenity>& amenity_,
+    const QString& matchString_,
+    const float matchFactor_,
+    const QList< std::pair<int, int> >& matchedRanges_)
+    : BaseSearchResult(matchString_, matchFactor_, matchedRanges_)
+    , amenity(amenity_)
+{
+}
+
+OsmAnd::PoiSearchDataSource::ResultEntry::~ResultEntry()
+{
+}
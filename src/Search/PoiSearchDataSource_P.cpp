@@ -1,6 +1,21 @@
 #include "PoiSearchDataSource_P.h"
 #include "PoiSearchDataSource.h"
 
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QStringList>
+#include <QRegExp>
+#include "restore_internal_warnings.h"
+
+#include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfInfo.h"
+#include "ObfPoiSectionInfo.h"
+#include "ObfPoiSectionReader.h"
+#include "Amenity.h"
+#include "BaseSearchEngine.h"
+#include "IQueryController.h"
+
 OsmAnd::PoiSearchDataSource_P::PoiSearchDataSource_P(PoiSearchDataSource* const owner_)
     : owner(owner_)
 {
@@ -9,3 +24,85 @@ OsmAnd::PoiSearchDataSource_P::PoiSearchDataSource_P(PoiSearchDataSource* const
 OsmAnd::PoiSearchDataSource_P::~PoiSearchDataSource_P()
 {
 }
+
+bool OsmAnd::PoiSearchDataSource_P::obtainResults(
+    const QString& query,
+    const AreaI* const bbox31,
+    const NewResultCallback newResultCallback,
+    const IQueryController* const controller) const
+{
+    const auto queryTokens = query.split(QRegExp(QLatin1String("\\s+")), QString::SkipEmptyParts);
+    if (queryTokens.isEmpty())
+        return true;
+    const auto& firstQueryToken = queryTokens.first();
+
+    const auto dataInterface = bbox31
+        ? owner->obfsCollection->obtainDataInterface(*bbox31)
+        : owner->obfsCollection->obtainDataInterface();
+
+    for (const auto& obfReader : constOf(dataInterface->obfReaders))
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        const auto& obfInfo = obfReader->obtainInfo();
+        for (const auto& poiSection : constOf(obfInfo->poiSections))
+        {
+            if (controller && controller->isAborted())
+                return false;
+
+            // Name index is used to reach only amenities which have a word starting with the first token,
+            // the rest of tokens is checked by matching. Amenities are reported right from the visitor
+            ObfPoiSectionReader::searchAmenitiesByName(
+                obfReader,
+                poiSection,
+                firstQueryToken,
+                bbox31,
+                nullptr,
+                nullptr,
+                [this, query, newResultCallback]
+                (const std::shared_ptr<const Amenity>& amenity) -> bool
+                {
+                    const auto resultEntry = matchAmenity(amenity, query);
+                    if (!resultEntry)
+                        return false;
+
+                    newResultCallback(owner, resultEntry);
+                    return true;
+                },
+                controller);
+        }
+    }
+
+    return !(controller && controller->isAborted());
+}
+
+std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResult> OsmAnd::PoiSearchDataSource_P::refineResult(
+    const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+    const QString& query) const
+{
+    const auto resultEntry = std::dynamic_pointer_cast<const ResultEntry>(result);
+    if (!resultEntry)
+        return nullptr;
+
+    return matchAmenity(resultEntry->amenity, query);
+}
+
+std::shared_ptr<const OsmAnd::PoiSearchDataSource_P::ResultEntry> OsmAnd::PoiSearchDataSource_P::matchAmenity(
+    const std::shared_ptr<const Amenity>& amenity,
+    const QString& query)
+{
+    float matchFactor = 0.0f;
+    QList< std::pair<int, int> > matchedRanges;
+    if (BaseSearchEngine::match(query, amenity->name, &matchFactor, &matchedRanges))
+        return std::make_shared<ResultEntry>(amenity, amenity->name, matchFactor, matchedRanges);
+
+    // Latin name is checked only as a fallback, since it's usually a transliteration of the native one
+    if (amenity->latinName != amenity->name &&
+        BaseSearchEngine::match(query, amenity->latinName, &matchFactor, &matchedRanges))
+    {
+        return std::make_shared<ResultEntry>(amenity, amenity->latinName, matchFactor, matchedRanges);
+    }
+
+    return nullptr;
+}
@@ -10,15 +10,26 @@
 #include "OsmAndCore.h"
 #include "PrivateImplementation.h"
 #include "IObfsCollection.h"
+#include "PoiSearchDataSource.h"
 
 namespace OsmAnd
 {
+    class Amenity;
+    class IQueryController;
+
     class PoiSearchDataSource;
     class PoiSearchDataSource_P Q_DECL_FINAL
     {
         Q_DISABLE_COPY_AND_MOVE(PoiSearchDataSource_P);
 
+    public:
+        typedef PoiSearchDataSource::ResultEntry ResultEntry;
+        typedef PoiSearchDataSource::NewResultCallback NewResultCallback;
+
     private:
+        static std::shared_ptr<const ResultEntry> matchAmenity(
+            const std::shared_ptr<const Amenity>& amenity,
+            const QString& query);
     protected:
         PoiSearchDataSource_P(PoiSearchDataSource* const owner);
     public:
@@ -26,6 +37,15 @@ namespace OsmAnd
 
         ImplementationInterface<PoiSearchDataSource> owner;
 
+        bool obtainResults(
+            const QString& query,
+            const AreaI* const bbox31,
+            const NewResultCallback newResultCallback,
+            const IQueryController* const controller) const;
+        std::shared_ptr<const ISearchEngine::ISearchResult> refineResult(
+            const std::shared_ptr<const ISearchEngine::ISearchResult>& result,
+            const QString& query) const;
+
     friend class OsmAnd::PoiSearchDataSource;
     };
 }
@@ -227,3 +227,58 @@ bool OsmAnd::TileDB::obtainTileData( const TileId tileId, const ZoomLevel zoom,
     
     return hit;
 }
+
+bool OsmAnd::TileDB::obtainTilesList(QList< std::pair<TileId, ZoomLevel> >& outTiles)
+{
+    QMutexLocker scopeLock(&_indexMutex);
+
+    // Check that index is available
+    if (!_indexDb.isOpen())
+    {
+        if (!openIndex())
+            return false;
+    }
+
+    QSqlQuery filesQuery(_indexDb);
+    if (!filesQuery.exec("SELECT filename FROM tiledb_files"))
+        return false;
+
+    while(filesQuery.next())
+    {
+        const auto dbFilename = filesQuery.value(0).toString();
+
+        // Open database
+        const auto connectionName = QLatin1String("tiledb-sqlite:") + dbFilename;
+        QSqlDatabase db;
+        if (!QSqlDatabase::contains(connectionName))
+            db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        else
+            db = QSqlDatabase::database(connectionName);
+        db.setDatabaseName(dbFilename);
+        if (!db.open())
+        {
+            LogPrintf(LogSeverityLevel::Error, "Failed to open TileDB from '%s': %s", qPrintable(dbFilename), qPrintable(db.lastError().text()));
+            return false;
+        }
+
+        // List all tiles stored in this database
+        QSqlQuery query(db);
+        if (query.exec("SELECT x, y, zoom FROM tiles"))
+        {
+            while(query.next())
+            {
+                TileId tileId;
+                tileId.x = query.value(0).toInt();
+                tileId.y = query.value(1).toInt();
+                const auto zoom = static_cast<ZoomLevel>(query.value(2).toInt());
+
+                outTiles.push_back(std::make_pair(tileId, zoom));
+            }
+        }
+
+        // Close database
+        db.close();
+    }
+
+    return true;
+}
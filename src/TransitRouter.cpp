@@ -0,0 +1,92 @@
+#include "TransitRouter.h"
+#include "TransitRouter_P.h"
+
+#include "TransportRoute.h"
+
+OsmAnd::TransitRouter::TransitRouter(
+    const std::shared_ptr<const IObfsCollection>& obfsCollection_,
+    const Settings& settings_ /*= Settings()*/)
+    : _p(new TransitRouter_P(this))
+    , obfsCollection(obfsCollection_)
+    , settings(settings_)
+{
+    _p->initialize();
+}
+
+OsmAnd::TransitRouter::~TransitRouter()
+{
+}
+
+int OsmAnd::TransitRouter::getStopsCount() const
+{
+    return _p->getStopsCount();
+}
+
+int OsmAnd::TransitRouter::getRoutesCount() const
+{
+    return _p->getRoutesCount();
+}
+
+int OsmAnd::TransitRouter::getTripsCount() const
+{
+    return _p->getTripsCount();
+}
+
+bool OsmAnd::TransitRouter::findJourneys(
+    const PointI start31,
+    const PointI finish31,
+    const unsigned int departureTime,
+    QList<Journey>& outJourneys,
+    const IQueryController* const controller /*= nullptr*/) const
+{
+    return _p->findJourneys(start31, finish31, departureTime, outJourneys, controller);
+}
+
+OsmAnd::TransitRouter::Settings::Settings()
+    : serviceStartTime(5 * 60 * 60)
+    , serviceEndTime(24 * 60 * 60)
+    , headway(10 * 60)
+    , dwellTime(20)
+    , defaultSpeed(5.5f)
+    , walkingSpeed(1.3f)
+    , maxTransferDistance(300.0)
+    , maxAccessDistance(800.0)
+    , maxTransfersCount(4)
+{
+    speedsByType.insert(QLatin1String("bus"), 5.5f);
+    speedsByType.insert(QLatin1String("trolleybus"), 5.5f);
+    speedsByType.insert(QLatin1String("share_taxi"), 6.0f);
+    speedsByType.insert(QLatin1String("tram"), 5.0f);
+    speedsByType.insert(QLatin1String("light_rail"), 8.0f);
+    speedsByType.insert(QLatin1String("subway"), 9.5f);
+    speedsByType.insert(QLatin1String("train"), 16.0f);
+    speedsByType.insert(QLatin1String("ferry"), 5.0f);
+}
+
+OsmAnd::TransitRouter::Settings::~Settings()
+{
+}
+
+OsmAnd::TransitRouter::Leg::Leg()
+    : type(LegType::Walk)
+    , startStopId(-1)
+    , endStopId(-1)
+    , departureTime(0)
+    , arrivalTime(0)
+{
+}
+
+OsmAnd::TransitRouter::Leg::~Leg()
+{
+}
+
+OsmAnd::TransitRouter::Journey::Journey()
+    : departureTime(0)
+    , arrivalTime(0)
+    , ridesCount(0)
+{
+}
+
+OsmAnd::TransitRouter::Journey::~Journey()
+{
+}
@@ -0,0 +1,393 @@
+#include "TransitRouter_P.h"
+#include "TransitRouter.h"
+
+#include "stdlib_common.h"
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QSet>
+#include "restore_internal_warnings.h"
+
+#include "IObfsCollection.h"
+#include "ObfDataInterface.h"
+#include "ObfReader.h"
+#include "ObfInfo.h"
+#include "ObfTransportSectionInfo.h"
+#include "ObfTransportSectionReader.h"
+#include "TransportStop.h"
+#include "TransportRoute.h"
+#include "TransitTimetable.h"
+#include "IQueryController.h"
+#include "Utilities.h"
+
+const uint32_t OsmAnd::TransitRouter_P::InfiniteTime = std::numeric_limits<uint32_t>::max();
+
+OsmAnd::TransitRouter_P::TransitRouter_P(TransitRouter* const owner_)
+    : owner(owner_)
+{
+}
+
+OsmAnd::TransitRouter_P::~TransitRouter_P()
+{
+}
+
+void OsmAnd::TransitRouter_P::initialize()
+{
+    QList< std::shared_ptr<const TransportRoute> > routes;
+    QSet<uint64_t> routesIds;
+
+    const auto dataInterface = owner->obfsCollection->obtainDataInterface();
+    for (const auto& obfReader : constOf(dataInterface->obfReaders))
+    {
+        const auto& obfInfo = obfReader->obtainInfo();
+        for (const auto& transportSection : constOf(obfInfo->transportSections))
+        {
+            // Stops are read only to collect routes that serve them
+            QList<uint32_t> routesOffsets;
+            ObfTransportSectionReader::loadStops(
+                obfReader,
+                transportSection,
+                nullptr,
+                nullptr,
+                [&routesOffsets]
+                (const std::shared_ptr<const TransportStop>& stop) -> bool
+                {
+                    for (const auto routeOffset : constOf(stop->routesOffsets))
+                        routesOffsets.push_back(routeOffset);
+                    return false;
+                });
+
+            QList< std::shared_ptr<const TransportRoute> > sectionRoutes;
+            ObfTransportSectionReader::loadRoutes(obfReader, transportSection, routesOffsets, &sectionRoutes);
+            for (const auto& route : constOf(sectionRoutes))
+            {
+                // Route that crosses borders of OBF files is stored in each of them
+                if (routesIds.contains(route->id))
+                    continue;
+                routesIds.insert(route->id);
+
+                routes.push_back(route);
+            }
+        }
+    }
+
+    _timetable.reset(new TransitTimetable(routes, owner->settings));
+}
+
+int OsmAnd::TransitRouter_P::getStopsCount() const
+{
+    return _timetable->getStopsCount();
+}
+
+int OsmAnd::TransitRouter_P::getRoutesCount() const
+{
+    return _timetable->getPatternsCount();
+}
+
+int OsmAnd::TransitRouter_P::getTripsCount() const
+{
+    return _timetable->getTripsCount();
+}
+
+bool OsmAnd::TransitRouter_P::findJourneys(
+    const PointI start31,
+    const PointI finish31,
+    const unsigned int departureTime,
+    QList<Journey>& outJourneys,
+    const IQueryController* const controller) const
+{
+    outJourneys.clear();
+
+    const auto& settings = owner->settings;
+    const auto& timetable = *_timetable;
+    const auto stopsCount = timetable.getStopsCount();
+    const auto pPatternStops = timetable.getPatternStops();
+    const auto pArrivalOffsets = timetable.getArrivalOffsets();
+    const auto pDepartureOffsets = timetable.getDepartureOffsets();
+    const auto pTripStartTimes = timetable.getTripStartTimes();
+    const auto getWalkingTime =
+        [&settings]
+        (const double distance) -> uint32_t
+        {
+            return static_cast<uint32_t>(qCeil(distance / settings.walkingSpeed));
+        };
+
+    // Each found arrival at finish is earlier than previous one, but takes more rides
+    QList<Arrival> arrivals;
+    uint32_t bestFinishTime = InfiniteTime;
+    const auto directDistance = Utilities::distance31(start31, finish31);
+    if (directDistance <= settings.maxAccessDistance)
+    {
+        Arrival arrival;
+        arrival.round = 0;
+        arrival.egressStop = -1;
+        arrival.time = departureTime + getWalkingTime(directDistance);
+        arrivals.push_back(arrival);
+
+        bestFinishTime = arrival.time;
+    }
+
+    QVector<TransitTimetable::StopDistance> accessStops;
+    QVector<TransitTimetable::StopDistance> egressStops;
+    timetable.findStopsWithin(start31, settings.maxAccessDistance, accessStops);
+    timetable.findStopsWithin(finish31, settings.maxAccessDistance, egressStops);
+
+    // Arrival times and labels of round K are [K * stopsCount; (K + 1) * stopsCount). Only stops improved
+    // in a round get time in it, since stops reached earlier were already scanned from
+    Label emptyLabel;
+    emptyLabel.type = Label::Type::None;
+    QVector<uint32_t> roundsArrivalTimes(stopsCount, InfiniteTime);
+    QVector<Label> roundsLabels(stopsCount, emptyLabel);
+    QVector<uint32_t> bestArrivalTimes(stopsCount, InfiniteTime);
+    QVector<bool> marked(stopsCount, false);
+    QVector<int> markedStops;
+    const auto markStop =
+        [&marked, &markedStops]
+        (const int stop)
+        {
+            if (marked[stop])
+                return;
+
+            marked[stop] = true;
+            markedStops.push_back(stop);
+        };
+
+    for (const auto& accessStop : constOf(accessStops))
+    {
+        const auto stop = accessStop.first;
+        const auto time = departureTime + getWalkingTime(accessStop.second);
+
+        roundsArrivalTimes[stop] = time;
+        roundsLabels[stop].type = Label::Type::Access;
+        bestArrivalTimes[stop] = time;
+        markStop(stop);
+    }
+
+    QVector<int> patternsScanStarts(timetable.getPatternsCount(), -1);
+    QVector<int> scannedPatterns;
+    QVector<int> rideMarkedStops;
+    for (auto round = 1u; round <= settings.maxTransfersCount + 1 && !markedStops.isEmpty(); round++)
+    {
+        if (controller && controller->isAborted())
+            return false;
+
+        // Each pattern is scanned once, starting from its first stop that was improved in previous round
+        scannedPatterns.clear();
+        for (const auto stop : constOf(markedStops))
+        {
+            marked[stop] = false;
+
+            const auto pStopPatternsEnd = timetable.getStopPatternsEnd(stop);
+            for (auto pStopPattern = timetable.getStopPatternsBegin(stop); pStopPattern != pStopPatternsEnd; ++pStopPattern)
+            {
+                auto& scanStart = patternsScanStarts[pStopPattern->pattern];
+                if (scanStart < 0)
+                {
+                    scanStart = pStopPattern->position;
+                    scannedPatterns.push_back(pStopPattern->pattern);
+                }
+                else if (static_cast<int>(pStopPattern->position) < scanStart)
+                {
+                    scanStart = pStopPattern->position;
+                }
+            }
+        }
+        markedStops.clear();
+
+        roundsArrivalTimes.insert(roundsArrivalTimes.end(), stopsCount, InfiniteTime);
+        roundsLabels.insert(roundsLabels.end(), stopsCount, emptyLabel);
+        const auto pPreviousTimes = roundsArrivalTimes.constData() + (round - 1) * stopsCount;
+        const auto pTimes = roundsArrivalTimes.data() + round * stopsCount;
+        const auto pLabels = roundsLabels.data() + round * stopsCount;
+
+        for (const auto patternIdx : constOf(scannedPatterns))
+        {
+            const auto& pattern = timetable.getPattern(patternIdx);
+            const auto pStops = pPatternStops + pattern.firstStop;
+            const auto pArrivals = pArrivalOffsets + pattern.firstStop;
+            const auto pDepartures = pDepartureOffsets + pattern.firstStop;
+
+            auto trip = -1;
+            uint32_t tripStartTime = 0;
+            uint32_t boardPosition = 0;
+            for (auto position = static_cast<uint32_t>(patternsScanStarts[patternIdx]); position < pattern.stopsCount; position++)
+            {
+                const auto stop = pStops[position];
+
+                if (trip >= 0)
+                {
+                    const auto time = tripStartTime + pArrivals[position];
+                    if (time < bestArrivalTimes[stop] && time < bestFinishTime)
+                    {
+                        pTimes[stop] = time;
+                        bestArrivalTimes[stop] = time;
+
+                        auto& label = pLabels[stop];
+                        label.type = Label::Type::Ride;
+                        label.pattern = patternIdx;
+                        label.trip = trip;
+                        label.boardPosition = boardPosition;
+                        label.alightPosition = position;
+
+                        markStop(stop);
+                    }
+                }
+
+                // Stop reached in previous round may allow to catch earlier trip
+                const auto previousTime = pPreviousTimes[stop];
+                if (previousTime != InfiniteTime && (trip < 0 || previousTime <= tripStartTime + pDepartures[position]))
+                {
+                    const auto earliestTrip = timetable.findEarliestTrip(pattern, position, previousTime);
+                    if (earliestTrip >= 0 && (trip < 0 || earliestTrip < trip))
+                    {
+                        trip = earliestTrip;
+                        tripStartTime = pTripStartTimes[pattern.firstTrip + trip];
+                        boardPosition = position;
+                    }
+                }
+            }
+
+            patternsScanStarts[patternIdx] = -1;
+        }
+
+        // Transfers are walked only from stops reached by ride in this round
+        rideMarkedStops = markedStops;
+        for (const auto stop : constOf(rideMarkedStops))
+        {
+            const auto pTransfersEnd = timetable.getTransfersEnd(stop);
+            for (auto pTransfer = timetable.getTransfersBegin(stop); pTransfer != pTransfersEnd; ++pTransfer)
+            {
+                const auto target = pTransfer->target;
+                const auto time = pTimes[stop] + pTransfer->duration;
+                if (time >= bestArrivalTimes[target] || time >= bestFinishTime)
+                    continue;
+
+                pTimes[target] = time;
+                bestArrivalTimes[target] = time;
+
+                auto& label = pLabels[target];
+                label.type = Label::Type::Transfer;
+                label.sourceStop = stop;
+
+                markStop(target);
+            }
+        }
+
+        Arrival arrival;
+        arrival.round = round;
+        arrival.egressStop = -1;
+        for (const auto& egressStop : constOf(egressStops))
+        {
+            const auto stopTime = pTimes[egressStop.first];
+            if (stopTime == InfiniteTime)
+                continue;
+
+            const auto time = stopTime + getWalkingTime(egressStop.second);
+            if (time < bestFinishTime)
+            {
+                bestFinishTime = time;
+                arrival.egressStop = egressStop.first;
+                arrival.time = time;
+            }
+        }
+        if (arrival.egressStop >= 0)
+            arrivals.push_back(arrival);
+    }
+
+    for (const auto& arrival : constOf(arrivals))
+    {
+        Journey journey;
+        buildJourney(start31, finish31, departureTime, roundsArrivalTimes, roundsLabels, arrival, journey);
+        outJourneys.push_back(journey);
+    }
+
+    return !outJourneys.isEmpty();
+}
+
+void OsmAnd::TransitRouter_P::buildJourney(
+    const PointI start31,
+    const PointI finish31,
+    const unsigned int departureTime,
+    const QVector<uint32_t>& roundsArrivalTimes,
+    const QVector<Label>& roundsLabels,
+    const Arrival& arrival,
+    Journey& outJourney) const
+{
+    const auto& timetable = *_timetable;
+    const auto stopsCount = timetable.getStopsCount();
+
+    outJourney.departureTime = departureTime;
+    outJourney.arrivalTime = arrival.time;
+    outJourney.ridesCount = arrival.round;
+
+    Leg finishLeg;
+    finishLeg.type = LegType::Walk;
+    finishLeg.end31 = finish31;
+    finishLeg.arrivalTime = arrival.time;
+    if (arrival.egressStop < 0)
+    {
+        finishLeg.start31 = start31;
+        finishLeg.departureTime = departureTime;
+        outJourney.legs.push_back(finishLeg);
+        return;
+    }
+    finishLeg.startStopId = timetable.getStopId(arrival.egressStop);
+    finishLeg.start31 = timetable.getStopPosition(arrival.egressStop);
+    finishLeg.departureTime = roundsArrivalTimes[arrival.round * stopsCount + arrival.egressStop];
+    outJourney.legs.push_front(finishLeg);
+
+    // Legs are restored from finish back to start
+    auto round = arrival.round;
+    auto stop = arrival.egressStop;
+    for (;;)
+    {
+        const auto& label = roundsLabels[round * stopsCount + stop];
+        const auto time = roundsArrivalTimes[round * stopsCount + stop];
+
+        Leg leg;
+        leg.endStopId = timetable.getStopId(stop);
+        leg.end31 = timetable.getStopPosition(stop);
+        leg.arrivalTime = time;
+        if (label.type == Label::Type::Access)
+        {
+            leg.type = LegType::Walk;
+            leg.start31 = start31;
+            leg.departureTime = departureTime;
+            outJourney.legs.push_front(leg);
+            break;
+        }
+        else if (label.type == Label::Type::Transfer)
+        {
+            leg.type = LegType::Walk;
+            leg.startStopId = timetable.getStopId(label.sourceStop);
+            leg.start31 = timetable.getStopPosition(label.sourceStop);
+            leg.departureTime = roundsArrivalTimes[round * stopsCount + label.sourceStop];
+            outJourney.legs.push_front(leg);
+
+            stop = label.sourceStop;
+        }
+        else if (label.type == Label::Type::Ride)
+        {
+            const auto& pattern = timetable.getPattern(label.pattern);
+            const auto boardStop = timetable.getPatternStops()[pattern.firstStop + label.boardPosition];
+            const auto tripStartTime = timetable.getTripStartTimes()[pattern.firstTrip + label.trip];
+
+            leg.type = LegType::Ride;
+            leg.route = pattern.route;
+            leg.startStopId = timetable.getStopId(boardStop);
+            leg.start31 = timetable.getStopPosition(boardStop);
+            leg.departureTime = tripStartTime + timetable.getDepartureOffsets()[pattern.firstStop + label.boardPosition];
+            outJourney.legs.push_front(leg);
+
+            stop = boardStop;
+            round--;
+        }
+        else
+        {
+            // Every reached stop has a label, so this is never expected
+            assert(false);
+            break;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef _OSMAND_CORE_TRANSIT_ROUTER_P_H_
+#define _OSMAND_CORE_TRANSIT_ROUTER_P_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "PrivateImplementation.h"
+#include "TransitRouter.h"
+
+namespace OsmAnd
+{
+    class TransitTimetable;
+
+    class TransitRouter;
+    class TransitRouter_P Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(TransitRouter_P);
+
+    public:
+        typedef TransitRouter::Journey Journey;
+        typedef TransitRouter::Leg Leg;
+        typedef TransitRouter::LegType LegType;
+
+        static const uint32_t InfiniteTime;
+
+    private:
+        // How stop was reached in a round: by walking from start, by a ride that began at stop reached
+        // in previous round, or by walking from other stop reached in the same round
+        struct Label
+        {
+            enum class Type : uint8_t
+            {
+                None,
+                Access,
+                Ride,
+                Transfer
+            };
+
+            Type type;
+            uint32_t pattern;
+            uint32_t trip;
+            uint32_t boardPosition;
+            uint32_t alightPosition;
+            uint32_t sourceStop;
+        };
+
+        struct Arrival
+        {
+            unsigned int round;
+            int egressStop;
+            uint32_t time;
+        };
+
+        std::shared_ptr<const TransitTimetable> _timetable;
+
+        void buildJourney(
+            const PointI start31,
+            const PointI finish31,
+            const unsigned int departureTime,
+            const QVector<uint32_t>& roundsArrivalTimes,
+            const QVector<Label>& roundsLabels,
+            const Arrival& arrival,
+            Journey& outJourney) const;
+    protected:
+        TransitRouter_P(TransitRouter* const owner);
+
+        void initialize();
+    public:
+        ~TransitRouter_P();
+
+        ImplementationInterface<TransitRouter> owner;
+
+        int getStopsCount() const;
+        int getRoutesCount() const;
+        int getTripsCount() const;
+
+        bool findJourneys(
+            const PointI start31,
+            const PointI finish31,
+            const unsigned int departureTime,
+            QList<Journey>& outJourneys,
+            const IQueryController* const controller) const;
+
+    friend class OsmAnd::TransitRouter;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TRANSIT_ROUTER_P_H_)
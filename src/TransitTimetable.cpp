@@ -0,0 +1,299 @@
+#include "TransitTimetable.h"
+
+#include "stdlib_common.h"
+#include <algorithm>
+#include <limits>
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QHash>
+#include "restore_internal_warnings.h"
+
+#include "TransportRoute.h"
+#include "Utilities.h"
+
+const int OsmAnd::TransitTimetable::CellSizeShift = 15;
+
+OsmAnd::TransitTimetable::TransitTimetable(
+    const QList< std::shared_ptr<const TransportRoute> >& routes,
+    const TransitRouter::Settings& settings)
+{
+    // Stops are shared by all routes that pass them, and identified by id
+    QHash<int64_t, uint32_t> stopsIndicesById;
+    QVector<uint32_t> stops;
+    for (const auto& route : constOf(routes))
+    {
+        for (const auto isReverse : { false, true })
+        {
+            const auto& routeStops = isReverse ? route->reverseStops : route->forwardStops;
+
+            stops.clear();
+            for (const auto& routeStop : constOf(routeStops))
+            {
+                auto itStopIndex = stopsIndicesById.find(routeStop.id);
+                if (itStopIndex == stopsIndicesById.end())
+                {
+                    itStopIndex = stopsIndicesById.insert(routeStop.id, _stopIds.size());
+                    _stopIds.push_back(routeStop.id);
+                    _stopPositions.push_back(routeStop.position31);
+                }
+                if (stops.isEmpty() || stops.last() != *itStopIndex)
+                    stops.push_back(*itStopIndex);
+            }
+            if (stops.size() < 2)
+                continue;
+
+            addPattern(route, isReverse, stops, settings);
+        }
+    }
+    _stopIds.squeeze();
+    _stopPositions.squeeze();
+    _patterns.squeeze();
+    _patternStops.squeeze();
+    _arrivalOffsets.squeeze();
+    _departureOffsets.squeeze();
+    _tripStartTimes.squeeze();
+
+    buildStopPatterns();
+    buildCells();
+    buildTransfers(settings);
+}
+
+OsmAnd::TransitTimetable::~TransitTimetable()
+{
+}
+
+uint64_t OsmAnd::TransitTimetable::makeCellKey(const int32_t cellX, const int32_t cellY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+void OsmAnd::TransitTimetable::addPattern(
+    const std::shared_ptr<const TransportRoute>& route,
+    const bool isReverse,
+    const QVector<uint32_t>& stops,
+    const TransitRouter::Settings& settings)
+{
+    const auto speed = settings.speedsByType.value(route->type, settings.defaultSpeed);
+
+    Pattern pattern;
+    pattern.route = route;
+    pattern.isReverse = isReverse;
+    pattern.firstStop = _patternStops.size();
+    pattern.stopsCount = stops.size();
+    pattern.firstTrip = _tripStartTimes.size();
+
+    // Vehicle waits at every stop except first and last ones
+    uint32_t time = 0;
+    for (auto position = 0, stopsCount = stops.size(); position < stopsCount; position++)
+    {
+        const auto stop = stops[position];
+        if (position > 0)
+        {
+            const auto distance = Utilities::distance31(_stopPositions[stops[position - 1]], _stopPositions[stop]);
+            time += static_cast<uint32_t>(qCeil(distance / speed));
+        }
+
+        _patternStops.push_back(stop);
+        _arrivalOffsets.push_back(time);
+        if (position > 0 && position + 1 < stopsCount)
+            time += settings.dwellTime;
+        _departureOffsets.push_back(time);
+    }
+
+    if (settings.headway > 0)
+    {
+        for (auto startTime = settings.serviceStartTime; startTime <= settings.serviceEndTime; startTime += settings.headway)
+            _tripStartTimes.push_back(startTime);
+    }
+    else
+    {
+        _tripStartTimes.push_back(settings.serviceStartTime);
+    }
+    pattern.tripsCount = _tripStartTimes.size() - pattern.firstTrip;
+
+    _patterns.push_back(pattern);
+}
+
+void OsmAnd::TransitTimetable::buildStopPatterns()
+{
+    const auto stopsCount = _stopIds.size();
+
+    _firstStopPatterns.resize(stopsCount + 1);
+    std::fill(_firstStopPatterns.begin(), _firstStopPatterns.end(), 0u);
+    for (const auto stop : constOf(_patternStops))
+        _firstStopPatterns[stop + 1]++;
+    for (auto stop = 0; stop < stopsCount; stop++)
+        _firstStopPatterns[stop + 1] += _firstStopPatterns[stop];
+
+    QVector<uint32_t> nextStopPatterns(_firstStopPatterns.mid(0, stopsCount));
+    _stopPatterns.resize(_patternStops.size());
+    for (auto patternIdx = 0, patternsCount = _patterns.size(); patternIdx < patternsCount; patternIdx++)
+    {
+        const auto& pattern = _patterns[patternIdx];
+        for (auto position = 0u; position < pattern.stopsCount; position++)
+        {
+            auto& stopPattern = _stopPatterns[nextStopPatterns[_patternStops[pattern.firstStop + position]]++];
+            stopPattern.pattern = patternIdx;
+            stopPattern.position = position;
+        }
+    }
+}
+
+void OsmAnd::TransitTimetable::buildCells()
+{
+    const auto stopsCount = _stopIds.size();
+
+    QVector< std::pair<uint64_t, uint32_t> > cellsOfStops(stopsCount);
+    for (auto stop = 0; stop < stopsCount; stop++)
+    {
+        const auto& position31 = _stopPositions[stop];
+        cellsOfStops[stop] = std::make_pair(makeCellKey(position31.x >> CellSizeShift, position31.y >> CellSizeShift), stop);
+    }
+    std::sort(cellsOfStops.begin(), cellsOfStops.end());
+
+    _cellKeys.resize(stopsCount);
+    _cellStops.resize(stopsCount);
+    for (auto idx = 0; idx < stopsCount; idx++)
+    {
+        _cellKeys[idx] = cellsOfStops[idx].first;
+        _cellStops[idx] = cellsOfStops[idx].second;
+    }
+}
+
+void OsmAnd::TransitTimetable::buildTransfers(const TransitRouter::Settings& settings)
+{
+    const auto stopsCount = _stopIds.size();
+
+    _firstTransfers.resize(stopsCount + 1);
+    _firstTransfers[0] = 0;
+    QVector<StopDistance> nearbyStops;
+    for (auto stop = 0; stop < stopsCount; stop++)
+    {
+        findStopsWithin(_stopPositions[stop], settings.maxTransferDistance, nearbyStops);
+        for (const auto& nearbyStop : constOf(nearbyStops))
+        {
+            if (nearbyStop.first == stop)
+                continue;
+
+            Transfer transfer;
+            transfer.target = nearbyStop.first;
+            transfer.duration = static_cast<uint32_t>(qCeil(nearbyStop.second / settings.walkingSpeed));
+            _transfers.push_back(transfer);
+        }
+        _firstTransfers[stop + 1] = _transfers.size();
+    }
+    _transfers.squeeze();
+}
+
+int OsmAnd::TransitTimetable::getStopsCount() const
+{
+    return _stopIds.size();
+}
+
+int64_t OsmAnd::TransitTimetable::getStopId(const int stop) const
+{
+    return _stopIds[stop];
+}
+
+const OsmAnd::PointI& OsmAnd::TransitTimetable::getStopPosition(const int stop) const
+{
+    return _stopPositions[stop];
+}
+
+const OsmAnd::TransitTimetable::StopPattern* OsmAnd::TransitTimetable::getStopPatternsBegin(const int stop) const
+{
+    return _stopPatterns.constData() + _firstStopPatterns[stop];
+}
+
+const OsmAnd::TransitTimetable::StopPattern* OsmAnd::TransitTimetable::getStopPatternsEnd(const int stop) const
+{
+    return _stopPatterns.constData() + _firstStopPatterns[stop + 1];
+}
+
+const OsmAnd::TransitTimetable::Transfer* OsmAnd::TransitTimetable::getTransfersBegin(const int stop) const
+{
+    return _transfers.constData() + _firstTransfers[stop];
+}
+
+const OsmAnd::TransitTimetable::Transfer* OsmAnd::TransitTimetable::getTransfersEnd(const int stop) const
+{
+    return _transfers.constData() + _firstTransfers[stop + 1];
+}
+
+int OsmAnd::TransitTimetable::getPatternsCount() const
+{
+    return _patterns.size();
+}
+
+const OsmAnd::TransitTimetable::Pattern& OsmAnd::TransitTimetable::getPattern(const int pattern) const
+{
+    return _patterns[pattern];
+}
+
+const uint32_t* OsmAnd::TransitTimetable::getPatternStops() const
+{
+    return _patternStops.constData();
+}
+
+const uint32_t* OsmAnd::TransitTimetable::getArrivalOffsets() const
+{
+    return _arrivalOffsets.constData();
+}
+
+const uint32_t* OsmAnd::TransitTimetable::getDepartureOffsets() const
+{
+    return _departureOffsets.constData();
+}
+
+const uint32_t* OsmAnd::TransitTimetable::getTripStartTimes() const
+{
+    return _tripStartTimes.constData();
+}
+
+int OsmAnd::TransitTimetable::getTripsCount() const
+{
+    return _tripStartTimes.size();
+}
+
+int OsmAnd::TransitTimetable::findEarliestTrip(const Pattern& pattern, const uint32_t position, const uint32_t time) const
+{
+    const auto departureOffset = _departureOffsets[pattern.firstStop + position];
+    const auto minStartTime = (time > departureOffset) ? (time - departureOffset) : 0u;
+
+    const auto pTripsBegin = _tripStartTimes.constData() + pattern.firstTrip;
+    const auto pTripsEnd = pTripsBegin + pattern.tripsCount;
+    const auto pTrip = std::lower_bound(pTripsBegin, pTripsEnd, minStartTime);
+    if (pTrip == pTripsEnd)
+        return -1;
+
+    return static_cast<int>(pTrip - pTripsBegin);
+}
+
+void OsmAnd::TransitTimetable::findStopsWithin(
+    const PointI& position31,
+    const double radiusInMeters,
+    QVector<StopDistance>& outStops) const
+{
+    outStops.clear();
+
+    const auto radiusX31 = Utilities::metersToX31(radiusInMeters);
+    const auto radiusY31 = Utilities::metersToY31(radiusInMeters);
+    const auto minCellX = static_cast<int32_t>(qMax<int64_t>(position31.x - radiusX31, 0) >> CellSizeShift);
+    const auto maxCellX = static_cast<int32_t>(qMin<int64_t>(position31.x + radiusX31, std::numeric_limits<int32_t>::max()) >> CellSizeShift);
+    const auto minCellY = static_cast<int32_t>(qMax<int64_t>(position31.y - radiusY31, 0) >> CellSizeShift);
+    const auto maxCellY = static_cast<int32_t>(qMin<int64_t>(position31.y + radiusY31, std::numeric_limits<int32_t>::max()) >> CellSizeShift);
+    for (auto cellX = minCellX; cellX <= maxCellX; cellX++)
+    {
+        // Cells of the same column are adjacent in sorted keys
+        const auto itCellsBegin = std::lower_bound(_cellKeys.cbegin(), _cellKeys.cend(), makeCellKey(cellX, minCellY));
+        const auto itCellsEnd = std::upper_bound(itCellsBegin, _cellKeys.cend(), makeCellKey(cellX, maxCellY));
+        for (auto itCell = itCellsBegin; itCell != itCellsEnd; ++itCell)
+        {
+            const auto stop = _cellStops[itCell - _cellKeys.cbegin()];
+            const auto distance = Utilities::distance31(position31, _stopPositions[stop]);
+            if (distance <= radiusInMeters)
+                outStops.push_back(std::make_pair(static_cast<int>(stop), distance));
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef _OSMAND_CORE_TRANSIT_TIMETABLE_H_
+#define _OSMAND_CORE_TRANSIT_TIMETABLE_H_
+
+#include "stdlib_common.h"
+
+#include "QtExtensions.h"
+#include "ignore_warnings_on_external_includes.h"
+#include <QList>
+#include <QVector>
+#include "restore_internal_warnings.h"
+
+#include "OsmAndCore.h"
+#include "CommonTypes.h"
+#include "TransitRouter.h"
+
+namespace OsmAnd
+{
+    class TransportRoute;
+
+    // Timetable of transit network packed into flat arrays. Each direction of route becomes a pattern: fixed
+    // sequence of stops that all its trips follow. Trips of pattern share running times, so stop times of a trip
+    // are its start time plus per-stop offsets of pattern, and trips of pattern never overtake each other.
+    // Stops are also indexed by grid cells, to find stops within walking distance.
+    class TransitTimetable Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(TransitTimetable);
+
+    public:
+        struct Pattern
+        {
+            std::shared_ptr<const TransportRoute> route;
+            bool isReverse;
+            // Stops of pattern and their time offsets are [firstStop; firstStop + stopsCount)
+            uint32_t firstStop;
+            uint32_t stopsCount;
+            // Sorted start times of trips are [firstTrip; firstTrip + tripsCount)
+            uint32_t firstTrip;
+            uint32_t tripsCount;
+        };
+
+        struct StopPattern
+        {
+            uint32_t pattern;
+            // Position of stop within pattern
+            uint32_t position;
+        };
+
+        struct Transfer
+        {
+            uint32_t target;
+            // In seconds
+            uint32_t duration;
+        };
+
+        // Stop index and walking distance to it, in meters
+        typedef std::pair<int, double> StopDistance;
+
+        // Size of grid cell in 31 coordinates is 2^CellSizeShift
+        static const int CellSizeShift;
+
+    private:
+        QVector<int64_t> _stopIds;
+        QVector<PointI> _stopPositions;
+        // Patterns serving stop N are [_firstStopPatterns[N]; _firstStopPatterns[N + 1])
+        QVector<uint32_t> _firstStopPatterns;
+        QVector<StopPattern> _stopPatterns;
+        // Transfers from stop N are [_firstTransfers[N]; _firstTransfers[N + 1])
+        QVector<uint32_t> _firstTransfers;
+        QVector<Transfer> _transfers;
+
+        QVector<Pattern> _patterns;
+        QVector<uint32_t> _patternStops;
+        QVector<uint32_t> _arrivalOffsets;
+        QVector<uint32_t> _departureOffsets;
+        QVector<uint32_t> _tripStartTimes;
+
+        // Sorted cell keys of stops, and stops in the same order
+        QVector<uint64_t> _cellKeys;
+        QVector<uint32_t> _cellStops;
+
+        static uint64_t makeCellKey(const int32_t cellX, const int32_t cellY);
+        void addPattern(
+            const std::shared_ptr<const TransportRoute>& route,
+            const bool isReverse,
+            const QVector<uint32_t>& stops,
+            const TransitRouter::Settings& settings);
+        void buildStopPatterns();
+        void buildCells();
+        void buildTransfers(const TransitRouter::Settings& settings);
+    protected:
+    public:
+        TransitTimetable(
+            const QList< std::shared_ptr<const TransportRoute> >& routes,
+            const TransitRouter::Settings& settings);
+        ~TransitTimetable();
+
+        int getStopsCount() const;
+        int64_t getStopId(const int stop) const;
+        const PointI& getStopPosition(const int stop) const;
+        const StopPattern* getStopPatternsBegin(const int stop) const;
+        const StopPattern* getStopPatternsEnd(const int stop) const;
+        const Transfer* getTransfersBegin(const int stop) const;
+        const Transfer* getTransfersEnd(const int stop) const;
+
+        int getPatternsCount() const;
+        const Pattern& getPattern(const int pattern) const;
+        // Arrays are indexed by firstStop or firstTrip of pattern plus position
+        const uint32_t* getPatternStops() const;
+        const uint32_t* getArrivalOffsets() const;
+        const uint32_t* getDepartureOffsets() const;
+        const uint32_t* getTripStartTimes() const;
+        int getTripsCount() const;
+
+        // Index of first trip of pattern that departs from stop at given position not earlier than time, or -1
+        int findEarliestTrip(const Pattern& pattern, const uint32_t position, const uint32_t time) const;
+
+        void findStopsWithin(const PointI& position31, const double radiusInMeters, QVector<StopDistance>& outStops) const;
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TRANSIT_TIMETABLE_H_)
@@ -8,6 +8,7 @@
 #include <QtNumeric>
 #include <QtCore>
 
+#include "ObfFile.h"
 #include "Logging.h"
 
 OsmAnd::Utilities::Utilities()
@@ -509,3 +510,19 @@ void OsmAnd::Utilities::scanlineFillPolygon(const unsigned int verticesCount, co
     for(const auto& edge : constOf(edges))
         delete edge;
 }
+
+QByteArray OsmAnd::Utilities::computeObfFilesSignature(const QList< std::shared_ptr<const ObfFile> >& obfFiles)
+{
+    QStringList fileDescriptions;
+    for (const auto& obfFile : constOf(obfFiles))
+    {
+        const QFileInfo fileInfo(obfFile->filePath);
+        fileDescriptions.push_back(QString::fromLatin1("%1:%2:%3")
+            .arg(fileInfo.fileName())
+            .arg(obfFile->fileSize)
+            .arg(fileInfo.lastModified().toMSecsSinceEpoch()));
+    }
+    fileDescriptions.sort();
+
+    return QCryptographicHash::hash(fileDescriptions.join(QLatin1Char('\n')).toUtf8(), QCryptographicHash::Md5);
+}
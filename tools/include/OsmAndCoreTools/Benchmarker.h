@@ -0,0 +1,192 @@
+#ifndef _OSMAND_CORE_TOOLS_BENCHMARKER_H_
+#define _OSMAND_CORE_TOOLS_BENCHMARKER_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/LatLon.h>
+#include <OsmAndCore/PointsAndAreas.h>
+#include <OsmAndCore/IObfsCollection.h>
+#include <OsmAndCore/RoadRouter.h>
+#include <OsmAndCore/IRoadCostModel.h>
+#include <OsmAndCore/Routing/RoutingProfile.h>
+
+#include <OsmAndCoreTools.h>
+
+namespace OsmAndTools
+{
+    class OSMAND_CORE_TOOLS_API Benchmarker Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(Benchmarker);
+
+    public:
+        enum class Benchmark
+        {
+            Unspecified = -1,
+
+            // Compares HeightmapTileProvider (TileDB + GDAL) with ElevationPyramidTileProvider
+            ElevationData,
+
+            // Measures per-keystroke latency of search session, typing query one character at a time
+            Search,
+
+            // Compares POI lookup by name prefix through name index with full scan of POI sections
+            PoiNameSearch,
+
+            // Measures throughput of batch map-matching of GPX trace with RoadLocator
+            MapMatching,
+
+            // Measures throughput and memory of RoadRouter on random pairs of road points within area,
+            // using contraction hierarchy if it's given
+            Routing,
+
+            // Measures time to compute travel-time matrices between random road points within area. Checks that
+            // targets first source can't reach by route, or that are off roads, are reported as unreachable
+            TravelTimeMatrix,
+
+            // Compares latency and memory of routing graph built from Road objects with the one built
+            // from cached flat graphs of roads data blocks
+            RoadGraphs,
+
+            // Measures time to build timetable of TransitRouter and latency of journeys between random
+            // transport stops within area
+            Transit,
+
+            // Measures time to prepare index of ReverseGeocoder and throughput of bulk reverse geocoding of
+            // random positions within area
+            ReverseGeocoding,
+
+            // Measures latency percentiles of ForwardGeocoder, typing query one character at a time. Without
+            // query, addresses of random positions within area are typed
+            ForwardGeocoding,
+
+            // Compares k-nearest amenities search, one position at a time and in batch, with fetching
+            // amenities of growing area around random positions within area. Query is name of category
+            // or subcategory, all amenities are searched without it
+            NearestAmenities,
+
+            // Compares rasterizing names of amenities within area into bitmaps with laying them out as quads
+            // of glyphs from SdfGlyphAtlas, by time and by volume of data that has to be uploaded to GPU
+            TextLabels,
+
+            // Compares rebuilding QuadTree on each frame with refilling persistent UniformGrid, by intersection
+            // tests per second of greedy placement of random symbol boxes on screen panned between frames
+            SymbolsIntersections,
+
+            // Compares CPU time per tile of rasterizing map primitives within area with MapRasterizer against
+            // tessellating them into triangles with MapTessellator, as well as volume of data to upload to GPU
+            MapLayerGeometry,
+
+            // Compares evaluating routing profile for every road within area by interpreting rulesets
+            // with lookups in tables of the profile compiled per routing section
+            RoutingProfile,
+
+            // Checks that routes from one side of junctions with 'no left turn' restriction within area to the
+            // road that can't be turned to never take the forbidden turn, and measures their latency
+            TurnRestrictions,
+
+            // Measures latency of IsochroneEngine from random road points within area, checking that area
+            // reachable within each time band is not smaller than the one of the band before
+            Isochrones,
+        };
+
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            Benchmark benchmark;
+            unsigned int iterations;
+            bool verbose;
+
+            QString heightmapTileDbPath;
+            QString heightmapTileDbIndexFilename;
+            QString elevationPyramidFilename;
+
+            std::shared_ptr<OsmAnd::IObfsCollection> obfsCollection;
+            QString query;
+            QString gpxFilename;
+
+            OsmAnd::LatLon center;
+            double radiusInMeters;
+            unsigned int routesCount;
+            QString contractionHierarchyFilename;
+            QList<unsigned int> matrixSizes;
+            unsigned int threadsCount;
+            QString reverseGeocodingIndexFilename;
+            QString routingConfigFilename;
+            QString routingProfileName;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+    private:
+#if defined(_UNICODE) || defined(UNICODE)
+        bool benchmark(std::wostream& output);
+        bool benchmarkElevationData(std::wostream& output);
+        bool benchmarkSearch(std::wostream& output);
+        bool benchmarkPoiNameSearch(std::wostream& output);
+        bool benchmarkMapMatching(std::wostream& output);
+        bool benchmarkRouting(std::wostream& output);
+        bool benchmarkTravelTimeMatrix(std::wostream& output);
+        bool benchmarkRoadGraphs(std::wostream& output);
+        bool benchmarkTransit(std::wostream& output);
+        bool benchmarkReverseGeocoding(std::wostream& output);
+        bool benchmarkForwardGeocoding(std::wostream& output);
+        bool benchmarkNearestAmenities(std::wostream& output);
+        bool benchmarkTextLabels(std::wostream& output);
+        bool benchmarkSymbolsIntersections(std::wostream& output);
+        bool benchmarkMapLayerGeometry(std::wostream& output);
+        bool benchmarkRoutingProfile(std::wostream& output);
+        bool benchmarkTurnRestrictions(std::wostream& output);
+        bool benchmarkIsochrones(std::wostream& output);
+#else
+        bool benchmark(std::ostream& output);
+        bool benchmarkElevationData(std::ostream& output);
+        bool benchmarkSearch(std::ostream& output);
+        bool benchmarkPoiNameSearch(std::ostream& output);
+        bool benchmarkMapMatching(std::ostream& output);
+        bool benchmarkRouting(std::ostream& output);
+        bool benchmarkTravelTimeMatrix(std::ostream& output);
+        bool benchmarkRoadGraphs(std::ostream& output);
+        bool benchmarkTransit(std::ostream& output);
+        bool benchmarkReverseGeocoding(std::ostream& output);
+        bool benchmarkForwardGeocoding(std::ostream& output);
+        bool benchmarkNearestAmenities(std::ostream& output);
+        bool benchmarkTextLabels(std::ostream& output);
+        bool benchmarkSymbolsIntersections(std::ostream& output);
+        bool benchmarkMapLayerGeometry(std::ostream& output);
+        bool benchmarkRoutingProfile(std::ostream& output);
+        bool benchmarkTurnRestrictions(std::ostream& output);
+        bool benchmarkIsochrones(std::ostream& output);
+#endif
+        bool obtainRandomRoadPoints(const unsigned int count, QVector<OsmAnd::PointI>& outPoints31) const;
+        std::shared_ptr<OsmAnd::RoutingProfile> loadRoutingProfile() const;
+        std::shared_ptr<const OsmAnd::IRoadCostModel> createRoadCostModel() const;
+        std::shared_ptr<OsmAnd::RoadRouter> createRoadRouter() const;
+    protected:
+    public:
+        Benchmarker(const Configuration& configuration);
+        ~Benchmarker();
+
+        const Configuration configuration;
+
+        bool benchmark(QString *pLog = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_BENCHMARKER_H_)
@@ -11,6 +11,7 @@
 #include <OsmAndCore/ignore_warnings_on_external_includes.h>
 #include <QString>
 #include <QStringList>
+#include <QList>
 #include <QDir>
 #include <QFile>
 #include <OsmAndCore/restore_internal_warnings.h>
@@ -18,6 +19,8 @@
 #include <OsmAndCore.h>
 #include <OsmAndCore/IObfsCollection.h>
 #include <OsmAndCore/Map/IMapStylesCollection.h>
+#include <OsmAndCore/Map/IMapRenderer.h>
+#include <OsmAndCore/Map/MapViewsBatchRenderer.h>
 
 #include <OsmAndCoreTools.h>
 
@@ -34,6 +37,9 @@ namespace OsmAndTools
             JPEG
         };
 
+        // Name of view is filename of its output image
+        typedef OsmAnd::MapViewsBatchRenderer::View View;
+
         struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
         {
             Configuration();
@@ -55,6 +61,12 @@ namespace OsmAndTools
             float displayDensityFactor;
             QString locale;
             bool verbose;
+            // Views rendered instead of single one, one per line of batch file
+            QList<View> batchViews;
+            // Before views are rendered, zoom is animated from this zoom to zoom of first view during given
+            // number of seconds, and tiles requested and postponed by zoom gesture are reported
+            float zoomGestureFromZoom;
+            float zoomGestureDuration;
 #if defined(OSMAND_TARGET_OS_linux)
             bool useLegacyContext;
 #endif
@@ -63,15 +75,28 @@ namespace OsmAndTools
                 const QStringList& commandLineArgs,
                 Configuration& outConfiguration,
                 QString& outError);
+        private:
+            static bool parseBatchFile(
+                const QString& batchFilename,
+                QList<View>& outViews,
+                QString& outError);
         };
 
     private:
+        QList<View> getViews() const;
+
 #if defined(_UNICODE) || defined(UNICODE)
         bool glVerifyResult(std::wostream& output) const;
 #else
         bool glVerifyResult(std::ostream& output) const;
 #endif
         
+#if defined(_UNICODE) || defined(UNICODE)
+        bool benchmarkZoomGesture(const std::shared_ptr<OsmAnd::IMapRenderer>& mapRenderer, std::wostream& output) const;
+#else
+        bool benchmarkZoomGesture(const std::shared_ptr<OsmAnd::IMapRenderer>& mapRenderer, std::ostream& output) const;
+#endif
+
 #if defined(_UNICODE) || defined(UNICODE)
         bool rasterize(std::wostream& output);
 #else
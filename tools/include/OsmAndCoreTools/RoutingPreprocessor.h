@@ -0,0 +1,67 @@
+#ifndef _OSMAND_CORE_TOOLS_ROUTING_PREPROCESSOR_H_
+#define _OSMAND_CORE_TOOLS_ROUTING_PREPROCESSOR_H_
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iostream>
+#include <sstream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QString>
+#include <QStringList>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/IObfsCollection.h>
+#include <OsmAndCore/IRoadCostModel.h>
+#include <OsmAndCore/DefaultRoadCostModel.h>
+
+#include <OsmAndCoreTools.h>
+
+namespace OsmAndTools
+{
+    // Builds contraction hierarchy of roads from OBF files for a routing profile
+    class OSMAND_CORE_TOOLS_API RoutingPreprocessor Q_DECL_FINAL
+    {
+        Q_DISABLE_COPY_AND_MOVE(RoutingPreprocessor);
+
+    public:
+        struct OSMAND_CORE_TOOLS_API Configuration Q_DECL_FINAL
+        {
+            Configuration();
+
+            std::shared_ptr<OsmAnd::IObfsCollection> obfsCollection;
+            OsmAnd::DefaultRoadCostModel::Profile profile;
+            // If routing configuration is given, its profile is used instead of default cost model
+            QString routingConfigFilename;
+            QString routingProfileName;
+            QString outputFilename;
+            bool verbose;
+
+            static bool parseFromCommandLineArguments(
+                const QStringList& commandLineArgs,
+                Configuration& outConfiguration,
+                QString& outError);
+        };
+
+    private:
+        std::shared_ptr<const OsmAnd::IRoadCostModel> createRoadCostModel() const;
+#if defined(_UNICODE) || defined(UNICODE)
+        bool preprocess(std::wostream& output);
+#else
+        bool preprocess(std::ostream& output);
+#endif
+    protected:
+    public:
+        RoutingPreprocessor(const Configuration& configuration);
+        ~RoutingPreprocessor();
+
+        const Configuration configuration;
+
+        bool preprocess(QString *pLog = nullptr);
+    };
+}
+
+#endif // !defined(_OSMAND_CORE_TOOLS_ROUTING_PREPROCESSOR_H_)
@@ -0,0 +1,2237 @@
+#include "Benchmarker.h"
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QDir>
+#include <QFile>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include <OsmAndCore/restore_internal_warnings.h>
+#include <OsmAndCore/QtCommon.h>
+
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <SkBitmap.h>
+#include <SkBitmapDevice.h>
+#include <SkCanvas.h>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/TileDB.h>
+#include <OsmAndCore/Map/HeightmapTileProvider.h>
+#include <OsmAndCore/Map/ElevationPyramidTileProvider.h>
+#include <OsmAndCore/ICU.h>
+#include <OsmAndCore/ObfsCollection.h>
+#include <OsmAndCore/ObfDataInterface.h>
+#include <OsmAndCore/Data/ObfReader.h>
+#include <OsmAndCore/Data/ObfInfo.h>
+#include <OsmAndCore/Data/ObfPoiSectionInfo.h>
+#include <OsmAndCore/Data/ObfPoiSectionReader.h>
+#include <OsmAndCore/Data/Amenity.h>
+#include <OsmAndCore/Data/AmenityCategory.h>
+#include <OsmAndCore/Data/BudgetedRoutingDataBlocksCache.h>
+#include <OsmAndCore/Data/ObfRoutingSectionReader_Metrics.h>
+#include <OsmAndCore/Search/InAreaSearchEngine.h>
+#include <OsmAndCore/Search/ISearchSession.h>
+#include <OsmAndCore/Search/PoiSearchDataSource.h>
+#include <OsmAndCore/Search/AddressSearchDataSource.h>
+#include <OsmAndCore/GpxDocument.h>
+#include <OsmAndCore/RoadLocator.h>
+#include <OsmAndCore/RoadRouter.h>
+#include <OsmAndCore/IsochroneEngine.h>
+#include <OsmAndCore/ContractionHierarchy.h>
+#include <OsmAndCore/DefaultRoadCostModel.h>
+#include <OsmAndCore/ProfileRoadCostModel.h>
+#include <OsmAndCore/Routing/RoutingConfiguration.h>
+#include <OsmAndCore/Routing/RoutingProfileContext.h>
+#include <OsmAndCore/Data/Road.h>
+#include <OsmAndCore/Data/ObfTransportSectionInfo.h>
+#include <OsmAndCore/Data/ObfTransportSectionReader.h>
+#include <OsmAndCore/Data/TransportStop.h>
+#include <OsmAndCore/TransitRouter.h>
+#include <OsmAndCore/ReverseGeocoder.h>
+#include <OsmAndCore/Search/ForwardGeocoder.h>
+#include <OsmAndCore/TextRasterizer.h>
+#include <OsmAndCore/SdfGlyphAtlas.h>
+#include <OsmAndCore/QuadTree.h>
+#include <OsmAndCore/UniformGrid.h>
+#include <OsmAndCore/Map/MapStylesCollection.h>
+#include <OsmAndCore/Map/MapPresentationEnvironment.h>
+#include <OsmAndCore/Map/MapPrimitiviser.h>
+#include <OsmAndCore/Map/MapPrimitivesProvider.h>
+#include <OsmAndCore/Map/ObfMapObjectsProvider.h>
+#include <OsmAndCore/Map/MapRasterizer.h>
+#include <OsmAndCore/Map/MapTessellator.h>
+#include <OsmAndCore/Utilities.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+OsmAndTools::Benchmarker::Benchmarker(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::Benchmarker::~Benchmarker()
+{
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmark(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmark(std::ostream& output)
+#endif
+{
+    switch (configuration.benchmark)
+    {
+        case Benchmark::ElevationData:
+            return benchmarkElevationData(output);
+        case Benchmark::Search:
+            return benchmarkSearch(output);
+        case Benchmark::PoiNameSearch:
+            return benchmarkPoiNameSearch(output);
+        case Benchmark::MapMatching:
+            return benchmarkMapMatching(output);
+        case Benchmark::Routing:
+            return benchmarkRouting(output);
+        case Benchmark::TravelTimeMatrix:
+            return benchmarkTravelTimeMatrix(output);
+        case Benchmark::RoadGraphs:
+            return benchmarkRoadGraphs(output);
+        case Benchmark::Transit:
+            return benchmarkTransit(output);
+        case Benchmark::ReverseGeocoding:
+            return benchmarkReverseGeocoding(output);
+        case Benchmark::ForwardGeocoding:
+            return benchmarkForwardGeocoding(output);
+        case Benchmark::NearestAmenities:
+            return benchmarkNearestAmenities(output);
+        case Benchmark::TextLabels:
+            return benchmarkTextLabels(output);
+        case Benchmark::SymbolsIntersections:
+            return benchmarkSymbolsIntersections(output);
+        case Benchmark::MapLayerGeometry:
+            return benchmarkMapLayerGeometry(output);
+        case Benchmark::RoutingProfile:
+            return benchmarkRoutingProfile(output);
+        case Benchmark::TurnRestrictions:
+            return benchmarkTurnRestrictions(output);
+        case Benchmark::Isochrones:
+            return benchmarkIsochrones(output);
+
+        default:
+            output << xT("No benchmark specified") << std::endl;
+            return false;
+    }
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkElevationData(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkElevationData(std::ostream& output)
+#endif
+{
+    // Both providers are queried for exactly the same set of tiles, the one stored in TileDB
+    OsmAnd::TileDB tileDb(QDir(configuration.heightmapTileDbPath), configuration.heightmapTileDbIndexFilename);
+    QList< std::pair<OsmAnd::TileId, OsmAnd::ZoomLevel> > tiles;
+    if (!tileDb.obtainTilesList(tiles) || tiles.isEmpty())
+    {
+        output << xT("Failed to list tiles of '") << QStringToStlString(configuration.heightmapTileDbPath) << xT("'") << std::endl;
+        return false;
+    }
+
+    if (!QFile(configuration.elevationPyramidFilename).exists())
+    {
+        if (configuration.verbose)
+            output << xT("Converting TileDB to '") << QStringToStlString(configuration.elevationPyramidFilename) << xT("'...") << std::endl;
+
+        OsmAnd::Stopwatch conversionStopwatch(true);
+        const auto ok = OsmAnd::ElevationPyramidTileProvider::convertFromTileDB(
+            configuration.heightmapTileDbPath,
+            configuration.heightmapTileDbIndexFilename,
+            configuration.elevationPyramidFilename);
+        if (!ok)
+        {
+            output << xT("Failed to convert TileDB to elevation pyramid") << std::endl;
+            return false;
+        }
+        output << xT("Conversion took ") << conversionStopwatch.elapsed() << xT("s") << std::endl;
+    }
+
+    OsmAnd::HeightmapTileProvider heightmapTileProvider(
+        configuration.heightmapTileDbPath,
+        configuration.heightmapTileDbIndexFilename);
+    OsmAnd::ElevationPyramidTileProvider elevationPyramidTileProvider(configuration.elevationPyramidFilename);
+    if (!elevationPyramidTileProvider.isValid())
+    {
+        output << xT("Failed to open '") << QStringToStlString(configuration.elevationPyramidFilename) << xT("'") << std::endl;
+        return false;
+    }
+
+    const auto measure =
+        [this, &tiles]
+        (OsmAnd::IMapElevationDataProvider& provider, unsigned int& outObtainedTiles) -> float
+        {
+            outObtainedTiles = 0;
+
+            OsmAnd::Stopwatch stopwatch(true);
+            for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+            {
+                for (const auto& tile : OsmAnd::constOf(tiles))
+                {
+                    std::shared_ptr<OsmAnd::IMapTiledDataProvider::Data> data;
+                    if (provider.obtainData(tile.first, tile.second, data) && data)
+                        outObtainedTiles++;
+                }
+            }
+            return stopwatch.elapsed();
+        };
+
+    unsigned int tileDbObtainedTiles = 0;
+    const auto tileDbElapsed = measure(heightmapTileProvider, tileDbObtainedTiles);
+    unsigned int pyramidObtainedTiles = 0;
+    const auto pyramidElapsed = measure(elevationPyramidTileProvider, pyramidObtainedTiles);
+
+    const auto requestsCount = tiles.size() * configuration.iterations;
+    output << xT("Tiles requested: ") << requestsCount << std::endl;
+    output << std::fixed << std::setprecision(3);
+    output << xT("TileDB + GDAL:     ") << tileDbObtainedTiles << xT(" tiles in ") << tileDbElapsed << xT("s, ")
+        << (tileDbElapsed * 1000000.0f / requestsCount) << xT("us/tile") << std::endl;
+    output << xT("Elevation pyramid: ") << pyramidObtainedTiles << xT(" tiles in ") << pyramidElapsed << xT("s, ")
+        << (pyramidElapsed * 1000000.0f / requestsCount) << xT("us/tile") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkSearch(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkSearch(std::ostream& output)
+#endif
+{
+    const std::shared_ptr<OsmAnd::InAreaSearchEngine> searchEngine(new OsmAnd::InAreaSearchEngine());
+    searchEngine->addDataSource(std::shared_ptr<OsmAnd::PoiSearchDataSource>(new OsmAnd::PoiSearchDataSource(
+        configuration.obfsCollection)));
+    searchEngine->addDataSource(std::shared_ptr<OsmAnd::AddressSearchDataSource>(new OsmAnd::AddressSearchDataSource(
+        configuration.obfsCollection)));
+
+    struct KeystrokeStatistics
+    {
+        KeystrokeStatistics()
+            : firstResultsTime(0.0f)
+            , completeTime(0.0f)
+            , resultsCount(0)
+        {
+        }
+
+        float firstResultsTime;
+        float completeTime;
+        unsigned int resultsCount;
+    };
+
+    // Types query one character at a time and waits for complete results after each keystroke.
+    // If 'refine' is false, session is cancelled before each keystroke to force search from scratch
+    const auto measure =
+        [this, searchEngine]
+        (const bool refine) -> QVector<KeystrokeStatistics>
+        {
+            QVector<KeystrokeStatistics> statistics(configuration.query.length());
+
+            for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+            {
+                QMutex completeMutex;
+                QWaitCondition completeCondition;
+                bool complete = false;
+                bool firstResultsReceived = false;
+                unsigned int resultsCount = 0;
+                OsmAnd::Stopwatch keystrokeStopwatch;
+                float firstResultsTime = 0.0f;
+
+                const auto session = searchEngine->createSession();
+                session->setResultsUpdatedCallback(
+                    [&]
+                    (OsmAnd::ISearchSession* const searchSession, const std::shared_ptr<const OsmAnd::ISearchEngine::ISearchResults>& results)
+                    {
+                        Q_UNUSED(searchSession);
+                        QMutexLocker scopedLocker(&completeMutex);
+
+                        if (!firstResultsReceived)
+                        {
+                            firstResultsTime = keystrokeStopwatch.elapsed();
+                            firstResultsReceived = true;
+                        }
+                        resultsCount = results->getResults().size();
+                        if (results->isComplete())
+                        {
+                            complete = true;
+                            completeCondition.wakeAll();
+                        }
+                    });
+
+                for (auto keystrokeIdx = 0; keystrokeIdx < configuration.query.length(); keystrokeIdx++)
+                {
+                    const auto query = configuration.query.left(keystrokeIdx + 1);
+                    if (query.trimmed().isEmpty())
+                        continue;
+
+                    if (!refine)
+                        session->cancelSearch();
+
+                    QMutexLocker scopedLocker(&completeMutex);
+                    complete = false;
+                    firstResultsReceived = false;
+                    keystrokeStopwatch.start();
+
+                    session->setQuery(query);
+                    session->startSearch();
+                    while (!complete)
+                        completeCondition.wait(&completeMutex);
+
+                    auto& keystrokeStatistics = statistics[keystrokeIdx];
+                    keystrokeStatistics.firstResultsTime += firstResultsTime;
+                    keystrokeStatistics.completeTime += keystrokeStopwatch.elapsed();
+                    keystrokeStatistics.resultsCount = resultsCount;
+                }
+            }
+
+            return statistics;
+        };
+
+    const auto fromScratchStatistics = measure(false);
+    const auto refinedStatistics = measure(true);
+
+    output << std::fixed << std::setprecision(3);
+    float fromScratchTotal = 0.0f;
+    float refinedTotal = 0.0f;
+    for (auto keystrokeIdx = 0; keystrokeIdx < configuration.query.length(); keystrokeIdx++)
+    {
+        const auto& fromScratch = fromScratchStatistics[keystrokeIdx];
+        const auto& refined = refinedStatistics[keystrokeIdx];
+        fromScratchTotal += fromScratch.completeTime;
+        refinedTotal += refined.completeTime;
+
+        if (!configuration.verbose)
+            continue;
+        output
+            << xT("'") << QStringToStlString(configuration.query.left(keystrokeIdx + 1)) << xT("': ")
+            << refined.resultsCount << xT(" result(s), from scratch ")
+            << (fromScratch.completeTime * 1000.0f / configuration.iterations) << xT("ms, refined ")
+            << (refined.completeTime * 1000.0f / configuration.iterations) << xT("ms (first results after ")
+            << (refined.firstResultsTime * 1000.0f / configuration.iterations) << xT("ms)") << std::endl;
+    }
+
+    const auto keystrokesCount = configuration.query.length() * configuration.iterations;
+    output << xT("Keystrokes: ") << keystrokesCount << std::endl;
+    output << xT("From scratch: ") << (fromScratchTotal * 1000.0f / keystrokesCount) << xT("ms/keystroke") << std::endl;
+    output << xT("Refined:      ") << (refinedTotal * 1000.0f / keystrokesCount) << xT("ms/keystroke") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkPoiNameSearch(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkPoiNameSearch(std::ostream& output)
+#endif
+{
+    const auto normalizedQuery = OsmAnd::ICU::stripAccentsAndDiacritics(configuration.query).toLower();
+    const auto nameMatches =
+        [normalizedQuery]
+        (const QString& name) -> bool
+        {
+            const auto normalizedName = OsmAnd::ICU::stripAccentsAndDiacritics(name).toLower();
+            auto position = normalizedName.indexOf(normalizedQuery);
+            while (position >= 0)
+            {
+                if (position == 0 || !normalizedName[position - 1].isLetterOrNumber())
+                    return true;
+                position = normalizedName.indexOf(normalizedQuery, position + 1);
+            }
+            return false;
+        };
+
+    const auto dataInterface = configuration.obfsCollection->obtainDataInterface();
+
+    unsigned int scanMatchesCount = 0;
+    unsigned int indexMatchesCount = 0;
+    float scanElapsed = 0.0f;
+    float indexElapsed = 0.0f;
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (const auto& obfReader : OsmAnd::constOf(dataInterface->obfReaders))
+        {
+            const auto& obfInfo = obfReader->obtainInfo();
+            for (const auto& poiSection : OsmAnd::constOf(obfInfo->poiSections))
+            {
+                QList< std::shared_ptr<const OsmAnd::Amenity> > scannedAmenities;
+                OsmAnd::Stopwatch scanStopwatch(true);
+                OsmAnd::ObfPoiSectionReader::loadAmenities(
+                    obfReader,
+                    poiSection,
+                    OsmAnd::ZoomLevel28,
+                    3,
+                    nullptr,
+                    nullptr,
+                    &scannedAmenities,
+                    [nameMatches]
+                    (const std::shared_ptr<const OsmAnd::Amenity>& amenity) -> bool
+                    {
+                        return nameMatches(amenity->name) || nameMatches(amenity->latinName);
+                    });
+                scanElapsed += scanStopwatch.elapsed();
+                scanMatchesCount += scannedAmenities.size();
+
+                QList< std::shared_ptr<const OsmAnd::Amenity> > foundAmenities;
+                OsmAnd::Stopwatch indexStopwatch(true);
+                OsmAnd::ObfPoiSectionReader::searchAmenitiesByName(
+                    obfReader,
+                    poiSection,
+                    configuration.query,
+                    nullptr,
+                    nullptr,
+                    &foundAmenities);
+                indexElapsed += indexStopwatch.elapsed();
+                indexMatchesCount += foundAmenities.size();
+
+                if (configuration.verbose && iteration == 0)
+                {
+                    output << xT("'") << QStringToStlString(poiSection->name) << xT("': ")
+                        << scannedAmenities.size() << xT(" by scan, ")
+                        << foundAmenities.size() << xT(" by name index") << std::endl;
+                }
+            }
+        }
+    }
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Full scan:  ") << (scanMatchesCount / configuration.iterations) << xT(" amenities, ")
+        << (scanElapsed * 1000.0f / configuration.iterations) << xT("ms/query") << std::endl;
+    output << xT("Name index: ") << (indexMatchesCount / configuration.iterations) << xT(" amenities, ")
+        << (indexElapsed * 1000.0f / configuration.iterations) << xT("ms/query") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkMapMatching(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkMapMatching(std::ostream& output)
+#endif
+{
+    const auto gpxDocument = OsmAnd::GpxDocument::loadFrom(configuration.gpxFilename);
+    if (!gpxDocument)
+    {
+        output << xT("Failed to load '") << QStringToStlString(configuration.gpxFilename) << xT("'") << std::endl;
+        return false;
+    }
+
+    QVector<OsmAnd::PointI> points31;
+    for (const auto& track : OsmAnd::constOf(gpxDocument->tracks))
+    {
+        for (const auto& segment : OsmAnd::constOf(track->segments))
+        {
+            for (const auto& point : OsmAnd::constOf(segment->points))
+                points31.push_back(OsmAnd::Utilities::convertLatLonTo31(point->position));
+        }
+    }
+    if (points31.isEmpty())
+    {
+        output << xT("No track points in '") << QStringToStlString(configuration.gpxFilename) << xT("'") << std::endl;
+        return false;
+    }
+
+    const std::shared_ptr<OsmAnd::ObfRoutingSectionReader::DataBlocksCache> cache(
+        new OsmAnd::ObfRoutingSectionReader::DataBlocksCache());
+    const std::shared_ptr<OsmAnd::RoadLocator> roadLocator(
+        new OsmAnd::RoadLocator(configuration.obfsCollection, cache));
+
+    // Roads are loaded into cache before measurements, so that only matching itself is measured
+    QVector<OsmAnd::RoadLocator::MatchedPoint> matchedPoints;
+    roadLocator->matchPoints(points31, 50.0, OsmAnd::RoutingDataLevel::Detailed, matchedPoints);
+
+    output << std::fixed << std::setprecision(3);
+    const auto modes = QList<OsmAnd::RoadLocator::MatchingMode>()
+        << OsmAnd::RoadLocator::MatchingMode::Nearest
+        << OsmAnd::RoadLocator::MatchingMode::Continuous;
+    for (const auto mode : OsmAnd::constOf(modes))
+    {
+        OsmAnd::Stopwatch stopwatch(true);
+        for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+            roadLocator->matchPoints(points31, 50.0, OsmAnd::RoutingDataLevel::Detailed, matchedPoints, mode);
+        const auto elapsed = stopwatch.elapsed();
+
+        auto unmatchedPointsCount = 0;
+        auto totalDistance = 0.0;
+        for (const auto& matchedPoint : OsmAnd::constOf(matchedPoints))
+        {
+            if (!matchedPoint.road)
+                unmatchedPointsCount++;
+            else
+                totalDistance += matchedPoint.distance;
+        }
+        const auto matchedPointsCount = matchedPoints.size() - unmatchedPointsCount;
+
+        output << (mode == OsmAnd::RoadLocator::MatchingMode::Nearest ? xT("Nearest:    ") : xT("Continuous: "))
+            << (points31.size() * configuration.iterations / elapsed) << xT(" points/s, ")
+            << unmatchedPointsCount << xT(" of ") << points31.size() << xT(" unmatched, ")
+            << (matchedPointsCount > 0 ? totalDistance / matchedPointsCount : 0.0) << xT("m average offset") << std::endl;
+    }
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkRouting(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkRouting(std::ostream& output)
+#endif
+{
+    QVector<OsmAnd::PointI> points31;
+    if (!obtainRandomRoadPoints(configuration.routesCount * 2, points31))
+    {
+        output << xT("No roads found in area") << std::endl;
+        return false;
+    }
+    QVector< std::pair<OsmAnd::PointI, OsmAnd::PointI> > pairs;
+    for (auto routeIdx = 0u; routeIdx < configuration.routesCount; routeIdx++)
+        pairs.push_back(std::make_pair(points31[routeIdx * 2], points31[routeIdx * 2 + 1]));
+
+    const auto router = createRoadRouter();
+    if (!router)
+    {
+        output << xT("Failed to load routing profile") << std::endl;
+        return false;
+    }
+    if (!configuration.contractionHierarchyFilename.isEmpty() && !router->isUsingContractionHierarchy())
+        output << xT("Contraction hierarchy can not be used, falling back to plain graph") << std::endl;
+
+    unsigned int foundRoutesCount = 0;
+    uint64_t settledNodesCount = 0;
+    uint64_t graphNodesCount = 0;
+    size_t peakMemoryUsage = 0;
+    OsmAnd::Stopwatch stopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (const auto& pair : OsmAnd::constOf(pairs))
+        {
+            OsmAnd::RoadRouter::Route route;
+            OsmAnd::RoadRouter::Statistics statistics;
+            if (router->findRoute(pair.first, pair.second, route, &statistics))
+                foundRoutesCount++;
+            settledNodesCount += statistics.settledNodesCount;
+            graphNodesCount += statistics.graphNodesCount;
+            peakMemoryUsage = qMax(peakMemoryUsage, statistics.peakMemoryUsage);
+
+            if (configuration.verbose && iteration == 0)
+            {
+                output << route.time << xT("s, ") << route.distance << xT("m, ")
+                    << statistics.settledNodesCount << xT(" settled of ") << statistics.graphNodesCount << xT(" nodes")
+                    << std::endl;
+            }
+        }
+    }
+    const auto elapsed = stopwatch.elapsed();
+    const auto queriesCount = pairs.size() * configuration.iterations;
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Mode:           ") << (router->isUsingContractionHierarchy() ? xT("contraction hierarchy") : xT("A*")) << std::endl;
+    output << xT("Routes:         ") << foundRoutesCount << xT(" of ") << queriesCount << xT(" found") << std::endl;
+    output << xT("Throughput:     ") << (queriesCount / elapsed) << xT(" routes/s") << std::endl;
+    output << xT("Settled nodes:  ") << (static_cast<double>(settledNodesCount) / queriesCount) << xT(" per route") << std::endl;
+    output << xT("Graph nodes:    ") << (static_cast<double>(graphNodesCount) / queriesCount) << xT(" per route") << std::endl;
+    output << xT("Peak memory:    ") << (peakMemoryUsage / 1024.0 / 1024.0) << xT("MB") << std::endl;
+    if (const auto budgetedCache = std::dynamic_pointer_cast<OsmAnd::BudgetedRoutingDataBlocksCache>(router->cache))
+    {
+        OsmAnd::ObfRoutingSectionReader_Metrics::Metric_dataBlocksCache cacheMetric;
+        budgetedCache->obtainMetric(cacheMetric);
+        output << xT("Blocks cache:   ") << cacheMetric.hits << xT(" hits, ") << cacheMetric.misses << xT(" misses, ")
+            << cacheMetric.evictions << xT(" evictions, ") << (cacheMetric.residentMemoryUsage / 1024.0) << xT("MB resident") << std::endl;
+    }
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkTravelTimeMatrix(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkTravelTimeMatrix(std::ostream& output)
+#endif
+{
+    const auto router = createRoadRouter();
+    if (!router)
+    {
+        output << xT("Failed to load routing profile") << std::endl;
+        return false;
+    }
+    if (!configuration.contractionHierarchyFilename.isEmpty() && !router->isUsingContractionHierarchy())
+        output << xT("Contraction hierarchy can not be used, falling back to plain graph") << std::endl;
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Mode:           ") << (router->isUsingContractionHierarchy() ? xT("contraction hierarchy") : xT("Dijkstra")) << std::endl;
+    for (const auto matrixSize : OsmAnd::constOf(configuration.matrixSizes))
+    {
+        // Sources and targets are different points
+        QVector<OsmAnd::PointI> points31;
+        if (!obtainRandomRoadPoints(matrixSize * 2, points31))
+        {
+            output << xT("No roads found in area") << std::endl;
+            return false;
+        }
+        const auto sources31 = points31.mid(0, matrixSize);
+        const auto targets31 = points31.mid(matrixSize);
+
+        QVector<float> times;
+        unsigned int reachableCount = 0;
+        OsmAnd::Stopwatch stopwatch(true);
+        for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+        {
+            if (!router->computeTravelTimes(sources31, targets31, times, configuration.threadsCount))
+            {
+                output << xT("Failed to compute ") << matrixSize << xT("x") << matrixSize << xT(" matrix") << std::endl;
+                return false;
+            }
+        }
+        const auto elapsed = stopwatch.elapsed() / configuration.iterations;
+        for (const auto time : OsmAnd::constOf(times))
+        {
+            if (time != std::numeric_limits<float>::infinity())
+                reachableCount++;
+        }
+
+        output << matrixSize << xT("x") << matrixSize << xT(":") << std::endl;
+        output << xT("  Elapsed:      ") << elapsed << xT("s") << std::endl;
+        output << xT("  Throughput:   ") << (times.size() / elapsed) << xT(" cells/s") << std::endl;
+        output << xT("  Reachable:    ") << reachableCount << xT(" of ") << times.size() << std::endl;
+
+        // Target without route from source must not make search run over the whole map, and must come out
+        // as unreachable. Point far from any road is one of them, others are found by routing to targets
+        const auto offRoadTargets31 = QVector<OsmAnd::PointI>(targets31) << OsmAnd::PointI(0, 0);
+        QVector<float> firstRowTimes;
+        OsmAnd::Stopwatch unreachableStopwatch(true);
+        if (!router->computeTravelTimes(sources31.mid(0, 1), offRoadTargets31, firstRowTimes, configuration.threadsCount))
+        {
+            output << xT("Failed to compute travel times to unreachable targets") << std::endl;
+            return false;
+        }
+        const auto unreachableElapsed = unreachableStopwatch.elapsed();
+        if (firstRowTimes.last() != std::numeric_limits<float>::infinity())
+        {
+            output << xT("ERROR: Off-road target was reached in ") << firstRowTimes.last() << xT("s") << std::endl;
+            return false;
+        }
+        auto unreachableCount = 1u;
+        for (auto targetIdx = 0; targetIdx < targets31.size(); targetIdx++)
+        {
+            OsmAnd::RoadRouter::Route route;
+            if (router->findRoute(sources31.first(), targets31[targetIdx], route))
+                continue;
+
+            unreachableCount++;
+            if (firstRowTimes[targetIdx] != std::numeric_limits<float>::infinity())
+            {
+                output << xT("ERROR: Target ") << targetIdx << xT(" has no route, but was reached in ")
+                    << firstRowTimes[targetIdx] << xT("s") << std::endl;
+                return false;
+            }
+        }
+        output << xT("  Unreachable:  ") << unreachableCount << xT(" of ") << offRoadTargets31.size()
+            << xT(" from first source, in ") << unreachableElapsed << xT("s") << std::endl;
+    }
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkRoadGraphs(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkRoadGraphs(std::ostream& output)
+#endif
+{
+    QVector<OsmAnd::PointI> points31;
+    if (!obtainRandomRoadPoints(configuration.routesCount * 2, points31))
+    {
+        output << xT("No roads found in area") << std::endl;
+        return false;
+    }
+
+    // Without blocks cache graph is built from Road objects, otherwise from flat graphs of cached blocks.
+    // Both routers search plain graph, even if contraction hierarchy is given
+    const auto costModel = createRoadCostModel();
+    if (!costModel)
+    {
+        output << xT("Failed to load routing profile") << std::endl;
+        return false;
+    }
+    const std::shared_ptr<OsmAnd::ObfRoutingSectionReader::DataBlocksCache> cache(
+        new OsmAnd::ObfRoutingSectionReader::DataBlocksCache());
+    const OsmAnd::RoadRouter roadsRouter(configuration.obfsCollection, costModel);
+    const OsmAnd::RoadRouter blockGraphsRouter(configuration.obfsCollection, costModel, cache);
+
+    output << std::fixed << std::setprecision(3);
+    const auto measure =
+        [this, &output, &points31]
+        (const OsmAnd::RoadRouter& router, const QString& name) -> void
+        {
+            unsigned int foundRoutesCount = 0;
+            size_t peakMemoryUsage = 0;
+            size_t roadsMemoryUsage = 0;
+            size_t blockGraphsMemoryUsage = 0;
+            OsmAnd::Stopwatch stopwatch(true);
+            for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+            {
+                for (auto routeIdx = 0u; routeIdx < configuration.routesCount; routeIdx++)
+                {
+                    OsmAnd::RoadRouter::Route route;
+                    OsmAnd::RoadRouter::Statistics statistics;
+                    if (router.findRoute(points31[routeIdx * 2], points31[routeIdx * 2 + 1], route, &statistics))
+                        foundRoutesCount++;
+                    peakMemoryUsage = qMax(peakMemoryUsage, statistics.peakMemoryUsage);
+                    roadsMemoryUsage = qMax(roadsMemoryUsage, statistics.roadsMemoryUsage);
+                    blockGraphsMemoryUsage = qMax(blockGraphsMemoryUsage, statistics.blockGraphsMemoryUsage);
+                }
+            }
+            const auto elapsed = stopwatch.elapsed();
+            const auto queriesCount = configuration.routesCount * configuration.iterations;
+
+            output << QStringToStlString(name) << xT(":") << std::endl;
+            output << xT("  Routes:       ") << foundRoutesCount << xT(" of ") << queriesCount << xT(" found") << std::endl;
+            output << xT("  Latency:      ") << (elapsed * 1000.0 / queriesCount) << xT("ms per route") << std::endl;
+            output << xT("  Graph memory: ") << (peakMemoryUsage / 1024.0 / 1024.0) << xT("MB peak") << std::endl;
+            output << xT("  Roads memory: ") << (roadsMemoryUsage / 1024.0 / 1024.0) << xT("MB peak") << std::endl;
+            output << xT("  Block graphs: ") << (blockGraphsMemoryUsage / 1024.0 / 1024.0) << xT("MB peak") << std::endl;
+        };
+    measure(roadsRouter, QLatin1String("Road objects"));
+    measure(blockGraphsRouter, QLatin1String("Block graphs"));
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkTransit(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkTransit(std::ostream& output)
+#endif
+{
+    // Random, but reproducible, pairs of transport stops within the area
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    QVector<OsmAnd::PointI> stopsPositions31;
+    const auto dataInterface = configuration.obfsCollection->obtainDataInterface(bbox31);
+    for (const auto& obfReader : OsmAnd::constOf(dataInterface->obfReaders))
+    {
+        const auto& obfInfo = obfReader->obtainInfo();
+        for (const auto& transportSection : OsmAnd::constOf(obfInfo->transportSections))
+        {
+            OsmAnd::ObfTransportSectionReader::loadStops(
+                obfReader,
+                transportSection,
+                &bbox31,
+                nullptr,
+                [&stopsPositions31]
+                (const std::shared_ptr<const OsmAnd::TransportStop>& stop) -> bool
+                {
+                    stopsPositions31.push_back(stop->position31);
+                    return false;
+                });
+        }
+    }
+    if (stopsPositions31.isEmpty())
+    {
+        output << xT("No transport stops found in area") << std::endl;
+        return false;
+    }
+
+    OsmAnd::Stopwatch buildStopwatch(true);
+    const OsmAnd::TransitRouter router(configuration.obfsCollection);
+    const auto buildElapsed = buildStopwatch.elapsed();
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Timetable built in ") << buildElapsed << xT("s: ")
+        << router.getStopsCount() << xT(" stops, ")
+        << router.getRoutesCount() << xT(" routes, ")
+        << router.getTripsCount() << xT(" trips") << std::endl;
+
+    std::mt19937 randomGenerator(0);
+    std::uniform_int_distribution<int> stopDistribution(0, stopsPositions31.size() - 1);
+    std::uniform_int_distribution<unsigned int> departureTimeDistribution(
+        router.settings.serviceStartTime,
+        router.settings.serviceEndTime - 1);
+    QVector<OsmAnd::PointI> points31;
+    QVector<unsigned int> departureTimes;
+    points31.reserve(configuration.routesCount * 2);
+    departureTimes.reserve(configuration.routesCount);
+    for (auto routeIdx = 0u; routeIdx < configuration.routesCount; routeIdx++)
+    {
+        points31.push_back(stopsPositions31[stopDistribution(randomGenerator)]);
+        points31.push_back(stopsPositions31[stopDistribution(randomGenerator)]);
+        departureTimes.push_back(departureTimeDistribution(randomGenerator));
+    }
+
+    unsigned int foundCount = 0;
+    unsigned int journeysCount = 0;
+    unsigned int ridesCount = 0;
+    float maxLatency = 0.0f;
+    OsmAnd::Stopwatch stopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (auto routeIdx = 0u; routeIdx < configuration.routesCount; routeIdx++)
+        {
+            QList<OsmAnd::TransitRouter::Journey> journeys;
+            OsmAnd::Stopwatch queryStopwatch(true);
+            const auto found = router.findJourneys(
+                points31[routeIdx * 2 + 0],
+                points31[routeIdx * 2 + 1],
+                departureTimes[routeIdx],
+                journeys);
+            maxLatency = qMax(maxLatency, queryStopwatch.elapsed());
+            if (!found)
+                continue;
+
+            foundCount++;
+            journeysCount += journeys.size();
+            for (const auto& journey : OsmAnd::constOf(journeys))
+                ridesCount += journey.ridesCount;
+        }
+    }
+    const auto elapsed = stopwatch.elapsed();
+    const auto queriesCount = configuration.routesCount * configuration.iterations;
+
+    output << xT("Found ") << foundCount << xT(" of ") << queriesCount << xT(" journeys queries") << std::endl;
+    output << xT("Latency: ") << (elapsed * 1000.0 / queriesCount) << xT("ms average, ")
+        << (maxLatency * 1000.0) << xT("ms max") << std::endl;
+    output << xT("Throughput: ") << (queriesCount / elapsed) << xT(" queries/s") << std::endl;
+    if (journeysCount > 0)
+    {
+        output << xT("Pareto set: ") << (static_cast<double>(journeysCount) / foundCount) << xT(" journeys, ")
+            << (static_cast<double>(ridesCount) / journeysCount) << xT(" rides per journey on average") << std::endl;
+    }
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkReverseGeocoding(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkReverseGeocoding(std::ostream& output)
+#endif
+{
+    const OsmAnd::ReverseGeocoder reverseGeocoder(configuration.obfsCollection, configuration.reverseGeocodingIndexFilename);
+
+    OsmAnd::Stopwatch prepareStopwatch(true);
+    if (!reverseGeocoder.prepareIndex())
+    {
+        output << xT("Failed to prepare reverse geocoding index") << std::endl;
+        return false;
+    }
+    const auto prepareElapsed = prepareStopwatch.elapsed();
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Index prepared in ") << prepareElapsed << xT("s: ")
+        << reverseGeocoder.getEntriesCount() << xT(" entries") << std::endl;
+
+    // Random, but reproducible, positions within the area
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    std::mt19937 randomGenerator(0);
+    std::uniform_int_distribution<int32_t> xDistribution(bbox31.left(), bbox31.right());
+    std::uniform_int_distribution<int32_t> yDistribution(bbox31.top(), bbox31.bottom());
+    QVector<OsmAnd::PointI> positions31;
+    positions31.reserve(configuration.routesCount);
+    for (auto positionIdx = 0u; positionIdx < configuration.routesCount; positionIdx++)
+        positions31.push_back(OsmAnd::PointI(xDistribution(randomGenerator), yDistribution(randomGenerator)));
+
+    unsigned int foundCount = 0;
+    double distancesSum = 0.0;
+    OsmAnd::Stopwatch stopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        QVector<OsmAnd::ReverseGeocoder::Address> addresses;
+        foundCount += reverseGeocoder.findNearestAddresses(positions31, addresses);
+        for (const auto& address : OsmAnd::constOf(addresses))
+        {
+            if (address.distance >= 0.0)
+                distancesSum += address.distance;
+        }
+    }
+    const auto elapsed = stopwatch.elapsed();
+    const auto queriesCount = configuration.routesCount * configuration.iterations;
+
+    output << xT("Found ") << foundCount << xT(" of ") << queriesCount << xT(" addresses") << std::endl;
+    output << xT("Latency: ") << (elapsed * 1000000.0 / queriesCount) << xT("us per position") << std::endl;
+    output << xT("Throughput: ") << (queriesCount / elapsed) << xT(" positions/s") << std::endl;
+    if (foundCount > 0)
+        output << xT("Distance: ") << (distancesSum / foundCount) << xT("m on average") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkForwardGeocoding(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkForwardGeocoding(std::ostream& output)
+#endif
+{
+    const OsmAnd::ForwardGeocoder forwardGeocoder(configuration.obfsCollection, true);
+
+    OsmAnd::Stopwatch prepareStopwatch(true);
+    if (!forwardGeocoder.prepareIndices())
+    {
+        output << xT("Failed to prepare forward geocoding indices") << std::endl;
+        return false;
+    }
+    const auto prepareElapsed = prepareStopwatch.elapsed();
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Indices prepared in ") << prepareElapsed << xT("s: ")
+        << forwardGeocoder.getIndexedNamesCount() << xT(" names, ")
+        << (forwardGeocoder.getMemoryUsage() / 1024.0 / 1024.0) << xT("MB") << std::endl;
+
+    QStringList queries;
+    if (!configuration.query.isEmpty())
+        queries.push_back(configuration.query);
+    else
+    {
+        // Random, but reproducible, positions within the area give addresses that surely exist
+        const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+        const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+        std::mt19937 randomGenerator(0);
+        std::uniform_int_distribution<int32_t> xDistribution(bbox31.left(), bbox31.right());
+        std::uniform_int_distribution<int32_t> yDistribution(bbox31.top(), bbox31.bottom());
+        QVector<OsmAnd::PointI> positions31;
+        for (auto positionIdx = 0u; positionIdx < configuration.routesCount; positionIdx++)
+            positions31.push_back(OsmAnd::PointI(xDistribution(randomGenerator), yDistribution(randomGenerator)));
+
+        const OsmAnd::ReverseGeocoder reverseGeocoder(configuration.obfsCollection, configuration.reverseGeocodingIndexFilename);
+        QVector<OsmAnd::ReverseGeocoder::Address> addresses;
+        reverseGeocoder.findNearestAddresses(positions31, addresses);
+        for (const auto& address : OsmAnd::constOf(addresses))
+        {
+            if (address.distance < 0.0)
+                continue;
+
+            auto query = address.settlementName + QLatin1String(", ") + address.streetName;
+            if (!address.houseNumber.isEmpty())
+                query += QLatin1String(", ") + address.houseNumber;
+            queries.push_back(query);
+        }
+    }
+    if (queries.isEmpty())
+    {
+        output << xT("No addresses found in area") << std::endl;
+        return false;
+    }
+
+    // Every prefix of every query is a separate query, as if typed one character at a time
+    QVector<float> latencies;
+    unsigned int answeredCount = 0;
+    unsigned int exactCount = 0;
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (const auto& query : OsmAnd::constOf(queries))
+        {
+            for (auto length = 1; length <= query.length(); length++)
+            {
+                QList<OsmAnd::ForwardGeocoder::Result> results;
+                OsmAnd::Stopwatch queryStopwatch(true);
+                const auto found = forwardGeocoder.geocode(query.left(length), results);
+                latencies.push_back(queryStopwatch.elapsed());
+                if (found)
+                    answeredCount++;
+                if (found && length == query.length() && results.first().cost == 0)
+                    exactCount++;
+            }
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile =
+        [&latencies]
+        (const double fraction) -> float
+        {
+            return latencies[qMin(static_cast<int>(fraction * latencies.size()), latencies.size() - 1)];
+        };
+
+    output << xT("Queries: ") << latencies.size() << xT(", answered ") << answeredCount << std::endl;
+    output << xT("Complete queries with exact best result: ") << exactCount << xT(" of ")
+        << (queries.size() * configuration.iterations) << std::endl;
+    output << xT("Latency p50: ") << (percentile(0.50) * 1000.0) << xT("ms") << std::endl;
+    output << xT("Latency p90: ") << (percentile(0.90) * 1000.0) << xT("ms") << std::endl;
+    output << xT("Latency p99: ") << (percentile(0.99) * 1000.0) << xT("ms") << std::endl;
+    output << xT("Latency max: ") << (latencies.last() * 1000.0) << xT("ms") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkNearestAmenities(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkNearestAmenities(std::ostream& output)
+#endif
+{
+    const unsigned int amenitiesCount = 10;
+
+    // Category identifiers are specific to each section, so query is resolved for every section separately
+    struct Section
+    {
+        std::shared_ptr<const OsmAnd::ObfReader> obfReader;
+        std::shared_ptr<const OsmAnd::ObfPoiSectionInfo> poiSection;
+        std::shared_ptr< QSet<uint32_t> > desiredCategories;
+    };
+    QList<Section> sections;
+    const auto dataInterface = configuration.obfsCollection->obtainDataInterface();
+    for (const auto& obfReader : OsmAnd::constOf(dataInterface->obfReaders))
+    {
+        for (const auto& poiSection : OsmAnd::constOf(obfReader->obtainInfo()->poiSections))
+        {
+            Section section;
+            section.obfReader = obfReader;
+            section.poiSection = poiSection;
+            if (!configuration.query.isEmpty())
+            {
+                QList< std::shared_ptr<const OsmAnd::AmenityCategory> > categories;
+                OsmAnd::ObfPoiSectionReader::loadCategories(obfReader, poiSection, categories);
+
+                section.desiredCategories.reset(new QSet<uint32_t>());
+                for (auto catId = 0u; catId < static_cast<unsigned int>(categories.size()); catId++)
+                {
+                    const auto& category = categories[catId];
+                    if (category->name == configuration.query)
+                        section.desiredCategories->insert((catId << 16) | 0xFFFF);
+                    for (auto subId = 0u; subId < static_cast<unsigned int>(category->subcategories.size()); subId++)
+                    {
+                        if (category->subcategories[subId] == configuration.query)
+                            section.desiredCategories->insert((catId << 16) | subId);
+                    }
+                }
+                if (section.desiredCategories->isEmpty())
+                    continue;
+            }
+            sections.push_back(section);
+        }
+    }
+    if (sections.isEmpty())
+    {
+        output << xT("No POI sections with '") << QStringToStlString(configuration.query) << xT("' found") << std::endl;
+        return false;
+    }
+
+    // Random, but reproducible, positions within the area
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    std::mt19937 randomGenerator(0);
+    std::uniform_int_distribution<int32_t> xDistribution(bbox31.left(), bbox31.right());
+    std::uniform_int_distribution<int32_t> yDistribution(bbox31.top(), bbox31.bottom());
+    QVector<OsmAnd::PointI> positions31;
+    positions31.reserve(configuration.routesCount);
+    for (auto positionIdx = 0u; positionIdx < configuration.routesCount; positionIdx++)
+        positions31.push_back(OsmAnd::PointI(xDistribution(randomGenerator), yDistribution(randomGenerator)));
+
+    // Amenities of all sections are merged, keeping only the nearest ones
+    const auto keepNearest =
+        [amenitiesCount]
+        (const OsmAnd::PointI& position31, QList< std::shared_ptr<const OsmAnd::Amenity> >& amenities)
+        {
+            std::sort(amenities.begin(), amenities.end(),
+                [position31]
+                (const std::shared_ptr<const OsmAnd::Amenity>& l, const std::shared_ptr<const OsmAnd::Amenity>& r) -> bool
+                {
+                    return OsmAnd::Utilities::squareDistance31(position31, l->point31) <
+                        OsmAnd::Utilities::squareDistance31(position31, r->point31);
+                });
+            while (amenities.size() > static_cast<int>(amenitiesCount))
+                amenities.removeLast();
+        };
+
+    // Area is doubled until enough amenities are found in it, but amenities found in area are the nearest
+    // ones only if they are not farther than its radius
+    QVector< QList< std::shared_ptr<const OsmAnd::Amenity> > > areaResults(positions31.size());
+    OsmAnd::Stopwatch areaStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (auto positionIdx = 0; positionIdx < positions31.size(); positionIdx++)
+        {
+            const auto& position31 = positions31[positionIdx];
+            auto& amenities = areaResults[positionIdx];
+            for (auto radius = 500.0; radius <= 1024000.0; radius *= 2.0)
+            {
+                amenities.clear();
+                const auto area31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(radius, position31);
+                for (const auto& section : OsmAnd::constOf(sections))
+                {
+                    OsmAnd::ObfPoiSectionReader::loadAmenities(
+                        section.obfReader,
+                        section.poiSection,
+                        OsmAnd::ZoomLevel28,
+                        3,
+                        &area31,
+                        section.desiredCategories.get(),
+                        &amenities);
+                }
+                keepNearest(position31, amenities);
+
+                const auto radius31 = static_cast<double>(area31.width()) / 2.0;
+                if (amenities.size() == static_cast<int>(amenitiesCount) &&
+                    OsmAnd::Utilities::distance31(position31, amenities.last()->point31) <= radius31)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    const auto areaElapsed = areaStopwatch.elapsed();
+
+    QVector< QList< std::shared_ptr<const OsmAnd::Amenity> > > singleResults(positions31.size());
+    OsmAnd::Stopwatch singleStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (auto positionIdx = 0; positionIdx < positions31.size(); positionIdx++)
+        {
+            const auto& position31 = positions31[positionIdx];
+            auto& amenities = singleResults[positionIdx];
+            amenities.clear();
+            for (const auto& section : OsmAnd::constOf(sections))
+            {
+                QList< std::shared_ptr<const OsmAnd::Amenity> > sectionAmenities;
+                OsmAnd::ObfPoiSectionReader::findNearestAmenities(
+                    section.obfReader,
+                    section.poiSection,
+                    position31,
+                    amenitiesCount,
+                    section.desiredCategories.get(),
+                    sectionAmenities);
+                amenities.append(sectionAmenities);
+            }
+            keepNearest(position31, amenities);
+        }
+    }
+    const auto singleElapsed = singleStopwatch.elapsed();
+
+    QVector< QList< std::shared_ptr<const OsmAnd::Amenity> > > batchResults(positions31.size());
+    OsmAnd::Stopwatch batchStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (auto& amenities : batchResults)
+            amenities.clear();
+        for (const auto& section : OsmAnd::constOf(sections))
+        {
+            QVector< QList< std::shared_ptr<const OsmAnd::Amenity> > > sectionAmenities;
+            OsmAnd::ObfPoiSectionReader::findNearestAmenities(
+                section.obfReader,
+                section.poiSection,
+                positions31,
+                amenitiesCount,
+                section.desiredCategories.get(),
+                sectionAmenities);
+            for (auto positionIdx = 0; positionIdx < positions31.size(); positionIdx++)
+                batchResults[positionIdx].append(sectionAmenities[positionIdx]);
+        }
+        for (auto positionIdx = 0; positionIdx < positions31.size(); positionIdx++)
+            keepNearest(positions31[positionIdx], batchResults[positionIdx]);
+    }
+    const auto batchElapsed = batchStopwatch.elapsed();
+
+    // Amenities at equal distance may come in any order, so only the farthest distances are compared
+    unsigned int matchesCount = 0;
+    for (auto positionIdx = 0; positionIdx < positions31.size(); positionIdx++)
+    {
+        const auto& position31 = positions31[positionIdx];
+        const auto& areaAmenities = areaResults[positionIdx];
+        const auto& batchAmenities = batchResults[positionIdx];
+        if (areaAmenities.size() != batchAmenities.size())
+            continue;
+        if (!areaAmenities.isEmpty() &&
+            OsmAnd::Utilities::squareDistance31(position31, areaAmenities.last()->point31) !=
+            OsmAnd::Utilities::squareDistance31(position31, batchAmenities.last()->point31))
+        {
+            continue;
+        }
+        matchesCount++;
+    }
+
+    const auto queriesCount = configuration.routesCount * configuration.iterations;
+    output << std::fixed << std::setprecision(3);
+    output << xT("Sections: ") << sections.size() << xT(", ") << amenitiesCount << xT(" nearest amenities of ")
+        << positions31.size() << xT(" positions") << std::endl;
+    output << xT("Growing area: ") << (areaElapsed * 1000.0 / queriesCount) << xT("ms/position, ")
+        << (queriesCount / areaElapsed) << xT(" positions/s") << std::endl;
+    output << xT("Single k-NN:  ") << (singleElapsed * 1000.0 / queriesCount) << xT("ms/position, ")
+        << (queriesCount / singleElapsed) << xT(" positions/s") << std::endl;
+    output << xT("Batch k-NN:   ") << (batchElapsed * 1000.0 / queriesCount) << xT("ms/position, ")
+        << (queriesCount / batchElapsed) << xT(" positions/s") << std::endl;
+    output << xT("Same results as growing area for ") << matchesCount << xT(" of ") << positions31.size()
+        << xT(" positions") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkTextLabels(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkTextLabels(std::ostream& output)
+#endif
+{
+    // Names of amenities within area are a realistic mix of labels, scripts and lengths
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    QStringList labels;
+    QSet<QString> uniqueLabels;
+    const auto dataInterface = configuration.obfsCollection->obtainDataInterface(bbox31);
+    for (const auto& obfReader : OsmAnd::constOf(dataInterface->obfReaders))
+    {
+        for (const auto& poiSection : OsmAnd::constOf(obfReader->obtainInfo()->poiSections))
+        {
+            QList< std::shared_ptr<const OsmAnd::Amenity> > amenities;
+            OsmAnd::ObfPoiSectionReader::loadAmenities(
+                obfReader,
+                poiSection,
+                OsmAnd::ZoomLevel28,
+                3,
+                &bbox31,
+                nullptr,
+                &amenities);
+            for (const auto& amenity : OsmAnd::constOf(amenities))
+            {
+                if (amenity->name.isEmpty() || uniqueLabels.contains(amenity->name))
+                    continue;
+                uniqueLabels.insert(amenity->name);
+                labels.push_back(amenity->name);
+            }
+        }
+    }
+    if (labels.isEmpty())
+    {
+        output << xT("No named amenities found within area") << std::endl;
+        return false;
+    }
+
+    // Style of typical map caption, with halo thin enough to be drawn from glyph fields at this size
+    const auto style = OsmAnd::TextRasterizer::Style()
+        .setSize(14.0f)
+        .setColor(OsmAnd::ColorARGB(0xFF000000))
+        .setHaloRadius(2)
+        .setHaloColor(OsmAnd::ColorARGB(0xFFFFFFFF))
+        .setWrapWidth(20);
+
+    // Every label is a separate RGBA texture
+    const auto textRasterizer = OsmAnd::TextRasterizer::getDefault();
+    size_t bitmapsSize = 0;
+    OsmAnd::Stopwatch bitmapsStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        bitmapsSize = 0;
+        for (const auto& label : OsmAnd::constOf(labels))
+        {
+            const auto bitmap = textRasterizer->rasterize(label, style);
+            if (bitmap)
+                bitmapsSize += bitmap->getSize();
+        }
+    }
+    const auto bitmapsElapsed = bitmapsStopwatch.elapsed();
+
+    // Glyphs are rendered into atlas only the first time they're met, so cold and warm layouts differ
+    const OsmAnd::SdfGlyphAtlas sdfGlyphAtlas(textRasterizer->fontsCollection);
+    size_t quadsCount = 0;
+    auto notLaidOutCount = 0;
+    OsmAnd::Stopwatch coldStopwatch(true);
+    for (const auto& label : OsmAnd::constOf(labels))
+    {
+        const auto glyphRun = sdfGlyphAtlas.layoutText(label, style);
+        if (glyphRun)
+            quadsCount += glyphRun->quads.size();
+        else
+            notLaidOutCount++;
+    }
+    const auto coldElapsed = coldStopwatch.elapsed();
+
+    OsmAnd::Stopwatch warmStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (const auto& label : OsmAnd::constOf(labels))
+            sdfGlyphAtlas.layoutText(label, style);
+    }
+    const auto warmElapsed = warmStopwatch.elapsed();
+
+    // Each quad is drawn from 4 vertices of clip-space position and texture coordinates
+    const auto verticesSize = quadsCount * 4 * (4 + 2) * sizeof(float);
+    const auto pagesSize = sdfGlyphAtlas.getTextureMemoryUsage();
+
+    const auto labelsCount = labels.size() * configuration.iterations;
+    output << std::fixed << std::setprecision(3);
+    output << xT("Labels: ") << labels.size() << xT(", glyphs in atlas: ") << sdfGlyphAtlas.getGlyphsCount()
+        << xT(", pages: ") << sdfGlyphAtlas.getPagesCount()
+        << xT(", left to bitmaps: ") << notLaidOutCount << std::endl;
+    output << xT("Bitmaps:     ") << (bitmapsElapsed * 1000.0 / labelsCount) << xT("ms/label, ")
+        << (bitmapsSize / 1024.0) << xT("KiB to upload") << std::endl;
+    output << xT("SDF (cold):  ") << (coldElapsed * 1000.0 / labels.size()) << xT("ms/label") << std::endl;
+    output << xT("SDF (warm):  ") << (warmElapsed * 1000.0 / labelsCount) << xT("ms/label, ")
+        << ((pagesSize + verticesSize) / 1024.0) << xT("KiB to upload (")
+        << (pagesSize / 1024.0) << xT("KiB of pages, ")
+        << (verticesSize / 1024.0) << xT("KiB of vertices)") << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkSymbolsIntersections(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkSymbolsIntersections(std::ostream& output)
+#endif
+{
+    typedef OsmAnd::QuadTree<int, OsmAnd::AreaI::CoordType> SymbolsQuadTree;
+    typedef OsmAnd::UniformGrid<int, OsmAnd::AreaI::CoordType> SymbolsGrid;
+
+    // Random, but reproducible, boxes of captions and icons over Full HD screen, a third of them
+    // rotated like captions along paths
+    const OsmAnd::AreaI viewport(0, 0, 1080, 1920);
+    const auto symbolsCount = 5000;
+    std::mt19937 randomGenerator(0);
+    QVector<SymbolsQuadTree::BBox> bboxes;
+    bboxes.reserve(symbolsCount);
+    for (auto symbolIdx = 0; symbolIdx < symbolsCount; symbolIdx++)
+    {
+        const OsmAnd::PointI size(
+            std::uniform_int_distribution<int>(16, 200)(randomGenerator),
+            std::uniform_int_distribution<int>(12, 40)(randomGenerator));
+        const OsmAnd::PointI topLeft(
+            std::uniform_int_distribution<int>(-size.x, viewport.width())(randomGenerator),
+            std::uniform_int_distribution<int>(-size.y, viewport.height())(randomGenerator));
+        const OsmAnd::AreaI aabb(topLeft, topLeft + size);
+        if (symbolIdx % 3 == 0)
+            bboxes.push_back(SymbolsQuadTree::BBox(OsmAnd::OOBBI(aabb, std::uniform_real_distribution<float>(0.0f, M_PI)(randomGenerator))));
+        else
+            bboxes.push_back(SymbolsQuadTree::BBox(aabb));
+    }
+
+    // Screen is panned between frames, so every box is moved
+    const auto getShiftedBBox =
+        []
+        (const SymbolsQuadTree::BBox& bbox, const OsmAnd::PointI& shift) -> SymbolsQuadTree::BBox
+        {
+            if (bbox.type == SymbolsQuadTree::BBoxType::AABB)
+                return SymbolsQuadTree::BBox(bbox.asAABB + shift);
+            else /* if (bbox.type == SymbolsQuadTree::BBoxType::OOBB) */
+                return SymbolsQuadTree::BBox(OsmAnd::OOBBI(bbox.asOOBB.unrotatedBBox() + shift, bbox.asOOBB.rotation()));
+        };
+
+    // Symbols are placed in order of priority, each one plotted only if it doesn't intersect already
+    // plotted ones. Every tenth plotted one is then discarded, as presentation rules of groups do
+    const auto placeSymbols =
+        [&bboxes, getShiftedBBox]
+        (const OsmAnd::PointI& shift, const std::function<bool (const SymbolsQuadTree::BBox& bbox)> test,
+            const std::function<bool (int symbolIdx, const SymbolsQuadTree::BBox& bbox)> insert,
+            const std::function<bool (int symbolIdx, const SymbolsQuadTree::BBox& bbox)> remove,
+            unsigned int& testsCount) -> unsigned int
+        {
+            QVector<int> plottedSymbols;
+            for (auto symbolIdx = 0; symbolIdx < bboxes.size(); symbolIdx++)
+            {
+                const auto shiftedBBox = getShiftedBBox(bboxes[symbolIdx], shift);
+
+                testsCount++;
+                if (test(shiftedBBox))
+                    continue;
+                if (insert(symbolIdx, shiftedBBox))
+                    plottedSymbols.push_back(symbolIdx);
+            }
+
+            auto plottedCount = plottedSymbols.size();
+            for (auto plottedIdx = 0; plottedIdx < plottedSymbols.size(); plottedIdx += 10)
+            {
+                const auto symbolIdx = plottedSymbols[plottedIdx];
+                const auto shiftedBBox = getShiftedBBox(bboxes[symbolIdx], shift);
+                if (remove(symbolIdx, shiftedBBox))
+                    plottedCount--;
+            }
+
+            return plottedCount;
+        };
+
+    // Depth of QuadTree that symbols stage used to build: cells of deepest level are at least 64 pixels wide
+    auto treeDepth = 1u;
+    while ((std::max(viewport.width(), viewport.height()) >> (treeDepth + 6)) > 0)
+        treeDepth++;
+
+    unsigned int treeTestsCount = 0;
+    unsigned int treePlottedCount = 0;
+    OsmAnd::Stopwatch treeStopwatch(true);
+    for (auto frame = 0u; frame < configuration.iterations; frame++)
+    {
+        const OsmAnd::PointI shift(frame % 64, (frame * 3) % 64);
+        SymbolsQuadTree quadTree(viewport, treeDepth);
+        treePlottedCount = placeSymbols(
+            shift,
+            [&quadTree]
+            (const SymbolsQuadTree::BBox& bbox) -> bool
+            {
+                return quadTree.test(bbox);
+            },
+            [&quadTree]
+            (int symbolIdx, const SymbolsQuadTree::BBox& bbox) -> bool
+            {
+                return quadTree.insert(symbolIdx, bbox);
+            },
+            [&quadTree]
+            (int symbolIdx, const SymbolsQuadTree::BBox& bbox) -> bool
+            {
+                return quadTree.removeOne(symbolIdx, bbox);
+            },
+            treeTestsCount);
+    }
+    const auto treeElapsed = treeStopwatch.elapsed();
+
+    unsigned int gridTestsCount = 0;
+    unsigned int gridPlottedCount = 0;
+    SymbolsGrid grid;
+    OsmAnd::Stopwatch gridStopwatch(true);
+    for (auto frame = 0u; frame < configuration.iterations; frame++)
+    {
+        const OsmAnd::PointI shift(frame % 64, (frame * 3) % 64);
+        grid.reset(viewport, 64);
+        gridPlottedCount = placeSymbols(
+            shift,
+            [&grid]
+            (const SymbolsQuadTree::BBox& bbox) -> bool
+            {
+                return grid.test(bbox);
+            },
+            [&grid]
+            (int symbolIdx, const SymbolsQuadTree::BBox& bbox) -> bool
+            {
+                return grid.insert(symbolIdx, bbox);
+            },
+            [&grid]
+            (int symbolIdx, const SymbolsQuadTree::BBox& bbox) -> bool
+            {
+                return grid.removeOne(symbolIdx, bbox);
+            },
+            gridTestsCount);
+    }
+    const auto gridElapsed = gridStopwatch.elapsed();
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Symbols: ") << symbolsCount << xT(", frames: ") << configuration.iterations << std::endl;
+    output << xT("QuadTree:    ") << (treeTestsCount / treeElapsed) << xT(" tests/s, ")
+        << (treeElapsed * 1000.0 / configuration.iterations) << xT("ms/frame, ")
+        << treePlottedCount << xT(" plotted") << std::endl;
+    output << xT("UniformGrid: ") << (gridTestsCount / gridElapsed) << xT(" tests/s, ")
+        << (gridElapsed * 1000.0 / configuration.iterations) << xT("ms/frame, ")
+        << gridPlottedCount << xT(" plotted") << std::endl;
+    if (treePlottedCount != gridPlottedCount)
+    {
+        output << xT("Plotted symbols differ") << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkMapLayerGeometry(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkMapLayerGeometry(std::ostream& output)
+#endif
+{
+    const auto zoom = OsmAnd::ZoomLevel15;
+    const auto tileSize = 256u;
+
+    // Both paths share the same primitives, so they're obtained once and are not measured
+    const std::shared_ptr<OsmAnd::MapStylesCollection> stylesCollection(new OsmAnd::MapStylesCollection());
+    const auto mapStyle = stylesCollection->getResolvedStyleByName(QLatin1String("default"));
+    if (!mapStyle)
+    {
+        output << xT("Failed to resolve default style") << std::endl;
+        return false;
+    }
+    const std::shared_ptr<OsmAnd::MapPresentationEnvironment> environment(new OsmAnd::MapPresentationEnvironment(
+        mapStyle));
+    const std::shared_ptr<OsmAnd::MapPrimitiviser> primitiviser(new OsmAnd::MapPrimitiviser(
+        environment));
+    const std::shared_ptr<OsmAnd::ObfMapObjectsProvider> mapObjectsProvider(new OsmAnd::ObfMapObjectsProvider(
+        configuration.obfsCollection));
+    const std::shared_ptr<OsmAnd::MapPrimitivesProvider> primitivesProvider(new OsmAnd::MapPrimitivesProvider(
+        mapObjectsProvider,
+        primitiviser,
+        tileSize));
+
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    const auto zoomShift = OsmAnd::ZoomLevel31 - zoom;
+    QList< std::shared_ptr<OsmAnd::MapPrimitivesProvider::Data> > primitivesTiles;
+    for (auto tileY = bbox31.top() >> zoomShift; tileY <= (bbox31.bottom() >> zoomShift); tileY++)
+    {
+        for (auto tileX = bbox31.left() >> zoomShift; tileX <= (bbox31.right() >> zoomShift); tileX++)
+        {
+            std::shared_ptr<OsmAnd::MapPrimitivesProvider::Data> primitivesTile;
+            primitivesProvider->obtainData(
+                OsmAnd::TileId::fromXY(tileX, tileY),
+                zoom,
+                primitivesTile,
+                nullptr,
+                nullptr);
+            if (primitivesTile && !primitivesTile->primitivisedObjects->isEmpty())
+                primitivesTiles.push_back(primitivesTile);
+        }
+    }
+    if (primitivesTiles.isEmpty())
+    {
+        output << xT("No map objects found within area") << std::endl;
+        return false;
+    }
+
+    // Rasterization target is reused, as MapRasterLayerProvider_Software allocates one per tile
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(SkImageInfo::MakeN32Premul(tileSize, tileSize)))
+    {
+        output << xT("Failed to allocate rasterization surface") << std::endl;
+        return false;
+    }
+    SkBitmapDevice rasterizationTarget(bitmap);
+    SkCanvas canvas(&rasterizationTarget);
+    OsmAnd::MapRasterizer rasterizer(environment);
+    OsmAnd::Stopwatch rasterizerStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (const auto& primitivesTile : OsmAnd::constOf(primitivesTiles))
+        {
+            rasterizer.rasterize(
+                OsmAnd::Utilities::tileBoundingBox31(primitivesTile->tileId, zoom),
+                primitivesTile->primitivisedObjects,
+                canvas);
+        }
+    }
+    const auto rasterizerElapsed = rasterizerStopwatch.elapsed();
+
+    OsmAnd::MapTessellator tessellator(environment);
+    OsmAnd::MapTessellator_Metrics::Metric_tessellate tessellateMetric;
+    QVector<OsmAnd::MapTessellator::Vertex> vertices;
+    size_t verticesCount = 0;
+    OsmAnd::Stopwatch tessellatorStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        verticesCount = 0;
+        for (const auto& primitivesTile : OsmAnd::constOf(primitivesTiles))
+        {
+            vertices.resize(0);
+            tessellator.tessellate(
+                OsmAnd::Utilities::tileBoundingBox31(primitivesTile->tileId, zoom),
+                primitivesTile->primitivisedObjects,
+                vertices,
+                true,
+                iteration == 0 ? &tessellateMetric : nullptr);
+            verticesCount += vertices.size();
+        }
+    }
+    const auto tessellatorElapsed = tessellatorStopwatch.elapsed();
+
+    const auto tilesCount = primitivesTiles.size() * configuration.iterations;
+    const auto bitmapsSize = primitivesTiles.size() * bitmap.getSize();
+    const auto verticesSize = verticesCount * sizeof(OsmAnd::MapTessellator::Vertex);
+    output << std::fixed << std::setprecision(3);
+    output << xT("Tiles: ") << primitivesTiles.size() << xT(" at zoom ") << zoom << std::endl;
+    output << xT("MapRasterizer:  ") << (rasterizerElapsed * 1000.0 / tilesCount) << xT("ms/tile, ")
+        << (bitmapsSize / 1024.0) << xT("KiB to upload") << std::endl;
+    output << xT("MapTessellator: ") << (tessellatorElapsed * 1000.0 / tilesCount) << xT("ms/tile, ")
+        << (verticesSize / 1024.0) << xT("KiB to upload (")
+        << (verticesCount / 3) << xT(" triangles)") << std::endl;
+    output << QStringToStlString(tessellateMetric.toString(false, QLatin1String("\t"))) << std::endl;
+
+    return true;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkRoutingProfile(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkRoutingProfile(std::ostream& output)
+#endif
+{
+    const auto routingProfile = loadRoutingProfile();
+    if (!routingProfile)
+    {
+        output << xT("Failed to load routing profile '") << QStringToStlString(configuration.routingProfileName) << xT("'") << std::endl;
+        return false;
+    }
+
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    QList< std::shared_ptr<const OsmAnd::Road> > roads;
+    configuration.obfsCollection->obtainDataInterface(bbox31)->loadRoads(
+        OsmAnd::RoutingDataLevel::Detailed,
+        &bbox31,
+        &roads);
+    if (roads.isEmpty())
+    {
+        output << xT("No roads found in area") << std::endl;
+        return false;
+    }
+
+    // Both ways evaluate the same four rulesets per road, so results are compared as well. Context of compiled
+    // profile is created anew on each iteration, so time to fill its tables is included
+    unsigned int mismatchesCount = 0;
+    double checksum = 0.0;
+    OsmAnd::Stopwatch interpretedStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        OsmAnd::RoutingProfileContext context(routingProfile);
+        const auto accessContext = context.getRulesetContext(OsmAnd::RoutingRuleset::Access);
+        const auto oneWayContext = context.getRulesetContext(OsmAnd::RoutingRuleset::OneWay);
+        const auto speedContext = context.getRulesetContext(OsmAnd::RoutingRuleset::RoadSpeed);
+        const auto priorityContext = context.getRulesetContext(OsmAnd::RoutingRuleset::RoadPriorities);
+        for (const auto& road : OsmAnd::constOf(roads))
+        {
+            checksum += accessContext->evaluateAsInteger(road, 0);
+            checksum += oneWayContext->evaluateAsInteger(road, 0);
+            checksum += speedContext->evaluateAsFloat(road, routingProfile->minDefaultSpeed);
+            checksum += priorityContext->evaluateAsFloat(road, 1.0f);
+        }
+    }
+    const auto interpretedElapsed = interpretedStopwatch.elapsed();
+
+    OsmAnd::Stopwatch compiledStopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        OsmAnd::RoutingProfileContext context(routingProfile);
+        for (const auto& road : OsmAnd::constOf(roads))
+        {
+            const auto compiledRoadTypes = context.getCompiledRoadTypes(road);
+            checksum += static_cast<int>(compiledRoadTypes.direction) + compiledRoadTypes.speed + compiledRoadTypes.speedPriority;
+        }
+    }
+    const auto compiledElapsed = compiledStopwatch.elapsed();
+
+    OsmAnd::RoutingProfileContext interpretedContext(routingProfile);
+    OsmAnd::RoutingProfileContext compiledContext(routingProfile);
+    for (const auto& road : OsmAnd::constOf(roads))
+    {
+        const auto compiledRoadTypes = compiledContext.getCompiledRoadTypes(road);
+        const auto accepted = interpretedContext.getRulesetContext(OsmAnd::RoutingRuleset::Access)->evaluateAsInteger(road, 0) >= 0;
+        const auto speed = interpretedContext.getRulesetContext(OsmAnd::RoutingRuleset::RoadSpeed)->evaluateAsFloat(
+            road,
+            routingProfile->minDefaultSpeed);
+        if (accepted != compiledRoadTypes.accepted || !qFuzzyCompare(speed, compiledRoadTypes.speed))
+            mismatchesCount++;
+    }
+
+    const auto evaluationsCount = static_cast<double>(roads.size()) * configuration.iterations;
+    output << std::fixed << std::setprecision(3);
+    output << xT("Roads:          ") << roads.size() << std::endl;
+    output << xT("Interpreted:    ") << (interpretedElapsed * 1000000.0 / evaluationsCount) << xT("us per road") << std::endl;
+    output << xT("Compiled:       ") << (compiledElapsed * 1000000.0 / evaluationsCount) << xT("us per road") << std::endl;
+    output << xT("Mismatches:     ") << mismatchesCount << std::endl;
+    if (configuration.verbose)
+        output << xT("Checksum:       ") << checksum << std::endl;
+
+    return mismatchesCount == 0;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkTurnRestrictions(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkTurnRestrictions(std::ostream& output)
+#endif
+{
+    const auto router = createRoadRouter();
+    if (!router)
+    {
+        output << xT("Failed to load routing profile") << std::endl;
+        return false;
+    }
+    if (!router->costModel->isRestrictionsAware())
+    {
+        output << xT("'") << QStringToStlString(router->costModel->getSignature()) << xT("' doesn't obey turn restrictions") << std::endl;
+        return false;
+    }
+
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    QList< std::shared_ptr<const OsmAnd::Road> > roads;
+    configuration.obfsCollection->obtainDataInterface(bbox31)->loadRoads(
+        OsmAnd::RoutingDataLevel::Detailed,
+        &bbox31,
+        &roads);
+    QHash< uint64_t, std::shared_ptr<const OsmAnd::Road> > roadsById;
+    for (const auto& road : OsmAnd::constOf(roads))
+        roadsById.insert(road->id, road);
+
+    // Route goes from the middle of restricted road segment next to the junction to the middle of segment of
+    // the road that can't be turned to. It's wrong if it goes from one road right to another
+    unsigned int checkedCount = 0;
+    unsigned int foundRoutesCount = 0;
+    unsigned int violationsCount = 0;
+    OsmAnd::Stopwatch stopwatch(true);
+    for (const auto& fromRoad : OsmAnd::constOf(roads))
+    {
+        if (checkedCount >= configuration.routesCount)
+            break;
+        if (fromRoad->points31.size() < 2)
+            continue;
+
+        const auto& restrictions = fromRoad->restrictions;
+        for (auto itRestriction = restrictions.cbegin(); itRestriction != restrictions.cend() && checkedCount < configuration.routesCount; ++itRestriction)
+        {
+            if (itRestriction.value() != OsmAnd::RoadRestriction::NoLeftTurn)
+                continue;
+            const auto toRoad = roadsById.value(itRestriction.key());
+            if (!toRoad || toRoad->points31.size() < 2)
+                continue;
+
+            auto fromPointIndex = -1;
+            auto toPointIndex = -1;
+            for (auto pointIdx = 0; pointIdx < fromRoad->points31.size() && toPointIndex < 0; pointIdx++)
+            {
+                fromPointIndex = pointIdx;
+                toPointIndex = toRoad->points31.indexOf(fromRoad->points31[pointIdx]);
+            }
+            if (toPointIndex < 0)
+                continue;
+
+            const auto& junction31 = fromRoad->points31[fromPointIndex];
+            const auto& from31 = fromRoad->points31[fromPointIndex > 0 ? fromPointIndex - 1 : fromPointIndex + 1];
+            const auto& to31 = toRoad->points31[toPointIndex + 1 < toRoad->points31.size() ? toPointIndex + 1 : toPointIndex - 1];
+            const OsmAnd::PointI start31(junction31.x + (from31.x - junction31.x) / 2, junction31.y + (from31.y - junction31.y) / 2);
+            const OsmAnd::PointI finish31(junction31.x + (to31.x - junction31.x) / 2, junction31.y + (to31.y - junction31.y) / 2);
+
+            checkedCount++;
+            OsmAnd::RoadRouter::Route route;
+            if (!router->findRoute(start31, finish31, route))
+                continue;
+            foundRoutesCount++;
+
+            for (auto segmentIdx = 1; segmentIdx < route.segments.size(); segmentIdx++)
+            {
+                if (route.segments[segmentIdx - 1].road->id != fromRoad->id || route.segments[segmentIdx].road->id != toRoad->id)
+                    continue;
+
+                violationsCount++;
+                if (configuration.verbose)
+                {
+                    output << xT("Forbidden turn from road ") << fromRoad->id.id << xT(" to road ") << toRoad->id.id
+                        << xT(" at ") << junction31.x << xT(";") << junction31.y << std::endl;
+                }
+                break;
+            }
+        }
+    }
+    const auto elapsed = stopwatch.elapsed();
+    if (checkedCount == 0)
+    {
+        output << xT("No 'no left turn' restrictions found in area") << std::endl;
+        return false;
+    }
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Restrictions:   ") << checkedCount << std::endl;
+    output << xT("Routes found:   ") << foundRoutesCount << std::endl;
+    output << xT("Violations:     ") << violationsCount << std::endl;
+    output << xT("Latency:        ") << (elapsed * 1000.0 / checkedCount) << xT("ms per route") << std::endl;
+
+    return violationsCount == 0;
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::Benchmarker::benchmarkIsochrones(std::wostream& output)
+#else
+bool OsmAndTools::Benchmarker::benchmarkIsochrones(std::ostream& output)
+#endif
+{
+    QVector<OsmAnd::PointI> origins31;
+    if (!obtainRandomRoadPoints(configuration.routesCount, origins31))
+    {
+        output << xT("No roads found in area") << std::endl;
+        return false;
+    }
+
+    const auto costModel = createRoadCostModel();
+    if (!costModel)
+    {
+        output << xT("Failed to load routing profile") << std::endl;
+        return false;
+    }
+    const std::shared_ptr<OsmAnd::ObfRoutingSectionReader::DataBlocksCache> cache(
+        new OsmAnd::BudgetedRoutingDataBlocksCache());
+    const OsmAnd::IsochroneEngine engine(configuration.obfsCollection, costModel, cache);
+
+    // Area of polygons in squared 31-coordinates, without their holes
+    const auto computeRingArea =
+        []
+        (const QVector<OsmAnd::PointI>& ring31) -> double
+        {
+            double doubledArea = 0.0;
+            for (auto pointIdx = 1; pointIdx < ring31.size(); pointIdx++)
+            {
+                const auto& p0 = ring31[pointIdx - 1];
+                const auto& p1 = ring31[pointIdx];
+                doubledArea += static_cast<double>(p0.x) * p1.y - static_cast<double>(p1.x) * p0.y;
+            }
+            return qAbs(doubledArea) / 2.0;
+        };
+    const auto computeArea =
+        [computeRingArea]
+        (const OsmAnd::IsochroneEngine::Isochrone& isochrone) -> double
+        {
+            double area = 0.0;
+            for (const auto& polygon : OsmAnd::constOf(isochrone.polygons))
+            {
+                area += computeRingArea(polygon.outerRing31);
+                for (const auto& innerRing31 : OsmAnd::constOf(polygon.innerRings31))
+                    area -= computeRingArea(innerRing31);
+            }
+            return area;
+        };
+
+    // Bands of 5, 10 and 15 minutes
+    const QList<float> times = QList<float>() << 300.0f << 600.0f << 900.0f;
+    unsigned int computedCount = 0;
+    unsigned int polygonsCount = 0;
+    unsigned int shrinkingBandsCount = 0;
+    OsmAnd::Stopwatch stopwatch(true);
+    for (auto iteration = 0u; iteration < configuration.iterations; iteration++)
+    {
+        for (const auto& origin31 : OsmAnd::constOf(origins31))
+        {
+            QList<OsmAnd::IsochroneEngine::Isochrone> isochrones;
+            if (!engine.compute(origin31, times, isochrones))
+                continue;
+            computedCount++;
+
+            auto previousArea = 0.0;
+            for (const auto& isochrone : OsmAnd::constOf(isochrones))
+            {
+                polygonsCount += isochrone.polygons.size();
+
+                const auto area = computeArea(isochrone);
+                if (area < previousArea)
+                {
+                    shrinkingBandsCount++;
+                    if (configuration.verbose)
+                    {
+                        output << xT("Area within ") << isochrone.time << xT("s from ")
+                            << origin31.x << xT(";") << origin31.y << xT(" is smaller than the one before") << std::endl;
+                    }
+                }
+                previousArea = area;
+            }
+        }
+    }
+    const auto elapsed = stopwatch.elapsed();
+    const auto queriesCount = origins31.size() * configuration.iterations;
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Isochrones:     ") << computedCount << xT(" of ") << queriesCount << xT(" computed") << std::endl;
+    output << xT("Polygons:       ") << polygonsCount << std::endl;
+    output << xT("Shrinking:      ") << shrinkingBandsCount << xT(" bands") << std::endl;
+    output << xT("Latency:        ") << (elapsed * 1000.0 / queriesCount) << xT("ms per origin") << std::endl;
+
+    return computedCount > 0 && shrinkingBandsCount == 0;
+}
+
+bool OsmAndTools::Benchmarker::obtainRandomRoadPoints(const unsigned int count, QVector<OsmAnd::PointI>& outPoints31) const
+{
+    // Random, but reproducible, road points within the area
+    const auto center31 = OsmAnd::Utilities::convertLatLonTo31(configuration.center);
+    const auto bbox31 = (OsmAnd::AreaI)OsmAnd::Utilities::boundingBox31FromAreaInMeters(configuration.radiusInMeters, center31);
+    QList< std::shared_ptr<const OsmAnd::Road> > roads;
+    configuration.obfsCollection->obtainDataInterface(bbox31)->loadRoads(
+        OsmAnd::RoutingDataLevel::Detailed,
+        &bbox31,
+        &roads);
+    if (roads.isEmpty())
+        return false;
+
+    std::mt19937 randomGenerator(0);
+    outPoints31.clear();
+    outPoints31.reserve(count);
+    for (auto pointIdx = 0u; pointIdx < count; pointIdx++)
+    {
+        const auto& road = roads[std::uniform_int_distribution<int>(0, roads.size() - 1)(randomGenerator)];
+        outPoints31.push_back(road->points31[std::uniform_int_distribution<int>(0, road->points31.size() - 1)(randomGenerator)]);
+    }
+
+    return true;
+}
+
+std::shared_ptr<OsmAnd::RoutingProfile> OsmAndTools::Benchmarker::loadRoutingProfile() const
+{
+    QFile routingConfigFile(configuration.routingConfigFilename);
+    if (!routingConfigFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return nullptr;
+    OsmAnd::RoutingConfiguration routingConfig;
+    const auto parsed = OsmAnd::RoutingConfiguration::parseConfiguration(&routingConfigFile, routingConfig);
+    routingConfigFile.close();
+    if (!parsed)
+        return nullptr;
+
+    return routingConfig.routingProfiles.value(configuration.routingProfileName);
+}
+
+std::shared_ptr<const OsmAnd::IRoadCostModel> OsmAndTools::Benchmarker::createRoadCostModel() const
+{
+    if (configuration.routingConfigFilename.isEmpty())
+        return std::make_shared<OsmAnd::DefaultRoadCostModel>();
+
+    const auto routingProfile = loadRoutingProfile();
+    if (!routingProfile)
+        return nullptr;
+    return std::make_shared<OsmAnd::ProfileRoadCostModel>(routingProfile);
+}
+
+std::shared_ptr<OsmAnd::RoadRouter> OsmAndTools::Benchmarker::createRoadRouter() const
+{
+    const auto costModel = createRoadCostModel();
+    if (!costModel)
+        return nullptr;
+
+    const std::shared_ptr<OsmAnd::ObfRoutingSectionReader::DataBlocksCache> cache(
+        new OsmAnd::BudgetedRoutingDataBlocksCache());
+    std::shared_ptr<const OsmAnd::ContractionHierarchy> contractionHierarchy;
+    if (!configuration.contractionHierarchyFilename.isEmpty())
+        contractionHierarchy.reset(new OsmAnd::ContractionHierarchy(configuration.contractionHierarchyFilename));
+
+    return std::shared_ptr<OsmAnd::RoadRouter>(new OsmAnd::RoadRouter(
+        configuration.obfsCollection,
+        costModel,
+        cache,
+        contractionHierarchy));
+}
+
+bool OsmAndTools::Benchmarker::benchmark(QString *pLog /*= nullptr*/)
+{
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        const bool success = benchmark(output);
+        *pLog = QString::fromStdWString(output.str());
+        return success;
+#else
+        std::ostringstream output;
+        const bool success = benchmark(output);
+        *pLog = QString::fromStdString(output.str());
+        return success;
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        return benchmark(std::wcout);
+#else
+        return benchmark(std::cout);
+#endif
+    }
+}
+
+OsmAndTools::Benchmarker::Configuration::Configuration()
+    : benchmark(Benchmark::Unspecified)
+    , iterations(1)
+    , verbose(false)
+    , radiusInMeters(10000.0)
+    , routesCount(100)
+    , threadsCount(0)
+    , routingProfileName(QLatin1String("car"))
+{
+    matrixSizes << 100 << 1000;
+}
+
+bool OsmAndTools::Benchmarker::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    const std::shared_ptr<OsmAnd::ObfsCollection> obfsCollection(new OsmAnd::ObfsCollection());
+    outConfiguration.obfsCollection = obfsCollection;
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-benchmark=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-benchmark=")));
+            if (value == QLatin1String("elevationData"))
+                outConfiguration.benchmark = Benchmark::ElevationData;
+            else if (value == QLatin1String("search"))
+                outConfiguration.benchmark = Benchmark::Search;
+            else if (value == QLatin1String("poiNameSearch"))
+                outConfiguration.benchmark = Benchmark::PoiNameSearch;
+            else if (value == QLatin1String("mapMatching"))
+                outConfiguration.benchmark = Benchmark::MapMatching;
+            else if (value == QLatin1String("routing"))
+                outConfiguration.benchmark = Benchmark::Routing;
+            else if (value == QLatin1String("travelTimeMatrix"))
+                outConfiguration.benchmark = Benchmark::TravelTimeMatrix;
+            else if (value == QLatin1String("roadGraphs"))
+                outConfiguration.benchmark = Benchmark::RoadGraphs;
+            else if (value == QLatin1String("transit"))
+                outConfiguration.benchmark = Benchmark::Transit;
+            else if (value == QLatin1String("reverseGeocoding"))
+                outConfiguration.benchmark = Benchmark::ReverseGeocoding;
+            else if (value == QLatin1String("forwardGeocoding"))
+                outConfiguration.benchmark = Benchmark::ForwardGeocoding;
+            else if (value == QLatin1String("nearestAmenities"))
+                outConfiguration.benchmark = Benchmark::NearestAmenities;
+            else if (value == QLatin1String("textLabels"))
+                outConfiguration.benchmark = Benchmark::TextLabels;
+            else if (value == QLatin1String("symbolsIntersections"))
+                outConfiguration.benchmark = Benchmark::SymbolsIntersections;
+            else if (value == QLatin1String("mapLayerGeometry"))
+                outConfiguration.benchmark = Benchmark::MapLayerGeometry;
+            else if (value == QLatin1String("routingProfile"))
+                outConfiguration.benchmark = Benchmark::RoutingProfile;
+            else if (value == QLatin1String("turnRestrictions"))
+                outConfiguration.benchmark = Benchmark::TurnRestrictions;
+            else if (value == QLatin1String("isochrones"))
+                outConfiguration.benchmark = Benchmark::Isochrones;
+            else
+            {
+                outError = QString("'%1' is not a known benchmark").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-iterations=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-iterations=")));
+
+            bool ok = false;
+            outConfiguration.iterations = value.toUInt(&ok);
+            if (!ok || outConfiguration.iterations == 0)
+            {
+                outError = QString("'%1' can not be parsed as iterations count").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-heightmapTileDbPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-heightmapTileDbPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.heightmapTileDbPath = value;
+        }
+        else if (arg.startsWith(QLatin1String("-heightmapTileDbIndex=")))
+        {
+            outConfiguration.heightmapTileDbIndexFilename = Utilities::resolvePath(arg.mid(strlen("-heightmapTileDbIndex=")));
+        }
+        else if (arg.startsWith(QLatin1String("-elevationPyramid=")))
+        {
+            outConfiguration.elevationPyramidFilename = Utilities::resolvePath(arg.mid(strlen("-elevationPyramid=")));
+        }
+        else if (arg.startsWith(QLatin1String("-obfsPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfsPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addDirectory(value, false);
+        }
+        else if (arg.startsWith(QLatin1String("-obfFile=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfFile=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addFile(value);
+        }
+        else if (arg.startsWith(QLatin1String("-matrixSizes=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-matrixSizes=")));
+
+            outConfiguration.matrixSizes.clear();
+            for (const auto& component : value.split(QLatin1Char(',')))
+            {
+                bool ok = false;
+                const auto matrixSize = component.toUInt(&ok);
+                if (!ok || matrixSize == 0)
+                {
+                    outError = QString("'%1' can not be parsed as matrix sizes").arg(value);
+                    return false;
+                }
+                outConfiguration.matrixSizes.push_back(matrixSize);
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-threads=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-threads=")));
+
+            bool ok = false;
+            outConfiguration.threadsCount = value.toUInt(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as threads count").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-contractionHierarchy=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-contractionHierarchy=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.contractionHierarchyFilename = value;
+        }
+        else if (arg.startsWith(QLatin1String("-routingConfig=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-routingConfig=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.routingConfigFilename = value;
+        }
+        else if (arg.startsWith(QLatin1String("-routingProfile=")))
+        {
+            outConfiguration.routingProfileName = Utilities::purifyArgumentValue(arg.mid(strlen("-routingProfile=")));
+        }
+        else if (arg.startsWith(QLatin1String("-reverseGeocodingIndex=")))
+        {
+            // Index is created if it does not exist yet
+            outConfiguration.reverseGeocodingIndexFilename = Utilities::resolvePath(arg.mid(strlen("-reverseGeocodingIndex=")));
+        }
+        else if (arg.startsWith(QLatin1String("-query=")))
+        {
+            outConfiguration.query = Utilities::purifyArgumentValue(arg.mid(strlen("-query=")));
+        }
+        else if (arg.startsWith(QLatin1String("-gpx=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-gpx=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.gpxFilename = value;
+        }
+        else if (arg.startsWith(QLatin1String("-center=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-center=")));
+            const auto components = value.split(QLatin1Char(','));
+
+            bool latOk = false;
+            bool lonOk = false;
+            if (components.size() == 2)
+            {
+                outConfiguration.center.latitude = components[0].toDouble(&latOk);
+                outConfiguration.center.longitude = components[1].toDouble(&lonOk);
+            }
+            if (!latOk || !lonOk)
+            {
+                outError = QString("'%1' can not be parsed as latitude,longitude").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-radius=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-radius=")));
+
+            bool ok = false;
+            outConfiguration.radiusInMeters = value.toDouble(&ok);
+            if (!ok || outConfiguration.radiusInMeters <= 0.0)
+            {
+                outError = QString("'%1' can not be parsed as radius").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-routes=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-routes=")));
+
+            bool ok = false;
+            outConfiguration.routesCount = value.toUInt(&ok);
+            if (!ok || outConfiguration.routesCount == 0)
+            {
+                outError = QString("'%1' can not be parsed as routes count").arg(value);
+                return false;
+            }
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    if (outConfiguration.benchmark == Benchmark::Unspecified)
+    {
+        outError = QLatin1String("'benchmark' has to be specified");
+        return false;
+    }
+    if (outConfiguration.benchmark == Benchmark::ElevationData)
+    {
+        if (outConfiguration.heightmapTileDbPath.isEmpty() || outConfiguration.elevationPyramidFilename.isEmpty())
+        {
+            outError = QLatin1String("'heightmapTileDbPath' and 'elevationPyramid' are required");
+            return false;
+        }
+    }
+    if (outConfiguration.benchmark == Benchmark::Search || outConfiguration.benchmark == Benchmark::PoiNameSearch)
+    {
+        if (obfsCollection->getObfFiles().isEmpty() || outConfiguration.query.isEmpty())
+        {
+            outError = QLatin1String("'obfsPath' or 'obfFile', and 'query' are required");
+            return false;
+        }
+    }
+    if (outConfiguration.benchmark == Benchmark::MapMatching)
+    {
+        if (obfsCollection->getObfFiles().isEmpty() || outConfiguration.gpxFilename.isEmpty())
+        {
+            outError = QLatin1String("'obfsPath' or 'obfFile', and 'gpx' are required");
+            return false;
+        }
+    }
+    if (outConfiguration.benchmark == Benchmark::RoutingProfile && outConfiguration.routingConfigFilename.isEmpty())
+    {
+        outError = QLatin1String("'routingConfig' is required");
+        return false;
+    }
+    if (outConfiguration.benchmark == Benchmark::Routing ||
+        outConfiguration.benchmark == Benchmark::TravelTimeMatrix ||
+        outConfiguration.benchmark == Benchmark::RoadGraphs ||
+        outConfiguration.benchmark == Benchmark::Transit ||
+        outConfiguration.benchmark == Benchmark::ReverseGeocoding ||
+        outConfiguration.benchmark == Benchmark::ForwardGeocoding ||
+        outConfiguration.benchmark == Benchmark::NearestAmenities ||
+        outConfiguration.benchmark == Benchmark::TextLabels ||
+        outConfiguration.benchmark == Benchmark::RoutingProfile ||
+        outConfiguration.benchmark == Benchmark::TurnRestrictions ||
+        outConfiguration.benchmark == Benchmark::Isochrones)
+    {
+        if (obfsCollection->getObfFiles().isEmpty())
+        {
+            outError = QLatin1String("'obfsPath' or 'obfFile' is required");
+            return false;
+        }
+    }
+
+    return true;
+}
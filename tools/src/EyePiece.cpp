@@ -2,15 +2,23 @@
 
 #include <OsmAndCore/stdlib_common.h>
 #include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <algorithm>
 #include <iomanip>
 #include <OsmAndCore/restore_internal_warnings.h>
 
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QVector>
+#include <QTextStream>
+#include <OsmAndCore/restore_internal_warnings.h>
+
 #include <OsmAndCore.h>
 #include <OsmAndCore/ObfsCollection.h>
 #include <OsmAndCore/Stopwatch.h>
 #include <OsmAndCore/Utilities.h>
 #include <OsmAndCore/CoreResourcesEmbeddedBundle.h>
 #include <OsmAndCore/Map/IMapRenderer.h>
+#include <OsmAndCore/Map/IMapRenderer_Metrics.h>
 #include <OsmAndCore/Map/AtlasMapRendererConfiguration.h>
 #include <OsmAndCore/Map/MapStylesCollection.h>
 #include <OsmAndCore/Map/MapPresentationEnvironment.h>
@@ -19,6 +27,7 @@
 #include <OsmAndCore/Map/MapPrimitivesProvider.h>
 #include <OsmAndCore/Map/MapObjectsSymbolsProvider.h>
 #include <OsmAndCore/Map/MapRasterLayerProvider_Software.h>
+#include <OsmAndCore/Map/MapViewsBatchRenderer.h>
 
 #include <OsmAndCore/ignore_warnings_on_external_includes.h>
 #if defined(OSMAND_TARGET_OS_windows)
@@ -923,10 +932,6 @@ bool OsmAndTools::EyePiece::rasterize(std::ostream& output)
         const auto mapRendererConfiguration = std::static_pointer_cast<OsmAnd::AtlasMapRendererConfiguration>(mapRenderer->getConfiguration());
         mapRendererConfiguration->referenceTileSizeOnScreenInPixels = configuration.referenceTileSize;
         mapRenderer->setConfiguration(mapRendererConfiguration);
-        mapRenderer->setTarget(configuration.target31);
-        mapRenderer->setZoom(configuration.zoom);
-        mapRenderer->setAzimuth(configuration.azimuth);
-        mapRenderer->setElevationAngle(configuration.elevationAngle);
         mapRenderer->setWindowSize(OsmAnd::PointI(configuration.outputImageWidth, configuration.outputImageHeight));
         mapRenderer->setViewport(OsmAnd::AreaI(0, 0, configuration.outputImageHeight, configuration.outputImageWidth));
         mapRenderer->setFieldOfView(configuration.fov);
@@ -948,57 +953,114 @@ bool OsmAndTools::EyePiece::rasterize(std::ostream& output)
             break;
         }
 
-        // Repeat processing and rendering until everything is complete
-        if (configuration.verbose)
-            output << xT("Rendering frames...") << std::endl;
-        OsmAnd::Stopwatch renderingStopwatch(true);
-        auto framesCounter = 0u;
-        bool wasInterrupted = false;
-        for (;; framesCounter++)
-        {
-            // Update must be performed before each frame
-            if (!mapRenderer->update())
-                output << xT("Map renderer: update failed") << std::endl;
+        if (configuration.zoomGestureDuration > 0.0f && !benchmarkZoomGesture(mapRenderer, output))
+            success = false;
 
-            // If frame was prepared, it means there's something to render
-            if (mapRenderer->prepareFrame())
+        // All views are rendered by the same renderer one after another, so that resources of previous
+        // views that are still in GPU and caches of providers are reused by the following ones. View that
+        // failed doesn't stop the following ones
+        const OsmAnd::MapViewsBatchRenderer batchRenderer(mapRenderer);
+        OsmAnd::Stopwatch viewsStopwatch(true);
+        const auto imagesCounter = batchRenderer.render(getViews(),
+            [this, &output, &success]
+            (const View& view,
+                const std::shared_ptr<const SkBitmap>& image,
+                const OsmAnd::MapViewsBatchRenderer::ViewStatistics& statistics,
+                const QString& error)
             {
-                const auto ok = mapRenderer->renderFrame();
-                glVerifyResult(output);
+                if (!image)
+                {
+                    output << xT("ERROR: View '") << QStringToStlString(view.name) << xT("' failed: ") << QStringToStlString(error) << std::endl;
+                    success = false;
+                    return;
+                }
 
-                if (!ok)
-                    output << xT("Map renderer: frame rendering failed") << std::endl;
-            }
+                const auto& framesTimes = statistics.framesTimes;
+                if (configuration.verbose)
+                {
+                    output << xT("Rendered view '") << QStringToStlString(view.name) << xT("' with ") << framesTimes.size() << xT(" frames in ") << statistics.elapsedTime << xT("s") << std::endl;
+                }
 
-            // Send everything to GPU
-            glFlush();
-            glVerifyResult(output);
+                // Spikes of frame time show resources uploads that didn't fit into budget of frame
+                if (configuration.verbose && !framesTimes.isEmpty())
+                {
+                    const auto getPercentile =
+                        [&framesTimes]
+                        (const int percentile) -> float
+                        {
+                            return framesTimes[qMin(framesTimes.size() * percentile / 100, framesTimes.size() - 1)];
+                        };
+                    output
+                        << xT("Frame time: p50 ") << getPercentile(50) * 1000.0f
+                        << xT("ms, p90 ") << getPercentile(90) * 1000.0f
+                        << xT("ms, p99 ") << getPercentile(99) * 1000.0f
+                        << xT("ms, max ") << framesTimes.last() * 1000.0f << xT("ms") << std::endl;
+                }
 
-            // Check if map renderer finished processing
-            if (mapRenderer->isIdle())
-                break;
+                // Save bitmap to image (if required)
+                if (view.name.isEmpty())
+                    return;
+                if (configuration.verbose)
+                    output << xT("Saving image to '") << QStringToStlString(view.name) << xT("'...") << std::endl;
 
-            if (renderingStopwatch.elapsed() > (10 * 60 /* 10 minutes */))
-            {
-                wasInterrupted = true;
-                break;
-            }
-        }
-        const auto timeElapsedOnRendering = renderingStopwatch.elapsed();
-        if (configuration.verbose)
-            output << xT("Rendered ") << framesCounter << xT(" frames in ") << timeElapsedOnRendering << xT("s") << std::endl;
+                std::unique_ptr<SkImageEncoder> imageEncoder;
+                switch (configuration.outputImageFormat)
+                {
+                    case ImageFormat::PNG:
+                        imageEncoder.reset(CreatePNGImageEncoder());
+                        break;
 
-        if (wasInterrupted)
-        {
-            output << xT("ERROR: Rendering was interrupted since it took too long (more than 10 minutes). Probably it's stuck: ") << QStringToStlString(mapRenderer->getNotIdleReason()) << std::endl;
-            success = false;
-        }
+                    case ImageFormat::JPEG:
+                        imageEncoder.reset(CreateJPEGImageEncoder());
+                        break;
+                }
 
-        // Wait until everything is ready on GPU
-        if (configuration.verbose)
-            output << xT("Waiting for GPU to complete all stuff requested...") << std::endl;
-        glFinish();
+                const auto imageData = imageEncoder->encodeData(*image, 100);
+                if (!imageData)
+                {
+                    output << xT("Failed to encode image") << std::endl;
+                    success = false;
+                    return;
+                }
+
+                QFile imageFile(view.name);
+
+                // Just in case try to create entire path
+                auto containingDirectory = QFileInfo(imageFile).absoluteDir();
+                containingDirectory.mkpath(QLatin1String("."));
+                if (!QFileInfo(containingDirectory.absolutePath()).isWritable())
+                {
+                    output << xT("'") << QStringToStlString(containingDirectory.absolutePath()) << xT("' is not writable") << std::endl;
+                    success = false;
+                }
+                else
+                {
+                    if (!imageFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                    {
+                        output << xT("Failed to open destination file '") << QStringToStlString(view.name) << xT("'") << std::endl;
+                        success = false;
+                    }
+                    else
+                    {
+                        if (imageFile.write(reinterpret_cast<const char*>(imageData->bytes()), imageData->size()) != imageData->size())
+                        {
+                            output << xT("Failed to write image to '") << QStringToStlString(view.name) << xT("'") << std::endl;
+                            success = false;
+                        }
+                        imageFile.close();
+                    }
+                }
+
+                imageData->unref();
+            });
         glVerifyResult(output);
+        if (configuration.verbose)
+        {
+            const auto timeElapsedOnViews = viewsStopwatch.elapsed();
+            output
+                << xT("Rendered ") << imagesCounter << xT(" image(s) in ") << timeElapsedOnViews << xT("s (")
+                << (timeElapsedOnViews > 0.0f ? imagesCounter / timeElapsedOnViews : 0.0f) << xT(" images/s)") << std::endl;
+        }
 
         // Release rendering
         if (configuration.verbose)
@@ -1014,83 +1076,6 @@ bool OsmAndTools::EyePiece::rasterize(std::ostream& output)
         break;
     }
 
-    // Read image from render-target
-    if (configuration.verbose)
-        output << xT("Reading result image from GPU...") << std::endl;
-    SkBitmap outputBitmap;
-    outputBitmap.allocPixels(SkImageInfo::MakeN32Premul(configuration.outputImageWidth, configuration.outputImageHeight));
-    glReadPixels(0, 0, configuration.outputImageWidth, configuration.outputImageHeight, GL_RGBA, GL_UNSIGNED_BYTE, outputBitmap.getPixels());
-    glVerifyResult(output);
-
-    // Flip image vertically
-    SkBitmap filledOutputBitmap;
-    filledOutputBitmap.allocPixels(SkImageInfo::MakeN32Premul(configuration.outputImageWidth, configuration.outputImageHeight));
-    const auto rowSizeInBytes = outputBitmap.rowBytes();
-    for (int row = 0; row < configuration.outputImageHeight; row++)
-    {
-        const auto pSrcRow = reinterpret_cast<uint8_t*>(outputBitmap.getPixels()) + (row * rowSizeInBytes);
-        const auto pDstRow = reinterpret_cast<uint8_t*>(filledOutputBitmap.getPixels()) + ((configuration.outputImageHeight - row - 1) * rowSizeInBytes);
-        memcpy(pDstRow, pSrcRow, rowSizeInBytes);
-    }
-
-    // Save bitmap to image (if required)
-    if (!configuration.outputImageFilename.isEmpty())
-    {
-        if (configuration.verbose)
-            output << xT("Saving image to '") << QStringToStlString(configuration.outputImageFilename) << xT("'...") << std::endl;
-
-        std::unique_ptr<SkImageEncoder> imageEncoder;
-        switch (configuration.outputImageFormat)
-        {
-            case ImageFormat::PNG:
-                imageEncoder.reset(CreatePNGImageEncoder());
-                break;
-
-            case ImageFormat::JPEG:
-                imageEncoder.reset(CreateJPEGImageEncoder());
-                break;
-        }
-
-        const auto imageData = imageEncoder->encodeData(filledOutputBitmap, 100);
-        if (!imageData)
-        {
-            output << xT("Failed to encode image") << std::endl;
-            success = false;
-        }
-        else
-        {
-            QFile imageFile(configuration.outputImageFilename);
-
-            // Just in case try to create entire path
-            auto containingDirectory = QFileInfo(imageFile).absoluteDir();
-            containingDirectory.mkpath(QLatin1String("."));
-            if (!QFileInfo(containingDirectory.absolutePath()).isWritable())
-            {
-                output << xT("'") << QStringToStlString(containingDirectory.absolutePath()) << xT("' is not writable") << std::endl;
-                success = false;
-            }
-            else
-            {
-                if (!imageFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
-                {
-                    output << xT("Failed to open destination file '") << QStringToStlString(configuration.outputImageFilename) << xT("'") << std::endl;
-                    success = false;
-                }
-                else
-                {
-                    if (imageFile.write(reinterpret_cast<const char*>(imageData->bytes()), imageData->size()) != imageData->size())
-                    {
-                        output << xT("Failed to write image to '") << QStringToStlString(configuration.outputImageFilename) << xT("'") << std::endl;
-                        success = false;
-                    }
-                    imageFile.close();
-                }
-            }
-
-            imageData->unref();
-        }
-    }
-
     if (configuration.verbose)
         output << xT("Going to release OpenGL context...") << std::endl;
 #if defined(OSMAND_TARGET_OS_windows)
@@ -1159,6 +1144,83 @@ bool OsmAndTools::EyePiece::rasterize(QString *pLog /*= nullptr*/)
     }
 }
 
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::EyePiece::benchmarkZoomGesture(const std::shared_ptr<OsmAnd::IMapRenderer>& mapRenderer, std::wostream& output) const
+#else
+bool OsmAndTools::EyePiece::benchmarkZoomGesture(const std::shared_ptr<OsmAnd::IMapRenderer>& mapRenderer, std::ostream& output) const
+#endif
+{
+    const auto view = getViews().first();
+    const auto fromZoom = configuration.zoomGestureFromZoom;
+    const auto toZoom = view.zoom;
+    const auto gestureTimeout = configuration.zoomGestureDuration + 60.0f;
+
+    mapRenderer->setTarget(view.target31);
+    mapRenderer->setAzimuth(view.azimuth);
+    mapRenderer->setElevationAngle(view.elevationAngle);
+    mapRenderer->setZoom(fromZoom);
+
+    // Gesture is counted by resources worker from first change of zoom until zoom settles after the last one,
+    // so frames are rendered until renderer reports it finished or it takes too long
+    unsigned int framesCount = 0;
+    unsigned int zoomGesturesFinished = 0;
+    unsigned int tiledResourcesRequested = 0;
+    unsigned int tiledResourcesRequestsPostponed = 0;
+    const OsmAnd::Stopwatch gestureStopwatch(true);
+    while (zoomGesturesFinished == 0)
+    {
+        const auto progress = qMin(gestureStopwatch.elapsed() / configuration.zoomGestureDuration, 1.0f);
+        mapRenderer->setZoom(fromZoom + (toZoom - fromZoom) * progress);
+
+        OsmAnd::IMapRenderer_Metrics::Metric_update updateMetric;
+        if (!mapRenderer->update(&updateMetric))
+        {
+            output << xT("Map renderer: update failed") << std::endl;
+            return false;
+        }
+        zoomGesturesFinished += updateMetric.zoomGesturesFinished;
+        tiledResourcesRequested += updateMetric.tiledResourcesRequested;
+        tiledResourcesRequestsPostponed += updateMetric.tiledResourcesRequestsPostponed;
+
+        if (mapRenderer->prepareFrame() && !mapRenderer->renderFrame())
+        {
+            output << xT("Map renderer: frame rendering failed") << std::endl;
+            return false;
+        }
+        glFlush();
+        framesCount++;
+
+        if (gestureStopwatch.elapsed() > gestureTimeout)
+        {
+            output << xT("Zoom gesture didn't finish in ") << gestureTimeout << xT("s") << std::endl;
+            return false;
+        }
+    }
+
+    output
+        << xT("Zoom gesture from ") << fromZoom << xT(" to ") << toZoom
+        << xT(" took ") << gestureStopwatch.elapsed() << xT("s and ") << framesCount << xT(" frames, requested ")
+        << tiledResourcesRequested << xT(" tile(s), postponed ") << tiledResourcesRequestsPostponed
+        << xT(" tile(s)") << std::endl;
+
+    return true;
+}
+
+QList<OsmAndTools::EyePiece::View> OsmAndTools::EyePiece::getViews() const
+{
+    if (!configuration.batchViews.isEmpty())
+        return configuration.batchViews;
+
+    View view;
+    view.name = configuration.outputImageFilename;
+    view.target31 = configuration.target31;
+    view.zoom = configuration.zoom;
+    view.azimuth = configuration.azimuth;
+    view.elevationAngle = configuration.elevationAngle;
+
+    return QList<View>() << view;
+}
+
 OsmAndTools::EyePiece::Configuration::Configuration()
     : styleName(QLatin1String("default"))
     , outputImageWidth(0)
@@ -1172,6 +1234,8 @@ OsmAndTools::EyePiece::Configuration::Configuration()
     , displayDensityFactor(1.0f)
     , locale(QLatin1String("en"))
     , verbose(false)
+    , zoomGestureFromZoom(10.0f)
+    , zoomGestureDuration(0.0f)
 #if defined(OSMAND_TARGET_OS_linux)
     , useLegacyContext(false)
 #endif
@@ -1443,6 +1507,36 @@ bool OsmAndTools::EyePiece::Configuration::parseFromCommandLineArguments(
 
             outConfiguration.locale = value;
         }
+        else if (arg.startsWith(QLatin1String("-batchFilename=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-batchFilename=")));
+            if (!parseBatchFile(value, outConfiguration.batchViews, outError))
+                return false;
+        }
+        else if (arg.startsWith(QLatin1String("-zoomGestureFromZoom=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-zoomGestureFromZoom=")));
+
+            bool ok = false;
+            outConfiguration.zoomGestureFromZoom = value.toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as zoom gesture start zoom").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-zoomGestureDuration=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-zoomGestureDuration=")));
+
+            bool ok = false;
+            outConfiguration.zoomGestureDuration = value.toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' can not be parsed as zoom gesture duration in seconds").arg(value);
+                return false;
+            }
+        }
         else if (arg == QLatin1String("-verbose"))
         {
             outConfiguration.verbose = true;
@@ -1479,3 +1573,94 @@ bool OsmAndTools::EyePiece::Configuration::parseFromCommandLineArguments(
 
     return true;
 }
+
+bool OsmAndTools::EyePiece::Configuration::parseBatchFile(
+    const QString& batchFilename,
+    QList<View>& outViews,
+    QString& outError)
+{
+    QFile batchFile(batchFilename);
+    if (!batchFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        outError = QString("'%1' file can not be opened").arg(batchFilename);
+        return false;
+    }
+
+    // Each line is "outputImageFilename latitude longitude zoom [azimuth [elevationAngle]]", empty lines
+    // and lines starting with '#' are skipped
+    QTextStream batchStream(&batchFile);
+    for (auto lineNumber = 1; !batchStream.atEnd(); lineNumber++)
+    {
+        const auto line = batchStream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+            continue;
+
+        const auto values = line.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+        if (values.size() < 4 || values.size() > 6)
+        {
+            outError = QString("Line %1 of '%2' can not be parsed as view").arg(lineNumber).arg(batchFilename);
+            return false;
+        }
+
+        View view;
+        view.name = Utilities::resolvePath(values[0]);
+
+        OsmAnd::LatLon latLon;
+        bool ok = false;
+        latLon.latitude = values[1].toDouble(&ok);
+        if (!ok)
+        {
+            outError = QString("'%1' at line %2 of '%3' can not be parsed as latitude").arg(values[1]).arg(lineNumber).arg(batchFilename);
+            return false;
+        }
+
+        ok = false;
+        latLon.longitude = values[2].toDouble(&ok);
+        if (!ok)
+        {
+            outError = QString("'%1' at line %2 of '%3' can not be parsed as longitude").arg(values[2]).arg(lineNumber).arg(batchFilename);
+            return false;
+        }
+        view.target31 = OsmAnd::Utilities::convertLatLonTo31(latLon);
+
+        ok = false;
+        view.zoom = values[3].toFloat(&ok);
+        if (!ok)
+        {
+            outError = QString("'%1' at line %2 of '%3' can not be parsed as zoom").arg(values[3]).arg(lineNumber).arg(batchFilename);
+            return false;
+        }
+
+        if (values.size() > 4)
+        {
+            ok = false;
+            view.azimuth = values[4].toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' at line %2 of '%3' can not be parsed as azimuth").arg(values[4]).arg(lineNumber).arg(batchFilename);
+                return false;
+            }
+        }
+
+        if (values.size() > 5)
+        {
+            ok = false;
+            view.elevationAngle = values[5].toFloat(&ok);
+            if (!ok)
+            {
+                outError = QString("'%1' at line %2 of '%3' can not be parsed as elevation angle").arg(values[5]).arg(lineNumber).arg(batchFilename);
+                return false;
+            }
+        }
+
+        outViews.push_back(view);
+    }
+
+    if (outViews.isEmpty())
+    {
+        outError = QString("'%1' contains no views").arg(batchFilename);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,218 @@
+#include "RoutingPreprocessor.h"
+
+#include <OsmAndCore/stdlib_common.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <iomanip>
+#include <OsmAndCore/restore_internal_warnings.h>
+
+#include <OsmAndCore/QtExtensions.h>
+#include <OsmAndCore/ignore_warnings_on_external_includes.h>
+#include <QDir>
+#include <QFile>
+#include <OsmAndCore/restore_internal_warnings.h>
+#include <OsmAndCore/QtCommon.h>
+
+#include <OsmAndCore.h>
+#include <OsmAndCore/Common.h>
+#include <OsmAndCore/Stopwatch.h>
+#include <OsmAndCore/ObfsCollection.h>
+#include <OsmAndCore/ContractionHierarchy.h>
+#include <OsmAndCore/ProfileRoadCostModel.h>
+#include <OsmAndCore/Routing/RoutingConfiguration.h>
+
+#include <OsmAndCoreTools.h>
+#include <OsmAndCoreTools/Utilities.h>
+
+OsmAndTools::RoutingPreprocessor::RoutingPreprocessor(const Configuration& configuration_)
+    : configuration(configuration_)
+{
+}
+
+OsmAndTools::RoutingPreprocessor::~RoutingPreprocessor()
+{
+}
+
+std::shared_ptr<const OsmAnd::IRoadCostModel> OsmAndTools::RoutingPreprocessor::createRoadCostModel() const
+{
+    if (configuration.routingConfigFilename.isEmpty())
+        return std::make_shared<OsmAnd::DefaultRoadCostModel>(configuration.profile);
+
+    QFile routingConfigFile(configuration.routingConfigFilename);
+    if (!routingConfigFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return nullptr;
+    OsmAnd::RoutingConfiguration routingConfig;
+    const auto parsed = OsmAnd::RoutingConfiguration::parseConfiguration(&routingConfigFile, routingConfig);
+    routingConfigFile.close();
+    if (!parsed)
+        return nullptr;
+
+    const auto routingProfile = routingConfig.routingProfiles.value(configuration.routingProfileName);
+    if (!routingProfile)
+        return nullptr;
+    return std::make_shared<OsmAnd::ProfileRoadCostModel>(routingProfile);
+}
+
+#if defined(_UNICODE) || defined(UNICODE)
+bool OsmAndTools::RoutingPreprocessor::preprocess(std::wostream& output)
+#else
+bool OsmAndTools::RoutingPreprocessor::preprocess(std::ostream& output)
+#endif
+{
+    const auto costModel = createRoadCostModel();
+    if (!costModel)
+    {
+        output << xT("Failed to load routing profile '") << QStringToStlString(configuration.routingProfileName) << xT("'") << std::endl;
+        return false;
+    }
+
+    if (configuration.verbose)
+    {
+        output << xT("Going to build contraction hierarchy of ") << configuration.obfsCollection->getObfFiles().size()
+            << xT(" OBF file(s) for '") << QStringToStlString(costModel->getSignature()) << xT("'...") << std::endl;
+    }
+
+    OsmAnd::ContractionHierarchy::BuildStatistics statistics;
+    OsmAnd::Stopwatch stopwatch(true);
+    const auto success = OsmAnd::ContractionHierarchy::build(
+        configuration.obfsCollection,
+        costModel,
+        configuration.outputFilename,
+        &statistics);
+    const auto elapsed = stopwatch.elapsed();
+    if (!success)
+    {
+        output << xT("Failed to build '") << QStringToStlString(configuration.outputFilename) << xT("'") << std::endl;
+        return false;
+    }
+
+    output << std::fixed << std::setprecision(3);
+    output << xT("Nodes:          ") << statistics.nodesCount << std::endl;
+    output << xT("Edges:          ") << statistics.edgesCount << std::endl;
+    output << xT("Shortcuts:      ") << statistics.shortcutsCount << std::endl;
+    output << xT("File size:      ") << (QFile(configuration.outputFilename).size() / 1024.0 / 1024.0) << xT("MB") << std::endl;
+    output << xT("Elapsed:        ") << elapsed << xT("s") << std::endl;
+
+    return true;
+}
+
+bool OsmAndTools::RoutingPreprocessor::preprocess(QString *pLog /*= nullptr*/)
+{
+    if (pLog != nullptr)
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        std::wostringstream output;
+        const bool success = preprocess(output);
+        *pLog = QString::fromStdWString(output.str());
+        return success;
+#else
+        std::ostringstream output;
+        const bool success = preprocess(output);
+        *pLog = QString::fromStdString(output.str());
+        return success;
+#endif
+    }
+    else
+    {
+#if defined(_UNICODE) || defined(UNICODE)
+        return preprocess(std::wcout);
+#else
+        return preprocess(std::cout);
+#endif
+    }
+}
+
+OsmAndTools::RoutingPreprocessor::Configuration::Configuration()
+    : profile(OsmAnd::DefaultRoadCostModel::Profile::Car)
+    , routingProfileName(QLatin1String("car"))
+    , verbose(false)
+{
+}
+
+bool OsmAndTools::RoutingPreprocessor::Configuration::parseFromCommandLineArguments(
+    const QStringList& commandLineArgs,
+    Configuration& outConfiguration,
+    QString& outError)
+{
+    outConfiguration = Configuration();
+
+    const std::shared_ptr<OsmAnd::ObfsCollection> obfsCollection(new OsmAnd::ObfsCollection());
+    outConfiguration.obfsCollection = obfsCollection;
+
+    for (const auto& arg : commandLineArgs)
+    {
+        if (arg.startsWith(QLatin1String("-obfsPath=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfsPath=")));
+            if (!QDir(value).exists())
+            {
+                outError = QString("'%1' path does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addDirectory(value, false);
+        }
+        else if (arg.startsWith(QLatin1String("-obfFile=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-obfFile=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            obfsCollection->addFile(value);
+        }
+        else if (arg.startsWith(QLatin1String("-profile=")))
+        {
+            const auto value = Utilities::purifyArgumentValue(arg.mid(strlen("-profile=")));
+            if (value == QLatin1String("car"))
+                outConfiguration.profile = OsmAnd::DefaultRoadCostModel::Profile::Car;
+            else if (value == QLatin1String("bicycle"))
+                outConfiguration.profile = OsmAnd::DefaultRoadCostModel::Profile::Bicycle;
+            else if (value == QLatin1String("pedestrian"))
+                outConfiguration.profile = OsmAnd::DefaultRoadCostModel::Profile::Pedestrian;
+            else
+            {
+                outError = QString("'%1' profile is not supported").arg(value);
+                return false;
+            }
+        }
+        else if (arg.startsWith(QLatin1String("-routingConfig=")))
+        {
+            const auto value = Utilities::resolvePath(arg.mid(strlen("-routingConfig=")));
+            if (!QFile(value).exists())
+            {
+                outError = QString("'%1' file does not exist").arg(value);
+                return false;
+            }
+
+            outConfiguration.routingConfigFilename = value;
+        }
+        else if (arg.startsWith(QLatin1String("-routingProfile=")))
+        {
+            outConfiguration.routingProfileName = Utilities::purifyArgumentValue(arg.mid(strlen("-routingProfile=")));
+        }
+        else if (arg.startsWith(QLatin1String("-output=")))
+        {
+            outConfiguration.outputFilename = Utilities::resolvePath(arg.mid(strlen("-output=")));
+        }
+        else if (arg == QLatin1String("-verbose"))
+        {
+            outConfiguration.verbose = true;
+        }
+        else
+        {
+            outError = QString("Unrecognized argument: '%1'").arg(arg);
+            return false;
+        }
+    }
+
+    // Validate
+    if (obfsCollection->getObfFiles().isEmpty() || outConfiguration.outputFilename.isEmpty())
+    {
+        outError = QLatin1String("'obfsPath' or 'obfFile', and 'output' are required");
+        return false;
+    }
+
+    return true;
+}